@@ -26,6 +26,7 @@ This class represents our type-abstraction layer. It is the means by which
 #include "Argument.h"
 
 #include <DataStructures/PriorityQueue.h>
+#include <DataStructures/Slab.h>
 #if defined(CONFIG_MANUVR_IMG_SUPPORT)
   #include <Types/Image.h>
 #endif   // CONFIG_MANUVR_IMG_SUPPORT
@@ -42,23 +43,69 @@ This class represents our type-abstraction layer. It is the means by which
 *
 * Static members and initializers should be located here.
 *******************************************************************************/
+#if (ARGUMENT_PREALLOC_COUNT > 0)
+  // Zero-initialized, and so usable by static constructors in other units.
+  static Slab<Argument, ARGUMENT_PREALLOC_COUNT> _arg_slab;
+#endif
+
+/**
+* Class-specific allocation. Tries the slab first, and then the heap.
+*
+* @return memory for an Argument, or nullptr if there is none.
+*/
+void* Argument::operator new(size_t sz) noexcept {
+  #if (ARGUMENT_PREALLOC_COUNT > 0)
+    if (sizeof(Argument) == sz) {
+      void* ret = _arg_slab.take();
+      if (nullptr != ret) return ret;
+    }
+  #endif
+  return malloc(sz);
+}
+
+
+void Argument::operator delete(void* p) {
+  #if (ARGUMENT_PREALLOC_COUNT > 0)
+    if (_arg_slab.give(p)) return;
+  #endif
+  free(p);
+}
+
+
+/**
+* Reports on the slab that backs all Arguments.
+*
+* @param   StringBuilder* The buffer into which this fxn should write its output.
+*/
+void Argument::printPool(StringBuilder* output) {
+  #if (ARGUMENT_PREALLOC_COUNT > 0)
+    output->concatf("-- Argument slab (%u x %u bytes)\n", _arg_slab.capacity(), sizeof(Argument));
+    output->concatf("\t Outstanding:    %u\n\t High watermark: %u\n\t Starves:        %u\n", _arg_slab.outstanding(), _arg_slab.highWaterMark(), _arg_slab.starves());
+  #else
+    output->concat("-- Argument slab disabled.\n");
+  #endif
+}
+
+
 #if defined(MANUVR_CBOR)
 
-int8_t Argument::encodeToCBOR(Argument* src, StringBuilder* out) {
-  cbor::output_dynamic output;
-  cbor::encoder encoder(output);
+/*
+* Writes an Argument list to the given encoder. Where the bytes go is up to the
+*   caller.
+*/
+static void _encode_cbor(Argument* src, cbor::encoder* encoder) {
   while (nullptr != src) {
     if (nullptr != src->getKey()) {
       // This is a map.
-      encoder.write_map(1);
-      encoder.write_string(src->getKey());
+      encoder->write_map(1);
+      encoder->write_string(src->getKey());
     }
     switch(src->typeCode()) {
       case TCode::INT8:
         {
           int8_t x = 0;
           if (0 == src->getValueAs(&x)) {
-            encoder.write_int((int) x);
+            encoder->write_int((int) x);
           }
         }
         break;
@@ -66,7 +113,7 @@ int8_t Argument::encodeToCBOR(Argument* src, StringBuilder* out) {
         {
           int16_t x = 0;
           if (0 == src->getValueAs(&x)) {
-            encoder.write_int((int) x);
+            encoder->write_int((int) x);
           }
         }
         break;
@@ -74,7 +121,7 @@ int8_t Argument::encodeToCBOR(Argument* src, StringBuilder* out) {
         {
           int32_t x = 0;
           if (0 == src->getValueAs(&x)) {
-            encoder.write_int((int) x);
+            encoder->write_int((int) x);
           }
         }
         break;
@@ -82,7 +129,7 @@ int8_t Argument::encodeToCBOR(Argument* src, StringBuilder* out) {
         {
           long long x = 0;
           if (0 == src->getValueAs(&x)) {
-            encoder.write_int(x);
+            encoder->write_int(x);
           }
         }
         break;
@@ -90,7 +137,7 @@ int8_t Argument::encodeToCBOR(Argument* src, StringBuilder* out) {
         {
           uint8_t x = 0;
           if (0 == src->getValueAs(&x)) {
-            encoder.write_int((unsigned int) x);
+            encoder->write_int((unsigned int) x);
           }
         }
         break;
@@ -98,7 +145,7 @@ int8_t Argument::encodeToCBOR(Argument* src, StringBuilder* out) {
         {
           uint16_t x = 0;
           if (0 == src->getValueAs(&x)) {
-            encoder.write_int((unsigned int) x);
+            encoder->write_int((unsigned int) x);
           }
         }
         break;
@@ -106,7 +153,7 @@ int8_t Argument::encodeToCBOR(Argument* src, StringBuilder* out) {
         {
           uint32_t x = 0;
           if (0 == src->getValueAs(&x)) {
-            encoder.write_int((unsigned int) x);
+            encoder->write_int((unsigned int) x);
           }
         }
         break;
@@ -114,7 +161,7 @@ int8_t Argument::encodeToCBOR(Argument* src, StringBuilder* out) {
         {
           unsigned long long x = 0;
           if (0 == src->getValueAs(&x)) {
-            encoder.write_int(x);
+            encoder->write_int(x);
           }
         }
         break;
@@ -122,7 +169,15 @@ int8_t Argument::encodeToCBOR(Argument* src, StringBuilder* out) {
         {
           float x = 0;
           if (0 == src->getValueAs(&x)) {
-            encoder.write_float(x);
+            encoder->write_float(x);
+          }
+        }
+        break;
+      case TCode::BOOLEAN:
+        {
+          uint8_t x = 0;
+          if (0 == src->getValueAs(&x)) {
+            encoder->write_special(x ? cbor::CBOR_TRUE : cbor::CBOR_FALSE);
           }
         }
         break;
@@ -131,7 +186,7 @@ int8_t Argument::encodeToCBOR(Argument* src, StringBuilder* out) {
         {
           double x = 0;
           if (0 == src->getValueAs(&x)) {
-            encoder.write_double(x);
+            encoder->write_double(x);
           }
         }
         break;
@@ -140,7 +195,7 @@ int8_t Argument::encodeToCBOR(Argument* src, StringBuilder* out) {
         {
           char* buf;
           if (0 == src->getValueAs(&buf)) {
-            encoder.write_string(buf);
+            encoder->write_string(buf);
           }
         }
         break;
@@ -148,7 +203,7 @@ int8_t Argument::encodeToCBOR(Argument* src, StringBuilder* out) {
         {
           StringBuilder* buf;
           if (0 == src->getValueAs(&buf)) {
-            encoder.write_string((char*) buf->string());
+            encoder->write_string((char*) buf->string());
           }
         }
         break;
@@ -159,8 +214,8 @@ int8_t Argument::encodeToCBOR(Argument* src, StringBuilder* out) {
         // NOTE: This ought to work for any types retaining portability isn't important.
         // TODO: Gradually convert types out of this block. As much as possible should
         //   be portable. VECT_3_FLOAT ought to be an array of floats, for instance.
-        encoder.write_tag(MANUVR_CBOR_VENDOR_TYPE | TcodeToInt(src->typeCode()));
-        encoder.write_bytes((uint8_t*) src->pointer(), src->length());
+        encoder->write_tag(MANUVR_CBOR_VENDOR_TYPE | TcodeToInt(src->typeCode()));
+        encoder->write_bytes((uint8_t*) src->pointer(), src->length());
         break;
 
       case TCode::IDENTITY:
@@ -170,8 +225,8 @@ int8_t Argument::encodeToCBOR(Argument* src, StringBuilder* out) {
             uint16_t i_len = ident->length();
             uint8_t buf[i_len];
             if (ident->toBuffer(buf)) {
-              encoder.write_tag(MANUVR_CBOR_VENDOR_TYPE | TcodeToInt(src->typeCode()));
-              encoder.write_bytes(buf, i_len);
+              encoder->write_tag(MANUVR_CBOR_VENDOR_TYPE | TcodeToInt(src->typeCode()));
+              encoder->write_bytes(buf, i_len);
             }
           }
         }
@@ -182,9 +237,9 @@ int8_t Argument::encodeToCBOR(Argument* src, StringBuilder* out) {
           Argument *subj;
           if (0 == src->getValueAs(&subj)) {
             // NOTE: Recursion.
-            if (Argument::encodeToCBOR(subj, &intermediary)) {
-              encoder.write_tag(MANUVR_CBOR_VENDOR_TYPE | TcodeToInt(src->typeCode()));
-              encoder.write_bytes(intermediary.string(), intermediary.length());
+            if (0 < Argument::encodeToCBOR(subj, &intermediary)) {
+              encoder->write_tag(MANUVR_CBOR_VENDOR_TYPE | TcodeToInt(src->typeCode()));
+              encoder->write_bytes(intermediary.string(), intermediary.length());
             }
           }
         }
@@ -199,9 +254,9 @@ int8_t Argument::encodeToCBOR(Argument* src, StringBuilder* out) {
                 uint32_t nb_buf = 0;
                 uint8_t* intermediary = (uint8_t*) alloca(32);
                 if (0 == img->serializeWithoutBuffer(intermediary, &nb_buf)) {
-                  encoder.write_tag(MANUVR_CBOR_VENDOR_TYPE | TcodeToInt(src->typeCode()));
-                  encoder.write_bytes(intermediary, nb_buf);   // TODO: This might cause two discrete CBOR objects.
-                  encoder.write_bytes(img->buffer(), sz_buf);
+                  encoder->write_tag(MANUVR_CBOR_VENDOR_TYPE | TcodeToInt(src->typeCode()));
+                  encoder->write_bytes(intermediary, nb_buf);   // TODO: This might cause two discrete CBOR objects.
+                  encoder->write_bytes(img->buffer(), sz_buf);
                 }
               }
             }
@@ -221,24 +276,285 @@ int8_t Argument::encodeToCBOR(Argument* src, StringBuilder* out) {
         // TODO: Handle pointer types, bool
         break;
     }
-    src = src->_next;
+    src = src->next();
   }
-  int final_size = output.size();
-  if (final_size) {
-    out->concat(output.data(), final_size);
+}
+
+
+/**
+* Guesses at the encoded size of an Argument list, from the same lengths that
+*   sumAllLengths() reports, plus room for each header, tag, and key. This is
+*   generous for everything but types held by reference (StringBuilder,
+*   Identity, Argument), for which the encoder will find the exact size.
+*/
+static unsigned int _cbor_size_hint(Argument* src) {
+  unsigned int ret = 0;
+  while (nullptr != src) {
+    ret += src->length() + 14;   // Tag, plus the largest header.
+    if (nullptr != src->getKey()) {
+      ret += strlen(src->getKey()) + 6;   // The map, and the key's header.
+    }
+    src = src->next();
   }
-  return final_size;
+  return ret;
 }
 
 
+/**
+* Encodes an Argument list as CBOR directly onto the end of a StringBuilder.
+*   Room is reserved up-front, so the common case is a single pass with no
+*   allocation beyond the StringBuilder's own growth.
+*
+* @param  src  The Argument list to encode.
+* @param  out  The buffer to append to.
+* @return the number of bytes appended, or -1 on failure.
+*/
+int Argument::encodeToCBOR(Argument* src, StringBuilder* out) {
+  unsigned int len = _cbor_size_hint(src);
+  cbor::output_buffer output(out->reserveTail(len), len);
+  cbor::encoder encoder(output);
+  _encode_cbor(src, &encoder);
+  if (output.overflowed()) {
+    // The guess was short. But now we know exactly how short.
+    len = output.size();
+    output.reset(out->reserveTail(len), len);
+    _encode_cbor(src, &encoder);
+    if (output.overflowed()) return -1;
+  }
+  out->commitTail(output.size());
+  return output.size();
+}
+
 
+/**
+* Encodes an Argument list as CBOR into the caller's memory. Never allocates.
+*   As with snprintf(), a return value larger than len means that the buffer was
+*   too small, and that the caller should try again with that many bytes.
+*
+* @param  src  The Argument list to encode.
+* @param  buf  The memory to write into.
+* @param  len  How many bytes are at buf.
+* @return the encoded length.
+*/
+int Argument::encodeToCBOR(Argument* src, uint8_t* buf, unsigned int len) {
+  cbor::output_buffer output(buf, len);
+  cbor::encoder encoder(output);
+  _encode_cbor(src, &encoder);
+  return output.size();
+}
+
+
+/*
+* Copies a byte string out of the CBOR source, so that the Argument can own it.
+*   Values that fit are kept inline.
+*/
+Argument* Argument::_from_cbor_bytes(TCode tc, const uint8_t* data, unsigned int len) {
+  Argument* ret = new Argument(tc);
+  if (len <= ARGUMENT_INLINE_BYTES) {
+    ret->_set_inline(data, len);
+  }
+  else {
+    void* copy = malloc(len);
+    if (nullptr == copy) {
+      delete ret;
+      return nullptr;
+    }
+    memcpy(copy, data, len);
+    ret->target_mem = copy;
+    ret->len        = len;
+    ret->reapValue(true);
+  }
+  return ret;
+}
+
+
+/**
+* Decodes CBOR into an Argument list. Items are pulled from the source one at a
+*   time, with no intermediate copies. The only allocations are the Arguments
+*   themselves, and memory for keys and variable-length values, which must
+*   outlive the source.
+*
+* Keys are recognized from map structure: each map entry becomes one Argument
+*   with a key. Array structure is flattened.
+*
+* Integers take the smallest type that holds them, up to 64 bits. Half-floats
+*   are widened to float. Null and undefined are the absence of a value, and
+*   produce no Argument. A negative integer beyond int64, or a simple value
+*   that CBOR doesn't assign, fails the whole decode.
+*
+* @param  src  The CBOR.
+* @param  len  How many bytes are at src.
+* @return the Argument list, or nullptr if nothing was decoded.
+*/
 Argument* Argument::decodeFromCBOR(uint8_t* src, unsigned int len) {
-  Argument* return_value = nullptr;
-  CBORArgListener listener(&return_value);
-  cbor::input input(src, len);
-  cbor::decoder decoder(input, listener);
-  decoder.run();
-  return return_value;
+  Argument* ret      = nullptr;
+  Argument* tail     = nullptr;
+  char*     key      = nullptr;
+  bool      key_next = false;       // Is the next string a key?
+  uint32_t  pairs    = 0;           // Map entries left to read.
+  TCode     vendor   = TCode::NONE; // A native type, from our vendor tag.
+  bool      failed   = false;       // Something we can't represent.
+  cbor::reader reader(src, len);
+  cbor::item   it;
+
+  while (!failed && reader.next(&it)) {
+    Argument* nu = nullptr;
+    switch (it.major) {
+      case cbor::CBOR_UINT:
+        switch (it.width) {
+          case 0:
+          case 1:   nu = new Argument((uint8_t)  it.value);   break;
+          case 2:   nu = new Argument((uint16_t) it.value);   break;
+          case 4:   nu = new Argument((uint32_t) it.value);   break;
+          default:  nu = new Argument((uint64_t) it.value);   break;
+        }
+        break;
+
+      case cbor::CBOR_NINT:
+        if (it.value > 0x7FFFFFFFFFFFFFFFULL) {
+          failed = true;   // Below the range of int64.
+        }
+        else if (it.value > 0x7FFFFFFF) {
+          nu = new Argument((int64_t) (-1 - (int64_t) it.value));
+        }
+        else {
+          // Use the smallest type that holds the value, within the encoded width.
+          const int32_t x = -1 - (int32_t) it.value;
+          if ((it.width <= 1) && (x >= -128)) {
+            nu = new Argument((int8_t) x);
+          }
+          else if ((it.width <= 2) && (x >= -32768)) {
+            nu = new Argument((int16_t) x);
+          }
+          else {
+            nu = new Argument((int32_t) x);
+          }
+        }
+        break;
+
+      case cbor::CBOR_BYTES:
+        if (TCode::ARGUMENT == vendor) {
+          // NOTE: Recursion.
+          Argument* inner = decodeFromCBOR((uint8_t*) it.data, (unsigned int) it.value);
+          if (nullptr != inner) {
+            nu = new Argument(inner);
+            nu->reapValue(true);
+          }
+        }
+        else if (TCode::IDENTITY == vendor) {
+          Identity* ident = Identity::fromBuffer((uint8_t*) it.data, (int) it.value);
+          if (nullptr != ident) {
+            nu = new Argument(ident);
+            nu->reapValue(true);
+          }
+        }
+        else if (TCode::NONE != vendor) {
+          const TypeCodeDef* const m_type_def = getManuvrTypeDef(vendor);
+          if (nullptr != m_type_def) {
+            // For variable-length types, fixed_len is a minimum.
+            const bool var_len = (m_type_def->type_flags & TYPE_CODE_FLAG_VARIABLE_LENGTH);
+            if (var_len ? (it.value >= m_type_def->fixed_len) : (it.value == m_type_def->fixed_len)) {
+              nu = _from_cbor_bytes(vendor, it.data, (unsigned int) it.value);
+            }
+          }
+        }
+        else {
+          nu = _from_cbor_bytes(TCode::BINARY, it.data, (unsigned int) it.value);
+        }
+        break;
+
+      case cbor::CBOR_STRING:
+        {
+          char* str = (char*) malloc(it.value + 1);
+          if (nullptr != str) {
+            memcpy(str, it.data, it.value);
+            *(str + it.value) = '\0';
+            if (key_next) {
+              key      = str;
+              key_next = false;
+              continue;    // The value is yet to come.
+            }
+            nu = new Argument(str);
+            nu->reapValue(true);
+          }
+        }
+        break;
+
+      case cbor::CBOR_ARRAY:
+        continue;
+
+      case cbor::CBOR_MAP:
+        if (nullptr != key) {
+          // A map where we expected a value. We don't nest maps.
+          free(key);
+          key = nullptr;
+        }
+        pairs    = (uint32_t) it.value;
+        key_next = (0 < pairs);
+        continue;
+
+      case cbor::CBOR_TAG:
+        // NOTE: IANA gives of _some_ guidance....
+        // https://www.iana.org/assignments/cbor-tags/cbor-tags.xhtml
+        if (MANUVR_CBOR_VENDOR_TYPE == (it.value & 0xFFFFFF00)) {
+          vendor = IntToTcode(it.value & 0x000000FF);
+        }
+        continue;
+
+      case cbor::CBOR_SPECIAL:
+        switch (it.width) {
+          case 2:   nu = new Argument(cbor::reader::asHalf(&it));     break;
+          case 4:   nu = new Argument(cbor::reader::asFloat(&it));    break;
+          case 8:   nu = new Argument(cbor::reader::asDouble(&it));   break;
+          default:
+            switch (it.value) {
+              case cbor::CBOR_FALSE:
+              case cbor::CBOR_TRUE:
+                nu = new Argument((void*)(uintptr_t) (cbor::CBOR_TRUE == it.value), 1, TCode::BOOLEAN);
+                break;
+              case cbor::CBOR_NULL:
+              case cbor::CBOR_UNDEFINED:
+                break;   // No value.
+              default:
+                failed = true;   // Unassigned simple value.
+                break;
+            }
+            break;
+        }
+        break;
+    }
+
+    // Whatever we just read was a value. Any tag applied to it.
+    vendor = TCode::NONE;
+    if (nullptr != nu) {
+      if (nullptr != key) {
+        nu->setKey(key);
+        nu->reapKey(true);
+        key = nullptr;
+      }
+      if (nullptr == tail) {
+        ret = nu;
+      }
+      else {
+        tail->link(nu);
+      }
+      tail = nu;
+    }
+    if (nullptr != key) {
+      free(key);   // Its value was something we don't support.
+      key = nullptr;
+    }
+    if (0 < pairs) {
+      pairs--;
+      key_next = (0 < pairs);
+    }
+  }
+  if (nullptr != key) free(key);
+  if (failed && (nullptr != ret)) {
+    delete ret;   // Takes the rest of the list with it.
+    ret = nullptr;
+  }
+  return ret;
 }
 #endif  // MANUVR_CBOR
 
@@ -310,11 +626,16 @@ Argument::Argument(void* ptr, int l, TCode code) : Argument(code) {
   target_mem = ptr;
 }
 
-Argument::Argument(double val) : Argument(malloc(sizeof(double)), sizeof(double), TCode::DOUBLE) {
-  if (nullptr != target_mem) {
-    *((double*) target_mem) = val;
-    _alter_flags(true, MANUVR_ARG_FLAG_REAP_VALUE);
-  }
+Argument::Argument(double val) : Argument(TCode::DOUBLE) {
+  _set_inline(&val, sizeof(double));
+}
+
+Argument::Argument(int64_t val) : Argument(TCode::INT64) {
+  _set_inline(&val, sizeof(int64_t));
+}
+
+Argument::Argument(uint64_t val) : Argument(TCode::UINT64) {
+  _set_inline(&val, sizeof(uint64_t));
 }
 
 
@@ -332,7 +653,14 @@ void Argument::wipe() {
   if (nullptr != target_mem) {
     void* p = target_mem;
     target_mem = nullptr;
-    if (reapValue()) free(p);
+    if (reapValue() && (p != (void*) _inline.b)) {
+      switch (_t_code) {
+        // Objects we created in decodeFromCBOR().
+        case TCode::ARGUMENT:   delete ((Argument*) p);   break;
+        case TCode::IDENTITY:   delete ((Identity*) p);   break;
+        default:                free(p);                  break;
+      }
+    }
   }
   if (nullptr != _key) {
     char* k = (char*) _key;
@@ -442,6 +770,7 @@ int8_t Argument::getValueAs(void* trg_buf) {
   switch (typeCode()) {
     case TCode::INT8:    // This frightens the compiler. Its fears are unfounded.
     case TCode::UINT8:   // This frightens the compiler. Its fears are unfounded.
+    case TCode::BOOLEAN:
       return_value = 0;
       *((uint8_t*) trg_buf) = *((uint8_t*)&target_mem);
       break;
@@ -463,7 +792,9 @@ int8_t Argument::getValueAs(void* trg_buf) {
       *((uint8_t*) trg_buf + 3) = *(((uint8_t*) &target_mem) + 3);
       break;
 
-    case TCode::DOUBLE:         // These are fixed-length allocated data.
+    case TCode::INT64:          // These are fixed-length allocated data.
+    case TCode::UINT64:         //
+    case TCode::DOUBLE:         //
     case TCode::VECT_4_FLOAT:   //
     case TCode::VECT_3_FLOAT:   //
     case TCode::VECT_3_UINT16:
@@ -554,6 +885,8 @@ int8_t Argument::serialize(StringBuilder *out) {
     case TCode::URL:             // This is a pointer to some StringBuilder. Presumably this is on the heap.
       temp_str    = ((StringBuilder*) target_mem)->string();
       arg_bin_len = ((StringBuilder*) target_mem)->length();
+    case TCode::INT64:
+    case TCode::UINT64:
     case TCode::DOUBLE:
     case TCode::VECT_4_FLOAT:  // NOTE!!! This only works for Vectors because of the template layout. FRAGILE!!!
     case TCode::VECT_3_FLOAT:  // NOTE!!! This only works for Vectors because of the template layout. FRAGILE!!!
@@ -629,6 +962,8 @@ int8_t Argument::serialize_raw(StringBuilder *out) {
       out->concat((StringBuilder*) target_mem);
       break;
     case TCode::STR:
+    case TCode::INT64:
+    case TCode::UINT64:
     case TCode::DOUBLE:
     case TCode::VECT_4_FLOAT:
     case TCode::VECT_3_FLOAT:
@@ -740,17 +1075,29 @@ void Argument::valToString(StringBuilder* out) {
     case TCode::INT8:
     case TCode::INT16:
     case TCode::INT32:
-    case TCode::INT64:
     case TCode::INT128:
       out->concatf("%d", (uintptr_t) pointer());
       break;
     case TCode::UINT8:
     case TCode::UINT16:
     case TCode::UINT32:
-    case TCode::UINT64:
     case TCode::UINT128:
       out->concatf("%u", (uintptr_t) pointer());
       break;
+    case TCode::INT64:
+      {
+        long long tmp = 0;
+        getValueAs((void*) &tmp);
+        out->concatf("%lld", tmp);
+      }
+      break;
+    case TCode::UINT64:
+      {
+        unsigned long long tmp = 0;
+        getValueAs((void*) &tmp);
+        out->concatf("%llu", tmp);
+      }
+      break;
     case TCode::FLOAT:
       {
         float tmp;
@@ -817,6 +1164,7 @@ int8_t Argument::setValue(void* trg_buf, int len, TCode tc) {
   switch (tc) {
     case TCode::INT8:    // This frightens the compiler. Its fears are unfounded.
     case TCode::UINT8:   // This frightens the compiler. Its fears are unfounded.
+    case TCode::BOOLEAN:
       return_value = 0;
       *((uint8_t*)&target_mem) = *((uint8_t*) trg_buf);
       break;
@@ -844,6 +1192,8 @@ int8_t Argument::setValue(void* trg_buf, int len, TCode tc) {
     case TCode::INT16_PTR:
     case TCode::INT8_PTR:
     case TCode::FLOAT_PTR:
+    case TCode::INT64:
+    case TCode::UINT64:
     case TCode::DOUBLE:
     case TCode::VECT_4_FLOAT:
     case TCode::VECT_3_FLOAT:
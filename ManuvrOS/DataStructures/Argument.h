@@ -52,6 +52,12 @@ Template for a preallocated pool manager.
 #define MANUVR_ARG_FLAG_CONST_REDUCED  0x40  // Key reduced to const.
 #define MANUVR_ARG_FLAG_REQUIRED       0x80
 
+/*
+* Values up to this size (doubles and vectors) are held inside the Argument,
+*   rather than in memory of their own.
+*/
+#define ARGUMENT_INLINE_BYTES          16
+
 class StringBuilder;
 class BufferPipe;
 class ManuvrXport;
@@ -96,6 +102,8 @@ class Argument {
       *(((uint8_t*) &target_mem) + 3) = *(src + 3);
     };
     Argument(double val);
+    Argument(int64_t  val);
+    Argument(uint64_t val);
 
     Argument(uint8_t*  val) : Argument((void*) val, sizeof(val), TCode::UINT8_PTR)  {};
     Argument(uint16_t* val) : Argument((void*) val, sizeof(val), TCode::UINT16_PTR) {};
@@ -110,6 +118,15 @@ class Argument {
     Argument(Vector3f*    val) : Argument((void*) val, 12, TCode::VECT_3_FLOAT)  {};
     Argument(Vector4f*    val) : Argument((void*) val, 16, TCode::VECT_4_FLOAT)  {};
 
+    /*
+    * Vectors passed by value are copied into the Argument itself. Their
+    *   pointer() will be good for as long as the Argument is.
+    */
+    Argument(Vector3ui16 val) : Argument(TCode::VECT_3_UINT16) {  _set_inline(&val, 6);   };
+    Argument(Vector3i16  val) : Argument(TCode::VECT_3_INT16)  {  _set_inline(&val, 6);   };
+    Argument(Vector3f    val) : Argument(TCode::VECT_3_FLOAT)  {  _set_inline(&val, 12);  };
+    Argument(Vector4f    val) : Argument(TCode::VECT_4_FLOAT)  {  _set_inline(&val, 16);  };
+
     /* Character pointers. */
     Argument(const char* val) : Argument((void*) val, (strlen(val)+1), TCode::STR) {};
     Argument(char* val)       : Argument((void*) val, (strlen(val)+1), TCode::STR) {};
@@ -147,6 +164,14 @@ class Argument {
 
     ~Argument();
 
+    /*
+    * Arguments are drawn from a static slab of ARGUMENT_PREALLOC_COUNT, and
+    *   come from the heap only when it runs dry.
+    */
+    static void* operator new(size_t) noexcept;
+    static void  operator delete(void*);
+    static void  printPool(StringBuilder*);
+
 
     int8_t dropArg(Argument**, Argument*);
 
@@ -155,6 +180,7 @@ class Argument {
     inline void reapValue(bool en) {  _alter_flags(en, MANUVR_ARG_FLAG_REAP_VALUE);    };
     inline bool reapValue() {         return _check_flags(MANUVR_ARG_FLAG_REAP_VALUE); };
 
+    inline Argument* next() {         return _next;      };
     inline void*    pointer() {       return target_mem; };
     inline uint16_t length() {        return len;        };
     inline TCode    typeCode() {      return _t_code;    };
@@ -197,6 +223,10 @@ class Argument {
     inline Argument* append(Vector3i16 *val) {      return link(new Argument(val));   }
     inline Argument* append(Vector3f *val) {        return link(new Argument(val));   }
     inline Argument* append(Vector4f *val) {        return link(new Argument(val));   }
+    inline Argument* append(Vector3ui16 val) {      return link(new Argument(val));   }
+    inline Argument* append(Vector3i16 val) {       return link(new Argument(val));   }
+    inline Argument* append(Vector3f val) {         return link(new Argument(val));   }
+    inline Argument* append(Vector4f val) {         return link(new Argument(val));   }
 
     inline Argument* append(void *val, int len) {   return link(new Argument(val, len));   }
     inline Argument* append(const char *val) {      return link(new Argument(val));   }
@@ -261,7 +291,8 @@ class Argument {
     static char*  printBinStringToBuffer(unsigned char *str, int len, char *buffer);
 
     #if defined(MANUVR_CBOR)
-    static int8_t encodeToCBOR(Argument*, StringBuilder*);
+    static int encodeToCBOR(Argument*, StringBuilder*);
+    static int encodeToCBOR(Argument*, uint8_t* buf, unsigned int len);
     static Argument* decodeFromCBOR(uint8_t*, unsigned int);
     static inline Argument* decodeFromCBOR(StringBuilder* buf) {
       return decodeFromCBOR(buf->string(), buf->length());
@@ -292,6 +323,22 @@ class Argument {
   private:
     uint8_t     _flags     = 0;
 
+    #if defined(MANUVR_CBOR)
+    static Argument* _from_cbor_bytes(TCode, const uint8_t*, unsigned int);
+    #endif
+
+    /* Storage for values too big for target_mem, but no bigger than this. */
+    union {
+      double    d;
+      uint8_t   b[ARGUMENT_INLINE_BYTES];
+    } _inline;
+
+    inline void _set_inline(const void* src, uint16_t l) {
+      memcpy(_inline.b, src, l);
+      target_mem = (void*) _inline.b;
+      len        = l;
+    };
+
     /* Inlines for altering and reading the flags. */
     inline void _alter_flags(bool en, uint8_t mask) {
       _flags = (en) ? (_flags | mask) : (_flags & ~mask);
@@ -57,6 +57,8 @@ const char* BufferPipe::signalString(ManuvrPipeSignal code) {
     case ManuvrPipeSignal::STRATEGY:          return "STRATEGY";
     case ManuvrPipeSignal::XPORT_CONNECT:     return "XPORT_CONNECT";
     case ManuvrPipeSignal::XPORT_DISCONNECT:  return "XPORT_DISCONNECT";
+    case ManuvrPipeSignal::XPORT_CONGESTED:   return "XPORT_CONGESTED";
+    case ManuvrPipeSignal::XPORT_DRAINED:     return "XPORT_DRAINED";
     case ManuvrPipeSignal::UNDEF:
     default:                                  return "SIGNAL_UNDEF";
   }
@@ -281,6 +283,37 @@ int8_t BufferPipe::fromCounterparty(StringBuilder* buf, int8_t mm) {
 }
 
 
+/**
+* Inward toward the transport.
+* Default implementation gives the overriding class the StringBuilder it
+*   understands. It costs a copy.
+*
+* @param  buf    A pointer to the slice. Remains the caller's.
+* @param  mm     A declaration of memory-management responsibility.
+* @return A declaration of memory-management responsibility.
+*/
+int8_t BufferPipe::toCounterparty(BufferSlice* buf, int8_t mm) {
+  StringBuilder temp;
+  buf->copyTo(&temp);
+  return toCounterparty(&temp, MEM_MGMT_RESPONSIBLE_BEARER);
+}
+
+/**
+* Outward toward the application (or into the accumulator).
+* Default implementation gives the overriding class the StringBuilder it
+*   understands. It costs a copy.
+*
+* @param  buf    A pointer to the slice. Remains the caller's.
+* @param  mm     A declaration of memory-management responsibility.
+* @return A declaration of memory-management responsibility.
+*/
+int8_t BufferPipe::fromCounterparty(BufferSlice* buf, int8_t mm) {
+  StringBuilder temp;
+  buf->copyTo(&temp);
+  return fromCounterparty(&temp, MEM_MGMT_RESPONSIBLE_BEARER);
+}
+
+
 /**
 * Sets the slot that sits nearer to the counterparty, as well as the default
 *   memory-management strategy for buffers moving toward the application.
@@ -60,6 +60,7 @@ See UDPPipe for a case where this matters.
 #define __MANUVR_DS_BUFFER_PIPE_H
 
 #include <DataStructures/StringBuilder.h>  // Our notion of buffer.
+#include <DataStructures/BufferSlice.h>    // ...and its zero-copy cousin.
 #include <CommonConstants.h>
 #include <EnumeratedTypeCodes.h>
 
@@ -117,7 +118,9 @@ enum class ManuvrPipeSignal : uint8_t {
   XPORT_RESET,         // reset()
   XPORT_LISTEN,        // listen()
   XPORT_CONNECT,       // connect()/connected()
-  XPORT_DISCONNECT     // disconnect()/disconnected()
+  XPORT_DISCONNECT,    // disconnect()/disconnected()
+  XPORT_CONGESTED,     // The transport's outbound queue is past its limit.
+  XPORT_DRAINED        // The transport's outbound queue has come back down.
 };
 
 /*
@@ -196,6 +199,18 @@ class BufferPipe {
     virtual int8_t toCounterparty(StringBuilder*, int8_t mm);
     virtual int8_t fromCounterparty(StringBuilder*, int8_t mm);
 
+    /*
+    * Sending reference-counted slices through pipes...
+    * The caller always keeps (and later releases) its own reference. A pipe
+    *   that wants the data after returning should append() the slice to one
+    *   of its own. So unlike the above, nothing is handed off.
+    * The default implementations copy into a StringBuilder, and pass that to
+    *   the override above. Pipes that can work on slices directly should
+    *   override these to avoid the copy.
+    */
+    virtual int8_t toCounterparty(BufferSlice*, int8_t mm);
+    virtual int8_t fromCounterparty(BufferSlice*, int8_t mm);
+
     /*
     * Used by pipes that wish to force asynchronicity WRT to their
     *   buffer movements. It is at discretion of the over-riding class how
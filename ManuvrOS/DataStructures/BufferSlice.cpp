@@ -0,0 +1,338 @@
+/*
+File:   BufferSlice.cpp
+Author: J. Ian Lindsay
+Date:   2026.10.17
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include "BufferSlice.h"
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+
+
+/*******************************************************************************
+* SharedBuffer                                                                 *
+*******************************************************************************/
+
+/**
+* Allocates a new backing of the given size. The object and its bytes come
+*   from a single allocation.
+*
+* @param  len  How many bytes?
+* @return a buffer with one reference, or nullptr on allocation failure.
+*/
+SharedBuffer* SharedBuffer::alloc(unsigned int len) {
+  uint8_t* mem = (uint8_t*) malloc(sizeof(SharedBuffer) + len);
+  if (nullptr == mem) return nullptr;
+  return new (mem) SharedBuffer(mem + sizeof(SharedBuffer), len, false);
+}
+
+
+/**
+* Wraps memory that already exists.
+*
+* @param  buf   The memory.
+* @param  len   How many bytes of it are valid.
+* @param  reap  If true, buf will be free()'d along with the last reference.
+* @return a buffer with one reference, or nullptr on allocation failure.
+*           On failure, buf remains the caller's.
+*/
+SharedBuffer* SharedBuffer::wrap(uint8_t* buf, unsigned int len, bool reap) {
+  if (nullptr == buf) return nullptr;
+  uint8_t* mem = (uint8_t*) malloc(sizeof(SharedBuffer));
+  if (nullptr == mem) return nullptr;
+  return new (mem) SharedBuffer(buf, len, reap);
+}
+
+
+SharedBuffer::SharedBuffer(uint8_t* buf, unsigned int len, bool reap) {
+  _buf  = buf;
+  _cap  = len;
+  _refs = 1;
+  _reap = reap;
+}
+
+
+SharedBuffer::~SharedBuffer() {
+  if (_reap && (nullptr != _buf)) free(_buf);
+  _buf = nullptr;
+}
+
+
+void SharedBuffer::take() {
+  __atomic_add_fetch(&_refs, 1, __ATOMIC_RELAXED);
+}
+
+
+/**
+* Drops a reference. The last one out frees the memory.
+*/
+void SharedBuffer::release() {
+  if (0 == __atomic_sub_fetch(&_refs, 1, __ATOMIC_ACQ_REL)) {
+    this->~SharedBuffer();
+    free(this);
+  }
+}
+
+
+
+/*******************************************************************************
+*   ___ _              ___      _ _              _      _
+*  / __| |__ _ ______ | _ ) ___(_) |___ _ _ _ __| |__ _| |_ ___
+* | (__| / _` (_-<_-< | _ \/ _ \ | / -_) '_| '_ \ / _` |  _/ -_)
+*  \___|_\__,_/__/__/ |___/\___/_|_\___|_| | .__/_\__,_|\__\___|
+*                                          |_|
+* Constructors/destructors, class initialization functions and so-forth...
+*******************************************************************************/
+
+BufferSlice::BufferSlice() {
+}
+
+
+BufferSlice::~BufferSlice() {
+  clear();
+}
+
+
+
+/*******************************************************************************
+* Functions specific to this class                                             *
+*******************************************************************************/
+
+/**
+* Adds a range of the given backing to the end of this slice. We take our
+*   own reference, so the caller may release theirs.
+* A range that picks up where the last segment left off just extends it.
+*
+* @param  b       The backing.
+* @param  offset  Where the range starts.
+* @param  len     How long it is.
+* @return 0 on success, -1 on a bad range, -2 if we ran out of room.
+*/
+int8_t BufferSlice::append(SharedBuffer* b, unsigned int offset, unsigned int len) {
+  if ((nullptr == b) || ((offset + len) > b->capacity())) return -1;
+  if (0 == len) return 0;
+  if (_count > 0) {
+    SliceSegment* last = &_segs[_count - 1];
+    if ((last->backing == b) && ((last->offset + last->len) == offset)) {
+      last->len += len;
+      _len      += len;
+      return 0;
+    }
+  }
+  if (BUFFER_SLICE_MAX_SEGMENTS == _count) {
+    // Out of segments. Pay for a copy now, rather than failing.
+    if (nullptr == contiguous()) return -2;
+  }
+  b->take();
+  _segs[_count].backing = b;
+  _segs[_count].offset  = offset;
+  _segs[_count].len     = len;
+  _count++;
+  _len += len;
+  return 0;
+}
+
+
+/**
+* Shares everything in the given slice, appending it to our own.
+*
+* @param  nu  The slice whose contents we want.
+* @return 0 on success, or the first error from append().
+*/
+int8_t BufferSlice::append(BufferSlice* nu) {
+  if ((nullptr == nu) || (this == nu)) return -1;
+  for (int i = 0; i < nu->_count; i++) {
+    SliceSegment* s = &nu->_segs[i];
+    int8_t ret = append(s->backing, s->offset, s->len);
+    if (0 != ret) return ret;
+  }
+  return 0;
+}
+
+
+/**
+* Appends memory that isn't yet shared.
+*
+* @param  buf   The memory.
+* @param  len   Its length.
+* @param  reap  If true, we take ownership, and it will be free()'d with the
+*                 last reference.
+* @return 0 on success. Non-zero on failure, in which case buf is still the
+*           caller's.
+*/
+int8_t BufferSlice::wrap(uint8_t* buf, unsigned int len, bool reap) {
+  SharedBuffer* b = SharedBuffer::wrap(buf, len, reap);
+  if (nullptr == b) return -1;
+  int8_t ret = append(b, 0, len);
+  if (0 != ret) {
+    b->_reap = false;   // Don't let the backing take buf with it.
+    b->release();
+    return ret;
+  }
+  b->release();
+  return 0;
+}
+
+
+/**
+* iovec-style access to the segments.
+*
+* @param  idx  Which segment?
+* @param  len  Will be set to the segment's length.
+* @return a pointer to the segment's first byte, or nullptr if there is no such segment.
+*/
+uint8_t* BufferSlice::segment(int idx, unsigned int* len) {
+  if ((idx < 0) || (idx >= _count)) {
+    *len = 0;
+    return nullptr;
+  }
+  *len = _segs[idx].len;
+  return (_segs[idx].backing->buffer() + _segs[idx].offset);
+}
+
+
+/**
+* Copies a range out of the slice.
+*
+* @return the number of bytes copied.
+*/
+unsigned int BufferSlice::copyOut(uint8_t* dest, unsigned int offset, unsigned int len) {
+  unsigned int copied = 0;
+  for (int i = 0; (i < _count) && (copied < len); i++) {
+    SliceSegment* s = &_segs[i];
+    if (offset >= s->len) {
+      offset -= s->len;
+      continue;
+    }
+    unsigned int n = s->len - offset;
+    if (n > (len - copied)) n = (len - copied);
+    memcpy(dest + copied, s->backing->buffer() + s->offset + offset, n);
+    copied += n;
+    offset  = 0;
+  }
+  return copied;
+}
+
+
+/**
+* For pipes that only understand StringBuilder.
+*
+* @return 0 on success. -1 on bad argument.
+*/
+int8_t BufferSlice::copyTo(StringBuilder* out) {
+  if (nullptr == out) return -1;
+  for (int i = 0; i < _count; i++) {
+    out->concat(_segs[i].backing->buffer() + _segs[i].offset, (int) _segs[i].len);
+  }
+  return 0;
+}
+
+
+/**
+* Assures that the slice is a single segment, copying if it must.
+*
+* @return a pointer to the contents, or nullptr if empty or allocation failed.
+*/
+uint8_t* BufferSlice::contiguous() {
+  if (0 == _count) return nullptr;
+  if (1 < _count) {
+    SharedBuffer* nu = SharedBuffer::alloc(_len);
+    if (nullptr == nu) return nullptr;
+    unsigned int len = copyOut(nu->buffer(), 0, _len);
+    clear();
+    append(nu, 0, len);
+    nu->release();
+  }
+  return (_segs[0].backing->buffer() + _segs[0].offset);
+}
+
+
+/**
+* Discards bytes from the front. No bytes are moved.
+*/
+void BufferSlice::cull(unsigned int len) {
+  if (len >= _len) {
+    clear();
+    return;
+  }
+  while (len >= _segs[0].len) {
+    len -= _segs[0].len;
+    _drop_front();
+  }
+  _segs[0].offset += len;
+  _segs[0].len    -= len;
+  _len            -= len;
+}
+
+
+/**
+* Discards bytes from the back, keeping the given length.
+*/
+void BufferSlice::truncate(unsigned int len) {
+  if (len >= _len) return;
+  unsigned int kept = 0;
+  int i = 0;
+  while ((i < _count) && ((kept + _segs[i].len) <= len)) {
+    kept += _segs[i++].len;
+  }
+  if ((i < _count) && (kept < len)) {
+    _segs[i].len = len - kept;
+    i++;
+  }
+  for (int n = i; n < _count; n++) {
+    _segs[n].backing->release();
+    _segs[n].backing = nullptr;
+  }
+  _count = i;
+  _len   = len;
+}
+
+
+/**
+* Releases everything.
+*/
+void BufferSlice::clear() {
+  for (int i = 0; i < _count; i++) {
+    _segs[i].backing->release();
+    _segs[i].backing = nullptr;
+  }
+  _count = 0;
+  _len   = 0;
+}
+
+
+void BufferSlice::_drop_front() {
+  _len -= _segs[0].len;
+  _segs[0].backing->release();
+  _count--;
+  memmove(&_segs[0], &_segs[1], _count * sizeof(SliceSegment));
+}
+
+
+/**
+* Debug support method.
+*
+* @param   StringBuilder* The buffer into which this fxn should write its output.
+*/
+void BufferSlice::printDebug(StringBuilder* output) {
+  output->concatf("-- BufferSlice: %u bytes in %d segments\n", _len, _count);
+  for (int i = 0; i < _count; i++) {
+    output->concatf("\t[%d] %p  +%u  %u bytes  (%d refs)\n", i, (void*) _segs[i].backing, _segs[i].offset, _segs[i].len, _segs[i].backing->refs());
+  }
+}
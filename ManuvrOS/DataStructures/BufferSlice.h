@@ -0,0 +1,125 @@
+/*
+File:   BufferSlice.h
+Author: J. Ian Lindsay
+Date:   2026.10.17
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Zero-copy buffers for BufferPipe chains.
+
+A SharedBuffer is a block of memory with a reference count. It is freed when
+  the last reference is released. A BufferSlice is an ordered list of
+  (backing, offset, length) segments, in the manner of an iovec. Each segment
+  holds a reference to its backing, so slices can be appended to one-another,
+  trimmed, and passed along without the bytes moving.
+
+The reference count is atomic, so slices on different threads may share a
+  backing. A BufferSlice itself is not thread-safe. Once a backing has been
+  shared, its contents should be treated as read-only. The owner may tell if
+  it is still the only holder with refs(), and re-use the memory if it is.
+
+See BufferPipe for how these move between pipes.
+*/
+
+
+#ifndef __MANUVR_DS_BUFFER_SLICE_H
+#define __MANUVR_DS_BUFFER_SLICE_H
+
+#include <inttypes.h>
+#include "StringBuilder.h"
+
+/*
+* How many segments a slice can hold before it must collapse itself.
+*/
+#ifndef BUFFER_SLICE_MAX_SEGMENTS
+  #define BUFFER_SLICE_MAX_SEGMENTS   8
+#endif
+
+
+class SharedBuffer {
+  public:
+    /* Both factories return a buffer with a single reference, held by the caller. */
+    static SharedBuffer* alloc(unsigned int len);
+    static SharedBuffer* wrap(uint8_t* buf, unsigned int len, bool reap);
+
+    void take();
+    void release();   // Might free this object. Don't touch it afterward.
+
+    inline uint8_t*     buffer() {    return _buf;   };
+    inline unsigned int capacity() {  return _cap;   };
+    inline int          refs() {      return __atomic_load_n(&_refs, __ATOMIC_ACQUIRE);  };
+
+
+  private:
+    uint8_t*     _buf;
+    unsigned int _cap;
+    int          _refs;
+    bool         _reap;    // Free _buf when we go?
+
+    SharedBuffer(uint8_t* buf, unsigned int len, bool reap);
+    ~SharedBuffer();
+
+    friend class BufferSlice;
+};
+
+
+typedef struct {
+  SharedBuffer* backing;   // We hold one reference to this.
+  unsigned int  offset;    // Where in the backing this segment starts.
+  unsigned int  len;       // How many bytes of the backing belong to us.
+} SliceSegment;
+
+
+class BufferSlice {
+  public:
+    BufferSlice();
+    ~BufferSlice();
+
+    int8_t append(SharedBuffer*, unsigned int offset, unsigned int len);
+    int8_t append(BufferSlice*);
+    int8_t wrap(uint8_t* buf, unsigned int len, bool reap);
+
+    inline unsigned int length() {    return _len;     };
+    inline int          segments() {  return _count;   };
+    uint8_t* segment(int idx, unsigned int* len);
+    inline const SliceSegment* segmentAt(int idx) {
+      return ((idx < 0) || (idx >= _count)) ? nullptr : &_segs[idx];
+    };
+
+    unsigned int copyOut(uint8_t* dest, unsigned int offset, unsigned int len);
+    int8_t copyTo(StringBuilder*);
+    uint8_t* contiguous();
+
+    void cull(unsigned int len);      // Discard this many bytes from the front.
+    void truncate(unsigned int len);  // Discard all but this many bytes from the front.
+    void clear();
+
+    void printDebug(StringBuilder*);
+
+
+  private:
+    SliceSegment _segs[BUFFER_SLICE_MAX_SEGMENTS];
+    unsigned int _len   = 0;
+    uint8_t      _count = 0;
+
+    void _drop_front();
+
+    // Slices hold references. They must not be copied by value.
+    BufferSlice(const BufferSlice&);
+    BufferSlice& operator=(const BufferSlice&);
+};
+
+#endif   // __MANUVR_DS_BUFFER_SLICE_H
@@ -40,6 +40,40 @@ template <class T> class Node{
     T data;
 };
 
+template <class T> class LinkedList;
+
+
+/*
+* Forward iterator over a LinkedList. Each step is one node hop, where get(i)
+*   walks from the root every time.
+*
+* The iterator remembers the node after the one it is on, so the current node
+*   may be removed with LinkedList::remove(ListIterator<T>&) without losing our
+*   place. Any other change to the list invalidates the iterator.
+*/
+template <class T> class ListIterator {
+  public:
+    ListIterator(Node<T>* n) : _prior(nullptr), _node(n), _next((nullptr != n) ? n->next : nullptr) {};
+
+    inline T operator*() {    return _node->data;  };
+    inline bool operator!=(const ListIterator<T>& other) {  return (_node != other._node);  };
+
+    inline ListIterator<T>& operator++() {
+      if (nullptr != _node) _prior = _node;   // Unless it was just removed.
+      _node = _next;
+      _next = (nullptr != _node) ? _node->next : nullptr;
+      return *this;
+    };
+
+
+  private:
+    Node<T>* _prior;   // The last node we passed that is still in the list.
+    Node<T>* _node;    // The current node. Null if it was removed.
+    Node<T>* _next;
+
+    friend class LinkedList<T>;
+};
+
 
 /**
 * This is a linked-list element with a slot for data.
@@ -68,6 +102,11 @@ template <class T> class LinkedList {
     bool hasNext(void);              // Returns false if this list is empty. True otherwise.
     bool contains(T);                // Returns true if this list contains the given data. False if not.
 
+    /* Iteration. Works with range-based for. */
+    inline ListIterator<T> begin() {  return ListIterator<T>(root);     };
+    inline ListIterator<T> end() {    return ListIterator<T>(nullptr);  };
+    bool remove(ListIterator<T>&);   // Removes the iterator's current element. Return true on success.
+
 
   private:
     Node<T> *root;
@@ -279,6 +318,31 @@ template <class T> bool LinkedList<T>::remove(T test_data) {
 }
 
 
+/**
+* Removes the element an iterator is on. The iterator may then be advanced as
+*   usual, but must not be dereferenced until it is.
+*
+* @param  it  The iterator.
+* @return true if an element was removed.
+*/
+template <class T> bool LinkedList<T>::remove(ListIterator<T>& it) {
+  Node<T>* current = it._node;
+  if (nullptr == current) {
+    return false;
+  }
+  if (nullptr != it._prior) {
+    it._prior->next = current->next;
+  }
+  else {
+    root = current->next;
+  }
+  free(current);
+  element_count--;
+  it._node = nullptr;
+  return true;
+}
+
+
 /**
 * Get the first piece of data.
 *
@@ -0,0 +1,202 @@
+/*
+File:   MPSCQueue.h
+Author: J. Ian Lindsay
+Date:   2026.10.17
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Template for a lock-free, multi-producer/single-consumer queue of
+  intrusively-linked elements.
+
+This is how events get into the Kernel from ISRs and foreign threads. Any
+  number of producers may push() concurrently, with no locks and no
+  allocation. Exactly one consumer (the Kernel's thread) may call dequeue()
+  and remove().
+
+Producers push onto a lock-free stack with a single compare-and-swap. The
+  consumer takes the entire stack in one atomic exchange, and reverses it into
+  a private FIFO that only it touches. Because the consumer never pops single
+  elements from the shared stack, there is no ABA hazard.
+
+Each element carries a claim flag that producers must win with an atomic
+  exchange before linking it. So pushing an element that is already pending
+  is refused, rather than corrupting the list. The consumer releases the claim
+  when it hands the element back out.
+
+T must provide the following, and should befriend MPSCQueue<T>:
+    T*      _mp_next;      // Link storage. Owned by the queue.
+    uint8_t _mp_claim;     // Initialize to zero.
+*/
+
+#include <inttypes.h>
+#include <stdlib.h>
+
+#ifndef __MANUVR_DS_MPSC_QUEUE_H
+#define __MANUVR_DS_MPSC_QUEUE_H
+
+
+template <class T> class MPSCQueue {
+  public:
+    MPSCQueue();
+    ~MPSCQueue();
+
+    int  push(T*);             // Any context. Returns 0 on success, -1 on null, -3 if already pending.
+    T*   dequeue();            // Consumer only. Removes and returns the oldest element, or nullptr.
+    bool remove(T*);           // Consumer only. Returns true if the element was pending.
+    int  clear();              // Consumer only. Returns the number of elements dropped.
+
+    /* Any context, but only a snapshot. */
+    inline int  size() {       return __atomic_load_n(&_count, __ATOMIC_RELAXED);  };
+    inline bool hasNext() {    return (0 < size());                                };
+    inline bool contains(T* d) {
+      return ((nullptr != d) && (0 != __atomic_load_n(&d->_mp_claim, __ATOMIC_ACQUIRE)));
+    };
+
+
+  private:
+    T*  _top;        // Shared. The most-recently pushed element.
+    T*  _head;       // Consumer-private. The oldest element taken from _top.
+    T*  _tail;       // Consumer-private. The newest element taken from _top.
+    int _count;      // Shared. Elements pushed and not yet dequeued.
+
+    void _take_pushed();
+    void _release(T*);
+};
+
+
+/**
+* Constructor.
+*/
+template <class T> MPSCQueue<T>::MPSCQueue() {
+  _top   = nullptr;
+  _head  = nullptr;
+  _tail  = nullptr;
+  _count = 0;
+}
+
+
+/**
+* Destructor. Releases anything left in the queue. The elements themselves are
+*   not ours to free.
+*/
+template <class T> MPSCQueue<T>::~MPSCQueue() {
+  clear();
+}
+
+
+/**
+* Pushes the given element. Safe to call from any thread or ISR, concurrently
+*   with other producers and with the consumer.
+*
+* @param  d  The element to push.
+* @return 0 on success, -1 if d is null, or -3 if d is already pending.
+*/
+template <class T> int MPSCQueue<T>::push(T* d) {
+  if (nullptr == d) return -1;
+  if (0 != __atomic_exchange_n(&d->_mp_claim, 1, __ATOMIC_ACQUIRE)) {
+    return -3;
+  }
+  T* top = __atomic_load_n(&_top, __ATOMIC_RELAXED);
+  do {
+    d->_mp_next = top;
+  } while (!__atomic_compare_exchange_n(&_top, &top, d, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+  __atomic_add_fetch(&_count, 1, __ATOMIC_RELAXED);
+  return 0;
+}
+
+
+/**
+* Takes everything the producers have pushed since the last call, and appends
+*   it (oldest first) to the consumer's private list.
+*/
+template <class T> void MPSCQueue<T>::_take_pushed() {
+  T* current = __atomic_exchange_n(&_top, nullptr, __ATOMIC_ACQUIRE);
+  if (nullptr == current) return;
+  // The stack is newest-first. Reverse it.
+  T* chain_tail = current;
+  T* chain_head = nullptr;
+  while (nullptr != current) {
+    T* next = current->_mp_next;
+    current->_mp_next = chain_head;
+    chain_head = current;
+    current    = next;
+  }
+  if (nullptr == _tail) {
+    _head = chain_head;
+  }
+  else {
+    _tail->_mp_next = chain_head;
+  }
+  _tail = chain_tail;
+}
+
+
+/**
+* Hands an element back out. After this, producers may push it again.
+*/
+template <class T> void MPSCQueue<T>::_release(T* d) {
+  d->_mp_next = nullptr;
+  __atomic_sub_fetch(&_count, 1, __ATOMIC_RELAXED);
+  __atomic_store_n(&d->_mp_claim, 0, __ATOMIC_RELEASE);
+}
+
+
+template <class T> T* MPSCQueue<T>::dequeue() {
+  if (nullptr == _head) _take_pushed();
+  T* return_value = _head;
+  if (nullptr != return_value) {
+    _head = return_value->_mp_next;
+    if (nullptr == _head) _tail = nullptr;
+    _release(return_value);
+  }
+  return return_value;
+}
+
+
+/**
+* Removes a specific element. This is a linear search, and is meant for the
+*   uncommon case of aborting an event.
+*/
+template <class T> bool MPSCQueue<T>::remove(T* d) {
+  if ((nullptr == d) || !contains(d)) return false;
+  _take_pushed();
+  T* prior   = nullptr;
+  T* current = _head;
+  while (nullptr != current) {
+    if (current == d) {
+      if (nullptr == prior) _head = d->_mp_next;
+      else                  prior->_mp_next = d->_mp_next;
+      if (_tail == d) _tail = prior;
+      _release(d);
+      return true;
+    }
+    prior   = current;
+    current = current->_mp_next;
+  }
+  // Claimed, but not yet linked by its producer. It will show up shortly.
+  return false;
+}
+
+
+template <class T> int MPSCQueue<T>::clear() {
+  int return_value = 0;
+  while (nullptr != dequeue()) {
+    return_value++;
+  }
+  return return_value;
+}
+
+#endif // __MANUVR_DS_MPSC_QUEUE_H
@@ -51,6 +51,41 @@ template <class T> class PriorityNode{
     int priority;
 };
 
+template <class T> class PriorityQueue;
+
+
+/*
+* Forward iterator over a PriorityQueue, from highest priority to lowest. Each
+*   step is one node hop, where get(i) walks from the root every time.
+*
+* The iterator remembers the node after the one it is on, so the current node
+*   may be removed with PriorityQueue::remove(PriorityIterator<T>&) without
+*   losing our place. Any other change to the queue invalidates the iterator.
+*/
+template <class T> class PriorityIterator {
+  public:
+    PriorityIterator(PriorityNode<T>* n) : _prior(nullptr), _node(n), _next((nullptr != n) ? n->next : nullptr) {};
+
+    inline T   operator*() {    return _node->data;      };
+    inline int priority() {     return _node->priority;  };
+    inline bool operator!=(const PriorityIterator<T>& other) {  return (_node != other._node);  };
+
+    inline PriorityIterator<T>& operator++() {
+      if (nullptr != _node) _prior = _node;   // Unless it was just removed.
+      _node = _next;
+      _next = (nullptr != _node) ? _node->next : nullptr;
+      return *this;
+    };
+
+
+  private:
+    PriorityNode<T>* _prior;   // The last node we passed that is still in the queue.
+    PriorityNode<T>* _node;    // The current node. Null if it was removed.
+    PriorityNode<T>* _next;
+
+    friend class PriorityQueue<T>;
+};
+
 
 /*
 * The class that should be instantiated.
@@ -86,6 +121,11 @@ template <class T> class PriorityQueue {
     bool incrementPriority(T);    // Finds the given T and increments its priority by one.
     bool decrementPriority(T);    // Finds the given T and decrements its priority by one.
 
+    /* Iteration. Works with range-based for. */
+    inline PriorityIterator<T> begin() {  return PriorityIterator<T>(root);     };
+    inline PriorityIterator<T> end() {    return PriorityIterator<T>(nullptr);  };
+    bool remove(PriorityIterator<T>&);   // Removes the iterator's current element. Return true on success.
+
 
   private:
     PriorityNode<T> *root;        // The root of the queue. Is also the highest-priority.
@@ -573,6 +613,36 @@ template <class T> bool PriorityQueue<T>::remove(T test_data) {
   return return_value;
 }
 
+/**
+* Removes the element an iterator is on. The iterator may then be advanced as
+*   usual, but must not be dereferenced until it is.
+*
+* @param  it  The iterator.
+* @return true if an element was removed.
+*/
+template <class T> bool PriorityQueue<T>::remove(PriorityIterator<T>& it) {
+  PriorityNode<T>* current = it._node;
+  if (nullptr == current) {
+    return false;
+  }
+  #ifdef __MANUVR_LINUX
+    pthread_mutex_lock(&_mutex);
+  #endif
+  if (nullptr != it._prior) {
+    it._prior->next = current->next;
+  }
+  else {
+    root = current->next;
+  }
+  free(current);
+  element_count--;
+  it._node = nullptr;
+  #ifdef __MANUVR_LINUX
+    pthread_mutex_unlock(&_mutex);
+  #endif
+  return true;
+}
+
 #if __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6)
 #pragma GCC diagnostic push
 #endif
@@ -21,7 +21,9 @@ limitations under the License.
 Template for a ring buffer.
 
 TODO: Rework modulus operations into bit mask, and make element count pow(2).
-TODO: Audit for best-practices for a lock-free design.
+
+This is not safe for concurrent use. For a lock-free stream between one
+  producer and one consumer, see SPSCRingBuffer.
 */
 
 #include <stdlib.h>
@@ -104,7 +106,7 @@ template <class T> int RingBuffer<T>::insert(T d) {
   for (unsigned int i = 0; i < _E_SIZE; i++) {
     *((uint8_t*) _pool + offset + i) = *((uint8_t*)ref + i);
   }
-  _w = (_w % _CAPAC) + 1;   // TODO: Convert to pow(2) later and convert to bitmask.
+  _w = (_w + 1) % _CAPAC;   // TODO: Convert to pow(2) later and convert to bitmask.
   _count++;
   return 0;
 }
@@ -115,7 +117,7 @@ template <class T> T RingBuffer<T>::get() {
     return (T)0;
   }
   T *return_value = (T*) (_pool + (_r * _E_SIZE));
-  _r = (_r % _CAPAC) + 1;   // TODO: Convert to pow(2) later and convert to bitmask.
+  _r = (_r + 1) % _CAPAC;   // TODO: Convert to pow(2) later and convert to bitmask.
   _count--;
   return *return_value;
 }
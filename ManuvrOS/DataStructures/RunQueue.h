@@ -0,0 +1,284 @@
+/*
+File:   RunQueue.h
+Author: J. Ian Lindsay
+Date:   2026.10.17
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Template for a bucketed priority queue of intrusively-linked elements.
+
+This is the Kernel's execution queue. It has the same ordering semantics as
+  PriorityQueue (highest priority first, FIFO within a priority), but it never
+  allocates, and insertion, removal, and membership tests are all O(1).
+
+There is one bucket for each of the 256 possible 8-bit priorities. Each bucket
+  is a circular doubly-linked list threaded through the elements themselves.
+  A bitmap of occupied buckets lets dequeue() find the highest non-empty bucket
+  in (at most) eight word tests.
+
+Elements that carry a deadline are filed earliest-deadline-first within their
+  bucket, ahead of any that don't. Elements without one stay FIFO. The Kernel
+  can also ask for the highest element within a range of priorities, which is
+  how it serves its scheduling bands separately.
+
+Because the links live in the element, an element can only be in one RunQueue
+  at a time. T must provide the following, and should befriend RunQueue<T>:
+    T*      _rq_next;        // Link storage. Owned by the queue.
+    T*      _rq_prev;        // Link storage. Owned by the queue.
+    uint8_t _rq_pri;         // The bucket the element was filed under.
+    uint8_t priority();      // The priority to file the element under.
+    uint32_t deadline();     // When (in uS) the element is due, or zero if never.
+    bool    isQueued();      // The idempotency flag.
+    void    isQueued(bool);
+*/
+
+#include <inttypes.h>
+#include <stdlib.h>
+
+#ifndef __MANUVR_DS_RUN_QUEUE_H
+#define __MANUVR_DS_RUN_QUEUE_H
+
+#ifdef __MANUVR_LINUX
+  #include <pthread.h>
+#endif
+
+#define RUN_QUEUE_BUCKETS        256
+#define RUN_QUEUE_BITMAP_WORDS   (RUN_QUEUE_BUCKETS / 32)
+
+
+template <class T> class RunQueue {
+  public:
+    RunQueue();
+    ~RunQueue();
+
+    int  insert(T*);           // Returns 0 on success, -1 on null, -3 if already queued.
+    T*   dequeue();            // Removes and returns the highest-priority element, or nullptr.
+    T*   get();                // Returns the highest-priority element without removing it.
+    T*   dequeue(uint8_t lo, uint8_t hi);  // As dequeue(), but only from priorities lo through hi.
+    T*   get(uint8_t lo, uint8_t hi);      // As get(), but only from priorities lo through hi.
+    bool remove(T*);           // Removes the given element. Returns true if it was queued.
+    int  clear();              // Empties the queue. Returns the number of elements dropped.
+
+    inline int  size() {               return _count;              };
+    inline bool hasNext() {            return (0 < _count);        };
+    inline bool contains(T* d) {       return ((nullptr != d) && d->isQueued());  };
+
+
+  private:
+    T*       _heads[RUN_QUEUE_BUCKETS];         // The oldest element in each bucket.
+    uint32_t _occupied[RUN_QUEUE_BITMAP_WORDS]; // One bit per non-empty bucket.
+    int      _count;
+    #if defined(__MANUVR_LINUX)
+      // If we are on linux, we control for concurrency with a mutex...
+      pthread_mutex_t _mutex;
+    #endif
+
+    inline void _lock() {
+      #if defined(__MANUVR_LINUX)
+        pthread_mutex_lock(&_mutex);
+      #endif
+    };
+
+    inline void _unlock() {
+      #if defined(__MANUVR_LINUX)
+        pthread_mutex_unlock(&_mutex);
+      #endif
+    };
+
+    int  _highest_bucket(uint8_t lo, uint8_t hi);
+    void _unlink(T*);
+};
+
+
+/**
+* Constructor.
+*/
+template <class T> RunQueue<T>::RunQueue() {
+  _count = 0;
+  for (int i = 0; i < RUN_QUEUE_BUCKETS; i++)      _heads[i]    = nullptr;
+  for (int i = 0; i < RUN_QUEUE_BITMAP_WORDS; i++) _occupied[i] = 0;
+  #ifdef __MANUVR_LINUX
+    #if defined (PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP)
+    _mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+    #else
+    _mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER;
+    #endif
+  #endif
+}
+
+
+/**
+* Destructor. Unlinks anything left in the queue. The elements themselves are
+*   not ours to free.
+*/
+template <class T> RunQueue<T>::~RunQueue() {
+  clear();
+  #ifdef __MANUVR_LINUX
+    pthread_mutex_destroy(&_mutex);
+  #endif
+}
+
+
+/**
+* Files the given element at the tail of the bucket for its priority.
+*
+* @param  d  The element to insert.
+* @return 0 on success, -1 if d is null, or -3 if d is already queued.
+*/
+template <class T> int RunQueue<T>::insert(T* d) {
+  if (nullptr == d) return -1;
+  _lock();
+  if (d->isQueued()) {
+    _unlock();
+    return -3;
+  }
+  const uint8_t b = d->priority();
+  T* head = _heads[b];
+  if (nullptr == head) {
+    d->_rq_next = d;
+    d->_rq_prev = d;
+    _heads[b]   = d;
+    _occupied[b >> 5] |= (1UL << (b & 0x1F));
+  }
+  else {
+    T* at = head;   // We link in just before this element. Before the head is the tail.
+    const uint32_t due = d->deadline();
+    if (0 != due) {
+      // Walk past anything due no later than us. Only deadlines are walked.
+      T* cur = head;
+      do {
+        const uint32_t cur_due = cur->deadline();
+        if ((0 == cur_due) || (0 < (int32_t) (cur_due - due))) {
+          at = cur;
+          if (cur == head) _heads[b] = d;
+          break;
+        }
+        cur = cur->_rq_next;
+      } while (cur != head);
+    }
+    T* prev = at->_rq_prev;
+    prev->_rq_next = d;
+    d->_rq_prev    = prev;
+    d->_rq_next    = at;
+    at->_rq_prev   = d;
+  }
+  d->_rq_pri = b;
+  d->isQueued(true);
+  _count++;
+  _unlock();
+  return 0;
+}
+
+
+/**
+* @param  lo  The lowest bucket to consider.
+* @param  hi  The highest bucket to consider.
+* @return the index of the highest non-empty bucket in the range, or -1 if none.
+*/
+template <class T> int RunQueue<T>::_highest_bucket(uint8_t lo, uint8_t hi) {
+  for (int w = (hi >> 5); w >= (lo >> 5); w--) {
+    uint32_t bits = _occupied[w];
+    if (w == (hi >> 5)) bits &= (0xFFFFFFFFUL >> (31 - (hi & 0x1F)));
+    if (w == (lo >> 5)) bits &= (0xFFFFFFFFUL << (lo & 0x1F));
+    if (bits) {
+      return ((w << 5) + (31 - __builtin_clz(bits)));
+    }
+  }
+  return -1;
+}
+
+
+/**
+* Unlinks the given element from its bucket. Caller must hold the lock and
+*   must have already established that the element is queued.
+*/
+template <class T> void RunQueue<T>::_unlink(T* d) {
+  const uint8_t b = d->_rq_pri;
+  if (d->_rq_next == d) {
+    // Sole occupant of the bucket.
+    _heads[b] = nullptr;
+    _occupied[b >> 5] &= ~(1UL << (b & 0x1F));
+  }
+  else {
+    d->_rq_prev->_rq_next = d->_rq_next;
+    d->_rq_next->_rq_prev = d->_rq_prev;
+    if (_heads[b] == d) _heads[b] = d->_rq_next;
+  }
+  d->_rq_next = nullptr;
+  d->_rq_prev = nullptr;
+  d->isQueued(false);
+  _count--;
+}
+
+
+template <class T> T* RunQueue<T>::dequeue() {
+  return dequeue(0, RUN_QUEUE_BUCKETS - 1);
+}
+
+
+template <class T> T* RunQueue<T>::get() {
+  return get(0, RUN_QUEUE_BUCKETS - 1);
+}
+
+
+template <class T> T* RunQueue<T>::dequeue(uint8_t lo, uint8_t hi) {
+  T* return_value = nullptr;
+  _lock();
+  int b = _highest_bucket(lo, hi);
+  if (0 <= b) {
+    return_value = _heads[b];
+    _unlink(return_value);
+  }
+  _unlock();
+  return return_value;
+}
+
+
+template <class T> T* RunQueue<T>::get(uint8_t lo, uint8_t hi) {
+  T* return_value = nullptr;
+  _lock();
+  int b = _highest_bucket(lo, hi);
+  if (0 <= b) {
+    return_value = _heads[b];
+  }
+  _unlock();
+  return return_value;
+}
+
+
+template <class T> bool RunQueue<T>::remove(T* d) {
+  bool return_value = false;
+  if (nullptr != d) {
+    _lock();
+    if (d->isQueued()) {
+      _unlink(d);
+      return_value = true;
+    }
+    _unlock();
+  }
+  return return_value;
+}
+
+
+template <class T> int RunQueue<T>::clear() {
+  int return_value = 0;
+  while (nullptr != dequeue()) {
+    return_value++;
+  }
+  return return_value;
+}
+
+#endif // __MANUVR_DS_RUN_QUEUE_H
@@ -0,0 +1,290 @@
+/*
+File:   SPSCRingBuffer.h
+Author: J. Ian Lindsay
+Date:   2026.10.17
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Template for a lock-free, single-producer/single-consumer ring buffer.
+
+This is for streams that cross from a reader thread (or ISR) to the Kernel:
+  audio samples, GPS and UART bytes, and the like. Exactly one context may
+  write, and exactly one (other) context may read. Neither ever blocks.
+
+Capacity is rounded up to a power of two, so that indexing is a mask. The
+  read and write indices run freely and are never wrapped, so full and empty
+  are distinguishable without a shared count. Each side owns its own index,
+  publishes it with a release store, and reads the other's with an acquire
+  load. Each side also keeps a private copy of the other's index, and only
+  looks at the real thing when the copy says it can't proceed. The two
+  sides' state live on separate cache lines.
+
+T must be safe to copy with memcpy().
+
+Unlike RingBuffer, this is not safe for use by more than one producer or
+  more than one consumer. See MPSCQueue for that case.
+*/
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef __MANUVR_DS_SPSC_RING_BUFFER_H
+#define __MANUVR_DS_SPSC_RING_BUFFER_H
+
+#ifndef MANUVR_CACHE_LINE_SIZE
+  #if defined(__MANUVR_LINUX)
+    #define MANUVR_CACHE_LINE_SIZE   64
+  #else
+    #define MANUVR_CACHE_LINE_SIZE   16
+  #endif
+#endif
+
+
+template <class T> class SPSCRingBuffer {
+  public:
+    SPSCRingBuffer(const unsigned int c);  // Rounded up to a power of two.
+    ~SPSCRingBuffer();
+
+    /* Producer only. */
+    int          insert(T);                       // Returns 0 on success, -1 if full.
+    unsigned int write(const T*, unsigned int);   // Returns how many were taken.
+
+    /* Consumer only. */
+    int          get(T*);                         // Returns 0 on success, -1 if empty.
+    unsigned int read(T*, unsigned int);          // Returns how many were given.
+    unsigned int peek(T*, unsigned int);          // As read(), but leaves them buffered.
+    unsigned int skip(unsigned int);              // Discards up to this many.
+
+    /* Neither side may be active. */
+    void clear();
+
+    /* Any context, but only a snapshot. */
+    inline unsigned int count() {
+      return (__atomic_load_n(&_w, __ATOMIC_ACQUIRE) - __atomic_load_n(&_r, __ATOMIC_ACQUIRE));
+    };
+    inline unsigned int vacancy() {    return (_CAPAC - count());        };
+    inline bool         allocated() {  return (nullptr != _pool);        };
+    inline unsigned int capacity() {   return _CAPAC;                    };
+    inline unsigned int heap_use() {   return (sizeof(T) * _CAPAC);      };
+
+
+  private:
+    // Producer's cache line.
+    unsigned int _w;         // Elements ever written.
+    unsigned int _r_seen;    // The producer's last look at _r.
+    uint8_t _pad0[MANUVR_CACHE_LINE_SIZE - (2 * sizeof(unsigned int))];
+
+    // Consumer's cache line.
+    unsigned int _r;         // Elements ever read.
+    unsigned int _w_seen;    // The consumer's last look at _w.
+    uint8_t _pad1[MANUVR_CACHE_LINE_SIZE - (2 * sizeof(unsigned int))];
+
+    // Shared, but never written after construction.
+    const unsigned int _CAPAC;
+    const unsigned int _MASK;
+    T* _pool;
+
+    static unsigned int _pow2(unsigned int);
+    inline unsigned int _readable();
+    inline unsigned int _writable();
+    void _copy_out(T*, unsigned int r, unsigned int n);
+};
+
+
+/**
+* @return the smallest power of two that is at least x.
+*/
+template <class T> unsigned int SPSCRingBuffer<T>::_pow2(unsigned int x) {
+  unsigned int p = 1;
+  while (p < x) p = p << 1;
+  return p;
+}
+
+
+/**
+* Constructor.
+*
+* @param c  The minimum number of elements. Will be rounded up to a power of two.
+*/
+template <class T> SPSCRingBuffer<T>::SPSCRingBuffer(const unsigned int c) : _CAPAC(_pow2(c)), _MASK(_pow2(c) - 1) {
+  _pool = (T*) malloc(sizeof(T) * _CAPAC);
+  clear();
+}
+
+
+template <class T> SPSCRingBuffer<T>::~SPSCRingBuffer() {
+  if (nullptr != _pool) {
+    free(_pool);
+    _pool = nullptr;
+  }
+}
+
+
+/**
+* Empties the buffer. Neither the producer nor the consumer may be using it.
+*/
+template <class T> void SPSCRingBuffer<T>::clear() {
+  _w      = 0;
+  _r      = 0;
+  _r_seen = 0;
+  _w_seen = 0;
+  if (nullptr != _pool) memset(_pool, 0, sizeof(T) * _CAPAC);
+}
+
+
+/**
+* Producer only.
+* @return how many elements can be written without looking at _r again.
+*/
+template <class T> unsigned int SPSCRingBuffer<T>::_writable() {
+  unsigned int free_slots = _CAPAC - (_w - _r_seen);
+  if (0 == free_slots) {
+    _r_seen    = __atomic_load_n(&_r, __ATOMIC_ACQUIRE);
+    free_slots = _CAPAC - (_w - _r_seen);
+  }
+  return free_slots;
+}
+
+
+/**
+* Consumer only.
+* @return how many elements can be read without looking at _w again.
+*/
+template <class T> unsigned int SPSCRingBuffer<T>::_readable() {
+  unsigned int avail = _w_seen - _r;
+  if (0 == avail) {
+    _w_seen = __atomic_load_n(&_w, __ATOMIC_ACQUIRE);
+    avail   = _w_seen - _r;
+  }
+  return avail;
+}
+
+
+/**
+* Producer only. Copies the element in.
+*
+* @return 0 on success, or -1 if the buffer is full (or unallocated).
+*/
+template <class T> int SPSCRingBuffer<T>::insert(T d) {
+  if ((nullptr == _pool) || (0 == _writable())) return -1;
+  const unsigned int w = _w;
+  _pool[w & _MASK] = d;
+  __atomic_store_n(&_w, w + 1, __ATOMIC_RELEASE);
+  return 0;
+}
+
+
+/**
+* Producer only. Copies in as many of the given elements as will fit.
+*
+* @param  src  The elements.
+* @param  len  How many are offered.
+* @return how many were taken.
+*/
+template <class T> unsigned int SPSCRingBuffer<T>::write(const T* src, unsigned int len) {
+  if (nullptr == _pool) return 0;
+  unsigned int n = _writable();
+  if (n < len) {
+    // Have a fresh look. The consumer may have caught up.
+    _r_seen = __atomic_load_n(&_r, __ATOMIC_ACQUIRE);
+    n = _CAPAC - (_w - _r_seen);
+  }
+  if (n > len) n = len;
+  if (0 == n) return 0;
+  const unsigned int w     = _w;
+  const unsigned int idx   = w & _MASK;
+  const unsigned int first = ((_CAPAC - idx) < n) ? (_CAPAC - idx) : n;
+  memcpy(&_pool[idx], src, first * sizeof(T));
+  if (first < n) memcpy(&_pool[0], src + first, (n - first) * sizeof(T));
+  __atomic_store_n(&_w, w + n, __ATOMIC_RELEASE);
+  return n;
+}
+
+
+/**
+* Consumer only.
+*
+* @param  d  Where to put the oldest element.
+* @return 0 on success, or -1 if there was nothing to get.
+*/
+template <class T> int SPSCRingBuffer<T>::get(T* d) {
+  if ((nullptr == _pool) || (0 == _readable())) return -1;
+  const unsigned int r = _r;
+  *d = _pool[r & _MASK];
+  __atomic_store_n(&_r, r + 1, __ATOMIC_RELEASE);
+  return 0;
+}
+
+
+template <class T> void SPSCRingBuffer<T>::_copy_out(T* dest, unsigned int r, unsigned int n) {
+  const unsigned int idx   = r & _MASK;
+  const unsigned int first = ((_CAPAC - idx) < n) ? (_CAPAC - idx) : n;
+  memcpy(dest, &_pool[idx], first * sizeof(T));
+  if (first < n) memcpy(dest + first, &_pool[0], (n - first) * sizeof(T));
+}
+
+
+/**
+* Consumer only. Copies out, and removes, as many elements as are available.
+*
+* @param  dest  Where to put them.
+* @param  len   How many dest can hold.
+* @return how many were given.
+*/
+template <class T> unsigned int SPSCRingBuffer<T>::read(T* dest, unsigned int len) {
+  unsigned int n = peek(dest, len);
+  if (0 < n) __atomic_store_n(&_r, _r + n, __ATOMIC_RELEASE);
+  return n;
+}
+
+
+/**
+* Consumer only. Copies out as many elements as are available, but leaves them
+*   in the buffer.
+*
+* @param  dest  Where to put them.
+* @param  len   How many dest can hold.
+* @return how many were given.
+*/
+template <class T> unsigned int SPSCRingBuffer<T>::peek(T* dest, unsigned int len) {
+  if (nullptr == _pool) return 0;
+  unsigned int n = _readable();
+  if (n < len) {
+    _w_seen = __atomic_load_n(&_w, __ATOMIC_ACQUIRE);
+    n = _w_seen - _r;
+  }
+  if (n > len) n = len;
+  if (0 < n) _copy_out(dest, _r, n);
+  return n;
+}
+
+
+/**
+* Consumer only. Discards elements without copying them.
+*
+* @param  len  How many to discard, at most.
+* @return how many were discarded.
+*/
+template <class T> unsigned int SPSCRingBuffer<T>::skip(unsigned int len) {
+  _w_seen = __atomic_load_n(&_w, __ATOMIC_ACQUIRE);
+  unsigned int n = _w_seen - _r;
+  if (n > len) n = len;
+  if (0 < n) __atomic_store_n(&_r, _r + n, __ATOMIC_RELEASE);
+  return n;
+}
+
+#endif // __MANUVR_DS_SPSC_RING_BUFFER_H
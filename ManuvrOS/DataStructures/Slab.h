@@ -0,0 +1,143 @@
+/*
+File:   Slab.h
+Author: J. Ian Lindsay
+Date:   2026.10.17
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Template for a fixed-size, lock-free slab of raw memory for objects of type T.
+
+This is the raw-memory counterpart to ElementPool. ElementPool hands out
+  objects that already exist. A Slab hands out uninitialized cells, and so is
+  meant to back a class-specific operator new/delete. As with ElementPool, a
+  cell is recognized as ours by its address, and a starved caller is expected
+  to fall back to the heap.
+
+The free list is a stack of cell indices. Its head carries a tag that changes
+  with every push and pop, so that a compare-and-swap can't be fooled by a
+  cell that was taken and returned in the meantime. Any context may take or
+  give, without locks.
+
+A zeroed Slab is a valid, empty Slab, and there is no constructor. So a Slab
+  with static storage duration is ready before any static constructor runs.
+  Cells that have never been handed out are taken from the end of the slab
+  until there are none left. Thereafter, only the free list is used.
+*/
+
+#include <stdint.h>
+
+#ifndef __MANUVR_DS_SLAB_H
+#define __MANUVR_DS_SLAB_H
+
+#if defined(MANUVR_DEBUG)
+  #include "StringBuilder.h"
+#endif
+
+
+template <class T, unsigned int N> class Slab {
+  public:
+    void* take();         // Returns nullptr if the slab is exhausted.
+    bool  give(void*);    // Returns false if the pointer isn't ours.
+
+    inline bool inSlab(const void* p) {
+      return ((((uintptr_t) p) >= ((uintptr_t) &_cells[0])) && (((uintptr_t) p) < ((uintptr_t) &_cells[N])));
+    };
+
+    inline unsigned int capacity() {      return N;                                           };
+    inline unsigned int outstanding() {   return __atomic_load_n(&_out, __ATOMIC_RELAXED);    };
+    inline unsigned int starves() {       return __atomic_load_n(&_starves, __ATOMIC_RELAXED); };
+    inline unsigned int highWaterMark() { return __atomic_load_n(&_peak, __ATOMIC_RELAXED);   };
+
+    #if defined(MANUVR_DEBUG)
+    void printDebug(StringBuilder* output) {
+      output->concatf("Slab (%u x %u bytes)\n", N, sizeof(Cell));
+      output->concatf("\tOutstanding:    %u/%u\n\tHigh Watermark: %u\n", outstanding(), N, highWaterMark());
+      output->concatf("\tStarves:        %u\n", starves());
+    };
+    #endif
+
+
+  private:
+    union Cell {
+      uint16_t next;                // Index of the next free cell, plus one. Only while free.
+      uint8_t  mem[sizeof(T)];
+      uint64_t _align;
+    };
+
+    Cell     _cells[N];
+    uint32_t _head;      // (tag << 16) | (index of the top free cell, plus one). Zero is empty.
+    uint32_t _fresh;     // How many cells have ever been handed out. Never more than N matter.
+    uint32_t _out;       // How many cells are presently handed out?
+    uint32_t _peak;      // The most cells that have ever been out at once.
+    uint32_t _starves;   // How many times were we asked for a cell we didn't have?
+
+    inline void _note_take() {
+      uint32_t out  = __atomic_add_fetch(&_out, 1, __ATOMIC_RELAXED);
+      uint32_t peak = __atomic_load_n(&_peak, __ATOMIC_RELAXED);
+      while ((out > peak) && !__atomic_compare_exchange_n(&_peak, &peak, out, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+    };
+};
+
+
+/**
+* @return an uninitialized cell, or nullptr if there are none left.
+*/
+template <class T, unsigned int N> void* Slab<T, N>::take() {
+  uint32_t head = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+  while (0 != (head & 0xFFFF)) {
+    const uint16_t idx  = (head & 0xFFFF) - 1;
+    const uint16_t next = __atomic_load_n(&_cells[idx].next, __ATOMIC_RELAXED);
+    const uint32_t nu   = ((head + 0x10000) & 0xFFFF0000) | next;
+    if (__atomic_compare_exchange_n(&_head, &head, nu, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+      _note_take();
+      return (void*) &_cells[idx];
+    }
+  }
+
+  // The free list is empty. Are there any cells we've never used?
+  if (__atomic_load_n(&_fresh, __ATOMIC_RELAXED) < N) {
+    const uint32_t idx = __atomic_fetch_add(&_fresh, 1, __ATOMIC_RELAXED);
+    if (idx < N) {
+      _note_take();
+      return (void*) &_cells[idx];
+    }
+  }
+  __atomic_add_fetch(&_starves, 1, __ATOMIC_RELAXED);
+  return nullptr;
+}
+
+
+/**
+* Returns a cell to the slab. The object that was in it must already have been
+*   destroyed.
+*
+* @param  p  The cell.
+* @return true if the cell was ours, and false if the caller must free it some other way.
+*/
+template <class T, unsigned int N> bool Slab<T, N>::give(void* p) {
+  if (!inSlab(p)) return false;
+  const uint16_t idx = (uint16_t) (((Cell*) p) - &_cells[0]);
+  uint32_t head = __atomic_load_n(&_head, __ATOMIC_RELAXED);
+  uint32_t nu;
+  do {
+    __atomic_store_n(&_cells[idx].next, (uint16_t) (head & 0xFFFF), __ATOMIC_RELAXED);
+    nu = ((head + 0x10000) & 0xFFFF0000) | (uint32_t) (idx + 1);
+  } while (!__atomic_compare_exchange_n(&_head, &head, nu, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+  __atomic_sub_fetch(&_out, 1, __ATOMIC_RELAXED);
+  return true;
+}
+
+#endif // __MANUVR_DS_SLAB_H
@@ -126,7 +126,9 @@ StringBuilder::StringBuilder() {
   root        = nullptr;
   str         = nullptr;
   col_length  = 0;
+  _str_cap    = 0;
   preserve_ll = false;
+  _coalesce   = false;
   #if defined(__BUILD_HAS_PTHREADS)
     #if defined (PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP)
     _mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
@@ -211,9 +213,8 @@ unsigned short StringBuilder::count() {
 unsigned char* StringBuilder::string() {
   if ((this->str == nullptr) && (this->root == nullptr)) {
     // Nothing in this object. Return a zero-length string.
-    this->str = (uint8_t*) malloc(1);
-    this->str[0] = '\0';
     this->col_length  = 0;
+    _reserve(0);
   }
   else {
     this->collapseIntoBuffer();
@@ -237,6 +238,7 @@ void StringBuilder::clear() {
   this->root   = nullptr;
   this->str    = nullptr;
   this->col_length = 0;
+  this->_str_cap   = 0;
   #if defined(__BUILD_HAS_PTHREADS)
     //pthread_mutex_unlock(&_mutex);
   #elif defined(__BUILD_HAS_FREERTOS)
@@ -379,6 +381,7 @@ bool StringBuilder::drop_position(unsigned int pos) {
   if (this->str != nullptr) {
     if (pos == 0) {
       this->col_length = 0;
+      this->_str_cap   = 0;
       free(this->str);
       this->str = nullptr;
       return true;
@@ -418,6 +421,7 @@ bool StringBuilder::drop_position(unsigned int pos) {
 *   taking the data we now have with it.
 */
 void StringBuilder::concatHandoff(StringBuilder *nu) {
+  if (nullptr == nu) return;
   #if defined(__BUILD_HAS_PTHREADS)
     pthread_mutex_lock(&_mutex);
     pthread_mutex_lock(&nu->_mutex);
@@ -425,12 +429,20 @@ void StringBuilder::concatHandoff(StringBuilder *nu) {
     //xSemaphoreTakeRecursive(&_mutex, 0);
     //xSemaphoreTakeRecursive(&nu->_mutex, 0);
   #endif
-  if ((nullptr != nu) && (nu->length() > 0)) {
-    nu->promote_collapsed_into_ll();   // Promote the previously-collapsed string.
+  int nu_len = nu->length();
+  if (nu_len > 0) {
+    if (_coalesce && (nullptr == this->root) && (nullptr == nu->root) && (nu_len <= STRINGBUILDER_COALESCE_LIMIT)) {
+      // Small and already collapsed. Copying is cheaper than carrying the element.
+      this->_append(nu->str, nu_len);
+      nu->clear();
+    }
+    else {
+      nu->promote_collapsed_into_ll();   // Promote the previously-collapsed string.
 
-    if (nullptr != nu->root) {
-      this->stackStrOntoList(nu->root);
-      nu->root = nullptr;  // Inform the origin instance...
+      if (nullptr != nu->root) {
+        this->stackStrOntoList(nu->root);
+        nu->root = nullptr;  // Inform the origin instance...
+      }
     }
   }
   #if defined(__BUILD_HAS_PTHREADS)
@@ -495,13 +507,19 @@ void StringBuilder::concatHandoff(uint8_t* buf, int len) {
       //pthread_mutex_lock(&_mutex);
     #elif defined(__BUILD_HAS_FREERTOS)
     #endif
-    StrLL *nu_element = (StrLL *) malloc(sizeof(StrLL));
-    if (nu_element) {
-      nu_element->reap = true;
-      nu_element->next = nullptr;
-      nu_element->len  = len;
-      nu_element->str  = buf;
-      this->stackStrOntoList(nu_element);
+    if (_coalesce && (nullptr == this->root) && (len <= STRINGBUILDER_COALESCE_LIMIT)) {
+      this->_append(buf, len);
+      free(buf);
+    }
+    else {
+      StrLL *nu_element = (StrLL *) malloc(sizeof(StrLL));
+      if (nu_element) {
+        nu_element->reap = true;
+        nu_element->next = nullptr;
+        nu_element->len  = len;
+        nu_element->str  = buf;
+        this->stackStrOntoList(nu_element);
+      }
     }
     #if defined(__BUILD_HAS_PTHREADS)
       //pthread_mutex_unlock(&_mutex);
@@ -528,6 +546,7 @@ StrLL* StringBuilder::promote_collapsed_into_ll(void) {
       nu_element->len = this->col_length;
       this->str = nullptr;
       this->col_length = 0;
+      this->_str_cap   = 0;
     }
   }
   return this->root;
@@ -538,6 +557,15 @@ StrLL* StringBuilder::promote_collapsed_into_ll(void) {
 */
 void StringBuilder::prepend(uint8_t*nu, int len) {
   if ((nullptr != nu) && (len > 0)) {
+    if (_coalesce && (nullptr == this->root)) {
+      // Shift the collapsed string up and write in front of it.
+      if (_reserve(this->col_length + len)) {
+        memmove(this->str + len, this->str, this->col_length + 1);
+        memcpy(this->str, nu, len);
+        this->col_length += len;
+      }
+      return;
+    }
     this->root = promote_collapsed_into_ll();   // Promote the previously-collapsed string.
 
     StrLL *nu_element = (StrLL *) malloc(sizeof(StrLL));
@@ -586,17 +614,11 @@ void StringBuilder::concat(uint8_t*nu, int len) {
       //pthread_mutex_lock(&_mutex);
     #elif defined(__BUILD_HAS_FREERTOS)
     #endif
-    StrLL *nu_element = (StrLL *) malloc(sizeof(StrLL));
-    if (nu_element != nullptr) {
-      nu_element->reap = true;
-      nu_element->next = nullptr;
-      nu_element->len  = len;
-      nu_element->str  = (uint8_t*) malloc(len+1);
-      if (nu_element->str != nullptr) {
-        *(nu_element->str + len) = '\0';
-        memcpy(nu_element->str, nu, len);
-        this->stackStrOntoList(nu_element);
-      }
+    if (_coalesce && (nullptr == this->root)) {
+      _append(nu, len);
+    }
+    else {
+      _concat_ll(nu, len);
     }
     #if defined(__BUILD_HAS_PTHREADS)
       //pthread_mutex_unlock(&_mutex);
@@ -606,6 +628,96 @@ void StringBuilder::concat(uint8_t*nu, int len) {
 }
 
 
+/**
+* Adds a copy of the given buffer to the end of the list as its own element.
+*/
+void StringBuilder::_concat_ll(uint8_t* nu, int len) {
+  StrLL *nu_element = (StrLL *) malloc(sizeof(StrLL));
+  if (nu_element != nullptr) {
+    nu_element->reap = true;
+    nu_element->next = nullptr;
+    nu_element->len  = len;
+    nu_element->str  = (uint8_t*) malloc(len+1);
+    if (nu_element->str != nullptr) {
+      *(nu_element->str + len) = '\0';
+      memcpy(nu_element->str, nu, len);
+      this->stackStrOntoList(nu_element);
+    }
+    else {
+      free(nu_element);
+    }
+  }
+}
+
+
+/**
+* Appends the given buffer to the collapsed string, in place.
+* Caller must ensure that there is no list.
+*/
+void StringBuilder::_append(uint8_t* nu, int len) {
+  if (_reserve(this->col_length + len)) {
+    memcpy(this->str + this->col_length, nu, len);
+    this->col_length += len;
+    *(this->str + this->col_length) = '\0';
+  }
+}
+
+
+/**
+* Makes room for the caller to write directly onto the end of the string. The
+*   string is collapsed first. Nothing is added until commitTail() is called, and
+*   the returned pointer is good only until the next change to this object.
+*
+* @param  len  How many bytes the caller intends to write.
+* @return a pointer to at least len free bytes, or nullptr if there isn't memory.
+*/
+uint8_t* StringBuilder::reserveTail(int len) {
+  if (len < 0) return nullptr;
+  if (nullptr != this->root) collapseIntoBuffer();
+  if ((nullptr == this->root) && _reserve(this->col_length + len)) {
+    return (this->str + this->col_length);
+  }
+  return nullptr;
+}
+
+
+/**
+* Accepts bytes written into the space given by reserveTail().
+*
+* @param  len  How many bytes were written. Must not exceed what was reserved.
+*/
+void StringBuilder::commitTail(int len) {
+  if ((len > 0) && ((this->col_length + len) < _str_cap)) {
+    this->col_length += len;
+    *(this->str + this->col_length) = '\0';
+  }
+}
+
+
+/**
+* Assures that the collapsed string has room for the given length, plus a
+*   null-terminator. When coalescing, capacity is grown by doubling so that
+*   repeated appends are amortized. Otherwise, it is grown exactly.
+*
+* @param  len  The string length that must fit.
+* @return true if the space is there. False if it could not be allocated.
+*/
+bool StringBuilder::_reserve(int len) {
+  if (len < _str_cap) return true;
+  int nu_cap = len + 1;
+  if (_coalesce) {
+    nu_cap = (_str_cap > STRINGBUILDER_MIN_CAPACITY) ? _str_cap : STRINGBUILDER_MIN_CAPACITY;
+    while (nu_cap <= len) nu_cap = nu_cap << 1;
+  }
+  uint8_t* nu = (uint8_t*) realloc(this->str, nu_cap);
+  if (nullptr == nu) return false;
+  this->str = nu;
+  this->_str_cap = nu_cap;
+  *(this->str + this->col_length) = '\0';
+  return true;
+}
+
+
 /**
 * Override to make best use of memory for const strings...
 *
@@ -615,7 +727,10 @@ void StringBuilder::concat(uint8_t*nu, int len) {
 void StringBuilder::concat(const char *nu) {
   if (nu != nullptr) {
     int len = strlen(nu);
-    if (len > 0) {
+    if (_coalesce && (nullptr == this->root)) {
+      if (len > 0) _append((uint8_t*) nu, len);
+    }
+    else if (len > 0) {
       #if defined(__BUILD_HAS_PTHREADS)
         //pthread_mutex_lock(&_mutex);
       #elif defined(__BUILD_HAS_FREERTOS)
@@ -680,9 +795,34 @@ void StringBuilder::concat(StringBuilder *nu) {
 
 /**
 * Variadic. No mutex required because all working memory is confined to stack.
+* When coalescing, we format directly into the collapsed string's spare
+*   capacity, and only go around again if it didn't fit.
 */
 int StringBuilder::concatf(const char *format, ...) {
   int len = strlen(format);
+  if (_coalesce && (nullptr == this->root)) {
+    if (!_reserve(this->col_length + len)) return -1;
+    va_list args;
+    int spare = _str_cap - this->col_length;
+    va_start(args, format);
+    int ret = vsnprintf((char*) (this->str + this->col_length), spare, format, args);
+    va_end(args);
+    if (ret >= spare) {
+      if (_reserve(this->col_length + ret)) {
+        va_start(args, format);
+        vsnprintf((char*) (this->str + this->col_length), ret + 1, format, args);
+        va_end(args);
+      }
+      else {
+        ret = -1;
+      }
+    }
+    if (ret > 0) {
+      this->col_length += ret;
+    }
+    *(this->str + this->col_length) = '\0';
+    return ret;
+  }
   unsigned short f_codes = 0;  // Count how many format codes are in use...
   for (unsigned short i = 0; i < len; i++) {  if (*(format+i) == '%') f_codes++; }
   va_list args;
@@ -722,16 +862,17 @@ void StringBuilder::cull(int offset, int length) {
     //pthread_mutex_lock(&_mutex);
   #elif defined(__BUILD_HAS_FREERTOS)
   #endif
-  if (this->length() >= (length-offset)) {   // Does the given range exist?
-    int remaining_length = length-offset;
-    unsigned char* temp = (unsigned char*) malloc(remaining_length+1);  // + 1 for null-terminator.
-    if (temp != nullptr) {
-      *(temp + remaining_length) = '\0';
-      this->collapseIntoBuffer();   // Room to optimize here...
-      memcpy(temp, this->str, remaining_length);
-      this->clear();         // Throw away all else.
-      this->str = temp;      // Replace our ref.
-      this->col_length = length;
+  if ((offset >= 0) && (length >= 0) && (this->length() >= (offset + length))) {   // Does the given range exist?
+    if (0 == length) {
+      this->clear();
+    }
+    else {
+      this->collapseIntoBuffer();
+      if (nullptr == this->root) {
+        memmove(this->str, (this->str + offset), length);
+        this->col_length = length;
+        *(this->str + length) = '\0';
+      }
     }
   }
   #if defined(__BUILD_HAS_PTHREADS)
@@ -752,16 +893,14 @@ void StringBuilder::cull(int x) {
   if (x == this->length()) {
     clear();
   }
-  else if (this->length() > x) {   // Does the given range exist?
-    int remaining_length = this->length()-x;
-    unsigned char* temp = (unsigned char*) malloc(remaining_length+1);  // + 1 for null-terminator.
-    if (temp != nullptr) {
-      *(temp + remaining_length) = '\0';
-      this->collapseIntoBuffer();   // Room to optimize here...
-      memcpy(temp, (unsigned char*)(this->str + x), remaining_length);
-      this->clear();         // Throw away all else.
-      this->str = temp;      // Replace our ref.
+  else if ((x > 0) && (this->length() > x)) {   // Does the given range exist?
+    this->collapseIntoBuffer();
+    if (nullptr == this->root) {
+      // Shift the remainder down in place, rather than copying it out.
+      int remaining_length = this->col_length - x;
+      memmove(this->str, (this->str + x), remaining_length);
       this->col_length = remaining_length;
+      *(this->str + remaining_length) = '\0';
     }
   }
   #if defined(__BUILD_HAS_PTHREADS)
@@ -835,24 +974,21 @@ void StringBuilder::collapseIntoBuffer() {
     //pthread_mutex_lock(&_mutex);
   #elif defined(__BUILD_HAS_FREERTOS)
   #endif
-  StrLL *current = promote_collapsed_into_ll();   // Promote the previously-collapsed string.
+  StrLL *current = this->root;
   if (current != nullptr) {
-    this->col_length = this->totalStrLen(this->root);
-    if (this->col_length > 0) {
-      this->str = (uint8_t*) malloc(this->col_length + 1);
-      if (this->str != nullptr) {
-        *(this->str + this->col_length) = '\0';
-        int tmp_len = 0;
-        while (current != nullptr) {
-          if (current->str != nullptr) {
-            memcpy((void *)(this->str + tmp_len), (void *)(current->str), current->len);
-            tmp_len = tmp_len + current->len;
-          }
-          current = current->next;
+    // The collapsed string (if any) is already at the front. Grow it to hold
+    //   the list, and copy the list in behind it.
+    if (_reserve(this->col_length + this->totalStrLen(this->root))) {
+      while (current != nullptr) {
+        if (current->str != nullptr) {
+          memcpy((void *)(this->str + this->col_length), (void *)(current->str), current->len);
+          this->col_length = this->col_length + current->len;
         }
+        current = current->next;
       }
+      *(this->str + this->col_length) = '\0';
+      this->destroyStrLL(this->root);
     }
-    this->destroyStrLL(this->root);
   }
   #if defined(__BUILD_HAS_PTHREADS)
     //pthread_mutex_unlock(&_mutex);
@@ -922,34 +1058,29 @@ int StringBuilder::split(const char *delims) {
     return 0;
   }
 
-  // If we are going to do something that requires a null-terminated string,
-  //   make sure that we have one. If we do, this call does nothing.
-  //   If we don't, we will add it.
-  if (nullptr != this->str) {
-    if (*(this->str + (this->col_length-1)) != '\0') {
-      uint8_t* temp = (uint8_t*) malloc(this->col_length+1);
-      if (nullptr != temp) {
-        *(temp + this->col_length) = '\0';
-        memcpy(temp, this->str, this->col_length);
-        free(this->str);
-        this->str = temp;
-      }
-    }
-  }
+  // The collapsed string is always null-terminated. Take it out of the way, so
+  //   that the tokens become list elements, whatever mode we are in.
+  uint8_t* whole   = this->str;
+  int whole_len    = this->col_length;
+  int whole_cap    = this->_str_cap;
+  this->str        = nullptr;
+  this->col_length = 0;
+  this->_str_cap   = 0;
 
-  char *temp_str  = strtok((char *)this->str, delims);
+  char *temp_str  = strtok((char *) whole, delims);
   if (nullptr != temp_str) {
     while (nullptr != temp_str) {
-      this->concat(temp_str);
+      this->_concat_ll((uint8_t*) temp_str, strlen(temp_str));
       return_value++;
       temp_str  = strtok(nullptr, delims);
     }
-    free(this->str);
-    this->str = nullptr;
-    this->col_length = 0;
+    free(whole);
   }
   else {
-    this->concat("");   // Assure at least one token.
+    // Nothing but delimiters. Leave it be.
+    this->str        = whole;
+    this->col_length = whole_len;
+    this->_str_cap   = whole_cap;
   }
   return return_value;
 }
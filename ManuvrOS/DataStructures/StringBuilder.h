@@ -26,6 +26,7 @@ limitations under the License.
 #include <inttypes.h>
 #include <stdarg.h>
 #include <string.h>
+#include "CommonConstants.h"   // The mutex below depends on threading flags.
 
 #if defined(__BUILD_HAS_PTHREADS)
   #include <pthread.h>
@@ -38,6 +39,21 @@ limitations under the License.
 int strcasestr(char *a, const char *b);
 #endif
 
+/*
+* When coalescing, the collapsed string grows by doubling from this size.
+*/
+#ifndef STRINGBUILDER_MIN_CAPACITY
+  #define STRINGBUILDER_MIN_CAPACITY   64
+#endif
+
+/*
+* When coalescing, handed-off buffers of this size or less are copied into the
+*   collapsed string rather than linked in as their own element.
+*/
+#ifndef STRINGBUILDER_COALESCE_LIMIT
+  #define STRINGBUILDER_COALESCE_LIMIT 256
+#endif
+
 /*
 * This is a linked-list that is castable as a string.
 */
@@ -63,6 +79,16 @@ typedef struct str_ll_t {
 *   then collapsed. Needless to say, this shuffling act might cause the class to more-than
 *   double its memory usage while the string is being reorganized. So be aware of your memory
 *   usage.
+*
+* An instance with coalesce(true) set appends new data in place to the collapsed
+*   string (so long as it has not been tokenized), growing it by doubling.
+*   concatf() formats directly into the spare capacity. This saves two heap
+*   allocations per concat(), and string() has nothing left to do. Tokens made
+*   by split() (and anything handed off in bulk) still live in the linked-list.
+*   Since the collapsed string might be moved by any addition, pointers taken
+*   from string() or position() should not be held across one.
+* Coalescing is off by default, so that each addition is its own element, as
+*   seen by count(), position(), and split() before the string is collapsed.
 */
 class StringBuilder {
   public:
@@ -105,6 +131,11 @@ class StringBuilder {
     /* Variadic concat. Semantics are the same as printf. */
     int concatf(const char *nu, ...);
 
+    /* For encoders that want to write in place. Reserve room at the end of the
+       string, write into it, and then commit however much was written. */
+    uint8_t* reserveTail(int len);           // Returns nullptr on failure.
+    void     commitTail(int len);
+
     //inline void concat(uint16_t nu) { this->concat((unsigned int) nu); }
     //inline void concat(int16_t nu) { this->concat((int) nu); }
 
@@ -140,6 +171,9 @@ class StringBuilder {
 
     void printDebug(StringBuilder*);
 
+    inline bool coalesce() {         return _coalesce;  };
+    inline void coalesce(bool x) {   _coalesce = x;     };
+
     /* Statics */
     static void printBuffer(StringBuilder* output, uint8_t* buf, unsigned int len, const char* indent);
     // Wrapper for high-level string functions that we may or may not have.
@@ -150,7 +184,9 @@ class StringBuilder {
     StrLL *root;         // The root of the linked-list.
     int col_length;      // The length of the collapsed string.
     unsigned char* str;  // The collapsed string.
+    int _str_cap;        // How many bytes are allocated at str.
     bool preserve_ll;    // If true, do not reap the linked list in the destructor.
+    bool _coalesce;      // If true, append to str in place when possible.
 
     #if defined(__BUILD_HAS_PTHREADS)
       // If we are on linux, we control for concurrency with a mutex...
@@ -166,5 +202,8 @@ class StringBuilder {
     void destroyStrLL(StrLL *r_node);
     void null_term_check();
     StrLL* promote_collapsed_into_ll();
+    bool _reserve(int len);
+    void _append(uint8_t* nu, int len);
+    void _concat_ll(uint8_t* nu, int len);
 };
 #endif  // __MANUVR_DS_STRING_BUILDER_H
@@ -0,0 +1,366 @@
+/*
+File:   TimerWheel.h
+Author: J. Ian Lindsay
+Date:   2026.10.17
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Template for a hierarchical timing wheel of intrusively-linked elements.
+
+This is the Kernel's schedule index. Elements are filed under an absolute
+  deadline (in ticks of the wheel's own clock), and advance() moves the ones
+  that have come due onto an expiry list. The cost of advancing the clock
+  depends on how many elements expire, not on how many are filed.
+
+There are TIMER_WHEEL_LEVELS wheels of 64 slots each. The innermost wheel
+  resolves single ticks, and each wheel outward is 64 times coarser. When the
+  innermost wheel wraps, the current slot of the next wheel out is cascaded
+  inward. Deadlines further out than the outermost wheel can represent are
+  parked in its farthest slot and re-filed when they cascade.
+
+Insertion and removal are O(1), so a deadline can be moved in either direction
+  cheaply. Because the links live in the element, an element can only be in
+  one TimerWheel at a time. T must provide the following, and should befriend
+  TimerWheel<T>:
+    T*       _tw_next;       // Link storage. Owned by the wheel.
+    T*       _tw_prev;       // Link storage. Owned by the wheel.
+    uint32_t _tw_deadline;   // Absolute deadline. Owned by the wheel.
+    uint16_t _tw_slot;       // Initialize to TIMER_WHEEL_NOT_FILED.
+*/
+
+#include <inttypes.h>
+#include <stdlib.h>
+
+#ifndef __MANUVR_DS_TIMER_WHEEL_H
+#define __MANUVR_DS_TIMER_WHEEL_H
+
+#ifdef __MANUVR_LINUX
+  #include <pthread.h>
+#endif
+
+#define TIMER_WHEEL_LEVELS       5
+#define TIMER_WHEEL_BITS         6
+#define TIMER_WHEEL_SLOTS        (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK         (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_MAX_SPAN     ((1UL << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_BITS)) - 1)
+#define TIMER_WHEEL_EXPIRED      (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS)  // The expiry list.
+#define TIMER_WHEEL_NOT_FILED    0xFFFF
+
+
+template <class T> class TimerWheel {
+  public:
+    TimerWheel();
+    ~TimerWheel();
+
+    int  insert(T*, uint32_t delay);  // Files (or re-files) an element. Returns 0 on success, -1 on null.
+    bool remove(T*);                  // Returns true if the element was filed.
+    int  advance(uint32_t ticks);     // Returns the number of elements that came due.
+    T*   dequeueExpired();            // Removes and returns the oldest expired element, or nullptr.
+    int  clear();                     // Unfiles everything. Returns the number of elements dropped.
+
+    inline uint32_t now() {            return _now;                                    };
+    inline int      size() {           return _count;                                  };
+    inline int      expired() {        return _level_count[TIMER_WHEEL_LEVELS];        };
+    inline int      occupancy(int l) { return ((l >= 0) && (l <= TIMER_WHEEL_LEVELS)) ? _level_count[l] : 0;  };
+    inline bool     contains(T* d) {   return ((nullptr != d) && (TIMER_WHEEL_NOT_FILED != d->_tw_slot));     };
+
+    /* How many ticks past its deadline is the given element? */
+    inline uint32_t overdue(T* d) {
+      int32_t x = (int32_t) (_now - d->_tw_deadline);
+      return ((x > 0) ? (uint32_t) x : 0);
+    };
+
+
+  private:
+    T*       _heads[TIMER_WHEEL_EXPIRED + 1];     // The oldest element in each slot.
+    uint64_t _occupied[TIMER_WHEEL_LEVELS];       // One bit per non-empty slot.
+    int      _level_count[TIMER_WHEEL_LEVELS + 1];
+    uint32_t _now;
+    int      _count;
+    #if defined(__MANUVR_LINUX)
+      // If we are on linux, we control for concurrency with a mutex...
+      pthread_mutex_t _mutex;
+    #endif
+
+    inline void _lock() {
+      #if defined(__MANUVR_LINUX)
+        pthread_mutex_lock(&_mutex);
+      #endif
+    };
+
+    inline void _unlock() {
+      #if defined(__MANUVR_LINUX)
+        pthread_mutex_unlock(&_mutex);
+      #endif
+    };
+
+    void _link(T*, uint16_t slot);
+    void _unlink(T*);
+    void _file(T*);
+    void _requeue_slot(uint16_t slot);
+    void _tick();
+};
+
+
+/**
+* Constructor.
+*/
+template <class T> TimerWheel<T>::TimerWheel() {
+  _now   = 0;
+  _count = 0;
+  for (int i = 0; i <= TIMER_WHEEL_EXPIRED; i++) _heads[i]       = nullptr;
+  for (int i = 0; i < TIMER_WHEEL_LEVELS; i++)   _occupied[i]    = 0;
+  for (int i = 0; i <= TIMER_WHEEL_LEVELS; i++)  _level_count[i] = 0;
+  #ifdef __MANUVR_LINUX
+    #if defined (PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP)
+    _mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+    #else
+    _mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER;
+    #endif
+  #endif
+}
+
+
+/**
+* Destructor. Unlinks anything left in the wheel. The elements themselves are
+*   not ours to free.
+*/
+template <class T> TimerWheel<T>::~TimerWheel() {
+  clear();
+  #ifdef __MANUVR_LINUX
+    pthread_mutex_destroy(&_mutex);
+  #endif
+}
+
+
+/**
+* Appends the element to the tail of the given slot. Caller must hold the lock.
+*/
+template <class T> void TimerWheel<T>::_link(T* d, uint16_t slot) {
+  T* head = _heads[slot];
+  if (nullptr == head) {
+    d->_tw_next  = d;
+    d->_tw_prev  = d;
+    _heads[slot] = d;
+    if (slot < TIMER_WHEEL_EXPIRED) {
+      _occupied[slot >> TIMER_WHEEL_BITS] |= (1ULL << (slot & TIMER_WHEEL_MASK));
+    }
+  }
+  else {
+    T* tail = head->_tw_prev;
+    tail->_tw_next = d;
+    d->_tw_prev    = tail;
+    d->_tw_next    = head;
+    head->_tw_prev = d;
+  }
+  d->_tw_slot = slot;
+  _level_count[slot >> TIMER_WHEEL_BITS]++;
+  _count++;
+}
+
+
+/**
+* Unlinks the element from whatever slot it is in. Caller must hold the lock
+*   and must have already established that the element is filed.
+*/
+template <class T> void TimerWheel<T>::_unlink(T* d) {
+  const uint16_t slot = d->_tw_slot;
+  if (d->_tw_next == d) {
+    // Sole occupant of the slot.
+    _heads[slot] = nullptr;
+    if (slot < TIMER_WHEEL_EXPIRED) {
+      _occupied[slot >> TIMER_WHEEL_BITS] &= ~(1ULL << (slot & TIMER_WHEEL_MASK));
+    }
+  }
+  else {
+    d->_tw_prev->_tw_next = d->_tw_next;
+    d->_tw_next->_tw_prev = d->_tw_prev;
+    if (_heads[slot] == d) _heads[slot] = d->_tw_next;
+  }
+  d->_tw_next = nullptr;
+  d->_tw_prev = nullptr;
+  d->_tw_slot = TIMER_WHEEL_NOT_FILED;
+  _level_count[slot >> TIMER_WHEEL_BITS]--;
+  _count--;
+}
+
+
+/**
+* Files the element on the innermost wheel that can resolve its deadline.
+*   Anything already due lands in the current slot, which is only ever
+*   called from within a tick, ahead of that slot being expired.
+* Caller must hold the lock.
+*/
+template <class T> void TimerWheel<T>::_file(T* d) {
+  int32_t  delta  = (int32_t) (d->_tw_deadline - _now);
+  uint32_t target = _now;
+  if (delta > 0) {
+    target += (((uint32_t) delta > TIMER_WHEEL_MAX_SPAN) ? TIMER_WHEEL_MAX_SPAN : (uint32_t) delta);
+  }
+  uint32_t span = target - _now;
+  int l = 0;
+  while ((l < (TIMER_WHEEL_LEVELS - 1)) && (span >= (1UL << ((l + 1) * TIMER_WHEEL_BITS)))) {
+    l++;
+  }
+  uint16_t slot = (l << TIMER_WHEEL_BITS) + ((target >> (l * TIMER_WHEEL_BITS)) & TIMER_WHEEL_MASK);
+  _link(d, slot);
+}
+
+
+/**
+* Takes every element out of the given slot and files it again against the
+*   present time. Caller must hold the lock.
+*/
+template <class T> void TimerWheel<T>::_requeue_slot(uint16_t slot) {
+  T* current = _heads[slot];
+  while (nullptr != current) {
+    // Cascading an outer slot always files its elements somewhere else.
+    _unlink(current);
+    _file(current);
+    current = _heads[slot];
+  }
+}
+
+
+/**
+* Advance the clock by one tick. Cascades the outer wheels if the innermost
+*   wheel wrapped, and then expires the innermost wheel's current slot.
+* Caller must hold the lock.
+*/
+template <class T> void TimerWheel<T>::_tick() {
+  const uint16_t idx = _now & TIMER_WHEEL_MASK;
+  if (0 == idx) {
+    for (int l = 1; l < TIMER_WHEEL_LEVELS; l++) {
+      uint16_t s = (_now >> (l * TIMER_WHEEL_BITS)) & TIMER_WHEEL_MASK;
+      if (_heads[(l << TIMER_WHEEL_BITS) + s]) _requeue_slot((l << TIMER_WHEEL_BITS) + s);
+      if (s) break;
+    }
+  }
+
+  T* current = _heads[idx];
+  while (nullptr != current) {
+    _unlink(current);
+    if ((int32_t) (current->_tw_deadline - _now) > 0) {
+      // Not actually due. Shouldn't happen, but filing it again is safe.
+      _file(current);
+    }
+    else {
+      _link(current, TIMER_WHEEL_EXPIRED);
+    }
+    current = _heads[idx];
+  }
+}
+
+
+/**
+* Files the given element to expire the given number of ticks from now. If
+*   the element was already filed, it is moved. A delay of zero is taken to
+*   mean "on the next tick".
+*
+* @param  d      The element to file.
+* @param  delay  How many ticks from now the element should expire.
+* @return 0 on success, or -1 if d is null.
+*/
+template <class T> int TimerWheel<T>::insert(T* d, uint32_t delay) {
+  if (nullptr == d) return -1;
+  _lock();
+  if (TIMER_WHEEL_NOT_FILED != d->_tw_slot) _unlink(d);
+  if (0 == delay)               delay = 1;
+  else if (delay > 0x7FFFFFFF)  delay = 0x7FFFFFFF;
+  d->_tw_deadline = _now + delay;
+  _file(d);
+  _unlock();
+  return 0;
+}
+
+
+template <class T> bool TimerWheel<T>::remove(T* d) {
+  bool return_value = false;
+  if (nullptr != d) {
+    _lock();
+    if (TIMER_WHEEL_NOT_FILED != d->_tw_slot) {
+      _unlink(d);
+      return_value = true;
+    }
+    _unlock();
+  }
+  return return_value;
+}
+
+
+/**
+* Moves the clock forward by the given number of ticks, and moves anything
+*   that came due onto the expiry list. Stretches of the innermost wheel that
+*   are empty are skipped without being visited.
+*
+* @param  ticks  How many ticks have passed.
+* @return the number of elements that came due.
+*/
+template <class T> int TimerWheel<T>::advance(uint32_t ticks) {
+  _lock();
+  const int initial = _level_count[TIMER_WHEEL_LEVELS];
+  if (_count == initial) {
+    // Nothing filed at all. The clock is all that moves.
+    _now += ticks;
+    ticks = 0;
+  }
+  while (ticks > 0) {
+    if (0 == _occupied[0]) {
+      // Nothing on the innermost wheel. Skip ahead to the next cascade.
+      uint32_t to_boundary = TIMER_WHEEL_SLOTS - (_now & TIMER_WHEEL_MASK);
+      if (ticks < to_boundary) {
+        _now += ticks;
+        break;
+      }
+      _now  += to_boundary - 1;
+      ticks -= to_boundary - 1;
+    }
+    _now++;
+    ticks--;
+    _tick();
+  }
+  const int return_value = _level_count[TIMER_WHEEL_LEVELS] - initial;
+  _unlock();
+  return return_value;
+}
+
+
+template <class T> T* TimerWheel<T>::dequeueExpired() {
+  T* return_value = nullptr;
+  _lock();
+  if (nullptr != _heads[TIMER_WHEEL_EXPIRED]) {
+    return_value = _heads[TIMER_WHEEL_EXPIRED];
+    _unlink(return_value);
+  }
+  _unlock();
+  return return_value;
+}
+
+
+template <class T> int TimerWheel<T>::clear() {
+  int return_value = 0;
+  _lock();
+  for (int i = 0; i <= TIMER_WHEEL_EXPIRED; i++) {
+    while (nullptr != _heads[i]) {
+      _unlink(_heads[i]);
+      return_value++;
+    }
+  }
+  _unlock();
+  return return_value;
+}
+
+#endif // __MANUVR_DS_TIMER_WHEEL_H
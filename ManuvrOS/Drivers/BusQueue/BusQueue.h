@@ -20,6 +20,15 @@ limitations under the License.
 
 TODO: BusOp lifecycle....
 
+Scheduling:
+Every requester on a bus gets a lane. When the adapter wants its next op, it
+  takes the oldest op from the next lane (round-robin) that has work, so one
+  chatty device can't starve the others. Ops within a lane stay in order.
+A lane can be given a latency target. Ops in such lanes carry a deadline, and
+  are taken ahead of best-effort work, earliest deadline first.
+A read that duplicates one still waiting in the queue (same requester, buffer,
+  and bus address, with no write from that requester queued behind it) is
+  folded into the waiting op. The requester sees one callback.
 */
 
 #ifndef __MANUVR_BUS_QUEUE_H__
@@ -30,6 +39,11 @@ TODO: BusOp lifecycle....
 #include <DataStructures/StringBuilder.h>
 #include <Platform/Platform.h>
 
+#ifndef BUSADAPTER_MAX_LANES
+  // How many requesters are scheduled separately? Any beyond this share the last lane.
+  #define BUSADAPTER_MAX_LANES  8
+#endif
+
 
 /*
 * These are possible transfer states.
@@ -89,6 +103,7 @@ enum class XferFault : uint8_t {
 
 /* Forward declarations. */
 class BusOp;
+template <class T> class BusAdapter;
 
 /*
 * This is an interface class that implements a callback path for I/O operations.
@@ -214,9 +229,29 @@ class BusOp {
 
 
   private:
+    uint32_t  _queued_at = 0;   // micros() when the adapter accepted the op.
+    uint8_t   _lane      = 0;   // The adapter's scheduling lane for our callback.
+
+    template <class T> friend class BusAdapter;
 };
 
 
+/*
+* Scheduling state and stats for one requester on a bus.
+*/
+typedef struct {
+  BusOpCallback* dev;          // Who the lane belongs to. nullptr if unclaimed.
+  uint32_t deadline_us;        // Latency target. Zero for best-effort.
+  uint32_t ops;                // Ops retired.
+  uint32_t faults;             // ...of which failed.
+  uint32_t bytes;              // Buffer bytes moved by successful ops.
+  uint32_t coalesced;          // Reads folded into one already waiting.
+  uint32_t missed;             // Ops retired after their deadline.
+  uint32_t lat_total;          // Sum of queue-to-retire times (us).
+  uint32_t lat_max;            // Worst queue-to-retire time (us).
+} BusQueueLane;
+
+
 /*
 * This class represents a generic bus adapter. We are not so concerned with
 *   performance and memory overhead in this class, because there is typically
@@ -231,21 +266,40 @@ template <class T> class BusAdapter : public BusOpCallback {
       preallocated.insert(obj);
     };
 
+    /**
+    * Gives a requester a latency target. Its ops will be taken ahead of
+    *   best-effort work, earliest deadline first.
+    *
+    * @param  dev  The requester.
+    * @param  us   How long its ops may wait, in microseconds. Zero for best-effort.
+    * @return 0 on success, or -1 if the requester has to share a lane.
+    */
+    int8_t setLatencyTarget(BusOpCallback* dev, uint32_t us) {
+      uint8_t l = _lane_for(dev);
+      if (dev != _lanes[l].dev) return -1;
+      _lanes[l].deadline_us = us;
+      return 0;
+    };
+
 
   protected:
     T*       current_job      = nullptr;
     uint32_t _total_xfers     = 0;  // Transfer stats.
     uint32_t _failed_xfers    = 0;  // Transfer stats.
     uint16_t _prealloc_misses = 0;  // How many times have we starved the preallocation queue?
+    uint16_t _prealloc_low    = 0xFFFF;  // Fewest ops ever left in the preallocation queue.
     uint16_t _heap_frees      = 0;  // How many times have we freed a BusOp?
     uint16_t _queue_floods    = 0;  // How many times has the queue rejected work?
+    uint16_t _queue_deepest   = 0;  // Largest depth the work queue has reached.
     const uint16_t MAX_Q_DEPTH;     // Maximum tolerable queue depth.
     //TODO: const uint8_t  MAX_Q_PRINT;     // Maximum tolerable queue depth.
     //TODO: const uint8_t  PREALLOC_SIZE;   // Maximum tolerable queue depth.
     PriorityQueue<T*> work_queue;   // A work queue to keep transactions in order.
     PriorityQueue<T*> preallocated; // TODO: Convert to ring buffer. This is the whole reason you embarked on this madness.
 
-    BusAdapter(uint16_t max) : MAX_Q_DEPTH(max) {};
+    BusAdapter(uint16_t max) : MAX_Q_DEPTH(max) {
+      memset(_lanes, 0, sizeof(_lanes));
+    };
 
     /* Mandatory overrides... */
     virtual int8_t advance_work_queue() =0;  // The nature of the bus dictates this implementation.
@@ -254,6 +308,17 @@ template <class T> class BusAdapter : public BusOpCallback {
     //virtual int8_t io_op_callback(T*)   =0;  // From BusOpCallback
     //virtual int8_t queue_io_job(T*)     =0;  // From BusOpCallback
 
+    /**
+    * Adapters that can tell where on the bus a read is aimed should override
+    *   this to allow coalescing. The opcode, requester, and buffer have already
+    *   been matched.
+    *
+    * @param  waiting  A read already in the queue.
+    * @param  nu       The read being queued.
+    * @return true if nu would read the same thing as waiting.
+    */
+    virtual bool same_read(T* waiting, T* nu) {  return false;  };
+
     /**
     * Return a vacant BusOp to the caller, allocating if necessary.
     *
@@ -265,6 +330,8 @@ template <class T> class BusAdapter : public BusOpCallback {
         _prealloc_misses++;
         return_value = new T();
       }
+      const uint16_t avail = (uint16_t) preallocated.size();
+      if (avail < _prealloc_low) _prealloc_low = avail;
       return return_value;
     };
 
@@ -295,6 +362,110 @@ template <class T> class BusAdapter : public BusOpCallback {
     //  }
     //};
 
+    /**
+    * Accepts an op into the work queue, stamping it for the scheduler. A read
+    *   that duplicates one still waiting is not queued. The caller should then
+    *   reclaim it, as it will never be run.
+    *
+    * @param  op  The op to queue.
+    * @return 0 if queued, 1 if coalesced, or -1 if the queue refused it.
+    */
+    int8_t enqueue_op(T* op) {
+      op->_lane      = _lane_for(op->callback);
+      op->_queued_at = (uint32_t) micros();
+      if (_coalesce(op)) {
+        _lanes[op->_lane].coalesced++;
+        return 1;
+      }
+      if (0 > work_queue.insert(op)) {
+        return -1;
+      }
+      const uint16_t depth = (uint16_t) work_queue.size();
+      if (depth > _queue_deepest) _queue_deepest = depth;
+      return 0;
+    };
+
+    /**
+    * Takes the next op the bus should run out of the work queue. Deadline work
+    *   goes first, earliest deadline first. Otherwise, the oldest op from the
+    *   next lane after the last one served.
+    *
+    * @return the op, or nullptr if the queue is empty.
+    */
+    T* dequeue_op() {
+      int  pos      = 0;
+      int  rr_pos   = -1;
+      int  edf_pos  = -1;
+      uint8_t  rr_dist = BUSADAPTER_MAX_LANES;
+      uint32_t edf_due = 0;
+      for (PriorityIterator<T*> it = work_queue.begin(); it != work_queue.end(); ++it) {
+        T* op = *it;
+        const uint8_t l = op->_lane;
+        if (_lanes[l].deadline_us) {
+          const uint32_t due = op->_queued_at + _lanes[l].deadline_us;
+          if ((edf_pos < 0) || ((int32_t) (due - edf_due) < 0)) {
+            edf_pos = pos;
+            edf_due = due;
+          }
+        }
+        else if (edf_pos < 0) {
+          const uint8_t dist = (l + BUSADAPTER_MAX_LANES - _rr_lane - 1) % BUSADAPTER_MAX_LANES;
+          if (dist < rr_dist) {
+            rr_dist = dist;
+            rr_pos  = pos;
+          }
+        }
+        pos++;
+      }
+      const int take = (edf_pos >= 0) ? edf_pos : rr_pos;
+      if (take < 0) return nullptr;
+      T* return_value = work_queue.get(take);
+      work_queue.remove(take);
+      if (edf_pos < 0) _rr_lane = return_value->_lane;
+      return return_value;
+    };
+
+    /**
+    * Counts a finished op against the adapter and its requester's lane. Call
+    *   once per op, before its callback.
+    *
+    * @param  op  The op that has reached COMPLETE or FAULT.
+    */
+    void retire_op(T* op) {
+      BusQueueLane* lane = &_lanes[op->_lane];
+      const uint32_t lat = (uint32_t) micros() - op->_queued_at;
+      _total_xfers++;
+      lane->ops++;
+      if (op->hasFault()) {
+        _failed_xfers++;
+        lane->faults++;
+      }
+      else {
+        lane->bytes += op->buf_len;
+      }
+      lane->lat_total += lat;
+      if (lat > lane->lat_max) lane->lat_max = lat;
+      if (lane->deadline_us && (lat > lane->deadline_us)) lane->missed++;
+    };
+
+
+    /**
+    * Gives up a requester's lane, so that it can be claimed by another. Call
+    *   when a device leaves the bus, after its queued work has been purged.
+    *   Lanes are matched by pointer, and a new device might be allocated at
+    *   the same address.
+    *
+    * @param  dev  The requester that is leaving.
+    */
+    void release_lane(BusOpCallback* dev) {
+      for (uint8_t i = 0; i < BUSADAPTER_MAX_LANES; i++) {
+        if (dev == _lanes[i].dev) {
+          memset(&_lanes[i], 0, sizeof(BusQueueLane));
+          return;
+        }
+      }
+    };
+
 
     /* Convenience function for guarding against queue floods. */
     inline bool roomInQueue() {    return !(work_queue.size() < MAX_Q_DEPTH);  }
@@ -304,10 +475,27 @@ template <class T> class BusAdapter : public BusOpCallback {
       output->concatf("-- Xfers (fail/total)  %u/%u\n", _failed_xfers, _total_xfers);
       output->concat("-- Prealloc:\n");
       output->concatf("--    available        %d\n",  preallocated.size());
+      output->concatf("--    low water        %u\n",  (0xFFFF == _prealloc_low) ? preallocated.size() : _prealloc_low);
       output->concatf("--    misses/frees     %u/%u\n", _prealloc_misses, _heap_frees);
       output->concat("-- Work queue:\n");
       output->concatf("--    depth/max        %u/%u\n", work_queue.size(), MAX_Q_DEPTH);
+      output->concatf("--    deepest          %u\n",  _queue_deepest);
       output->concatf("--    floods           %u\n",  _queue_floods);
+      printLanes(output);
+    };
+
+    // TODO: I hate that I'm doing this in a template.
+    void printLanes(StringBuilder* output) {
+      output->concat("-- Lanes:\n--    requester        ops  faults     bytes  merged  lat avg/max (us)   deadline/missed\n");
+      for (uint8_t i = 0; i < BUSADAPTER_MAX_LANES; i++) {
+        BusQueueLane* l = &_lanes[i];
+        if (nullptr == l->dev) continue;
+        output->concatf("--    %-14p %6u  %6u  %8u  %6u  %8u/%-8u  %8u/%u\n",
+          l->dev, l->ops, l->faults, l->bytes, l->coalesced,
+          (l->ops ? (l->lat_total / l->ops) : 0), l->lat_max,
+          l->deadline_us, l->missed
+        );
+      }
     };
 
     // TODO: I hate that I'm doing this in a template.
@@ -332,7 +520,47 @@ template <class T> class BusAdapter : public BusOpCallback {
       }
     };
 
+
   private:
+    BusQueueLane _lanes[BUSADAPTER_MAX_LANES];
+    uint8_t      _rr_lane = BUSADAPTER_MAX_LANES - 1;   // Lane last served. Lane 0 goes first.
+
+    /*
+    * Finds (or claims) the lane for a requester. Released lanes leave gaps, so
+    *   the whole table is searched before the first free lane is claimed. Once
+    *   the lanes are all claimed, latecomers share the last one.
+    */
+    uint8_t _lane_for(BusOpCallback* dev) {
+      int8_t vacant = -1;
+      for (uint8_t i = 0; i < BUSADAPTER_MAX_LANES; i++) {
+        if (dev == _lanes[i].dev) return i;
+        if ((vacant < 0) && (nullptr == _lanes[i].dev)) vacant = i;
+      }
+      if (vacant < 0) return (BUSADAPTER_MAX_LANES - 1);
+      _lanes[vacant].dev = dev;
+      return (uint8_t) vacant;
+    };
+
+    /*
+    * Looks for a waiting read that nu duplicates. A write from the same
+    *   requester queued after it makes it ineligible, since nu must observe
+    *   the write.
+    */
+    bool _coalesce(T* nu) {
+      if (BusOpcode::RX != nu->get_opcode()) return false;
+      T* candidate = nullptr;
+      for (PriorityIterator<T*> it = work_queue.begin(); it != work_queue.end(); ++it) {
+        T* op = *it;
+        if (op->callback != nu->callback) continue;
+        if (BusOpcode::RX != op->get_opcode()) {
+          candidate = nullptr;
+        }
+        else if ((op->buf == nu->buf) && (op->buf_len == nu->buf_len) && same_read(op, nu)) {
+          candidate = op;
+        }
+      }
+      return (nullptr != candidate);
+    };
 };
 
 #endif  // __MANUVR_BUS_QUEUE_H__
@@ -25,12 +25,23 @@ The idea here is not to provide any manner of abstraction for GPIO. Our
 #include "ManuvrableGPIO.h"
 #if defined(CONFIG_MANUVR_GPIO_ER)
 
+/* The only codes our notify() handles. */
+const uint16_t gpio_er_interest[] = {
+  MANUVR_MSG_DIGITAL_READ,
+  MANUVR_MSG_DIGITAL_WRITE,
+  MANUVR_MSG_ANALOG_READ,
+  MANUVR_MSG_ANALOG_WRITE,
+  MANUVR_MSG_EVENT_ON_INTERRUPT,
+  MANUVR_MSG_GPIO_LEGEND,
+  MANUVR_MSG_UNDEFINED
+};
 
 ManuvrableGPIO::ManuvrableGPIO() : EventReceiver("GPIO") {
   _gpio_notice.incRefs();
   _gpio_notice.setOriginator((EventReceiver*) this);
   // There should be no need to inform the Kernel of the codes we will be using
   //   since they are general, and should be added by the Kernel itself.
+  msgInterest(gpio_er_interest);
 }
 
 ManuvrableGPIO::~ManuvrableGPIO() {
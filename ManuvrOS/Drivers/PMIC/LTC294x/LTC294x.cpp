@@ -101,6 +101,8 @@ LTC294x::LTC294x(const LTC294xOpts* o, uint16_t bc) : I2CDeviceWithRegisters(LTC
     //gpioDefine(_opts.pin, GPIOMode::OUTPUT_OD);
   }
 
+  // The register pointer auto-increments, and the map is contiguous.
+  multi_access_support = true;
   defineRegister(LTC294X_REG_STATUS,        (uint8_t)  0x00,   false, true,  false);
   defineRegister(LTC294X_REG_CONTROL,       (uint8_t)  0x3C,   false, false, true);
   defineRegister(LTC294X_REG_ACC_CHARGE,    (uint16_t) 0x7FFF, false, false, true);
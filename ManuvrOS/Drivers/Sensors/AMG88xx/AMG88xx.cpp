@@ -77,6 +77,7 @@ SensorError AMG88xx::init() {
   if (_opts.useIRQPin()) {
     setPinEvent(_opts.pin, FALLING_PULL_UP, &isr_event);
   }
+  setOutputDataRate(10.0f);   // The power-on frame rate.
   return SensorError::NO_ERROR;
 }
 
@@ -126,6 +127,9 @@ int8_t AMG88xx::io_op_callback(I2CBusOp* completed) {
         case AMG88XX_REG_PWR_CTRL:
           break;
         case AMG88XX_REG_FRAME_RATE:
+          if (completed->buf_len) {
+            setOutputDataRate((AMG88XX_FPS_1 == (*completed->buf & 0x01)) ? 1.0f : 10.0f);
+          }
           break;
         case AMG88XX_REG_IRQ_CTRL:
           break;
@@ -145,6 +149,9 @@ int8_t AMG88xx::io_op_callback(I2CBusOp* completed) {
         case AMG88XX_REG_RESET:
           break;
         case AMG88XX_REG_FRAME_RATE:
+          if (completed->buf_len) {
+            setOutputDataRate((AMG88XX_FPS_1 == (*completed->buf & 0x01)) ? 1.0f : 10.0f);
+          }
           break;
         case AMG88XX_REG_IRQ_CTRL:
           break;
@@ -21,6 +21,7 @@ limitations under the License.
 
 
 #include "SensorWrapper.h"
+#include <math.h>
 
 
 SensorDatum::SensorDatum(const DatumDef* d) : Argument(d->type_id) {
@@ -61,6 +62,78 @@ void SensorDatum::autoreport(SensorReporting ar) {
 }
 
 
+/**
+* Called after every update to this datum. Decides whether the update warrants
+*   a report, and notes it if so.
+*
+* @return true if a report is now due.
+*/
+bool SensorDatum::noteUpdate() {
+  if (_flags & SENSE_DATUM_FLAG_REPORT_READ) {
+    _flags |= SENSE_DATUM_FLAG_REPORT_DUE;
+  }
+  else if (_flags & SENSE_DATUM_FLAG_REPORT_CHANGE) {
+    double val;
+    if (_numeric_value(&val)) {
+      // The first value is always news. Thereafter, it must clear the deadband.
+      if (!(_flags & SENSE_DATUM_FLAG_REPORT_REF) || (fabs(val - _reported) > (double) _deadband)) {
+        _reported = val;
+        _flags |= (SENSE_DATUM_FLAG_REPORT_DUE | SENSE_DATUM_FLAG_REPORT_REF);
+      }
+    }
+    else {
+      // We can't measure change in non-scalars. Report them all.
+      _flags |= SENSE_DATUM_FLAG_REPORT_DUE;
+    }
+  }
+  return reportDue();
+}
+
+
+/*
+* Fetches the value as a double, if it is a scalar number.
+*/
+bool SensorDatum::_numeric_value(double* val) {
+  union {
+    int8_t   i8;
+    int16_t  i16;
+    int32_t  i32;
+    uint8_t  u8;
+    uint16_t u16;
+    uint32_t u32;
+    float    f;
+    double   d;
+  } v;
+  switch (typeCode()) {
+    case TCode::INT8:
+    case TCode::INT16:
+    case TCode::INT32:
+    case TCode::UINT8:
+    case TCode::UINT16:
+    case TCode::UINT32:
+    case TCode::FLOAT:
+    case TCode::DOUBLE:
+      if (0 != getValueAs((void*) &v)) return false;
+      break;
+    default:
+      return false;   // Vectors, strings, and the like.
+  }
+  switch (typeCode()) {
+    case TCode::INT8:     *val = v.i8;    break;
+    case TCode::INT16:    *val = v.i16;   break;
+    case TCode::INT32:    *val = v.i32;   break;
+    case TCode::UINT8:    *val = v.u8;    break;
+    case TCode::UINT16:   *val = v.u16;   break;
+    case TCode::UINT32:   *val = v.u32;   break;
+    case TCode::FLOAT:    *val = (double) v.f;   break;
+    case TCode::DOUBLE:   *val = v.d;     break;
+    default:
+      return false;
+  }
+  return true;
+}
+
+
 SensorError SensorDatum::printValue(StringBuilder* output) {
   Argument::valToString(output);
   if (def->units) output->concat(def->units);
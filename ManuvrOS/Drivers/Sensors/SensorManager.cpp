@@ -34,6 +34,13 @@ const MessageTypeDef message_defs_sensors[] = {
   {  MANUVR_MSG_SENSOR_MGR_REPORT,    MSG_FLAG_EXPORTABLE,   "SENSOR_MGR_REPORT", ManuvrMsg::MSG_ARGS_NONE }  // Pass a group ID to free the channels it contains, or no args to ungroup everything.
 };
 
+/* The only codes our notify() handles. */
+const uint16_t sensor_mgr_interest[] = {
+  MANUVR_MSG_SENSOR_MGR_SVC,
+  MANUVR_MSG_SENSOR_MGR_REPORT,
+  MANUVR_MSG_UNDEFINED
+};
+
 
 /*
 * Constructor.
@@ -41,6 +48,8 @@ const MessageTypeDef message_defs_sensors[] = {
 SensorManager::SensorManager() : EventReceiver("SensorManager") {
   int mes_count = sizeof(message_defs_sensors) / sizeof(MessageTypeDef);
   ManuvrMsg::registerMessages(message_defs_sensors, mes_count);
+  msgInterest(sensor_mgr_interest);
+  for (int i = 0; i < SENSOR_MGR_MAX_BUSES; i++) _buses[i] = nullptr;
 }
 
 
@@ -59,14 +68,25 @@ SensorManager::~SensorManager() {
 *******************************************************************************/
 
 /**
+* Sensors that share a bus are kept together in the service order, and those
+*   that are nearly due are polled alongside those that are due. So the bus
+*   sees their transfers as one batch, rather than being woken for each.
+*
 * @param  sensor  The SensorWrapper to add.
+* @param  bus     Any pointer unique to the bus the sensor is on (typically its
+*                   adapter), or nullptr if it doesn't matter.
 * @return 0 on success and -1 on failure.
 */
-int8_t SensorManager::addSensor(SensorWrapper* sensor) {
+int8_t SensorManager::addSensor(SensorWrapper* sensor, const void* bus) {
   if (nullptr == sensor) return -1;
 
-  if (0 <= _sensors.insertIfAbsent(sensor)) {
+  // Sensors on buses we can't track are polled on their own.
+  const int bus_idx = (nullptr != bus) ? _bus_index(bus) : -1;
+  if (0 <= _sensors.insertIfAbsent(sensor, bus_idx + 1)) {
     sensor->setSensorManager(this);
+    sensor->_bus       = (0 <= bus_idx) ? bus : nullptr;
+    sensor->_next_poll = micros();
+    _retune_service_period();
   }
   return 0;
 }
@@ -78,27 +98,132 @@ int8_t SensorManager::addSensor(SensorWrapper* sensor) {
 */
 int8_t SensorManager::dropSensor(SensorWrapper* sensor) {
   if (nullptr == sensor) return -1;
-  return (_sensors.remove(sensor) ? 0 : -1);
+  if (_sensors.remove(sensor)) {
+    _retune_service_period();
+    return 0;
+  }
+  return -1;
+}
+
+
+/**
+* @param  bus  The bus pointer given to addSensor().
+* @return the bus's index, assigning one if necessary. -1 if there is no room.
+*/
+int SensorManager::_bus_index(const void* bus) {
+  for (int i = 0; i < SENSOR_MGR_MAX_BUSES; i++) {
+    if (bus == _buses[i]) return i;
+    if (nullptr == _buses[i]) {
+      _buses[i] = bus;
+      return i;
+    }
+  }
+  return -1;
+}
+
+
+/*
+* The service schedule runs as fast as the fastest sensor needs, and no faster.
+*/
+void SensorManager::_retune_service_period() {
+  uint32_t period = SENSOR_MGR_MAX_PERIOD_MS;
+  for (SensorWrapper* current : _sensors) {
+    const uint32_t p = current->pollPeriod() / 1000;
+    if (current->pollPeriod() && (p < period)) {
+      period = p;
+    }
+  }
+  if (period < SENSOR_MGR_MIN_PERIOD_MS) period = SENSOR_MGR_MIN_PERIOD_MS;
+  if (period != _svc_period) {
+    _svc_period = period;
+    if (erAttached()) {
+      _sensor_report.alterSchedulePeriod(_svc_period);
+    }
+  }
 }
 
 
+/**
+* Polls those sensors that are due (or nearly so, and on a bus that is being
+*   polled anyway). The rest are left alone until their data is fresh.
+*
+* @return The number of sensors that were polled without error.
+*/
 int SensorManager::_service_sensors() {
+  const uint32_t now   = micros();
+  const int32_t  slack = (int32_t) (_svc_period * 500);   // Half a service period, in us.
+  bool bus_due[SENSOR_MGR_MAX_BUSES];
   int return_val = 0;
-  //Kernel::log("_service_sensors()\n");
-  for (int i = 0; i < _sensors.size(); i++) {
-    SensorWrapper* current = _sensors.get(i);
-    // TODO: This ought to be a general time-sharing fxn.
-    if (SensorError::NO_ERROR == current->readSensor()) {
-      return_val++;
+  int reports    = 0;
+
+  // First, find the buses that are going to see traffic.
+  for (int i = 0; i < SENSOR_MGR_MAX_BUSES; i++) bus_due[i] = false;
+  for (SensorWrapper* current : _sensors) {
+    if (current->_bus && ((int32_t) (current->_next_poll - now) <= slack)) {
+      bus_due[_bus_index(current->_bus)] = true;
+    }
+  }
+
+  for (SensorWrapper* current : _sensors) {
+    const int32_t until = (int32_t) (current->_next_poll - now);
+    bool poll = (until <= slack);
+    if (!poll && current->_bus && bus_due[_bus_index(current->_bus)]) {
+      // The bus is busy this service anyway. Take this sensor along if its
+      //   next poll isn't far off.
+      if (until <= (int32_t) (current->_poll_period >> SENSOR_MGR_COALESCE_SHIFT)) {
+        poll = true;
+        _polls_coalesced++;
+      }
+    }
+
+    if (poll) {
+      _polls_executed++;
+      if (SensorError::NO_ERROR == current->readSensor()) {
+        return_val++;
+      }
+      else {
+        _polls_failed++;
+      }
+      // Keep to the sensor's own cadence, unless we've fallen a whole period behind.
+      current->_next_poll += current->_poll_period;
+      if ((int32_t) (current->_next_poll - now) <= 0) {
+        current->_next_poll = now + current->_poll_period;
+      }
+    }
+    else {
+      _polls_skipped++;
     }
+
+    // Reads may complete asynchronously, so this might be from a prior service.
+    if (current->reportDue()) reports++;
   }
+
+  if (reports && !_report_pending && erAttached()) {
+    _report_pending = true;
+    Kernel::staticRaiseEvent(&_report_ready);
+  }
+  _retune_service_period();
   return return_val;
 }
 
 
+/**
+* Issues the reports that sensors have earned. Data that haven't changed
+*   beyond their deadbands don't earn reports.
+*
+* @return The number of sensors that reported.
+*/
 int SensorManager::_report_sensors() {
-  Kernel::log("_report_sensors()\n");
-  return 0;
+  int return_val = 0;
+  _report_pending = false;
+  for (SensorWrapper* current : _sensors) {
+    if (current->reportDue()) {
+      current->issueReport();
+      return_val++;
+    }
+  }
+  _reports_issued += return_val;
+  return return_val;
 }
 
 
@@ -170,10 +295,9 @@ int SensorManager::_report_sensor_data_by_index(uint8_t idx, TCode tcode, String
 * @param   StringBuilder* The buffer into which this fxn should write its output.
 */
 void SensorManager::printSensorList(StringBuilder* output) {
-  output->concatf("-- Managing %d sensors:", _sensors.size());
+  output->concatf("-- Managing %d sensors (service every %ums):", _sensors.size(), _svc_period);
   output->concat("\n\t-UUID---------------------------------Name---------a-c-d---lastUpdate---");
-  for (int i = 0; i < _sensors.size(); i++) {
-    SensorWrapper* current = _sensors.get(i);
+  for (SensorWrapper* current : _sensors) {
     output->concat("\n\t");
     current->printSensorSummary(output);
   }
@@ -192,8 +316,8 @@ int SensorManager::_report_sensor_data_defs(TCode tcode, StringBuilder* output)
     if (final_size) {
       output->concat(coutput.data(), final_size);
     }
-    for (int i = 0; i < s_count; i++) {
-      _report_sensor_data_defs_by_index(i, tcode, output);
+    for (SensorWrapper* current : _sensors) {
+      current->issue_def_map(tcode, output);
     }
   #endif   //__BUILD_HAS_CBOR
 
@@ -213,8 +337,8 @@ int SensorManager::_report_sensor_data(TCode tcode, StringBuilder* output) {
     if (final_size) {
       output->concat(coutput.data(), final_size);
     }
-    for (int i = 0; i < s_count; i++) {
-      _report_sensor_data_by_index(i, tcode, output);
+    for (SensorWrapper* current : _sensors) {
+      current->issue_value_map(tcode, output);
     }
   #endif   //__BUILD_HAS_CBOR
 
@@ -247,10 +371,14 @@ int8_t SensorManager::attached() {
     _sensor_report.incRefs();
     _sensor_report.specific_target = (EventReceiver*) this;
     _sensor_report.alterScheduleRecurrence(-1);
-    _sensor_report.alterSchedulePeriod(1001);
+    _sensor_report.alterSchedulePeriod(_svc_period);
     _sensor_report.autoClear(false);
     _sensor_report.enableSchedule(true);
     platform.kernel()->addSchedule(&_sensor_report);
+
+    _report_ready.repurpose(MANUVR_MSG_SENSOR_MGR_REPORT, (EventReceiver*) this);
+    _report_ready.incRefs();
+    _report_ready.specific_target = (EventReceiver*) this;
     return 1;
   }
   return 0;
@@ -265,6 +393,9 @@ int8_t SensorManager::attached() {
 void SensorManager::printDebug(StringBuilder* output) {
   EventReceiver::printDebug(output);
   printSensorList(output);
+  output->concatf("-- Polls executed/skipped  %u/%u\n", _polls_executed, _polls_skipped);
+  output->concatf("--    coalesced/failed     %u/%u\n", _polls_coalesced, _polls_failed);
+  output->concatf("-- Reports issued          %u\n", _reports_issued);
   output->concat("\n");
 }
 
@@ -236,6 +236,51 @@ SensorError SensorWrapper::setAutoReporting(uint8_t dat, SensorReporting nu_ar_s
 
 
 
+/*
+* Sets the change threshold for the given datum. Only meaningful for numeric
+*   data that report changes.
+*/
+SensorError SensorWrapper::setDeadband(uint8_t dat, float band) {
+  SensorDatum* current = get_datum(dat);
+  if (current) {
+    current->deadband(band);
+    return SensorError::NO_ERROR;
+  }
+  return SensorError::INVALID_DATUM;
+}
+
+
+/*
+* Hands the sensor to its autoreport callback, if a report is due, and clears
+*   the due marks.
+*/
+SensorError SensorWrapper::issueReport() {
+  if (reportDue()) {
+    _flags &= ~MANUVR_SENSOR_FLAG_REPORT_DUE;
+    if (ar_callback) {
+      ar_callback(this);
+    }
+    SensorDatum* current = datum_list;
+    while (current) {
+      current->reportIssued();
+      current = current->next();
+    }
+  }
+  return SensorError::NO_ERROR;
+}
+
+
+/*
+* Sets the rate at which the hardware produces data. Drivers should call this
+*   whenever they change the hardware's rate.
+*/
+void SensorWrapper::setOutputDataRate(float hz) {
+  _odr = (hz > 0.0f) ? hz : 0.0f;
+  _poll_period = (hz > 0.0f) ? (uint32_t) (1000000.0f / hz) : 0;
+}
+
+
+
 /*******************************************************************************
 * Functions that generate string outputs.                                      *
 *******************************************************************************/
@@ -346,7 +391,7 @@ SensorError SensorWrapper::issue_value_map(TCode tcode, StringBuilder* output) {
         if (final_size) {
           output->concat(coutput.data(), final_size);
         }
-        if (0 == Argument::encodeToCBOR((Argument*) &datum_list, output)) {
+        if (0 <= Argument::encodeToCBOR((Argument*) &datum_list, output)) {
           return SensorError::NO_ERROR;
         }
       }
@@ -401,7 +446,13 @@ SensorError SensorWrapper::updateDatum(uint8_t dat, void *reading) {
   else {
     return SensorError::INVALID_DATUM;
   }
-  return mark_dirty(dat);   // If we've come this far, mark this datum as dirty.
+  if (current->noteUpdate()) {
+    _flags |= MANUVR_SENSOR_FLAG_REPORT_DUE;
+  }
+  // If we've come this far, mark this datum as dirty.
+  current->dirty(true);
+  updated_at = micros();
+  return SensorError::NO_ERROR;
 }
 
 
@@ -57,6 +57,8 @@ typedef void (*SensorCallBack) (SensorWrapper*);
 
 #define SENSE_DATUM_FLAG_HARDWARE      0x80
 #define SENSE_DATUM_FLAG_IS_PROXIED    0x40
+#define SENSE_DATUM_FLAG_REPORT_DUE    0x20
+#define SENSE_DATUM_FLAG_REPORT_REF    0x10
 #define SENSE_DATUM_FLAG_DIRTY         0x08
 #define SENSE_DATUM_FLAG_MEM_ALLOC     0x04
 #define SENSE_DATUM_FLAG_REPORT_READ   0x02
@@ -86,6 +88,18 @@ typedef struct sense_datum_flag_def_t {
 #define MANUVR_SENSOR_FLAG_ACTIVE        0x40
 #define MANUVR_SENSOR_FLAG_AUTOREPORT    0x20
 #define MANUVR_SENSOR_FLAG_CALIBRATED    0x10
+#define MANUVR_SENSOR_FLAG_REPORT_DUE    0x08
+
+
+/*
+* SensorManager tuning.
+* The service period follows the fastest sensor, within these bounds. Sensors
+*   that don't declare a data rate are polled on every service.
+*/
+#define SENSOR_MGR_MAX_PERIOD_MS       1001
+#define SENSOR_MGR_MIN_PERIOD_MS       2
+#define SENSOR_MGR_MAX_BUSES           8   // Distinct buses that will be coalesced.
+#define SENSOR_MGR_COALESCE_SHIFT      2   // Pull polls forward by up to 1/4 period.
 
 
 /*
@@ -180,9 +194,26 @@ class SensorDatum : public Argument {
     inline void reportAll() {      _flags |= SENSE_DATUM_FLAG_REPORT_READ;    };
     inline void reportChanges() {  _flags |= SENSE_DATUM_FLAG_REPORT_CHANGE;  };
 
+    /*
+    * Under reportChanges(), a numeric value must move further than this from
+    *   the last value reported before it is reported again. Zero reports any change.
+    */
+    inline float deadband() {          return _deadband;   };
+    inline void  deadband(float x) {   _deadband = (x < 0.0f) ? -x : x;  };
+
+    /* Has an update to this datum earned a report that hasn't been issued? */
+    inline bool reportDue() {    return (SENSE_DATUM_FLAG_REPORT_DUE == (_flags & SENSE_DATUM_FLAG_REPORT_DUE));  };
+    inline void reportIssued() { _flags &= ~SENSE_DATUM_FLAG_REPORT_DUE;   };
+
+    bool noteUpdate();
+
 
   private:
+    double         _reported   = 0;        // The value last marked for report.
+    float          _deadband   = 0.0f;     // Change threshold for REPORT_CHANGE.
     uint8_t        _flags      = 0;        // Dirty, autoreport, hardware basis, etc...
+
+    bool _numeric_value(double*);
 };
 
 
@@ -207,6 +238,20 @@ class SensorWrapper {
     /* Sets a callback function for all data in this sensor. */
     inline void setAutoReportCallback(SensorCallBack nu) {  ar_callback = nu;  };
     inline void setSensorManager(SensorManager* x) {        _sm = x;           };
+    SensorError setDeadband(uint8_t, float);  // Sets the change threshold for the given datum.
+
+    /* Have any data been updated in a way that warrants a report? */
+    inline bool reportDue() {   return (MANUVR_SENSOR_FLAG_REPORT_DUE == (_flags & MANUVR_SENSOR_FLAG_REPORT_DUE));  };
+    SensorError issueReport();
+
+    /*
+    * The rate at which the hardware produces new data, in Hz. The SensorManager
+    *   won't poll faster than this. Zero means "unknown", and such sensors are
+    *   polled on every service.
+    */
+    void setOutputDataRate(float hz);
+    inline float    outputDataRate() {  return _odr;           };
+    inline uint32_t pollPeriod() {      return _poll_period;   };  // Microseconds.
 
     /* Is this sensor active? */
     inline bool isActive() {        return (MANUVR_SENSOR_FLAG_ACTIVE == (_flags & MANUVR_SENSOR_FLAG_ACTIVE));  };
@@ -236,12 +281,12 @@ class SensorWrapper {
     confusion later. See some of the provided sensor classes for examples.
     */
 
-    inline SensorError readDatumRaw(uint8_t dat, double *val) {         return readDatumRaw(dat, (void*) &val); }
-    inline SensorError readDatumRaw(uint8_t dat, float *val) {          return readDatumRaw(dat, (void*) &val); }
-    inline SensorError readDatumRaw(uint8_t dat, int *val) {            return readDatumRaw(dat, (void*) &val); }
-    inline SensorError readDatumRaw(uint8_t dat, unsigned int *val) {   return readDatumRaw(dat, (void*) &val); }
-    inline SensorError readDatumRaw(uint8_t dat, char** val) {          return readDatumRaw(dat, (void*) &val); }
-    inline SensorError readDatumRaw(uint8_t dat, unsigned char** val) { return readDatumRaw(dat, (void*) &val); }
+    inline SensorError readDatumRaw(uint8_t dat, double *val) {         return readDatumRaw(dat, (void*) val); }
+    inline SensorError readDatumRaw(uint8_t dat, float *val) {          return readDatumRaw(dat, (void*) val); }
+    inline SensorError readDatumRaw(uint8_t dat, int *val) {            return readDatumRaw(dat, (void*) val); }
+    inline SensorError readDatumRaw(uint8_t dat, unsigned int *val) {   return readDatumRaw(dat, (void*) val); }
+    inline SensorError readDatumRaw(uint8_t dat, char** val) {          return readDatumRaw(dat, (void*) val); }
+    inline SensorError readDatumRaw(uint8_t dat, unsigned char** val) { return readDatumRaw(dat, (void*) val); }
     SensorError readDatumRaw(uint8_t, void*);   // This is the actual implementation.
 
     // Static functions...
@@ -283,6 +328,10 @@ class SensorWrapper {
     UUID uuid;             // A cross-platform unique ID for this sensor.
     const char*    name;   // This is the name of the sensor.
     SensorManager* _sm         = nullptr;
+    const void*    _bus        = nullptr; // Sensors that share a bus are polled together.
+    float          _odr        = 0.0f;    // Output data rate, in Hz.
+    uint32_t       _poll_period = 0;      // Microseconds between polls. Derived from _odr.
+    uint32_t       _next_poll  = 0;       // When the SensorManager should next poll us.
     SensorDatum*   datum_list  = nullptr; // Linked list of data that this sensor might carry.
     SensorCallBack ar_callback = nullptr; // The pointer to the callback function used for autoreporting.
     long           updated_at  = 0;       // When was the last update?
@@ -290,6 +339,8 @@ class SensorWrapper {
 
     void insert_datum(SensorDatum*);
     SensorError mark_dirty(uint8_t);   // Marks a specific datum in this sensor as dirty.
+
+    friend class SensorManager;   // For the poll schedule.
 };
 
 
@@ -320,22 +371,42 @@ class SensorManager : public EventReceiver
     #endif  //MANUVR_CONSOLE_SUPPORT
 
     /* For application usage. */
-    int8_t addSensor(SensorWrapper*);
+    int8_t addSensor(SensorWrapper*, const void* bus);   // bus is any pointer unique to the sensor's bus.
     int8_t dropSensor(SensorWrapper*);
+    inline int8_t addSensor(SensorWrapper* s) {  return addSensor(s, nullptr);  };
 
     void printSensorList(StringBuilder*);
 
+    /* Poll accounting. */
+    inline uint32_t pollsExecuted() {   return _polls_executed;   };
+    inline uint32_t pollsSkipped() {    return _polls_skipped;    };
+    inline uint32_t pollsCoalesced() {  return _polls_coalesced;  };
+    inline uint32_t pollsFailed() {     return _polls_failed;     };
+    inline uint32_t reportsIssued() {   return _reports_issued;   };
+    inline uint32_t servicePeriod() {   return _svc_period;       };  // Milliseconds.
+
 
   protected:
     int8_t attached();      // This is called from the base notify().
 
 
   private:
-    PriorityQueue<SensorWrapper*> _sensors;    // SensorWrappers we service.
+    PriorityQueue<SensorWrapper*> _sensors;    // SensorWrappers we service, grouped by bus.
     ManuvrMsg _sensor_report;  // Schedule
+    ManuvrMsg _report_ready;   // Raised when a service turns up something to report.
+    const void* _buses[SENSOR_MGR_MAX_BUSES];  // Sensor priority is bus index, plus one.
+    uint32_t _svc_period      = SENSOR_MGR_MAX_PERIOD_MS;
+    uint32_t _polls_executed  = 0;
+    uint32_t _polls_skipped   = 0;
+    uint32_t _polls_coalesced = 0;
+    uint32_t _polls_failed    = 0;
+    uint32_t _reports_issued  = 0;
+    bool     _report_pending  = false;
 
     int _service_sensors();
     int _report_sensors();
+    void _retune_service_period();
+    int  _bus_index(const void*);
 
     int _init_sensor_by_index(uint8_t);
     int _read_sensor_by_index(uint8_t);
@@ -24,6 +24,7 @@ limitations under the License.
 
 
 EventReceiver::EventReceiver(const char* nom) : _receiver_name(nom) {
+  local_log.coalesce(true);   // Built up from many small pieces.
 }
 
 EventReceiver::~EventReceiver() {
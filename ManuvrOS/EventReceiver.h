@@ -133,6 +133,37 @@ Lifecycle:
         */
         inline bool   dirtyConf() {    return (0 != (_class_state & MANUVR_ER_FLAG_CONF_DIRTY));    };
 
+        /**
+        * May the Kernel call notify() from a worker thread, concurrently with
+        *   other receivers? Receivers are never re-entered, and see events in
+        *   order, either way.
+        * A parallel-safe receiver must not raise events (or take them with
+        *   returnEvent()) from notify(). The Msg preallocation pool is not
+        *   thread-safe.
+        *
+        * @return  true if the class has declared itself parallel-safe.
+        */
+        inline bool   parallelSafe() { return _parallel_safe;  };
+
+        /**
+        * Which message codes does this class want to be notified of? The list
+        *   is terminated by MANUVR_MSG_UNDEFINED. Boot and configuration
+        *   messages are always delivered, since the base notify() handles them.
+        *
+        * @return  The list, or nullptr if the class wants everything.
+        */
+        inline const uint16_t* msgInterest() {   return _msg_interest;   };
+
+        /**
+        * How much notify() time (in uS) may this class spend in a single pass
+        *   of the Kernel's loop? Once it goes over, the Kernel ends the pass
+        *   after the current event, so that everything else gets a turn.
+        *
+        * @return  The budget, or zero if unlimited.
+        */
+        inline uint32_t schedBudget() {              return _sched_budget_us;   };
+        inline void     schedBudget(uint32_t us) {   _sched_budget_us = us;     };
+
         #if defined(__BUILD_HAS_THREADS)
           inline void   wake() {    wakeThread(_thread_id);    };
         #endif
@@ -151,6 +182,12 @@ Lifecycle:
 
         void flushLocalLog();
 
+        /* Extending classes call this if their notify() is thread-safe. */
+        inline void parallelSafe(bool x) {   _parallel_safe = x;   };
+
+        /* Extending classes call this before subscribing, to narrow their notifications. */
+        inline void msgInterest(const uint16_t* codes) {   _msg_interest = codes;   };
+
         // These inlines are for convenience of extending classes.
         inline uint8_t _er_flags() {                 return _extnd_state;            };
         inline bool _er_flag(uint8_t _flag) {        return (_extnd_state & _flag);  };
@@ -165,10 +202,23 @@ Lifecycle:
 
       private:
         const char* const _receiver_name;
+        const uint16_t*   _msg_interest  = nullptr;  // See msgInterest().
         uint8_t     _class_state   = (DEFAULT_CLASS_VERBOSITY & MANUVR_ER_FLAG_VERBOSITY_MASK);
         uint8_t     _extnd_state   = 0;  // This is here for use by the extending class.
+        bool        _parallel_safe = false;
+
+        /* The Kernel's accounting of our notify() time. See schedBudget(). */
+        uint32_t    _sched_budget_us   = 0;  // Zero is unlimited.
+        uint32_t    _sched_loop        = 0;  // The Kernel loop that _sched_loop_us belongs to.
+        uint32_t    _sched_loop_us     = 0;  // notify() time in that loop.
+        uint32_t    _sched_loop_max_us = 0;  // The most notify() time in any one loop.
+        uint32_t    _sched_total_us    = 0;  // notify() time, all told.
+        uint32_t    _sched_calls       = 0;  // Timed notify() calls.
+        uint32_t    _sched_overruns    = 0;  // Loops in which we exceeded our budget.
 
         inline void _mark_attached() {   _class_state |= MANUVR_ER_FLAG_ATTACHED;  };
+
+        friend class Kernel;   // Kernel::subscribe() can set our interests, and it keeps our time.
     };
   }
 
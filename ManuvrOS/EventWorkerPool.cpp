@@ -0,0 +1,404 @@
+/*
+File:   EventWorkerPool.cpp
+Author: J. Ian Lindsay
+Date:   2026.10.17
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include "EventWorkerPool.h"
+
+#if defined(__BUILD_HAS_PTHREADS)
+#include <signal.h>
+#include "EventReceiver.h"
+#include "Platform/Platform.h"
+
+
+/**
+* Worker thread entry point.
+*
+* @param  The EWWorker that this thread is to be.
+* @return nullptr, always.
+*/
+void* EventWorkerPool::worker_loop(void* arg) {
+  EWWorker* w = (EWWorker*) arg;
+  // Timer and termination signals belong to the main thread.
+  sigset_t set;
+  sigemptyset(&set);
+  sigaddset(&set, SIGQUIT);
+  sigaddset(&set, SIGHUP);
+  sigaddset(&set, SIGTERM);
+  sigaddset(&set, SIGVTALRM);
+  sigaddset(&set, SIGINT);
+  pthread_sigmask(SIG_BLOCK, &set, nullptr);
+  w->pool->_work(w->idx);
+  return nullptr;
+}
+
+
+/*******************************************************************************
+*   ___ _              ___      _ _              _      _
+*  / __| |__ _ ______ | _ ) ___(_) |___ _ _ _ __| |__ _| |_ ___
+* | (__| / _` (_-<_-< | _ \/ _ \ | / -_) '_| '_ \ / _` |  _/ -_)
+*  \___|_\__,_/__/__/ |___/\___/_|_\___|_| | .__/_\__,_|\__\___|
+*                                          |_|
+* Constructors/destructors, class initialization functions and so-forth...
+*******************************************************************************/
+
+EventWorkerPool::EventWorkerPool() {
+  pthread_mutex_init(&_mutex, nullptr);
+  pthread_cond_init(&_work_cond, nullptr);
+  pthread_cond_init(&_idle_cond, nullptr);
+  for (int i = 0; i < EVENT_WORKERS_MAX; i++) {
+    _workers[i].pool       = this;
+    _workers[i].ready_head = nullptr;
+    _workers[i].ready_tail = nullptr;
+    _workers[i].jobs       = 0;
+    _workers[i].steals     = 0;
+    _workers[i].idx        = i;
+  }
+}
+
+
+/**
+* Destructor. Stops the threads and frees everything we allocated.
+*/
+EventWorkerPool::~EventWorkerPool() {
+  stop();
+  while (nullptr != _free_jobs) {
+    EWJob* j = _free_jobs;
+    _free_jobs = j->next;
+    delete j;
+  }
+  while (nullptr != _free_tickets) {
+    EWTicket* t = _free_tickets;
+    _free_tickets = t->_mp_next;
+    delete t;
+  }
+  for (std::map<EventReceiver*, EWStrand*>::iterator it = _strands.begin(); it != _strands.end(); ++it) {
+    delete it->second;
+  }
+  pthread_cond_destroy(&_idle_cond);
+  pthread_cond_destroy(&_work_cond);
+  pthread_mutex_destroy(&_mutex);
+}
+
+
+/**
+* Starts the given number of worker threads.
+*
+* @param  threads  How many threads? Must be in [1, EVENT_WORKERS_MAX].
+* @return 0 on success, -1 if already running, -2 on bad count, -3 if a
+*           thread could not be created.
+*/
+int8_t EventWorkerPool::start(uint8_t threads) {
+  if (_running) return -1;
+  if ((0 == threads) || (threads > EVENT_WORKERS_MAX)) return -2;
+  _running     = true;
+  _next_worker = 0;
+  for (uint8_t i = 0; i < threads; i++) {
+    if (0 != pthread_create(&_workers[i].thread, nullptr, worker_loop, (void*) &_workers[i])) {
+      _thread_count = i;
+      stop();
+      return -3;
+    }
+    _thread_count = i + 1;
+  }
+  return 0;
+}
+
+
+/**
+* Stops the worker threads. Anything already dispatched is delivered first,
+*   and its ticket will still turn up in completed().
+*/
+void EventWorkerPool::stop() {
+  pthread_mutex_lock(&_mutex);
+  _running = false;
+  pthread_cond_broadcast(&_work_cond);
+  pthread_mutex_unlock(&_mutex);
+  for (uint8_t i = 0; i < _thread_count; i++) {
+    pthread_join(_workers[i].thread, nullptr);
+  }
+  _thread_count = 0;
+}
+
+
+/*******************************************************************************
+* Work distribution                                                            *
+*******************************************************************************/
+
+/**
+* Puts a strand on the tail of the given worker's ready list.
+* Caller must hold the lock.
+*/
+void EventWorkerPool::_make_ready(EWStrand* s, uint8_t worker) {
+  EWWorker* w = &_workers[worker];
+  s->ready      = true;
+  s->next_ready = nullptr;
+  if (nullptr == w->ready_tail) {
+    w->ready_head = s;
+  }
+  else {
+    w->ready_tail->next_ready = s;
+  }
+  w->ready_tail = s;
+}
+
+
+/**
+* Takes a strand from the given worker's own ready list, or failing that,
+*   steals one from another worker.
+* Caller must hold the lock.
+*
+* @return a strand to run, or nullptr if there is nothing to do.
+*/
+EWStrand* EventWorkerPool::_take_ready(uint8_t worker) {
+  for (uint8_t i = 0; i < _thread_count; i++) {
+    EWWorker* w = &_workers[(worker + i) % _thread_count];
+    EWStrand* s = w->ready_head;
+    if (nullptr != s) {
+      w->ready_head = s->next_ready;
+      if (nullptr == w->ready_head) w->ready_tail = nullptr;
+      s->next_ready = nullptr;
+      if (0 != i) _workers[worker].steals++;
+      return s;
+    }
+  }
+  return nullptr;
+}
+
+
+/**
+* The body of each worker thread. Runs strands until told to stop and there
+*   is nothing left to run.
+* The strand is ours alone while we hold it, so the receiver is called
+*   without the lock.
+*/
+void EventWorkerPool::_work(uint8_t worker) {
+  pthread_mutex_lock(&_mutex);
+  while (true) {
+    EWStrand* s = _take_ready(worker);
+    if (nullptr == s) {
+      if (!_running) break;
+      pthread_cond_wait(&_work_cond, &_mutex);
+      continue;
+    }
+
+    EWJob* job = s->head;
+    s->head = job->next;
+    if (nullptr == s->head) s->tail = nullptr;
+    pthread_mutex_unlock(&_mutex);
+
+    EWTicket* t = job->ticket;
+    int8_t result = s->receiver->notify(t->event);
+
+    pthread_mutex_lock(&_mutex);
+    if (0 != result) t->activity++;
+    _workers[worker].jobs++;
+    _queued_jobs--;
+    job->next  = _free_jobs;
+    _free_jobs = job;
+    if (0 == --t->pending) {
+      _completions.push(t);
+    }
+    s->pending--;
+    if (nullptr != s->head) {
+      // More for this receiver. Keep it on this worker, behind everyone else.
+      _make_ready(s, worker);
+    }
+    else {
+      s->ready = false;
+    }
+    if ((0 == _queued_jobs) || (0 == s->pending)) pthread_cond_broadcast(&_idle_cond);
+  }
+  pthread_mutex_unlock(&_mutex);
+}
+
+
+/**
+* Dispatches an event to the given receivers. Each receiver's strand gets a
+*   notification appended to it.
+*
+* @param  event      The event to deliver.
+* @param  receivers  The receivers to deliver it to. All must be parallelSafe().
+* @param  count      How many receivers.
+* @param  activity   Activity already provoked by receivers notified inline.
+* @return the number of receivers the event was dispatched to, or -1 if the
+*           pool isn't running.
+*/
+int EventWorkerPool::dispatch(ManuvrMsg* event, EventReceiver** receivers, int count, int activity) {
+  if (!_running || (0 == _thread_count)) return -1;
+  if (0 >= count) return 0;
+
+  EWTicket* t = _free_tickets;
+  if (nullptr != t) {
+    _free_tickets = t->_mp_next;
+  }
+  else {
+    t = new EWTicket();
+  }
+  t->event      = event;
+  t->_mp_next   = nullptr;
+  t->_mp_claim  = 0;
+  t->pending    = count;
+  t->activity   = activity;
+  t->dispatched = micros();
+  _in_flight++;
+  _dispatched++;
+
+  pthread_mutex_lock(&_mutex);
+  for (int i = 0; i < count; i++) {
+    // Only we touch the map. Workers only see strands once they are ready.
+    EWStrand* s = _strands[receivers[i]];
+    if (nullptr == s) {
+      s = new EWStrand();
+      s->receiver   = receivers[i];
+      s->head       = nullptr;
+      s->tail       = nullptr;
+      s->next_ready = nullptr;
+      s->pending    = 0;
+      s->ready      = false;
+      _strands[receivers[i]] = s;
+    }
+    EWJob* job = _free_jobs;
+    if (nullptr != job) {
+      _free_jobs = job->next;
+    }
+    else {
+      job = new EWJob();
+    }
+    job->ticket = t;
+    job->next   = nullptr;
+    if (nullptr == s->tail) {
+      s->head = job;
+    }
+    else {
+      s->tail->next = job;
+    }
+    s->tail = job;
+    s->pending++;
+    _queued_jobs++;
+    if (!s->ready) {
+      _make_ready(s, _next_worker);
+      _next_worker = (_next_worker + 1) % _thread_count;
+    }
+  }
+  pthread_cond_broadcast(&_work_cond);
+  pthread_mutex_unlock(&_mutex);
+  return count;
+}
+
+
+/**
+* @return the next ticket whose event has been delivered to every receiver,
+*           or nullptr if there are none (yet).
+*/
+EWTicket* EventWorkerPool::completed() {
+  return _completions.dequeue();
+}
+
+
+/**
+* The Kernel is done with the ticket. Recycle it.
+*/
+void EventWorkerPool::retire(EWTicket* t) {
+  t->event      = nullptr;
+  t->_mp_next   = _free_tickets;
+  _free_tickets = t;
+  _in_flight--;
+}
+
+
+/**
+* Blocks until every dispatched notification has been delivered. Tickets are
+*   left in the completion queue for the Kernel to retire.
+*/
+void EventWorkerPool::quiesce() {
+  pthread_mutex_lock(&_mutex);
+  while ((0 < _queued_jobs) && (0 < _thread_count)) {
+    pthread_cond_wait(&_idle_cond, &_mutex);
+  }
+  pthread_mutex_unlock(&_mutex);
+}
+
+
+/**
+* Blocks until every notification dispatched to the given receiver has been
+*   delivered. The Kernel calls this before notifying a parallel-safe receiver
+*   on its own thread, so that the receiver is never re-entered, and sees
+*   events in order.
+* Kernel thread only.
+*
+* @param  rx  The receiver.
+* @return 1 if we had to wait, 0 otherwise.
+*/
+int8_t EventWorkerPool::drain(EventReceiver* rx) {
+  std::map<EventReceiver*, EWStrand*>::iterator it = _strands.find(rx);
+  if (it == _strands.end()) return 0;
+  EWStrand* s = it->second;
+  int8_t return_value = 0;
+  pthread_mutex_lock(&_mutex);
+  if (0 < s->pending) {
+    return_value = 1;
+    _drains++;
+    // stop() delivers everything before the threads exit, so this can't hang.
+    while (0 < s->pending) {
+      pthread_cond_wait(&_idle_cond, &_mutex);
+    }
+  }
+  pthread_mutex_unlock(&_mutex);
+  return return_value;
+}
+
+
+/**
+* Discards the strand of a receiver that is going away, after it has seen
+*   everything dispatched to it. Otherwise, a later receiver at the same
+*   address would inherit it.
+* Kernel thread only.
+*
+* @param  rx  The receiver.
+*/
+void EventWorkerPool::forget(EventReceiver* rx) {
+  std::map<EventReceiver*, EWStrand*>::iterator it = _strands.find(rx);
+  if (it == _strands.end()) return;
+  drain(rx);
+  // The last worker to hold the strand let go of it before drain() woke.
+  delete it->second;
+  _strands.erase(it);
+}
+
+
+/**
+* Debug support method.
+*
+* @param   StringBuilder* The buffer into which this fxn should write its output.
+*/
+void EventWorkerPool::printDebug(StringBuilder* output) {
+  output->concatf("-- Worker pool:        %u threads (%srunning)\n", _thread_count, (_running ? "" : "not "));
+  output->concatf("-- Dispatched:         %lu\n", (unsigned long) _dispatched);
+  output->concatf("-- In flight:          %d\n", _in_flight);
+  output->concatf("-- Drains:             %lu\n", (unsigned long) _drains);
+  output->concatf("-- Strands:            %lu\n", (unsigned long) _strands.size());
+  pthread_mutex_lock(&_mutex);
+  for (uint8_t i = 0; i < _thread_count; i++) {
+    output->concatf("\t Worker %u:  %lu jobs, %lu steals\n", i, (unsigned long) _workers[i].jobs, (unsigned long) _workers[i].steals);
+  }
+  pthread_mutex_unlock(&_mutex);
+}
+
+#endif  // __BUILD_HAS_PTHREADS
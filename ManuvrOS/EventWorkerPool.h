@@ -0,0 +1,150 @@
+/*
+File:   EventWorkerPool.h
+Author: J. Ian Lindsay
+Date:   2026.10.17
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+A pool of threads that the Kernel can use to notify() EventReceivers of
+  events in parallel. This is opt-in. See Kernel::workerThreads().
+
+Only events whose MessageTypeDef carries MSG_FLAG_PARALLEL_SAFE are eligible,
+  and only receivers that have declared themselves parallelSafe() are notified
+  from the pool. Everyone else is notified on the Kernel's thread, as before.
+
+Each receiver gets a strand: a FIFO of the events it has yet to see. A strand
+  is only ever run by one worker at a time, so each receiver sees events in
+  the order the Kernel dispatched them, and is never re-entered. Different
+  receivers run concurrently. A receiver whose strand is not yet empty is
+  not notified inline of anything else until the strand drains (see drain()),
+  so events that aren't parallel-safe keep their place in line too. Ready strands are handed to workers round-robin,
+  and a worker with nothing to do steals from the others.
+
+The pool never calls back into the Kernel. Once every strand has seen a given
+  event, the event's ticket is pushed to a lock-free completion queue that
+  the Kernel drains on its own thread. Call-backs, originator callbacks and
+  reclamation all happen there, in the same order as before.
+
+Receivers that are notified from the pool must not mutate the event, and must
+  not raise (or take) events from notify(). The Kernel's preallocation pool
+  is not thread-safe.
+*/
+
+
+#ifndef __MANUVR_EVENT_WORKER_POOL_H__
+#define __MANUVR_EVENT_WORKER_POOL_H__
+
+#include <inttypes.h>
+#include <map>
+#include "CommonConstants.h"
+#include "DataStructures/MPSCQueue.h"
+#include "DataStructures/StringBuilder.h"
+
+#if defined(__BUILD_HAS_PTHREADS)
+#include <pthread.h>
+
+#define EVENT_WORKERS_MAX   16
+
+class ManuvrMsg;
+class EventReceiver;
+class EventWorkerPool;
+
+/* Tracks a single event while it is in the pool. */
+typedef struct ew_ticket_t {
+  ManuvrMsg*          event;
+  struct ew_ticket_t* _mp_next;    // Completion queue link.
+  uint8_t             _mp_claim;   // Completion queue claim.
+  int                 pending;     // Notifications not yet delivered.
+  int                 activity;    // Notifications that provoked action.
+  uint32_t            dispatched;  // micros() at dispatch.
+} EWTicket;
+
+/* One notification owed to one receiver. */
+typedef struct ew_job_t {
+  EWTicket*        ticket;
+  struct ew_job_t* next;
+} EWJob;
+
+/* The ordered work for a single receiver. */
+typedef struct ew_strand_t {
+  EventReceiver*      receiver;
+  EWJob*              head;
+  EWJob*              tail;
+  struct ew_strand_t* next_ready;
+  int                 pending;     // Jobs queued or being run.
+  bool                ready;       // Waiting in a ready list, or being run.
+} EWStrand;
+
+/* Per-thread state. */
+typedef struct ew_worker_t {
+  EventWorkerPool*    pool;
+  pthread_t           thread;
+  EWStrand*           ready_head;
+  EWStrand*           ready_tail;
+  uint32_t            jobs;        // Notifications delivered.
+  uint32_t            steals;      // Strands taken from other workers.
+  uint8_t             idx;
+} EWWorker;
+
+
+class EventWorkerPool {
+  public:
+    EventWorkerPool();
+    ~EventWorkerPool();
+
+    int8_t start(uint8_t threads);   // Returns 0 on success.
+    void   stop();                   // Finishes queued work, then joins.
+
+    /* Kernel thread only. */
+    int  dispatch(ManuvrMsg*, EventReceiver**, int count, int activity);
+    EWTicket* completed();           // Next ticket whose event has been fully delivered.
+    void retire(EWTicket*);          // Hand a completed ticket back.
+    void quiesce();                  // Block until nothing is in flight.
+    int8_t drain(EventReceiver*);    // Block until the receiver has seen everything dispatched to it.
+    void forget(EventReceiver*);     // Drain, then discard the receiver's strand.
+
+    inline uint8_t threads() {   return _thread_count;   };
+    inline int     inFlight() {  return _in_flight;      };
+
+    void printDebug(StringBuilder*);
+
+    static void* worker_loop(void*);
+
+
+  private:
+    EWWorker   _workers[EVENT_WORKERS_MAX];
+    std::map<EventReceiver*, EWStrand*> _strands;   // Kernel thread only.
+    MPSCQueue<EWTicket> _completions;
+    pthread_mutex_t _mutex;
+    pthread_cond_t  _work_cond;
+    pthread_cond_t  _idle_cond;
+    EWJob*     _free_jobs     = nullptr;   // Guarded by _mutex.
+    EWTicket*  _free_tickets  = nullptr;   // Kernel thread only.
+    int        _in_flight     = 0;         // Tickets not yet retired. Kernel thread only.
+    int        _queued_jobs   = 0;         // Guarded by _mutex.
+    uint32_t   _dispatched    = 0;
+    uint32_t   _drains        = 0;         // drain() calls that had to wait.
+    uint8_t    _thread_count  = 0;
+    uint8_t    _next_worker   = 0;
+    bool       _running       = false;
+
+    void      _make_ready(EWStrand*, uint8_t worker);
+    EWStrand* _take_ready(uint8_t worker);
+    void      _work(uint8_t worker);
+};
+
+#endif  // __BUILD_HAS_PTHREADS
+#endif  // __MANUVR_EVENT_WORKER_POOL_H__
@@ -24,6 +24,7 @@ limitations under the License.
 #include <Platform/Platform.h>
 
 #include <MsgProfiler.h>
+#include <EventWorkerPool.h>
 
 // Conditional inclusion for different threading models...
 #if defined(__MANUVR_LINUX)
@@ -44,7 +45,7 @@ limitations under the License.
 uint32_t    Kernel::lagged_schedules = 0;
 Kernel*     Kernel::INSTANCE         = nullptr;
 BufferPipe* Kernel::_logger          = nullptr;  // The logger slot.
-PriorityQueue<ManuvrMsg*> Kernel::isr_exec_queue;
+MPSCQueue<ManuvrMsg>      Kernel::isr_exec_queue;
 
 
 /* Duty-cycle calculation. */
@@ -52,6 +53,20 @@ unsigned long Kernel::_idle_trans_point = 0;
 unsigned long Kernel::_millis_idle      = 0;
 unsigned long Kernel::_millis_working   = 1;
 
+/*
+* The scheduling bands, lowest first. A band holds the priorities from its
+*   floor up to the next band's floor. The top band may have the whole loop.
+*/
+static const uint8_t  _sched_band_floors[KERNEL_SCHED_BANDS]  = {
+  EVENT_PRIORITY_LOWEST, EVENT_PRIORITY_DEFAULT, 5, EVENT_PRIORITY_HIGHEST
+};
+static const uint32_t _sched_band_budgets[KERNEL_SCHED_BANDS] = {
+  300, 600, 800, KERNEL_SCHED_LOOP_BUDGET_US
+};
+static const char* const _sched_band_names[KERNEL_SCHED_BANDS] = {
+  "Background", "Default", "Elevated", "Highest"
+};
+
 /*
 * These are the hard-coded message types that the program knows about.
 * This is where we decide what kind of arguments each message is capable of carrying.
@@ -200,6 +215,14 @@ Kernel::Kernel() : EventReceiver("Kernel"), _msg_prealloc(EVENT_MANAGER_PREALLOC
   max_idle_count       = 100;
   consequtive_idles    = max_idle_count;
 
+  for (int b = 0; b < KERNEL_SCHED_BANDS; b++) {
+    SchedBand* band = &_bands[b];
+    memset(band, 0, sizeof(SchedBand));
+    band->budget_us = _sched_band_budgets[b];
+    band->floor     = _sched_band_floors[b];
+    band->ceiling   = (b < (KERNEL_SCHED_BANDS - 1)) ? (_sched_band_floors[b + 1] - 1) : 255;
+  }
+
   for (int i = 0; i < EVENT_MANAGER_PREALLOC_COUNT; i++) {
     /* We carved out a space in our allocation for a pool of events. Ideally, this would be enough
         for most of the load, most of the time. If the preallocation ends up being insufficient to
@@ -222,6 +245,20 @@ Kernel::Kernel() : EventReceiver("Kernel"), _msg_prealloc(EVENT_MANAGER_PREALLOC
 * Destructor. Should probably never be called.
 */
 Kernel::~Kernel() {
+  #if defined(__BUILD_HAS_PTHREADS)
+    workerThreads(0);
+  #endif
+  sched_wheel.clear();
+  for (std::map<uint16_t, DispatchList*>::iterator it = _dispatch_lists.begin(); it != _dispatch_lists.end(); ++it) {
+    if (nullptr != it->second) {
+      delete[] it->second->list;
+      delete it->second;
+    }
+  }
+  if (nullptr != _fan_out) {
+    delete[] _fan_out;
+    _fan_out = nullptr;
+  }
   ManuvrMsg* temp = schedules.dequeue();
   while (temp) {
     temp->decRefs();
@@ -303,6 +340,7 @@ int8_t Kernel::subscribe(EventReceiver *client) {
 
   client->setVerbosity((int8_t)DEFAULT_CLASS_VERBOSITY);
   int8_t return_value = subscribers.insert(client);
+  _dispatch_gen++;
   if (erAttached()) {
     // This subscriber is joining us after bootup. Call its attached() fxn to cause it to init.
     client->attached();
@@ -327,6 +365,7 @@ int8_t Kernel::subscribe(EventReceiver *client, uint8_t priority) {
 
   client->setVerbosity((int8_t)DEFAULT_CLASS_VERBOSITY);
   int8_t return_value = subscribers.insert(client, priority);
+  _dispatch_gen++;
   if (erAttached()) {
     // This subscriber is joining us after bootup. Call its attached() fxn to cause it to init.
     client->attached();
@@ -336,6 +375,23 @@ int8_t Kernel::subscribe(EventReceiver *client, uint8_t priority) {
 }
 
 
+/**
+* A class calls this to subscribe to only the given message codes. This
+*   saves a notify() call for every other event that passes through.
+*
+* @param  client    The class that will be listening for Events.
+* @param  priority  The priority of the client in the Event queue.
+* @param  codes     The codes the client handles, terminated by MANUVR_MSG_UNDEFINED.
+*                     Must outlive the subscription. nullptr means all codes.
+* @return 0 on success and -1 on failure.
+*/
+int8_t Kernel::subscribe(EventReceiver *client, uint8_t priority, const uint16_t* codes) {
+  if (nullptr == client) return -1;
+  client->_msg_interest = codes;
+  return subscribe(client, priority);
+}
+
+
 /**
 * A class calls this to unsubscribe.
 *
@@ -344,14 +400,23 @@ int8_t Kernel::subscribe(EventReceiver *client, uint8_t priority) {
 */
 int8_t Kernel::unsubscribe(EventReceiver *client) {
   if (nullptr == client) return -1;
-  return (subscribers.remove(client) ? 0 : -1);
+  #if defined(__BUILD_HAS_PTHREADS)
+    // The client may still owe the worker pool some notify() calls.
+    if (nullptr != _workers) {
+      _workers->quiesce();
+      _workers->forget(client);
+    }
+  #endif
+  if (subscribers.remove(client)) {
+    _dispatch_gen++;
+    return 0;
+  }
+  return -1;
 }
 
 
 EventReceiver* Kernel::getSubscriberByName(const char* search_str) {
-  EventReceiver* working;
-  for (int i = 0; i < subscribers.size(); i++) {
-    working = subscribers.get(i);
+  for (EventReceiver* working : subscribers) {
     if (!strcasecmp(working->getReceiverName(), search_str)) {
       return working;
     }
@@ -485,15 +550,22 @@ bool Kernel::abortEvent(ManuvrMsg* event) {
 }
 
 
-// TODO: It would be bettter to put a semaphore on the exec_queue and set it in the idle loop.
-//       That way, we could check for it here, and have the (probable) possibility of not incurring
-//       the cost for merging these two queues if we don't have to.
-//             ---J. Ian Lindsay   Fri Jul 03 16:54:14 MST 2015
+/**
+* Raise an event from an ISR, or from any thread other than the Kernel's. The
+*   event is pushed onto a lock-free queue, and validated into the exec_queue
+*   by the Kernel's next call to procIdleFlags().
+* No locks are taken, and interrupts are left alone.
+*
+* @param   event  The event to be raised.
+* @return  0 on success, -1 on null, or -3 if the event is already pending.
+*/
 int8_t Kernel::isrRaiseEvent(ManuvrMsg* event) {
-  int return_value = -1;
-  maskableInterrupts(false);
-  return_value = isr_exec_queue.insertIfAbsent(event, event->priority());
-  maskableInterrupts(true);
+  #if defined(MANUVR_EVENT_PROFILER)
+    if ((nullptr != event) && INSTANCE->_profiler_enabled() && (0 == event->raisedAt())) {
+      event->raisedAt(micros());
+    }
+  #endif  //MANUVR_EVENT_PROFILER
+  int8_t return_value = isr_exec_queue.push(event);
   #if defined (__BUILD_HAS_THREADS)
     if (INSTANCE->_thread_id) wakeThread(INSTANCE->_thread_id);
   #endif
@@ -556,16 +628,21 @@ int8_t Kernel::validate_insertion(ManuvrMsg* event) {
   if (MANUVR_MSG_UNDEFINED == event->eventCode()) {
     return -2;  // No undefined events.
   }
-
-  if (exec_queue.contains(event)) {
-    // Bail out with error, because this event (which is status-bearing) cannot be in the
-    //   queue more than once.
-    return -3;
+  if (event->isDispatched()) {
+    return -3;  // Still being delivered by the worker pool.
   }
 
-  // Go ahead and insert.
-  INSTANCE->exec_queue.insert(event, event->priority());
-  return 0;
+  // Go ahead and insert. The queue will refuse (with -3) an event that is
+  //   already enqueued, because this event (which is status-bearing) cannot
+  //   be in the queue more than once.
+  int8_t return_value = exec_queue.insert(event);
+  #if defined(MANUVR_EVENT_PROFILER)
+    // Events from isrRaiseEvent() were stamped when they were raised.
+    if ((0 == return_value) && _profiler_enabled() && (0 == event->raisedAt())) {
+      event->raisedAt(micros());
+    }
+  #endif  //MANUVR_EVENT_PROFILER
+  return return_value;
 }
 
 
@@ -577,6 +654,9 @@ int8_t Kernel::validate_insertion(ManuvrMsg* event) {
 */
 void Kernel::reclaim_event(ManuvrMsg* obj) {
   if (obj) {
+    #if defined(MANUVR_EVENT_PROFILER)
+      obj->raisedAt(0);   // In case it never made it to dispatch.
+    #endif  //MANUVR_EVENT_PROFILER
     if (0 == obj->refCount()) {
       // No outstanding references.
       if (_msg_prealloc.inPool(obj)) {
@@ -590,6 +670,190 @@ void Kernel::reclaim_event(ManuvrMsg* obj) {
 }
 
 
+/**
+* Everything that happens to an event after its subscribers have seen it:
+*   dead-event accounting, the originator's callback, and reclamation.
+*
+* @param event     The event that has been serviced.
+* @param activity  How many subscribers reacted to it.
+*/
+void Kernel::_retire_event(ManuvrMsg* active_runnable, uint8_t activity) {
+  if (0 == activity) {
+    #ifdef MANUVR_DEBUG
+    if (getVerbosity() >= 3) local_log.concatf("\tDead event: %s\n", active_runnable->getMsgTypeString());
+    #endif
+    total_events_dead++;
+  }
+
+  /* Should we clean up the Event? */
+  bool clean_up_active_runnable = true;  // Defaults to 'yes'.
+  int8_t vi_res = 0;
+
+  switch (active_runnable->callbackOriginator()) {
+    case EVENT_CALLBACK_RETURN_RECYCLE:     // The originating class wants us to re-insert the event.
+      #ifdef MANUVR_DEBUG
+      if (getVerbosity() > 6) local_log.concatf("Recycling %s.\n", active_runnable->getMsgTypeString());
+      #endif
+      vi_res = validate_insertion(active_runnable);
+      switch (vi_res) {
+        case -1:   // NULL runnable! How?!?!
+        case -2:   // UNDEFINED event. This shall not stand, man....
+          #ifdef MANUVR_DEBUG
+            if (getVerbosity() >= 2) local_log.concatf("%s event returned RECYCLE?\n", ((-1 == vi_res) ? "Null" : "UNDEFINED"));
+          #endif
+          break;
+        case -3:   // Pointer idempotency. THIS EXACT runnable is already enqueue.
+          #ifdef MANUVR_DEBUG
+            if (getVerbosity() >= 5) {
+              local_log.concat("THIS EXACT runnable is already enqueue.\n");
+            }
+          #endif
+        case 0:    // Insertion succeeded.
+          clean_up_active_runnable = false;
+          break;
+      }
+      break;
+    case EVENT_CALLBACK_RETURN_ERROR:       // Something went wrong. Should never occur.
+    case EVENT_CALLBACK_RETURN_UNDEFINED:   // The originating class doesn't care what we do with the event.
+      //if (verbosity > 1) local_log.concatf("Kernel found a possible mistake. Unexpected return case from callback_proc.\n");
+      // NOTE: No break;
+    case EVENT_CALLBACK_RETURN_DROP:        // The originating class expects us to drop the event.
+      #ifdef MANUVR_DEBUG
+      //if (getVerbosity() > 6) local_log.concatf("Dropping %s after running.\n", active_runnable->getMsgTypeString());
+      #endif
+      // NOTE: No break;
+    case EVENT_CALLBACK_RETURN_REAP:        // The originating class is explicitly telling us to reap the event.
+      // NOTE: No break;
+    default:
+      //if (verbosity > 0) local_log.concatf("Event %s has no cleanup case.\n", active_runnable->getMsgTypeString());
+      break;
+  }
+
+  // All of the logic above ultimately informs this choice.
+  if (clean_up_active_runnable) {
+    reclaim_event(active_runnable);
+  }
+
+  total_events++;
+}
+
+
+#if defined(__BUILD_HAS_PTHREADS)
+/**
+* Retires every event that the worker pool has finished delivering. Call-backs
+*   run here, on the Kernel's thread, exactly as they would have inline.
+*
+* @return The number of events retired.
+*/
+int Kernel::_retire_dispatched() {
+  int return_value = 0;
+  EWTicket* ticket = nullptr;
+  while (nullptr != (ticket = _workers->completed())) {
+    ManuvrMsg* event = ticket->event;
+    uint8_t activity = (ticket->activity > 255) ? 255 : ticket->activity;
+    _workers->retire(ticket);
+    event->isDispatched(false);
+    current_event = event;
+    procCallBacks(event);
+    _retire_event(event, activity);
+    return_value++;
+  }
+  current_event = nullptr;
+  return return_value;
+}
+
+
+/**
+* Starts, resizes, or stops the worker pool.
+* Only events flagged MSG_FLAG_PARALLEL_SAFE, and only receivers that have
+*   declared themselves parallelSafe(), are affected.
+*
+* @param  count  How many worker threads. Zero stops the pool.
+* @return 0 on success, or the (negative) failure code from the pool.
+*/
+int8_t Kernel::workerThreads(uint8_t count) {
+  if (nullptr != _workers) {
+    _workers->stop();   // Delivers anything in flight.
+    _retire_dispatched();
+    if (0 == count) {
+      delete _workers;
+      _workers = nullptr;
+      return 0;
+    }
+  }
+  else if (0 == count) {
+    return 0;
+  }
+  else {
+    _workers = new EventWorkerPool();
+  }
+  return _workers->start(count);
+}
+
+
+/**
+* @return The number of worker threads presently running.
+*/
+uint8_t Kernel::workerThreads() {
+  return ((nullptr == _workers) ? 0 : _workers->threads());
+}
+#endif  // __BUILD_HAS_PTHREADS
+
+
+/**
+* Returns the subscribers that want to be notified of the given code, in the
+*   same order as the subscriber list. Receivers that declared no interests
+*   are on every list. The list is (re)built on first use after any change
+*   to the subscribers, so a list handed out for the current event stays
+*   valid even if a subscriber joins or leaves while it is being notified.
+*
+* @param code  The message code.
+* @return The dispatch list. Never nullptr.
+*/
+DispatchList* Kernel::_dispatch_list(uint16_t code) {
+  DispatchList* dl = _dispatch_lists[code];
+  if ((nullptr != dl) && (dl->generation == _dispatch_gen)) {
+    return dl;
+  }
+  const int sub_count = subscribers.size();
+  if (nullptr == dl) {
+    dl = new DispatchList();
+    dl->list     = nullptr;
+    dl->capacity = 0;
+    _dispatch_lists[code] = dl;
+  }
+  if (dl->capacity < sub_count) {
+    if (nullptr != dl->list) delete[] dl->list;
+    dl->list     = new EventReceiver*[sub_count];
+    dl->capacity = sub_count;
+  }
+  if (_fan_out_cap < sub_count) {
+    if (nullptr != _fan_out) delete[] _fan_out;
+    _fan_out     = new EventReceiver*[sub_count];
+    _fan_out_cap = sub_count;
+  }
+  dl->count      = 0;
+  dl->generation = _dispatch_gen;
+  for (EventReceiver* subscriber : subscribers) {
+    const uint16_t* interest  = subscriber->msgInterest();
+    bool wanted = (nullptr == interest);
+    switch (code) {
+      case MANUVR_MSG_SYS_BOOT_COMPLETED:   // The base notify() handles these
+      case MANUVR_MSG_SYS_CONF_LOAD:        //   for everyone.
+        wanted = true;
+        break;
+      default:
+        while (!wanted && (MANUVR_MSG_UNDEFINED != *interest)) {
+          wanted = (*interest++ == code);
+        }
+        break;
+    }
+    if (wanted) dl->list[dl->count++] = subscriber;
+  }
+  return dl;
+}
+
+
 /*******************************************************************************
 * Kernel operation...                                                          *
 *******************************************************************************/
@@ -643,6 +907,19 @@ void Kernel::_idle(bool nu) {
 
 
 
+/*
+* Charges the time since the given mark to the band that an event came from.
+*/
+static inline void _sched_charge_band(SchedBand* band, uint32_t mark) {
+  const uint32_t now = micros();
+  const uint32_t us  = wrap_accounted_delta(mark, now);
+  band->spent_us   += us;
+  band->total_us   += us;
+  band->last_served = now;
+  band->events++;
+}
+
+
 /**
 * Process any open events.
 *
@@ -652,7 +929,8 @@ void Kernel::_idle(bool nu) {
 *     call. We don't want to cause bad re-entrancy problem in the Kernel by spending
 *     all of our time here (although we might re-work the Kernel to make this acceptable).
 *
-* @return the number of events processed, or a negative value on some failure.
+* @return the number of events processed (at most 127), or a negative value on
+*           some failure.
 */
 int8_t Kernel::procIdleFlags() {
   uint32_t profiler_mark   = micros();
@@ -660,18 +938,16 @@ int8_t Kernel::procIdleFlags() {
   uint32_t profiler_mark_1 = 0;   // Profiling requests...
   uint32_t profiler_mark_2 = 0;   // Profiling requests...
   uint32_t profiler_mark_3 = 0;   // Profiling requests...
-  int8_t   return_value    = 0;   // Number of Events we've processed this call.
+  int      return_value    = 0;   // Number of Events we've processed this call.
   uint16_t msg_code_local  = 0;
 
   serviceSchedules();
 
   ManuvrMsg *active_runnable = nullptr;  // Our short-term focus.
-  uint8_t activity_count    = 0;     // Incremented whenever a subscriber reacts to an event.
-
-  globalIRQDisable();
-  while (isr_exec_queue.size() > 0) {
-    active_runnable = isr_exec_queue.dequeue();
+  SchedBand *active_band     = nullptr;  // The band it was taken from.
 
+  // Nothing here needs interrupts masked. Producers never touch what we take.
+  while (nullptr != (active_runnable = isr_exec_queue.dequeue())) {
     switch (validate_insertion(active_runnable)) {
       case 0:    // Clear for insertion.
         break;
@@ -685,23 +961,34 @@ int8_t Kernel::procIdleFlags() {
         break;
     }
   }
-  globalIRQEnable();
+
+  #if defined(__BUILD_HAS_PTHREADS)
+    // Finish off anything the worker pool has delivered since last time.
+    if (nullptr != _workers) return_value += _retire_dispatched();
+  #endif
 
   active_runnable = nullptr;   // Pedantic...
+  _sched_loop_begin(profiler_mark);
 
-  /* As long as we have an open event and we aren't yet at our proc ceiling... */
-  while (exec_queue.hasNext() && should_run_another_event(return_value, profiler_mark)) {
+  /* As long as the scheduling policy has something for us to run... */
+  while (nullptr != (active_runnable = _next_runnable(return_value, profiler_mark, &active_band))) {
     if (idle()) {
       platform.wakeHook();
       _idle(false);
     }
-    active_runnable = exec_queue.dequeue();       // Grab the Event and remove it in the same call.
     msg_code_local = active_runnable->eventCode();  // This gets used after the life of the event.
+    active_runnable->deadline(0);   // Like the raise stamp, only good for one trip.
+    uint8_t activity_count = 0;     // Incremented whenever a subscriber reacts to an event.
 
     current_event = active_runnable;
 
     // Chat and measure.
     profiler_mark_0 = micros();
+    #if defined(MANUVR_EVENT_PROFILER)
+      // The stamp must not outlive this trip through the queue.
+      uint32_t raised_at = active_runnable->raisedAt();
+      active_runnable->raisedAt(0);
+    #endif  //MANUVR_EVENT_PROFILER
 
     procCallAheads(active_runnable);
 
@@ -713,10 +1000,40 @@ int8_t Kernel::procIdleFlags() {
       activity_count += active_runnable->execute();
     }
     else {
-      for (int i = 0; i < subscribers.size(); i++) {
-        subscriber = subscribers.get(i);
-
-        switch (subscriber->notify(active_runnable)) {
+      // Only the subscribers that want this code get notified.
+      DispatchList* dl = _dispatch_list(msg_code_local);
+      notify_calls   += dl->count;
+      notify_avoided += subscribers.size() - dl->count;
+      #if defined(__BUILD_HAS_PTHREADS)
+        // Parallel-safe subscribers to a parallel-safe event are left to the pool.
+        const bool pooled  = ((nullptr != _workers) && (0 < _workers->threads()));
+        const bool fan_out = (pooled && active_runnable->isParallelSafe());
+        EventReceiver** parallel = _fan_out;   // Never shorter than dl.
+        int parallel_count = 0;
+      #endif
+      for (int i = 0; i < dl->count; i++) {
+        subscriber = dl->list[i];
+
+        #if defined(__BUILD_HAS_PTHREADS)
+          if (pooled && subscriber->parallelSafe()) {
+            if (fan_out) {
+              parallel[parallel_count++] = subscriber;
+              continue;
+            }
+            // It may still be working through earlier events in the pool.
+            _workers->drain(subscriber);
+          }
+        #endif
+        int8_t rx_ret = 0;
+        if (_timed_receiver(subscriber)) {
+          const uint32_t rx_mark = micros();
+          rx_ret = subscriber->notify(active_runnable);
+          _charge_receiver(subscriber, wrap_accounted_delta(rx_mark, micros()));
+        }
+        else {
+          rx_ret = subscriber->notify(active_runnable);
+        }
+        switch (rx_ret) {
           case -1:  // The subscriber choked. Figure out why. Technically, this is action. Case fall-through...
             subscriber->printDebug(&local_log);
           default:   // The subscriber acted.
@@ -725,6 +1042,30 @@ int8_t Kernel::procIdleFlags() {
             break;
         }
       }
+
+      #if defined(__BUILD_HAS_PTHREADS)
+        if (0 < parallel_count) {
+          // Marked before the workers can see it, since they may raise it again.
+          active_runnable->isDispatched(true);
+          if (0 < _workers->dispatch(active_runnable, parallel, parallel_count, activity_count)) {
+            // The event is in flight. It will be retired by _retire_dispatched().
+            _sched_charge_band(active_band, profiler_mark_0);
+            return_value++;
+            continue;
+          }
+          active_runnable->isDispatched(false);
+          for (int i = 0; i < parallel_count; i++) {
+            if (_timed_receiver(parallel[i])) {
+              const uint32_t rx_mark = micros();
+              if (0 != parallel[i]->notify(active_runnable)) activity_count++;
+              _charge_receiver(parallel[i], wrap_accounted_delta(rx_mark, micros()));
+            }
+            else if (0 != parallel[i]->notify(active_runnable)) {
+              activity_count++;
+            }
+          }
+        }
+      #endif
     }
     if (_profiler_enabled()) profiler_mark_2 = micros();
 
@@ -734,94 +1075,21 @@ int8_t Kernel::procIdleFlags() {
       active_runnable->noteExecutionTime(profiler_mark_0, micros());
     #endif  //MANUVR_EVENT_PROFILER
 
-    if (0 == activity_count) {
-      #ifdef MANUVR_DEBUG
-      if (getVerbosity() >= 3) local_log.concatf("\tDead event: %s\n", active_runnable->getMsgTypeString());
-      #endif
-      total_events_dead++;
-    }
-
-    /* Should we clean up the Event? */
-    bool clean_up_active_runnable = true;  // Defaults to 'yes'.
-    int8_t vi_res = 0;
-
-    switch (active_runnable->callbackOriginator()) {
-      case EVENT_CALLBACK_RETURN_RECYCLE:     // The originating class wants us to re-insert the event.
-        #ifdef MANUVR_DEBUG
-        if (getVerbosity() > 6) local_log.concatf("Recycling %s.\n", active_runnable->getMsgTypeString());
-        #endif
-        vi_res = validate_insertion(active_runnable);
-        switch (vi_res) {
-          case -1:   // NULL runnable! How?!?!
-          case -2:   // UNDEFINED event. This shall not stand, man....
-            #ifdef MANUVR_DEBUG
-              if (getVerbosity() >= 2) local_log.concatf("%s event returned RECYCLE?\n", ((-1 == vi_res) ? "Null" : "UNDEFINED"));
-            #endif
-            break;
-          case -3:   // Pointer idempotency. THIS EXACT runnable is already enqueue.
-            #ifdef MANUVR_DEBUG
-              if (getVerbosity() >= 5) {
-                local_log.concat("THIS EXACT runnable is already enqueue.\n");
-              }
-            #endif
-          case 0:    // Insertion succeeded.
-            clean_up_active_runnable = false;
-            break;
-        }
-        break;
-      case EVENT_CALLBACK_RETURN_ERROR:       // Something went wrong. Should never occur.
-      case EVENT_CALLBACK_RETURN_UNDEFINED:   // The originating class doesn't care what we do with the event.
-        //if (verbosity > 1) local_log.concatf("Kernel found a possible mistake. Unexpected return case from callback_proc.\n");
-        // NOTE: No break;
-      case EVENT_CALLBACK_RETURN_DROP:        // The originating class expects us to drop the event.
-        #ifdef MANUVR_DEBUG
-        //if (getVerbosity() > 6) local_log.concatf("Dropping %s after running.\n", active_runnable->getMsgTypeString());
-        #endif
-        // NOTE: No break;
-      case EVENT_CALLBACK_RETURN_REAP:        // The originating class is explicitly telling us to reap the event.
-        // NOTE: No break;
-      default:
-        //if (verbosity > 0) local_log.concatf("Event %s has no cleanup case.\n", active_runnable->getMsgTypeString());
-        break;
-    }
-
-    // All of the logic above ultimately informs this choice.
-    if (clean_up_active_runnable) {
-      reclaim_event(active_runnable);
-    }
-
-    total_events++;
+    _retire_event(active_runnable, activity_count);
+    _sched_charge_band(active_band, profiler_mark_0);
 
     #if defined(MANUVR_EVENT_PROFILER)
       // This is a stat-gathering block.
       if (_profiler_enabled()) {
         profiler_mark_3 = micros();
 
-        TaskProfilerData* profiler_item = nullptr;
-        int cost_size = event_costs.size();
-        int i = 0;
-        while ((nullptr == profiler_item) && (i < cost_size)) {
-          if (event_costs.get(i)->msg_code == msg_code_local) {
-            profiler_item = event_costs.get(i);
+        TaskProfilerData* profiler_item = event_costs.profile(msg_code_local);
+        if (nullptr != profiler_item) {
+          profiler_item->noteRunTime(wrap_accounted_delta(profiler_mark_2, profiler_mark_1));
+          if (0 != raised_at) {
+            profiler_item->noteWaitTime(wrap_accounted_delta(profiler_mark_0, raised_at));
           }
-          i++;
-        }
-        if (nullptr == profiler_item) {
-          // If we don't yet have a profiler item for this message type...
-          profiler_item = new TaskProfilerData();    // ...create one...
-          profiler_item->msg_code = msg_code_local;   // ...assign the code...
-          event_costs.insert(profiler_item, 1);       // ...and insert it for the future.
-        }
-        else {
-          // If we already have a profiler item for this code...
-          event_costs.incrementPriority(profiler_item);
         }
-        profiler_item->executions++;
-        profiler_item->run_time_last    = wrap_accounted_delta(profiler_mark_2, profiler_mark_1);
-        profiler_item->run_time_best    = strict_min(profiler_item->run_time_last, profiler_item->run_time_best);
-        profiler_item->run_time_worst   = strict_max(profiler_item->run_time_last, profiler_item->run_time_worst);
-        profiler_item->run_time_total  += profiler_item->run_time_last;
-        profiler_item->run_time_average = profiler_item->run_time_total / ((profiler_item->executions) ? profiler_item->executions : 1);
 
         profiler_mark_2 = 0;  // Reset for next iteration.
       }
@@ -845,6 +1113,7 @@ int8_t Kernel::procIdleFlags() {
     _pending_pipes(false);
   }
 
+  if (_sched_yield()) _sched_yields++;
   total_loops++;
   current_event = nullptr;
   profiler_mark_3 = micros();
@@ -855,8 +1124,8 @@ int8_t Kernel::procIdleFlags() {
     // We ran at-least one Msg.
     micros_occupied += runtime_this_loop;
     consequtive_idles = max_idle_count;  // Reset the idle loop down-counter.
-    if (max_events_p_loop < (uint8_t) return_value) {
-      max_events_p_loop = (uint8_t) return_value;
+    if (max_events_p_loop < (uint32_t) return_value) {
+      max_events_p_loop = (uint32_t) return_value;
     }
   }
   else if (0 == return_value) {
@@ -889,7 +1158,212 @@ int8_t Kernel::procIdleFlags() {
   else {
     // there was a problem. Do nothing.
   }
-  return return_value;
+  // With no event limit, a loop can run more than fits in our return type.
+  return (int8_t) strict_min((int32_t) return_value, (int32_t) INT8_MAX);
+}
+
+
+
+/*******************************************************************************
+* Scheduling policy                                                            *
+*******************************************************************************/
+
+/**
+* Which band does the given priority fall in?
+*
+* @param  priority  A Msg priority.
+* @return the band's index.
+*/
+uint8_t Kernel::schedBand(uint8_t priority) {
+  uint8_t b = KERNEL_SCHED_BANDS - 1;
+  while ((b > 0) && (priority < _sched_band_floors[b])) b--;
+  return b;
+}
+
+
+/**
+* Sets how much of each loop (in uS) the given band may spend.
+*
+* @param  band  The band's index.
+* @param  us    The budget. Zero means the band only runs when nothing else
+*                 wants to, or when it is starving, or when a Msg is nearly due.
+* @return 0 on success, -1 if there is no such band.
+*/
+int8_t Kernel::bandBudget(uint8_t band, uint32_t us) {
+  if (band >= KERNEL_SCHED_BANDS) return -1;
+  _bands[band].budget_us = us;
+  _bands[band].spent_us  = 0;   // Forgive any debt run up under the old budget.
+  return 0;
+}
+
+
+/**
+* @param  band  The band's index.
+* @return the band's budget, or zero if there is no such band.
+*/
+uint32_t Kernel::bandBudget(uint8_t band) {
+  return (band < KERNEL_SCHED_BANDS) ? _bands[band].budget_us : 0;
+}
+
+
+/*
+* Called once at the top of every loop. Pays down each band's debt by one
+*   loop's worth of budget.
+*/
+void Kernel::_sched_loop_begin(uint32_t now) {
+  const bool empty = !exec_queue.hasNext();
+  _sched_yield(false);
+  _sched_overtime = 0;
+  for (int b = 0; b < KERNEL_SCHED_BANDS; b++) {
+    SchedBand* band = &_bands[b];
+    if (_sched_deferred & (1 << b)) band->deferrals++;
+    band->spent_us = (band->spent_us > band->budget_us) ? (band->spent_us - band->budget_us) : 0;
+    if (empty) band->last_served = now;   // Waiting for nothing isn't starving.
+  }
+  _sched_deferred = 0;
+}
+
+
+/*
+* Decides what to run next, and takes it from the exec_queue. In order of
+*   precedence...
+*   1) Nothing, if a receiver has gone over its budget.
+*   2) A band with work that hasn't run in longer than the aging limit.
+*   3) A higher band that is over budget, but whose next Msg is nearly due.
+*   4) The highest band with work and budget to spare.
+*   5) The highest band with work. Budgets only matter when bands compete.
+* Once the loop has used up its event count or its time, only the highest band
+*   with a Msg nearly due still runs, budget or not. That can happen at most
+*   KERNEL_SCHED_FORCED_PER_LOOP times, so that a stream of deadlines can't
+*   hold the loop open.
+*
+* @param  ran         How many events this loop has run.
+* @param  loop_start  When (micros()) the loop started.
+* @param  band        The band the Msg was taken from is returned here.
+* @return the Msg to run, or nullptr if the loop should end.
+*/
+ManuvrMsg* Kernel::_next_runnable(int ran, uint32_t loop_start, SchedBand** band) {
+  if (!exec_queue.hasNext() || _sched_yield()) return nullptr;
+
+  const uint32_t now        = micros();
+  const bool     loop_spent = ((0 < max_events_per_loop) && (ran >= max_events_per_loop))
+                              || ((0 < ran) && (wrap_accounted_delta(loop_start, now) >= _sched_loop_us));
+  int      with_budget = -1;  // The highest band with work and budget.
+  int      with_work   = -1;  // The highest band with work.
+  int      starving    = -1;  // The band that has waited longest past the aging limit.
+  int      due         = -1;  // The highest band with a Msg nearly due.
+  uint8_t  over        = 0;   // Over-budget bands with work.
+  uint32_t longest     = _sched_aging_us;
+
+  for (int b = KERNEL_SCHED_BANDS - 1; b >= 0; b--) {
+    SchedBand* sb   = &_bands[b];
+    ManuvrMsg* head = exec_queue.get(sb->floor, sb->ceiling);
+    if (nullptr == head) {
+      sb->last_served = now;
+      continue;
+    }
+    if (0 > with_work) with_work = b;
+    const uint32_t waited = wrap_accounted_delta(sb->last_served, now);
+    if ((0 < _sched_aging_us) && (waited >= longest)) {
+      longest  = waited;
+      starving = b;
+    }
+    if (sb->spent_us < sb->budget_us) {
+      if (0 > with_budget) with_budget = b;
+    }
+    else {
+      over |= (1 << b);
+    }
+    // The head of a band is its most urgent Msg, so that is all we check.
+    const uint32_t deadline = head->deadline();
+    if ((0 > due) && (0 != deadline) && ((int32_t) (deadline - now) <= (int32_t) _sched_slack_us)) {
+      due = b;
+    }
+  }
+
+  int pick = -1;
+  if (!loop_spent) {
+    pick = (0 <= with_budget) ? with_budget : with_work;
+    if ((0 <= starving) && (starving != pick)) {
+      pick = starving;
+      _bands[pick].aged++;
+    }
+    if ((0 <= due) && (due > pick) && (starving != pick)) {
+      pick = due;
+      _bands[pick].forced++;
+    }
+  }
+  else if ((0 <= due) && (_sched_overtime < KERNEL_SCHED_FORCED_PER_LOOP)) {
+    pick = due;
+    _bands[pick].forced++;
+    _sched_overtime++;
+  }
+
+  _sched_deferred |= over;
+  if (0 > pick) return nullptr;
+  _sched_deferred &= ~(1 << pick);
+  *band = &_bands[pick];
+  return exec_queue.dequeue(_bands[pick].floor, _bands[pick].ceiling);
+}
+
+
+/*
+* Charges a receiver for a notify() call, and asks the loop to end early if
+*   that put it over its budget. Only receivers with a budget are timed, unless
+*   the profiler is running.
+*/
+void Kernel::_charge_receiver(EventReceiver* er, uint32_t us) {
+  if (er->_sched_loop != total_loops) {
+    er->_sched_loop    = total_loops;
+    er->_sched_loop_us = 0;
+  }
+  const uint32_t before = er->_sched_loop_us;
+  er->_sched_loop_us  += us;
+  er->_sched_total_us += us;
+  er->_sched_calls++;
+  if (er->_sched_loop_us > er->_sched_loop_max_us) {
+    er->_sched_loop_max_us = er->_sched_loop_us;
+  }
+  if ((0 < er->_sched_budget_us) && (er->_sched_loop_us > er->_sched_budget_us)) {
+    if (before <= er->_sched_budget_us) er->_sched_overruns++;
+    _sched_yield(true);
+  }
+}
+
+
+/**
+* Prints the scheduling policy, what each band has been doing, and the time
+*   each subscriber has spent in notify(). Subscribers are only timed while
+*   they have a budget, or while the profiler is running.
+*
+* @param   StringBuilder*  The buffer that this fxn will write output into.
+*/
+void Kernel::printSchedPolicy(StringBuilder* output) {
+  output->concat("-- Scheduling policy\n");
+  output->concatf("   Events per loop:   %d%s\n", max_events_per_loop, (max_events_per_loop ? "" : " (unlimited)"));
+  output->concatf("   Loop budget:       %u us\n", (unsigned long) _sched_loop_us);
+  output->concatf("   Aging limit:       %u us%s\n", (unsigned long) _sched_aging_us, (_sched_aging_us ? "" : " (disabled)"));
+  output->concatf("   Deadline slack:    %u us\n", (unsigned long) _sched_slack_us);
+  output->concatf("   Yields:            %u\n", (unsigned long) _sched_yields);
+  output->concat("\n\t Band        Pri       Budget  Debt     Events     Total us   Deferred  Aged    Forced\n\t ---------------------------------------------------------------------------------------\n");
+  for (int b = KERNEL_SCHED_BANDS - 1; b >= 0; b--) {
+    SchedBand* sb = &_bands[b];
+    output->concatf("\t %d %-10s%3u-%-3u   %-7u %-7u  %-9u  %-10u %-9u %-7u %u\n",
+      b, _sched_band_names[b], sb->floor, sb->ceiling,
+      (unsigned long) sb->budget_us,
+      (unsigned long) ((sb->spent_us > sb->budget_us) ? (sb->spent_us - sb->budget_us) : 0),
+      (unsigned long) sb->events, (unsigned long) sb->total_us,
+      (unsigned long) sb->deferrals, (unsigned long) sb->aged, (unsigned long) sb->forced
+    );
+  }
+  output->concat("\n\t Receiver                 Budget  Calls      Total us   Worst loop  Overruns\n\t ---------------------------------------------------------------------------\n");
+  for (EventReceiver* er : subscribers) {
+    output->concatf("\t %-24s %-7u %-10u %-10u %-11u %u\n",
+      er->getReceiverName(), (unsigned long) er->_sched_budget_us,
+      (unsigned long) er->_sched_calls, (unsigned long) er->_sched_total_us,
+      (unsigned long) er->_sched_loop_max_us, (unsigned long) er->_sched_overruns
+    );
+  }
 }
 
 
@@ -921,7 +1395,7 @@ void Kernel::profiler(bool enabled) {
   insertion_denials  = 0;
 
   #if defined(MANUVR_EVENT_PROFILER)
-    while (event_costs.hasNext()) delete event_costs.dequeue();
+    event_costs.clear();
   #endif   // MANUVR_EVENT_PROFILER
 }
 
@@ -952,6 +1426,7 @@ void Kernel::printProfiler(StringBuilder* output) {
     if (total_events) {
       output->concatf("\t Hits:     \t%.3f\%\n", (double)(1-(_msg_prealloc.starves() / total_events)) * 100);
     }
+    Argument::printPool(output);
   }
 
   output->concatf("-- total_events       \t%u\n", (unsigned long) total_events);
@@ -961,6 +1436,11 @@ void Kernel::printProfiler(StringBuilder* output) {
   output->concatf("-- max_idle_loop_time \t%u\n", (unsigned long) max_idle_loop_time);
   output->concatf("-- max_events_p_loop  \t%u\n", (unsigned long) max_events_p_loop);
   output->concatf("-- Pending pipes:     \t%d\n", _pipe_io_pend.size());
+  output->concatf("-- notify() calls     \t%u\n", (unsigned long) notify_calls);
+  output->concatf("-- notify() avoided   \t%u\n", (unsigned long) notify_avoided);
+  #if defined(__BUILD_HAS_PTHREADS)
+    if (nullptr != _workers) _workers->printDebug(output);
+  #endif
 
   if (_profiler_enabled()) {
     output->concat("-- Profiler:\n");
@@ -968,17 +1448,7 @@ void Kernel::printProfiler(StringBuilder* output) {
     output->concatf("   Kernel duty cycle: %.3f\n", dutyCycle());
 
     #if defined(MANUVR_EVENT_PROFILER)
-      TaskProfilerData *profiler_item;
-      int stat_mode = event_costs.getPriority(0);
-      int x = event_costs.size();
-
-      TaskProfilerData::printDebugHeader(output);
-      for (int i = 0; i < x; i++) {
-        profiler_item = event_costs.get(i);
-        stat_mode     = event_costs.getPriority(i);
-        output->concatf("\t (%10d)\t", stat_mode);
-        profiler_item->printDebug(output);
-      }
+      event_costs.printDebug(output);
     #endif   // MANUVR_EVENT_PROFILER
   }
   else {
@@ -1002,6 +1472,26 @@ void Kernel::printProfiler(StringBuilder* output) {
 }
 
 
+/**
+* Writes the per-code profile in a tab-separated form meant for scripts
+*   rather than people. One header line, then one line per message code. All
+*   times are in microseconds. Run time is spent notifying subscribers. Wait
+*   time is from raise to dispatch.
+*
+* @param   StringBuilder*  The buffer that this fxn will write output into.
+* @param   bool            If true, each code's histograms follow its line as
+*                            "<upper bound>:<count>" pairs.
+*/
+void Kernel::dumpProfiler(StringBuilder* output, bool buckets) {
+  if (nullptr == output) return;
+  #if defined(MANUVR_EVENT_PROFILER)
+    event_costs.dump(output, buckets);
+  #else
+    output->concat("#Kernel profiler not built.\n");
+  #endif   // MANUVR_EVENT_PROFILER
+}
+
+
 /**
 * Debug support method. This fxn is only present in debug builds.
 *
@@ -1011,6 +1501,13 @@ void Kernel::printScheduler(StringBuilder* output) {
   output->concat("-- SCHEDULER\n");
   output->concatf("-- _ms_elapsed         %u\n", (unsigned long) _ms_elapsed);
   output->concatf("-- Total schedules:    %d\n-- Active schedules:   %d\n\n", schedules.size(), countActiveSchedules());
+  output->concatf("-- Wheel clock:        %u\n", (unsigned long) sched_wheel.now());
+  output->concatf("-- Wheel occupancy:    %d", sched_wheel.size());
+  for (int l = 0; l < TIMER_WHEEL_LEVELS; l++) {
+    output->concatf("%s%d", ((0 == l) ? "  (" : " / "), sched_wheel.occupancy(l));
+  }
+  output->concatf(")  %d expired\n", sched_wheel.expired());
+  output->concatf("-- Lag (last/worst):   %u / %u ms\n", (unsigned long) _sched_lag_last, (unsigned long) _sched_lag_max);
   if (lagged_schedules)    output->concatf("-- Lagged schedules:   %u\n", (unsigned long) lagged_schedules);
   if (_skips_observed)     output->concatf("-- Scheduler skips:    %u\n", (unsigned long) _skips_observed);
   if (_er_flag(MKERNEL_FLAG_SKIP_FAILSAFE)) {
@@ -1037,8 +1534,9 @@ void Kernel::printDebug(StringBuilder* output) {
   //output->concatf("-- our_mem_addr:             %p\n", this);
   if (subscribers.size() > 0) {
     output->concatf("-- Subscribers: (%d total):\n", subscribers.size());
-    for (int i = 0; i < subscribers.size(); i++) {
-      output->concatf("\t %d: %s\n", i, subscribers.get(i)->getReceiverName());
+    int i = 0;
+    for (EventReceiver* subscriber : subscribers) {
+      output->concatf("\t %d: %s%s\n", i++, subscriber->getReceiverName(), (subscriber->msgInterest() ? " (filtered)" : ""));
     }
     output->concat("\n");
   }
@@ -1227,6 +1725,7 @@ ManuvrMsg* Kernel::createSchedule(uint32_t sch_period, int16_t recurrence, bool
         return_value->isScheduled(true);
         return_value->incRefs();
         schedules.insert(return_value);
+        _refile_schedule(return_value);
       }
     }
   }
@@ -1248,6 +1747,7 @@ ManuvrMsg* Kernel::createSchedule(uint32_t sch_period, int16_t recurrence, bool
       return_value->isScheduled(true);
       return_value->incRefs();
       schedules.insert(return_value);
+      _refile_schedule(return_value);
     }
   }
   return return_value;
@@ -1294,6 +1794,7 @@ bool Kernel::removeSchedule(ManuvrMsg* obj) {
     if (obj != current_event) {
       obj->isScheduled(false);
       obj->decRefs();
+      sched_wheel.remove(obj);
       schedules.remove(obj);
       reclaim_event(obj);
     }
@@ -1312,6 +1813,7 @@ bool Kernel::addSchedule(ManuvrMsg* obj) {
       obj->isScheduled(true);
       obj->incRefs();
       schedules.insert(obj);
+      _refile_schedule(obj);
     }
     return true;
   }
@@ -1319,11 +1821,44 @@ bool Kernel::addSchedule(ManuvrMsg* obj) {
 }
 
 
+/**
+* Files the given schedule in the wheel according to its present state, or
+*   takes it out if it has nothing left to wait for.
+*
+* @param  A pointer to the schedule item to be filed.
+*/
+void Kernel::_refile_schedule(ManuvrMsg* obj) {
+  if (obj->shouldFire()) {
+    sched_wheel.insert(obj, 0);    // Next tick.
+  }
+  else if (obj->scheduleEnabled()) {
+    sched_wheel.insert(obj, obj->scheduleTTW());
+  }
+  else {
+    sched_wheel.remove(obj);
+  }
+}
+
+
+/**
+* ManuvrMsg calls this when a schedule's timing has been changed, so that the
+*   wheel can be kept in agreement. Msgs that aren't scheduled are ignored.
+*
+* @param  A pointer to the schedule item that changed.
+*/
+void Kernel::refileSchedule(ManuvrMsg* obj) {
+  if ((nullptr != INSTANCE) && obj->isScheduled()) {
+    INSTANCE->_refile_schedule(obj);
+  }
+}
+
+
 /**
 * This is the function that is called from the main loop to offload big
 *  tasks into idle CPU time. If many scheduled items have fired, function
 *  will churn through all of them. The presumption is that they are
 *  latency-sensitive.
+* Only schedules that have come due are visited.
 */
 int Kernel::serviceSchedules() {
   if (!platform.booted() || (0 == _ms_elapsed)) return -1;
@@ -1331,21 +1866,23 @@ int Kernel::serviceSchedules() {
   uint32_t mse = _ms_elapsed;  // Concurrency....
   _ms_elapsed = 0;
 
-  int x = schedules.size();
-  ManuvrMsg *current;
+  sched_wheel.advance(mse);
+  ManuvrMsg *current = sched_wheel.dequeueExpired();
+
+  while (current) {
+    _sched_lag_last = sched_wheel.overdue(current);
+    if (_sched_lag_last > _sched_lag_max) _sched_lag_max = _sched_lag_last;
 
-  for (int i = 0; i < x; i++) {
-    current = schedules.recycle();
     if (current->scheduleEnabled()) {
-      switch (current->applyTime(mse)) {
+      switch (current->applyTime(_sched_lag_last)) {
         case 1:   // Schedule should be exec'd and retained.
           Kernel::staticRaiseEvent(current);
+          _refile_schedule(current);
           break;
         case -1:  // Schedule should be dropped and executed.
           Kernel::staticRaiseEvent(current);
         case -2:  // Schedule should be dropped without execution.
           removeSchedule(current);
-          x--;
           break;
         case 0:   // Nominal outcome. No action.
         default:  // Nonsense.
@@ -1357,6 +1894,8 @@ int Kernel::serviceSchedules() {
       current->shouldFire(false);    // Mark it as serviced.
       Kernel::staticRaiseEvent(current);
     }
+    return_value++;
+    current = sched_wheel.dequeueExpired();
   }
 
   // We just ran a loop. Punch the bistable swtich.
@@ -1386,6 +1925,12 @@ static const ConsoleCommand console_cmds[] = {
   { "i5", "Scheduler" },
   { "i6", "Supported notions of identity" },
   { "i7", "Our Identity" },
+  { "i8", "Scheduling policy" },
+  { "k", "Band budget: k <band> <us>" },
+  { "l", "Loop budget (us)" },
+  { "e", "Events per loop (0 for time only)" },
+  { "a", "Aging limit (us, 0 to disable)" },
+  { "d", "Deadline slack (us)" },
   #if defined(__HAS_CRYPT_WRAPPER)
     { "c", "Cryptoburrito" },
   #endif //__HAS_CRYPT_WRAPPER
@@ -1410,6 +1955,7 @@ void Kernel::consoleCmdProc(StringBuilder* input) {
   const char* str = (char *) input->position(0);
   char c    = *str;
   int temp_int = 0;
+  bool has_arg = ((input->count() > 1) || (strlen(str) > 1));
 
   if (input->count() > 1) {
     // If there is a second token, we proceed on good-faith that it's an int.
@@ -1436,6 +1982,29 @@ void Kernel::consoleCmdProc(StringBuilder* input) {
       profiler('P' == c);
       break;
 
+    case 'k':    // Band budgets.
+      if (input->count() > 2) {
+        if (0 != bandBudget((uint8_t) temp_int, (uint32_t) input->position_as_int(2))) {
+          local_log.concatf("There is no band %d.\n", temp_int);
+        }
+      }
+      printSchedPolicy(&local_log);
+      break;
+    case 'l':    // The rest of the scheduling policy.
+    case 'e':
+    case 'a':
+    case 'd':
+      if (has_arg && (0 <= temp_int)) {
+        switch (c) {
+          case 'l':  loopBudget((uint32_t) temp_int);       break;
+          case 'e':  maxEventsPerLoop((int8_t) temp_int);   break;
+          case 'a':  agingLimit((uint32_t) temp_int);       break;
+          case 'd':  deadlineSlack((uint32_t) temp_int);    break;
+        }
+      }
+      printSchedPolicy(&local_log);
+      break;
+
     case 'y':    // Power mode.
       {
         ManuvrMsg* event = returnEvent(MANUVR_MSG_SYS_POWER_MODE);
@@ -1481,6 +2050,10 @@ void Kernel::consoleCmdProc(StringBuilder* input) {
           platform.printDebug(&local_log);
           break;
 
+        case 4:
+          dumpProfiler(&local_log, true);
+          break;
+
         case 5:
           printScheduler(&local_log);
           break;
@@ -1498,6 +2071,10 @@ void Kernel::consoleCmdProc(StringBuilder* input) {
           Identity::staticToString(platform.selfIdentity(), &local_log);
           break;
 
+        case 8:
+          printSchedPolicy(&local_log);
+          break;
+
         default:
           printDebug(&local_log);
           break;
@@ -36,6 +36,9 @@ limitations under the License.
   #include "Utilities.h"
   #include "EnumeratedTypeCodes.h"
   #include "DataStructures/PriorityQueue.h"
+  #include "DataStructures/RunQueue.h"
+  #include "DataStructures/TimerWheel.h"
+  #include "DataStructures/MPSCQueue.h"
   #include "DataStructures/ElementPool.h"
   #include "DataStructures/StringBuilder.h"
   #include "EventReceiver.h"
@@ -52,6 +55,19 @@ limitations under the License.
   #define MKERNEL_FLAG_SKIP_FAILSAFE 0x04    // Too many skips will send us to the bootloader.
   #define MKERNEL_FLAG_PENDING_PIPE  0x08    // There is Pipe I/O pending.
   #define MKERNEL_FLAG_IDLE          0x10    // The kernel is idle.
+  #define MKERNEL_FLAG_SCHED_YIELD   0x20    // A receiver went over budget. End this loop.
+
+  /*
+  * Scheduling policy defaults. The exec_queue's priorities are split into
+  *   bands, and each band may spend only so much of each loop. A band that
+  *   goes over carries the debt into later loops, and defers to the others
+  *   until it is paid. Bands with nothing to defer to run regardless.
+  */
+  #define KERNEL_SCHED_BANDS              4
+  #define KERNEL_SCHED_LOOP_BUDGET_US     1200   // How long a single loop may run events.
+  #define KERNEL_SCHED_AGING_US           20000  // A band waiting this long is served out of turn.
+  #define KERNEL_SCHED_DEADLINE_SLACK_US  250    // Msgs this close to due are run despite budgets.
+  #define KERNEL_SCHED_FORCED_PER_LOOP    4      // How many nearly-due Msgs a spent loop may still run.
 
 
   #ifdef __cplusplus
@@ -60,6 +76,35 @@ limitations under the License.
 
   extern unsigned long micros();  // Prevents circular-inclusion with Platform.h
 
+  class EventWorkerPool;
+
+  /*
+  * The subscribers that want a given message code, in subscription order.
+  * Built on demand, and rebuilt when the generation goes stale.
+  */
+  typedef struct {
+    EventReceiver** list;
+    uint16_t        count;
+    uint16_t        capacity;
+    uint32_t        generation;
+  } DispatchList;
+
+  /*
+  * One band of the Kernel's scheduling policy, and what it has been up to.
+  */
+  typedef struct {
+    uint32_t budget_us;    // How much of each loop the band may spend.
+    uint32_t spent_us;     // Spent in this loop, plus any debt from earlier ones.
+    uint32_t last_served;  // When (micros()) the band last ran, or was last seen empty.
+    uint32_t events;       // Events run.
+    uint32_t total_us;     // Time spent running them.
+    uint32_t deferrals;    // Loops in which the band waited for want of budget.
+    uint32_t aged;         // Events run out of turn because the band was starving.
+    uint32_t forced;       // Events run over budget because they were nearly due.
+    uint8_t  floor;        // The lowest priority in the band.
+    uint8_t  ceiling;      // The highest priority in the band.
+  } SchedBand;
+
 
   /****************************************************************************************************
   *  ___ ___   ____  ____   __ __  __ __  ____       __  _    ___  ____   ____     ___  _
@@ -97,6 +142,7 @@ limitations under the License.
       EventReceiver* getSubscriberByName(const char*);
       int8_t subscribe(EventReceiver *client);                    // A class calls this to subscribe to events.
       int8_t subscribe(EventReceiver *client, uint8_t priority);  // A class calls this to subscribe to events.
+      int8_t subscribe(EventReceiver *client, uint8_t priority, const uint16_t* codes);  // ...to only some events.
       int8_t unsubscribe(EventReceiver *client);                  // A class calls this to unsubscribe.
       inline EventReceiver* getSubscriber(int i) {                // Fetch a subscriber by index.
         return subscribers.get(i);
@@ -146,13 +192,31 @@ limitations under the License.
 
       void profiler(bool enabled);
       void printProfiler(StringBuilder*);
+      void dumpProfiler(StringBuilder*, bool buckets);  // Machine-readable form of the per-code profile.
 
-      inline void maxEventsPerLoop(int8_t nu) { max_events_per_loop = (nu > 0) ? nu : 1; }
+      /* Scheduling policy. Zero events per loop leaves the loop limited only by time. */
+      inline void maxEventsPerLoop(int8_t nu) { max_events_per_loop = (nu > 0) ? nu : 0; }
       inline int8_t maxEventsPerLoop() {        return max_events_per_loop; }
+      inline void loopBudget(uint32_t us) {     _sched_loop_us = (us > 0) ? us : 1;  };
+      inline uint32_t loopBudget() {            return _sched_loop_us;               };
+      inline void agingLimit(uint32_t us) {     _sched_aging_us = us;                };
+      inline uint32_t agingLimit() {            return _sched_aging_us;              };
+      inline void deadlineSlack(uint32_t us) {  _sched_slack_us = us;                };
+      inline uint32_t deadlineSlack() {         return _sched_slack_us;              };
+      int8_t   bandBudget(uint8_t band, uint32_t us);
+      uint32_t bandBudget(uint8_t band);
+      static uint8_t schedBand(uint8_t priority);  // Which band does the given priority fall in?
+      void printSchedPolicy(StringBuilder*);
       inline int queueSize() {                  return INSTANCE->exec_queue.size();     }
       inline bool containsPreformedEvent(ManuvrMsg* event) {   return exec_queue.contains(event);  };
       inline bool idle() {                     return (_er_flag(MKERNEL_FLAG_IDLE));              };
 
+      #if defined(__BUILD_HAS_PTHREADS)
+        /* Parallel notification of parallel-safe receivers. Zero threads disables. */
+        int8_t  workerThreads(uint8_t);
+        uint8_t workerThreads();
+      #endif
+
       /* Overrides from EventReceiver
          Just gracefully fall into those when needed. */
       int8_t notify(ManuvrMsg*);
@@ -174,6 +238,7 @@ limitations under the License.
       static int8_t raiseEvent(uint16_t event_code, EventReceiver* data);
       static int8_t staticRaiseEvent(ManuvrMsg* event);
       static bool   abortEvent(ManuvrMsg* event);
+      static void   refileSchedule(ManuvrMsg* sched);  // Called when a schedule's timing changes.
       static int8_t isrRaiseEvent(ManuvrMsg* event);
       static void   nextTick(BufferPipe*);
 
@@ -186,18 +251,28 @@ limitations under the License.
     private:
       ManuvrMsg _preallocation_pool[EVENT_MANAGER_PREALLOC_COUNT];
       ManuvrMsg* current_event = nullptr;  // The presently-executing event.
+      EventWorkerPool* _workers = nullptr; // Optional threads for notify()'ing in parallel.
       ElementPool<ManuvrMsg>           _msg_prealloc; // This is the listing of pre-allocated Msgs.
-      PriorityQueue<ManuvrMsg*>        exec_queue;    // Msgs that are pending execution.
+      RunQueue<ManuvrMsg>              exec_queue;    // Msgs that are pending execution.
       PriorityQueue<ManuvrMsg*>        schedules;     // These are Msgs scheduled to be run.
+      TimerWheel<ManuvrMsg>            sched_wheel;   // The subset of schedules that are waiting to fire, by deadline.
 
       PriorityQueue<BufferPipe*>       _pipe_io_pend; // Pending BufferPipe transfers that wish to be async.
-      PriorityQueue<TaskProfilerData*> event_costs;   // Message code is the priority. Calculates average cost in uS.
+      #if defined(MANUVR_EVENT_PROFILER)
+      MsgProfiler                      event_costs;   // Run and wait times (in uS), by message code.
+      #endif
       PriorityQueue<EventReceiver*>    subscribers;   // Our manifest of EventReceivers we service.
       std::map<uint16_t, PriorityQueue<listenerFxnPtr>*> ca_listeners;  // Call-ahead listeners.
       std::map<uint16_t, PriorityQueue<listenerFxnPtr>*> cb_listeners;  // Call-back listeners.
+      std::map<uint16_t, DispatchList*> _dispatch_lists;  // Subscribers by message code.
+      uint32_t _dispatch_gen      = 1; // Bumped whenever the subscriber list changes.
+      EventReceiver** _fan_out    = nullptr; // Scratch for the receivers of an event bound for the pool.
+      uint16_t _fan_out_cap       = 0; // Sized to the largest dispatch list.
 
       uint32_t _ms_elapsed        = 0; // How much time has passed since we serviced our schedules?
       uint32_t _skips_observed    = 0; // How many sequential scheduler skips have we noticed?
+      uint32_t _sched_lag_last    = 0; // How late (in ms) was the most-recently fired schedule?
+      uint32_t _sched_lag_max     = 0; // How late (in ms) was the latest schedule we've ever fired?
       /* Profiling and logging variables... */
       uint32_t micros_occupied    = 0; // How many micros have we spent procing Msgs?
       uint32_t total_loops        = 0; // How many times have we looped?
@@ -209,9 +284,18 @@ limitations under the License.
       uint16_t consequtive_idles;      // How many consecutive idle loops?
       uint16_t max_idle_count;         // How many consecutive idle loops before we act?
       uint32_t insertion_denials;      // How many times have we rejected events?
-
-
-      uint8_t  max_events_p_loop;     // What is the most events we've handled in a single loop?
+      uint32_t notify_calls       = 0; // How many times have we called notify()?
+      uint32_t notify_avoided     = 0; // How many notify() calls did the dispatch lists save?
+      uint32_t _sched_loop_us     = KERNEL_SCHED_LOOP_BUDGET_US;
+      uint32_t _sched_aging_us    = KERNEL_SCHED_AGING_US;
+      uint32_t _sched_slack_us    = KERNEL_SCHED_DEADLINE_SLACK_US;
+      uint32_t _sched_yields      = 0; // How many loops were cut short by a receiver's budget?
+      uint8_t  _sched_deferred    = 0; // Bands that have waited for want of budget in this loop.
+      uint8_t  _sched_overtime    = 0; // Nearly-due Msgs run after this loop was spent.
+      SchedBand _bands[KERNEL_SCHED_BANDS];
+
+
+      uint32_t max_events_p_loop;     // What is the most events we've handled in a single loop?
       int8_t   max_events_per_loop;
 
       int8_t procCallAheads(ManuvrMsg* active_event);
@@ -219,14 +303,22 @@ limitations under the License.
 
       unsigned int countActiveSchedules();  // How many active schedules are present?
       int serviceSchedules();         // Prep any schedules that have come due for exec.
+      void _refile_schedule(ManuvrMsg*);  // (Re)file a schedule in the wheel according to its state.
 
       int8_t validate_insertion(ManuvrMsg*);
       void reclaim_event(ManuvrMsg*);
+      void _retire_event(ManuvrMsg*, uint8_t activity);  // Everything that follows notify().
+      DispatchList* _dispatch_list(uint16_t code);       // Who wants this code?
+      int  _retire_dispatched();                         // Retire whatever the workers have finished.
       inline void update_maximum_queue_depth() {   max_queue_depth = (exec_queue.size() > (int) max_queue_depth) ? exec_queue.size() : max_queue_depth;   };
 
-
-      /*  */
-      inline bool should_run_another_event(int8_t loops, uint32_t begin) {     return (max_events_per_loop ? ((int8_t) max_events_per_loop > loops) : ((micros() - begin) < 1200));   };
+      /* Scheduling policy. */
+      void       _sched_loop_begin(uint32_t now);
+      ManuvrMsg* _next_runnable(int ran, uint32_t loop_start, SchedBand** band);
+      void       _charge_receiver(EventReceiver*, uint32_t us);
+      inline bool _timed_receiver(EventReceiver* er) {
+        return ((0 < er->_sched_budget_us) || _profiler_enabled());
+      };
 
       inline bool _profiler_enabled() {         return (_er_flag(MKERNEL_FLAG_PROFILING));            };
       inline void _profiler_enabled(bool nu) {  return (_er_set_flag(MKERNEL_FLAG_PROFILING, nu));    };
@@ -234,10 +326,12 @@ limitations under the License.
       inline void _skip_detected(bool nu) {     return (_er_set_flag(MKERNEL_FLAG_SKIP_DETECT, nu));  };
       inline bool _pending_pipes() {            return (_er_flag(MKERNEL_FLAG_PENDING_PIPE));         };
       inline void _pending_pipes(bool nu) {     return (_er_set_flag(MKERNEL_FLAG_PENDING_PIPE, nu)); };
+      inline bool _sched_yield() {              return (_er_flag(MKERNEL_FLAG_SCHED_YIELD));          };
+      inline void _sched_yield(bool nu) {       return (_er_set_flag(MKERNEL_FLAG_SCHED_YIELD, nu));  };
       void _idle(bool nu);
 
       static Kernel*     INSTANCE;
-      static PriorityQueue<ManuvrMsg*> isr_exec_queue;   // Events that have been raised from ISRs.
+      static MPSCQueue<ManuvrMsg>      isr_exec_queue;   // Events that have been raised from ISRs and foreign threads.
 
       static unsigned long _millis_idle;
       static unsigned long _millis_working;
@@ -43,7 +43,10 @@ extern inline uint16_t parseUint16Fromchars(unsigned char *input);
 * Static members and initializers should be located here.
 *******************************************************************************/
 // Runtime manifest of Msg definitions.
-std::map<uint16_t, const MessageTypeDef*> ManuvrMsg::message_defs_extended;
+const MessageTypeDef** ManuvrMsg::_ext_defs      = nullptr;
+uint16_t*              ManuvrMsg::_ext_slots     = nullptr;
+uint16_t               ManuvrMsg::_ext_capacity  = 0;
+uint16_t               ManuvrMsg::_ext_count     = 0;
 
 // Generic argument def for a message with no args.
 const unsigned char ManuvrMsg::MSG_ARGS_NONE[] = {0};
@@ -58,6 +61,121 @@ bool ManuvrMsg::isExportable(const MessageTypeDef* message_def) {
   return (message_def->msg_type_flags & MSG_FLAG_EXPORTABLE);
 }
 
+/**
+* Slot for a message code in a hash table of the given (power-of-two) size.
+*/
+static inline uint16_t _msg_def_hash(uint16_t code, uint16_t capacity) {
+  uint32_t h = code * 0x9E3779B1;
+  return (uint16_t) ((h ^ (h >> 16)) & (capacity - 1));
+}
+
+
+/**
+* Turns the contents of a hash slot back into a definition.
+*/
+inline const MessageTypeDef* ManuvrMsg::_slot_def(uint16_t v) {
+  return (v <= TOTAL_MSG_DEFS) ? &message_defs[v - 1] : _ext_defs[v - 1 - TOTAL_MSG_DEFS];
+}
+
+
+/**
+* (Re)builds the hash index at the given size. Built-in definitions go in
+*   first, so that they take precedence over registered ones, as they always
+*   have.
+*
+* @param  capacity  Slot count. Must be a power of two.
+* @return 0 on success, -1 on allocation failure.
+*/
+int8_t ManuvrMsg::_index_defs(uint16_t capacity) {
+  uint16_t* nu_slots = (uint16_t*) malloc(capacity * sizeof(uint16_t));
+  const MessageTypeDef** nu_defs = (const MessageTypeDef**) malloc((capacity >> 1) * sizeof(MessageTypeDef*));
+  if ((nullptr == nu_slots) || (nullptr == nu_defs)) {
+    free(nu_slots);
+    free(nu_defs);
+    return -1;
+  }
+  memset(nu_slots, 0, capacity * sizeof(uint16_t));
+  for (uint16_t n = 0; n < _ext_count; n++) {
+    nu_defs[n] = _ext_defs[n];
+  }
+  free(_ext_slots);
+  free(_ext_defs);
+  _ext_slots    = nu_slots;
+  _ext_defs     = nu_defs;
+  _ext_capacity = capacity;
+
+  const uint16_t total = TOTAL_MSG_DEFS + _ext_count;
+  for (uint16_t v = 1; v <= total; v++) {
+    const uint16_t code = _slot_def(v)->msg_type_code;
+    uint16_t i = _msg_def_hash(code, capacity);
+    while ((0 != _ext_slots[i]) && (_slot_def(_ext_slots[i])->msg_type_code != code)) {
+      i = (i + 1) & (capacity - 1);
+    }
+    if (0 == _ext_slots[i]) {
+      _ext_slots[i] = v;
+    }
+  }
+  return 0;
+}
+
+
+/**
+* Builds the first index, which only needs to hold the built-ins.
+*
+* @return 0 on success, -1 on allocation failure.
+*/
+int8_t ManuvrMsg::_index_builtins() {
+  uint16_t cap = 16;
+  while (cap < (TOTAL_MSG_DEFS * 4)) cap <<= 1;
+  return _index_defs(cap);
+}
+
+
+/**
+* Adds a definition to the runtime manifest, replacing any prior registration
+*   with the same code. The index doubles whenever it becomes half full.
+*
+* @param  def  The definition to add.
+* @return 0 on success, -1 on allocation failure.
+*/
+int8_t ManuvrMsg::_ext_insert(const MessageTypeDef* def) {
+  const uint16_t code = def->msg_type_code;
+  if ((0 == _ext_capacity) && (0 != _index_builtins())) {
+    return -1;
+  }
+
+  uint16_t i = _msg_def_hash(code, _ext_capacity);
+  while (0 != _ext_slots[i]) {
+    uint16_t v = _ext_slots[i];
+    if (_slot_def(v)->msg_type_code == code) {
+      if (v > TOTAL_MSG_DEFS) {
+        _ext_defs[v - 1 - TOTAL_MSG_DEFS] = def;   // Redefinition.
+        return 0;
+      }
+      break;   // A built-in code. It will keep precedence.
+    }
+    i = (i + 1) & (_ext_capacity - 1);
+  }
+
+  if ((TOTAL_MSG_DEFS + _ext_count + 1) * 2 > _ext_capacity) {
+    if (_ext_capacity & 0x8000) return -1;   // Full.
+    _ext_defs[_ext_count] = def;  // There is always room for one more.
+    _ext_count++;
+    if (0 != _index_defs(_ext_capacity << 1)) {
+      _ext_count--;
+      return -1;
+    }
+    return 0;
+  }
+
+  _ext_defs[_ext_count++] = def;
+  if (0 == _ext_slots[i]) {
+    _ext_slots[i] = TOTAL_MSG_DEFS + _ext_count;
+  }
+  return 0;
+}
+
+
 /**
 * Called by other classes to add their event definitions to the runtime
 *   manifest.
@@ -68,7 +186,7 @@ bool ManuvrMsg::isExportable(const MessageTypeDef* message_def) {
 */
 int8_t ManuvrMsg::registerMessages(const MessageTypeDef defs[], int mes_count) {
   for (int i = 0; i < mes_count; i++) {
-    message_defs_extended[defs[i].msg_type_code] = &defs[i];
+    if (0 != _ext_insert(&defs[i])) return -1;
   }
   return 0;
 }
@@ -81,8 +199,7 @@ int8_t ManuvrMsg::registerMessages(const MessageTypeDef defs[], int mes_count) {
 * @return 0 on success. Non-zero otherwise.
 */
 int8_t ManuvrMsg::registerMessage(MessageTypeDef* nu_def) {
-  message_defs_extended[nu_def->msg_type_code] = nu_def;
-  return 0;
+  return _ext_insert(nu_def);
 }
 
 /**
@@ -119,19 +236,7 @@ int8_t ManuvrMsg::registerMessage(uint16_t tc, uint16_t tf, const char* lab, con
 * @return a pointer to the human-readable label for this Msg code. Never nullptr.
 */
 const char* ManuvrMsg::getMsgTypeString(uint16_t code) {
-  for (int i = 0; i < TOTAL_MSG_DEFS; i++) {
-    if (ManuvrMsg::message_defs[i].msg_type_code == code) {
-      return ManuvrMsg::message_defs[i].debug_label;
-    }
-  }
-
-  // Didn't find it there. Search in the extended defs...
-  const MessageTypeDef* temp_type_def = message_defs_extended[code];
-  if ( temp_type_def) {
-    return temp_type_def->debug_label;
-  }
-  // If we've come this far, we don't know what the caller is asking for. Return the default.
-  return ManuvrMsg::message_defs[0].debug_label;
+  return lookupMsgDefByCode(code)->debug_label;
 }
 
 
@@ -143,15 +248,20 @@ const char* ManuvrMsg::getMsgTypeString(uint16_t code) {
 * @return a pointer to the MessageTypeDef for this Msg code. Never nullptr.
 */
 const MessageTypeDef* ManuvrMsg::lookupMsgDefByCode(uint16_t code) {
-  for (int i = 0; i < TOTAL_MSG_DEFS; i++) {
-    if (ManuvrMsg::message_defs[i].msg_type_code == code) {
-      return &ManuvrMsg::message_defs[i];
+  if (0 == _ext_capacity) {
+    // Nothing has been registered yet. Index the built-ins.
+    if (0 != _index_builtins()) {
+      for (int i = 0; i < TOTAL_MSG_DEFS; i++) {
+        if (message_defs[i].msg_type_code == code) return &message_defs[i];
+      }
+      return &ManuvrMsg::message_defs[0];
     }
   }
-  // Didn't find it there. Search in the extended defs...
-  const MessageTypeDef* temp_type_def = message_defs_extended[code];
-  if (temp_type_def) {
-    return temp_type_def;
+  uint16_t i = _msg_def_hash(code, _ext_capacity);
+  while (0 != _ext_slots[i]) {
+    const MessageTypeDef* def = _slot_def(_ext_slots[i]);
+    if (def->msg_type_code == code) return def;
+    i = (i + 1) & (_ext_capacity - 1);
   }
   // If we've come this far, we don't know what the caller is asking for. Return the default.
   return &ManuvrMsg::message_defs[0];
@@ -175,9 +285,8 @@ const MessageTypeDef* ManuvrMsg::lookupMsgDefByLabel(char* label) {
 
   // Didn't find it there. Search in the extended defs...
   const MessageTypeDef* temp_type_def;
-  std::map<uint16_t, const MessageTypeDef*>::iterator it;
-  for (it = message_defs_extended.begin(); it != message_defs_extended.end(); it++) {
-    temp_type_def = it->second;
+  for (uint16_t i = 0; i < _ext_count; i++) {
+    temp_type_def = _ext_defs[i];
     if (strstr(label, temp_type_def->debug_label)) {
       return temp_type_def;
     }
@@ -228,9 +337,8 @@ int8_t ManuvrMsg::getMsgLegend(StringBuilder* output) {
     }
   }
 
-  std::map<uint16_t, const MessageTypeDef*>::iterator it;
-  for (it = message_defs_extended.begin(); it != message_defs_extended.end(); it++) {
-    temp_def = it->second;
+  for (uint16_t i = 0; i < _ext_count; i++) {
+    temp_def = _ext_defs[i];
 
     if (isExportable(temp_def)) {
       output->concat((unsigned char*) temp_def, 4);
@@ -349,18 +457,30 @@ ManuvrMsg::~ManuvrMsg() {
 */
 int8_t ManuvrMsg::repurpose(uint16_t code, EventReceiver* cb) {
   // These things have implications for memory management, which is why repurpose() doesn't touch them.
-  uint32_t _persist_mask = MANUVR_MSG_FLAG_SCHEDULED;
+  uint32_t _persist_mask = MANUVR_MSG_FLAG_SCHEDULED | MANUVR_MSG_FLAG_EXEC_QUEUED | MANUVR_MSG_FLAG_DISPATCHED;
   _flags            = _flags & _persist_mask;
   _origin           = cb;
   specific_target   = nullptr;
   schedule_callback = nullptr;
   priority(EVENT_PRIORITY_DEFAULT);
+  _deadline         = 0;
   _code             = code;
   message_def       = lookupMsgDefByCode(_code);
   return 0;
 }
 
 
+/**
+* Sets this Msg's deadline to the given number of microseconds from now.
+*
+* @param us  How long from now the Msg is due.
+*/
+void ManuvrMsg::deadlineIn(uint32_t us) {
+  _deadline = micros() + us;
+  if (0 == _deadline) _deadline = 1;   // Zero means "none".
+}
+
+
 /*******************************************************************************
 * Argument manipulation...                                                     *
 *******************************************************************************/
@@ -373,14 +493,44 @@ int8_t ManuvrMsg::repurpose(uint16_t code, EventReceiver* cb) {
 * @return nullptr on failure, or Argument passed as a parameter on success.
 */
 Argument* ManuvrMsg::addArg(Argument* nu) {
+  if (nullptr == nu) return nullptr;
   if (_args) {
-    return _args->link(nu);
+    // Link after the last Argument we know of, rather than from the root.
+    _arg_idx[_arg_indexed - 1]->link(nu);
+  }
+  else {
+    _args = nu;
+    _arg_idx[0]  = nu;
+    _arg_indexed = 1;
+  }
+  // Index as much of the list as we have room for.
+  Argument* a = _arg_idx[_arg_indexed - 1]->next();
+  while ((nullptr != a) && (_arg_indexed < MANUVR_MSG_ARG_INDEX_DEPTH)) {
+    _arg_idx[_arg_indexed++] = a;
+    a = a->next();
   }
-  _args = nu;
   return nu;
 };
 
 
+/**
+* Finds an Argument by position. The first MANUVR_MSG_ARG_INDEX_DEPTH are
+*   reached directly. The rest are found by walking from the last of those.
+*
+* @param  idx  The Argument position
+* @return the Argument, or nullptr if there is no such Argument.
+*/
+Argument* ManuvrMsg::_arg_at(uint8_t idx) {
+  if (idx < _arg_indexed) return _arg_idx[idx];
+  if (0 == _arg_indexed)  return nullptr;
+  Argument* a = _arg_idx[_arg_indexed - 1];
+  for (uint8_t i = _arg_indexed - 1; (i < idx) && (nullptr != a); i++) {
+    a = a->next();
+  }
+  return a;
+}
+
+
 /**
 * This function is for the exclusive purpose of inflating an argument from a place where a
 *   pointer doesn't make sense. This means that an argument mode that contains a non-exportable
@@ -457,28 +607,24 @@ uint8_t ManuvrMsg::inflateArgumentsFromBuffer(uint8_t* buffer, int len) {
         buffer += 4;
         break;
       case TCode::VECT_4_FLOAT:
-        nu_arg = new Argument(new Vector4f(parseFloatFromchars(buffer + 0), parseFloatFromchars(buffer + 4), parseFloatFromchars(buffer + 8), parseFloatFromchars(buffer + 12)));
+        nu_arg = new Argument(Vector4f(parseFloatFromchars(buffer + 0), parseFloatFromchars(buffer + 4), parseFloatFromchars(buffer + 8), parseFloatFromchars(buffer + 12)));
         len = len - 16;
         buffer += 16;
-        nu_arg->reapValue(true);
         break;
       case TCode::VECT_3_FLOAT:
-        nu_arg = new Argument(new Vector3f(parseFloatFromchars(buffer + 0), parseFloatFromchars(buffer + 4), parseFloatFromchars(buffer + 8)));
+        nu_arg = new Argument(Vector3f(parseFloatFromchars(buffer + 0), parseFloatFromchars(buffer + 4), parseFloatFromchars(buffer + 8)));
         len = len - 12;
         buffer += 12;
-        nu_arg->reapValue(true);
         break;
       case TCode::VECT_3_UINT16:
-        nu_arg = new Argument(new Vector3ui16(parseUint16Fromchars(buffer + 0), parseUint16Fromchars(buffer + 2), parseUint16Fromchars(buffer + 4)));
+        nu_arg = new Argument(Vector3ui16(parseUint16Fromchars(buffer + 0), parseUint16Fromchars(buffer + 2), parseUint16Fromchars(buffer + 4)));
         len = len - 6;
         buffer += 6;
-        nu_arg->reapValue(true);
         break;
       case TCode::VECT_3_INT16:
-        nu_arg = new Argument(new Vector3i16((int16_t) parseUint16Fromchars(buffer + 0), (int16_t) parseUint16Fromchars(buffer + 2), (int16_t) parseUint16Fromchars(buffer + 4)));
+        nu_arg = new Argument(Vector3i16((int16_t) parseUint16Fromchars(buffer + 0), (int16_t) parseUint16Fromchars(buffer + 2), (int16_t) parseUint16Fromchars(buffer + 4)));
         len = len - 6;
         buffer += 6;
-        nu_arg->reapValue(true);
         break;
 
       // Variable-length types...
@@ -529,8 +675,8 @@ uint8_t ManuvrMsg::inflateArgumentsFromBuffer(uint8_t* buffer, int len) {
 * @return 1 on success, 0 on failure.
 */
 int8_t ManuvrMsg::markArgForReap(uint8_t idx, bool reap) {
-  if (_args) {
-    Argument* tmp = _args->retrieveArgByIdx(idx);
+  Argument* tmp = _arg_at(idx);
+  if (tmp) {
     tmp->reapValue(reap);
     return 1;
   }
@@ -547,11 +693,8 @@ int8_t ManuvrMsg::markArgForReap(uint8_t idx, bool reap) {
 * @return 0 or appropriate failure code.
 */
 int8_t ManuvrMsg::getArgAs(uint8_t idx, void* trg_buf) {
-  int8_t return_value = -1;
-  if (_args) {
-    return ((0 == idx) ? _args->getValueAs(trg_buf) : _args->getValueAs(idx, trg_buf));
-  }
-  return return_value;
+  Argument* a = _arg_at(idx);
+  return ((nullptr != a) ? a->getValueAs(trg_buf) : -1);
 }
 
 
@@ -597,6 +740,7 @@ int8_t ManuvrMsg::writePointerArgAs(uint8_t idx, void* trg_buf) {
 * @return 0 or appropriate failure code.
 */
 int8_t ManuvrMsg::clearArgs() {
+  _arg_indexed = 0;
   if (_args) {
     Argument* tmp = _args;
     _args = nullptr;
@@ -614,6 +758,7 @@ int8_t ManuvrMsg::clearArgs() {
 Argument* ManuvrMsg::takeArgs() {
   Argument* ret = _args;
   _args = nullptr;
+  _arg_indexed = 0;
   return ret;
 }
 
@@ -625,11 +770,9 @@ Argument* ManuvrMsg::takeArgs() {
 * @return TCode::NONE if the Argument isn't found, and its type code if it is.
 */
 TCode ManuvrMsg::getArgumentType(uint8_t idx) {
-  if (_args) {
-    Argument* a = _args->retrieveArgByIdx(idx);
-    if (a) {
-      return a->typeCode();
-    }
+  Argument* a = _arg_at(idx);
+  if (a) {
+    return a->typeCode();
   }
   return TCode::NONE;
 }
@@ -668,8 +811,7 @@ const char* ManuvrMsg::getMsgTypeString() {
 * @return The human-readable label for the type of the Argument at given index.
 */
 const char* ManuvrMsg::getArgTypeString(uint8_t idx) {
-  if (nullptr == _args) return "<INVALID INDEX>";
-  Argument* a = _args->retrieveArgByIdx(idx);
+  Argument* a = _arg_at(idx);
   if (nullptr == a) return "<INVALID INDEX>";
   return getTypeCodeString(a->typeCode());
 }
@@ -832,7 +974,7 @@ void ManuvrMsg::printDebug(StringBuilder *output) {
   if (isScheduled()) {
     output->concatf("\t [%p] Schedule \n\t --------------------------------\n", this);
     output->concatf("\t Enabled       \t%s\n", (scheduleEnabled() ? YES_STR : NO_STR));
-    output->concatf("\t Time-till-fire\t%u\n", _sched_ttw);
+    output->concatf("\t TTW when filed\t%u\n", _sched_ttw);
     output->concatf("\t Period        \t%u\n", _sched_period);
     output->concatf("\t Recurs?       \t%d\n", _sched_recurs);
     output->concatf("\t Exec pending: \t%s\n", (shouldFire() ? YES_STR : NO_STR));
@@ -902,13 +1044,7 @@ void ManuvrMsg::clearProfilingData() {
 */
 void ManuvrMsg::noteExecutionTime(uint32_t profile_start_time, uint32_t profile_stop_time) {
   if (prof_data) {
-    profile_stop_time = micros();
-    prof_data->run_time_last    = wrap_accounted_delta(profile_start_time, profile_stop_time);  // Rollover invarient.
-    prof_data->run_time_best    = strict_min(prof_data->run_time_best,  prof_data->run_time_last);
-    prof_data->run_time_worst   = strict_max(prof_data->run_time_worst, prof_data->run_time_last);
-    prof_data->run_time_total  += prof_data->run_time_last;
-    prof_data->run_time_average = prof_data->run_time_total / ((prof_data->executions) ? prof_data->executions : 1);
-    prof_data->executions++;
+    prof_data->noteRunTime(wrap_accounted_delta(profile_start_time, profile_stop_time));  // Rollover invarient.
   }
 }
 #endif // MANUVR_EVENT_PROFILER
@@ -937,6 +1073,7 @@ bool ManuvrMsg::alterSchedulePeriod(uint32_t nu_period) {
   if (nu_period > 1) {
     _sched_period       = nu_period;
     _sched_ttw = nu_period;
+    Kernel::refileSchedule(this);
     return_value  = true;
   }
   return return_value;
@@ -948,7 +1085,10 @@ bool ManuvrMsg::alterSchedulePeriod(uint32_t nu_period) {
 * @return  true if the schedule alteraction succeeded.
 */
 bool ManuvrMsg::alterScheduleRecurrence(int16_t recurrence) {
-  shouldFire(false);
+  if (shouldFire()) {
+    shouldFire(false);
+    Kernel::refileSchedule(this);
+  }
   _sched_recurs = recurrence;
   return true;
 }
@@ -976,6 +1116,7 @@ bool ManuvrMsg::alterSchedule(uint32_t sch_p, int16_t sch_r, bool ac, FxnPointer
       _sched_period     = sch_p;
       _sched_ttw        = sch_p;
       schedule_callback = sch_cb;
+      Kernel::refileSchedule(this);
       return_value      = true;
     }
   }
@@ -1019,43 +1160,41 @@ bool ManuvrMsg::willRunAgain() {
 
 
 /**
-* Applies time to the schedule, bringing it closer to execution.
+* Called by the Kernel when the schedule's deadline has passed. Works out the
+*   next TTW (keeping the schedule in phase if possible), and the recurrence.
 *
-* @param  uint32_t The number of milliseconds to drop from the schedule.
+* @param  uint32_t How many milliseconds late the Kernel noticed the deadline.
 * @return  an integer code directing the kernel how to procede.
 */
-int8_t ManuvrMsg::applyTime(uint32_t mse) {
+int8_t ManuvrMsg::applyTime(uint32_t lag_ms) {
   int8_t return_value = 0;
   if (scheduleEnabled()) {
-    if ((_sched_ttw > mse) && (!shouldFire())) {
-      _sched_ttw -= mse;
+    if (shouldFire()) {
+      // We were fired ahead of schedule. Start a fresh period from here.
+      lag_ms = 0;
     }
-    else {
-      // The schedule should execute this time.
-      uint32_t adjusted_ttw = (mse - _sched_ttw);
-      if (adjusted_ttw > _sched_period) {
-        // TODO: Possible error-case? Too many clicks passed. We have schedule jitter...
-        // For now, we'll just throw away the difference.
-        adjusted_ttw = 0;
-        Kernel::lagged_schedules++;
-      }
-      _sched_ttw = _sched_period - adjusted_ttw;
-      switch (_sched_recurs) {
-        default:
-          // If we are on a fixed execution-count, but will run again.
-          _sched_recurs--;
-        case -1:
-          // We run until stopped.
-          return_value = 1;
-          break;
-        case 0:
-          // We aren't supposed to run again.
-          scheduleEnabled(false);
-          return_value = autoClear() ? -1 : 1;
-          break;
-      }
-      shouldFire(false);    // ...mark it as serviced.
+    else if (lag_ms > _sched_period) {
+      // TODO: Possible error-case? Too many clicks passed. We have schedule jitter...
+      // For now, we'll just throw away the difference.
+      lag_ms = 0;
+      Kernel::lagged_schedules++;
+    }
+    _sched_ttw = _sched_period - lag_ms;
+    switch (_sched_recurs) {
+      default:
+        // If we are on a fixed execution-count, but will run again.
+        _sched_recurs--;
+      case -1:
+        // We run until stopped.
+        return_value = 1;
+        break;
+      case 0:
+        // We aren't supposed to run again.
+        scheduleEnabled(false);
+        return_value = autoClear() ? -1 : 1;
+        break;
     }
+    shouldFire(false);    // ...mark it as serviced.
   }
   return return_value;  // Kernel will take no action.
 }
@@ -1075,6 +1214,7 @@ bool ManuvrMsg::enableSchedule(bool en) {
     _sched_ttw = _sched_period;
   }
   scheduleEnabled(en);
+  Kernel::refileSchedule(this);
   return true;
 }
 
@@ -1089,10 +1229,22 @@ bool ManuvrMsg::enableSchedule(bool en) {
 bool ManuvrMsg::delaySchedule(uint32_t by_ms) {
   _sched_ttw = by_ms;
   scheduleEnabled(true);
+  Kernel::refileSchedule(this);
   return true;
 }
 
 
+/**
+* If this ManuvrMsg is scheduled, call this to proc it on the "next-tick".
+* All schedule members are treated normally, so if the schedule recurs,
+*   it will be re-timed after next-tick, with a decremented recur counter.
+*/
+void ManuvrMsg::fireNow() {
+  shouldFire(true);
+  Kernel::refileSchedule(this);
+}
+
+
 
 /*******************************************************************************
 * Actually execute this runnable.                                              *
@@ -31,6 +31,9 @@ This class forms the foundation of internal events. It contains the identity of
 #include "MessageDefs.h"    // This include file contains all of the message codes.
 #include <DataStructures/Argument.h>
 #include <DataStructures/LightLinkedList.h>
+#include <DataStructures/RunQueue.h>
+#include <DataStructures/TimerWheel.h>
+#include <DataStructures/MPSCQueue.h>
 
 #include <EnumeratedTypeCodes.h>
 #include <MsgProfiler.h>
@@ -43,6 +46,8 @@ This class forms the foundation of internal events. It contains the identity of
 /*
 * These are flag definitions that might apply to an instance of a Msg.
 */
+#define MANUVR_MSG_FLAG_DISPATCHED      0x04000000  // This Msg is being delivered by the Kernel's worker pool.
+#define MANUVR_MSG_FLAG_EXEC_QUEUED     0x08000000  // This Msg is presently in the Kernel's exec_queue.
 #define MANUVR_MSG_FLAG_AUTOCLEAR       0x10000000  // If true, this schedule will be removed after its last execution.
 #define MANUVR_MSG_FLAG_SCHED_ENABLED   0x20000000  // Is the schedule running?
 #define MANUVR_MSG_FLAG_SCHEDULED       0x40000000  // Set to true to cause the Kernel to not free().
@@ -51,6 +56,13 @@ This class forms the foundation of internal events. It contains the identity of
 #define MANUVR_MSG_FLAG_PRIORITY_MASK   0x0000FF00
 #define MANUVR_MSG_FLAG_REF_COUNT_MASK  0x0000007F
 
+/*
+* How many of a Msg's leading Arguments can be reached without walking the list?
+*/
+#ifndef MANUVR_MSG_ARG_INDEX_DEPTH
+  #define MANUVR_MSG_ARG_INDEX_DEPTH    4
+#endif
+
 
 class EventReceiver;
 
@@ -80,7 +92,7 @@ typedef struct msg_defin_t {
 #define MSG_FLAG_EMITS        0x0010      // Indicates that this device might emit this message.
 #define MSG_FLAG_LISTENS      0x0020      // Indicates that this device can accept this message.
 
-#define MSG_FLAG_RESERVED_9   0x0040      // Reserved flag.
+#define MSG_FLAG_PARALLEL_SAFE 0x0040     // Receivers may be notified of this message concurrently.
 #define MSG_FLAG_RESERVED_8   0x0080      // Reserved flag.
 #define MSG_FLAG_RESERVED_7   0x0100      // Reserved flag.
 #define MSG_FLAG_RESERVED_6   0x0200      // Reserved flag.
@@ -141,6 +153,16 @@ class ManuvrMsg {
       return (message_def->msg_type_flags & MSG_FLAG_DEMAND_ACK);
     }
 
+    /**
+    * May this message be delivered to parallel-safe receivers concurrently?
+    *
+    * @return true if so.
+    */
+    inline bool isParallelSafe() {
+      if (NULL == message_def) message_def = lookupMsgDefByCode(_code);
+      return (message_def->msg_type_flags & MSG_FLAG_PARALLEL_SAFE);
+    }
+
     /**
     * Allows the caller to plan other allocations based on how many bytes this message's
     *   Arguments occupy.
@@ -196,6 +218,10 @@ class ManuvrMsg {
     inline Argument* addArg(Vector3i16 *val) {     return addArg(new Argument(val));  }
     inline Argument* addArg(Vector3f *val) {       return addArg(new Argument(val));  }
     inline Argument* addArg(Vector4f *val) {       return addArg(new Argument(val));  }
+    inline Argument* addArg(Vector3ui16 val) {     return addArg(new Argument(val));  }  // These are copied.
+    inline Argument* addArg(Vector3i16 val) {      return addArg(new Argument(val));  }
+    inline Argument* addArg(Vector3f val) {        return addArg(new Argument(val));  }
+    inline Argument* addArg(Vector4f val) {        return addArg(new Argument(val));  }
 
     inline Argument* addArg(void *val, int len) {  return addArg(new Argument(val, len));  }
     inline Argument* addArg(const char *val) {     return addArg(new Argument(val));  }
@@ -268,8 +294,8 @@ class ManuvrMsg {
     /* If this ManuvrMsg is scheduled, aborts it. Returns true if aborted. */
     bool abort();
 
-    /* Applies time to the schedule, bringing it closer to execution. */
-    int8_t applyTime(uint32_t ms);
+    /* Called by the Kernel when the schedule comes due, with how late it was noticed. */
+    int8_t applyTime(uint32_t lag_ms);
 
     /* Called from the kernel to inform the class that it has completed. */
     int8_t callbackOriginator();
@@ -282,6 +308,7 @@ class ManuvrMsg {
 
     /* These are accessors to formerly-public members of ScheduleItem. */
     inline uint32_t schedulePeriod() { return _sched_period; };
+    inline uint32_t scheduleTTW() {    return _sched_ttw;    };
     bool alterScheduleRecurrence(int16_t recurrence);
     bool alterSchedulePeriod(uint32_t nu_period);
     bool alterSchedule(FxnPointer sch_callback);
@@ -297,7 +324,7 @@ class ManuvrMsg {
     * All schedule members are treated normally, so if the schedule recurs,
     *   it will be re-timed after next-tick, with a decremented recur counter.
     */
-    inline void fireNow() { shouldFire(true); };
+    void fireNow();
 
     /**
     * Is the schedule pending execution ahread of schedule (next tick)?
@@ -341,6 +368,26 @@ class ManuvrMsg {
     };
 
 
+    /**
+    * Is this Msg waiting in the Kernel's exec_queue? This is how the Kernel
+    *   enforces pointer idempotency without searching the queue.
+    *
+    * @return true if the Msg is enqueued.
+    */
+    inline bool isQueued() { return (_flags & MANUVR_MSG_FLAG_EXEC_QUEUED); };
+
+    /**
+    * Is this Msg still being delivered by the Kernel's worker pool? If so, it
+    *   may not be raised again until it has been retired.
+    *
+    * @return true if the Msg is in flight.
+    */
+    inline bool isDispatched() { return (_flags & MANUVR_MSG_FLAG_DISPATCHED); };
+    inline void isDispatched(bool en) {
+      _flags = (en) ? (_flags | MANUVR_MSG_FLAG_DISPATCHED) : (_flags & ~(MANUVR_MSG_FLAG_DISPATCHED));
+    };
+
+
     inline uint8_t refCount() {  return (_flags & MANUVR_MSG_FLAG_REF_COUNT_MASK); };
     inline bool    decRefs() {   return (0 == --_flags);  };
     inline void    incRefs() {   _flags++;  };
@@ -350,6 +397,18 @@ class ManuvrMsg {
       _flags = (_flags & ~(MANUVR_MSG_FLAG_PRIORITY_MASK)) + (pri << 8);
     };
 
+    /**
+    * When (in uS, by micros()) should this Msg have been run? Among Msgs of
+    *   the same priority, the Kernel runs the earliest deadline first, and
+    *   it will run a Msg that is nearly due even when its priority has used
+    *   up its time. Cleared when the Msg is dispatched.
+    *
+    * @return the deadline, or zero if there isn't one.
+    */
+    inline uint32_t deadline() {               return _deadline;                  };
+    inline void     deadline(uint32_t t) {     _deadline = t;                     };
+    void            deadlineIn(uint32_t us);   // Sets the deadline relative to now.
+
 
     #if defined(MANUVR_EVENT_PROFILER)
       /**
@@ -365,6 +424,10 @@ class ManuvrMsg {
 
       /* Function for pinging the profiler data. */
       void noteExecutionTime(uint32_t start, uint32_t stop);
+
+      /* When (in uS) this Msg was raised. Zero if it wasn't timed. */
+      inline uint32_t raisedAt() {            return _raised_at;   };
+      inline void     raisedAt(uint32_t t) {  _raised_at = t;      };
     #endif
 
 
@@ -385,37 +448,75 @@ class ManuvrMsg {
     static int8_t registerMessage(uint16_t, uint16_t, const char*, const unsigned char*, const char*);
     static int8_t registerMessages(const MessageTypeDef[], int len);
     static bool   isExportable(const MessageTypeDef*);
+    static inline int registeredMessageCount() {   return _ext_count;   };
 
 
 
   private:
+    friend class RunQueue<ManuvrMsg>;
+    friend class TimerWheel<ManuvrMsg>;
+    friend class MPSCQueue<ManuvrMsg>;
+
+    ManuvrMsg*     _rq_next            = nullptr;  // Intrusive links for the exec_queue.
+    ManuvrMsg*     _rq_prev            = nullptr;  // Intrusive links for the exec_queue.
+    uint8_t        _rq_pri             = 0;        // The exec_queue bucket we were filed under.
+    ManuvrMsg*     _tw_next            = nullptr;  // Intrusive links for the Kernel's schedule wheel.
+    ManuvrMsg*     _tw_prev            = nullptr;  // Intrusive links for the Kernel's schedule wheel.
+    uint32_t       _tw_deadline        = 0;        // When the schedule wheel expects us to fire.
+    uint16_t       _tw_slot  = TIMER_WHEEL_NOT_FILED;  // The wheel slot we were filed under.
+    ManuvrMsg*     _mp_next            = nullptr;  // Intrusive link for the Kernel's ISR queue.
+    uint8_t        _mp_claim           = 0;        // Non-zero while pending in the Kernel's ISR queue.
     const MessageTypeDef* message_def  = nullptr;  // The definition for the message (once it is associated).
     FxnPointer     schedule_callback   = nullptr;  // Pointers to the schedule service function.
     EventReceiver* _origin             = nullptr;  // This is an optional ref to the class that raised this runnable.
     Argument*      _args               = nullptr;  // The optional list of arguments associated with this event.
+    Argument*      _arg_idx[MANUVR_MSG_ARG_INDEX_DEPTH];  // The first few members of _args, for direct access.
+    uint8_t        _arg_indexed        = 0;        // How many of _arg_idx are valid?
     uint32_t       _flags              = 0;        // Optional flags that might be important for a runnable.
     uint16_t       _code  = MANUVR_MSG_UNDEFINED;  // The identity of the event (or command).
     int16_t        _sched_recurs       = 0;        // See Note 2.
     uint32_t       _sched_period       = 0;        // How often does this schedule execute?
-    uint32_t       _sched_ttw          = 0;        // How much longer until the schedule fires?
+    uint32_t       _sched_ttw          = 0;        // How long to wait, as of the last time we were filed.
+    uint32_t       _deadline           = 0;        // See deadline().
 
     #if defined(MANUVR_EVENT_PROFILER)
     TaskProfilerData* prof_data = nullptr;  // If this schedule is being profiled, the ref will be here.
+    uint32_t       _raised_at          = 0;        // For the Kernel's measure of queue wait.
     #endif
 
     int8_t getArgAs(uint8_t idx, void *dat);
     int8_t writePointerArgAs(uint8_t idx, void *trg_buf);
+    Argument* _arg_at(uint8_t idx);   // Returns nullptr if there is no such Argument.
 
     char* is_valid_argument_buffer(int len);
     int   collect_valid_grammatical_forms(int, LinkedList<char*>*);
 
+    inline void isQueued(bool en) {
+      _flags = (en) ? (_flags | MANUVR_MSG_FLAG_EXEC_QUEUED) : (_flags & ~(MANUVR_MSG_FLAG_EXEC_QUEUED));
+    };
+
     inline void scheduleEnabled(bool en) {
       _flags = (en) ? (_flags | MANUVR_MSG_FLAG_SCHED_ENABLED) : (_flags & ~(MANUVR_MSG_FLAG_SCHED_ENABLED));
     };
 
 
-    // Where runtime-loaded message defs go.
-    static std::map<uint16_t, const MessageTypeDef*> message_defs_extended;
+    /*
+    * Where runtime-loaded message defs go: a dense array in order of
+    *   registration. Both these and the built-in message_defs are indexed by
+    *   an open-addressed hash of the message code, so lookup is a probe or
+    *   two, regardless of where the def came from.
+    * These are all zero-initialized, so registration is safe from static
+    *   constructors.
+    */
+    static const MessageTypeDef** _ext_defs;      // Registered defs, in order.
+    static uint16_t*              _ext_slots;     // Hash of code -> 1 + (index into message_defs, then _ext_defs).
+    static uint16_t               _ext_capacity;  // Slot count. Zero or a power of two.
+    static uint16_t               _ext_count;     // How many defs are registered?
+
+    static inline const MessageTypeDef* _slot_def(uint16_t);
+    static int8_t _index_defs(uint16_t capacity);
+    static int8_t _index_builtins();
+    static int8_t _ext_insert(const MessageTypeDef*);
 };
 
 #endif   // __MANUVR_MESSAGE_H__
@@ -19,13 +19,69 @@ limitations under the License.
 
 
 The common message-profiling container.
+
+Latencies are kept in log-linear histograms: each power-of-two range of
+  microseconds is split into (1 << MSG_PROFILER_SUB_BITS) equal buckets. So
+  a reported percentile is never off by more than one part in that many,
+  recording a sample is a couple of shifts, and the memory cost is fixed.
+
+The Kernel keeps one TaskProfilerData per message code in a MsgProfiler,
+  which finds it with a single hash probe.
 */
 
 #ifndef __MANUVR_MSG_PROFILER_H__
   #define __MANUVR_MSG_PROFILER_H__
 
+  #include <inttypes.h>
+
   class StringBuilder;
 
+  /*
+  * Sub-buckets per power of two, as a power of two. Each histogram costs
+  *   4 * (33 - bits) * (1 << bits) bytes.
+  */
+  #ifndef MSG_PROFILER_SUB_BITS
+    #if defined(__MANUVR_LINUX)
+      #define MSG_PROFILER_SUB_BITS   3
+    #else
+      #define MSG_PROFILER_SUB_BITS   2
+    #endif
+  #endif
+
+  #define MSG_PROFILER_SUB_COUNT   (1 << MSG_PROFILER_SUB_BITS)
+  #define MSG_PROFILER_BUCKETS     ((33 - MSG_PROFILER_SUB_BITS) * MSG_PROFILER_SUB_COUNT)
+
+
+  class LatencyHistogram {
+    public:
+      LatencyHistogram();
+
+      void     record(uint32_t);
+      void     reset();
+      uint32_t percentile(uint16_t per_mille);  // 500 is the median. 999 is p99.9.
+
+      inline uint32_t count() {    return _count;                        };
+      inline uint32_t minimum() {  return (_count ? _min : 0);           };
+      inline uint32_t maximum() {  return _max;                          };
+      inline uint32_t mean() {     return (_count ? (uint32_t) (_total / _count) : 0);  };
+      inline uint32_t bucketCount(int idx) {  return _buckets[idx];     };
+
+      void printBuckets(StringBuilder*);
+
+      static int      bucketOf(uint32_t);
+      static uint32_t bucketFloor(int);
+      static uint32_t bucketCeiling(int);
+
+
+    private:
+      uint64_t _total;
+      uint32_t _count;
+      uint32_t _min;
+      uint32_t _max;
+      uint32_t _buckets[MSG_PROFILER_BUCKETS];
+  };
+
+
   class TaskProfilerData {
     public:
       TaskProfilerData();
@@ -40,8 +96,46 @@ The common message-profiling container.
       uint32_t executions;       // How many times has this task been used?
       bool     profiling_active;
 
+      LatencyHistogram run_hist;   // Time spent notifying subscribers.
+      LatencyHistogram wait_hist;  // Time between raise and dispatch.
+
+      void noteRunTime(uint32_t);
+      inline void noteWaitTime(uint32_t us) {   wait_hist.record(us);   };
+
       void printDebug(StringBuilder*);
+      void dump(StringBuilder*, bool buckets);
       static void printDebugHeader(StringBuilder*);
+      static void dumpHeader(StringBuilder*);
+  };
+
+
+  /*
+  * The Kernel's per-code profile. Open-addressed on message code, with the
+  *   entries themselves kept densely, in the order they were first seen.
+  */
+  class MsgProfiler {
+    public:
+      MsgProfiler();
+      ~MsgProfiler();
+
+      TaskProfilerData* lookup(uint16_t code);   // Returns nullptr on a miss.
+      TaskProfilerData* profile(uint16_t code);  // As lookup(), but creates on a miss.
+      void clear();
+
+      inline int size() {                      return _count;       };
+      inline TaskProfilerData* get(int idx) {  return (((idx >= 0) && (idx < _count)) ? _entries[idx] : nullptr);  };
+
+      void printDebug(StringBuilder*);
+      void dump(StringBuilder*, bool buckets);
+
+
+    private:
+      TaskProfilerData** _entries;   // Dense, in order of first appearance.
+      uint16_t*          _slots;     // Index into _entries, plus one. Zero is empty.
+      uint16_t           _capacity;  // Slot count. Always a power of two.
+      uint16_t           _count;
+
+      int8_t _rehash(uint16_t capacity);
   };
 
 #endif // __MANUVR_MSG_PROFILER_H__
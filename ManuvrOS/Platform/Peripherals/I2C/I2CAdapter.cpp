@@ -187,6 +187,7 @@ int8_t I2CAdapter::removeSlaveDevice(I2CDevice* slave) {
   if (dev_list.remove(slave)) {
     slave->disassignBusInstance();
     purge_queued_work_by_dev(slave);
+    release_lane(slave);
     return_value = I2C_ERR_SLAVE_NO_ERROR;
   }
   return return_value;
@@ -199,10 +200,12 @@ int8_t I2CAdapter::removeSlaveDevice(I2CDevice* slave) {
 *   is only called to prevent address collision. Not fetch a device handle.
 */
 int I2CAdapter::get_slave_dev_by_addr(uint8_t search_addr) {
-  for (int i = 0; i < dev_list.size(); i++) {
-    if (search_addr == dev_list.get(i)->_dev_addr) {
+  int i = 0;
+  for (I2CDevice* dev : dev_list) {
+    if (search_addr == dev->_dev_addr) {
       return i;
     }
+    i++;
   }
   return I2C_ERR_SLAVE_NOT_FOUND;
 }
@@ -290,13 +293,27 @@ int8_t I2CAdapter::queue_io_job(BusOp* op) {
   I2CBusOp* nu = (I2CBusOp*) op;
   nu->setVerbosity(getVerbosity());
   nu->device = (I2CAdapter*)this;
+  switch (enqueue_op(nu)) {
+    case 0:
+      break;
+    case 1:    // A read of the same thing is already waiting. Ours is redundant.
+      reclaim_queue_item(nu);
+      return 0;
+    default:   // Refused. Fail it back to the requester, so that it isn't lost.
+      _queue_floods++;
+      nu->abort(XferFault::QUEUE_FLUSH);
+      if (nu->callback) nu->callback->io_op_callback(nu);
+      reclaim_queue_item(nu);
+      return -1;
+  }
   if (current_job) {
-    // Something is already going on with the bus. Queue...
-    work_queue.insert(nu);
+    // Something is already going on with the bus. It will get to this in turn.
+    _fill_in_flight();
   }
   else {
-    // Bus is idle. Put this work item in the active slot and start the bus operations...
-    current_job = nu;
+    // Bus is idle. Put the next work item in the active slot and start the bus operations...
+    current_job = dequeue_op();
+    nu = current_job;
     if ((getAdapterId() >= 0) && busOnline()) {
       if (XferFault::NONE == nu->begin()) {
         #if defined(__BUILD_HAS_THREADS)
@@ -364,9 +381,8 @@ int8_t I2CAdapter::advance_work_queue() {
         /* These are finish states. */
         case XferState::FAULT:     // Fault condition.
         case XferState::COMPLETE:  // I/O op complete with no problems.
-          _total_xfers++;
+          retire_op(current_job);
           if (current_job->hasFault()) {
-            _failed_xfers++;
             #if defined(MANUVR_DEBUG)
             if (getVerbosity() > 3) {
               local_log.concat("Destroying failed job.\n");
@@ -388,41 +404,84 @@ int8_t I2CAdapter::advance_work_queue() {
 
     if (nullptr == current_job) {
       // If there is nothing presently being serviced, we should promote an operation from the
-      //   queue into the active slot and initiate it in the block below.
-      current_job = work_queue.dequeue();
+      //   queue into the active slot and initiate it in the block below. Ops that
+      //   were already handed to the platform go first.
+      current_job = _in_flight.dequeue();
+      if (nullptr == current_job) {
+        current_job = dequeue_op();
+      }
       if (current_job) {
         recycle = busOnline();
       }
     }
   }
+  _fill_in_flight();
 
   flushLocalLog();
   return return_value;
 }
 
 
+/**
+* Platforms that can keep more than one op in flight are handed queued work
+*   while the current job is still on the bus. Those ops complete in order,
+*   and are promoted to current_job in turn.
+*/
+void I2CAdapter::_fill_in_flight() {
+  #if (I2CADAPTER_MAX_IN_FLIGHT > 1)
+  if (current_job && current_job->has_bus_control() && busOnline()) {
+    while (_in_flight.size() < (I2CADAPTER_MAX_IN_FLIGHT - 1)) {
+      I2CBusOp* nxt = dequeue_op();
+      if (nullptr == nxt) break;
+      _in_flight.insert(nxt);
+      nxt->begin();   // A failure here is handled when the op is promoted.
+    }
+  }
+  #endif
+}
+
+
+/**
+* Two reads with the same buffer are only the same read if they are aimed at
+*   the same register of the same device.
+*/
+bool I2CAdapter::same_read(I2CBusOp* waiting, I2CBusOp* nu) {
+  return ((waiting->dev_addr == nu->dev_addr) && (waiting->sub_addr == nu->sub_addr));
+}
+
+
 /**
 * Pass an i2c device, and this fxn will purge all of its queued work. Presumably, this is
 *   because it is being detached from the bux, but it may also be because one of it's operations
 *   went bad.
+* Ops that were already handed to the platform are taken back first, so none of
+*   them will call back into the device. Work for other devices is left alone.
 *
 * @param  dev  The device pointer that owns jobs we wish purged.
 */
 void I2CAdapter::purge_queued_work_by_dev(I2CDevice *dev) {
-  I2CBusOp* current = nullptr;
-
-  if (work_queue.size() > 0) {
-    for (int i = 0; i < work_queue.size(); i++) {
-      current = work_queue.get(i);
-      if (current->dev_addr == dev->_dev_addr) {
-        work_queue.remove(current);
-        reclaim_queue_item(current);   // Delete the queued work AND its buffer.
-      }
+  for (PriorityIterator<I2CBusOp*> it = work_queue.begin(); it != work_queue.end(); ++it) {
+    I2CBusOp* current = *it;
+    if (current->dev_addr == dev->_dev_addr) {
+      work_queue.remove(it);
+      reclaim_queue_item(current);   // Delete the queued work AND its buffer.
+    }
+  }
+  for (PriorityIterator<I2CBusOp*> it = _in_flight.begin(); it != _in_flight.end(); ++it) {
+    I2CBusOp* current = *it;
+    if (current->dev_addr == dev->_dev_addr) {
+      _recall(current);
+      _in_flight.remove(it);
+      reclaim_queue_item(current);
     }
   }
 
   // Check this last to head off any silliness with bus operations colliding with us.
-  purge_stalled_job();
+  if (current_job && (current_job->dev_addr == dev->_dev_addr)) {
+    _recall(current_job);
+    reclaim_queue_item(current_job);
+    current_job = nullptr;
+  }
 
   // Lastly... initiate the next bus transfer if the bus is not sideways.
   advance_work_queue();
@@ -430,12 +489,23 @@ void I2CAdapter::purge_queued_work_by_dev(I2CDevice *dev) {
 
 
 /**
-* Purges only the work_queue. Leaves the currently-executing job.
+* Purges the work_queue, and anything waiting in flight behind the current job.
+*   Leaves the currently-executing job.
 */
 void I2CAdapter::purge_queued_work() {
-  I2CBusOp* current = work_queue.dequeue();
+  I2CBusOp* current = _in_flight.dequeue();
+  while (current) {
+    if (_recall(current) || !current->isComplete()) {
+      current->abort(XferFault::QUEUE_FLUSH);
+    }
+    if (current->callback) {
+      current->callback->io_op_callback(current);
+    }
+    reclaim_queue_item(current);
+    current = _in_flight.dequeue();
+  }
+  current = work_queue.dequeue();
   while (current) {
-    current = work_queue.get();
     current->abort(XferFault::QUEUE_FLUSH);
     if (current->callback) {
       current->callback->io_op_callback(current);
@@ -446,13 +516,19 @@ void I2CAdapter::purge_queued_work() {
 }
 
 
+/**
+* Fails the current job. If the platform has it, we wait for the platform to
+*   give it back first.
+*/
 void I2CAdapter::purge_stalled_job() {
   if (current_job) {
-    current_job->abort(XferFault::QUEUE_FLUSH);
+    if (_recall(current_job) || !current_job->isComplete()) {
+      current_job->abort(XferFault::QUEUE_FLUSH);
+    }
     if (current_job->callback) {
       current_job->callback->io_op_callback(current_job);
     }
-    delete current_job;
+    reclaim_queue_item(current_job);
     current_job = nullptr;
   }
 }
@@ -521,8 +597,8 @@ void I2CAdapter::printDevs(StringBuilder *temp) {
   if (temp == nullptr) return;
 
   EventReceiver::printDebug(temp);
-  for (int i = 0; i < dev_list.size(); i++) {
-    dev_list.get(i)->printDebug(temp);
+  for (I2CDevice* dev : dev_list) {
+    dev->printDebug(temp);
   }
   temp->concat("\n");
 }
@@ -630,6 +706,7 @@ void I2CAdapter::printDebug(StringBuilder* output) {
   output->concatf("-- sda/scl             %u/%u\n", _bus_opts.sda_pin, _bus_opts.scl_pin);
   output->concatf("-- bus_error           %s\n", (busError()  ? "yes" : "no"));
   printAdapter(output);
+  output->concatf("-- In flight           %d/%u\n", _in_flight.size(), I2CADAPTER_MAX_IN_FLIGHT - 1);
   printWorkQueue(output, I2CADAPTER_MAX_QUEUE_PRINT);
 }
 
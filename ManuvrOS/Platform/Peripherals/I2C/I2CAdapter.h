@@ -59,6 +59,22 @@ This file is the tortured result of growing pains since the beginning of
     // How many queue items should we have on-tap?
     #define I2CADAPTER_PREALLOC_COUNT 4
   #endif
+  #ifndef I2CADAPTER_MAX_IN_FLIGHT
+    // How many ops may be handed to the platform at once (including current_job)?
+    #if defined(__MANUVR_LINUX)
+      #define I2CADAPTER_MAX_IN_FLIGHT 8
+    #else
+      #define I2CADAPTER_MAX_IN_FLIGHT 1
+    #endif
+  #endif
+  #ifndef I2CDEVICE_MAX_BURST_LEN
+    // How many bytes of contiguous registers may be moved in a single bus op?
+    #define I2CDEVICE_MAX_BURST_LEN 32
+  #endif
+  #ifndef I2CDEVICE_REG_INDEX_MAX
+    // Registers at or above this address are found by search, rather than by index.
+    #define I2CDEVICE_REG_INDEX_MAX 256
+  #endif
 
   /*
   * These are used as function-return codes, and have nothing to do with bus
@@ -299,6 +315,7 @@ This file is the tortured result of growing pains since the beginning of
 
       /* Overrides from the BusAdapter interface */
       int8_t advance_work_queue();
+      bool   same_read(I2CBusOp*, I2CBusOp*);
       int8_t bus_init();      // This must be provided on a per-platform basis.
       int8_t bus_deinit();    // This must be provided on a per-platform basis.
 
@@ -310,6 +327,7 @@ This file is the tortured result of growing pains since the beginning of
       int8_t  ping_map[32];
 
       LinkedList<I2CDevice*> dev_list;    // A list of active slaves on this bus.
+      PriorityQueue<I2CBusOp*> _in_flight; // Begun, and waiting behind current_job.
       ManuvrMsg _queue_ready;
 
 
@@ -318,6 +336,12 @@ This file is the tortured result of growing pains since the beginning of
       void purge_queued_work_by_dev(I2CDevice *dev);
       void purge_queued_work();
       void purge_stalled_job();
+      void _fill_in_flight();
+      #if defined(__MANUVR_LINUX)
+        bool _recall(I2CBusOp*);   // Takes a begun op back from the platform.
+      #else
+        inline bool _recall(I2CBusOp*) {  return false;  };
+      #endif
 
       I2CPingState get_ping_state_by_addr(uint8_t addr);
       void set_ping_state_by_addr(uint8_t addr, I2CPingState nu);
@@ -383,7 +407,7 @@ This file is the tortured result of growing pains since the beginning of
 
     protected:
       RingBuffer<DeviceRegister*> reg_defs;      // Here is where registers will be enumerated.
-      bool      multi_access_support = false;    // TODO: Make this happen! Depends on _pooled_reg_mem.
+      bool      multi_access_support = false;    // Set if the device auto-increments its register pointer.
 
 
       // Callback for requested operation completion.
@@ -428,9 +452,17 @@ This file is the tortured result of growing pains since the beginning of
 
     private:
       uint8_t* _pooled_reg_mem  = nullptr;
+      uint8_t* _reg_index       = nullptr;  // Register address -> (position in reg_defs + 1).
+      uint16_t _reg_index_len   = 0;
 
       int8_t writeRegister(DeviceRegister* reg);
       int8_t readRegister(DeviceRegister* reg);
+      int8_t writeRegisters(DeviceRegister* reg, uint16_t len);
+      int8_t readRegisters(DeviceRegister* reg, uint8_t len);
+
+      void _index_register(DeviceRegister*);
+      void _mark_pending(DeviceRegister*, uint16_t len, bool pending);
+      unsigned int _burst_extent(unsigned int, bool for_write, uint16_t* len);
   };
 
 #endif  //I2C_ABSTRACTION_LAYER_ADAPTER
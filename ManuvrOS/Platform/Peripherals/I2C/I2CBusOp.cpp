@@ -65,8 +65,8 @@ I2CBusOp::~I2CBusOp() {
 
 /* Call to mark something completed that may not be. Also sends a stop. */
 int8_t I2CBusOp::abort(XferFault er) {
+  xfer_fault = er;   // Before the state, for the benefit of other threads.
   markComplete();
-  xfer_fault = er;
   return 0;
 }
 
@@ -53,6 +53,8 @@ I2CDevice::~I2CDevice() {
 /**
 * This is what we call when this class wants to conduct a transaction on
 *   the bus. We simply forward to the bus we are bound to.
+* writeX() and readX() come through here, so an extending class may intercept
+*   its own traffic.
 *
 * @param  _op  The bus operation that was completed.
 * @return 0 to run the op, or non-zero to cancel it.
@@ -139,7 +141,7 @@ bool I2CDevice::writeX(int sub_addr, uint16_t len, uint8_t *buf) {
   nu->sub_addr = (int16_t) sub_addr;
   nu->buf      = buf;
   nu->buf_len  = len;
-  return (0 == _bus->queue_io_job(nu));
+  return (0 == queue_io_job(nu));
 }
 
 
@@ -157,7 +159,7 @@ bool I2CDevice::readX(int sub_addr, uint8_t len, uint8_t *buf) {
   nu->sub_addr = (int16_t) sub_addr;
   nu->buf      = buf;
   nu->buf_len  = len;
-  return (0 == _bus->queue_io_job(nu));
+  return (0 == queue_io_job(nu));
 }
 
 
@@ -44,6 +44,11 @@ I2CDeviceWithRegisters::~I2CDeviceWithRegisters() {
     free(_pooled_reg_mem);
     _pooled_reg_mem = nullptr;
   }
+  if (nullptr != _reg_index) {
+    free(_reg_index);
+    _reg_index     = nullptr;
+    _reg_index_len = 0;
+  }
 }
 
 
@@ -65,6 +70,7 @@ bool I2CDeviceWithRegisters::defineRegister(uint16_t _addr, uint8_t val, bool di
   }
   DeviceRegister* nu = new DeviceRegister(_addr, val, buffer, dirty, unread, writable);
   reg_defs.insert(nu);
+  _index_register(nu);
   return true;
 }
 
@@ -76,6 +82,7 @@ bool I2CDeviceWithRegisters::defineRegister(uint16_t _addr, uint16_t val, bool d
   }
   DeviceRegister *nu = new DeviceRegister(_addr, val, buffer, dirty, unread, writable);
   reg_defs.insert(nu);
+  _index_register(nu);
   return true;
 }
 
@@ -87,19 +94,42 @@ bool I2CDeviceWithRegisters::defineRegister(uint16_t _addr, uint32_t val, bool d
   }
   DeviceRegister *nu = new DeviceRegister(_addr, val, buffer, dirty, unread, writable);
   reg_defs.insert(nu);
+  _index_register(nu);
   return true;
 }
 
 
+/*
+* Records the position of a freshly-defined register so that it can be found
+*   by address without a search. The index grows to the highest address
+*   defined. Registers at or above I2CDEVICE_REG_INDEX_MAX are left out, and
+*   will be found the slow way.
+*/
+void I2CDeviceWithRegisters::_index_register(DeviceRegister* nu) {
+  if (nu->addr >= I2CDEVICE_REG_INDEX_MAX) return;
+  if (nu->addr >= _reg_index_len) {
+    uint16_t nu_len = nu->addr + 1;
+    uint8_t* nu_idx = (uint8_t*) realloc(_reg_index, nu_len);
+    if (nullptr == nu_idx) return;
+    memset(nu_idx + _reg_index_len, 0, nu_len - _reg_index_len);
+    _reg_index     = nu_idx;
+    _reg_index_len = nu_len;
+  }
+  _reg_index[nu->addr] = (uint8_t) reg_defs.count();  // Position + 1.
+}
+
+
 DeviceRegister* I2CDeviceWithRegisters::getRegisterByBaseAddress(int b_addr) {
-  int i = 0;
-  DeviceRegister *nu = reg_defs.get(0);
-  while (nu) {
+  if ((b_addr >= 0) && (b_addr < _reg_index_len)) {
+    const uint8_t pos = _reg_index[b_addr];
+    return (pos) ? reg_defs.get(pos - 1) : nullptr;
+  }
+  const unsigned int count = reg_defs.count();
+  for (unsigned int i = 0; i < count; i++) {
+    DeviceRegister* nu = reg_defs.get(i);
     if (nu->addr == b_addr) {
       return nu;
     }
-    i++;
-    nu = reg_defs.get(i);
   }
   return nullptr;
 }
@@ -198,18 +228,50 @@ int8_t I2CDeviceWithRegisters::writeRegister(DeviceRegister *reg) {
   if (!reg->writable) {
     return I2C_ERR_SLAVE_REG_IS_RO;
   }
+  if (reg->op_pending) {
+    return I2C_ERR_SLAVE_NO_ERROR;
+  }
+  return writeRegisters(reg, reg->len);
+}
+
 
-  if (!reg->op_pending && !writeX(reg->addr, reg->len, (uint8_t*) reg->val)) {
+/**
+* Writes a run of contiguous registers in a single bus operation. The run
+*   begins with the given register, and the device must auto-increment if len
+*   is greater than the register's own length.
+* The registers are marked pending before the op is queued, since the bus
+*   might complete it before we return.
+*
+* @param reg The first register in the run.
+* @param len The number of bytes to write.
+* @return 0 on success. i2c error code on failure.
+*/
+int8_t I2CDeviceWithRegisters::writeRegisters(DeviceRegister *reg, uint16_t len) {
+  _mark_pending(reg, len, true);
+  if (!writeX(reg->addr, len, (uint8_t*) reg->val)) {
+    _mark_pending(reg, len, false);
     #ifdef MANUVR_DEBUG
     Kernel::log("Bus error while writing device.\n");
     #endif
     return I2C_ERR_SLAVE_BUS_FAULT;
   }
-  reg->op_pending = true;
   return I2C_ERR_SLAVE_NO_ERROR;
 }
 
 
+/*
+* Sets or clears op_pending on each register in a run.
+*/
+void I2CDeviceWithRegisters::_mark_pending(DeviceRegister* reg, uint16_t len, bool pending) {
+  uint16_t covered = 0;
+  while ((nullptr != reg) && (covered < len)) {
+    reg->op_pending = pending;
+    covered += reg->len;
+    reg = getRegisterByBaseAddress(reg->addr + reg->len);
+  }
+}
+
+
 /**
 * Read a register at the given base address.
 *
@@ -224,7 +286,20 @@ int8_t I2CDeviceWithRegisters::readRegister(DeviceRegister* reg) {
   if (reg == nullptr) {
     return I2C_ERR_SLAVE_UNDEFD_REG;
   }
-  if (!readX(reg->addr, reg->len, (uint8_t*) reg->val)) {
+  return readRegisters(reg, reg->len);
+}
+
+/**
+* Reads a run of contiguous registers in a single bus operation. The run
+*   begins with the given register, and the device must auto-increment if len
+*   is greater than the register's own length.
+*
+* @param reg The first register in the run.
+* @param len The number of bytes to read.
+* @return 0 on success. i2c error code on failure.
+*/
+int8_t I2CDeviceWithRegisters::readRegisters(DeviceRegister* reg, uint8_t len) {
+  if (!readX(reg->addr, len, (uint8_t*) reg->val)) {
     #ifdef MANUVR_DEBUG
     Kernel::log("Bus error while reading device.\n");
     #endif
@@ -281,19 +356,23 @@ int8_t I2CDeviceWithRegisters::syncRegisters() {
   DeviceRegister *temp = nullptr;
   int8_t return_value = I2C_ERR_SLAVE_NO_ERROR;
   unsigned int count = reg_defs.count();
-  for (unsigned int i = 0; i < count; i++) {
+  unsigned int i = 0;
+  while (i < count) {
+    uint16_t len = 0;
+    unsigned int run = _burst_extent(i, false, &len);
     temp = reg_defs.get(i);
     if (temp) {   // Safety-check that an out-of-bounds reg wasn't in the list...
-      return_value = readRegister(temp);
-      #ifdef MANUVR_DEBUG
-      if (return_value != I2C_ERR_SLAVE_NO_ERROR) {
+      int8_t ret = readRegisters(temp, (uint8_t) len);
+      if (ret != I2C_ERR_SLAVE_NO_ERROR) {
+        #ifdef MANUVR_DEBUG
         StringBuilder output;
         output.concatf("Failed to read from register %d\n", temp->addr);
         Kernel::log(&output);
+        #endif
+        if (I2C_ERR_SLAVE_NO_ERROR == return_value) return_value = ret;
       }
-      #endif
     }
-    return_value = I2C_ERR_SLAVE_UNDEFD_REG;
+    i += run;
   }
   return return_value;
 }
@@ -328,11 +407,17 @@ int8_t I2CDeviceWithRegisters::writeDirtyRegisters() {
   int8_t return_value = I2C_ERR_SLAVE_NO_ERROR;
   DeviceRegister *temp = nullptr;
   unsigned int count = reg_defs.count();
-  for (unsigned int i = 0; i < count; i++) {
+  unsigned int i = 0;
+  while (i < count) {
+    unsigned int run = 1;
     temp = reg_defs.get(i);
     if (temp->dirty) {
       if (temp->writable) {
-        return_value = writeRegister(temp);
+        if (!temp->op_pending) {
+          uint16_t len = 0;
+          run = _burst_extent(i, true, &len);
+          return_value = writeRegisters(temp, len);
+        }
         if (return_value != I2C_ERR_SLAVE_NO_ERROR) {
           #ifdef MANUVR_DEBUG
           StringBuilder output;
@@ -350,11 +435,50 @@ int8_t I2CDeviceWithRegisters::writeDirtyRegisters() {
         #endif
       }
     }
+    i += run;
   }
   return return_value;
 }
 
 
+/**
+* Finds the run of registers that can be moved in one bus operation, starting
+*   with the register at position i in reg_defs. A run is a sequence of
+*   definitions that are adjacent both in the device's address space and in
+*   _pooled_reg_mem. Devices that don't auto-increment get runs of one.
+*
+* @param i          The position of the first register in reg_defs.
+* @param for_write  If true, the run will only extend over writable registers
+*                     that are dirty and have no pending i/o.
+* @param len        The number of bytes in the run is written here.
+* @return the number of registers in the run.
+*/
+unsigned int I2CDeviceWithRegisters::_burst_extent(unsigned int i, bool for_write, uint16_t* len) {
+  DeviceRegister* prev = reg_defs.get(i);
+  unsigned int run = 1;
+  *len = prev->len;
+  if (multi_access_support) {
+    const unsigned int count = reg_defs.count();
+    while ((i + run) < count) {
+      DeviceRegister* nxt = reg_defs.get(i + run);
+      if ((nxt->addr != (prev->addr + prev->len)) || (nxt->val != (prev->val + prev->len))) {
+        break;
+      }
+      if ((*len + nxt->len) > I2CDEVICE_MAX_BURST_LEN) {
+        break;
+      }
+      if (for_write && !(nxt->dirty && nxt->writable && !nxt->op_pending)) {
+        break;
+      }
+      *len += nxt->len;
+      prev = nxt;
+      run++;
+    }
+  }
+  return run;
+}
+
+
 /*******************************************************************************
 * ___     _       _                      These members are mandatory overrides
 *  |   / / \ o   | \  _     o  _  _      for implementing I/O callbacks. They
@@ -367,40 +491,48 @@ int8_t I2CDeviceWithRegisters::io_op_callahead(BusOp* op) {
 }
 
 
+/**
+* The op may have covered a run of registers. Each of them is handled in turn,
+*   in address order.
+*/
 int8_t I2CDeviceWithRegisters::io_op_callback(BusOp* _op) {
   int8_t return_value = -1;
   I2CBusOp* completed = (I2CBusOp*) _op;
 
   if (completed) {
     DeviceRegister* reg = getRegisterByBaseAddress(completed->sub_addr);
-    reg->op_pending = false;
-    if (!completed->hasFault()) {
-      if (reg) {
-        switch (completed->get_opcode()) {
-          case BusOpcode::RX:
+    if (nullptr == reg) {
+      #ifdef MANUVR_DEBUG
+      Kernel::log("I2CDeviceWithRegisters::io_op_callback(): register lookup failed.\n");
+      #endif
+    }
+    else if (completed->hasFault()) {
+      #ifdef MANUVR_DEBUG
+      Kernel::log("I2CDeviceWithRegisters::io_op_callback(): i2c operation errored.\n");
+      #endif
+    }
+    uint16_t covered = 0;
+    while ((nullptr != reg) && (covered < completed->buf_len)) {
+      switch (completed->get_opcode()) {
+        case BusOpcode::RX:
+          if (!completed->hasFault()) {
             reg->unread = true;
             return_value = register_read_cb(reg);
-            break;
-          case BusOpcode::TX:
+          }
+          break;
+        case BusOpcode::TX:
+          reg->op_pending = false;
+          if (!completed->hasFault()) {
             reg->dirty = false;
             return_value = register_write_cb(reg);
-            break;
-          case BusOpcode::TX_CMD:
-            break;
-          default:
-            break;
-        }
-      }
-      else {
-        #ifdef MANUVR_DEBUG
-        Kernel::log("I2CDeviceWithRegisters::io_op_callback(): register lookup failed.\n");
-        #endif
+          }
+          break;
+        case BusOpcode::TX_CMD:
+        default:
+          break;
       }
-    }
-    else {
-      #ifdef MANUVR_DEBUG
-      Kernel::log("I2CDeviceWithRegisters::io_op_callback(): i2c operation errored.\n");
-      #endif
+      covered += reg->len;
+      reg = getRegisterByBaseAddress(reg->addr + reg->len);
     }
     /* Null the buffer so the bus adapter isn't tempted to free it.
       TODO: This is silly. Fix this in the API. */
@@ -181,29 +181,42 @@ int8_t SPIAdapter::queue_io_job(BusOp* _op) {
       return -4;
     }
 
-    if ((nullptr == current_job) && (work_queue.size() == 0)){
-      // If the queue is empty, fire the operation now.
-      current_job = op;
-      advance_work_queue();
-      //if (bus_timeout_millis) event_spi_timeout.delaySchedule(bus_timeout_millis);  // Punch the timeout schedule.
+    if ((op == current_job) || work_queue.contains(op)) {
+      if (getVerbosity() > 2) {
+        local_log.concat("SPIAdapter::queue_io_job(): \t Double-insertion. Dropping transaction with no status change.\n");
+        op->printDebug(&local_log);
+        Kernel::log(&local_log);
+      }
+      return -3;
+    }
+
+    if (current_job && _er_flag(SPI_FLAG_QUEUE_GUARD) && (CONFIG_SPIADAPTER_MAX_QUEUE_DEPTH <= work_queue.size())) {
+      if (getVerbosity() > 3) Kernel::log("SPIAdapter::queue_io_job(): \t Bus queue at max size. Dropping transaction.\n");
+      _queue_floods++;
+      op->abort(XferFault::QUEUE_FLUSH);
+      callback_queue.insertIfAbsent(op);
+      if (callback_queue.size() == 1) Kernel::staticRaiseEvent(&event_spi_callback_ready);
+      return -1;
     }
-    else {    // If there is something already in progress, queue up.
-      if (_er_flag(SPI_FLAG_QUEUE_GUARD) && (CONFIG_SPIADAPTER_MAX_QUEUE_DEPTH <= work_queue.size())) {
-        if (getVerbosity() > 3) Kernel::log("SPIAdapter::queue_io_job(): \t Bus queue at max size. Dropping transaction.\n");
+
+    switch (enqueue_op(op)) {
+      case 0:
+        break;
+      case 1:    // A read of the same thing is already waiting. Ours is redundant.
+        reclaim_queue_item(op);
+        return 0;
+      default:   // Refused. Fail it back to the requester, as for a flood.
+        _queue_floods++;
         op->abort(XferFault::QUEUE_FLUSH);
         callback_queue.insertIfAbsent(op);
         if (callback_queue.size() == 1) Kernel::staticRaiseEvent(&event_spi_callback_ready);
         return -1;
-      }
+    }
 
-      if (0 > work_queue.insertIfAbsent(op)) {
-        if (getVerbosity() > 2) {
-          local_log.concat("SPIAdapter::queue_io_job(): \t Double-insertion. Dropping transaction with no status change.\n");
-          op->printDebug(&local_log);
-          Kernel::log(&local_log);
-        }
-        return -3;
-      }
+    if (nullptr == current_job) {
+      // If the bus is idle, fire the next operation now.
+      advance_work_queue();
+      //if (bus_timeout_millis) event_spi_timeout.delaySchedule(bus_timeout_millis);  // Punch the timeout schedule.
     }
     return 0;
   }
@@ -236,104 +249,147 @@ int8_t SPIAdapter::queue_io_job(BusOp* _op) {
 */
 int8_t SPIAdapter::advance_work_queue() {
   int8_t return_value = 0;
+  bool recycle = true;
 
   timeout_punch = false;
-  if (current_job) {
-    switch (current_job->get_state()) {
-       case XferState::TX_WAIT:
-       case XferState::RX_WAIT:
-         if (current_job->hasFault()) {
-           if (getVerbosity() > 3) local_log.concat("SPIAdapter::advance_work_queue():\t Failed at IO_WAIT.\n");
-         }
-         else {
-           current_job->markComplete();
-         }
-         // NOTE: No break on purpose.
-       case XferState::COMPLETE:
-         callback_queue.insert(current_job);
-         current_job = nullptr;
-         if (callback_queue.size() == 1) {
-           Kernel::staticRaiseEvent(&event_spi_callback_ready);
-         }
-         break;
-
-       case XferState::IDLE:
-       case XferState::INITIATE:
-         switch (current_job->begin()) {
-           case XferFault::NONE:     // Nominal outcome. Transfer started with no problens...
-             break;
-           case XferFault::BUS_BUSY:    // Bus appears to be in-use. State did not change.
-             // Re-throw queue_ready event and try again later.
-             if (getVerbosity() > 2) local_log.concat("  advance_work_queue() tried to clobber an existing transfer on chain.\n");
-             //Kernel::staticRaiseEvent(&event_spi_queue_ready);  // Bypass our method. Jump right to the target.
-             break;
-           default:    // Began the transfer, and it barffed... was aborted.
-             if (getVerbosity() > 3) local_log.concat("SPIAdapter::advance_work_queue():\t Failed to begin transfer after starting.\n");
-             callback_queue.insert(current_job);
-             current_job = nullptr;
-             if (callback_queue.size() == 1) Kernel::staticRaiseEvent(&event_spi_callback_ready);
-             break;
-         }
-         break;
-
-       /* Cases below ought to be handled by ISR flow... */
-       case XferState::ADDR:
-         current_job->advance_operation(0, 0);
-       case XferState::STOP:
-         if (getVerbosity() > 5) local_log.concatf("State might be corrupted if we tried to advance_queue(). \n");
-         break;
-       default:
-         if (getVerbosity() > 3) local_log.concatf("advance_work_queue() default state \n");
-         break;
+  while (recycle) {
+    recycle = false;
+    if (current_job) {
+      switch (current_job->get_state()) {
+         case XferState::TX_WAIT:
+         case XferState::RX_WAIT:
+           if (current_job->hasFault()) {
+             if (getVerbosity() > 3) local_log.concat("SPIAdapter::advance_work_queue():\t Failed at IO_WAIT.\n");
+           }
+           else {
+             current_job->markComplete();
+           }
+           // NOTE: No break on purpose.
+         case XferState::COMPLETE:
+           retire_op(current_job);
+           callback_queue.insert(current_job);
+           current_job = nullptr;
+           if (callback_queue.size() == 1) {
+             Kernel::staticRaiseEvent(&event_spi_callback_ready);
+           }
+           break;
+
+         case XferState::IDLE:
+         case XferState::INITIATE:
+           switch (current_job->begin()) {
+             case XferFault::NONE:     // Nominal outcome. Transfer started with no problens...
+               break;
+             case XferFault::BUS_BUSY:    // Bus appears to be in-use. State did not change.
+               // Re-throw queue_ready event and try again later.
+               if (getVerbosity() > 2) local_log.concat("  advance_work_queue() tried to clobber an existing transfer on chain.\n");
+               //Kernel::staticRaiseEvent(&event_spi_queue_ready);  // Bypass our method. Jump right to the target.
+               break;
+             default:    // Began the transfer, and it barffed... was aborted.
+               if (getVerbosity() > 3) local_log.concat("SPIAdapter::advance_work_queue():\t Failed to begin transfer after starting.\n");
+               retire_op(current_job);
+               callback_queue.insert(current_job);
+               current_job = nullptr;
+               if (callback_queue.size() == 1) Kernel::staticRaiseEvent(&event_spi_callback_ready);
+               break;
+           }
+           break;
+
+         /* Cases below ought to be handled by ISR flow... */
+         case XferState::ADDR:
+           current_job->advance_operation(0, 0);
+         case XferState::STOP:
+           if (getVerbosity() > 5) local_log.concatf("State might be corrupted if we tried to advance_queue(). \n");
+           break;
+         default:
+           if (getVerbosity() > 3) local_log.concatf("advance_work_queue() default state \n");
+           break;
+      }
     }
-  }
 
 
-  if (nullptr == current_job) {
-    current_job = work_queue.dequeue();
-    // Begin the bus operation.
-    if (current_job) {
-      if (XferFault::NONE != current_job->begin()) {
-        if (getVerbosity() > 2) local_log.concatf("advance_work_queue() tried to clobber an existing transfer on the pick-up.\n");
-        Kernel::staticRaiseEvent(&SPIBusOp::event_spi_queue_ready);  // Bypass our method. Jump right to the target.
+    if (nullptr == current_job) {
+      // Ops that were already handed to the platform go first. They have been
+      //   begun, and may have finished while they waited.
+      current_job = _in_flight.dequeue();
+      if (current_job) {
+        recycle = current_job->isComplete();
+        return_value++;
+      }
+      else {
+        current_job = dequeue_op();
+        // Begin the bus operation.
+        if (current_job) {
+          if (XferFault::NONE != current_job->begin()) {
+            if (getVerbosity() > 2) local_log.concatf("advance_work_queue() tried to clobber an existing transfer on the pick-up.\n");
+            Kernel::staticRaiseEvent(&SPIBusOp::event_spi_queue_ready);  // Bypass our method. Jump right to the target.
+          }
+          return_value++;
+        }
+        else {
+          // No Queue! Relax...
+          event_spi_timeout.enableSchedule(false);  // Punch the timeout schedule.
+        }
       }
-      return_value++;
-    }
-    else {
-      // No Queue! Relax...
-      event_spi_timeout.enableSchedule(false);  // Punch the timeout schedule.
     }
   }
+  _fill_in_flight();
 
   flushLocalLog();
   return return_value;
 }
 
 
+/**
+* Platforms that can keep more than one op in flight are handed queued work
+*   while the current job is still on the bus. Those ops complete in order,
+*   and are promoted to current_job in turn.
+*/
+void SPIAdapter::_fill_in_flight() {
+  #if (CONFIG_SPIADAPTER_MAX_IN_FLIGHT > 1)
+  if (current_job && current_job->has_bus_control() && busOnline()) {
+    while (_in_flight.size() < (CONFIG_SPIADAPTER_MAX_IN_FLIGHT - 1)) {
+      SPIBusOp* nxt = dequeue_op();
+      if (nullptr == nxt) break;
+      _in_flight.insert(nxt);
+      nxt->begin();   // A failure here is handled when the op is promoted.
+    }
+  }
+  #endif
+}
+
+
+/**
+* Two reads with the same buffer are only the same read if they send the same
+*   transfer parameters (typically, the register address).
+*/
+bool SPIAdapter::same_read(SPIBusOp* waiting, SPIBusOp* nu) {
+  if (waiting->transferParamLength() != nu->transferParamLength()) return false;
+  for (uint8_t i = 0; i < nu->transferParamLength(); i++) {
+    if (waiting->getTransferParam(i) != nu->getTransferParam(i)) return false;
+  }
+  return true;
+}
+
+
 /**
 * Purges only the jobs belonging to the given device from the work_queue.
-* Leaves the currently-executing job.
+* Leaves the currently-executing job. The device is presumed to be leaving the
+*   bus, so its scheduling lane is released.
 *
 * @param  dev  The device pointer that owns jobs we wish purged.
 */
 void SPIAdapter::purge_queued_work_by_dev(BusOpCallback* dev) {
   if (NULL == dev) return;
 
-  if (work_queue.size() > 0) {
-    SPIBusOp* current = nullptr;
-    int i = 0;
-    while (i < work_queue.size()) {
-      current = work_queue.get(i);
-      if (current->callback == dev) {
-        current->abort(XferFault::QUEUE_FLUSH);
-        work_queue.remove(current);
-        reclaim_queue_item(current);
-      }
-      else {
-        i++;
-      }
+  for (PriorityIterator<SPIBusOp*> it = work_queue.begin(); it != work_queue.end(); ++it) {
+    SPIBusOp* current = *it;
+    if (current->callback == dev) {
+      current->abort(XferFault::QUEUE_FLUSH);
+      work_queue.remove(it);
+      reclaim_queue_item(current);
     }
   }
+  release_lane(dev);
   // Lastly... initiate the next bus transfer if the bus is not sideways.
   advance_work_queue();
 }
@@ -423,10 +479,10 @@ void SPIAdapter::reclaim_queue_item(SPIBusOp* op) {
 */
 int8_t SPIAdapter::service_callback_queue() {
   int8_t return_value = 0;
-  SPIBusOp* temp_op = callback_queue.dequeue();
+  SPIBusOp* temp_op = nullptr;
 
-  while ((nullptr != temp_op) && (return_value < spi_cb_per_event)) {
-  //if (nullptr != temp_op) {
+  // Check the limit first, so that we never dequeue an op we won't service.
+  while ((return_value < spi_cb_per_event) && (nullptr != (temp_op = callback_queue.dequeue()))) {
     if (getVerbosity() > 6) temp_op->printDebug(&local_log);
     if (temp_op->callback) {
       int8_t cb_code = temp_op->callback->io_op_callback(temp_op);
@@ -452,7 +508,6 @@ int8_t SPIAdapter::service_callback_queue() {
       reclaim_queue_item(temp_op);
     }
     return_value++;
-    temp_op = callback_queue.dequeue();
   }
 
   flushLocalLog();
@@ -540,6 +595,7 @@ void SPIAdapter::printDebug(StringBuilder *output) {
     output->concatf("-- spi_cb_per_event    %d\n--\n",   spi_cb_per_event);
   }
   printAdapter(output);
+  output->concatf("-- In flight           %d/%u\n", _in_flight.size(), CONFIG_SPIADAPTER_MAX_IN_FLIGHT - 1);
   output->concatf("-- callback q depth    %d\n\n", callback_queue.size());
 
   if (getVerbosity() > 3) {
@@ -41,6 +41,14 @@ limitations under the License.
   // How many queue items should we have on-tap?
   #define CONFIG_SPIADAPTER_PREALLOC_COUNT  4
 #endif
+#ifndef CONFIG_SPIADAPTER_MAX_IN_FLIGHT
+  // How many ops may be handed to the platform at once (including current_job)?
+  #if defined(__MANUVR_LINUX)
+    #define CONFIG_SPIADAPTER_MAX_IN_FLIGHT 8
+  #else
+    #define CONFIG_SPIADAPTER_MAX_IN_FLIGHT 1
+  #endif
+#endif
 
 
 #define MANUVR_MSG_SPI_QUEUE_READY      0x0230 // There is a new job in the SPI bus queue.
@@ -134,6 +142,10 @@ class SPIAdapter : public EventReceiver, public BusAdapter<SPIBusOp> {
     int8_t callback_proc(ManuvrMsg*);
     void printHardwareState(StringBuilder*);
 
+    inline uint8_t getAdapterId() {  return _opts.idx;                      };
+    inline bool    busOnline() {     return _er_flag(SPI_FLAG_SPI_READY);   };
+    inline void    busOnline(bool nu) {  _er_set_flag(SPI_FLAG_SPI_READY, nu);  };
+
   protected:
     int8_t attached();      // This is called from the base notify().
 
@@ -144,6 +156,7 @@ class SPIAdapter : public EventReceiver, public BusAdapter<SPIBusOp> {
 
     /* List of pending callbacks for bus transactions. */
     PriorityQueue<SPIBusOp*> callback_queue;
+    PriorityQueue<SPIBusOp*> _in_flight;    // Begun, and waiting behind current_job.
     uint32_t  bus_timeout_millis = 5;  // How long to spend in IO_WAIT?
     uint8_t   spi_cb_per_event   = 3;  // Limit the number of callbacks processed per event.
 
@@ -151,10 +164,12 @@ class SPIAdapter : public EventReceiver, public BusAdapter<SPIBusOp> {
     void purge_current_job();     // Purges the active job.
     int8_t service_callback_queue();
     void reclaim_queue_item(SPIBusOp*);
+    void _fill_in_flight();
 
     /* Overrides from the BusAdapter interface */
     int8_t bus_init();
     int8_t bus_deinit();
+    bool   same_read(SPIBusOp*, SPIBusOp*);
 
     static SPIBusOp preallocated_bus_jobs[CONFIG_SPIADAPTER_PREALLOC_COUNT];// __attribute__ ((section(".ccm")));
 };
@@ -86,7 +86,8 @@ class SPIBusOp : public BusOp {
     inline uint8_t getTransferParam(int x) {  return xfer_params[x]; };
     inline uint8_t transferParamLength() {    return _param_len;     };
 
-    inline void setCSPin(uint8_t pin) {   _cs_pin = pin;  };
+    inline void    setCSPin(uint8_t pin) {   _cs_pin = pin;  };
+    inline uint8_t getCSPin() {              return _cs_pin; };
 
     /* Flag management fxns... */
     bool shouldReap(bool);    // Override to set the reap behavior.
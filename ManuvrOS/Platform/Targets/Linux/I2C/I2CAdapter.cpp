@@ -1,4 +1,4 @@
-#include <Platform/Peripherals/I2C/I2CAdapter.h>
+#include <Platform/Targets/Linux/I2C/LinuxI2C.h>
 
 #if defined(MANUVR_SUPPORT_I2C)
 #include <stdlib.h>
@@ -7,83 +7,298 @@
 #include <sys/types.h>
 #include <sys/ioctl.h>
 #include <sys/stat.h>
-#include <fstream>
-#include <iostream>
 #include <fcntl.h>
 #include <inttypes.h>
 #include <ctype.h>
+#include <time.h>
 
 
-int open_bus_handle = -1;        //TODO: This is a hack. Re-work it.
-int8_t  last_used_bus_addr = 0;  //TODO: This is a hack. Re-work it.
+/*******************************************************************************
+* Linux bus state and the worker thread                                        *
+*******************************************************************************/
+
+LinuxI2CBus LinuxI2CBus::_buses[I2C_LINUX_MAX_ADAPTERS];
+
+
+LinuxI2CBus::LinuxI2CBus() {
+  pthread_mutex_init(&_mutex, nullptr);
+  pthread_cond_init(&_cond, nullptr);
+  pthread_cond_init(&_done, nullptr);
+}
+
 
+/**
+* @param  adapter_id  The bus number.
+* @return the state for the given bus, or nullptr if it is out of range.
+*/
+LinuxI2CBus* LinuxI2CBus::bus(int8_t adapter_id) {
+  if ((adapter_id >= 0) && (adapter_id < I2C_LINUX_MAX_ADAPTERS)) {
+    return &_buses[adapter_id];
+  }
+  return nullptr;
+}
 
-I2CBusOp* _threaded_op = nullptr;
 
-void* i2c_worker_thread(void* arg) {
-  //I2CAdapter* adapter = (I2CAdapter*) arg;
+/*
+* The worker waits for ops to be handed over, and moves whatever is waiting
+*   as a single batch.
+*/
+void* LinuxI2CBus::worker(void* arg) {
+  LinuxI2CBus* b = (LinuxI2CBus*) arg;
+  I2CBusOp* ops[I2C_LINUX_MAX_BATCH];
   while (!platform.nominalState()) {
     sleep_millis(80);
   }
+  pthread_mutex_lock(&b->_mutex);
   while (platform.nominalState()) {
-    if (_threaded_op) {
-      _threaded_op->advance(0);
-      _threaded_op = nullptr;
-      yieldThread();
-    }
-    else {
-      suspendThread();
+    if (0 == b->_count) {
+      // Wake periodically to notice platform shutdown.
+      struct timespec ts;
+      clock_gettime(CLOCK_REALTIME, &ts);
+      ts.tv_nsec += 100000000;
+      if (ts.tv_nsec >= 1000000000) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000;
+      }
+      pthread_cond_timedwait(&b->_cond, &b->_mutex, &ts);
+      continue;
     }
+    const uint8_t max = strict_min((uint8_t) I2C_LINUX_MAX_BATCH, b->maxBatch);
+    b->_batch_len = b->_take(ops, (max > 0) ? max : 1);
+    b->_batch     = ops;
+    pthread_mutex_unlock(&b->_mutex);
+    b->runBatch(ops, b->_batch_len);
+    pthread_mutex_lock(&b->_mutex);
+    b->_batch     = nullptr;
+    b->_batch_len = 0;
+    pthread_cond_broadcast(&b->_done);
   }
+  pthread_mutex_unlock(&b->_mutex);
   return nullptr;
 }
 
 
-/*
-* Private function that will switch the addressed i2c device via ioctl. This
-*   function is meaningless on anything but a linux system, in which case it
-*   will always return true;
-* On a linux system, this will only return true if the ioctl call succeeded.
+/**
+* Opens the bus and starts its worker.
+*
+* @param  a  The adapter that owns the bus.
+* @return 0 on success, -1 if the device file couldn't be opened, -2 if the
+*           thread couldn't be started.
 */
-bool switch_device(I2CAdapter* adapter, uint8_t nu_addr) {
-  bool return_value = false;
-  unsigned short timeout = 10000;
-  if (nu_addr != last_used_bus_addr) {
-    if (open_bus_handle < 0) {
-      // If the bus is either uninitiallized or not idle, decline
-      // to switch the device. Return false;
-      #ifdef MANUVR_DEBUG
-      Kernel::log("i2c bus is not online, so won't switch device. Failing....\n");
-      #endif
-      return return_value;
+int8_t LinuxI2CBus::open(I2CAdapter* a) {
+  adapter = a;
+  if (nullptr == fake) {
+    char filename[24];
+    snprintf(filename, sizeof(filename), "/dev/i2c-%d", a->getAdapterId());
+    handle = ::open(filename, O_RDWR);
+    if (handle < 0) {
+      return -1;
     }
-    else {
-      while (adapter->busError() && (timeout > 0)) { timeout--; }
-      if (adapter->busError()) {
-        #ifdef MANUVR_DEBUG
-        Kernel::log("i2c bus was held for too long. Failing....\n");
-        #endif
-        return return_value;
+  }
+  if (!_threaded) {
+    ManuvrThreadOptions _t_opts;
+    _t_opts.thread_name = (char*) "i2c_worker";
+    _t_opts.stack_sz    = 8192;
+    if (0 != createThread(&_thread_id, nullptr, worker, (void*) this, &_t_opts)) {
+      close();
+      return -2;
+    }
+    _threaded = true;
+  }
+  return 0;
+}
+
+
+void LinuxI2CBus::close() {
+  if (handle >= 0) {
+    ::close(handle);
+    handle = -1;
+  }
+}
+
+
+/**
+* Hands an op to the worker. Called from the Kernel's thread.
+*
+* @param  op  The op. Belongs to the worker until it is marked complete.
+* @return 0 on success, -1 if the ring is full.
+*/
+int8_t LinuxI2CBus::submit(I2CBusOp* op) {
+  int8_t ret = -1;
+  pthread_mutex_lock(&_mutex);
+  if (_count < I2C_LINUX_RING_SIZE) {
+    _ring[(_r + _count) % I2C_LINUX_RING_SIZE] = op;
+    _count++;
+    pthread_cond_signal(&_cond);
+    ret = 0;
+  }
+  pthread_mutex_unlock(&_mutex);
+  return ret;
+}
+
+
+/**
+* Takes an op back from the worker. Called from the Kernel's thread.
+* If the worker hasn't gotten to the op yet, it is taken out of the ring, and
+*   will never touch the bus. Otherwise, this blocks until the worker is done
+*   with it. Either way, the op is ours once this returns.
+*
+* @param  op  The op.
+* @return true if the op was taken back before it ran.
+*/
+bool LinuxI2CBus::recall(I2CBusOp* op) {
+  bool ret = false;
+  pthread_mutex_lock(&_mutex);
+  for (uint8_t i = 0; i < _count; i++) {
+    if (op == _ring[(_r + i) % I2C_LINUX_RING_SIZE]) {
+      // Close the gap, keeping the others in order.
+      for (uint8_t j = i + 1; j < _count; j++) {
+        _ring[(_r + j - 1) % I2C_LINUX_RING_SIZE] = _ring[(_r + j) % I2C_LINUX_RING_SIZE];
       }
+      _count--;
+      ret = true;
+      break;
+    }
+  }
+  if (!ret) {
+    bool running = true;
+    while (running) {
+      running = false;
+      for (int i = 0; i < _batch_len; i++) {
+        if (op == _batch[i]) running = true;
+      }
+      if (running) pthread_cond_wait(&_done, &_mutex);
+    }
+  }
+  pthread_mutex_unlock(&_mutex);
+  return ret;
+}
+
 
-      if (ioctl(open_bus_handle, I2C_SLAVE, nu_addr) >= 0) {
-        last_used_bus_addr = nu_addr;
-        return_value = true;
+/*
+* Takes up to max ops from the ring. Caller must hold the mutex.
+*/
+int LinuxI2CBus::_take(I2CBusOp** ops, int max) {
+  int n = 0;
+  while ((n < max) && (_count > 0)) {
+    ops[n++] = _ring[_r];
+    _r = (_r + 1) % I2C_LINUX_RING_SIZE;
+    _count--;
+  }
+  return n;
+}
+
+
+int LinuxI2CBus::_transfer(struct i2c_msg* msgs, int count) {
+  _transfers++;
+  if (nullptr != fake) {
+    return fake->transfer(msgs, count);
+  }
+  struct i2c_rdwr_ioctl_data xfer;
+  xfer.msgs  = msgs;
+  xfer.nmsgs = (uint32_t) count;
+  return ioctl(handle, I2C_RDWR, &xfer);
+}
+
+
+/**
+* Moves the given ops on the bus, as few transfers as possible. Each op is
+*   marked complete (or failed) in order, and must not be touched afterward.
+* Only consecutive ops for the same device share a transfer. If a transfer
+*   fails, all of its ops fail. See the notes in LinuxI2C.h.
+*
+* @param  ops    The ops, in the order they were submitted.
+* @param  count  How many.
+*/
+void LinuxI2CBus::runBatch(I2CBusOp** ops, int count) {
+  struct i2c_msg msgs[I2C_LINUX_MAX_BATCH * 2];
+  uint8_t scratch[I2C_LINUX_SCRATCH];
+  int i = 0;
+  while (i < count) {
+    const int first = i;
+    int      m      = 0;
+    uint16_t used   = 0;
+    uint8_t* heap   = nullptr;   // For a lone write too large for scratch.
+
+    while ((i < count) && ((i - first) < I2C_LINUX_MAX_BATCH)) {
+      I2CBusOp* op = ops[i];
+      const uint16_t addr = op->dev_addr;
+      if ((0 < m) && (addr != ops[first]->dev_addr)) break;   // Another device.
+      const bool     sub  = (op->sub_addr >= 0);
+      if (BusOpcode::RX == op->get_opcode()) {
+        if (sub) {
+          if (used >= I2C_LINUX_SCRATCH) break;
+          scratch[used] = (uint8_t) (op->sub_addr & 0x00FF);
+          msgs[m++] = { addr, 0, 1, &scratch[used++] };
+        }
+        msgs[m++] = { addr, I2C_M_RD, op->buf_len, op->buf };
+      }
+      else if (BusOpcode::TX == op->get_opcode()) {
+        if (sub) {
+          uint8_t* dest = nullptr;
+          if ((used + op->buf_len + 1) <= I2C_LINUX_SCRATCH) {
+            dest  = &scratch[used];
+            used += op->buf_len + 1;
+          }
+          else if (0 == m) {
+            dest = heap = (uint8_t*) malloc(op->buf_len + 1);
+            if (nullptr == dest) {
+              op->abort(XferFault::BUS_FAULT);
+              i++;
+              break;
+            }
+          }
+          if (nullptr == dest) break;   // Goes in the next transfer.
+          dest[0] = (uint8_t) (op->sub_addr & 0x00FF);
+          if (op->buf_len) memcpy(dest + 1, op->buf, op->buf_len);
+          msgs[m++] = { addr, 0, (uint16_t) (op->buf_len + 1), dest };
+        }
+        else {
+          msgs[m++] = { addr, 0, op->buf_len, op->buf };
+        }
+      }
+      else if (BusOpcode::TX_CMD == op->get_opcode()) {
+        if (used >= I2C_LINUX_SCRATCH) break;
+        scratch[used] = (uint8_t) (op->sub_addr & 0x00FF);
+        msgs[m++] = { addr, 0, 1, &scratch[used++] };
       }
       else {
-        #ifdef MANUVR_DEBUG
-        StringBuilder local_log;
-        local_log.concatf("Failed to acquire bus access and/or talk to slave at %d.\n", nu_addr);
-        Kernel::log(&local_log);
-        #endif
-        adapter->busError(true);
+        // Not something we can batch. Fail it in its place.
+        if (0 == m) {
+          op->abort(XferFault::BAD_PARAM);
+          i++;
+        }
+        break;
       }
+      i++;
     }
+    if (0 == m) continue;   // Only failed ops so far.
+
+    const int n = i - first;
+    _ops += n;
+    if (n > _deepest) _deepest = n;
+    if (m == _transfer(msgs, m)) {
+      for (int j = first; j < i; j++) ops[j]->markComplete();
+    }
+    else {
+      // Some of the batch may have happened. We can't know how much, so we
+      //   mustn't do any of it again.
+      _failed++;
+      for (int j = first; j < i; j++) ops[j]->abort(XferFault::BUS_FAULT);
+    }
+    if (nullptr != heap) free(heap);
   }
-  else {
-    return_value = true;
-  }
-  return return_value;
+}
+
+
+void LinuxI2CBus::printDebug(StringBuilder* output) {
+  output->concatf("-- Backend             %s\n", (nullptr != fake) ? "fake" : "i2c-dev");
+  pthread_mutex_lock(&_mutex);
+  output->concatf("-- Waiting for worker  %u\n", _count);
+  pthread_mutex_unlock(&_mutex);
+  output->concatf("-- Transfers/ops       %u/%u\n", _transfers, _ops);
+  output->concatf("-- Largest batch       %u (limit %u)\n", _deepest, maxBatch);
+  output->concatf("-- Batches failed      %u\n", _failed);
 }
 
 
@@ -95,28 +310,13 @@ bool switch_device(I2CAdapter* adapter, uint8_t nu_addr) {
 *******************************************************************************/
 
 int8_t I2CAdapter::bus_init() {
-  char *filename = (char *) alloca(24);
-  *filename = 0;
-  if (sprintf(filename, "/dev/i2c-%d", getAdapterId()) > 0) {
-    open_bus_handle = open(filename, O_RDWR);
-    if (open_bus_handle < 0) {
-      // TODO?
-      // http://stackoverflow.com/questions/15337799/configure-linux-i2c-speed
-      #ifdef MANUVR_DEBUG
-      if (getVerbosity() > 2) {
-        local_log.concatf("Failed to open the i2c bus represented by %s.\n", filename);
-        Kernel::log(&local_log);
-      }
-      #endif
-    }
-    else {
-      createThread(&_thread_id, nullptr, i2c_worker_thread, (void*) this, nullptr);
-      busOnline(true);
-    }
+  LinuxI2CBus* b = LinuxI2CBus::bus(getAdapterId());
+  if ((nullptr != b) && (0 == b->open(this))) {
+    busOnline(true);
   }
-  #if defined(MANUVR_DEBUG)
+  #ifdef MANUVR_DEBUG
   else if (getVerbosity() > 2) {
-    local_log.concatf("Somehow we failed to sprintf and build a filename to open i2c bus %d.\n", getAdapterId());
+    local_log.concatf("Failed to open i2c bus %d.\n", getAdapterId());
     Kernel::log(&local_log);
   }
   #endif
@@ -125,18 +325,35 @@ int8_t I2CAdapter::bus_init() {
 
 
 int8_t I2CAdapter::bus_deinit() {
-  if (open_bus_handle >= 0) {
+  LinuxI2CBus* b = LinuxI2CBus::bus(getAdapterId());
+  if ((nullptr != b) && (b->handle >= 0)) {
     #ifdef MANUVR_DEBUG
     Kernel::log("Closing the open i2c bus...\n");
     #endif
-    close(open_bus_handle);
+    b->close();
   }
+  busOnline(false);
   return 0;
 }
 
 
 void I2CAdapter::printHardwareState(StringBuilder* output) {
   output->concatf("-- I2C%d (%sline)\n", getAdapterId(), (_er_flag(I2C_BUS_FLAG_BUS_ONLINE)?"on":"OFF"));
+  LinuxI2CBus* b = LinuxI2CBus::bus(getAdapterId());
+  if (nullptr != b) {
+    b->printDebug(output);
+  }
+}
+
+
+/*
+* Takes an op back from the worker, so that it can be freed.
+*
+* @return true if the op was taken back before it ran.
+*/
+bool I2CAdapter::_recall(I2CBusOp* op) {
+  LinuxI2CBus* b = LinuxI2CBus::bus(getAdapterId());
+  return (nullptr != b) ? b->recall(op) : false;
 }
 
 
@@ -145,112 +362,60 @@ int8_t I2CAdapter::generateStart() {
   return busOnline() ? 0 : -1;
 }
 
-
 // TODO: Inline this.
 int8_t I2CAdapter::generateStop() {
   return busOnline() ? 0 : -1;
 }
 
 
-
 /*******************************************************************************
 * ___     _                              These members are mandatory overrides
 *  |   / / \ o     |  _  |_              from the BusOp class.
 * _|_ /  \_/ o   \_| (_) |_)
 *******************************************************************************/
 
+/*
+* Hands the op to the bus's worker thread.
+*/
 XferFault I2CBusOp::begin() {
-  if (nullptr == _threaded_op) {
-    if (device) {
-      switch (device->getAdapterId()) {
-        case 0:
-        case 1:
-          if ((nullptr == callback) || (0 == callback->io_op_callahead(this))) {
-            set_state(XferState::INITIATE);
-            _threaded_op = this;
-            device->wake();
-            return XferFault::NONE;
-          }
-          else {
-            abort(XferFault::IO_RECALL);
-          }
-          break;
-        default:
-          abort(XferFault::BAD_PARAM);
-          break;
+  if (device) {
+    LinuxI2CBus* b = LinuxI2CBus::bus(device->getAdapterId());
+    if ((nullptr != b) && b->online()) {
+      if ((nullptr == callback) || (0 == callback->io_op_callahead(this))) {
+        // Until it is marked complete, the op belongs to the worker.
+        set_state(XferState::ADDR);
+        if (0 == b->submit(this)) {
+          return XferFault::NONE;
+        }
+        abort(XferFault::BUS_BUSY);
+      }
+      else {
+        abort(XferFault::IO_RECALL);
       }
     }
     else {
-      abort(XferFault::DEV_NOT_FOUND);
+      abort(XferFault::BAD_PARAM);
     }
   }
   else {
-    abort(XferFault::BUS_BUSY);
+    abort(XferFault::DEV_NOT_FOUND);
   }
-
   return xfer_fault;
 }
 
 
 /*
-* Linux doesn't have a concept of interrupt, but we might call this
-*   from an I/O thread.
+* Linux doesn't have a concept of interrupt. This moves the op on the bus
+*   from the calling thread, bypassing the worker.
 */
 XferFault I2CBusOp::advance(uint32_t status_reg) {
-  xfer_state = XferState::ADDR;
-  if (device->generateStart()) {
-    // Failure to generate START condition.
-    abort(XferFault::BUS_BUSY);
-    return xfer_fault;
-  }
-
-  if (!switch_device(device, dev_addr)) {
+  LinuxI2CBus* b = (device) ? LinuxI2CBus::bus(device->getAdapterId()) : nullptr;
+  if ((nullptr == b) || !b->online()) {
     abort(XferFault::BUS_FAULT);
     return xfer_fault;
   }
-
-  if (opcode == BusOpcode::RX) {
-    uint8_t sa = (uint8_t) (sub_addr & 0x00FF);
-
-    if (write(open_bus_handle, &sa, 1) == 1) {
-      if (read(open_bus_handle, buf, buf_len) == buf_len) {
-        markComplete();
-      }
-      else {
-        abort(XferFault::BUS_FAULT);
-      }
-    }
-    else {
-      abort(XferFault::BUS_FAULT);
-    }
-  }
-  else if (opcode == BusOpcode::TX) {
-    uint8_t buffer[buf_len + 1];
-    buffer[0] = (uint8_t) (sub_addr & 0x00FF);
-
-    for (int i = 0; i < buf_len; i++) buffer[i + 1] = *(buf + i);
-
-    if (write(open_bus_handle, &buffer, buf_len+1) == buf_len+1) {
-      markComplete();
-    }
-    else {
-      abort(XferFault::BUS_FAULT);
-    }
-  }
-  else if (opcode == BusOpcode::TX_CMD) {
-    uint8_t buffer[buf_len + 1];
-    buffer[0] = (uint8_t) (sub_addr & 0x00FF);
-    if (write(open_bus_handle, &buffer, 1) == 1) {
-      markComplete();
-    }
-    else {
-      abort(XferFault::BUS_FAULT);
-    }
-  }
-  else {
-    abort(XferFault::BUS_FAULT);
-  }
-
+  I2CBusOp* op = this;
+  b->runBatch(&op, 1);
   return xfer_fault;
 }
 
@@ -0,0 +1,134 @@
+/*
+File:   I2CFakeBus.cpp
+Author: J. Ian Lindsay
+Date:   2026.10.18
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+An i2c bus in memory, for testing the linux i2c path without hardware.
+*/
+
+#include <Platform/Targets/Linux/I2C/LinuxI2C.h>
+
+#if defined(MANUVR_SUPPORT_I2C)
+#include <errno.h>
+
+
+I2CFakeBus::I2CFakeBus() {
+  memset(_devs, 0, sizeof(_devs));
+}
+
+
+I2CFakeBus::~I2CFakeBus() {
+  for (uint8_t i = 0; i < _dev_count; i++) {
+    free(_devs[i].mem);
+  }
+  _dev_count = 0;
+}
+
+
+/**
+* Adds a device with a zeroed register file.
+*
+* @param  addr  The device's bus address.
+* @param  len   The size of its register file.
+* @return 0 on success, -1 if the address is taken or there is no room.
+*/
+int8_t I2CFakeBus::addDevice(uint8_t addr, uint16_t len) {
+  if ((nullptr != _find(addr)) || (_dev_count >= I2C_FAKE_MAX_DEVICES) || (0 == len)) {
+    return -1;
+  }
+  uint8_t* mem = (uint8_t*) malloc(len);
+  if (nullptr == mem) return -1;
+  memset(mem, 0, len);
+  _devs[_dev_count].mem  = mem;
+  _devs[_dev_count].len  = len;
+  _devs[_dev_count].ptr  = 0;
+  _devs[_dev_count].addr = addr;
+  _dev_count++;
+  return 0;
+}
+
+
+/**
+* @param  addr  The device's bus address.
+* @return the device's register file, or nullptr if there is no such device.
+*/
+uint8_t* I2CFakeBus::registers(uint8_t addr) {
+  FakeI2CDevice* dev = _find(addr);
+  return (nullptr != dev) ? dev->mem : nullptr;
+}
+
+
+I2CFakeBus::FakeI2CDevice* I2CFakeBus::_find(uint8_t addr) {
+  for (uint8_t i = 0; i < _dev_count; i++) {
+    if (addr == _devs[i].addr) return &_devs[i];
+  }
+  return nullptr;
+}
+
+
+/**
+* Services a message array as the i2c-dev driver would. The first byte of a
+*   write sets the register pointer, and the rest are written from there.
+*   Reads come from the pointer. Either way, the pointer advances.
+* Like the driver, a message to an absent device stops the transfer with
+*   an error, though the messages before it have taken effect.
+*
+* @param  msgs   The messages.
+* @param  count  How many.
+* @return the number of messages transferred, or -1 with errno set.
+*/
+int I2CFakeBus::transfer(struct i2c_msg* msgs, int count) {
+  if (transferCost) {
+    const uint32_t t0 = (uint32_t) micros();
+    while (((uint32_t) micros() - t0) < transferCost) {}
+  }
+  _transfers++;
+  for (int i = 0; i < count; i++) {
+    FakeI2CDevice* dev = _find((uint8_t) msgs[i].addr);
+    if (nullptr == dev) {
+      errno = ENXIO;
+      return -1;
+    }
+    _messages++;
+    _bytes += msgs[i].len;
+    uint16_t n = 0;
+    if (msgs[i].flags & I2C_M_RD) {
+      for (; n < msgs[i].len; n++) {
+        msgs[i].buf[n] = dev->mem[dev->ptr];
+        dev->ptr = (dev->ptr + 1) % dev->len;
+      }
+    }
+    else if (msgs[i].len > 0) {
+      dev->ptr = msgs[i].buf[0] % dev->len;
+      for (n = 1; n < msgs[i].len; n++) {
+        dev->mem[dev->ptr] = msgs[i].buf[n];
+        dev->ptr = (dev->ptr + 1) % dev->len;
+      }
+    }
+  }
+  return count;
+}
+
+
+void I2CFakeBus::printDebug(StringBuilder* output) {
+  output->concatf("-- Fake i2c bus (%u devices)\n", _dev_count);
+  output->concatf("-- Transfers           %u\n", _transfers);
+  output->concatf("-- Messages/bytes      %u/%u\n", _messages, _bytes);
+}
+
+#endif  // MANUVR_SUPPORT_I2C
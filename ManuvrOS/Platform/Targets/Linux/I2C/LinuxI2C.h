@@ -0,0 +1,149 @@
+/*
+File:   LinuxI2C.h
+Author: J. Ian Lindsay
+Date:   2026.10.18
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+The linux side of the i2c adapter.
+
+Each open bus has a worker thread. The Kernel hands it ops through a ring,
+  and the worker takes as many as are waiting (up to a limit). Consecutive
+  ops for the same device are moved in a single I2C_RDWR ioctl. A read with a
+  sub-address is sent as a write of the sub-address and a read, joined by a
+  repeated start.
+
+I2C_RDWR isn't atomic, and a failure doesn't say how far it got. The messages
+  ahead of the one that failed have already happened, and repeating them would
+  repeat writes, and reads that have side-effects (FIFOs, clear-on-read
+  status). So if a batch fails, every op in it is failed, and none are retried.
+  Since a batch only ever holds one device's ops, nothing else is affected.
+
+Ops complete in the order they were handed over. An op that the Kernel wants
+  back (because its device is going away) can be recalled. See recall().
+
+In place of /dev/i2c-N, a bus can be given an I2CFakeBus, which services the
+  same message arrays against register files in memory. It must be plugged
+  in before the adapter is attached.
+*/
+
+#ifndef __MANUVR_LINUX_I2C_H__
+#define __MANUVR_LINUX_I2C_H__
+
+#include <Platform/Peripherals/I2C/I2CAdapter.h>
+
+#if defined(MANUVR_SUPPORT_I2C)
+#include <pthread.h>
+#include <linux/i2c.h>
+
+#define I2C_LINUX_MAX_ADAPTERS   4    // Buses 0 through 3.
+#define I2C_LINUX_MAX_BATCH      8    // Most ops moved in one ioctl.
+#define I2C_LINUX_RING_SIZE     16    // Ops that may be waiting for the worker.
+#define I2C_LINUX_SCRATCH      256    // Bytes for building writes with a sub-address.
+#define I2C_FAKE_MAX_DEVICES     8
+
+
+/*
+* An i2c bus in memory. Each device is a register file with a pointer that
+*   auto-increments, and wraps at the end of the file.
+*/
+class I2CFakeBus {
+  public:
+    I2CFakeBus();
+    ~I2CFakeBus();
+
+    int8_t   addDevice(uint8_t addr, uint16_t len);
+    uint8_t* registers(uint8_t addr);
+
+    int  transfer(struct i2c_msg* msgs, int count);  // Same contract as I2C_RDWR.
+
+    uint32_t transferCost = 0;   // Microseconds to spin per transfer, to model the syscall.
+
+    inline uint32_t transfers() {  return _transfers;  };
+    inline uint32_t messages() {   return _messages;   };
+    inline uint32_t bytes() {      return _bytes;      };
+
+    void printDebug(StringBuilder*);
+
+
+  private:
+    typedef struct {
+      uint8_t* mem;
+      uint16_t len;
+      uint16_t ptr;
+      uint8_t  addr;
+    } FakeI2CDevice;
+
+    FakeI2CDevice _devs[I2C_FAKE_MAX_DEVICES];
+    uint8_t  _dev_count = 0;
+    uint32_t _transfers = 0;
+    uint32_t _messages  = 0;
+    uint32_t _bytes     = 0;
+
+    FakeI2CDevice* _find(uint8_t addr);
+};
+
+
+/*
+* The state of one bus, shared by the adapter and its worker.
+*/
+class LinuxI2CBus {
+  public:
+    I2CAdapter*    adapter   = nullptr;
+    I2CFakeBus*    fake      = nullptr;   // If set, used instead of the device file.
+    int            handle    = -1;
+    uint8_t        maxBatch  = I2C_LINUX_MAX_BATCH;
+
+    int8_t open(I2CAdapter*);
+    void   close();
+    int8_t submit(I2CBusOp*);
+    bool   recall(I2CBusOp*);
+    void   runBatch(I2CBusOp** ops, int count);
+    void   printDebug(StringBuilder*);
+
+    inline bool online() {  return ((nullptr != fake) || (handle >= 0));  };
+
+    static LinuxI2CBus* bus(int8_t adapter_id);
+    static void* worker(void*);
+
+
+  private:
+    pthread_mutex_t _mutex;
+    pthread_cond_t  _cond;
+    pthread_cond_t  _done;          // Signaled when the worker finishes a batch.
+    unsigned long   _thread_id = 0;
+    bool            _threaded  = false;
+    I2CBusOp*       _ring[I2C_LINUX_RING_SIZE];
+    uint8_t         _r         = 0;
+    uint8_t         _count     = 0;
+    I2CBusOp**      _batch     = nullptr;   // What the worker is running. Guarded by _mutex.
+    int             _batch_len = 0;
+
+    /* Stats */
+    uint32_t _transfers = 0;   // ioctls (or fake transfers).
+    uint32_t _ops       = 0;
+    uint32_t _failed    = 0;   // Batches that failed, and took their ops with them.
+    uint8_t  _deepest   = 0;   // Largest batch.
+
+    LinuxI2CBus();
+    int  _transfer(struct i2c_msg*, int);
+    int  _take(I2CBusOp** ops, int max);
+
+    static LinuxI2CBus _buses[I2C_LINUX_MAX_ADAPTERS];
+};
+
+#endif  // MANUVR_SUPPORT_I2C
+#endif  // __MANUVR_LINUX_I2C_H__
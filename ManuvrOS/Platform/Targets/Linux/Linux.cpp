@@ -478,6 +478,7 @@ unsigned long millis() {
       if (_storage_device->isMounted()) {
         uint8_t raw[2048];
         int len = _storage_device->persistentRead(NULL, raw, 2048, 0);
+        if (0 >= len) return -1;
         _config = Argument::decodeFromCBOR(raw, len);
         if (_config) {
           return 0;
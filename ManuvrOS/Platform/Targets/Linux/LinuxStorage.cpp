@@ -19,9 +19,17 @@ limitations under the License.
 
 
 Data-persistence layer for linux.
-Implemented as a JSON object within a single file. This feature therefore
-  requires MANUVR_JSON. In the future, it may be made to operate on some
-  other encoding, be run through a cryptographic pipe, etc.
+Implemented as an append-only log of keyed records within a single file. See
+  the header for the arrangement.
+
+The file begins with an 8-byte magic string. Each record is laid out thus:
+  uint32  CRC-32 of everything in the record that follows it
+  uint16  Length of the key
+  uint16  Flags
+  uint32  Length of the value
+  ...     The key, without a terminator
+  ...     The value
+Integers are in host byte-order. The store isn't meant to move between hosts.
 */
 
 #include "LinuxStorage.h"
@@ -30,10 +38,20 @@ Implemented as a JSON object within a single file. This feature therefore
 #include <Platform/Platform.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <sys/uio.h>
 
-// We want this definition isolated to the compilation unit.
+// We want these definitions isolated to the compilation unit.
 #define STORAGE_PROPS (MANUVR_PL_USES_FILESYSTEM | MANUVR_PL_BLOCK_ACCESS)
 
+#define STORE_MAGIC            "MVKVLOG1"
+#define STORE_HDR_LEN          8
+#define STORE_REC_HDR_LEN      12
+#define STORE_REC_TOMBSTONE    0x0001     // The key was deleted.
+#define STORE_MAP_QUANTUM      0x10000    // Mappings grow in multiples of this.
+
 
 /*******************************************************************************
 *      _______.___________.    ___   .___________. __    ______     _______.
@@ -46,6 +64,89 @@ Implemented as a JSON object within a single file. This feature therefore
 * Static members and initializers should be located here.
 *******************************************************************************/
 
+static uint32_t _crc_table[256];
+static bool     _crc_table_ready = false;
+
+/*
+* CRC-32 (IEEE 802.3), by the table.
+*/
+static uint32_t _crc32(uint32_t crc, const uint8_t* buf, uint32_t len) {
+  if (!_crc_table_ready) {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; k++) {
+        c = (c & 1) ? (0xEDB88320 ^ (c >> 1)) : (c >> 1);
+      }
+      _crc_table[i] = c;
+    }
+    _crc_table_ready = true;
+  }
+  crc = ~crc;
+  for (uint32_t i = 0; i < len; i++) {
+    crc = _crc_table[(crc ^ buf[i]) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+/*
+* FNV-1a, for the index.
+*/
+static uint32_t _key_hash(const char* key, uint16_t len) {
+  uint32_t h = 0x811C9DC5;
+  for (uint16_t i = 0; i < len; i++) {
+    h = (h ^ (uint8_t) key[i]) * 0x01000193;
+  }
+  return h;
+}
+
+/*
+* Writes one record at the given offset.
+*
+* @return the length of the record, or -1 on failure.
+*/
+static int _rec_write(int fd, uint32_t offset, const char* key, uint16_t key_len, const uint8_t* val, uint32_t val_len, uint16_t flags) {
+  uint8_t hdr[STORE_REC_HDR_LEN];
+  memcpy(&hdr[4],  &key_len, 2);
+  memcpy(&hdr[6],  &flags,   2);
+  memcpy(&hdr[8],  &val_len, 4);
+  uint32_t crc = _crc32(0, &hdr[4], STORE_REC_HDR_LEN - 4);
+  crc = _crc32(crc, (const uint8_t*) key, key_len);
+  crc = _crc32(crc, val, val_len);
+  memcpy(&hdr[0], &crc, 4);
+
+  struct iovec iov[3];
+  iov[0].iov_base = hdr;
+  iov[0].iov_len  = STORE_REC_HDR_LEN;
+  iov[1].iov_base = (void*) key;
+  iov[1].iov_len  = key_len;
+  iov[2].iov_base = (void*) val;
+  iov[2].iov_len  = val_len;
+  const ssize_t total = STORE_REC_HDR_LEN + key_len + val_len;
+  return (total == pwritev(fd, iov, 3, offset)) ? (int) total : -1;
+}
+
+/*
+* Syncs the directory holding the given path, so that a rename is durable.
+*/
+static void _sync_dir(const char* path) {
+  const char* slash = strrchr(path, '/');
+  StringBuilder dir;
+  if (nullptr == slash) {
+    dir.concat(".");
+  }
+  else if (slash == path) {
+    dir.concat("/");
+  }
+  else {
+    dir.concat((uint8_t*) path, (int) (slash - path));
+  }
+  int dfd = open((const char*) dir.string(), O_RDONLY | O_DIRECTORY);
+  if (dfd >= 0) {
+    fsync(dfd);
+    close(dfd);
+  }
+}
+
 
 /*******************************************************************************
 *   ___ _              ___      _ _              _      _
@@ -68,11 +169,24 @@ LinuxStorage::LinuxStorage(Argument* opts) : EventReceiver("LinuxStorage"), Stor
         *(_filename+i) = *(str+i);
       }
     }
+    // If present, every write is synced before it returns.
+    _sync_writes = (nullptr != opts->retrieveArgByKey("store_sync"));
   }
 }
 
 
 LinuxStorage::~LinuxStorage() {
+  _close_log();
+  _index_clear();
+  if (nullptr != _entries) {
+    free(_entries);
+    _entries = nullptr;
+  }
+  if (nullptr != _slots) {
+    free(_slots);
+    _slots = nullptr;
+  }
+  _capacity = 0;
   if (nullptr != _filename) {
     free(_filename);
     _filename = nullptr;
@@ -88,111 +202,479 @@ LinuxStorage::~LinuxStorage() {
 * Storage interface.
 ********************************************************************************/
 unsigned long LinuxStorage::freeSpace() {
-  // TODO: Need a sophisticated apparatus to find this accurately.
-  // What partition is )_filename on?
-  // How much space free on it?
-  // Cap to arbitrary maximum value for now.
-  return ((2 << 16) - _disk_buffer.length());
+  if (_filename) {
+    struct statvfs sv;
+    if (0 == statvfs(_filename, &sv)) {
+      return (unsigned long) (sv.f_bavail * sv.f_frsize);
+    }
+  }
+  return 0;
 }
 
+/**
+* Discards every record. The file is left holding only its header.
+*/
 int8_t LinuxStorage::wipe() {
-  _disk_buffer.clear();
-  _disk_buffer.concat('\0');
-  return _save_file(&_disk_buffer);
+  if (_fd < 0) return -1;
+  _pl_set_flag(true, MANUVR_PL_BUSY_WRITE);
+  int8_t ret = -1;
+  if (0 == ftruncate(_fd, STORE_HDR_LEN)) {
+    if (0 == fdatasync(_fd)) {
+      _index_clear();
+      _log_len  = STORE_HDR_LEN;
+      _live_len = 0;
+      ret = 0;
+    }
+  }
+  _pl_set_flag(false, MANUVR_PL_BUSY_WRITE);
+  return ret;
 }
 
+/**
+* Everything written before this returns successfully will survive a crash.
+*/
 int8_t LinuxStorage::flush() {
-  if (_filename) {
-    if (0 < _disk_buffer.length()) {
-      return _save_file(&_disk_buffer);
+  if (_fd < 0) return 0;
+  return (0 == fdatasync(_fd)) ? 0 : -1;
+}
+
+
+/**
+* Stores a value under the given key, replacing any value it had. A null key
+*   is the same as an empty one. Writing zero bytes deletes the key.
+*
+* @return the number of bytes written, or -1 on failure.
+*/
+int LinuxStorage::persistentWrite(const char* key, uint8_t* buf, unsigned int len, uint16_t) {
+  if (!isMounted()) return -1;
+  if ((0 < len) && (nullptr == buf)) return -1;
+  _pl_set_flag(true, MANUVR_PL_BUSY_WRITE);
+  int ret = _append(((nullptr == key) ? "" : key), buf, len, ((0 == len) ? STORE_REC_TOMBSTONE : 0));
+  _pl_set_flag(false, MANUVR_PL_BUSY_WRITE);
+  if (0 > ret) return -1;
+
+  // Compact once the superseded records outweigh the live ones.
+  const uint32_t dead = _log_len - STORE_HDR_LEN - _live_len;
+  if ((_log_len > LINUX_STORAGE_COMPACT_MIN) && (dead > _live_len)) {
+    compact();   // On failure, the log is just left as it was.
+  }
+  return (int) len;
+}
+
+
+/**
+* Copies the value for the given key into the buffer, zeroing any of the
+*   buffer that it doesn't fill.
+*
+* @return the number of bytes copied, or -1 if there is no such key.
+*/
+int LinuxStorage::persistentRead(const char* key, uint8_t* buf, unsigned int len, uint16_t) {
+  if (!isMounted() || (nullptr == _map)) return -1;
+  if (nullptr == key) key = "";
+  const uint16_t klen = strlen(key);
+  StoreIndexEntry* e = _index_find(key, klen, _key_hash(key, klen));
+  if (nullptr == e) return -1;
+  unsigned int r_len = (e->len > len) ? len : e->len;
+  memcpy(buf, _map + e->offset, r_len);
+  if (r_len < len) {
+    memset(buf + r_len, 0, len - r_len);  // Zero the unused buffer, for safety.
+  }
+  return r_len;
+}
+
+
+int LinuxStorage::persistentRead(const char* key, StringBuilder* out) {
+  if (!isMounted() || (nullptr == _map)) return -1;
+  if (nullptr == key) key = "";
+  const uint16_t klen = strlen(key);
+  StoreIndexEntry* e = _index_find(key, klen, _key_hash(key, klen));
+  if (nullptr == e) return -1;
+  out->concat(_map + e->offset, (int) e->len);
+  return e->len;
+}
+
+
+/**
+* Rewrites the log with only the current value for each key. The new log is
+*   built beside the old one, and renamed over it once it is safely on disk.
+*   Until then, the old log is untouched.
+*
+* @return 0 on success, -1 on failure.
+*/
+int8_t LinuxStorage::compact() {
+  if ((_fd < 0) || (nullptr == _filename)) return -1;
+  StringBuilder tmp_path(_filename);
+  tmp_path.concat(".tmp");
+  int tfd = open((const char*) tmp_path.string(), O_CREAT | O_TRUNC | O_RDWR, S_IRUSR | S_IWUSR);
+  if (tfd < 0) return -1;
+
+  _pl_set_flag(true, MANUVR_PL_BUSY_WRITE);
+  uint32_t* nu_offsets = (uint32_t*) malloc(sizeof(uint32_t) * (_count + 1));
+  uint32_t  offset     = STORE_HDR_LEN;
+  bool      ok         = (nullptr != nu_offsets) && (STORE_HDR_LEN == pwrite(tfd, STORE_MAGIC, STORE_HDR_LEN, 0));
+  for (uint32_t i = 0; ok && (i < _count); i++) {
+    StoreIndexEntry* e = &_entries[i];
+    int r = _rec_write(tfd, offset, e->key, e->key_len, _map + e->offset, e->len, 0);
+    if (0 > r) {
+      ok = false;
+    }
+    else {
+      nu_offsets[i] = offset + STORE_REC_HDR_LEN + e->key_len;
+      offset += r;
+    }
+  }
+
+  int8_t ret = -1;
+  if (ok && (0 == _install(tfd, (const char*) tmp_path.string(), offset))) {
+    for (uint32_t i = 0; i < _count; i++) {
+      _entries[i].offset = nu_offsets[i];
     }
+    _live_len = offset - STORE_HDR_LEN;
+    _compactions++;
+    ret = 0;
+  }
+  else if (!ok) {
+    close(tfd);
+    unlink((const char*) tmp_path.string());
+  }   // Otherwise, _install() cleaned up after itself.
+  if (nullptr != nu_offsets) free(nu_offsets);
+  _pl_set_flag(false, MANUVR_PL_BUSY_WRITE);
+  return ret;
+}
+
+
+/*******************************************************************************
+* The log                                                                      *
+*******************************************************************************/
+
+/**
+* Opens (or creates) the log, and replays it into the index.
+*
+* @return 0 on success, -1 on failure.
+*/
+int8_t LinuxStorage::_open_log() {
+  if (nullptr == _filename) return -1;
+  if (_fd >= 0) return 0;
+  _fd = open(_filename, O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+  if (_fd < 0) return -1;
+
+  _pl_set_flag(true, MANUVR_PL_BUSY_READ);
+  int8_t ret = _replay();
+  _pl_set_flag(false, MANUVR_PL_BUSY_READ);
+  if (0 != ret) {
+    _close_log();
+    return -1;
   }
+  _pl_set_flag(true, MANUVR_PL_MEDIUM_MOUNTED | MANUVR_PL_MEDIUM_READABLE | MANUVR_PL_MEDIUM_WRITABLE);
   return 0;
 }
 
 
-int LinuxStorage::persistentWrite(const char* key, uint8_t* buf, unsigned int len, uint16_t ) {
-  if (isMounted()) {
-    _disk_buffer.clear();
-    _disk_buffer.concat(buf, len);
-    return _save_file(&_disk_buffer);
+void LinuxStorage::_close_log() {
+  _pl_set_flag(false, MANUVR_PL_MEDIUM_MOUNTED | MANUVR_PL_MEDIUM_READABLE | MANUVR_PL_MEDIUM_WRITABLE);
+  if (nullptr != _map) {
+    munmap(_map, _map_len);
+    _map     = nullptr;
+    _map_len = 0;
+  }
+  if (_fd >= 0) {
+    fdatasync(_fd);
+    close(_fd);
+    _fd = -1;
   }
-  return -1;
 }
 
 
-int LinuxStorage::persistentRead(const char* key, uint8_t* buf, unsigned int len, uint16_t) {
-  if (isMounted()) {
-    unsigned int max_l = _disk_buffer.length();
-    unsigned int r_len = (max_l > len) ? len : max_l;
-    uint8_t* d_buf = _disk_buffer.string();
-    for (unsigned int i = 0; i < r_len; i++) {
-      *(buf+i) = *(d_buf+i);
+/**
+* Rebuilds the index from the log. Replay stops at the first record that is
+*   incomplete or fails its CRC. Anything from there on is the remains of a
+*   write that never finished, and is cut off.
+*
+* @return 0 on success, -1 on failure.
+*/
+int8_t LinuxStorage::_replay() {
+  struct stat st;
+  if (0 != fstat(_fd, &st)) return -1;
+  const uint32_t size = (uint32_t) st.st_size;
+  _index_clear();
+  _live_len  = 0;
+  _discarded = 0;
+
+  if (0 == size) {
+    // A new store.
+    if (STORE_HDR_LEN != pwrite(_fd, STORE_MAGIC, STORE_HDR_LEN, 0)) return -1;
+    _log_len = STORE_HDR_LEN;
+    return _remap(_log_len);
+  }
+  if (0 != _remap(size)) return -1;
+  if ((size < STORE_HDR_LEN) || (0 != memcmp(_map, STORE_MAGIC, STORE_HDR_LEN))) {
+    return _adopt_legacy(size);
+  }
+
+  uint32_t offset = STORE_HDR_LEN;
+  while ((size - offset) >= STORE_REC_HDR_LEN) {
+    const uint8_t* rec = _map + offset;
+    uint32_t crc;
+    uint16_t key_len;
+    uint16_t flags;
+    uint32_t val_len;
+    memcpy(&crc,     rec,     4);
+    memcpy(&key_len, rec + 4, 2);
+    memcpy(&flags,   rec + 6, 2);
+    memcpy(&val_len, rec + 8, 4);
+    const uint32_t avail = size - offset - STORE_REC_HDR_LEN;
+    if ((key_len > LINUX_STORAGE_MAX_KEY_LEN) || (key_len > avail) || (val_len > (avail - key_len))) {
+      break;   // Short.
+    }
+    const uint32_t rec_len = STORE_REC_HDR_LEN + key_len + val_len;
+    if (crc != _crc32(0, rec + 4, rec_len - 4)) {
+      break;   // Torn.
+    }
+    const char*    key  = (const char*) (rec + STORE_REC_HDR_LEN);
+    const uint32_t hash = _key_hash(key, key_len);
+    if (flags & STORE_REC_TOMBSTONE) {
+      _index_drop(key, key_len, hash);
     }
-    for (unsigned int i = r_len; i < len; i++) {
-      *(buf+i) = 0;  // Zero the  unused buffer, for safety.
+    else if (0 != _index_put(key, key_len, hash, offset + STORE_REC_HDR_LEN + key_len, val_len, rec_len)) {
+      return -1;
     }
-    return r_len;
+    offset += rec_len;
   }
-  return -1;
+
+  if (offset < size) {
+    _discarded = size - offset;
+    if ((0 != ftruncate(_fd, offset)) || (0 != fdatasync(_fd))) return -1;
+  }
+  _log_len = offset;
+  return 0;
 }
 
 
-int LinuxStorage::persistentRead(const char*, StringBuilder* out) {
-  if (isMounted()) {
-    out->concat(&_disk_buffer);
-    return _disk_buffer.length();
+/**
+* The file isn't a log. It must be a store from before keys, which held one
+*   blob. That blob becomes the value of the null key.
+*
+* @return 0 on success, -1 on failure.
+*/
+int8_t LinuxStorage::_adopt_legacy(uint32_t len) {
+  StringBuilder tmp_path(_filename);
+  tmp_path.concat(".tmp");
+  int tfd = open((const char*) tmp_path.string(), O_CREAT | O_TRUNC | O_RDWR, S_IRUSR | S_IWUSR);
+  if (tfd < 0) return -1;
+  int r = -1;
+  if (STORE_HDR_LEN == pwrite(tfd, STORE_MAGIC, STORE_HDR_LEN, 0)) {
+    r = _rec_write(tfd, STORE_HDR_LEN, "", 0, _map, len, 0);
+  }
+  if (0 > r) {
+    close(tfd);
+    unlink((const char*) tmp_path.string());
+    return -1;
   }
-  return -1;
+  if (0 != _install(tfd, (const char*) tmp_path.string(), STORE_HDR_LEN + r)) return -1;
+  return _index_put("", 0, _key_hash("", 0), STORE_HDR_LEN + STORE_REC_HDR_LEN, len, r);
 }
 
 
 /**
-* Open the file write-only and save the buffer. Clobbering the file's contents.
+* Puts a freshly-written log in place of the current one. The new log is
+*   synced before the rename, and the directory after it. Either the old log or
+*   the new one will be found after a crash, but never a mix of the two.
+*
+* @param fd        The open descriptor of the new log.
+* @param tmp_path  Where the new log is now.
+* @param log_len   The length of the new log.
+* @return 0 on success, -1 on failure. If the rename failed, the new log is
+*   discarded. If the new log can't be mapped after the rename, the store
+*   is closed.
 */
-int LinuxStorage::_save_file(StringBuilder* b) {
-  int return_value = -1;  // Fail by default.
-  if (_filename) {
-    int fd = open(_filename, O_CREAT | O_WRONLY | O_TRUNC, S_IRUSR | S_IWUSR);
-    if (fd >= 0) {
-      _pl_set_flag(true, MANUVR_PL_BUSY_WRITE);
-      int len = b->length();
-      StringBuilder buf(b->string(), len);  // Buffer is now locally-scoped.
-      int q = write(fd, buf.string(), len);
-      if (len == q) {
-        return_value = len;
-      }
-      close(fd);
-      _pl_set_flag(false, MANUVR_PL_BUSY_WRITE);
+int8_t LinuxStorage::_install(int fd, const char* tmp_path, uint32_t log_len) {
+  if ((0 != fsync(fd)) || (0 != rename(tmp_path, _filename))) {
+    close(fd);
+    unlink(tmp_path);
+    return -1;
+  }
+  _sync_dir(_filename);
+  if (nullptr != _map) {
+    munmap(_map, _map_len);
+    _map     = nullptr;
+    _map_len = 0;
+  }
+  close(_fd);
+  _fd      = fd;
+  _log_len = log_len;
+  if (0 != _remap(_log_len)) {
+    // The new log is in place, but we can't read it, and the index still
+    //   points into the old one.
+    _close_log();
+    return -1;
+  }
+  return 0;
+}
+
+
+/**
+* Makes sure the mapping covers at least the given length of the file. The
+*   mapping is grown with some room to spare, since the log only gets longer.
+*   Pages past the end of the file are never touched.
+*
+* @return 0 on success, -1 on failure.
+*/
+int8_t LinuxStorage::_remap(size_t need) {
+  if ((nullptr != _map) && (need <= _map_len)) return 0;
+  if (nullptr != _map) {
+    munmap(_map, _map_len);
+    _map     = nullptr;
+    _map_len = 0;
+  }
+  size_t len = need + (need >> 1);
+  len = (len + STORE_MAP_QUANTUM - 1) & ~((size_t) STORE_MAP_QUANTUM - 1);
+  void* m = mmap(nullptr, len, PROT_READ, MAP_SHARED, _fd, 0);
+  if (MAP_FAILED == m) return -1;
+  _map     = (uint8_t*) m;
+  _map_len = len;
+  return 0;
+}
+
+
+/**
+* Appends a record to the log, and updates the index to match.
+*
+* @return the length of the record, or -1 on failure.
+*/
+int LinuxStorage::_append(const char* key, const uint8_t* val, uint32_t len, uint16_t flags) {
+  const size_t klen = strlen(key);
+  if (klen > LINUX_STORAGE_MAX_KEY_LEN) return -1;
+  const uint32_t hash = _key_hash(key, klen);
+  if ((flags & STORE_REC_TOMBSTONE) && (nullptr == _index_find(key, klen, hash))) {
+    return 0;   // Nothing to delete.
+  }
+
+  const uint32_t offset = _log_len;
+  int r = _rec_write(_fd, offset, key, klen, val, len, flags);
+  if ((0 > r) || (_sync_writes && (0 != fdatasync(_fd)))) {
+    // Don't leave a partial record for the next write to land behind.
+    if (0 != ftruncate(_fd, offset)) {}
+    return -1;
+  }
+  _log_len += r;
+  if (0 != _remap(_log_len)) {
+    _close_log();   // We can no longer read what we've written.
+    return -1;
+  }
+  if (flags & STORE_REC_TOMBSTONE) {
+    _index_drop(key, klen, hash);
+  }
+  else if (0 != _index_put(key, klen, hash, offset + STORE_REC_HDR_LEN + klen, len, r)) {
+    return -1;
+  }
+  return r;
+}
+
+
+/*******************************************************************************
+* The index                                                                    *
+* Open addressing with linear probing. The entries are kept dense, so that     *
+*   they can be walked in order without visiting empty slots.                  *
+*******************************************************************************/
+
+StoreIndexEntry* LinuxStorage::_index_find(const char* key, uint16_t key_len, uint32_t hash) {
+  if (0 == _capacity) return nullptr;
+  const uint32_t mask = _capacity - 1;
+  uint32_t i = hash & mask;
+  while (0 != _slots[i]) {
+    StoreIndexEntry* e = &_entries[_slots[i] - 1];
+    if ((e->hash == hash) && (e->key_len == key_len) && (0 == memcmp(e->key, key, key_len))) {
+      return e;
     }
+    i = (i + 1) & mask;
   }
-  return return_value;
+  return nullptr;
 }
 
 
 /**
-* Open the file read-only and fill the buffer.
+* Points the key at a new value, adding the key if needed.
+*
+* @return 0 on success, -1 on failure.
 */
-int LinuxStorage::_load_file(StringBuilder* buf) {
-  if (_filename) {
-    int fd = open(_filename, O_RDONLY);
-    if (fd >= 0) {
-      int total_read = 0;
-      _pl_set_flag(true, MANUVR_PL_BUSY_READ);
-      uint8_t* buffer = (uint8_t*) alloca(2048);
-      int r_len = read(fd, buffer, 2048);
-      while (0 < r_len) {
-        buf->concat(buffer, r_len);
-        total_read += r_len;
-        r_len = read(fd, buffer, 2048);
-      }
-      close(fd);
-      _pl_set_flag(false, MANUVR_PL_BUSY_READ);
-      _pl_set_flag(true, MANUVR_PL_MEDIUM_MOUNTED | MANUVR_PL_MEDIUM_READABLE | MANUVR_PL_MEDIUM_WRITABLE);
-      return total_read;
+int8_t LinuxStorage::_index_put(const char* key, uint16_t key_len, uint32_t hash, uint32_t offset, uint32_t len, uint32_t rec_len) {
+  StoreIndexEntry* e = _index_find(key, key_len, hash);
+  if (nullptr == e) {
+    if (((_count + 1) << 1) > _capacity) {
+      if (0 != _rehash((0 == _capacity) ? 64 : (_capacity << 1))) return -1;
     }
+    char* k = (char*) malloc(key_len + 1);
+    if (nullptr == k) return -1;
+    memcpy(k, key, key_len);
+    k[key_len] = '\0';
+    e = &_entries[_count];
+    e->key     = k;
+    e->hash    = hash;
+    e->key_len = key_len;
+    e->rec_len = 0;
+    uint32_t i = hash & (_capacity - 1);
+    while (0 != _slots[i]) i = (i + 1) & (_capacity - 1);
+    _slots[i] = ++_count;
+  }
+  _live_len  = _live_len - e->rec_len + rec_len;
+  e->offset  = offset;
+  e->len     = len;
+  e->rec_len = rec_len;
+  return 0;
+}
+
+
+void LinuxStorage::_index_drop(const char* key, uint16_t key_len, uint32_t hash) {
+  StoreIndexEntry* e = _index_find(key, key_len, hash);
+  if (nullptr == e) return;
+  _live_len -= e->rec_len;
+  free(e->key);
+  *e = _entries[--_count];   // Keep the entries dense.
+  _reslot();
+}
+
+
+void LinuxStorage::_index_clear() {
+  for (uint32_t i = 0; i < _count; i++) {
+    free(_entries[i].key);
+  }
+  _count = 0;
+  if (nullptr != _slots) {
+    memset(_slots, 0, sizeof(uint32_t) * _capacity);
+  }
+}
+
+
+/**
+* Grows the index.
+*
+* @return 0 on success, -1 on failure.
+*/
+int8_t LinuxStorage::_rehash(uint32_t capacity) {
+  StoreIndexEntry* nu_entries = (StoreIndexEntry*) realloc(_entries, sizeof(StoreIndexEntry) * (capacity >> 1));
+  if (nullptr == nu_entries) return -1;
+  _entries = nu_entries;
+  uint32_t* nu_slots = (uint32_t*) malloc(sizeof(uint32_t) * capacity);
+  if (nullptr == nu_slots) return -1;
+  if (nullptr != _slots) free(_slots);
+  _slots    = nu_slots;
+  _capacity = capacity;
+  _reslot();
+  return 0;
+}
+
+
+/*
+* Rebuilds the slots from the entries.
+*/
+void LinuxStorage::_reslot() {
+  const uint32_t mask = _capacity - 1;
+  memset(_slots, 0, sizeof(uint32_t) * _capacity);
+  for (uint32_t n = 0; n < _count; n++) {
+    uint32_t i = _entries[n].hash & mask;
+    while (0 != _slots[i]) i = (i + 1) & mask;
+    _slots[i] = n + 1;
   }
-  return -1;
 }
 
 
@@ -217,12 +699,8 @@ int LinuxStorage::_load_file(StringBuilder* buf) {
 */
 int8_t LinuxStorage::attached() {
   if (EventReceiver::attached()) {
-    if (0 <= _load_file(&_disk_buffer)) {
-    }
-    else {
-      // Attempt to create the file.
-      wipe();
-      if (0 == wipe()) _load_file(&_disk_buffer);
+    if (0 != _open_log()) {
+      local_log.concatf("Failed to open %s.\n", (nullptr == _filename ? "<unset>" : _filename));
     }
     return 1;
   }
@@ -267,6 +745,12 @@ int8_t LinuxStorage::callback_proc(ManuvrMsg* event) {
 void LinuxStorage::printDebug(StringBuilder *output) {
   EventReceiver::printDebug(output);
   output->concatf("-- _filename:           %s\n", (nullptr == _filename ? "<unset>" : _filename));
+  output->concatf("-- Keys:                %u\n", _count);
+  output->concatf("-- Log/live bytes:      %u/%u\n", _log_len, _live_len);
+  output->concatf("-- Compactions:         %u\n", _compactions);
+  if (_discarded) {
+    output->concatf("-- Discarded on load:   %u bytes\n", _discarded);
+  }
   Storage::printDebug(output);
 }
 
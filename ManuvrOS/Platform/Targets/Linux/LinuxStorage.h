@@ -19,9 +19,20 @@ limitations under the License.
 
 
 Data-persistence layer for linux.
-Implemented as a CBOR object within a single file. This feature therefore
-  requires MANUVR_CBOR. In the future, it may be made to operate on some
-  other encoding, be run through a cryptographic pipe, etc.
+Implemented as an append-only log of keyed records within a single file.
+  Every write appends a record, and an index in memory maps each key to the
+  latest value for it. Reads come from a read-only mapping of the file.
+
+Each record carries a CRC. When the store is opened, the log is replayed
+  until the first record that is short or fails its CRC, and the file is
+  truncated there. So a write that was interrupted is lost, but nothing
+  before it is. Writes are durable once flush() returns.
+
+Once more than half the log is superseded records, the live records are
+  copied into a new file, which is synced and renamed over the old one.
+
+A store in the old single-blob format is adopted as the value of the null
+  key, which is the key the platform uses for its configuration.
 */
 
 #ifndef __MANUVR_LINUX_STORAGE_H__
@@ -30,9 +41,18 @@ Implemented as a CBOR object within a single file. This feature therefore
 #include <EventReceiver.h>
 #include <Platform/Storage.h>
 
-#ifndef MANUVR_CBOR
-  #error The LinuxStorage class requires MANUVR_CBOR be enabled.
-#endif
+#define LINUX_STORAGE_COMPACT_MIN    65536   // Logs smaller than this aren't compacted.
+#define LINUX_STORAGE_MAX_KEY_LEN    255
+
+/* An index entry for one key. */
+typedef struct {
+  char*    key;
+  uint32_t hash;
+  uint16_t key_len;
+  uint32_t offset;    // Offset of the value within the file.
+  uint32_t len;       // Length of the value.
+  uint32_t rec_len;   // Length of the whole record.
+} StoreIndexEntry;
 
 class LinuxStorage : public EventReceiver, public Storage {
   public:
@@ -48,6 +68,14 @@ class LinuxStorage : public EventReceiver, public Storage {
     int persistentRead(const char*, uint8_t*, unsigned int, uint16_t);
     int persistentRead(const char*, StringBuilder*);
 
+    int8_t compact();   // Rewrites the log with only live records.
+
+    inline uint32_t keyCount() {      return _count;       };
+    inline uint32_t logLength() {     return _log_len;     };
+    inline uint32_t liveLength() {    return _live_len;    };
+    inline uint32_t compactions() {   return _compactions; };
+    inline uint32_t discardedOnLoad() {  return _discarded;  };
+
     /* Overrides from EventReceiver */
     void printDebug(StringBuilder*);
     int8_t notify(ManuvrMsg*);
@@ -61,11 +89,34 @@ class LinuxStorage : public EventReceiver, public Storage {
 
 
   private:
-    char*          _filename   = nullptr;
-    StringBuilder  _disk_buffer;
-
-    int _save_file(StringBuilder* b);
-    int _load_file(StringBuilder* b);
+    char*            _filename    = nullptr;
+    int              _fd          = -1;
+    uint8_t*         _map         = nullptr;  // Read-only view of the log.
+    size_t           _map_len     = 0;
+    uint32_t         _log_len     = 0;        // Bytes of valid log.
+    uint32_t         _live_len    = 0;        // Bytes of records that are still current.
+    uint32_t         _compactions = 0;
+    uint32_t         _discarded   = 0;        // Bytes of torn log found on load.
+    StoreIndexEntry* _entries     = nullptr;  // Dense.
+    uint32_t*        _slots       = nullptr;  // Index into _entries, plus one. Zero is empty.
+    uint32_t         _capacity    = 0;        // Slot count. Always a power of two.
+    uint32_t         _count       = 0;
+    bool             _sync_writes = false;    // fdatasync() after every write?
+
+    int8_t _open_log();
+    void   _close_log();
+    int8_t _replay();
+    int8_t _adopt_legacy(uint32_t len);
+    int8_t _install(int fd, const char* tmp_path, uint32_t log_len);
+    int8_t _remap(size_t);
+    int    _append(const char* key, const uint8_t* val, uint32_t len, uint16_t flags);
+
+    StoreIndexEntry* _index_find(const char* key, uint16_t key_len, uint32_t hash);
+    int8_t _index_put(const char* key, uint16_t key_len, uint32_t hash, uint32_t offset, uint32_t len, uint32_t rec_len);
+    void   _index_drop(const char* key, uint16_t key_len, uint32_t hash);
+    void   _index_clear();
+    int8_t _rehash(uint32_t capacity);
+    void   _reslot();
 };
 
 #endif // __MANUVR_LINUX_STORAGE_H__
@@ -0,0 +1,191 @@
+/*
+File:   LinuxSPI.h
+Author: J. Ian Lindsay
+Date:   2026.10.18
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+The linux side of the SPI adapter.
+
+Chip-select belongs to the kernel driver. Each CS line on a bus is its own
+  device file (/dev/spidevB.C), and an op's CS pin is taken as the C.
+
+Each open bus has a worker thread. The Kernel hands it ops through a ring,
+  and the worker takes as many as are waiting (up to a limit). Consecutive
+  ops for the same CS are chained into one SPI_IOC_MESSAGE(n) ioctl. Each op
+  is a transfer for its parameters and a transfer for its buffer, with CS
+  released after the op. Ops that the driver would refuse (too long, or not
+  a transfer) are failed without being moved. If an ioctl fails anyway, every
+  op in its chain fails, since none of them can be safely moved again.
+
+Ops complete in the order they were handed over, and their callbacks are
+  made from the Kernel's thread by the adapter.
+
+Drivers that want buffers suitable for DMA can take them from the bus's
+  SPIBufferPool. The kernel driver copies through its own bounce buffer
+  otherwise.
+
+In place of /dev/spidevB.C, a bus can be given an SPIFakeBus, which services
+  the same transfer arrays in memory. It must be plugged in before the
+  adapter is attached.
+*/
+
+#ifndef __MANUVR_LINUX_SPI_H__
+#define __MANUVR_LINUX_SPI_H__
+
+#include <Platform/Peripherals/SPI/SPIAdapter.h>
+
+#if defined(CONFIG_MANUVR_SUPPORT_SPI)
+#include <pthread.h>
+#include <linux/spi/spidev.h>
+
+#define SPI_LINUX_MAX_ADAPTERS   2    // Buses 0 and 1.
+#define SPI_LINUX_MAX_CS         4    // CS lines per bus.
+#define SPI_LINUX_MAX_CHAIN      8    // Most ops moved in one ioctl.
+#define SPI_LINUX_RING_SIZE     16    // Ops that may be waiting for the worker.
+#define SPI_LINUX_BUF_ALIGN     64    // Cache line, and then some.
+#define SPI_LINUX_POOL_SLOTS    16    // At most 32.
+#define SPI_LINUX_POOL_SLOT_LEN 256
+#define SPI_LINUX_DEFAULT_HZ    1000000
+
+
+/*
+* Fixed-size buffers with cache-line alignment. Taking and giving are
+*   lock-free, so either thread may do it.
+*/
+class SPIBufferPool {
+  public:
+    SPIBufferPool(uint16_t slot_len, uint8_t slots);
+    ~SPIBufferPool();
+
+    uint8_t* take();
+    void     give(uint8_t*);
+    bool     owns(uint8_t*);
+
+    inline uint16_t slotLength() {  return _slot_len;  };
+    inline uint8_t  slots() {       return _slots;     };
+    uint8_t  available();
+
+    void printDebug(StringBuilder*);
+
+
+  private:
+    uint8_t* _mem      = nullptr;
+    uint16_t _slot_len;
+    uint8_t  _slots;
+    uint32_t _free     = 0;   // Bit per slot. Set if free.
+    uint32_t _misses   = 0;   // take() with nothing free.
+};
+
+
+/*
+* An SPI bus in memory. Each CS is either absent, a loopback (MISO follows
+*   MOSI), or a register file. For a register file, the first byte after CS
+*   asserts is the address, with bit 7 set for a read. The address then
+*   auto-increments, and wraps at the end of the file.
+*/
+class SPIFakeBus {
+  public:
+    SPIFakeBus();
+    ~SPIFakeBus();
+
+    int8_t   addDevice(uint8_t cs, uint16_t len);
+    int8_t   addLoopback(uint8_t cs);
+    uint8_t* registers(uint8_t cs);
+
+    // Same contract as SPI_IOC_MESSAGE(count) on /dev/spidevB.cs
+    int  transfer(uint8_t cs, struct spi_ioc_transfer* xfers, int count);
+
+    uint32_t transferCost = 0;   // Microseconds to spin per transfer, to model the syscall.
+
+    inline uint32_t transfers() {  return _transfers;  };
+    inline uint32_t segments() {   return _segments;   };
+    inline uint32_t bytes() {      return _bytes;      };
+
+    void printDebug(StringBuilder*);
+
+
+  private:
+    typedef struct {
+      uint8_t* mem;
+      uint16_t len;
+      uint16_t ptr;
+      bool     present;
+      bool     loopback;
+      bool     addressed;   // Has the address byte been seen since CS asserted?
+      bool     reading;
+    } FakeSPIDevice;
+
+    FakeSPIDevice _devs[SPI_LINUX_MAX_CS];
+    uint32_t _transfers = 0;
+    uint32_t _segments  = 0;
+    uint32_t _bytes     = 0;
+
+    uint8_t _clock(FakeSPIDevice*, uint8_t mosi);
+};
+
+
+/*
+* The state of one bus, shared by the adapter and its worker.
+*/
+class LinuxSPIBus {
+  public:
+    SPIAdapter*    adapter   = nullptr;
+    SPIFakeBus*    fake      = nullptr;   // If set, used instead of the device files.
+    int            handles[SPI_LINUX_MAX_CS];
+    uint32_t       speedHz   = SPI_LINUX_DEFAULT_HZ;
+    uint8_t        maxChain  = SPI_LINUX_MAX_CHAIN;
+    SPIBufferPool  pool;
+
+    int8_t open(SPIAdapter*);
+    void   close();
+    int8_t submit(SPIBusOp*);
+    void   runChain(SPIBusOp** ops, int count);
+    void   printDebug(StringBuilder*);
+
+    bool online(uint8_t cs);
+
+    static LinuxSPIBus* bus(int8_t adapter_id);
+    static LinuxSPIBus* active();
+    static void* worker(void*);
+
+
+  private:
+    pthread_mutex_t _mutex;
+    pthread_cond_t  _cond;
+    unsigned long   _thread_id = 0;
+    bool            _threaded  = false;
+    SPIBusOp*       _ring[SPI_LINUX_RING_SIZE];
+    uint8_t         _r         = 0;
+    uint8_t         _count     = 0;
+    uint8_t*        _params    = nullptr;   // Pool slot the worker stages parameters in.
+
+    /* Stats */
+    uint32_t _transfers = 0;   // ioctls (or fake transfers).
+    uint32_t _ops       = 0;
+    uint32_t _failed    = 0;   // Chains that failed, taking all of their ops with them.
+    uint8_t  _deepest   = 0;   // Longest chain.
+
+    LinuxSPIBus();
+    int  _transfer(uint8_t cs, struct spi_ioc_transfer*, int);
+    int  _take(SPIBusOp** ops, int max);
+
+    static LinuxSPIBus  _buses[SPI_LINUX_MAX_ADAPTERS];
+    static LinuxSPIBus* _active;
+};
+
+#endif  // CONFIG_MANUVR_SUPPORT_SPI
+#endif  // __MANUVR_LINUX_SPI_H__
@@ -27,20 +27,319 @@ For instance: On a RasPi v1 with the kernel driver loaded we have...
     /dev/spidev0.0
     /dev/spidev0.1
   ...for CS0 and CS1.
+
+The bus state and its worker thread are described in LinuxSPI.h.
 */
 
-#include <Platform/Peripherals/SPI/SPIAdapter.h>
+#include <Platform/Targets/Linux/SPI/LinuxSPI.h>
 
+#if defined(CONFIG_MANUVR_SUPPORT_SPI)
 #include <stdint.h>
 #include <unistd.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <getopt.h>
 #include <fcntl.h>
+#include <time.h>
 #include <sys/ioctl.h>
 #include <linux/types.h>
 #include <linux/spi/spidev.h>
 
+#define SPI_LINUX_MAX_MESSAGE   4096   // spidev's default bufsiz.
+
+/*
+* Linux handles CS. A pin of 255 means the bus has only the one device.
+*/
+static inline uint8_t _cs_of(SPIBusOp* op) {
+  return (255 == op->getCSPin()) ? 0 : op->getCSPin();
+}
+
+
+/*******************************************************************************
+* Linux bus state and the worker thread                                        *
+*******************************************************************************/
+
+LinuxSPIBus  LinuxSPIBus::_buses[SPI_LINUX_MAX_ADAPTERS];
+LinuxSPIBus* LinuxSPIBus::_active = nullptr;
+
+
+LinuxSPIBus::LinuxSPIBus() : pool(SPI_LINUX_POOL_SLOT_LEN, SPI_LINUX_POOL_SLOTS) {
+  for (uint8_t i = 0; i < SPI_LINUX_MAX_CS; i++) handles[i] = -1;
+  pthread_mutex_init(&_mutex, nullptr);
+  pthread_cond_init(&_cond, nullptr);
+}
+
+
+/**
+* @param  adapter_id  The bus number.
+* @return the state for the given bus, or nullptr if it is out of range.
+*/
+LinuxSPIBus* LinuxSPIBus::bus(int8_t adapter_id) {
+  if ((adapter_id >= 0) && (adapter_id < SPI_LINUX_MAX_ADAPTERS)) {
+    return &_buses[adapter_id];
+  }
+  return nullptr;
+}
+
+
+/**
+* SPIBusOps don't know which adapter they belong to, and there is only ever
+*   one SPIAdapter (they share the static queue-ready event).
+*
+* @return the bus that was most recently opened, or nullptr if none was.
+*/
+LinuxSPIBus* LinuxSPIBus::active() {
+  return _active;
+}
+
+
+/*
+* The worker waits for ops to be handed over, and moves whatever is waiting
+*   in as few ioctls as it can.
+*/
+void* LinuxSPIBus::worker(void* arg) {
+  LinuxSPIBus* b = (LinuxSPIBus*) arg;
+  SPIBusOp* ops[SPI_LINUX_MAX_CHAIN];
+  while (!platform.nominalState()) {
+    sleep_millis(80);
+  }
+  pthread_mutex_lock(&b->_mutex);
+  while (platform.nominalState()) {
+    if (0 == b->_count) {
+      // Wake periodically to notice platform shutdown.
+      struct timespec ts;
+      clock_gettime(CLOCK_REALTIME, &ts);
+      ts.tv_nsec += 100000000;
+      if (ts.tv_nsec >= 1000000000) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000;
+      }
+      pthread_cond_timedwait(&b->_cond, &b->_mutex, &ts);
+      continue;
+    }
+    const uint8_t max = strict_min((uint8_t) SPI_LINUX_MAX_CHAIN, b->maxChain);
+    int n = b->_take(ops, (max > 0) ? max : 1);
+    pthread_mutex_unlock(&b->_mutex);
+    b->runChain(ops, n);
+    pthread_mutex_lock(&b->_mutex);
+  }
+  pthread_mutex_unlock(&b->_mutex);
+  return nullptr;
+}
+
+
+/**
+* Opens every CS on the bus that has a device file, and starts the worker.
+*
+* @param  a  The adapter that owns the bus.
+* @return 0 on success, -1 if no device file could be opened, -2 if the
+*           thread couldn't be started.
+*/
+int8_t LinuxSPIBus::open(SPIAdapter* a) {
+  adapter = a;
+  if (nullptr == fake) {
+    uint8_t opened = 0;
+    for (uint8_t cs = 0; cs < SPI_LINUX_MAX_CS; cs++) {
+      char filename[24];
+      snprintf(filename, sizeof(filename), "/dev/spidev%u.%u", a->getAdapterId(), cs);
+      handles[cs] = ::open(filename, O_RDWR);
+      if (handles[cs] >= 0) {
+        uint8_t bits = 8;
+        ioctl(handles[cs], SPI_IOC_WR_BITS_PER_WORD, &bits);
+        ioctl(handles[cs], SPI_IOC_WR_MAX_SPEED_HZ, &speedHz);
+        opened++;
+      }
+    }
+    if (0 == opened) {
+      return -1;
+    }
+  }
+  if (nullptr == _params) {
+    _params = pool.take();
+  }
+  if (!_threaded) {
+    ManuvrThreadOptions _t_opts;
+    _t_opts.thread_name = (char*) "spi_worker";
+    _t_opts.stack_sz    = 8192;
+    if (0 != createThread(&_thread_id, nullptr, worker, (void*) this, &_t_opts)) {
+      close();
+      return -2;
+    }
+    _threaded = true;
+  }
+  _active = this;
+  return 0;
+}
+
+
+void LinuxSPIBus::close() {
+  for (uint8_t cs = 0; cs < SPI_LINUX_MAX_CS; cs++) {
+    if (handles[cs] >= 0) {
+      ::close(handles[cs]);
+      handles[cs] = -1;
+    }
+  }
+}
+
+
+/**
+* @param  cs  The chip-select.
+* @return true if ops for the given CS can be moved.
+*/
+bool LinuxSPIBus::online(uint8_t cs) {
+  if (cs >= SPI_LINUX_MAX_CS) return false;
+  return ((nullptr != fake) || (handles[cs] >= 0));
+}
+
+
+/**
+* Hands an op to the worker. Called from the Kernel's thread.
+*
+* @param  op  The op. Belongs to the worker until it is marked complete.
+* @return 0 on success, -1 if the ring is full.
+*/
+int8_t LinuxSPIBus::submit(SPIBusOp* op) {
+  int8_t ret = -1;
+  pthread_mutex_lock(&_mutex);
+  if (_count < SPI_LINUX_RING_SIZE) {
+    _ring[(_r + _count) % SPI_LINUX_RING_SIZE] = op;
+    _count++;
+    pthread_cond_signal(&_cond);
+    ret = 0;
+  }
+  pthread_mutex_unlock(&_mutex);
+  return ret;
+}
+
+
+/*
+* Takes up to max ops from the ring. Caller must hold the mutex.
+*/
+int LinuxSPIBus::_take(SPIBusOp** ops, int max) {
+  int n = 0;
+  while ((n < max) && (_count > 0)) {
+    ops[n++] = _ring[_r];
+    _r = (_r + 1) % SPI_LINUX_RING_SIZE;
+    _count--;
+  }
+  return n;
+}
+
+
+int LinuxSPIBus::_transfer(uint8_t cs, struct spi_ioc_transfer* xfers, int count) {
+  _transfers++;
+  if (nullptr != fake) {
+    return fake->transfer(cs, xfers, count);
+  }
+  // SPI_IOC_MESSAGE(count), without the array type that needs a constant.
+  return ioctl(handles[cs], _IOC(_IOC_WRITE, SPI_IOC_MAGIC, 0, SPI_MSGSIZE(count)), xfers);
+}
+
+
+/**
+* Moves the given ops on the bus, as few ioctls as possible. Consecutive ops
+*   for the same CS are chained, with CS released between them. Each op is
+*   marked complete (or failed) in order, and must not be touched afterward.
+*   Nothing is ever moved twice.
+*
+* @param  ops    The ops, in the order they were submitted.
+* @param  count  How many.
+*/
+void LinuxSPIBus::runChain(SPIBusOp** ops, int count) {
+  struct spi_ioc_transfer xfers[SPI_LINUX_MAX_CHAIN * 2];
+  alignas(SPI_LINUX_BUF_ALIGN) uint8_t fallback[SPI_LINUX_MAX_CHAIN * 4];
+  uint8_t* params = (nullptr != _params) ? _params : fallback;
+  int i = 0;
+  while (i < count) {
+    const int     first = i;
+    const uint8_t cs    = _cs_of(ops[i]);
+    int      m     = 0;
+    uint32_t total = 0;
+    memset(xfers, 0, sizeof(xfers));
+
+    while ((i < count) && ((i - first) < SPI_LINUX_MAX_CHAIN)) {
+      SPIBusOp* op = ops[i];
+      const uint8_t  plen = op->transferParamLength();
+      const uint16_t blen = op->buf_len;
+      if (cs != _cs_of(op)) break;                                   // Next chain.
+      if ((m > 0) && ((total + plen + blen) > SPI_LINUX_MAX_MESSAGE)) break;
+      uint8_t* tx = op->buf;
+      uint8_t* rx = op->buf;
+      bool chainable = ((plen + blen) <= SPI_LINUX_MAX_MESSAGE);  // The driver would refuse it.
+      switch (op->get_opcode()) {
+        case BusOpcode::RX:          tx = nullptr;  break;   // Clock out zeros.
+        case BusOpcode::TX:
+        case BusOpcode::TX_CMD:      rx = nullptr;  break;
+        case BusOpcode::TX_WAIT_RX:  break;                  // Full-duplex, in place.
+        default:                     chainable = false;  break;
+      }
+      if (!chainable) {
+        // Not something we can move. Fail it in its place.
+        if (0 == m) {
+          op->abort(XferFault::BAD_PARAM);
+          i++;
+        }
+        break;
+      }
+      if (plen) {
+        uint8_t* p = &params[(i - first) * 4];
+        for (uint8_t n = 0; n < plen; n++) p[n] = op->getTransferParam(n);
+        xfers[m].tx_buf        = (uintptr_t) p;
+        xfers[m].len           = plen;
+        xfers[m].speed_hz      = speedHz;
+        xfers[m].bits_per_word = 8;
+        m++;
+      }
+      if (blen && (nullptr != op->buf)) {
+        xfers[m].tx_buf        = (uintptr_t) tx;
+        xfers[m].rx_buf        = (uintptr_t) rx;
+        xfers[m].len           = blen;
+        xfers[m].speed_hz      = speedHz;
+        xfers[m].bits_per_word = 8;
+        m++;
+      }
+      xfers[m - 1].cs_change = 1;   // Release CS between ops.
+      total += plen + blen;
+      i++;
+    }
+    if (0 == m) continue;   // Only failed ops so far.
+    xfers[m - 1].cs_change = 0;     // On the last transfer, this would hold CS.
+
+    const int n = i - first;
+    _ops += n;
+    if (n > _deepest) _deepest = n;
+    if (_transfer(cs, xfers, m) >= 0) {
+      for (int j = first; j < i; j++) ops[j]->markComplete();
+    }
+    else {
+      // We can't know how far the chain got before it failed, and moving any
+      //   of it again might repeat a read or write that has side-effects. So
+      //   every op in the chain fails.
+      _failed++;
+      for (int j = first; j < i; j++) ops[j]->abort(XferFault::BUS_FAULT);
+    }
+  }
+}
+
+
+void LinuxSPIBus::printDebug(StringBuilder* output) {
+  output->concatf("-- Backend             %s\n", (nullptr != fake) ? "fake" : "spidev");
+  if (nullptr == fake) {
+    output->concat("-- Open CS             ");
+    for (uint8_t cs = 0; cs < SPI_LINUX_MAX_CS; cs++) {
+      if (handles[cs] >= 0) output->concatf("%u ", cs);
+    }
+    output->concat("\n");
+  }
+  pthread_mutex_lock(&_mutex);
+  output->concatf("-- Waiting for worker  %u\n", _count);
+  pthread_mutex_unlock(&_mutex);
+  output->concatf("-- Transfers/ops       %u/%u\n", _transfers, _ops);
+  output->concatf("-- Longest chain       %u (limit %u)\n", _deepest, maxChain);
+  output->concatf("-- Chains failed       %u\n", _failed);
+  pool.printDebug(output);
+}
+
+
 /*******************************************************************************
 * ######## ##     ## ######## ##    ## ########  ######
 * ##       ##     ## ##       ###   ##    ##    ##    ##
@@ -61,58 +360,91 @@ For instance: On a RasPi v1 with the kernel driver loaded we have...
 */
 int8_t SPIAdapter::attached() {
   if (EventReceiver::attached()) {
-    // We should init the SPI library...
-    //SPI.begin();
-    //SPI.setDataMode(SPI_MODE0);
-    //SPI.setClockDivider(SPI_CLOCK_DIV32);
+    bus_init();
+    if (busOnline()) {
+      advance_work_queue();
+    }
     return 1;
   }
   return 0;
 }
 
 
+/*******************************************************************************
+* ___     _                                  This is a template class for
+*  |   / / \ o    /\   _|  _. ._ _|_  _  ._  defining arbitrary I/O adapters.
+* _|_ /  \_/ o   /--\ (_| (_| |_) |_ (/_ |   Adapters must be instanced with
+*                             |              a BusOp as the template param.
+*******************************************************************************/
+
+int8_t SPIAdapter::bus_init() {
+  LinuxSPIBus* b = LinuxSPIBus::bus(getAdapterId());
+  if ((nullptr != b) && (0 == b->open(this))) {
+    busOnline(true);
+  }
+  #ifdef MANUVR_DEBUG
+  else if (getVerbosity() > 2) {
+    local_log.concatf("Failed to open SPI bus %d.\n", getAdapterId());
+    Kernel::log(&local_log);
+  }
+  #endif
+  return (busOnline() ? 0:-1);
+}
+
+
+int8_t SPIAdapter::bus_deinit() {
+  LinuxSPIBus* b = LinuxSPIBus::bus(getAdapterId());
+  if (nullptr != b) {
+    b->close();
+  }
+  busOnline(false);
+  return 0;
+}
+
+
+void SPIAdapter::printHardwareState(StringBuilder* output) {
+  output->concatf("-- SPI%d (%sline)\n", getAdapterId(), (busOnline()?"on":"OFF"));
+  LinuxSPIBus* b = LinuxSPIBus::bus(getAdapterId());
+  if (nullptr != b) {
+    b->printDebug(output);
+  }
+}
+
+
+/*******************************************************************************
+* ___     _                              These members are mandatory overrides
+*  |   / / \ o     |  _  |_              from the BusOp class.
+* _|_ /  \_/ o   \_| (_) |_)
+*******************************************************************************/
+
 /**
-* Calling this member will cause the bus operation to be started.
+* Calling this member will cause the bus operation to be started. On linux,
+*   that means handing it to the bus's worker thread.
 *
-* @return 0 on success, or non-zero on failure.
+* @return XferFault::NONE on success, or the reason the op was aborted.
 */
 XferFault SPIBusOp::begin() {
   //time_began    = micros();
-  //if (0 == _param_len) {
-  //  // Obvious invalidity. We must have at least one transfer parameter.
-  //  abort(XferFault::BAD_PARAM);
-  //  return XferFault::BAD_PARAM;
-  //}
-
-  //if (SPI1->SR & SPI_FLAG_BSY) {
-  //  Kernel::log("SPI op aborted before taking bus control.\n");
-  //  abort(XferFault::BUS_BUSY);
-  //  return XferFault::BUS_BUSY;
-  //}
-
-  set_state(XferState::INITIATE);  // Indicate that we now have bus control.
-
-  // NOTE: The linux SPI driver abstracts chip-select pins away from us. If the
-  //  CS pin number is set to 255, this fxn call loses its hardware implications
-  //  and degrades into a state-tracking marker.
-  _assert_cs(true);
-
-  if (_param_len) {
+  LinuxSPIBus* b = LinuxSPIBus::active();
+  if ((0 == _param_len) && ((0 == buf_len) || (nullptr == buf))) {
+    // Obvious invalidity. Nothing to move.
+    abort(XferFault::BAD_PARAM);
+  }
+  else if ((nullptr == b) || !b->online(_cs_of(this))) {
+    abort(XferFault::DEV_NOT_FOUND);
+  }
+  else if ((nullptr == callback) || (0 == callback->io_op_callahead(this))) {
+    // Until it is marked complete, the op belongs to the worker.
     set_state(XferState::ADDR);
-    for (int i = 0; i < _param_len; i++) {
-      SPI.transfer(xfer_params[i]);
+    if (0 == b->submit(this)) {
+      return XferFault::NONE;
     }
+    abort(XferFault::BUS_BUSY);
   }
-
-  if (buf_len) {
-    set_state((opcode == BusOpcode::TX) ? XferState::TX_WAIT : XferState::RX_WAIT);
-    for (int i = 0; i < buf_len; i++) {
-      SPI.transfer(*(buf + i));
-    }
+  else {
+    abort(XferFault::IO_RECALL);
   }
-
-  markComplete();
-  return XferFault::NONE;
+  return xfer_fault;
 }
 
 
@@ -123,9 +455,6 @@ XferFault SPIBusOp::begin() {
 * @return 0 on success. Non-zero on failure.
 */
 int8_t SPIBusOp::advance_operation(uint32_t status_reg, uint8_t data_reg) {
-  //debug_log.concatf("advance_op(0x%08x, 0x%02x)\n\t %s\n\t status: 0x%08x\n", status_reg, data_reg, getStateString(), (unsigned long) hspi1.State);
-  //Kernel::log(&debug_log);
-
   /* These are our transfer-size-invariant cases. */
   switch (xfer_state) {
     case XferState::COMPLETE:
@@ -137,11 +466,11 @@ int8_t SPIBusOp::advance_operation(uint32_t status_reg, uint8_t data_reg) {
       markComplete();
       return 0;
 
+    case XferState::ADDR:     // The worker has it.
     case XferState::FAULT:
       return 0;
 
     case XferState::QUEUED:
-    case XferState::ADDR:
     case XferState::STOP:
     case XferState::UNDEF:
 
@@ -154,3 +483,5 @@ int8_t SPIBusOp::advance_operation(uint32_t status_reg, uint8_t data_reg) {
 
   return -1;
 }
+
+#endif  // CONFIG_MANUVR_SUPPORT_SPI
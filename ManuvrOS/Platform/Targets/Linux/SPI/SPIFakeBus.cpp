@@ -0,0 +1,254 @@
+/*
+File:   SPIFakeBus.cpp
+Author: J. Ian Lindsay
+Date:   2026.10.18
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+An SPI bus in memory, for testing the linux SPI path without hardware.
+  Also home to the buffer pool, which has no platform dependencies.
+*/
+
+#include <Platform/Targets/Linux/SPI/LinuxSPI.h>
+
+#if defined(CONFIG_MANUVR_SUPPORT_SPI)
+#include <errno.h>
+#include <stdlib.h>
+
+
+/*******************************************************************************
+* Buffer pool                                                                  *
+*******************************************************************************/
+
+SPIBufferPool::SPIBufferPool(uint16_t slot_len, uint8_t slots) {
+  // Round the slot length up, so that every slot is aligned.
+  _slot_len = (slot_len + (SPI_LINUX_BUF_ALIGN - 1)) & ~(SPI_LINUX_BUF_ALIGN - 1);
+  _slots    = strict_min(slots, (uint8_t) 32);
+  void* mem = nullptr;
+  if (0 == posix_memalign(&mem, SPI_LINUX_BUF_ALIGN, (size_t) _slot_len * _slots)) {
+    _mem  = (uint8_t*) mem;
+    _free = (32 == _slots) ? 0xFFFFFFFF : ((1u << _slots) - 1);
+  }
+  else {
+    _slots = 0;
+  }
+}
+
+
+SPIBufferPool::~SPIBufferPool() {
+  if (nullptr != _mem) {
+    free(_mem);
+    _mem = nullptr;
+  }
+}
+
+
+/**
+* @return an aligned buffer of slotLength() bytes, or nullptr if none are free.
+*/
+uint8_t* SPIBufferPool::take() {
+  uint32_t f = __atomic_load_n(&_free, __ATOMIC_ACQUIRE);
+  while (0 != f) {
+    const uint32_t bit = f & (~f + 1);   // Lowest free slot.
+    if (__atomic_compare_exchange_n(&_free, &f, f & ~bit, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+      return _mem + ((size_t) __builtin_ctz(bit) * _slot_len);
+    }
+  }
+  __atomic_add_fetch(&_misses, 1, __ATOMIC_RELAXED);
+  return nullptr;
+}
+
+
+/**
+* Returns a buffer to the pool. Buffers that didn't come from here are ignored.
+*
+* @param  buf  A buffer that was returned by take().
+*/
+void SPIBufferPool::give(uint8_t* buf) {
+  if (owns(buf)) {
+    const uint32_t slot = (uint32_t) ((buf - _mem) / _slot_len);
+    __atomic_or_fetch(&_free, (1u << slot), __ATOMIC_RELEASE);
+  }
+}
+
+
+/**
+* @return true if the given pointer is the start of one of our slots.
+*/
+bool SPIBufferPool::owns(uint8_t* buf) {
+  if ((nullptr == _mem) || (buf < _mem) || (buf >= (_mem + ((size_t) _slot_len * _slots)))) {
+    return false;
+  }
+  return (0 == ((buf - _mem) % _slot_len));
+}
+
+
+uint8_t SPIBufferPool::available() {
+  return (uint8_t) __builtin_popcount(__atomic_load_n(&_free, __ATOMIC_ACQUIRE));
+}
+
+
+void SPIBufferPool::printDebug(StringBuilder* output) {
+  output->concatf("-- Buffer pool         %u/%u free (%u bytes each, %u misses)\n", available(), _slots, _slot_len, _misses);
+}
+
+
+/*******************************************************************************
+* Fake bus                                                                     *
+*******************************************************************************/
+
+SPIFakeBus::SPIFakeBus() {
+  memset(_devs, 0, sizeof(_devs));
+}
+
+
+SPIFakeBus::~SPIFakeBus() {
+  for (uint8_t i = 0; i < SPI_LINUX_MAX_CS; i++) {
+    if (nullptr != _devs[i].mem) free(_devs[i].mem);
+  }
+  memset(_devs, 0, sizeof(_devs));
+}
+
+
+/**
+* Puts a device with a zeroed register file on the given CS.
+*
+* @param  cs   The chip-select.
+* @param  len  The size of its register file. At most 128.
+* @return 0 on success, -1 if the CS is taken or out of range.
+*/
+int8_t SPIFakeBus::addDevice(uint8_t cs, uint16_t len) {
+  if ((cs >= SPI_LINUX_MAX_CS) || _devs[cs].present || (0 == len) || (len > 128)) {
+    return -1;
+  }
+  uint8_t* mem = (uint8_t*) malloc(len);
+  if (nullptr == mem) return -1;
+  memset(mem, 0, len);
+  _devs[cs].mem     = mem;
+  _devs[cs].len     = len;
+  _devs[cs].present = true;
+  return 0;
+}
+
+
+/**
+* Ties MISO to MOSI on the given CS.
+*
+* @param  cs   The chip-select.
+* @return 0 on success, -1 if the CS is taken or out of range.
+*/
+int8_t SPIFakeBus::addLoopback(uint8_t cs) {
+  if ((cs >= SPI_LINUX_MAX_CS) || _devs[cs].present) {
+    return -1;
+  }
+  _devs[cs].present  = true;
+  _devs[cs].loopback = true;
+  return 0;
+}
+
+
+/**
+* @param  cs  The chip-select.
+* @return the device's register file, or nullptr if there is no such device.
+*/
+uint8_t* SPIFakeBus::registers(uint8_t cs) {
+  return (cs < SPI_LINUX_MAX_CS) ? _devs[cs].mem : nullptr;
+}
+
+
+/*
+* One byte each way.
+*/
+uint8_t SPIFakeBus::_clock(FakeSPIDevice* dev, uint8_t mosi) {
+  if (dev->loopback) {
+    return mosi;
+  }
+  if (!dev->addressed) {
+    dev->addressed = true;
+    dev->reading   = (0 != (mosi & 0x80));
+    dev->ptr       = (mosi & 0x7F) % dev->len;
+    return 0;
+  }
+  uint8_t miso = 0;
+  if (dev->reading) {
+    miso = dev->mem[dev->ptr];
+  }
+  else {
+    dev->mem[dev->ptr] = mosi;
+  }
+  dev->ptr = (dev->ptr + 1) % dev->len;
+  return miso;
+}
+
+
+/**
+* Services a transfer array as spidev would. CS is asserted for the message,
+*   and released between transfers that ask for it with cs_change. A missing
+*   buffer clocks zeros out, or discards what comes in.
+* Like the driver, a message longer than the driver's buffer is refused.
+*
+* @param  cs     The chip-select.
+* @param  xfers  The transfers.
+* @param  count  How many.
+* @return the number of bytes moved, or -1 with errno set.
+*/
+int SPIFakeBus::transfer(uint8_t cs, struct spi_ioc_transfer* xfers, int count) {
+  if (transferCost) {
+    const uint32_t t0 = (uint32_t) micros();
+    while (((uint32_t) micros() - t0) < transferCost) {}
+  }
+  _transfers++;
+  if ((cs >= SPI_LINUX_MAX_CS) || !_devs[cs].present) {
+    errno = ENODEV;
+    return -1;
+  }
+  uint32_t total = 0;
+  for (int i = 0; i < count; i++) total += xfers[i].len;
+  if (total > 4096) {
+    errno = EMSGSIZE;
+    return -1;
+  }
+
+  FakeSPIDevice* dev = &_devs[cs];
+  dev->addressed = false;
+  for (int i = 0; i < count; i++) {
+    uint8_t* tx = (uint8_t*) (uintptr_t) xfers[i].tx_buf;
+    uint8_t* rx = (uint8_t*) (uintptr_t) xfers[i].rx_buf;
+    for (uint32_t n = 0; n < xfers[i].len; n++) {
+      const uint8_t miso = _clock(dev, (nullptr != tx) ? tx[n] : 0);
+      if (nullptr != rx) rx[n] = miso;
+    }
+    _segments++;
+    if (xfers[i].cs_change) {
+      dev->addressed = false;
+    }
+  }
+  _bytes += total;
+  return (int) total;
+}
+
+
+void SPIFakeBus::printDebug(StringBuilder* output) {
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < SPI_LINUX_MAX_CS; i++) {
+    if (_devs[i].present) n++;
+  }
+  output->concatf("-- Fake SPI bus (%u devices)\n", n);
+  output->concatf("-- Transfers           %u\n", _transfers);
+  output->concatf("-- Segments/bytes      %u/%u\n", _segments, _bytes);
+}
+
+#endif  // CONFIG_MANUVR_SUPPORT_SPI
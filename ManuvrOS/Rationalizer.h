@@ -72,6 +72,11 @@
   #define EVENT_MANAGER_PREALLOC_COUNT 8
 #endif
 
+// How many Arguments should come from preallocated memory? Zero disables.
+#ifndef ARGUMENT_PREALLOC_COUNT
+  #define ARGUMENT_PREALLOC_COUNT (EVENT_MANAGER_PREALLOC_COUNT * 4)
+#endif
+
 #ifndef MAXIMUM_SEQUENTIAL_SKIPS
   #define MAXIMUM_SEQUENTIAL_SKIPS 20
 #endif
@@ -20,44 +20,375 @@ limitations under the License.
 */
 
 
+
+
 #include <Kernel.h>
 
 #if defined(MANUVR_EVENT_PROFILER)
-  /**
-  * Constructor
-  */
-  TaskProfilerData::TaskProfilerData() {
-    msg_code         = 0;
-    run_time_last    = 0;
-    run_time_best    = 0xFFFFFFFF;   // Need __something__ to compare against...
-    run_time_worst   = 0;
-    run_time_average = 0;
-    run_time_total   = 0;
-    executions       = 0;   // How many times has this task been used?
-    profiling_active = false;
+/*******************************************************************************
+* LatencyHistogram                                                             *
+*******************************************************************************/
+
+LatencyHistogram::LatencyHistogram() {
+  reset();
+}
+
+
+void LatencyHistogram::reset() {
+  _total = 0;
+  _count = 0;
+  _min   = 0xFFFFFFFF;
+  _max   = 0;
+  memset(_buckets, 0, sizeof(_buckets));
+}
+
+
+/**
+* Which bucket holds the given value? Values below MSG_PROFILER_SUB_COUNT get a
+*   bucket of their own. Above that, the leading bit picks the octave, and the
+*   next MSG_PROFILER_SUB_BITS bits pick the bucket within it.
+*
+* @param  v  The value.
+* @return the bucket index.
+*/
+int LatencyHistogram::bucketOf(uint32_t v) {
+  if (v < MSG_PROFILER_SUB_COUNT) return (int) v;
+  const int shift = (31 - __builtin_clz(v)) - MSG_PROFILER_SUB_BITS;
+  return ((shift + 1) << MSG_PROFILER_SUB_BITS) + (int) ((v >> shift) & (MSG_PROFILER_SUB_COUNT - 1));
+}
+
+
+/**
+* @return the smallest value that lands in the given bucket.
+*/
+uint32_t LatencyHistogram::bucketFloor(int idx) {
+  if (idx < MSG_PROFILER_SUB_COUNT) return (uint32_t) idx;
+  const int shift = (idx >> MSG_PROFILER_SUB_BITS) - 1;
+  return ((uint32_t) ((idx & (MSG_PROFILER_SUB_COUNT - 1)) | MSG_PROFILER_SUB_COUNT)) << shift;
+}
+
+
+/**
+* @return the largest value that lands in the given bucket.
+*/
+uint32_t LatencyHistogram::bucketCeiling(int idx) {
+  if (idx < MSG_PROFILER_SUB_COUNT) return (uint32_t) idx;
+  const int shift = (idx >> MSG_PROFILER_SUB_BITS) - 1;
+  return bucketFloor(idx) + ((((uint32_t) 1) << shift) - 1);
+}
+
+
+void LatencyHistogram::record(uint32_t v) {
+  _buckets[bucketOf(v)]++;
+  _count++;
+  _total += v;
+  if (v < _min) _min = v;
+  if (v > _max) _max = v;
+}
+
+
+/**
+* Reports the given percentile as the upper edge of the bucket it falls in,
+*   but never more than the largest value actually seen.
+*
+* @param  per_mille  Which percentile, in tenths of a percent.
+* @return the value, or zero if nothing has been recorded.
+*/
+uint32_t LatencyHistogram::percentile(uint16_t per_mille) {
+  if (0 == _count) return 0;
+  if (per_mille > 1000) per_mille = 1000;
+  uint32_t target = (uint32_t) ((((uint64_t) _count) * per_mille + 999) / 1000);
+  if (0 == target) target = 1;
+  uint32_t seen = 0;
+  for (int i = 0; i < MSG_PROFILER_BUCKETS; i++) {
+    seen += _buckets[i];
+    if (seen >= target) {
+      const uint32_t ceiling = bucketCeiling(i);
+      return (ceiling < _max) ? ceiling : _max;
+    }
+  }
+  return _max;
+}
+
+
+/**
+* Writes each occupied bucket as a tab-separated "<upper edge>:<count>" pair.
+*
+* @param   StringBuilder* The buffer into which this fxn should write its output.
+*/
+void LatencyHistogram::printBuckets(StringBuilder* output) {
+  for (int i = 0; i < MSG_PROFILER_BUCKETS; i++) {
+    if (_buckets[i]) output->concatf("\t%u:%u", (unsigned long) bucketCeiling(i), (unsigned long) _buckets[i]);
+  }
+}
+
+
+
+/*******************************************************************************
+* TaskProfilerData                                                             *
+*******************************************************************************/
+
+/**
+* Constructor
+*/
+TaskProfilerData::TaskProfilerData() {
+  msg_code         = 0;
+  run_time_last    = 0;
+  run_time_best    = 0xFFFFFFFF;   // Need __something__ to compare against...
+  run_time_worst   = 0;
+  run_time_average = 0;
+  run_time_total   = 0;
+  executions       = 0;   // How many times has this task been used?
+  profiling_active = false;
+}
+
+/**
+* Destructor
+*/
+TaskProfilerData::~TaskProfilerData() {
+}
+
+
+/**
+* Accounts for one execution.
+*
+* @param  us  How long it ran, in microseconds.
+*/
+void TaskProfilerData::noteRunTime(uint32_t us) {
+  executions++;
+  run_time_last    = us;
+  run_time_best    = strict_min(run_time_best,  run_time_last);
+  run_time_worst   = strict_max(run_time_worst, run_time_last);
+  run_time_total  += run_time_last;
+  run_time_average = run_time_total / executions;
+  run_hist.record(us);
+}
+
+
+void TaskProfilerData::printDebug(StringBuilder *output) {
+  output->concatf("%18s  %9u %9u %9u %9u %9u %9u %9u   %9u %9u %9u %9u\n",
+    ManuvrMsg::getMsgTypeString(msg_code),
+    (unsigned long) executions,
+    (unsigned long) run_time_total,
+    (unsigned long) run_time_average,
+    (unsigned long) run_hist.percentile(500),
+    (unsigned long) run_hist.percentile(990),
+    (unsigned long) run_hist.percentile(999),
+    (unsigned long) run_time_worst,
+    (unsigned long) wait_hist.percentile(500),
+    (unsigned long) wait_hist.percentile(990),
+    (unsigned long) wait_hist.percentile(999),
+    (unsigned long) wait_hist.maximum()
+  );
+}
+
+
+void TaskProfilerData::printDebugHeader(StringBuilder *output) {
+  output->concat("\n\t\t Event          Execd  total us   average       p50       p99     p99.9     worst    wait50    wait99  wait99.9  waitmax\n");
+}
+
+
+/**
+* Machine-readable form of this data. One tab-separated line, matching
+*   dumpHeader(). If buckets is true, each histogram follows on its own line.
+*
+* @param   StringBuilder* The buffer into which this fxn should write its output.
+* @param   bool           Include the raw histograms?
+*/
+void TaskProfilerData::dump(StringBuilder* output, bool buckets) {
+  output->concatf("0x%04x\t%s\t%u\t%u\t%u\t%u\t%u\t%u\t%u\t%u\t%u\t%u\t%u\t%u\t%u\t%u\n",
+    (unsigned int) msg_code,
+    ManuvrMsg::getMsgTypeString(msg_code),
+    (unsigned long) run_hist.count(),
+    (unsigned long) run_hist.minimum(),
+    (unsigned long) run_hist.mean(),
+    (unsigned long) run_hist.percentile(500),
+    (unsigned long) run_hist.percentile(990),
+    (unsigned long) run_hist.percentile(999),
+    (unsigned long) run_hist.maximum(),
+    (unsigned long) wait_hist.count(),
+    (unsigned long) wait_hist.minimum(),
+    (unsigned long) wait_hist.mean(),
+    (unsigned long) wait_hist.percentile(500),
+    (unsigned long) wait_hist.percentile(990),
+    (unsigned long) wait_hist.percentile(999),
+    (unsigned long) wait_hist.maximum()
+  );
+  if (buckets) {
+    output->concatf("#run\t0x%04x", (unsigned int) msg_code);
+    run_hist.printBuckets(output);
+    output->concatf("\n#wait\t0x%04x", (unsigned int) msg_code);
+    wait_hist.printBuckets(output);
+    output->concat("\n");
   }
+}
+
 
-  /**
-  * Destructor
-  */
-  TaskProfilerData::~TaskProfilerData() {
+void TaskProfilerData::dumpHeader(StringBuilder* output) {
+  output->concat("#code\tlabel\truns\trun_min\trun_mean\trun_p50\trun_p99\trun_p999\trun_max\twaits\twait_min\twait_mean\twait_p50\twait_p99\twait_p999\twait_max\n");
+}
+
+
+
+/*******************************************************************************
+* MsgProfiler                                                                  *
+*******************************************************************************/
+
+/**
+* Slot for a message code in a table of the given (power-of-two) size.
+*/
+static inline uint16_t _profiler_hash(uint16_t code, uint16_t capacity) {
+  uint32_t h = code * 0x9E3779B1;
+  return (uint16_t) ((h ^ (h >> 16)) & (capacity - 1));
+}
+
+
+MsgProfiler::MsgProfiler() {
+  _entries  = nullptr;
+  _slots    = nullptr;
+  _capacity = 0;
+  _count    = 0;
+}
+
+
+MsgProfiler::~MsgProfiler() {
+  clear();
+}
+
+
+/**
+* Drops all collected data, and all memory that held it.
+*/
+void MsgProfiler::clear() {
+  for (uint16_t i = 0; i < _count; i++) {
+    delete _entries[i];
   }
+  free(_entries);
+  free(_slots);
+  _entries  = nullptr;
+  _slots    = nullptr;
+  _capacity = 0;
+  _count    = 0;
+}
 
 
-  void TaskProfilerData::printDebug(StringBuilder *output) {
-    output->concatf("%18s  %9u %9u %9u %9u %9u\n",
-      ManuvrMsg::getMsgTypeString(msg_code),
-      (unsigned long) run_time_total,
-      (unsigned long) run_time_average,
-      (unsigned long) run_time_worst,
-      (unsigned long) run_time_best,
-      (unsigned long) run_time_last
-    );
+/**
+* (Re)builds the index at the given size. The dense list can always hold half
+*   as many entries as there are slots.
+*
+* @param  capacity  Slot count. Must be a power of two.
+* @return 0 on success, -1 on allocation failure.
+*/
+int8_t MsgProfiler::_rehash(uint16_t capacity) {
+  uint16_t* nu_slots = (uint16_t*) malloc(capacity * sizeof(uint16_t));
+  TaskProfilerData** nu_entries = (TaskProfilerData**) malloc((capacity >> 1) * sizeof(TaskProfilerData*));
+  if ((nullptr == nu_slots) || (nullptr == nu_entries)) {
+    free(nu_slots);
+    free(nu_entries);
+    return -1;
+  }
+  memset(nu_slots, 0, capacity * sizeof(uint16_t));
+  for (uint16_t n = 0; n < _count; n++) {
+    nu_entries[n] = _entries[n];
+    uint16_t i = _profiler_hash((uint16_t) _entries[n]->msg_code, capacity);
+    while (0 != nu_slots[i]) i = (i + 1) & (capacity - 1);
+    nu_slots[i] = n + 1;
   }
+  free(_slots);
+  free(_entries);
+  _slots    = nu_slots;
+  _entries  = nu_entries;
+  _capacity = capacity;
+  return 0;
+}
 
 
-  void TaskProfilerData::printDebugHeader(StringBuilder *output) {
-    output->concat("\n\t\t Execd \t\t Event \t\t total us   average     worst    best      last\n");
+/**
+* @param  code  The message code.
+* @return the profile for the given code, or nullptr if we've never seen it.
+*/
+TaskProfilerData* MsgProfiler::lookup(uint16_t code) {
+  if (0 == _capacity) return nullptr;
+  uint16_t i = _profiler_hash(code, _capacity);
+  while (0 != _slots[i]) {
+    TaskProfilerData* item = _entries[_slots[i] - 1];
+    if (item->msg_code == code) return item;
+    i = (i + 1) & (_capacity - 1);
+  }
+  return nullptr;
+}
+
+
+/**
+* Finds the profile for the given code, creating it if it doesn't exist. The
+*   index doubles whenever it becomes half full.
+*
+* @param  code  The message code.
+* @return the profile, or nullptr on allocation failure.
+*/
+TaskProfilerData* MsgProfiler::profile(uint16_t code) {
+  TaskProfilerData* item = lookup(code);
+  if (nullptr != item) return item;
+
+  if (((_count + 1) * 2) > _capacity) {
+    if (_capacity & 0x8000) return nullptr;   // Full.
+    if (0 != _rehash((0 == _capacity) ? 16 : (_capacity << 1))) return nullptr;
+  }
+  item = new TaskProfilerData();
+  if (nullptr == item) return nullptr;
+  item->msg_code = code;
+  _entries[_count++] = item;
+
+  uint16_t i = _profiler_hash(code, _capacity);
+  while (0 != _slots[i]) i = (i + 1) & (_capacity - 1);
+  _slots[i] = _count;
+  return item;
+}
+
+
+/**
+* Prints the table, worst p99 run-time first. All times are in microseconds.
+*
+* @param   StringBuilder* The buffer into which this fxn should write its output.
+*/
+void MsgProfiler::printDebug(StringBuilder* output) {
+  if (0 == _count) {
+    output->concat("\t No messages profiled.\n");
+    return;
+  }
+  uint32_t p99[_count];
+  uint16_t order[_count];
+  for (uint16_t i = 0; i < _count; i++) {
+    const uint32_t p = _entries[i]->run_hist.percentile(990);
+    uint16_t n = i;
+    while ((n > 0) && (p99[n - 1] < p)) {
+      p99[n]   = p99[n - 1];
+      order[n] = order[n - 1];
+      n--;
+    }
+    p99[n]   = p;
+    order[n] = i;
+  }
+
+  TaskProfilerData::printDebugHeader(output);
+  for (uint16_t i = 0; i < _count; i++) {
+    output->concat("\t");
+    _entries[order[i]]->printDebug(output);
+  }
+}
+
+
+/**
+* Machine-readable form of the table, in order of first appearance.
+*
+* @param   StringBuilder* The buffer into which this fxn should write its output.
+* @param   bool           Include the raw histograms?
+*/
+void MsgProfiler::dump(StringBuilder* output, bool buckets) {
+  TaskProfilerData::dumpHeader(output);
+  for (uint16_t i = 0; i < _count; i++) {
+    _entries[i]->dump(output, buckets);
   }
+}
 
 #endif  //MANUVR_EVENT_PROFILER
@@ -41,7 +41,6 @@ extern "C" {
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
-#include <stdarg.h>
 #include <time.h>
 
 #ifdef __cplusplus
@@ -77,7 +76,6 @@ const DatumDef datum_defs[] = {
 };
 
 
-
 /*******************************************************************************
 *      _______.___________.    ___   .___________. __    ______     _______.
 *     /       |           |   /   \  |           ||  |  /      |   /       |
@@ -100,6 +98,150 @@ static int hex2int(char c) {
   return -1;
 }
 
+static inline int32_t _ubx_i32(const char* p) {
+  const uint8_t* b = (const uint8_t*) p;
+  return (int32_t) (b[0] | (b[1] << 8) | (b[2] << 16) | ((uint32_t) b[3] << 24));
+}
+
+
+/*
+* Field parsers. Each takes a single NUL-terminated field, and returns false
+*   if it is malformed. An empty field is not malformed.
+*/
+
+/* Single character field. */
+static char _field_char(const char* field) {
+  return minmea_isfield(*field) ? *field : '\0';
+}
+
+/* Single character direction field. */
+static bool _field_dir(const char* field, int* value) {
+  switch (*field) {
+    case 'N':
+    case 'E':
+      *value = 1;
+      return true;
+    case 'S':
+    case 'W':
+      *value = -1;
+      return true;
+    case '\0':
+      *value = 0;
+      return true;
+    default:
+      break;
+  }
+  return false;
+}
+
+/* Integer value, default 0. */
+static bool _field_int(const char* field, int* value) {
+  char* endptr;
+  *value = strtol(field, &endptr, 10);
+  return !minmea_isfield(*endptr);
+}
+
+/* Fractional value with scale. */
+static bool _field_float(const char* field, struct minmea_float* f) {
+  int sign = 0;
+  int_least32_t value = -1;
+  int_least32_t scale = 0;
+
+  while (minmea_isfield(*field)) {
+    if (*field == '+' && !sign && value == -1) {
+      sign = 1;
+    }
+    else if (*field == '-' && !sign && value == -1) {
+      sign = -1;
+    }
+    else if (isdigit((unsigned char) *field)) {
+      int digit = *field - '0';
+      if (value == -1) value = 0;
+      if (value > (INT_LEAST32_MAX-digit) / 10) {
+        // We ran out of bits. Truncate extra precision, but fail on overflow.
+        if (scale) break;
+        return false;
+      }
+      value = (10 * value) + digit;
+      if (scale) scale *= 10;
+    }
+    else if (*field == '.' && scale == 0) {
+      scale = 1;
+    }
+    else if (*field == ' ') {
+      // Allow spaces at the start of the field. Not NMEA conformant, but some
+      //   modules do this.
+      if (sign != 0 || value != -1 || scale != 0) return false;
+    }
+    else {
+      return false;
+    }
+    field++;
+  }
+
+  if ((sign || scale) && value == -1) return false;
+
+  if (value == -1) {
+    // No digits were scanned.
+    value = 0;
+    scale = 0;
+  }
+  else if (scale == 0) {
+    // No decimal point.
+    scale = 1;
+  }
+  if (sign) value *= sign;
+  f->value = value;
+  f->scale = scale;
+  return true;
+}
+
+/* Date, -1 if empty. Always six digits. */
+static bool _field_date(const char* field, struct minmea_date* date) {
+  date->day   = -1;
+  date->month = -1;
+  date->year  = -1;
+  if (minmea_isfield(*field)) {
+    for (int f = 0; f < 6; f++) {
+      if (!isdigit((unsigned char) field[f])) return false;
+    }
+    date->day   = (field[0] - '0') * 10 + (field[1] - '0');
+    date->month = (field[2] - '0') * 10 + (field[3] - '0');
+    date->year  = (field[4] - '0') * 10 + (field[5] - '0');
+  }
+  return true;
+}
+
+/* Time, -1 if empty. Fractional seconds are saved as microseconds. */
+static bool _field_time(const char* field, struct minmea_time* time_) {
+  time_->hours        = -1;
+  time_->minutes      = -1;
+  time_->seconds      = -1;
+  time_->microseconds = -1;
+  if (minmea_isfield(*field)) {
+    // Minimum required: integer time.
+    for (int f = 0; f < 6; f++) {
+      if (!isdigit((unsigned char) field[f])) return false;
+    }
+    time_->hours   = (field[0] - '0') * 10 + (field[1] - '0');
+    time_->minutes = (field[2] - '0') * 10 + (field[3] - '0');
+    time_->seconds = (field[4] - '0') * 10 + (field[5] - '0');
+    field += 6;
+
+    int value = 0;
+    if (*field++ == '.') {
+      int scale = 1000000;
+      while (isdigit((unsigned char) *field) && scale > 1) {
+        value = (value * 10) + (*field++ - '0');
+        scale /= 10;
+      }
+      value *= scale;
+    }
+    time_->microseconds = value;
+  }
+  return true;
+}
+
 
 /*******************************************************************************
 *   ___ _              ___      _ _              _      _
@@ -127,7 +269,6 @@ ManuvrGPS::ManuvrGPS(BufferPipe* src) : ManuvrGPS() {
 
 
 ManuvrGPS::~ManuvrGPS() {
-  _accumulator.clear();
 }
 
 
@@ -158,8 +299,8 @@ int8_t ManuvrGPS::fromCounterparty(ManuvrPipeSignal _sig, void* _args) {
   switch (_sig) {
     case ManuvrPipeSignal::XPORT_CONNECT:
     case ManuvrPipeSignal::XPORT_DISCONNECT:
-      // If we lose or gain a connection, wipe the buffer.
-      _accumulator.clear();
+      // If we lose or gain a connection, drop whatever we were in the middle of.
+      _reset_parser();
       return 1;
 
     case ManuvrPipeSignal::FAR_SIDE_DETACH:   // The far side is detaching.
@@ -190,21 +331,38 @@ int8_t ManuvrGPS::toCounterparty(StringBuilder* buf, int8_t mm) {
 
 
 /**
-* Outward toward the application (or into the accumulator).
+* Outward toward the application. The buffer is parsed as it stands, and
+*   consumed.
 *
 * @param  buf    A pointer to the buffer.
 * @param  mm     A declaration of memory-management responsibility.
 * @return A declaration of memory-management responsibility.
 */
 int8_t ManuvrGPS::fromCounterparty(StringBuilder* buf, int8_t mm) {
-  _accumulator.concatHandoff(buf);
-  if (MINMEA_MAX_LENGTH < _accumulator.length()) {
-    _attempt_parse();
-  }
+  _feed(buf->string(), buf->length());
+  buf->clear();
   return MEM_MGMT_RESPONSIBLE_BEARER;   // We take responsibility.
 }
 
 
+/**
+* Outward toward the application. Each segment is parsed where it lies, so
+*   the slice is never made contiguous.
+*
+* @param  buf    A pointer to the slice.
+* @param  mm     A declaration of memory-management responsibility.
+* @return A declaration of memory-management responsibility.
+*/
+int8_t ManuvrGPS::fromCounterparty(BufferSlice* buf, int8_t mm) {
+  for (int i = 0; i < buf->segments(); i++) {
+    unsigned int len = 0;
+    uint8_t* seg = buf->segment(i, &len);
+    _feed(seg, len);
+  }
+  return MEM_MGMT_RESPONSIBLE_BEARER;
+}
+
+
 /*******************************************************************************
 *  ,-.                      ,   .
 * (   `                     | . |
@@ -214,7 +372,7 @@ int8_t ManuvrGPS::fromCounterparty(StringBuilder* buf, int8_t mm) {
 ******************************************|***|********************************/
 
 SensorError ManuvrGPS::init() {
-  _accumulator.clear();
+  _reset_parser();
   return haveNear() ? SensorError::NO_ERROR : SensorError::BUS_ERROR;
 }
 
@@ -256,679 +414,488 @@ const char* ManuvrGPS::_get_string_by_sentence_id(enum minmea_sentence_id id) {
 }
 
 
-enum minmea_sentence_id ManuvrGPS::_sentence_id(const char *sentence, bool strict) {
-  if (_check(sentence, strict)) {
-    char type[6];
-    if (_scan(sentence, "t", type)) {
-      uint32_t int_sent_code = (type[2] << 16) + (type[3] << 8) + (type[4]);
-      switch (int_sent_code) {
-        case MINMEA_INT_SENTENCE_CODE_RMC:  return MINMEA_SENTENCE_RMC;
-        case MINMEA_INT_SENTENCE_CODE_GGA:  return MINMEA_SENTENCE_GGA;
-        case MINMEA_INT_SENTENCE_CODE_GSA:  return MINMEA_SENTENCE_GSA;
-        case MINMEA_INT_SENTENCE_CODE_GLL:  return MINMEA_SENTENCE_GLL;
-        case MINMEA_INT_SENTENCE_CODE_GST:  return MINMEA_SENTENCE_GST;
-        case MINMEA_INT_SENTENCE_CODE_GSV:  return MINMEA_SENTENCE_GSV;
-        case MINMEA_INT_SENTENCE_CODE_VTG:  return MINMEA_SENTENCE_VTG;
-        default:                            return MINMEA_UNKNOWN;
-      }
+static const char* _get_string_by_parse_state(GPSParseState s) {
+  switch (s) {
+    case GPSParseState::HUNT:          return "HUNT";
+    case GPSParseState::NMEA_BODY:     return "NMEA_BODY";
+    case GPSParseState::NMEA_CSUM_HI:  return "NMEA_CSUM_HI";
+    case GPSParseState::NMEA_CSUM_LO:  return "NMEA_CSUM_LO";
+    case GPSParseState::NMEA_EOL:      return "NMEA_EOL";
+    case GPSParseState::UBX_SYNC:      return "UBX_SYNC";
+    case GPSParseState::UBX_HEADER:    return "UBX_HEADER";
+    case GPSParseState::UBX_PAYLOAD:   return "UBX_PAYLOAD";
+    case GPSParseState::UBX_CK_A:      return "UBX_CK_A";
+    case GPSParseState::UBX_CK_B:      return "UBX_CK_B";
+  }
+  return "xxx";
+}
+
+
+/**
+* The talker and sentence identifier is the first field, less its '$'.
+*/
+enum minmea_sentence_id ManuvrGPS::_sentence_id() {
+  const char* type = _field(0);
+  for (int f = 0; f < 5; f++) {
+    if (!minmea_isfield(type[f])) return MINMEA_INVALID;
+  }
+  if ('\0' != type[5]) return MINMEA_INVALID;
+  uint32_t int_sent_code = (type[2] << 16) + (type[3] << 8) + (type[4]);
+  switch (int_sent_code) {
+    case MINMEA_INT_SENTENCE_CODE_RMC:  return MINMEA_SENTENCE_RMC;
+    case MINMEA_INT_SENTENCE_CODE_GGA:  return MINMEA_SENTENCE_GGA;
+    case MINMEA_INT_SENTENCE_CODE_GSA:  return MINMEA_SENTENCE_GSA;
+    case MINMEA_INT_SENTENCE_CODE_GLL:  return MINMEA_SENTENCE_GLL;
+    case MINMEA_INT_SENTENCE_CODE_GST:  return MINMEA_SENTENCE_GST;
+    case MINMEA_INT_SENTENCE_CODE_GSV:  return MINMEA_SENTENCE_GSV;
+    case MINMEA_INT_SENTENCE_CODE_VTG:  return MINMEA_SENTENCE_VTG;
+    default:                            return MINMEA_UNKNOWN;
+  }
+}
+
+
+void ManuvrGPS::_reset_parser() {
+  _state       = GPSParseState::HUNT;
+  _line_len    = 0;
+  _field_count = 0;
+}
+
+
+void ManuvrGPS::_nmea_begin() {
+  _state       = GPSParseState::NMEA_BODY;
+  _line_len    = 0;
+  _fields[0]   = 0;
+  _field_count = 1;
+  _csum        = 0;
+  _csum_given  = false;
+}
+
+
+/**
+* Called on the line ending of an NMEA sentence. The checksum, if there was
+*   one, has been collected. The fields are already split and terminated.
+*/
+void ManuvrGPS::_nmea_end() {
+  _state = GPSParseState::HUNT;
+  if ((!_csum_given) || (_csum == _csum_rx)) {
+    if (_dispatch_nmea()) {
+      _sentences_parsed++;
+      return;
     }
   }
-  return MINMEA_INVALID;
+  _sentences_rejected++;
+  #if defined(MANUVR_DEBUG)
+    StringBuilder _log;
+    _log.concatf("$%s sentence is not parsed.\n", _field(0));
+    Kernel::log(&_log);
+  #endif
 }
 
 
-bool ManuvrGPS::_attempt_parse() {
-  if (_accumulator.split("\n") == 0) return false;
-  char* line = nullptr;
-  bool local_success = false;
-  StringBuilder _log;
+void ManuvrGPS::_ubx_end() {
+  _state = GPSParseState::HUNT;
+  if (_dispatch_ubx()) {
+    _sentences_parsed++;
+  }
+  else {
+    _sentences_rejected++;
+  }
+}
 
-  while (_accumulator.count() > 1) {
-    line = _accumulator.position(0);
-    enum minmea_sentence_id id = _sentence_id(line, false);
-    switch (id) {
-      case MINMEA_SENTENCE_GSA:
-        {
-          struct minmea_sentence_gsa frame;
-          if (_parse_gsa(&frame, line)) {
-            local_success = true;
-          }
+
+/**
+* The parser proper. Takes bytes as they come, in any quantity, and acts on
+*   each sentence or frame as its last byte arrives.
+*
+* @param  buf    The bytes.
+* @param  len    How many of them.
+*/
+void ManuvrGPS::_feed(const uint8_t* buf, unsigned int len) {
+  for (unsigned int i = 0; i < len; i++) {
+    const uint8_t c = buf[i];
+    switch (_state) {
+      case GPSParseState::HUNT:
+        if ('$' == c) {
+          _nmea_begin();
         }
-        break;
-      case MINMEA_SENTENCE_GLL:
-        {
-          struct minmea_sentence_gll frame;
-          if (_parse_gll(&frame, line)) {
-            local_success = true;
-          }
+        else if (UBX_SYNC_CHAR_1 == c) {
+          _state = GPSParseState::UBX_SYNC;
         }
         break;
-      case MINMEA_SENTENCE_RMC:
-        {
-          struct minmea_sentence_rmc frame;
-          if (_parse_rmc(&frame, line)) {
-            local_success = true;
-            updateDatum(1, minmea_tocoord(&frame.latitude));
-            updateDatum(2, minmea_tocoord(&frame.longitude));
-              // _log.concatf("$xxRMC: raw coordinates and speed: (%d/%d,%d/%d) %d/%d\n",
-              //         frame.latitude.value, frame.latitude.scale,
-              //         frame.longitude.value, frame.longitude.scale,
-              //         frame.speed.value, frame.speed.scale);
-              // _log.concatf("$xxRMC fixed-point coordinates and speed scaled to three decimal places: (%d,%d) %d\n",
-              //         minmea_rescale(&frame.latitude, 1000),
-              //         minmea_rescale(&frame.longitude, 1000),
-              //         minmea_rescale(&frame.speed, 1000));
-              // _log.concatf("$xxRMC floating point degree coordinates and speed: (%f,%f) %f\n",
-              //         (double) minmea_tocoord(&frame.latitude),
-              //         (double) minmea_tocoord(&frame.longitude),
-              //         (double) minmea_tofloat(&frame.speed));
+
+      case GPSParseState::NMEA_BODY:
+        if (_line_len >= MINMEA_MAX_LENGTH) {
+          // Too long to be a sentence. Fall through to the reject below.
+        }
+        else if (',' == c) {
+          _csum ^= c;
+          _line[_line_len++] = '\0';
+          if (_field_count < MINMEA_MAX_FIELDS) {
+            _fields[_field_count++] = _line_len;
           }
+          break;
+        }
+        else if ('*' == c) {
+          _line[_line_len++] = '\0';
+          _csum_given = true;
+          _state = GPSParseState::NMEA_CSUM_HI;
+          break;
+        }
+        else if (('\r' == c) || ('\n' == c)) {
+          // No checksum. We'll take it anyway.
+          _line[_line_len++] = '\0';
+          _nmea_end();
+          break;
+        }
+        else if (isprint(c) && ('$' != c)) {
+          _csum ^= c;
+          _line[_line_len++] = (char) c;
+          break;
+        }
+        // Anything else ruins the sentence in progress. It might also be the
+        //   start of the next thing.
+        _sentences_rejected++;
+        _state = GPSParseState::HUNT;
+        if ('$' == c) {
+          _nmea_begin();
+        }
+        else if (UBX_SYNC_CHAR_1 == c) {
+          _state = GPSParseState::UBX_SYNC;
         }
         break;
-      case MINMEA_SENTENCE_GGA:
+
+      case GPSParseState::NMEA_CSUM_HI:
+      case GPSParseState::NMEA_CSUM_LO:
         {
-          struct minmea_sentence_gga frame;
-          if (_parse_gga(&frame, line)) {
-            local_success = true;
-            //_log.concatf("$xxGGA: fix quality: %d\n", frame.fix_quality);
+          int nib = hex2int((char) c);
+          if (nib < 0) {
+            _sentences_rejected++;
+            _state = GPSParseState::HUNT;
+            if ('$' == c) _nmea_begin();
+          }
+          else if (GPSParseState::NMEA_CSUM_HI == _state) {
+            _csum_rx = (uint8_t) (nib << 4);
+            _state = GPSParseState::NMEA_CSUM_LO;
+          }
+          else {
+            _csum_rx |= (uint8_t) nib;
+            _state = GPSParseState::NMEA_EOL;
           }
         }
         break;
-      case MINMEA_SENTENCE_GST:
-        {
-          struct minmea_sentence_gst frame;
-          if (_parse_gst(&frame, line)) {
-            local_success = true;
-              // _log.concatf("$xxGST: raw latitude,longitude and altitude error deviation: (%d/%d,%d/%d,%d/%d)\n",
-              //         frame.latitude_error_deviation.value, frame.latitude_error_deviation.scale,
-              //         frame.longitude_error_deviation.value, frame.longitude_error_deviation.scale,
-              //         frame.altitude_error_deviation.value, frame.altitude_error_deviation.scale);
-              // _log.concatf("$xxGST fixed point latitude,longitude and altitude error deviation"
-              //        " scaled to one decimal place: (%d,%d,%d)\n",
-              //         minmea_rescale(&frame.latitude_error_deviation, 10),
-              //         minmea_rescale(&frame.longitude_error_deviation, 10),
-              //         minmea_rescale(&frame.altitude_error_deviation, 10));
-              // _log.concatf("$xxGST floating point degree latitude, longitude and altitude error deviation: (%f,%f,%f)",
-              //         (double) minmea_tofloat(&frame.latitude_error_deviation),
-              //         (double) minmea_tofloat(&frame.longitude_error_deviation),
-              //         (double) minmea_tofloat(&frame.altitude_error_deviation));
-          }
+
+      case GPSParseState::NMEA_EOL:
+        // Anything between the checksum and the line ending is ignored.
+        if (('\r' == c) || ('\n' == c)) {
+          _nmea_end();
+        }
+        else if ('$' == c) {
+          // The line ending went missing.
+          _nmea_end();
+          _nmea_begin();
         }
         break;
-      case MINMEA_SENTENCE_GSV:
-        {
-          struct minmea_sentence_gsv frame;
-          if (_parse_gsv(&frame, line)) {
-            local_success = true;
-              // _log.concatf("$xxGSV: message %d of %d\n", frame.msg_nr, frame.total_msgs);
-              // _log.concatf("$xxGSV: sattelites in view: %d\n", frame.total_sats);
-              // for (int i = 0; i < 4; i++)
-              //     _log.concatf("$xxGSV: sat nr %d, elevation: %d, azimuth: %d, snr: %d dbm\n",
-              //         frame.sats[i].nr,
-              //         frame.sats[i].elevation,
-              //         frame.sats[i].azimuth,
-              //         frame.sats[i].snr);
-          }
+
+      case GPSParseState::UBX_SYNC:
+        if (UBX_SYNC_CHAR_2 == c) {
+          _state    = GPSParseState::UBX_HEADER;
+          _line_len = 0;
+          _csum     = 0;
+          _csum_b   = 0;
+        }
+        else if ('$' == c) {
+          _nmea_begin();
+        }
+        else if (UBX_SYNC_CHAR_1 != c) {
+          _state = GPSParseState::HUNT;
         }
         break;
-      case MINMEA_SENTENCE_VTG:
-        {
-          struct minmea_sentence_vtg frame;
-          if (_parse_vtg(&frame, line)) {
-            local_success = true;
-            updateDatum(0, minmea_tofloat(&frame.speed_kph));
-
-              // _log.concatf("$xxVTG: true track degrees = %f\n",
-              //        (double) minmea_tofloat(&frame.true_track_degrees));
-              // _log.concatf("        magnetic track degrees = %f\n",
-              //        (double) minmea_tofloat(&frame.magnetic_track_degrees));
-              // _log.concatf("        speed knots = %f\n",
-              //         (double) minmea_tofloat(&frame.speed_knots));
-              // _log.concatf("        speed kph = %f\n",
-              //         (double) minmea_tofloat(&frame.speed_kph));
+
+      case GPSParseState::UBX_HEADER:
+      case GPSParseState::UBX_PAYLOAD:
+        // Class, ID, and length occupy the first four bytes of _line. The
+        //   payload follows.
+        _csum   += c;
+        _csum_b += _csum;
+        _line[_line_len++] = (char) c;
+        if (4 == _line_len) {
+          _ubx_len = (uint8_t) _line[2] | ((uint16_t) (uint8_t) _line[3] << 8);
+          if (_ubx_len > (sizeof(_line) - 4)) {
+            // Nothing we understand is that long. Most likely, the sync was
+            //   a coincidence in NMEA, and the sentences that follow are good.
+            _sentences_rejected++;
+            _state = GPSParseState::HUNT;
+            break;
           }
+          _state = GPSParseState::UBX_PAYLOAD;
+        }
+        if ((GPSParseState::UBX_PAYLOAD == _state) && (_line_len >= (4 + _ubx_len))) {
+          _state = GPSParseState::UBX_CK_A;
         }
         break;
-      case MINMEA_INVALID:
-      default:
-        break;
-    }
-    if (local_success) {
-      _sentences_parsed++;
-    }
-    else {
-      _sentences_rejected++;
-      _log.concatf("$xx%s sentence is not parsed: \n%s\n", _get_string_by_sentence_id(id), (const char*) line);
-    }
-    _accumulator.drop_position(0);
-  }
-  Kernel::log(&_log);
-  return true;
-}
 
+      case GPSParseState::UBX_CK_A:
+        _csum_rx = c;
+        _state = GPSParseState::UBX_CK_B;
+        break;
 
-void ManuvrGPS::printDebug(StringBuilder* output) {
-  BufferPipe::printDebug(output);
-  output->concatf("\tSentences\n\t-------------\n\tParsed %u\n\tReject %u\n", _sentences_parsed, _sentences_rejected);
-
-  if (_accumulator.length() > 0) {
-    output->concatf("\n\taccumulator (%d bytes):  ", _accumulator.length());
-    _accumulator.printDebug(output);
+      case GPSParseState::UBX_CK_B:
+        if ((_csum_rx == _csum) && (c == _csum_b)) {
+          _ubx_end();
+        }
+        else {
+          _sentences_rejected++;
+          _state = GPSParseState::HUNT;
+        }
+        break;
+    }
   }
 }
 
 
-uint8_t ManuvrGPS::_checksum(const char *sentence) {
-  // Support senteces with or without the starting dollar sign.
-  if (*sentence == '$') sentence++;
-  uint8_t checksum = 0x00;
-
-  // The optional checksum is an XOR of all bytes between "$" and "*".
-  while (*sentence && *sentence != '*') checksum ^= *sentence++;
-  return checksum;
-}
-
-
-bool ManuvrGPS::_check(const char *sentence, bool strict) {
-  // Sequence length is limited.
-  if (strlen(sentence) <= MINMEA_MAX_LENGTH + 3) {
-    // A valid sentence starts with "$".
-    if (*sentence++ == '$') {
-      // The optional checksum is an XOR of all bytes between "$" and "*".
-      uint8_t checksum = 0x00;
-      while (*sentence && *sentence != '*' && isprint((unsigned char) *sentence)) {
-        checksum ^= *sentence++;
+/**
+* Parses the completed NMEA sentence, and updates any data it bears on.
+*
+* @return true if the sentence was understood.
+*/
+bool ManuvrGPS::_dispatch_nmea() {
+  switch (_sentence_id()) {
+    case MINMEA_SENTENCE_GSA:
+      {
+        struct minmea_sentence_gsa frame;
+        return _parse_gsa(&frame);
+      }
+    case MINMEA_SENTENCE_GLL:
+      {
+        struct minmea_sentence_gll frame;
+        return _parse_gll(&frame);
+      }
+    case MINMEA_SENTENCE_RMC:
+      {
+        struct minmea_sentence_rmc frame;
+        if (_parse_rmc(&frame)) {
+          updateDatum(1, minmea_tocoord(&frame.latitude));
+          updateDatum(2, minmea_tocoord(&frame.longitude));
+          return true;
+        }
       }
-      if (*sentence == '*') {
-        // If checksum is present, extract and compare it.
-        sentence++;
-        int upper = hex2int(*sentence++);
-        if (upper != -1) {
-          int lower = hex2int(*sentence++);
-          if (lower != -1) {
-            int expected = upper << 4 | lower;
-            // Check for checksum mismatch.
-            return (checksum == expected);
+      break;
+    case MINMEA_SENTENCE_GGA:
+      {
+        struct minmea_sentence_gga frame;
+        if (_parse_gga(&frame)) {
+          if ('M' == frame.altitude_units) {
+            updateDatum(3, minmea_tofloat(&frame.altitude));
           }
+          return true;
         }
       }
-      else if (*sentence && (!strict) && ((*sentence == '\n') || (*sentence == '\r'))) {
-        // The only stuff allowed at this point is a newline, and then only if
-        //   strict mode is false.
-        return true;
+      break;
+    case MINMEA_SENTENCE_GST:
+      {
+        struct minmea_sentence_gst frame;
+        return _parse_gst(&frame);
+      }
+    case MINMEA_SENTENCE_GSV:
+      {
+        struct minmea_sentence_gsv frame;
+        return _parse_gsv(&frame);
       }
-    }
+    case MINMEA_SENTENCE_VTG:
+      {
+        struct minmea_sentence_vtg frame;
+        if (_parse_vtg(&frame)) {
+          // The speed datum is a double.
+          updateDatum(0, (double) minmea_tofloat(&frame.speed_kph));
+          return true;
+        }
+      }
+      break;
+    case MINMEA_UNKNOWN:
+    case MINMEA_INVALID:
+    default:
+      break;
   }
   return false;
 }
 
 
-
-
-/*******************************************************************************
-* Undigested GPS functions                                                     *
-*******************************************************************************/
-
-bool ManuvrGPS::_scan(const char *sentence, const char *format, ...) {
-  bool result = false;
-  bool optional = false;
-  va_list ap;
-  va_start(ap, format);
-
-  const char *field = sentence;
-#define next_field() \
-    do { \
-        /* Progress to the next field. */ \
-        while (minmea_isfield(*sentence)) \
-            sentence++; \
-        /* Make sure there is a field there. */ \
-        if (*sentence == ',') { \
-            sentence++; \
-            field = sentence; \
-        } else { \
-            field = nullptr; \
-        } \
-    } while (0)
-
-    while (*format) {
-        char type = *format++;
-
-        if (type == ';') {
-            // All further fields are optional.
-            optional = true;
-            continue;
-        }
-
-        if (!field && !optional) {
-            // Field requested but we ran out if input. Bail out.
-            goto parse_error;
-        }
-
-        switch (type) {
-            case 'c': { // Single character field (char).
-                char value = '\0';
-
-                if (field && minmea_isfield(*field))
-                    value = *field;
-
-                *va_arg(ap, char *) = value;
-            } break;
-
-            case 'd': { // Single character direction field (int).
-                int value = 0;
-
-                if (field && minmea_isfield(*field)) {
-                    switch (*field) {
-                        case 'N':
-                        case 'E':
-                            value = 1;
-                            break;
-                        case 'S':
-                        case 'W':
-                            value = -1;
-                            break;
-                        default:
-                            goto parse_error;
-                    }
-                }
-
-                *va_arg(ap, int *) = value;
-            } break;
-
-            case 'f': { // Fractional value with scale (struct minmea_float).
-                int sign = 0;
-                int_least32_t value = -1;
-                int_least32_t scale = 0;
-
-                if (field) {
-                    while (minmea_isfield(*field)) {
-                        if (*field == '+' && !sign && value == -1) {
-                            sign = 1;
-                        } else if (*field == '-' && !sign && value == -1) {
-                            sign = -1;
-                        } else if (isdigit((unsigned char) *field)) {
-                            int digit = *field - '0';
-                            if (value == -1)
-                                value = 0;
-                            if (value > (INT_LEAST32_MAX-digit) / 10) {
-                                /* we ran out of bits, what do we do? */
-                                if (scale) {
-                                    /* truncate extra precision */
-                                    break;
-                                } else {
-                                    /* integer overflow. bail out. */
-                                    goto parse_error;
-                                }
-                            }
-                            value = (10 * value) + digit;
-                            if (scale)
-                                scale *= 10;
-                        } else if (*field == '.' && scale == 0) {
-                            scale = 1;
-                        } else if (*field == ' ') {
-                            /* Allow spaces at the start of the field. Not NMEA
-                             * conformant, but some modules do this. */
-                            if (sign != 0 || value != -1 || scale != 0)
-                                goto parse_error;
-                        } else {
-                            goto parse_error;
-                        }
-                        field++;
-                    }
-                }
-
-                if ((sign || scale) && value == -1)
-                    goto parse_error;
-
-                if (value == -1) {
-                    /* No digits were scanned. */
-                    value = 0;
-                    scale = 0;
-                } else if (scale == 0) {
-                    /* No decimal point. */
-                    scale = 1;
-                }
-                if (sign)
-                    value *= sign;
-
-                *va_arg(ap, struct minmea_float *) = (struct minmea_float) {value, scale};
-            } break;
-
-            case 'i': { // Integer value, default 0 (int).
-                int value = 0;
-
-                if (field) {
-                    char *endptr;
-                    value = strtol(field, &endptr, 10);
-                    if (minmea_isfield(*endptr))
-                        goto parse_error;
-                }
-
-                *va_arg(ap, int *) = value;
-            } break;
-
-            case 's': { // String value (char *).
-                char *buf = va_arg(ap, char *);
-
-                if (field) {
-                    while (minmea_isfield(*field))
-                        *buf++ = *field++;
-                }
-
-                *buf = '\0';
-            } break;
-
-            case 't': { // NMEA talker+sentence identifier (char *).
-                // This field is always mandatory.
-                if (!field)
-                    goto parse_error;
-
-                if (field[0] != '$')
-                    goto parse_error;
-                for (int f=0; f<5; f++)
-                    if (!minmea_isfield(field[1+f]))
-                        goto parse_error;
-
-                char *buf = va_arg(ap, char *);
-                memcpy(buf, field+1, 5);
-                buf[5] = '\0';
-            } break;
-
-            case 'D': { // Date (int, int, int), -1 if empty.
-                struct minmea_date *date = va_arg(ap, struct minmea_date *);
-
-                int d = -1, m = -1, y = -1;
-
-                if (field && minmea_isfield(*field)) {
-                    // Always six digits.
-                    for (int f=0; f<6; f++)
-                        if (!isdigit((unsigned char) field[f]))
-                            goto parse_error;
-
-                    char dArr[] = {field[0], field[1], '\0'};
-                    char mArr[] = {field[2], field[3], '\0'};
-                    char yArr[] = {field[4], field[5], '\0'};
-                    d = strtol(dArr, nullptr, 10);
-                    m = strtol(mArr, nullptr, 10);
-                    y = strtol(yArr, nullptr, 10);
-                }
-
-                date->day = d;
-                date->month = m;
-                date->year = y;
-            } break;
-
-            case 'T': { // Time (int, int, int, int), -1 if empty.
-                struct minmea_time *time_ = va_arg(ap, struct minmea_time *);
-
-                int h = -1, i = -1, s = -1, u = -1;
-
-                if (field && minmea_isfield(*field)) {
-                    // Minimum required: integer time.
-                    for (int f=0; f<6; f++)
-                        if (!isdigit((unsigned char) field[f]))
-                            goto parse_error;
-
-                    char hArr[] = {field[0], field[1], '\0'};
-                    char iArr[] = {field[2], field[3], '\0'};
-                    char sArr[] = {field[4], field[5], '\0'};
-                    h = strtol(hArr, nullptr, 10);
-                    i = strtol(iArr, nullptr, 10);
-                    s = strtol(sArr, nullptr, 10);
-                    field += 6;
-
-                    // Extra: fractional time. Saved as microseconds.
-                    if (*field++ == '.') {
-                        int value = 0;
-                        int scale = 1000000;
-                        while (isdigit((unsigned char) *field) && scale > 1) {
-                            value = (value * 10) + (*field++ - '0');
-                            scale /= 10;
-                        }
-                        u = value * scale;
-                    } else {
-                        u = 0;
-                    }
-                }
-
-                time_->hours = h;
-                time_->minutes = i;
-                time_->seconds = s;
-                time_->microseconds = u;
-            } break;
-
-            case '_': { // Ignore the field.
-            } break;
-
-            default: { // Unknown.
-                goto parse_error;
-            } break;
-        }
-
-        next_field();
+/**
+* Parses the completed UBX frame. Its checksum has already been verified.
+*
+* @return true if the frame was understood.
+*/
+bool ManuvrGPS::_dispatch_ubx() {
+  const uint8_t cls = (uint8_t) _line[0];
+  const uint8_t id  = (uint8_t) _line[1];
+  const char*   p   = &_line[4];
+  if ((UBX_CLASS_NAV == cls) && (UBX_ID_NAV_PVT == id) && (UBX_LEN_NAV_PVT == _ubx_len)) {
+    if (p[21] & 0x01) {
+      // gnssFixOK. Position is in 1e-7 degrees, height in mm, and speed in mm/s.
+      updateDatum(1, (float) (((double) _ubx_i32(p + 28)) / (double) 10000000));
+      updateDatum(2, (float) (((double) _ubx_i32(p + 24)) / (double) 10000000));
+      updateDatum(3, (float) (((double) _ubx_i32(p + 36)) / (double) 1000));
+      updateDatum(0, ((double) _ubx_i32(p + 60)) * (double) 0.0036);
     }
-
-    result = true;
-
-parse_error:
-    va_end(ap);
-    return result;
+    return true;
+  }
+  return false;
 }
 
 
-bool ManuvrGPS::_talker_id(char talker[3], const char *sentence) {
-  char type[6];
-  if (!_scan(sentence, "t", type)) {
-    return false;
-  }
-  talker[0] = type[0];
-  talker[1] = type[1];
-  talker[2] = '\0';
-  return true;
+void ManuvrGPS::printDebug(StringBuilder* output) {
+  BufferPipe::printDebug(output);
+  output->concatf("\tSentences\n\t-------------\n\tParsed %u\n\tReject %u\n", _sentences_parsed, _sentences_rejected);
+  output->concatf("\tParser state: %s (%u bytes)\n", _get_string_by_parse_state(_state), _line_len);
 }
 
 
 
-bool ManuvrGPS::_parse_rmc(struct minmea_sentence_rmc *frame, const char *sentence) {
+/*******************************************************************************
+* Undigested GPS functions                                                     *
+*******************************************************************************/
+
+bool ManuvrGPS::_parse_rmc(struct minmea_sentence_rmc *frame) {
   // $GPRMC,081836,A,3751.65,S,14507.36,E,000.0,360.0,130998,011.3,E*62
-  char type[6];
-  char validity;
   int latitude_direction;
   int longitude_direction;
   int variation_direction;
-  if (!_scan(sentence, "tTcfdfdffDfd",
-      type,
-      &frame->time,
-      &validity,
-      &frame->latitude, &latitude_direction,
-      &frame->longitude, &longitude_direction,
-      &frame->speed,
-      &frame->course,
-      &frame->date,
-      &frame->variation, &variation_direction)) {
+  if (_field_count < 12) return false;
+  if (!(_field_time(_field(1), &frame->time) &&
+        _field_float(_field(3), &frame->latitude) &&
+        _field_dir(_field(4), &latitude_direction) &&
+        _field_float(_field(5), &frame->longitude) &&
+        _field_dir(_field(6), &longitude_direction) &&
+        _field_float(_field(7), &frame->speed) &&
+        _field_float(_field(8), &frame->course) &&
+        _field_date(_field(9), &frame->date) &&
+        _field_float(_field(10), &frame->variation) &&
+        _field_dir(_field(11), &variation_direction))) {
     return false;
   }
-  if (strcmp(type+2, "RMC")) {
-    return false;
-  }
-  frame->valid = (validity == 'A');
+  frame->valid = ('A' == _field_char(_field(2)));
   frame->latitude.value *= latitude_direction;
   frame->longitude.value *= longitude_direction;
   frame->variation.value *= variation_direction;
   return true;
 }
 
-bool ManuvrGPS::_parse_gga(struct minmea_sentence_gga *frame, const char *sentence) {
+bool ManuvrGPS::_parse_gga(struct minmea_sentence_gga *frame) {
   // $GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47
-  char type[6];
   int latitude_direction;
   int longitude_direction;
-
-  if (!_scan(sentence, "tTfdfdiiffcfci_",
-      type,
-      &frame->time,
-      &frame->latitude, &latitude_direction,
-      &frame->longitude, &longitude_direction,
-      &frame->fix_quality,
-      &frame->satellites_tracked,
-      &frame->hdop,
-      &frame->altitude, &frame->altitude_units,
-      &frame->height, &frame->height_units,
-      &frame->dgps_age)) {
+  if (_field_count < 15) return false;
+  if (!(_field_time(_field(1), &frame->time) &&
+        _field_float(_field(2), &frame->latitude) &&
+        _field_dir(_field(3), &latitude_direction) &&
+        _field_float(_field(4), &frame->longitude) &&
+        _field_dir(_field(5), &longitude_direction) &&
+        _field_int(_field(6), &frame->fix_quality) &&
+        _field_int(_field(7), &frame->satellites_tracked) &&
+        _field_float(_field(8), &frame->hdop) &&
+        _field_float(_field(9), &frame->altitude) &&
+        _field_float(_field(11), &frame->height) &&
+        _field_int(_field(13), &frame->dgps_age))) {
     return false;
   }
-  if (strcmp(type+2, "GGA")) {
-    return false;
-  }
-
+  frame->altitude_units = _field_char(_field(10));
+  frame->height_units   = _field_char(_field(12));
   frame->latitude.value *= latitude_direction;
   frame->longitude.value *= longitude_direction;
   return true;
 }
 
-bool ManuvrGPS::_parse_gsa(struct minmea_sentence_gsa *frame, const char *sentence) {
-    // $GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*39
-    char type[6];
-
-    if (!_scan(sentence, "tciiiiiiiiiiiiifff",
-            type,
-            &frame->mode,
-            &frame->fix_type,
-            &frame->sats[0],
-            &frame->sats[1],
-            &frame->sats[2],
-            &frame->sats[3],
-            &frame->sats[4],
-            &frame->sats[5],
-            &frame->sats[6],
-            &frame->sats[7],
-            &frame->sats[8],
-            &frame->sats[9],
-            &frame->sats[10],
-            &frame->sats[11],
-            &frame->pdop,
-            &frame->hdop,
-            &frame->vdop))
-        return false;
-    if (strcmp(type+2, "GSA"))
-        return false;
-
-    return true;
+bool ManuvrGPS::_parse_gsa(struct minmea_sentence_gsa *frame) {
+  // $GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*39
+  if (_field_count < 18) return false;
+  frame->mode = _field_char(_field(1));
+  if (!_field_int(_field(2), &frame->fix_type)) return false;
+  for (int i = 0; i < 12; i++) {
+    if (!_field_int(_field(3 + i), &frame->sats[i])) return false;
+  }
+  return (_field_float(_field(15), &frame->pdop) &&
+          _field_float(_field(16), &frame->hdop) &&
+          _field_float(_field(17), &frame->vdop));
 }
 
-bool ManuvrGPS::_parse_gll(struct minmea_sentence_gll *frame, const char *sentence) {
-    // $GPGLL,3723.2475,N,12158.3416,W,161229.487,A,A*41$;
-    char type[6];
-    int latitude_direction;
-    int longitude_direction;
-
-    if (!_scan(sentence, "tfdfdTc;c",
-            type,
-            &frame->latitude, &latitude_direction,
-            &frame->longitude, &longitude_direction,
-            &frame->time,
-            &frame->status,
-            &frame->mode))
-        return false;
-    if (strcmp(type+2, "GLL"))
-        return false;
-
-    frame->latitude.value *= latitude_direction;
-    frame->longitude.value *= longitude_direction;
-
-    return true;
+bool ManuvrGPS::_parse_gll(struct minmea_sentence_gll *frame) {
+  // $GPGLL,3723.2475,N,12158.3416,W,161229.487,A,A*41$;
+  int latitude_direction;
+  int longitude_direction;
+  if (_field_count < 7) return false;
+  if (!(_field_float(_field(1), &frame->latitude) &&
+        _field_dir(_field(2), &latitude_direction) &&
+        _field_float(_field(3), &frame->longitude) &&
+        _field_dir(_field(4), &longitude_direction) &&
+        _field_time(_field(5), &frame->time))) {
+    return false;
+  }
+  frame->status = _field_char(_field(6));
+  frame->mode   = _field_char(_field(7));   // Optional.
+  frame->latitude.value *= latitude_direction;
+  frame->longitude.value *= longitude_direction;
+  return true;
 }
 
-bool ManuvrGPS::_parse_gst(struct minmea_sentence_gst *frame, const char *sentence) {
-    // $GPGST,024603.00,3.2,6.6,4.7,47.3,5.8,5.6,22.0*58
-    char type[6];
-
-    if (!_scan(sentence, "tTfffffff",
-            type,
-            &frame->time,
-            &frame->rms_deviation,
-            &frame->semi_major_deviation,
-            &frame->semi_minor_deviation,
-            &frame->semi_major_orientation,
-            &frame->latitude_error_deviation,
-            &frame->longitude_error_deviation,
-            &frame->altitude_error_deviation))
-        return false;
-    if (strcmp(type+2, "GST"))
-        return false;
-
-    return true;
+bool ManuvrGPS::_parse_gst(struct minmea_sentence_gst *frame) {
+  // $GPGST,024603.00,3.2,6.6,4.7,47.3,5.8,5.6,22.0*58
+  if (_field_count < 9) return false;
+  return (_field_time(_field(1), &frame->time) &&
+          _field_float(_field(2), &frame->rms_deviation) &&
+          _field_float(_field(3), &frame->semi_major_deviation) &&
+          _field_float(_field(4), &frame->semi_minor_deviation) &&
+          _field_float(_field(5), &frame->semi_major_orientation) &&
+          _field_float(_field(6), &frame->latitude_error_deviation) &&
+          _field_float(_field(7), &frame->longitude_error_deviation) &&
+          _field_float(_field(8), &frame->altitude_error_deviation));
 }
 
-bool ManuvrGPS::_parse_gsv(struct minmea_sentence_gsv *frame, const char *sentence) {
-    // $GPGSV,3,1,11,03,03,111,00,04,15,270,00,06,01,010,00,13,06,292,00*74
-    // $GPGSV,3,3,11,22,42,067,42,24,14,311,43,27,05,244,00,,,,*4D
-    // $GPGSV,4,2,11,08,51,203,30,09,45,215,28*75
-    // $GPGSV,4,4,13,39,31,170,27*40
-    // $GPGSV,4,4,13*7B
-    char type[6];
-
-    if (!_scan(sentence, "tiii;iiiiiiiiiiiiiiii",
-            type,
-            &frame->total_msgs,
-            &frame->msg_nr,
-            &frame->total_sats,
-            &frame->sats[0].nr,
-            &frame->sats[0].elevation,
-            &frame->sats[0].azimuth,
-            &frame->sats[0].snr,
-            &frame->sats[1].nr,
-            &frame->sats[1].elevation,
-            &frame->sats[1].azimuth,
-            &frame->sats[1].snr,
-            &frame->sats[2].nr,
-            &frame->sats[2].elevation,
-            &frame->sats[2].azimuth,
-            &frame->sats[2].snr,
-            &frame->sats[3].nr,
-            &frame->sats[3].elevation,
-            &frame->sats[3].azimuth,
-            &frame->sats[3].snr
-            )) {
-        return false;
+bool ManuvrGPS::_parse_gsv(struct minmea_sentence_gsv *frame) {
+  // $GPGSV,3,1,11,03,03,111,00,04,15,270,00,06,01,010,00,13,06,292,00*74
+  // $GPGSV,3,3,11,22,42,067,42,24,14,311,43,27,05,244,00,,,,*4D
+  // $GPGSV,4,2,11,08,51,203,30,09,45,215,28*75
+  // $GPGSV,4,4,13,39,31,170,27*40
+  // $GPGSV,4,4,13*7B
+  if (_field_count < 4) return false;
+  if (!(_field_int(_field(1), &frame->total_msgs) &&
+        _field_int(_field(2), &frame->msg_nr) &&
+        _field_int(_field(3), &frame->total_sats))) {
+    return false;
+  }
+  // Satellites are optional. Missing fields read as empty.
+  for (int i = 0; i < 4; i++) {
+    const int f = 4 + (i * 4);
+    if (!(_field_int(_field(f), &frame->sats[i].nr) &&
+          _field_int(_field(f + 1), &frame->sats[i].elevation) &&
+          _field_int(_field(f + 2), &frame->sats[i].azimuth) &&
+          _field_int(_field(f + 3), &frame->sats[i].snr))) {
+      return false;
     }
-    if (strcmp(type+2, "GSV"))
-        return false;
-
-    return true;
+  }
+  return true;
 }
 
-bool ManuvrGPS::_parse_vtg(struct minmea_sentence_vtg *frame, const char *sentence) {
-    // $GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48
-    // $GPVTG,156.1,T,140.9,M,0.0,N,0.0,K*41
-    // $GPVTG,096.5,T,083.5,M,0.0,N,0.0,K,D*22
-    // $GPVTG,188.36,T,,M,0.820,N,1.519,K,A*3F
-    char type[6];
-    char c_true, c_magnetic, c_knots, c_kph, c_faa_mode;
-
-    if (!_scan(sentence, "tfcfcfcfc;c",
-            type,
-            &frame->true_track_degrees,
-            &c_true,
-            &frame->magnetic_track_degrees,
-            &c_magnetic,
-            &frame->speed_knots,
-            &c_knots,
-            &frame->speed_kph,
-            &c_kph,
-            &c_faa_mode))
-        return false;
-    if (strcmp(type+2, "VTG"))
-        return false;
-    // check chars
-    if (c_true != 'T' ||
-        c_magnetic != 'M' ||
-        c_knots != 'N' ||
-        c_kph != 'K')
-        return false;
-    frame->faa_mode = (minmea_faa_mode) c_faa_mode;
-
-    return true;
+bool ManuvrGPS::_parse_vtg(struct minmea_sentence_vtg *frame) {
+  // $GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48
+  // $GPVTG,156.1,T,140.9,M,0.0,N,0.0,K*41
+  // $GPVTG,096.5,T,083.5,M,0.0,N,0.0,K,D*22
+  // $GPVTG,188.36,T,,M,0.820,N,1.519,K,A*3F
+  if (_field_count < 9) return false;
+  if (!(_field_float(_field(1), &frame->true_track_degrees) &&
+        _field_float(_field(3), &frame->magnetic_track_degrees) &&
+        _field_float(_field(5), &frame->speed_knots) &&
+        _field_float(_field(7), &frame->speed_kph))) {
+    return false;
+  }
+  // check chars
+  if (_field_char(_field(2)) != 'T' ||
+      _field_char(_field(4)) != 'M' ||
+      _field_char(_field(6)) != 'N' ||
+      _field_char(_field(8)) != 'K') {
+    return false;
+  }
+  frame->faa_mode = (minmea_faa_mode) _field_char(_field(9));   // Optional.
+  return true;
 }
 
 int ManuvrGPS::_gettime(struct timespec *ts, const struct minmea_date *date, const struct minmea_time *time_) {
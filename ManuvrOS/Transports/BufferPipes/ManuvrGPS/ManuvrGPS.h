@@ -21,6 +21,12 @@ limitations under the License.
 This is a basic class for parsing NMEA sentences from a GPS and emitting
   them as annotated messages.
 
+Input is parsed a byte at a time, as it arrives, so nothing is buffered but
+  the sentence in progress. Its checksum is kept as it goes, and its fields
+  are indexed as their commas are seen. So a completed sentence is parsed in
+  place, with no further scanning. UBX frames may be interleaved with NMEA on
+  the same stream. Of those, only NAV-PVT is understood.
+
 This class in unidirectional in the sense that it only reads from the
   associated transport. Hardware that has bidirectional capability for
   whatever reason can extend this class into something with a non-trivial
@@ -55,8 +61,16 @@ https://github.com/cloudyourcar/minmea
 
 
 #define MINMEA_MAX_LENGTH          140
+#define MINMEA_MAX_FIELDS          24     // GSV has the most, at 20.
 #define MANUVR_MSG_GPS_LOCATION    0x2039
 
+/* UBX framing. Payloads longer than our line buffer are checked and discarded. */
+#define UBX_SYNC_CHAR_1            0xB5
+#define UBX_SYNC_CHAR_2            0x62
+#define UBX_CLASS_NAV              0x01
+#define UBX_ID_NAV_PVT             0x07
+#define UBX_LEN_NAV_PVT            92
+
 /* These are integer representations of the three-letter sentence IDs. */
 #define MINMEA_INT_SENTENCE_CODE_RMC   0x00524d43
 #define MINMEA_INT_SENTENCE_CODE_GGA   0x00474741
@@ -84,6 +98,20 @@ enum minmea_sentence_id {
     MINMEA_SENTENCE_VTG,
 };
 
+/* Where the byte-wise parser is within a sentence or frame. */
+enum class GPSParseState : uint8_t {
+  HUNT = 0,      // Looking for the start of something.
+  NMEA_BODY,     // Between '$' and '*'.
+  NMEA_CSUM_HI,  // The checksum's first hex digit.
+  NMEA_CSUM_LO,  // ...and its second.
+  NMEA_EOL,      // Waiting on the line ending.
+  UBX_SYNC,      // Saw the first sync character.
+  UBX_HEADER,    // Class, ID, and length.
+  UBX_PAYLOAD,
+  UBX_CK_A,
+  UBX_CK_B
+};
+
 enum minmea_gll_status {
     MINMEA_GLL_STATUS_DATA_VALID     = 'A',
     MINMEA_GLL_STATUS_DATA_NOT_VALID = 'V',
@@ -257,6 +285,7 @@ class ManuvrGPS : public BufferPipe, public SensorWrapper {
     virtual int8_t fromCounterparty(ManuvrPipeSignal, void*);
     virtual int8_t toCounterparty(StringBuilder* buf, int8_t mm);
     virtual int8_t fromCounterparty(StringBuilder* buf, int8_t mm);
+    virtual int8_t fromCounterparty(BufferSlice* buf, int8_t mm);
 
     /* Overrides from SensorWrapper */
     SensorError init();
@@ -266,6 +295,9 @@ class ManuvrGPS : public BufferPipe, public SensorWrapper {
 
     void printDebug(StringBuilder*);
 
+    inline uint32_t sentencesParsed() {    return _sentences_parsed;    };
+    inline uint32_t sentencesRejected() {  return _sentences_rejected;  };
+
 
   protected:
     const char* pipeName();
@@ -274,58 +306,52 @@ class ManuvrGPS : public BufferPipe, public SensorWrapper {
   private:
     uint32_t       _sentences_parsed   = 0;
     uint32_t       _sentences_rejected = 0;
-    StringBuilder  _accumulator;
+    char           _line[MINMEA_MAX_LENGTH + 4];    // The sentence (or UBX payload) in progress.
+    uint8_t        _fields[MINMEA_MAX_FIELDS];      // Offsets into _line of each field.
+    uint16_t       _line_len    = 0;
+    uint16_t       _ubx_len     = 0;   // The declared payload length of a UBX frame.
+    uint8_t        _field_count = 0;
+    uint8_t        _csum        = 0;   // NMEA XOR, or UBX CK_A.
+    uint8_t        _csum_b      = 0;   // UBX CK_B.
+    uint8_t        _csum_rx     = 0;   // The NMEA checksum, as received.
+    bool           _csum_given  = false;
+    GPSParseState  _state       = GPSParseState::HUNT;
 
     void _class_init();
 
-    /**
-    * Tries to empty the accumulator, parsing sentences iteratively.
-    */
-    bool _attempt_parse();
-
-    /**
-    * Calculate raw sentence checksum. Does not check sentence integrity.
-    */
-    uint8_t _checksum(const char *sentence);
-
-    /**
-    * Check sentence validity and checksum. Returns true for valid sentences.
-    */
-    bool _check(const char *sentence, bool strict);
+    /* Byte-wise parsing. */
+    void _feed(const uint8_t*, unsigned int);
+    void _reset_parser();
+    void _nmea_begin();
+    void _nmea_end();
+    void _ubx_end();
+    bool _dispatch_nmea();
+    bool _dispatch_ubx();
 
     /**
-    * Determine talker identifier.
+    * Returns the given field of the current sentence. Never nullptr. Field 0
+    *   is the talker and sentence identifier.
     */
-    bool _talker_id(char talker[3], const char *sentence);
+    inline const char* _field(uint8_t idx) {
+      return (idx < _field_count) ? (_line + _fields[idx]) : "";
+    };
 
     /**
     * Determine sentence identifier.
     */
-    enum minmea_sentence_id _sentence_id(const char *sentence, bool strict);
+    enum minmea_sentence_id _sentence_id();
 
     /*
-    * Parse a specific type of sentence. Return true on success.
-    */
-    bool _parse_rmc(struct minmea_sentence_rmc *frame, const char *sentence);
-    bool _parse_gga(struct minmea_sentence_gga *frame, const char *sentence);
-    bool _parse_gsa(struct minmea_sentence_gsa *frame, const char *sentence);
-    bool _parse_gll(struct minmea_sentence_gll *frame, const char *sentence);
-    bool _parse_gst(struct minmea_sentence_gst *frame, const char *sentence);
-    bool _parse_gsv(struct minmea_sentence_gsv *frame, const char *sentence);
-    bool _parse_vtg(struct minmea_sentence_vtg *frame, const char *sentence);
-
-    /**
-    * Scanf-like processor for NMEA sentences. Supports the following formats:
-    * c - single character (char *)
-    * d - direction, returned as 1/-1, default 0 (int *)
-    * f - fractional, returned as value + scale (int *, int *)
-    * i - decimal, default zero (int *)
-    * s - string (char *)
-    * t - talker identifier and type (char *)
-    * T - date/time stamp (int *, int *, int *)
-    * Returns true on success. See library source code for details.
+    * Parse a specific type of sentence from the fields of the current one.
+    *   Return true on success.
     */
-    bool _scan(const char *sentence, const char *format, ...);
+    bool _parse_rmc(struct minmea_sentence_rmc *frame);
+    bool _parse_gga(struct minmea_sentence_gga *frame);
+    bool _parse_gsa(struct minmea_sentence_gsa *frame);
+    bool _parse_gll(struct minmea_sentence_gll *frame);
+    bool _parse_gst(struct minmea_sentence_gst *frame);
+    bool _parse_gsv(struct minmea_sentence_gsv *frame);
+    bool _parse_vtg(struct minmea_sentence_vtg *frame);
 
     const char* _get_string_by_sentence_id(enum minmea_sentence_id);
 
@@ -49,6 +49,8 @@ Platforms that require it should be able to extend this driver for specific
   #include <cstdio>
   #include <stdlib.h>
   #include <unistd.h>
+  #include <errno.h>
+  #include <sys/uio.h>
 #else
   // No special globals needed for this platform.
 #endif
@@ -299,6 +301,9 @@ int8_t ManuvrSerial::reset() {
 int8_t ManuvrSerial::read_port() {
   int8_t return_value = 0;
   if (connected()) {
+    #if defined (__MANUVR_LINUX)
+      if (0 < outboundDepth()) _out_flush();   // Anything the port wouldn't take before?
+    #endif
     uint8_t* buf;
     int n = 0;
     #if defined (STM32F4XX)        // STM32F4
@@ -383,7 +388,8 @@ bool ManuvrSerial::write_port(unsigned char* out, int out_len) {
         #endif
         return false;
       }
-      bytes_written = (int) write(_sock, out, out_len);
+      // Whatever the port won't take now is queued, and retried as we read.
+      return (0 == _out_queue(out, out_len));
     #else   // Unsupported.
     #endif
 
@@ -394,6 +400,22 @@ bool ManuvrSerial::write_port(unsigned char* out, int out_len) {
 }
 
 
+#if defined (__MANUVR_LINUX)
+/**
+* Writes as much of the vector as the port will take.
+*
+* @param  iov    The segments.
+* @param  count  How many.
+* @return the number of bytes written, or -1 on failure.
+*/
+int ManuvrSerial::_out_write(XportIOV* iov, int count) {
+  const ssize_t n = writev(_sock, iov, count);
+  if (0 <= n) return (int) n;
+  return ((EAGAIN == errno) || (EWOULDBLOCK == errno) || (EINTR == errno)) ? 0 : -1;
+}
+#endif
+
+
 
 /*******************************************************************************
 * ######## ##     ## ######## ##    ## ########  ######
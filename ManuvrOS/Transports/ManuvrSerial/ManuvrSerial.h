@@ -79,6 +79,12 @@ class ManuvrSerial : public ManuvrXport {
     bool   write_port(unsigned char* out, int out_len);
 
 
+  protected:
+    #if defined(__MANUVR_LINUX)
+      int _out_write(XportIOV*, int count);   // Override from ManuvrXport.
+    #endif
+
+
   private:
     char*     _addr;
     uint32_t  _options;
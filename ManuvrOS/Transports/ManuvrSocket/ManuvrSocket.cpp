@@ -82,6 +82,9 @@ ManuvrSocket::ManuvrSocket(const char* nom, const char* addr, int port, SocketOp
 * Destructor
 */
 ManuvrSocket::~ManuvrSocket() {
+  #if defined(__MANUVR_LINUX)
+    if (0 != _reactor_slot) SocketReactor::reactor()->remove(this);
+  #endif
   if (_sock) {
     close(_sock);  // Close the socket.
     _sock = 0;
@@ -107,6 +110,10 @@ int8_t ManuvrSocket::disconnect() {
     connected(false);
   }
 
+  #if defined(__MANUVR_LINUX)
+    // The reactor must let go of the descriptor before it is closed.
+    if (0 != _reactor_slot) SocketReactor::reactor()->remove(this);
+  #endif
   if (_sock) {
     close(_sock);  // Close the socket.
     _sock = 0;
@@ -58,9 +58,17 @@ class SocketOpts {
     uint32_t _flags = 0;
 };
 
+#if defined(__MANUVR_LINUX)
+  #include "SocketReactor.h"
+#endif
+
 /*
 * This is a wrapper around sockets as they exist in a linux system.
 * TODO: This might be an appropriate place for lwip?
+*
+* On linux, sockets don't get threads of their own. They register with the
+*   SocketReactor, which calls _service_socket() when there is something to
+*   accept or read.
 */
 class ManuvrSocket : public ManuvrXport {
   public:
@@ -79,8 +87,16 @@ class ManuvrSocket : public ManuvrXport {
 
     ManuvrSocket(const char* nom, const char* addr, int port, SocketOpts* opts);
 
+    /* Called by the reactor when the socket is ready. Must not block. */
+    virtual void _service_socket(uint32_t events) {};
+
 
   private:
+    uint32_t _reactor_slot = 0;   // Owned by the reactor. Zero means unregistered.
+
+    #if defined(__MANUVR_LINUX)
+      friend class SocketReactor;
+    #endif
 };
 
 #endif  // Header guard __MANUVR_SOCKET_H__
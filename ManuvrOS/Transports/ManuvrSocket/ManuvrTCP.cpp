@@ -29,6 +29,8 @@ This is basically only for linux for now.
 #include <Kernel.h>
 
 #if defined(MANUVR_SUPPORT_TCPSOCKET)
+#include <errno.h>
+#include <netinet/tcp.h>
 
 
 /*******************************************************************************
@@ -53,71 +55,7 @@ This is basically only for linux for now.
 *******************************************************************************/
 
 #if defined(__MANUVR_LINUX)
-  // TODO: Generallize into Manuvr threading abstraction.
-  // Threaded platforms will need this to compensate for a loss of ISR.
-  extern void* xport_read_handler(void* active_xport);
-
-
-  /*
-  * Since listening for connections on this transport involves blocking, we have a
-  *   thread dedicated to the task...
-  */
-  void* socket_listener_loop(void* active_xport) {
-    if (NULL != active_xport) {
-      sigset_t set;
-      sigemptyset(&set);
-      //sigaddset(&set, SIGIO);
-      sigaddset(&set, SIGQUIT);
-      sigaddset(&set, SIGHUP);
-      sigaddset(&set, SIGTERM);
-      sigaddset(&set, SIGVTALRM);
-      sigaddset(&set, SIGINT);
-      int s = pthread_sigmask(SIG_BLOCK, &set, NULL);
-
-      ManuvrTCP* listening_inst = (ManuvrTCP*) active_xport;
-      StringBuilder output;
-      if (0 != s) {
-        output.concatf("pthread_sigmask() returned an error: %d\n", s);
-        Kernel::log(&output);
-        return NULL;
-      }
-      int      cli_sock;
-      struct sockaddr_in cli_addr;
-      while (listening_inst->listening()) {
-        unsigned int clientlen = sizeof(cli_addr);
-
-        /* Wait for client connection */
-        if ((cli_sock = accept(listening_inst->getSockID(), (struct sockaddr *) &cli_addr, &clientlen)) < 0) {
-          output.concat("Failed to accept client connection.\n");
-        }
-        else {
-          ManuvrTCP* nu_connection = new ManuvrTCP(listening_inst, cli_sock, &cli_addr);
-          nu_connection->setPipeStrategy(listening_inst->getPipeStrategy());
-
-          ManuvrMsg* event = Kernel::returnEvent(MANUVR_MSG_SYS_ADVERTISE_SRVC);
-          event->addArg((EventReceiver*) nu_connection);
-          Kernel::staticRaiseEvent(event);
-
-          output.concatf("TCP Client connected: %s\n", (char*) inet_ntoa(cli_addr.sin_addr));
-        }
-        Kernel::log(&output);
-
-        for (uint16_t i = 0; i < sizeof(cli_addr);  i++) {
-          // Zero the sockaddr structure for next use. The new transport
-          //   instance should have copied it by now.
-          *((uint8_t *) &cli_addr  + i) = 0;
-        }
-      }
-      // Close the listener...
-      // TODO: Is this all we need to do?   ---J. Ian Lindsay   Fri Jan 15 11:32:12 PST 2016
-      close(listening_inst->getSockID());
-    }
-    else {
-      Kernel::log("Tried to listen with a NULL transport.");
-    }
-
-    return NULL;
-  }
+  // Linux sockets are serviced by the SocketReactor. No threads of our own.
 #elif defined(__MANUVR_ESP32)
   // TODO: Generallize into Manuvr threading abstraction.
   /*
@@ -143,7 +81,7 @@ This is basically only for linux for now.
 
           ManuvrMsg* event = Kernel::returnEvent(MANUVR_MSG_SYS_ADVERTISE_SRVC);
           event->addArg((EventReceiver*) nu_connection);
-          Kernel::staticRaiseEvent(event);
+          Kernel::isrRaiseEvent(event);   // We are on the listener thread.
 
           output.concatf("TCP Client connected: %s\n", (char*) inet_ntoa(cli_addr.sin_addr));
         }
@@ -197,6 +135,10 @@ ManuvrTCP::ManuvrTCP(const char* addr, int port) : ManuvrTCP(addr, port, nullptr
 ManuvrTCP::ManuvrTCP(ManuvrTCP* listening_instance, int sock, struct sockaddr_in* nu_sockaddr) : ManuvrTCP(listening_instance->_addr, listening_instance->_port_number, 0) {
   _sock = sock;
   _opts = listening_instance->_opts;
+  if (listening_instance->eventDriven()) {
+    // The listener will register us with the reactor. We mustn't get a thread.
+    set_xport_state(MANUVR_XPORT_FLAG_EVENT_DRIVEN);
+  }
 
   listening_instance->_connections.insert(this);  // TODO: This is starting to itch...
 
@@ -213,6 +155,14 @@ ManuvrTCP::ManuvrTCP(ManuvrTCP* listening_instance, int sock, struct sockaddr_in
 * Destructor
 */
 ManuvrTCP::~ManuvrTCP() {
+  #if defined(__MANUVR_LINUX)
+    // Before we are only partly destroyed, make sure we won't be serviced.
+    if (eventDriven()) SocketReactor::reactor()->remove(this);
+  #endif
+  if (nullptr != _rx_backing) {
+    _rx_backing->release();
+    _rx_backing = nullptr;
+  }
 }
 
 
@@ -255,6 +205,20 @@ int8_t ManuvrTCP::toCounterparty(StringBuilder* buf, int8_t mm) {
 }
 
 
+/**
+* Inward toward the transport, by reference. Large segments are queued without
+*   being copied.
+*
+* @param  buf    A pointer to the slice. Remains the caller's.
+* @param  mm     A declaration of memory-management responsibility.
+* @return A declaration of memory-management responsibility.
+*/
+int8_t ManuvrTCP::toCounterparty(BufferSlice* buf, int8_t mm) {
+  if (!connected() || (0 >= getSockID())) return MEM_MGMT_RESPONSIBLE_CALLER;
+  return (0 == _out_queue(buf)) ? MEM_MGMT_RESPONSIBLE_BEARER : MEM_MGMT_RESPONSIBLE_CALLER;
+}
+
+
 
 /*******************************************************************************
 * ___________                                                  __
@@ -296,6 +260,13 @@ int8_t ManuvrTCP::connect() {
   }
 
   initialized(true);
+  #if defined(__MANUVR_LINUX)
+    // Writes are queued rather than blocking. See _out_write().
+    fcntl(_sock, F_SETFL, fcntl(_sock, F_GETFL, 0) | O_NONBLOCK);
+    if (0 == SocketReactor::reactor()->add(this)) {
+      set_xport_state(MANUVR_XPORT_FLAG_EVENT_DRIVEN);
+    }
+  #endif
   connected(true);
 
   return 0;
@@ -320,24 +291,41 @@ int8_t ManuvrTCP::listen() {
 
   _sock = socket(AF_INET, SOCK_STREAM, 0);        // Open the socket...
 
+  #if defined(__MANUVR_LINUX)
+    int reuse = 1;
+    setsockopt(_sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  #endif
+
   /* Bind the server socket */
   if (bind(_sock, (struct sockaddr *) &_sockaddr, sizeof(_sockaddr))) {
     Kernel::log("Failed to bind the server socket.\n");
     return -1;
   }
   /* Listen on the server socket */
-  if (::listen(_sock, 4) < 0) {
+  if (::listen(_sock, SOMAXCONN) < 0) {
     Kernel::log("Failed to listen on server socket\n");
     return -1;
   }
 
   initialized(true);
-  ManuvrThreadOptions _t_opts;
-  _t_opts.thread_name = (char*) "tcp_listen";
-  _t_opts.stack_sz = 4096;
+  #if defined(__MANUVR_LINUX)
+    // The reactor will tell us when there are connections to accept.
+    fcntl(_sock, F_SETFL, fcntl(_sock, F_GETFL, 0) | O_NONBLOCK);
+    set_xport_state(MANUVR_XPORT_FLAG_EVENT_DRIVEN);
+    listening(true);
+    if (0 != SocketReactor::reactor()->add(this)) {
+      Kernel::log("Failed to register the TCP listener.\n");
+      listening(false);
+      return -1;
+    }
+  #else
+    ManuvrThreadOptions _t_opts;
+    _t_opts.thread_name = (char*) "tcp_listen";
+    _t_opts.stack_sz = 4096;
 
-  listening(true);
-  createThread(&_thread_id, NULL, socket_listener_loop, (void*) this, &_t_opts);
+    listening(true);
+    createThread(&_thread_id, NULL, socket_listener_loop, (void*) this, &_t_opts);
+  #endif
 
   local_log.concatf("TCP Now listening at %s:%d.\n", _addr, _port_number);
 
@@ -353,31 +341,176 @@ int8_t ManuvrTCP::reset() {
 
 
 
+/**
+* Reads whatever is waiting, without blocking.
+* Threaded platforms call this in a loop. On linux, the reactor calls
+*   _service_socket() instead.
+*
+* @return 1 if anything was read, 0 if not.
+*/
 int8_t ManuvrTCP::read_port() {
-  if (connected()) {
-    unsigned char *buf = (unsigned char *) alloca(256);
-    int n;
-
-    while (connected()) {
-      n = read(_sock, buf, 255);
-      if (n > 0) {
-        bytes_received += n;
-        BufferPipe::fromCounterparty(buf, n, MEM_MGMT_RESPONSIBLE_BEARER);
-      }
-      else {
-        // Don't thrash the CPU for no reason...
-        sleep_millis(20);
-      }
+  if (!connected()) {
+    if (getVerbosity() > 1) {
+      local_log.concat("Somehow we are trying to read a port that is not marked as open.\n");
+      flushLocalLog();
     }
+    return 0;
   }
-  else if (getVerbosity() > 1) {
-    local_log.concat("Somehow we are trying to read a port that is not marked as open.\n");
+  #if defined (__MANUVR_LINUX)
+    if (0 < outboundDepth()) _out_flush();   // Anything the port wouldn't take before?
+  #endif
+  const int n = _read_available();
+  if (0 > n) disconnect();
+  return (0 < n) ? 1 : 0;
+}
+
+
+/**
+* Reads until the socket is drained, or until it has had its share of reads.
+*   Each read lands in a shared backing that is passed along by reference.
+*   If nothing downstream kept a reference to the last one, it is re-used.
+*
+* @return the number of bytes read, or -1 if the counterparty went away.
+*/
+int ManuvrTCP::_read_available() {
+  int total = 0;
+  for (int i = 0; i < SOCKET_REACTOR_READS_PER_WAKE; i++) {
+    if ((nullptr != _rx_backing) && (1 < _rx_backing->refs())) {
+      _rx_backing->release();
+      _rx_backing = nullptr;
+    }
+    if (nullptr == _rx_backing) {
+      _rx_backing = SharedBuffer::alloc(SOCKET_REACTOR_RX_BUFFER);
+      if (nullptr == _rx_backing) break;   // Try again on the next pass.
+    }
+    const int n = recv(_sock, _rx_backing->buffer(), _rx_backing->capacity(), MSG_DONTWAIT);
+    if (n > 0) {
+      bytes_received += n;
+      total += n;
+      BufferSlice slice;
+      slice.append(_rx_backing, 0, n);
+      if (haveFar()) {
+        far()->fromCounterparty(&slice, MEM_MGMT_RESPONSIBLE_BEARER);
+      }
+      if (n < (int) _rx_backing->capacity()) break;   // Drained.
+    }
+    else if (0 == n) {
+      return -1;   // Orderly shutdown by the counterparty.
+    }
+    else if ((EAGAIN == errno) || (EWOULDBLOCK == errno) || (EINTR == errno)) {
+      break;
+    }
+    else {
+      return -1;
+    }
   }
+  return total;
+}
 
-  _thread_id = 0;
 
+#if defined(__MANUVR_LINUX)
+/**
+* Called by the reactor when our socket is ready.
+*
+* @param  events  The epoll events.
+*/
+void ManuvrTCP::_service_socket(uint32_t events) {
+  if (listening()) {
+    _accept_all();
+    return;
+  }
+  if ((events & EPOLLOUT) && (0 > _out_flush())) {
+    disconnect();
+    flushLocalLog();
+    return;
+  }
+  const int n = (events & EPOLLIN) ? _read_available() : 0;
+  if ((0 > n) || ((0 == n) && (events & (EPOLLHUP | EPOLLERR)))) {
+    disconnect();
+  }
   flushLocalLog();
-  return 0;
+}
+
+
+/**
+* Accepts every connection that is waiting, and hands each to the reactor.
+*/
+void ManuvrTCP::_accept_all() {
+  StringBuilder output;
+  while (listening()) {
+    struct sockaddr_in cli_addr;
+    socklen_t clientlen = sizeof(cli_addr);
+    memset((uint8_t*) &cli_addr, 0, sizeof(cli_addr));
+    int cli_sock = accept4(_sock, (struct sockaddr *) &cli_addr, &clientlen, SOCK_CLOEXEC | SOCK_NONBLOCK);
+    if (cli_sock < 0) {
+      if ((EAGAIN != errno) && (EWOULDBLOCK != errno) && (EINTR != errno) && (ECONNABORTED != errno)) {
+        output.concat("Failed to accept client connection.\n");
+      }
+      break;
+    }
+    // Messages are small, and we would rather they not wait on Nagle.
+    int nodelay = 1;
+    setsockopt(cli_sock, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+    ManuvrTCP* nu_connection = new ManuvrTCP(this, cli_sock, &cli_addr);
+    nu_connection->setPipeStrategy(getPipeStrategy());
+    if (0 != SocketReactor::reactor()->add(nu_connection)) {
+      output.concat("Failed to register a TCP client.\n");
+      nu_connection->disconnect();
+      continue;
+    }
+
+    ManuvrMsg* event = Kernel::returnEvent(MANUVR_MSG_SYS_ADVERTISE_SRVC);
+    event->addArg((EventReceiver*) nu_connection);
+    Kernel::isrRaiseEvent(event);   // We are on the reactor's thread.
+
+    output.concatf("TCP Client connected: %s\n", (char*) inet_ntoa(cli_addr.sin_addr));
+  }
+  if (0 < output.length()) Kernel::log(&output);
+}
+
+
+/**
+* Asks the reactor to call us once the socket can take more.
+*
+* @return true if it will.
+*/
+bool ManuvrTCP::_out_wanted() {
+  return (eventDriven() && (0 == SocketReactor::reactor()->watchWritable(this, true)));
+}
+
+
+/**
+* The queue is empty. Stop asking.
+*/
+void ManuvrTCP::_out_idle() {
+  if (eventDriven()) SocketReactor::reactor()->watchWritable(this, false);
+}
+#endif  // __MANUVR_LINUX
+
+
+/**
+* Writes as much of the vector as the socket will take without blocking.
+*
+* @param  iov    The segments.
+* @param  count  How many.
+* @return the number of bytes written, or -1 on failure.
+*/
+int ManuvrTCP::_out_write(XportIOV* iov, int count) {
+  #if defined(__MANUVR_LINUX)
+    const ssize_t n = writev(_sock, iov, count);
+    if (0 <= n) return (int) n;
+    return ((EAGAIN == errno) || (EWOULDBLOCK == errno) || (EINTR == errno)) ? 0 : -1;
+  #else
+    int total = 0;
+    for (int i = 0; i < count; i++) {
+      const int n = (int) write(_sock, iov[i].iov_base, iov[i].iov_len);
+      if (n < 0) return (0 == total) ? -1 : total;
+      total += n;
+      if (n < (int) iov[i].iov_len) break;
+    }
+    return total;
+  #endif
 }
 
 
@@ -402,9 +535,8 @@ bool ManuvrTCP::write_port(unsigned char* out, int out_len) {
   }
 
   if (connected()) {
-    int bytes_written = (int) write(getSockID(), out, out_len);
-    bytes_sent += bytes_written;
-    if (bytes_written == out_len) {
+    // Whatever the socket won't take now is queued, and written when it will.
+    if (0 == _out_queue(out, out_len)) {
       return true;
     }
     Kernel::log("Failed to send bytes to client");
@@ -461,6 +593,9 @@ void ManuvrTCP::printDebug(StringBuilder *temp) {
   temp->concatf("-- _addr           %s:%d\n",  _addr, _port_number);
   temp->concatf("-- _opts           %p\n", _opts);
   temp->concatf("-- _sock           0x%08x\n", _sock);
+  if (listening()) {
+    temp->concatf("-- Connections     %d\n", _connections.size());
+  }
 }
 
 
@@ -75,6 +75,7 @@ class ManuvrTCP : public ManuvrSocket
 
     /* Override from BufferPipe. */
     virtual int8_t toCounterparty(StringBuilder* buf, int8_t mm);
+    virtual int8_t toCounterparty(BufferSlice* buf, int8_t mm);
 
     /* Overrides from EventReceiver */
     void printDebug(StringBuilder *);
@@ -91,10 +92,22 @@ class ManuvrTCP : public ManuvrSocket
 
   protected:
     int8_t attached();
+    void   _service_socket(uint32_t events);
+
+    /* Overrides from ManuvrXport's outbound queue. */
+    int    _out_write(XportIOV*, int count);
+    #if defined(__MANUVR_LINUX)
+      bool _out_wanted();
+      void _out_idle();
+    #endif
 
 
   private:
     LinkedList<ManuvrTCP*> _connections;   // A list of client connections.
+    SharedBuffer* _rx_backing = nullptr;   // Kept between reads, if nothing else holds it.
+
+    int  _read_available();
+    void _accept_all();
 };
 
 #endif  // __MANUVR_TCP_SOCKET_H__
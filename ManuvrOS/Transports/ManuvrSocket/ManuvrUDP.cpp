@@ -26,6 +26,7 @@ This class implements a crude UDP connector.
 
 #include <DataStructures/StringBuilder.h>
 #include "ManuvrUDP.h"
+#include <errno.h>
 
 
 /*******************************************************************************
@@ -39,6 +40,16 @@ This class implements a crude UDP connector.
 * Static members and initializers should be located here.
 *******************************************************************************/
 
+/* The address stays in network order. The port is native. */
+static inline uint64_t _peer_key(uint32_t addr, uint16_t port) {
+  return (((uint64_t) addr) << 16) | port;
+}
+
+/* Fibonacci hashing. The top bits are the well-mixed ones. */
+static inline uint32_t _peer_hash(uint64_t key) {
+  return (uint32_t) ((key * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
 
 /*******************************************************************************
 * .-. .----..----.    .-.     .--.  .-. .-..----.
@@ -50,51 +61,31 @@ This class implements a crude UDP connector.
 *   executes under an ISR. Keep it brief...
 *******************************************************************************/
 
-#if defined(__BUILD_HAS_THREADS)
-
-  /*
-  * Since listening for connections on this transport involves blocking, we have a
-  *   thread dedicated to the task...
-  */
-  void* _udp_socket_listener_loop(void* active_xport) {
-    if (active_xport) {
-      sigset_t set;
-      sigemptyset(&set);
-      //sigaddset(&set, SIGIO);
-      sigaddset(&set, SIGQUIT);
-      sigaddset(&set, SIGHUP);
-      sigaddset(&set, SIGTERM);
-      sigaddset(&set, SIGVTALRM);
-      sigaddset(&set, SIGINT);
-      int s = pthread_sigmask(SIG_BLOCK, &set, nullptr);
-      ManuvrUDP* listening_inst = (ManuvrUDP*) active_xport;
-
-      if (0 == s) {
-        while (listening_inst->listening()) {
-          // Read data from UDP port. Blocks...
-          if (0 > listening_inst->read_port()) {
-            // Don't thrash the CPU for no reason...
-            sleep_millis(20);
-          }
-        }
-      }
-      else {
-        Kernel::log("Failed to thread the UDP listener loop.\n");
-      }
-
-      // Close the listener...
-      listening_inst->disconnect();
-    }
-    else {
-      Kernel::log("Tried to listen with a NULL transport.");
-    }
+// The first socket is serviced by the SocketReactor. If there are others
+//   bound to the same port, each of them has a thread like this one.
 
-    return nullptr;
+/*
+* Blocks on its own socket, and hands whatever turns up to the same demux as
+*   the reactor uses. The socket times out periodically so that we notice when
+*   we are told to stop.
+*/
+void* ManuvrUDP::receiver_loop(void* arg) {
+  sigset_t set;
+  sigemptyset(&set);
+  sigaddset(&set, SIGQUIT);
+  sigaddset(&set, SIGHUP);
+  sigaddset(&set, SIGTERM);
+  sigaddset(&set, SIGVTALRM);
+  sigaddset(&set, SIGINT);
+  pthread_sigmask(SIG_BLOCK, &set, nullptr);
+  UDPReceiver* rx = (UDPReceiver*) arg;
+  ManuvrUDP*  udp = rx->udp;
+  while (__atomic_load_n(&udp->_rx_run, __ATOMIC_ACQUIRE)) {
+    const int n = udp->_receive_batch(rx, MSG_WAITFORONE);
+    if (n > 0) udp->_ingest(rx, n);
   }
-#else
-  // Threads are unsupported here.
-#endif
-
+  return nullptr;
+}
 
 
 
@@ -114,11 +105,7 @@ This class implements a crude UDP connector.
 * @param  port  A 16-bit port number.
 */
 ManuvrUDP::ManuvrUDP(const char* addr, int port) : ManuvrSocket("ManuvrUDP", addr, port, nullptr) {
-  set_xport_state(MANUVR_XPORT_FLAG_HAS_MULTICAST | MANUVR_XPORT_FLAG_CONNECTIONLESS);
-  _bp_set_flag(BPIPE_FLAG_PIPE_PACKETIZED, true);
-
-  // Per RFC1122: Minimum reassembly buffer is 576 bytes of effective MTU.
-  _xport_mtu = 576;
+  _udp_init();
 }
 
 
@@ -130,11 +117,7 @@ ManuvrUDP::ManuvrUDP(const char* addr, int port) : ManuvrSocket("ManuvrUDP", add
 * @param  opts  An options mask to pass to the underlying socket implentation.
 */
 ManuvrUDP::ManuvrUDP(const char* addr, int port, SocketOpts* opts) : ManuvrSocket("ManuvrUDP", addr, port, opts) {
-  set_xport_state(MANUVR_XPORT_FLAG_HAS_MULTICAST | MANUVR_XPORT_FLAG_CONNECTIONLESS);
-  _bp_set_flag(BPIPE_FLAG_PIPE_PACKETIZED, true);
-
-  // Per RFC1122: Minimum reassembly buffer is 576 bytes of effective MTU.
-  _xport_mtu = 576;
+  _udp_init();
 }
 
 
@@ -145,10 +128,37 @@ ManuvrUDP::ManuvrUDP(const char* addr, int port, SocketOpts* opts) : ManuvrSocke
 *   as appropriate.
 */
 ManuvrUDP::~ManuvrUDP() {
-  std::map<uint16_t, UDPPipe*>::iterator it;
-  for (it = _open_replies.begin(); it != _open_replies.end(); it++) {
-    delete it->second;
+  // Before we are only partly destroyed, make sure we won't be serviced.
+  _stop_receivers();
+  if (eventDriven()) SocketReactor::reactor()->remove(this);
+  _clear_peers();
+  _free_batches();
+  if (0 <= _tx_sock) close(_tx_sock);
+  pthread_mutex_destroy(&_rx_mutex);
+}
+
+
+/*
+* Shared by the constructors.
+*/
+void ManuvrUDP::_udp_init() {
+  set_xport_state(MANUVR_XPORT_FLAG_HAS_MULTICAST | MANUVR_XPORT_FLAG_CONNECTIONLESS);
+  _bp_set_flag(BPIPE_FLAG_PIPE_PACKETIZED, true);
+
+  // Per RFC1122: Minimum reassembly buffer is 576 bytes of effective MTU.
+  _xport_mtu = 576;
+
+  memset(_rx, 0, sizeof(_rx));
+  for (uint8_t i = 0; i < MANUVR_UDP_MAX_RECEIVERS; i++) {
+    _rx[i].udp  = this;
+    _rx[i].sock = -1;
   }
+  // Pipes call back into us as they are destroyed, sometimes while we hold this.
+  pthread_mutexattr_t attr;
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+  pthread_mutex_init(&_rx_mutex, &attr);
+  pthread_mutexattr_destroy(&attr);
 }
 
 
@@ -249,6 +259,10 @@ int8_t ManuvrUDP::fromCounterparty(StringBuilder* buf, int8_t mm) {
 * We're being told to start listening on whatever address was provided to the
 *   constructor. That means we are a server.
 *
+* If more than one receiver was asked for, that many sockets are bound to the
+*   port with SO_REUSEPORT. The kernel spreads counterparties between them by
+*   hashing their addresses, so any one counterparty's datagrams stay in order.
+*
 * @return 0 on success. Negative value on failure.
 */
 int8_t ManuvrUDP::listen() {
@@ -256,28 +270,62 @@ int8_t ManuvrUDP::listen() {
     Kernel::log("A UDP socket was told to listen when it already was. Doing nothing.");
     return -1;
   }
+  if (0 != _alloc_batches()) {
+    Kernel::log("Failed to allocate UDP batch buffers.\n");
+    return -1;
+  }
 
   _sockaddr.sin_family      = AF_INET;
   //_sockaddr.sin_addr.s_addr = htonl(INADDR_ANY);
   _sockaddr.sin_addr.s_addr = inet_addr(_addr);
   _sockaddr.sin_port        = htons(_port_number);
 
-  _sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);    // Open the socket...
-  if (-1 == _sock) {
-    Kernel::log("Failed to bind the UDP server socket.\n");
-    return -1;
-  }
+  for (uint8_t i = 0; i < _rx_count; i++) {
+    int s = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, IPPROTO_UDP);    // Open the socket...
+    if (-1 == s) {
+      Kernel::log("Failed to open a UDP server socket.\n");
+      _stop_receivers();
+      return -1;
+    }
+    _rx[i].sock = s;
+    if (_rx_count > 1) {
+      int on = 1;
+      setsockopt(s, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+    }
+    if (i > 0) {
+      struct timeval tv;
+      tv.tv_sec  = 0;
+      tv.tv_usec = MANUVR_UDP_RECEIVER_WAIT_MS * 1000;
+      setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    }
 
-  /* Bind the server socket */
-  if (bind(_sock, (struct sockaddr *) &_sockaddr, sizeof(_sockaddr))) {
-    Kernel::log("Failed to bind the UDP server socket.\n");
-    return -1;
+    /* Bind the server socket */
+    if (bind(s, (struct sockaddr *) &_sockaddr, sizeof(_sockaddr))) {
+      Kernel::log("Failed to bind the UDP server socket.\n");
+      _stop_receivers();
+      return -1;
+    }
   }
+  _sock = _rx[0].sock;
 
   //initialized(true);
-  createThread(&_thread_id, nullptr, _udp_socket_listener_loop, (void*) this, nullptr);
+  // The reactor will tell us when there are datagrams to read.
+  set_xport_state(MANUVR_XPORT_FLAG_EVENT_DRIVEN);
   listening(true);
-  local_log.concatf("UDP Now listening at %s:%d.\n", _addr, _port_number);
+  if (0 != SocketReactor::reactor()->add(this)) {
+    Kernel::log("Failed to register the UDP listener.\n");
+    disconnect();
+    return -1;
+  }
+  __atomic_store_n(&_rx_run, true, __ATOMIC_RELEASE);
+  for (uint8_t i = 1; i < _rx_count; i++) {
+    if (0 != pthread_create(&_rx[i].thread, nullptr, receiver_loop, (void*) &_rx[i])) {
+      Kernel::log("Failed to start a UDP receiver thread.\n");
+      close(_rx[i].sock);   // Nothing will read it. Let the others have its share.
+      _rx[i].sock = -1;
+    }
+  }
+  local_log.concatf("UDP Now listening at %s:%d (%u receivers, batches of %u).\n", _addr, _port_number, _rx_count, _batch);
 
   flushLocalLog();
   return 0;
@@ -285,84 +333,30 @@ int8_t ManuvrUDP::listen() {
 
 
 /**
-* Read data from UDP port.
+* Stops any receiver threads and closes every socket but the first, which is
+*   left for ManuvrSocket to close.
 *
-* NOTE: Blocks. So only call from within a thread.
-* TODO: ALL OF THIS RUNS IN A THREAD. IT IS NOT SAFE AS IT STANDS.
-*
-* @return 0 on success. Negative value on failure.
+* @return 0 on success.
 */
-int8_t ManuvrUDP::read_port() {
-  int8_t return_value = -1;
-  unsigned char buf[_xport_mtu];
-  struct sockaddr_in cli_addr;
-  for (uint16_t i = 0; i < sizeof(cli_addr); i++) {
-    *((uint8_t *) &cli_addr  + i) = 0;   // Zero the sockaddr structure for use.
-  }
+int8_t ManuvrUDP::disconnect() {
+  _stop_receivers();
+  return ManuvrSocket::disconnect();
+}
 
-  unsigned int clientlen = sizeof(cli_addr);
-  int n = recvfrom(getSockID(), buf, _xport_mtu, 0, (struct sockaddr*) &cli_addr, &clientlen);
-  if (-1 == n) {
-    local_log.concat("Failed to read UDP packet.\n");
-  }
-  else if (n > 0) {
-    // We received a packet. Send it further away.
-    bytes_received += n;   // Log the bytes.
-    if (getVerbosity() > 6) {
-      local_log.concatf("UDP read %d bytes from counterparty (%s).\n", n, (const char*) inet_ntoa(cli_addr.sin_addr));
-    }
-    UDPPipe* related_pipe = _open_replies[cli_addr.sin_port];
-    if (nullptr == related_pipe) {
-      // Non-existence. Create...
-      related_pipe = new UDPPipe(this, cli_addr.sin_addr.s_addr, cli_addr.sin_port);
-      if (_pipe_strategy) related_pipe->setPipeStrategy(_pipe_strategy);
 
-      if (MEM_MGMT_RESPONSIBLE_BEARER == ((BufferPipe*)related_pipe)->fromCounterparty(buf, n, MEM_MGMT_RESPONSIBLE_BEARER)) {
-        // The pipe copied the buffer. Success.
-        // Since we don't have a pipe, we create one and realize that there will
-        //   be nothing on the other side to take the buffer. So we only broadcast
-        //   a system-wide message if mem-mgmt responsibility for the buffer was
-        //   accepted by the bearer.
-        _open_replies[cli_addr.sin_port] = related_pipe;
-        ManuvrMsg* event = Kernel::returnEvent(MANUVR_MSG_XPORT_RECEIVE);
-        // Because we allocated the pipe, we must clean it up if it is not taken.
-        event->setOriginator((EventReceiver*) this);
-        //event->addArg(related_pipe);   // Add the newly-minted pipe.
-        // Convey the transport. This is optional, but helps downstream classes
-        //   make choices about binding to the BufferPipe.
-        //event->addArg((ManuvrXport*) this);
-        Kernel::staticRaiseEvent(event);
-      }
-      else {
-        if (getVerbosity() > 2) {
-          local_log.concat("UDPPipe failed to take the buffer. Dropping this created pipe:\n");
-          related_pipe->printDebug(&local_log);
-        }
-        delete related_pipe;
-      }
-    }
-    else {
-      // We have a related pipe.
-      switch (((BufferPipe*)related_pipe)->fromCounterparty(buf, n, MEM_MGMT_RESPONSIBLE_BEARER)) {
-        case MEM_MGMT_RESPONSIBLE_BEARER:
-          // Success
-          break;
-        case MEM_MGMT_RESPONSIBLE_CREATOR:
-          if (getVerbosity() > 3) local_log.concat("UDPPipe took the buffer, but will probably fail (RESPONSIBLE_CREATOR).\n");
-        case MEM_MGMT_RESPONSIBLE_CALLER:
-        default:
-          break;
-      }
-
-      if (!related_pipe->persistAfterReply()) {
-        if (getVerbosity() > 3) local_log.concat("Attempting orderly cleanup of UDPPipe.\n");
-        delete related_pipe;
-      }
-    }
-    return_value = 0;
+/**
+* Read a batch of datagrams from the UDP port, if there are any. Doesn't block.
+*
+* @return 0 on success. Negative value if there was nothing to read.
+*/
+int8_t ManuvrUDP::read_port() {
+  if (0 >= _sock) return -1;
+  const int n = _receive_batch(&_rx[0], MSG_DONTWAIT);
+  if (n > 0) {
+    _ingest(&_rx[0], n);
+    return 0;
   }
-  flushLocalLog();
-  return return_value;
+  return -1;
 }
 
 
@@ -374,10 +368,7 @@ int8_t ManuvrUDP::read_port() {
 */
 int8_t ManuvrUDP::reset() {
   initialized(false);
-  std::map<uint16_t, UDPPipe*>::iterator it;
-  for (it = _open_replies.begin(); it != _open_replies.end(); it++) {
-    delete it->second;
-  }
+  _clear_peers();
 
   disconnect();
 
@@ -385,6 +376,26 @@ int8_t ManuvrUDP::reset() {
   return 0;
 }
 
+/**
+* Called by the reactor when there are datagrams waiting. Reads batches until
+*   one comes back short.
+*
+* @param  events  The epoll events.
+*/
+void ManuvrUDP::_service_socket(uint32_t events) {
+  for (int i = 0; i < SOCKET_REACTOR_READS_PER_WAKE; i++) {
+    const int n = _receive_batch(&_rx[0], MSG_DONTWAIT);
+    if (n > 0) _ingest(&_rx[0], n);
+    if (n < (int) _batch) break;
+  }
+  if (events & EPOLLERR) {
+    int err = 0;   // Clear the pending error (an ICMP unreachable, say).
+    socklen_t len = sizeof(err);
+    getsockopt(getSockID(), SOL_SOCKET, SO_ERROR, &err, &len);
+  }
+}
+
+
 int8_t ManuvrUDP::connect() {
   return 0;
 }
@@ -397,6 +408,11 @@ bool ManuvrUDP::write_port(unsigned char* out, int out_len) {
 /**
 * Does what it claims to do on linux.
 *
+* Replies that are written while we are handing a batch of datagrams to their
+*   pipes are held, and go out together with sendmmsg() once the batch is done.
+*   Anything else is sent immediately. If we are listening, datagrams leave
+*   from the listening port, so that answers find their way back to us.
+*
 * @param  out     The buffer to send.
 * @param  out_len The size of the buffer.
 * @param  addr    The target IP as a network-order 32-bit unsigned.
@@ -405,33 +421,42 @@ bool ManuvrUDP::write_port(unsigned char* out, int out_len) {
 * @return false on error and true on success.
 */
 bool ManuvrUDP::write_datagram(unsigned char* out, int out_len, uint32_t addr, int port, uint32_t opts) {
-  struct sockaddr_in _tmp_sockaddr;
   bool return_value = false;
+  pthread_mutex_lock(&_rx_mutex);
+  if ((0 < _tx_holders) && (out_len <= (int) _xport_mtu)) {
+    if (_tx_count >= _batch) flushDatagrams();
+    const uint8_t i = _tx_count++;
+    memcpy(_tx_bufs + (i * _xport_mtu), out, out_len);
+    _tx_iov[i].iov_len               = out_len;
+    _tx_peers[i].sin_port            = htons(port);
+    _tx_peers[i].sin_addr.s_addr     = addr;
+    pthread_mutex_unlock(&_rx_mutex);
+    return true;
+  }
 
-  int _client_sock = socket(PF_INET, SOCK_DGRAM, 0);
-
+  struct sockaddr_in _tmp_sockaddr;
+  memset(&_tmp_sockaddr, 0, sizeof(_tmp_sockaddr));
   _tmp_sockaddr.sin_family      = AF_INET;
   _tmp_sockaddr.sin_port        = htons(port);
   _tmp_sockaddr.sin_addr.s_addr = addr;
-  memset(_tmp_sockaddr.sin_zero, '\0', sizeof(_tmp_sockaddr.sin_zero));
 
-  if (-1 != _client_sock) {
-    int result = sendto(_client_sock, out, out_len, 0, (const sockaddr*) &_tmp_sockaddr, sizeof(_tmp_sockaddr));
+  const bool bound = listening() && (0 < _sock);
+  if (!bound && (0 > _tx_sock)) {
+    _tx_sock = socket(PF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  }
+  const int s = bound ? _sock : _tx_sock;
+
+  if (-1 != s) {
+    int result = sendto(s, out, out_len, 0, (const sockaddr*) &_tmp_sockaddr, sizeof(_tmp_sockaddr));
     if (-1 < result) {
       bytes_sent += result;
+      _dgrams_tx++;
+      _tx_calls++;
 
-      UDPPipe* related_pipe = _open_replies[_tmp_sockaddr.sin_port];
-      if (nullptr == related_pipe) {
-        // Non-existence. Create...
-        related_pipe = new UDPPipe(this, _tmp_sockaddr.sin_addr.s_addr, _tmp_sockaddr.sin_port);
-        _open_replies[_tmp_sockaddr.sin_port] = related_pipe;
+      if (bound && (nullptr == findPipe(addr, (uint16_t) port))) {
+        // Non-existence. Create a pipe for the answer to arrive in.
+        _peer_insert(new UDPPipe(this, addr, (uint16_t) port));
       }
-
-      // TODO: We must receive from the socket before we can send again...
-      char buffer[_xport_mtu];
-      buffer[0] = '\0';
-      int _rec_bytes = recvfrom(_client_sock, buffer, _xport_mtu, 0, nullptr, nullptr);
-      Kernel::log(buffer);
       return_value = true;
     }
     else {
@@ -441,26 +466,411 @@ bool ManuvrUDP::write_datagram(unsigned char* out, int out_len, uint32_t addr, i
   else {
     if (getVerbosity() > 3) Kernel::log("Failed to write a UDP datagram. No client socket.\n");
   }
-
+  pthread_mutex_unlock(&_rx_mutex);
   return return_value;
 }
 
 
+/**
+* Sends any replies that were held while a batch was being handed out.
+*
+* @return the number of datagrams sent.
+*/
+int ManuvrUDP::flushDatagrams() {
+  int sent = 0;
+  pthread_mutex_lock(&_rx_mutex);
+  while (sent < _tx_count) {
+    const int n = sendmmsg(_sock, &_tx_msgs[sent], _tx_count - sent, 0);
+    _tx_calls++;
+    if (n <= 0) {
+      if (getVerbosity() > 3) local_log.concatf("Dropped %d held UDP datagrams.\n", _tx_count - sent);
+      break;
+    }
+    for (int i = sent; i < sent + n; i++) bytes_sent += _tx_msgs[i].msg_len;
+    sent += n;
+  }
+  _dgrams_tx += sent;
+  _tx_count = 0;
+  pthread_mutex_unlock(&_rx_mutex);
+  return sent;
+}
+
+
 /**
 * UDP pipes call this during their destructors to cause the
 *   issuing class to clean up references.
 *
-* @param  buf    A pointer to the buffer.
-* @param  len    How long the buffer is.
-* @param  mm     A declaration of memory-management responsibility.
-* @return A declaration of memory-management responsibility.
+* @param  _dead_walking  The pipe being destroyed.
+* @return 0 if the pipe was in the table. -1 otherwise.
 */
 int8_t ManuvrUDP::udpPipeDestroyCallback(UDPPipe* _dead_walking) {
-  _open_replies.erase(_dead_walking->getPort());
+  int8_t ret = -1;
+  pthread_mutex_lock(&_rx_mutex);
+  if (_dead_walking == findPipe(_dead_walking->getAddress(), _dead_walking->getPort())) {
+    _peer_remove(_dead_walking->getAddress(), _dead_walking->getPort());
+    ret = 0;
+  }
+  pthread_mutex_unlock(&_rx_mutex);
+  return ret;
+}
+
+
+/**
+* How many datagrams should be moved per syscall? Can only be changed while we
+*   aren't listening.
+*
+* @param  count  In [1, MANUVR_UDP_MAX_BATCH].
+* @return 0 on success, -1 if listening, -2 if the count is out of range.
+*/
+int8_t ManuvrUDP::setBatchSize(uint8_t count) {
+  if (listening()) return -1;
+  if ((0 == count) || (count > MANUVR_UDP_MAX_BATCH)) return -2;
+  _free_batches();
+  _batch = count;
+  return 0;
+}
+
+
+/**
+* How many sockets should be bound to the port? Every one past the first gets
+*   a thread. Can only be changed while we aren't listening.
+*
+* @param  count  In [1, MANUVR_UDP_MAX_RECEIVERS].
+* @return 0 on success, -1 if listening, -2 if the count is out of range.
+*/
+int8_t ManuvrUDP::setReceivers(uint8_t count) {
+  if (listening()) return -1;
+  if ((0 == count) || (count > MANUVR_UDP_MAX_RECEIVERS)) return -2;
+  _free_batches();
+  _rx_count = count;
+  return 0;
+}
+
+
+/*******************************************************************************
+* Batches                                                                      *
+*******************************************************************************/
+
+/*
+* Allocates the receive batch for each receiver, and the batch of held replies.
+*   The headers are pointed at their buffers once, here. Only the lengths need
+*   to be reset between calls.
+*/
+int8_t ManuvrUDP::_alloc_batches() {
+  if (nullptr != _tx_msgs) return 0;   // Already done.
+  for (uint8_t r = 0; r <= _rx_count; r++) {
+    struct mmsghdr*     msgs  = (struct mmsghdr*) calloc(_batch, sizeof(struct mmsghdr));
+    struct iovec*       iov   = (struct iovec*) calloc(_batch, sizeof(struct iovec));
+    struct sockaddr_in* peers = (struct sockaddr_in*) calloc(_batch, sizeof(struct sockaddr_in));
+    uint8_t*            bufs  = (uint8_t*) malloc(_batch * _xport_mtu);
+    if (r < _rx_count) {
+      _rx[r].msgs  = msgs;
+      _rx[r].iov   = iov;
+      _rx[r].peers = peers;
+      _rx[r].bufs  = bufs;
+    }
+    else {   // The last one holds replies.
+      _tx_msgs  = msgs;
+      _tx_iov   = iov;
+      _tx_peers = peers;
+      _tx_bufs  = bufs;
+    }
+    if ((nullptr == msgs) || (nullptr == iov) || (nullptr == peers) || (nullptr == bufs)) {
+      _free_batches();
+      return -1;
+    }
+    for (uint8_t i = 0; i < _batch; i++) {
+      peers[i].sin_family          = AF_INET;
+      iov[i].iov_base              = bufs + (i * _xport_mtu);
+      iov[i].iov_len               = _xport_mtu;
+      msgs[i].msg_hdr.msg_name     = &peers[i];
+      msgs[i].msg_hdr.msg_namelen  = sizeof(struct sockaddr_in);
+      msgs[i].msg_hdr.msg_iov      = &iov[i];
+      msgs[i].msg_hdr.msg_iovlen   = 1;
+    }
+  }
+  return 0;
+}
+
+
+void ManuvrUDP::_free_batches() {
+  for (uint8_t r = 0; r < MANUVR_UDP_MAX_RECEIVERS; r++) {
+    if (nullptr != _rx[r].msgs) {   free(_rx[r].msgs);    _rx[r].msgs  = nullptr;  }
+    if (nullptr != _rx[r].iov) {    free(_rx[r].iov);     _rx[r].iov   = nullptr;  }
+    if (nullptr != _rx[r].peers) {  free(_rx[r].peers);   _rx[r].peers = nullptr;  }
+    if (nullptr != _rx[r].bufs) {   free(_rx[r].bufs);    _rx[r].bufs  = nullptr;  }
+  }
+  if (nullptr != _tx_msgs) {   free(_tx_msgs);    _tx_msgs  = nullptr;  }
+  if (nullptr != _tx_iov) {    free(_tx_iov);     _tx_iov   = nullptr;  }
+  if (nullptr != _tx_peers) {  free(_tx_peers);   _tx_peers = nullptr;  }
+  if (nullptr != _tx_bufs) {   free(_tx_bufs);    _tx_bufs  = nullptr;  }
+  _tx_count = 0;
+}
+
+
+/*
+* Joins the receiver threads and closes their sockets. The first receiver's
+*   socket belongs to ManuvrSocket, and is only forgotten.
+*/
+void ManuvrUDP::_stop_receivers() {
+  const bool was_running = __atomic_exchange_n(&_rx_run, false, __ATOMIC_ACQ_REL);
+  for (uint8_t i = 1; i < MANUVR_UDP_MAX_RECEIVERS; i++) {
+    if (0 <= _rx[i].sock) {
+      if (was_running) pthread_join(_rx[i].thread, nullptr);
+      close(_rx[i].sock);
+      _rx[i].sock = -1;
+    }
+  }
+  if ((0 <= _rx[0].sock) && (_rx[0].sock != _sock)) {
+    close(_rx[0].sock);   // We failed before ManuvrSocket took it.
+  }
+  _rx[0].sock = -1;
+}
+
+
+/*
+* Reads as many datagrams as will fit in the receiver's batch.
+*
+* @param  rx     The receiver.
+* @param  flags  MSG_DONTWAIT from the reactor. MSG_WAITFORONE from a thread.
+* @return the number of datagrams read, or -1 if there were none.
+*/
+int ManuvrUDP::_receive_batch(UDPReceiver* rx, int flags) {
+  for (uint8_t i = 0; i < _batch; i++) {
+    rx->msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+  }
+  const int n = recvmmsg(rx->sock, rx->msgs, _batch, flags, nullptr);
+  if ((-1 == n) && (EAGAIN != errno) && (EWOULDBLOCK != errno) && (EINTR != errno)) {
+    if (getVerbosity() > 3) {
+      pthread_mutex_lock(&_rx_mutex);
+      local_log.concat("Failed to read UDP packets.\n");
+      pthread_mutex_unlock(&_rx_mutex);
+    }
+  }
+  return n;
+}
+
+
+/*
+* Hands a batch of datagrams to the pipes of their counterparties, creating
+*   pipes where there are none. Replies are held until the whole batch has been
+*   handed out, and then sent together.
+* Datagrams that didn't fit in the MTU are dropped rather than truncated.
+*
+* The mutex is only held to find (or add) a counterparty, and to take the held
+*   replies, so that receivers don't wait on each other's pipes. SO_REUSEPORT
+*   sends a given counterparty's datagrams to the same socket, so a pipe is
+*   only ever fed by one receiver.
+*
+* @param  rx     The receiver that read the batch.
+* @param  count  How many datagrams it read.
+*/
+void ManuvrUDP::_ingest(UDPReceiver* rx, int count) {
+  StringBuilder log;
+  uint32_t rx_bytes = 0;
+  pthread_mutex_lock(&_rx_mutex);
+  _rx_calls++;
+  _dgrams_rx += count;
+  _tx_holders++;
+  pthread_mutex_unlock(&_rx_mutex);
+
+  for (int i = 0; i < count; i++) {
+    const unsigned int n      = rx->msgs[i].msg_len;
+    const uint32_t     ip     = rx->peers[i].sin_addr.s_addr;
+    const uint16_t     port   = ntohs(rx->peers[i].sin_port);
+    uint8_t*           buf    = (uint8_t*) rx->iov[i].iov_base;
+    rx_bytes += n;   // Log the bytes.
+    if (rx->msgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+      if (getVerbosity() > 3) log.concatf("Dropped a UDP datagram larger than the MTU (%u).\n", _xport_mtu);
+      continue;
+    }
+    if (0 == n) continue;
+    if (getVerbosity() > 6) {
+      log.concatf("UDP read %u bytes from counterparty (%s).\n", n, (const char*) inet_ntoa(rx->peers[i].sin_addr));
+    }
+
+    // We received a packet. Send it further away.
+    bool created = false;
+    pthread_mutex_lock(&_rx_mutex);
+    UDPPipe* related_pipe = findPipe(ip, port);
+    if (nullptr == related_pipe) {
+      // Non-existence. Create...
+      related_pipe = new UDPPipe(this, ip, port);
+      if (_pipe_strategy) related_pipe->setPipeStrategy(_pipe_strategy);
+      _peer_insert(related_pipe);
+      created = true;
+    }
+    pthread_mutex_unlock(&_rx_mutex);
+
+    if (created) {
+      if (MEM_MGMT_RESPONSIBLE_BEARER == ((BufferPipe*)related_pipe)->fromCounterparty(buf, n, MEM_MGMT_RESPONSIBLE_BEARER)) {
+        // The pipe copied the buffer. Success.
+        // Since we don't have a pipe, we create one and realize that there will
+        //   be nothing on the other side to take the buffer. So we only broadcast
+        //   a system-wide message if mem-mgmt responsibility for the buffer was
+        //   accepted by the bearer.
+        ManuvrMsg* event = Kernel::returnEvent(MANUVR_MSG_XPORT_RECEIVE);
+        // Because we allocated the pipe, we must clean it up if it is not taken.
+        event->setOriginator((EventReceiver*) this);
+        //event->addArg(related_pipe);   // Add the newly-minted pipe.
+        // Convey the transport. This is optional, but helps downstream classes
+        //   make choices about binding to the BufferPipe.
+        //event->addArg((ManuvrXport*) this);
+        Kernel::isrRaiseEvent(event);   // We are on the reactor's thread.
+      }
+      else {
+        if (getVerbosity() > 2) {
+          log.concat("UDPPipe failed to take the buffer. Dropping this created pipe:\n");
+          related_pipe->printDebug(&log);
+        }
+        delete related_pipe;   // Takes itself out of the table.
+      }
+    }
+    else {
+      // We have a related pipe.
+      switch (((BufferPipe*)related_pipe)->fromCounterparty(buf, n, MEM_MGMT_RESPONSIBLE_BEARER)) {
+        case MEM_MGMT_RESPONSIBLE_BEARER:
+          // Success
+          break;
+        case MEM_MGMT_RESPONSIBLE_CREATOR:
+          if (getVerbosity() > 3) log.concat("UDPPipe took the buffer, but will probably fail (RESPONSIBLE_CREATOR).\n");
+        case MEM_MGMT_RESPONSIBLE_CALLER:
+        default:
+          break;
+      }
+
+      if (!related_pipe->persistAfterReply()) {
+        if (getVerbosity() > 3) log.concat("Attempting orderly cleanup of UDPPipe.\n");
+        delete related_pipe;
+      }
+    }
+  }
+
+  pthread_mutex_lock(&_rx_mutex);
+  bytes_received += rx_bytes;
+  _tx_holders--;
+  flushDatagrams();   // Ours, and any held for other receivers so far.
+  if (log.length() > 0) local_log.concatHandoff(&log);
+  flushLocalLog();
+  pthread_mutex_unlock(&_rx_mutex);
+}
+
+
+/*******************************************************************************
+* Counterparty table                                                           *
+* Open addressing with linear probing, keyed on address and port. Removal      *
+*   shifts the rest of the run back, so there are no tombstones to sweep.      *
+*******************************************************************************/
+
+/**
+* @param  addr  The counterparty's IP as a network-order 32-bit unsigned.
+* @param  port  The counterparty's port as a native-order 16-bit unsigned.
+* @return the pipe for the counterparty, or nullptr if there isn't one.
+*/
+UDPPipe* ManuvrUDP::findPipe(uint32_t addr, uint16_t port) {
+  if (0 == _peer_cap) return nullptr;
+  const uint64_t key  = _peer_key(addr, port);
+  const uint32_t mask = _peer_cap - 1;
+  uint32_t idx = _peer_hash(key) & mask;
+  while (0 != _peer_slots[idx].key) {
+    if (key == _peer_slots[idx].key) return _peer_slots[idx].pipe;
+    idx = (idx + 1) & mask;
+  }
+  return nullptr;
+}
+
+
+/*
+* Adds the pipe under its counterparty, replacing any pipe already there.
+*/
+int8_t ManuvrUDP::_peer_insert(UDPPipe* pipe) {
+  if (((_peer_count + 1) * 4) > (_peer_cap * 3)) {   // Keep the load under 3/4.
+    if (0 != _peer_grow()) return -1;
+  }
+  const uint64_t key  = _peer_key(pipe->getAddress(), pipe->getPort());
+  const uint32_t mask = _peer_cap - 1;
+  uint32_t idx = _peer_hash(key) & mask;
+  while ((0 != _peer_slots[idx].key) && (key != _peer_slots[idx].key)) {
+    idx = (idx + 1) & mask;
+  }
+  if (0 == _peer_slots[idx].key) _peer_count++;
+  _peer_slots[idx].key  = key;
+  _peer_slots[idx].pipe = pipe;
+  return 0;
+}
+
+
+void ManuvrUDP::_peer_remove(uint32_t addr, uint16_t port) {
+  if (0 == _peer_cap) return;
+  const uint64_t key  = _peer_key(addr, port);
+  const uint32_t mask = _peer_cap - 1;
+  uint32_t i = _peer_hash(key) & mask;
+  while (key != _peer_slots[i].key) {
+    if (0 == _peer_slots[i].key) return;   // Not here.
+    i = (i + 1) & mask;
+  }
+  _peer_slots[i].key = 0;
+  _peer_count--;
+  // Anything later in the run that could live in the hole is moved into it.
+  uint32_t j = i;
+  while (true) {
+    j = (j + 1) & mask;
+    if (0 == _peer_slots[j].key) break;
+    const uint32_t home = _peer_hash(_peer_slots[j].key) & mask;
+    const bool stays = (i <= j) ? ((i < home) && (home <= j)) : ((i < home) || (home <= j));
+    if (!stays) {
+      _peer_slots[i]     = _peer_slots[j];
+      _peer_slots[j].key = 0;
+      i = j;
+    }
+  }
+}
+
+
+int8_t ManuvrUDP::_peer_grow() {
+  const unsigned int nu_cap = (0 == _peer_cap) ? 16 : (_peer_cap << 1);
+  UDPPeerSlot* nu_slots = (UDPPeerSlot*) calloc(nu_cap, sizeof(UDPPeerSlot));
+  if (nullptr == nu_slots) return -1;
+  const uint32_t mask = nu_cap - 1;
+  for (unsigned int i = 0; i < _peer_cap; i++) {
+    if (0 != _peer_slots[i].key) {
+      uint32_t idx = _peer_hash(_peer_slots[i].key) & mask;
+      while (0 != nu_slots[idx].key) idx = (idx + 1) & mask;
+      nu_slots[idx] = _peer_slots[i];
+    }
+  }
+  if (nullptr != _peer_slots) free(_peer_slots);
+  _peer_slots = nu_slots;
+  _peer_cap   = nu_cap;
   return 0;
 }
 
 
+/*
+* Destroys every pipe in the table. The pipes remove themselves as they go, and
+*   that shuffles the table, so we take a list of them first.
+*/
+void ManuvrUDP::_clear_peers() {
+  pthread_mutex_lock(&_rx_mutex);
+  if (0 < _peer_count) {
+    UDPPipe** doomed = (UDPPipe**) malloc(sizeof(UDPPipe*) * _peer_count);
+    unsigned int count = 0;
+    if (nullptr != doomed) {
+      for (unsigned int i = 0; i < _peer_cap; i++) {
+        if (0 != _peer_slots[i].key) doomed[count++] = _peer_slots[i].pipe;
+      }
+      for (unsigned int i = 0; i < count; i++) delete doomed[i];
+      free(doomed);
+    }
+  }
+  if (nullptr != _peer_slots) free(_peer_slots);
+  _peer_slots = nullptr;
+  _peer_cap   = 0;
+  _peer_count = 0;
+  pthread_mutex_unlock(&_rx_mutex);
+}
+
+
 
 /*******************************************************************************
 * ######## ##     ## ######## ##    ## ########  ######
@@ -509,11 +919,16 @@ void ManuvrUDP::printDebug(StringBuilder* output) {
   output->concatf("-- _opts           %p\n", _opts);
   output->concatf("-- _sock           0x%08x\n", _sock);
 
-  output->concatf("--\n-- _open_replies \n");
-  std::map<uint16_t, UDPPipe*>::iterator it;
-  for (it = _open_replies.begin(); it != _open_replies.end(); it++) {
-    it->second->printDebug(output);
+  output->concatf("-- Receivers:      %u, in batches of %u\n", _rx_count, _batch);
+  output->concatf("-- Datagrams in:   %u in %u batches\n", _dgrams_rx, _rx_calls);
+  output->concatf("-- Datagrams out:  %u in %u calls\n", _dgrams_tx, _tx_calls);
+
+  output->concatf("--\n-- Counterparties (%u):\n", _peer_count);
+  pthread_mutex_lock(&_rx_mutex);
+  for (unsigned int i = 0; i < _peer_cap; i++) {
+    if (0 != _peer_slots[i].key) _peer_slots[i].pipe->printDebug(output);
   }
+  pthread_mutex_unlock(&_rx_mutex);
   output->concat("\n");
 }
 
@@ -550,7 +965,7 @@ int8_t ManuvrUDP::callback_proc(ManuvrMsg* event) {
             // The pipe was NOT taken. Clean it up.
             if (0 == event->getArgAs(&tmp_pipe)) {
               // We rely on the UDPPipe to call us back to trigger a cleanup of
-              //   the entry in _open_replies.
+              //   its entry in the counterparty table.
               delete (UDPPipe*) tmp_pipe;  // TODO: Any safer way?
             }
             break;
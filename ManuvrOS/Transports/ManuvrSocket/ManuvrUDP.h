@@ -21,6 +21,12 @@ limitations under the License.
 This driver is designed to give Manuvr platform-abstracted socket connection.
 This is basically only for linux until it is needed in a smaller space.
 
+Datagrams are read in batches with recvmmsg(), and handed to the UDPPipe for
+  their counterparty, which is found in a hash table keyed on address and port.
+  Replies written while a batch is being handed out are sent together with
+  sendmmsg(). Optionally, several sockets can be bound to the same port with
+  SO_REUSEPORT, each read by its own thread.
+
 */
 
 
@@ -43,6 +49,7 @@ This is basically only for linux until it is needed in a smaller space.
   #include <sys/socket.h>
   #include <netinet/in.h>
   #include <arpa/inet.h>
+  #include <pthread.h>
 #else
   // No supportage.
 #endif
@@ -75,6 +82,11 @@ This is basically only for linux until it is needed in a smaller space.
 
 #define MANUVR_UDP_FLAG_PERSIST       0x01  // Keep this pipe alive until explicit close.
 
+#define MANUVR_UDP_DEFAULT_BATCH      16    // Datagrams moved per syscall, unless told otherwise.
+#define MANUVR_UDP_MAX_BATCH          64
+#define MANUVR_UDP_MAX_RECEIVERS      8     // Sockets bound to the same port with SO_REUSEPORT.
+#define MANUVR_UDP_RECEIVER_WAIT_MS   100   // How often a receiver thread checks if it should quit.
+
 class ManuvrUDP;
 
 /*
@@ -102,7 +114,8 @@ class UDPPipe : public BufferPipe {
       _udpflags = (en) ? (_udpflags | MANUVR_UDP_FLAG_PERSIST) : (_udpflags & ~(MANUVR_UDP_FLAG_PERSIST));
     };
 
-    inline uint16_t getPort() {   return _port;   };
+    inline uint32_t getAddress() {   return _ip;     };
+    inline uint16_t getPort() {      return _port;   };
 
 
   protected:
@@ -119,6 +132,27 @@ class UDPPipe : public BufferPipe {
 
 
 
+/* One entry in the table of counterparties we have pipes open to. */
+typedef struct {
+  uint64_t key;    // (addr << 16) | port. Address in network order. Zero means empty.
+  UDPPipe* pipe;
+} UDPPeerSlot;
+
+/*
+* A bound socket, and the memory that a batch of datagrams is read into. The
+*   first receiver is serviced by the SocketReactor. Any others have threads.
+*/
+typedef struct {
+  ManuvrUDP*          udp;
+  struct mmsghdr*     msgs;
+  struct iovec*       iov;
+  struct sockaddr_in* peers;
+  uint8_t*            bufs;     // One MTU for each datagram in the batch.
+  pthread_t           thread;
+  int                 sock;
+} UDPReceiver;
+
+
 class ManuvrUDP : public ManuvrSocket
     #if defined(MANUVR_CONSOLE_SUPPORT)
       , public ConsoleInterface
@@ -146,12 +180,26 @@ class ManuvrUDP : public ManuvrSocket
 
     int8_t connect();
     int8_t listen();
+    int8_t disconnect();
     int8_t reset();
     int8_t read_port();
 
     bool write_port(unsigned char* out, int out_len);
     int8_t udpPipeDestroyCallback(UDPPipe*);
 
+    int8_t setBatchSize(uint8_t);    // Datagrams per syscall. Before listen().
+    int8_t setReceivers(uint8_t);    // Sockets on the port. Before listen().
+    int    flushDatagrams();         // Sends any replies that are being held.
+    UDPPipe* findPipe(uint32_t addr, uint16_t port);
+
+    inline uint8_t  batchSize() {           return _batch;           };
+    inline uint8_t  receivers() {           return _rx_count;        };
+    inline unsigned int peers() {           return _peer_count;      };
+    inline uint32_t datagramsReceived() {   return _dgrams_rx;       };
+    inline uint32_t datagramsSent() {       return _dgrams_tx;       };
+    inline uint32_t receiveCalls() {        return _rx_calls;        };
+    inline uint32_t sendCalls() {           return _tx_calls;        };
+
     bool write_datagram(unsigned char* out, int out_len, uint32_t addr, int port, uint32_t opts);
     inline bool write_datagram(unsigned char* out, int out_len, uint32_t addr, int port) {
       return write_datagram(out, out_len, addr, port, 0);
@@ -166,11 +214,42 @@ class ManuvrUDP : public ManuvrSocket
 
   protected:
     int8_t attached();
+    void   _service_socket(uint32_t events);
 
 
   private:
-    // We index our spawned UDPPipes by counterparty port number.
-    std::map<uint16_t, UDPPipe*> _open_replies;
+    pthread_mutex_t _rx_mutex;      // Guards the counterparty table and held replies.
+    UDPReceiver     _rx[MANUVR_UDP_MAX_RECEIVERS];
+    UDPPeerSlot*    _peer_slots    = nullptr;   // Open-addressed. Power-of-two sized.
+    unsigned int    _peer_cap      = 0;
+    unsigned int    _peer_count    = 0;
+    struct mmsghdr*     _tx_msgs   = nullptr;   // Replies held until the batch is done.
+    struct iovec*       _tx_iov    = nullptr;
+    struct sockaddr_in* _tx_peers  = nullptr;
+    uint8_t*            _tx_bufs   = nullptr;
+    uint32_t        _dgrams_rx     = 0;
+    uint32_t        _dgrams_tx     = 0;
+    uint32_t        _rx_calls      = 0;
+    uint32_t        _tx_calls      = 0;
+    int             _tx_sock       = -1;        // For sending when we aren't bound.
+    uint8_t         _batch         = MANUVR_UDP_DEFAULT_BATCH;
+    uint8_t         _rx_count      = 1;
+    uint8_t         _tx_count      = 0;
+    uint8_t         _tx_holders    = 0;       // Receivers handing out a batch. Replies are held while any are.
+    bool            _rx_run        = false;   // Receiver threads quit when this goes false. Atomic access only.
+
+    void   _udp_init();
+    int8_t _alloc_batches();
+    void   _free_batches();
+    void   _stop_receivers();
+    int    _receive_batch(UDPReceiver*, int flags);
+    void   _ingest(UDPReceiver*, int count);
+    void   _clear_peers();
+    int8_t _peer_insert(UDPPipe*);
+    void   _peer_remove(uint32_t addr, uint16_t port);
+    int8_t _peer_grow();
+
+    static void* receiver_loop(void*);
 };
 
 
@@ -0,0 +1,274 @@
+/*
+File:   SocketReactor.cpp
+Author: J. Ian Lindsay
+Date:   2026.10.18
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+An epoll loop for ManuvrSocket. See the header for the arrangement.
+*/
+
+#include <CommonConstants.h>
+#include "ManuvrSocket.h"
+#include "SocketReactor.h"
+
+#if (defined(MANUVR_SUPPORT_TCPSOCKET) || defined(MANUVR_SUPPORT_UDP)) && defined(__MANUVR_LINUX)
+#include <Platform/Platform.h>
+#include <signal.h>
+#include <errno.h>
+
+
+/*******************************************************************************
+*      _______.___________.    ___   .___________. __    ______     _______.
+*     /       |           |   /   \  |           ||  |  /      |   /       |
+*    |   (----`---|  |----`  /  ^  \ `---|  |----`|  | |  ,----'  |   (----`
+*     \   \       |  |      /  /_\  \    |  |     |  | |  |        \   \
+* .----)   |      |  |     /  _____  \   |  |     |  | |  `----.----)   |
+* |_______/       |__|    /__/     \__\  |__|     |__|  \______|_______/
+*
+* Static members and initializers should be located here.
+*******************************************************************************/
+
+/**
+* @return the reactor that all sockets share, or nullptr if it couldn't be
+*           started.
+*/
+SocketReactor* SocketReactor::reactor() {
+  static SocketReactor* _shared = nullptr;
+  static pthread_once_t _once = PTHREAD_ONCE_INIT;
+  struct Starter {
+    static void start() {
+      SocketReactor* r = new SocketReactor();
+      if (0 == r->_start()) {
+        _shared = r;
+      }
+      // On failure, we leak the instance. It may be half-owned by a thread.
+    };
+  };
+  pthread_once(&_once, Starter::start);
+  return _shared;
+}
+
+
+/*
+* The reactor's thread.
+*/
+void* SocketReactor::reactor_loop(void* arg) {
+  sigset_t set;
+  sigemptyset(&set);
+  sigaddset(&set, SIGQUIT);
+  sigaddset(&set, SIGHUP);
+  sigaddset(&set, SIGTERM);
+  sigaddset(&set, SIGVTALRM);
+  sigaddset(&set, SIGINT);
+  pthread_sigmask(SIG_BLOCK, &set, nullptr);
+  SocketReactor* r = (SocketReactor*) arg;
+  while (true) {
+    r->poll(-1);
+  }
+  return nullptr;
+}
+
+
+/*******************************************************************************
+*   ___ _              ___      _ _              _      _
+*  / __| |__ _ ______ | _ ) ___(_) |___ _ _ _ __| |__ _| |_ ___
+* | (__| / _` (_-<_-< | _ \/ _ \ | / -_) '_| '_ \ / _` |  _/ -_)
+*  \___|_\__,_/__/__/ |___/\___/_|_\___|_| | .__/_\__,_|\__\___|
+*                                          |_|
+* Constructors/destructors, class initialization functions and so-forth...
+*******************************************************************************/
+
+SocketReactor::SocketReactor() {
+  pthread_mutexattr_t attr;
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+  pthread_mutex_init(&_mutex, &attr);
+  pthread_mutexattr_destroy(&attr);
+}
+
+
+SocketReactor::~SocketReactor() {
+  if (_epfd >= 0) close(_epfd);
+  if (nullptr != _slots) free(_slots);
+  pthread_mutex_destroy(&_mutex);
+}
+
+
+/**
+* @return 0 on success, -1 if epoll is unavailable, -2 if the thread failed.
+*/
+int8_t SocketReactor::_start() {
+  _epfd = epoll_create1(EPOLL_CLOEXEC);
+  if (_epfd < 0) return -1;
+  ManuvrThreadOptions _t_opts;
+  _t_opts.thread_name = (char*) "sock_reactor";
+  _t_opts.stack_sz    = 16384;
+  if (0 != createThread(&_thread_id, nullptr, reactor_loop, (void*) this, &_t_opts)) {
+    return -2;
+  }
+  return 0;
+}
+
+
+/*******************************************************************************
+* Registration                                                                 *
+*******************************************************************************/
+
+/**
+* Starts watching the socket's descriptor.
+*
+* @param  sock  The socket. Must have an open descriptor.
+* @return 0 on success, -1 if it is already registered, -2 on failure.
+*/
+int8_t SocketReactor::add(ManuvrSocket* sock) {
+  int8_t ret = -2;
+  pthread_mutex_lock(&_mutex);
+  if (0 != sock->_reactor_slot) {
+    ret = -1;
+  }
+  else if ((0 != _free_head) || (0 == _grow())) {
+    const uint32_t idx = _free_head - 1;
+    ReactorSlot* slot = &_slots[idx];
+    struct epoll_event ev;
+    ev.events   = EPOLLIN | EPOLLRDHUP;
+    ev.data.u64 = (((uint64_t) slot->gen) << 32) | idx;
+    if (0 == epoll_ctl(_epfd, EPOLL_CTL_ADD, sock->getSockID(), &ev)) {
+      _free_head          = slot->next_free;
+      slot->sock          = sock;
+      sock->_reactor_slot = idx + 1;
+      _sockets++;
+      ret = 0;
+    }
+  }
+  pthread_mutex_unlock(&_mutex);
+  return ret;
+}
+
+
+/**
+* Stops watching the socket. Once this returns, the socket will not be called
+*   again, even for events that were already collected. Must be called before
+*   the descriptor is closed.
+*
+* @param  sock  The socket.
+* @return 0 on success, -1 if it wasn't registered.
+*/
+int8_t SocketReactor::remove(ManuvrSocket* sock) {
+  int8_t ret = -1;
+  pthread_mutex_lock(&_mutex);
+  if (0 != sock->_reactor_slot) {
+    const uint32_t idx = sock->_reactor_slot - 1;
+    ReactorSlot* slot = &_slots[idx];
+    epoll_ctl(_epfd, EPOLL_CTL_DEL, sock->getSockID(), nullptr);
+    slot->sock      = nullptr;
+    slot->gen++;
+    slot->next_free = _free_head;
+    _free_head      = idx + 1;
+    sock->_reactor_slot = 0;
+    _sockets--;
+    ret = 0;
+  }
+  pthread_mutex_unlock(&_mutex);
+  return ret;
+}
+
+
+/**
+* Starts or stops calling the socket when it is writable, as well as when it
+*   is readable.
+*
+* @param  sock  The socket.
+* @param  en    True to be told about writability.
+* @return 0 on success, -1 if it isn't registered, -2 on failure.
+*/
+int8_t SocketReactor::watchWritable(ManuvrSocket* sock, bool en) {
+  int8_t ret = -1;
+  pthread_mutex_lock(&_mutex);
+  if (0 != sock->_reactor_slot) {
+    const uint32_t idx = sock->_reactor_slot - 1;
+    struct epoll_event ev;
+    ev.events   = EPOLLIN | EPOLLRDHUP | (en ? EPOLLOUT : 0);
+    ev.data.u64 = (((uint64_t) _slots[idx].gen) << 32) | idx;
+    ret = (0 == epoll_ctl(_epfd, EPOLL_CTL_MOD, sock->getSockID(), &ev)) ? 0 : -2;
+  }
+  pthread_mutex_unlock(&_mutex);
+  return ret;
+}
+
+
+/*
+* Doubles the slot table, and puts the new slots on the free list.
+*/
+int8_t SocketReactor::_grow() {
+  const uint32_t nu_count = (0 == _slot_count) ? 64 : (_slot_count << 1);
+  ReactorSlot* nu_slots = (ReactorSlot*) realloc(_slots, sizeof(ReactorSlot) * nu_count);
+  if (nullptr == nu_slots) return -1;
+  _slots = nu_slots;
+  for (uint32_t i = nu_count; i > _slot_count; i--) {
+    _slots[i - 1].sock      = nullptr;
+    _slots[i - 1].gen       = 0;
+    _slots[i - 1].next_free = _free_head;
+    _free_head = i;
+  }
+  _slot_count = nu_count;
+  return 0;
+}
+
+
+/*******************************************************************************
+* Dispatch                                                                     *
+*******************************************************************************/
+
+/**
+* Waits for sockets to become ready, and calls each of them.
+*
+* @param  timeout_ms  How long to wait. -1 waits forever.
+* @return the number of sockets that were called.
+*/
+int SocketReactor::poll(int timeout_ms) {
+  const int n = epoll_wait(_epfd, _ready, SOCKET_REACTOR_MAX_EVENTS, timeout_ms);
+  if (n <= 0) return 0;   // Timeout, or EINTR.
+
+  int called = 0;
+  pthread_mutex_lock(&_mutex);
+  _passes++;
+  for (int i = 0; i < n; i++) {
+    const uint32_t idx = (uint32_t) (_ready[i].data.u64 & 0xFFFFFFFF);
+    const uint32_t gen = (uint32_t) (_ready[i].data.u64 >> 32);
+    if ((idx < _slot_count) && (gen == _slots[idx].gen) && (nullptr != _slots[idx].sock)) {
+      _slots[idx].sock->_service_socket(_ready[i].events);
+      called++;
+    }
+    else {
+      _stale++;   // Removed since epoll_wait() returned.
+    }
+  }
+  _dispatches += called;
+  pthread_mutex_unlock(&_mutex);
+  return called;
+}
+
+
+void SocketReactor::printDebug(StringBuilder* output) {
+  output->concat("---< SocketReactor >-----------------------------\n");
+  output->concatf("-- Sockets:         %u (%u slots)\n", _sockets, _slot_count);
+  output->concatf("-- Passes:          %u\n", _passes);
+  output->concatf("-- Dispatches:      %u\n", _dispatches);
+  output->concatf("-- Stale events:    %u\n", _stale);
+}
+
+#endif  // Socket support on linux?
@@ -0,0 +1,103 @@
+/*
+File:   SocketReactor.h
+Author: J. Ian Lindsay
+Date:   2026.10.18
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+A single thread that waits on every socket at once, by way of epoll. When a
+  socket is ready, the reactor calls into the ManuvrSocket that owns it, which
+  accepts or reads whatever is waiting without blocking. So there is no thread
+  per socket, and no sleeping in between reads.
+
+Sockets are registered with a slot in a table, and epoll hands back the slot
+  and its generation rather than a pointer. A socket that is removed, even by
+  the socket itself in the middle of a batch of events, will not be called
+  again. Dispatch and removal are serialized by a recursive mutex.
+
+Level-triggered, so a socket that doesn't drain itself in one call will be
+  called again on the next pass, after everyone else has had a turn.
+
+A socket with output waiting can also ask to be called when it is writable.
+  It should stop asking once its output is gone, or it will be called on
+  every pass.
+*/
+
+
+#ifndef __MANUVR_SOCKET_REACTOR_H__
+#define __MANUVR_SOCKET_REACTOR_H__
+
+#include <inttypes.h>
+#include <DataStructures/StringBuilder.h>
+
+#if defined(__MANUVR_LINUX)
+#include <pthread.h>
+#include <sys/epoll.h>
+
+#define SOCKET_REACTOR_MAX_EVENTS      64     // Events taken from the kernel per pass.
+#define SOCKET_REACTOR_RX_BUFFER       4096   // Bytes read at a go from a stream socket.
+#define SOCKET_REACTOR_READS_PER_WAKE  8      // Reads per socket per pass, for fairness.
+
+class ManuvrSocket;
+
+/* One registered socket. */
+typedef struct {
+  ManuvrSocket* sock;
+  uint32_t      gen;         // Bumped on every removal.
+  uint32_t      next_free;   // Index of the next free slot, plus one. Only while free.
+} ReactorSlot;
+
+
+class SocketReactor {
+  public:
+    int8_t add(ManuvrSocket*);      // Returns 0 on success.
+    int8_t remove(ManuvrSocket*);   // Returns 0 if the socket was registered.
+    int8_t watchWritable(ManuvrSocket*, bool);   // Returns 0 if the socket was registered.
+    int    poll(int timeout_ms);    // Services whatever is ready. Returns the count.
+
+    inline unsigned int sockets() {       return _sockets;       };
+    inline uint32_t     passes() {        return _passes;        };
+    inline uint32_t     dispatches() {    return _dispatches;    };
+    inline uint32_t     staleEvents() {   return _stale;         };
+
+    void printDebug(StringBuilder*);
+
+    static SocketReactor* reactor();   // The shared instance. Started on first use.
+    static void* reactor_loop(void*);
+
+
+  private:
+    pthread_mutex_t _mutex;
+    struct epoll_event _ready[SOCKET_REACTOR_MAX_EVENTS];
+    ReactorSlot*  _slots       = nullptr;
+    uint32_t      _slot_count  = 0;
+    uint32_t      _free_head   = 0;     // Index of the first free slot, plus one.
+    unsigned int  _sockets     = 0;
+    uint32_t      _passes      = 0;     // Wake-ups with something to do.
+    uint32_t      _dispatches  = 0;     // Calls into sockets.
+    uint32_t      _stale       = 0;     // Events for sockets that were already removed.
+    unsigned long _thread_id   = 0;
+    int           _epfd        = -1;
+
+    SocketReactor();
+    ~SocketReactor();
+
+    int8_t _start();
+    int8_t _grow();
+};
+
+#endif  // __MANUVR_LINUX
+#endif  // __MANUVR_SOCKET_REACTOR_H__
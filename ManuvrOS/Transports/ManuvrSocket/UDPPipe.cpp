@@ -53,8 +53,8 @@ UDPPipe::UDPPipe() : BufferPipe() {
 }
 
 UDPPipe::UDPPipe(ManuvrUDP* udp, uint32_t ip, uint16_t port) : BufferPipe() {
-  // The near-side will always be feeding us from buffers on the stack. Since
-  //   the buffer will vanish after return, we must copy it.
+  // The near-side will always be feeding us from batch buffers that it will
+  //   reuse after return, so we must copy it.
   _ip    = ip;
   _port  = port;
   _udp   = udp;
@@ -130,7 +130,7 @@ int8_t UDPPipe::fromCounterparty(StringBuilder* buf, int8_t mm) {
           caller will expect _us_ to manage this memory.  */
       if (haveFar()) {
         /* We are not the transport driver, and we do no transformation. */
-        return _far->fromCounterparty(buf, mm);
+        return far()->fromCounterparty(buf, mm);
       }
       else {
         _accumulator.concatHandoff(buf);
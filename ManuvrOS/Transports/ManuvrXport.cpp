@@ -120,6 +120,10 @@ ManuvrXport::ManuvrXport(const char* nom) : EventReceiver(nom), BufferPipe() {
 
   // Transports are all terminal.
   _bp_set_flag(BPIPE_FLAG_IS_TERMINUS, true);
+
+  #if defined(__BUILD_HAS_PTHREADS)
+    pthread_mutex_init(&_outq_mutex, nullptr);
+  #endif
 }
 
 /**
@@ -135,6 +139,12 @@ ManuvrXport::~ManuvrXport() {
     _autoconnect_schedule = nullptr;
     delete _autoconnect_schedule;
   }
+
+  _out_discard();
+  if (nullptr != _outq) free(_outq);
+  #if defined(__BUILD_HAS_PTHREADS)
+    pthread_mutex_destroy(&_outq_mutex);
+  #endif
 }
 
 
@@ -208,6 +218,7 @@ int8_t ManuvrXport::toCounterparty(ManuvrPipeSignal _sig, void* _args) {
 
 int8_t ManuvrXport::disconnect() {
   connected(false);
+  _out_discard();   // Nowhere for it to go.
   return 0;
 }
 
@@ -291,7 +302,7 @@ void ManuvrXport::connected(bool en) {
     if (_autoconnect_schedule) _autoconnect_schedule->enableSchedule(true);
   }
   #if defined (__BUILD_HAS_FREERTOS) || defined (__MANUVR_LINUX)
-    if (0 == _thread_id) {
+    if ((0 == _thread_id) && !eventDriven()) {
       // If we are in a threaded environment, we will want a thread if there isn't one already.
       if (createThread(&_thread_id, nullptr, xport_read_handler, (void*) this, nullptr)) {
         Kernel::log("Failed to create transport read thread.\n");
@@ -318,6 +329,325 @@ void ManuvrXport::listening(bool en) {
 }
 
 
+/*******************************************************************************
+* Outbound queue                                                               *
+* See the notes in the header. The lock is never held while calling out of     *
+*   this class, except into _out_write().                                      *
+*******************************************************************************/
+
+#if defined(__BUILD_HAS_PTHREADS)
+  #define OUTQ_LOCK()     pthread_mutex_lock(&_outq_mutex)
+  #define OUTQ_UNLOCK()   pthread_mutex_unlock(&_outq_mutex)
+#else
+  #define OUTQ_LOCK()
+  #define OUTQ_UNLOCK()
+#endif
+
+/**
+* Writes the buffer, or as much of it as the driver will take, and queues the
+*   rest. Small writes are only queued, to be written along with whatever
+*   follows them.
+* The buffer is copied if it is queued, so it remains the caller's.
+*
+* @param  buf  The bytes to send.
+* @param  len  How many.
+* @return 0 if the bytes were taken, -1 if not.
+*/
+int8_t ManuvrXport::_out_queue(uint8_t* buf, unsigned int len) {
+  if (0 == len) return 0;
+  int8_t ret  = 0;
+  bool   want = false;
+  OUTQ_LOCK();
+  if ((_outq_bytes + len) > (_outq_limit * XPORT_OUTQ_REFUSE_FACTOR)) {
+    ret = -1;
+  }
+  else {
+    if ((0 == _outq_count) && (len >= XPORT_OUTQ_COALESCE)) {
+      // Nothing ahead of us, and not worth holding. Try to write it now.
+      XportIOV iov;
+      iov.iov_base = buf;
+      iov.iov_len  = len;
+      const int n = _out_write(&iov, 1);
+      _outq_writes++;
+      if (n < 0) {
+        ret = -1;
+      }
+      else {
+        bytes_sent += n;
+        buf += n;
+        len -= n;
+        if (0 < len) _outq_stalls++;
+      }
+    }
+    if ((0 == ret) && (0 < len)) {
+      ret  = _outq_copy(buf, len);
+      want = (0 == ret) && !_outq_wanted;
+      if (want) _outq_wanted = true;
+    }
+  }
+  const int8_t change = _outq_assess();
+  OUTQ_UNLOCK();
+  _outq_signal(change);
+  if (want && !_out_wanted()) {
+    OUTQ_LOCK();
+    _outq_wanted = false;   // Nothing will call us back. Flush now.
+    OUTQ_UNLOCK();
+    _out_flush();
+  }
+  return ret;
+}
+
+
+/**
+* As above, for a slice. Large segments are queued by reference rather than
+*   copied. The slice remains the caller's.
+*
+* @param  slice  The bytes to send.
+* @return 0 if the bytes were taken, -1 if not.
+*/
+int8_t ManuvrXport::_out_queue(BufferSlice* slice) {
+  const unsigned int total = slice->length();
+  if (0 == total) return 0;
+  int8_t ret  = 0;
+  bool   want = false;
+  unsigned int skip = 0;   // Bytes already written.
+  OUTQ_LOCK();
+  if ((_outq_bytes + total) > (_outq_limit * XPORT_OUTQ_REFUSE_FACTOR)) {
+    ret = -1;
+  }
+  else {
+    if ((0 == _outq_count) && (total >= XPORT_OUTQ_COALESCE)) {
+      XportIOV iov[XPORT_OUTQ_MAX_VECTOR];
+      int cnt = 0;
+      for (; (cnt < slice->segments()) && (cnt < XPORT_OUTQ_MAX_VECTOR); cnt++) {
+        unsigned int l = 0;
+        iov[cnt].iov_base = slice->segment(cnt, &l);
+        iov[cnt].iov_len  = l;
+      }
+      const int n = _out_write(iov, cnt);
+      _outq_writes++;
+      if (n < 0) {
+        ret = -1;
+      }
+      else {
+        bytes_sent += n;
+        skip = n;
+        if (skip < total) _outq_stalls++;
+      }
+    }
+    for (int i = 0; (0 == ret) && (i < slice->segments()); i++) {
+      const SliceSegment* seg = slice->segmentAt(i);
+      if (skip >= seg->len) {
+        skip -= seg->len;
+        continue;
+      }
+      const unsigned int off = seg->offset + skip;
+      const unsigned int l   = seg->len - skip;
+      skip = 0;
+      if (l < XPORT_OUTQ_COALESCE) {
+        ret = _outq_copy(seg->backing->buffer() + off, l);
+      }
+      else {
+        ret = _outq_push(seg->backing, off, l);
+      }
+      if ((0 == ret) && !_outq_wanted) {
+        _outq_wanted = true;
+        want = true;
+      }
+    }
+  }
+  const int8_t change = _outq_assess();
+  OUTQ_UNLOCK();
+  _outq_signal(change);
+  if (want && !_out_wanted()) {
+    OUTQ_LOCK();
+    _outq_wanted = false;
+    OUTQ_UNLOCK();
+    _out_flush();
+  }
+  return ret;
+}
+
+
+/**
+* Writes as much of the queue as the driver will take, in as few calls as
+*   possible.
+*
+* @return the number of bytes still queued, or -1 if the driver failed.
+*/
+int ManuvrXport::_out_flush() {
+  int  ret  = 0;
+  bool idle = false;
+  OUTQ_LOCK();
+  while (0 < _outq_count) {
+    XportIOV iov[XPORT_OUTQ_MAX_VECTOR];
+    unsigned int offered = 0;
+    int cnt = 0;
+    for (; (cnt < XPORT_OUTQ_MAX_VECTOR) && (cnt < (int) _outq_count); cnt++) {
+      SliceSegment* seg = &_outq[(_outq_head + cnt) % _outq_cap];
+      iov[cnt].iov_base = seg->backing->buffer() + seg->offset;
+      iov[cnt].iov_len  = seg->len;
+      offered += seg->len;
+    }
+    const int n = _out_write(iov, cnt);
+    _outq_writes++;
+    if (n < 0) {
+      ret = -1;
+      break;
+    }
+    bytes_sent  += n;
+    _outq_bytes -= n;
+    unsigned int taken = n;
+    while (0 < taken) {   // Retire what was written.
+      SliceSegment* seg = &_outq[_outq_head];
+      if (taken < seg->len) {
+        seg->offset += taken;
+        seg->len    -= taken;
+        break;
+      }
+      taken -= seg->len;
+      seg->backing->release();
+      _outq_head = (_outq_head + 1) % _outq_cap;
+      _outq_count--;
+    }
+    if ((unsigned int) n < offered) {
+      _outq_stalls++;   // The driver is full. Try again when it says so.
+      break;
+    }
+  }
+  if (0 == ret) ret = (int) _outq_bytes;
+  if ((0 == _outq_count) && _outq_wanted) {
+    _outq_wanted = false;
+    idle = true;
+  }
+  const int8_t change = _outq_assess();
+  OUTQ_UNLOCK();
+  _outq_signal(change);
+  if (idle) _out_idle();
+  return ret;
+}
+
+
+/**
+* Drops anything queued, without writing it.
+*/
+void ManuvrXport::_out_discard() {
+  OUTQ_LOCK();
+  while (0 < _outq_count) {
+    _outq[_outq_head].backing->release();
+    _outq_head = (_outq_head + 1) % _outq_cap;
+    _outq_count--;
+  }
+  _outq_head   = 0;
+  _outq_bytes  = 0;
+  _outq_wanted = false;
+  if (nullptr != _outq_chunk) {
+    _outq_chunk->release();
+    _outq_chunk = nullptr;
+  }
+  const int8_t change = _outq_assess();
+  OUTQ_UNLOCK();
+  _outq_signal(change);
+}
+
+
+/*
+* Appends a segment to the ring, taking a reference to its backing.
+* Caller must hold the lock.
+*/
+int8_t ManuvrXport::_outq_push(SharedBuffer* backing, unsigned int offset, unsigned int len) {
+  if (_outq_count == _outq_cap) {
+    const unsigned int nu_cap = (0 == _outq_cap) ? 16 : (_outq_cap << 1);
+    SliceSegment* nu_q = (SliceSegment*) malloc(sizeof(SliceSegment) * nu_cap);
+    if (nullptr == nu_q) return -1;
+    for (unsigned int i = 0; i < _outq_count; i++) {   // Straighten out the ring.
+      nu_q[i] = _outq[(_outq_head + i) % _outq_cap];
+    }
+    if (nullptr != _outq) free(_outq);
+    _outq      = nu_q;
+    _outq_cap  = nu_cap;
+    _outq_head = 0;
+  }
+  backing->take();
+  SliceSegment* seg = &_outq[(_outq_head + _outq_count) % _outq_cap];
+  seg->backing = backing;
+  seg->offset  = offset;
+  seg->len     = len;
+  _outq_count++;
+  _outq_bytes += len;
+  return 0;
+}
+
+
+/*
+* Copies bytes onto the end of the queue. If the last segment is the tail of
+*   our chunk, it just gets longer.
+* Caller must hold the lock.
+*/
+int8_t ManuvrXport::_outq_copy(uint8_t* buf, unsigned int len) {
+  while (0 < len) {
+    if ((0 < _outq_count) && (nullptr != _outq_chunk) && (_outq_fill < _outq_chunk->capacity())) {
+      SliceSegment* tail = &_outq[(_outq_head + _outq_count - 1) % _outq_cap];
+      if ((tail->backing == _outq_chunk) && ((tail->offset + tail->len) == _outq_fill)) {
+        const unsigned int n = strict_min((uint32_t) len, (uint32_t) (_outq_chunk->capacity() - _outq_fill));
+        memcpy(_outq_chunk->buffer() + _outq_fill, buf, n);
+        tail->len   += n;
+        _outq_fill  += n;
+        _outq_bytes += n;
+        buf += n;
+        len -= n;
+        continue;
+      }
+    }
+    if ((nullptr != _outq_chunk) && (1 == _outq_chunk->refs())) {
+      _outq_fill = 0;   // Nothing queued refers to it any longer.
+    }
+    if ((nullptr == _outq_chunk) || (_outq_fill >= _outq_chunk->capacity())) {
+      if (nullptr != _outq_chunk) _outq_chunk->release();
+      _outq_chunk = SharedBuffer::alloc(strict_max((uint32_t) len, (uint32_t) XPORT_OUTQ_CHUNK));
+      _outq_fill  = 0;
+      if (nullptr == _outq_chunk) return -1;
+    }
+    const unsigned int n = strict_min((uint32_t) len, (uint32_t) (_outq_chunk->capacity() - _outq_fill));
+    memcpy(_outq_chunk->buffer() + _outq_fill, buf, n);
+    if (0 != _outq_push(_outq_chunk, _outq_fill, n)) return -1;
+    _outq_fill += n;
+    buf += n;
+    len -= n;
+  }
+  return 0;
+}
+
+
+/*
+* Updates the congestion flag.
+* Caller must hold the lock.
+*
+* @return 1 if we just became congested, -1 if we just drained, 0 otherwise.
+*/
+int8_t ManuvrXport::_outq_assess() {
+  if (!congested() && (_outq_bytes > _outq_limit)) {
+    set_xport_state(MANUVR_XPORT_FLAG_CONGESTED);
+    return 1;
+  }
+  if (congested() && (_outq_bytes <= (_outq_limit >> 1))) {
+    unset_xport_state(MANUVR_XPORT_FLAG_CONGESTED);
+    return -1;
+  }
+  return 0;
+}
+
+
+/*
+* Tells the far side about a change in congestion.
+*/
+void ManuvrXport::_outq_signal(int8_t change) {
+  if ((0 != change) && (nullptr != far())) {
+    far()->fromCounterparty(((0 < change) ? ManuvrPipeSignal::XPORT_CONGESTED : ManuvrPipeSignal::XPORT_DRAINED), (void*) this);
+  }
+}
+
+
 
 /*******************************************************************************
 * ######## ##     ## ######## ##    ## ########  ######
@@ -347,6 +677,10 @@ void ManuvrXport::printDebug(StringBuilder *temp) {
   temp->concatf("-- connected:      %s\n", (connected() ? "yes" : "no"));
   temp->concatf("-- listening:      %s\n", (listening() ? "yes" : "no"));
   temp->concatf("-- autoconnect:    %s\n", (autoConnect() ? "yes" : "no"));
+  if (0 < _outq_writes) {
+    temp->concatf("-- outbound:       %u bytes in %u segments%s\n", _outq_bytes, _outq_count, (congested() ? " (congested)" : ""));
+    temp->concatf("-- writes:         %u (%u stalled)\n", _outq_writes, _outq_stalls);
+  }
 }
 
 
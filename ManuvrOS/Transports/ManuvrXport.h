@@ -31,6 +31,16 @@ This driver is designed to give Manuvr platform-abstracted transports.
 
 #include <Platform/Platform.h>
 
+#if defined(__MANUVR_LINUX)
+  #include <sys/uio.h>
+  typedef struct iovec XportIOV;
+#else
+  typedef struct {
+    void*  iov_base;
+    size_t iov_len;
+  } XportIOV;
+#endif
+
 
 /*
 * Notes about how transport flags are organized:
@@ -46,8 +56,8 @@ This driver is designed to give Manuvr platform-abstracted transports.
 #define MANUVR_XPORT_FLAG_STREAM_ORIENTED  0x10000000  // See note below.
 #define MANUVR_XPORT_FLAG_LISTENING        0x08000000  // We are listening for connections.
 #define MANUVR_XPORT_FLAG_RESERVED_1       0x04000000  //
-#define MANUVR_XPORT_FLAG_RESERVED_2       0x02000000  //
-#define MANUVR_XPORT_FLAG_RESERVED_0       0x01000000  //
+#define MANUVR_XPORT_FLAG_CONGESTED        0x02000000  // The outbound queue is past its limit.
+#define MANUVR_XPORT_FLAG_EVENT_DRIVEN     0x01000000  // Reads are driven by readiness, rather than a thread.
 #define MANUVR_XPORT_FLAG_ALWAYS_CONNECTED 0x00800000  // Serial ports.
 #define MANUVR_XPORT_FLAG_CONNECTIONLESS   0x00400000  // This transport is "connectionless". See Note0 below.
 #define MANUVR_XPORT_FLAG_HAS_MULTICAST    0x00200000  // This transport supports multicast.
@@ -79,6 +89,23 @@ This driver is designed to give Manuvr platform-abstracted transports.
 
 #define XPORT_DEFAULT_AUTOCONNECT_PERIOD 15000  // In ms. Unless otherwise specified...
 
+/*
+* Notes about the outbound queue:
+* Transports that can't always take a write in full put what is left into a
+*   queue of slice segments, which is written out later with as few vectored
+*   writes as possible. Small writes are copied together into shared chunks,
+*   and (if the transport can be told when it is writable) are held until then,
+*   so a burst of messages reaches the kernel in one call.
+* When the queue grows past its limit, the far side is sent XPORT_CONGESTED. It
+*   gets XPORT_DRAINED once the queue is down to half the limit. Writes that
+*   would take the queue past XPORT_OUTQ_REFUSE_FACTOR times the limit fail.
+*/
+#define XPORT_OUTQ_DEFAULT_LIMIT   65536   // Bytes queued before we push back.
+#define XPORT_OUTQ_REFUSE_FACTOR   4       // ...and how many times that before we refuse.
+#define XPORT_OUTQ_COALESCE        512     // Writes smaller than this are copied together.
+#define XPORT_OUTQ_CHUNK           4096    // Size of the chunks that small writes are copied into.
+#define XPORT_OUTQ_MAX_VECTOR      32      // Segments per vectored write.
+
 class ManuvrXport : public EventReceiver, public BufferPipe {
   public:
     virtual ~ManuvrXport();
@@ -115,6 +142,18 @@ class ManuvrXport : public EventReceiver, public BufferPipe {
     inline void autoConnect(bool en) {   autoConnect(en, XPORT_DEFAULT_AUTOCONNECT_PERIOD);  };
     void autoConnect(bool en, uint32_t _ac_period);
 
+    /* Does something other than a thread of our own call read_port()? */
+    inline bool eventDriven() {   return (_xport_flags & MANUVR_XPORT_FLAG_EVENT_DRIVEN);  };
+
+    /* The outbound queue. */
+    inline bool     congested() {         return (_xport_flags & MANUVR_XPORT_FLAG_CONGESTED);  };
+    inline unsigned int outboundDepth() { return _outq_count;    };   // Segments waiting.
+    inline uint32_t outboundBytes() {     return _outq_bytes;    };   // Bytes waiting.
+    inline uint32_t outboundWrites() {    return _outq_writes;   };   // Writes made to the driver.
+    inline uint32_t outboundStalls() {    return _outq_stalls;   };   // Writes the driver couldn't finish.
+    inline uint32_t outboundLimit() {     return _outq_limit;    };
+    inline void     outboundLimit(uint32_t x) {   _outq_limit = x;   };
+
     /* Members that deal with sessions. */
     inline bool streamOriented() {          return (_xport_flags & MANUVR_XPORT_FLAG_STREAM_ORIENTED);  };
 
@@ -151,6 +190,26 @@ class ManuvrXport : public EventReceiver, public BufferPipe {
     inline void set_xport_state(uint32_t bitmask) {    _xport_flags = (bitmask  | _xport_flags);   }
     inline void unset_xport_state(uint32_t bitmask) {  _xport_flags = (~bitmask & _xport_flags);   }
 
+    /* Outbound queue. Safe to call from any thread. */
+    int8_t _out_queue(uint8_t* buf, unsigned int len);   // 0 if taken.
+    int8_t _out_queue(BufferSlice*);                     // 0 if taken.
+    int    _out_flush();       // Returns the bytes still waiting, or -1 on failure.
+    void   _out_discard();
+
+    /*
+    * Transports that use the queue override these.
+    * _out_write() must not block. It returns the bytes taken (which may be
+    *   zero), or -1 on failure.
+    * _out_wanted() is called when the queue goes from idle to waiting.
+    *   Transports that are told when they are writable should arrange for
+    *   _out_flush() to be called then, and return true. Otherwise, the queue
+    *   is flushed immediately.
+    * _out_idle() is called when a flush leaves the queue empty.
+    */
+    virtual int  _out_write(XportIOV*, int count) {   return -1;      };
+    virtual bool _out_wanted() {                      return false;   };
+    virtual void _out_idle() {};
+
     /*
     * State imperatives.
     * TODO: This is fragile, and has been a PITA to maintain. Migrate some of this to Pipe
@@ -165,6 +224,26 @@ class ManuvrXport : public EventReceiver, public BufferPipe {
   private:
     uint32_t _xport_flags = 0;
 
+    SliceSegment* _outq       = nullptr;   // A ring of segments, oldest at _outq_head.
+    SharedBuffer* _outq_chunk = nullptr;   // The chunk small writes are copied into.
+    unsigned int  _outq_fill  = 0;         // How much of the chunk is used.
+    unsigned int  _outq_cap   = 0;
+    unsigned int  _outq_head  = 0;
+    unsigned int  _outq_count = 0;
+    uint32_t      _outq_bytes  = 0;
+    uint32_t      _outq_limit  = XPORT_OUTQ_DEFAULT_LIMIT;
+    uint32_t      _outq_writes = 0;
+    uint32_t      _outq_stalls = 0;
+    bool          _outq_wanted = false;    // _out_wanted() has been called, and not yet answered.
+    #if defined(__BUILD_HAS_PTHREADS)
+      pthread_mutex_t _outq_mutex;
+    #endif
+
+    int8_t _outq_push(SharedBuffer*, unsigned int offset, unsigned int len);
+    int8_t _outq_copy(uint8_t* buf, unsigned int len);
+    int8_t _outq_assess();
+    void   _outq_signal(int8_t change);
+
     /* Connection/Listen states */
     inline void mark_connected(bool en) {
       _xport_flags = (en) ? (_xport_flags | MANUVR_XPORT_FLAG_CONNECTED) : (_xport_flags & ~(MANUVR_XPORT_FLAG_CONNECTED));
@@ -23,5 +23,7 @@
 #include "listener.h"
 #include "output_static.h"
 #include "output_dynamic.h"
+#include "output_buffer.h"
+#include "reader.h"
 
 #endif //CBOR_CPP_CBOR_H
@@ -0,0 +1,68 @@
+/*
+File:   output_buffer.cpp
+Author: J. Ian Lindsay
+Date:   2026.10.18
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include "output_buffer.h"
+
+#include <string.h>
+
+using namespace cbor;
+
+
+output_buffer::output_buffer(unsigned char* buf, unsigned int capacity) {
+  reset(buf, capacity);
+}
+
+output_buffer::~output_buffer() {}
+
+
+/**
+* Points the output at new memory, and forgets anything already written.
+*
+* @param  buf       The memory to write into. May be nullptr, to only count.
+* @param  capacity  How many bytes are at buf.
+*/
+void output_buffer::reset(unsigned char* buf, unsigned int capacity) {
+  _buffer   = buf;
+  _capacity = (nullptr == buf) ? 0 : capacity;
+  _offset   = 0;
+}
+
+unsigned char* output_buffer::data() {
+  return _buffer;
+}
+
+unsigned int output_buffer::size() {
+  return _offset;
+}
+
+void output_buffer::put_byte(unsigned char value) {
+  if (_offset < _capacity) {
+    _buffer[_offset] = value;
+  }
+  _offset++;
+}
+
+void output_buffer::put_bytes(const unsigned char* data, int size) {
+  if ((_offset + size) <= _capacity) {
+    memcpy(_buffer + _offset, data, size);
+  }
+  _offset += size;
+}
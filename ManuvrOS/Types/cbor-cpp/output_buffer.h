@@ -0,0 +1,56 @@
+/*
+File:   output_buffer.h
+Author: J. Ian Lindsay
+Date:   2026.10.18
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+A CBOR output that writes into memory owned by the caller, and never
+  allocates. If the memory runs out, writing stops, but counting does not.
+  So after an overflow, size() is the exact length that would have fit, and
+  the caller can try again with that much. Given no memory at all, this is
+  simply a sizing pass.
+*/
+
+#ifndef __CborBufferOutput_H_
+#define __CborBufferOutput_H_
+
+#include "output.h"
+
+namespace cbor {
+  class output_buffer : public output {
+    public:
+      output_buffer(unsigned char* buf, unsigned int capacity);
+      ~output_buffer();
+
+      virtual unsigned char* data();
+      virtual unsigned int   size();
+
+      virtual void put_byte(unsigned char value);
+      virtual void put_bytes(const unsigned char* data, int size);
+
+      void reset(unsigned char* buf, unsigned int capacity);
+      inline bool overflowed() {   return (_offset > _capacity);   };
+
+
+    private:
+      unsigned char* _buffer;
+      unsigned int   _capacity;
+      unsigned int   _offset;     // Keeps counting past _capacity.
+  };
+}
+
+#endif //__CborBufferOutput_H_
@@ -0,0 +1,132 @@
+/*
+File:   reader.cpp
+Author: J. Ian Lindsay
+Date:   2026.10.18
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include "reader.h"
+
+#include <string.h>
+#include <math.h>
+
+using namespace cbor;
+
+
+reader::reader(const unsigned char* buf, unsigned int len) {
+  _buf    = buf;
+  _len    = (nullptr == buf) ? 0 : len;
+  _offset = 0;
+  _failed = false;
+}
+
+reader::~reader() {}
+
+
+/**
+* Reads the next item. Containers (arrays and maps) and tags are returned as
+*   items in their own right, with their count or tag in value. Their contents
+*   follow as subsequent items.
+*
+* @param  out  The item to fill.
+* @return true if an item was read. False at the end of input, or on error.
+*/
+bool reader::next(item* out) {
+  if (_failed || (_offset >= _len)) return false;
+  const unsigned char header = _buf[_offset];
+  const uint8_t minor = header & 0x1F;
+  uint8_t width = 0;
+  out->major = header >> 5;
+  out->data  = nullptr;
+
+  switch (minor) {
+    case 24:  width = 1;  break;
+    case 25:  width = 2;  break;
+    case 26:  width = 4;  break;
+    case 27:  width = 8;  break;
+    default:
+      if (minor > 27) {
+        _failed = true;   // Reserved, or indefinite length.
+        return false;
+      }
+      break;
+  }
+  if ((_offset + 1 + width) > _len) {
+    _failed = true;       // Truncated.
+    return false;
+  }
+
+  uint64_t value = (0 == width) ? minor : 0;
+  for (uint8_t i = 1; i <= width; i++) {
+    value = (value << 8) | _buf[_offset + i];
+  }
+  _offset += 1 + width;
+
+  if ((CBOR_BYTES == out->major) || (CBOR_STRING == out->major)) {
+    if (value > (uint64_t) (_len - _offset)) {
+      _failed = true;     // Claims more than we have.
+      return false;
+    }
+    out->data = _buf + _offset;
+    _offset  += (unsigned int) value;
+  }
+  out->width = width;
+  out->value = value;
+  return true;
+}
+
+
+/**
+* @return the value of a 16-bit float item, widened to a float.
+*/
+float reader::asHalf(const item* it) {
+  const uint16_t half = (uint16_t) it->value;
+  const int      exp  = (half >> 10) & 0x1F;
+  const int      mant = half & 0x03FF;
+  float ret;
+  if (0 == exp) {
+    ret = ldexpf((float) mant, -24);            // Zero, or subnormal.
+  }
+  else if (31 != exp) {
+    ret = ldexpf((float) (mant + 1024), exp - 25);
+  }
+  else {
+    ret = (0 == mant) ? INFINITY : NAN;
+  }
+  return (half & 0x8000) ? -ret : ret;
+}
+
+
+/**
+* @return the value of a 32-bit float item.
+*/
+float reader::asFloat(const item* it) {
+  uint32_t bits = (uint32_t) it->value;
+  float ret;
+  memcpy(&ret, &bits, sizeof(float));
+  return ret;
+}
+
+
+/**
+* @return the value of a 64-bit float item.
+*/
+double reader::asDouble(const item* it) {
+  double ret;
+  memcpy(&ret, &it->value, sizeof(double));
+  return ret;
+}
@@ -0,0 +1,88 @@
+/*
+File:   reader.h
+Author: J. Ian Lindsay
+Date:   2026.10.18
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+A pull-style CBOR decoder.
+
+Where decoder pushes each item at a listener (copying strings and byte
+  strings on the way), the reader hands items back one at a time, and never
+  allocates. Strings and byte strings are returned as pointers into the
+  source buffer, which must outlive them. Strings are not null-terminated.
+
+Indefinite-length items are not supported, and are reported as errors.
+*/
+
+#ifndef __CborReader_H_
+#define __CborReader_H_
+
+#include <stdint.h>
+
+namespace cbor {
+  /* Major types. */
+  enum {
+    CBOR_UINT    = 0,
+    CBOR_NINT    = 1,
+    CBOR_BYTES   = 2,
+    CBOR_STRING  = 3,
+    CBOR_ARRAY   = 4,
+    CBOR_MAP     = 5,
+    CBOR_TAG     = 6,
+    CBOR_SPECIAL = 7
+  };
+
+  /* Simple values of the special type. */
+  enum {
+    CBOR_FALSE     = 20,
+    CBOR_TRUE      = 21,
+    CBOR_NULL      = 22,
+    CBOR_UNDEFINED = 23
+  };
+
+  typedef struct {
+    uint8_t              major;  // One of the above.
+    uint8_t              width;  // How many bytes held the value. Zero if it was in the header.
+    uint64_t             value;  // Integer, length, count, tag, special, or raw float bits.
+    const unsigned char* data;   // For bytes and strings. Points into the source.
+  } item;
+
+
+  class reader {
+    public:
+      reader(const unsigned char* buf, unsigned int len);
+      ~reader();
+
+      bool next(item*);    // Returns false at the end of input, or on error.
+
+      inline bool         failed() {     return _failed;   };
+      inline unsigned int consumed() {   return _offset;   };
+
+      static float  asHalf(const item*);
+      static float  asFloat(const item*);
+      static double asDouble(const item*);
+
+
+    private:
+      const unsigned char* _buf;
+      unsigned int         _len;
+      unsigned int         _offset;
+      bool                 _failed;
+  };
+}
+
+#endif //__CborReader_H_
@@ -37,15 +37,21 @@ limitations under the License.
 * Static members and initializers should be located here.
 *******************************************************************************/
 
-/* A list of regsitered console interactables. */
-static PriorityQueue<ConsoleInterface*> _consoles;
+/*
+* A list of regsitered console interactables. Constructed on first use, since
+*   the Kernel registers itself from a static constructor of its own.
+*/
+static PriorityQueue<ConsoleInterface*>& _console_list() {
+  static PriorityQueue<ConsoleInterface*> _consoles;
+  return _consoles;
+}
 
 /**
 * @param  client  The class that will be listening for Events.
 * @return 0 on success and -1 on failure.
 */
 void ConsoleInterface::consoleSchemaAdd(ConsoleInterface* obj) {
-  if (nullptr != obj) _consoles.insert(obj);
+  if (nullptr != obj) _console_list().insert(obj);
 }
 
 /**
@@ -55,12 +61,12 @@ void ConsoleInterface::consoleSchemaAdd(ConsoleInterface* obj) {
 * @return 0 on success and -1 on failure.
 */
 void ConsoleInterface::consoleSchemaDrop(ConsoleInterface* obj) {
-  if (nullptr != obj) _consoles.remove(obj);
+  if (nullptr != obj) _console_list().remove(obj);
 }
 
 
 void runConsoleFunction(uint c, StringBuilder* out) {
-  ConsoleInterface* working = _consoles.get(c);
+  ConsoleInterface* working = _console_list().get(c);
   if (nullptr != working) {
     ConsoleCommand* cmd;
     uint j = working->consoleGetCmds(&cmd);
@@ -73,12 +79,11 @@ void runConsoleFunction(uint c, StringBuilder* out) {
 
 void printConsoleTree(StringBuilder* out) {
   out->concat("Console tree:\n");
-  ConsoleInterface* working;
-  for (int i = 0; i < _consoles.size(); i++) {
-    working = _consoles.get(i);
+  int i = 0;
+  for (ConsoleInterface* working : _console_list()) {
     ConsoleCommand* cmd;
     uint j = working->consoleGetCmds(&cmd);
-    out->concatf("%d: %s\n", i, working->consoleName());
+    out->concatf("%d: %s\n", i++, working->consoleName());
     while (j-- > 0) {
       out->concatf("  %10s: %s\n", cmd->shortcut, cmd->help_text);
       cmd++;
@@ -104,6 +109,7 @@ void printConsoleTree(StringBuilder* out) {
 ManuvrConsole::ManuvrConsole(BufferPipe* _near_side) : EventReceiver("Console"), BufferPipe() {
   _bp_set_flag(BPIPE_FLAG_IS_TERMINUS, true);
   _bp_set_flag(BPIPE_FLAG_IS_BUFFERED, true);
+  _log_accumulator.coalesce(true);   // Every log line in the system passes through here.
 
   // The link nearer to the transport should not free.
   if (_near_side) {
@@ -147,7 +153,7 @@ int8_t ManuvrConsole::_route_console_input(StringBuilder* last_user_input) {
       if ((0 != cif_idx) || ('0' == *str)) {
         // If the first position is a number, we drop the first position, since
         //   it was essentially a directive aimed at this class.
-        working = _consoles.get(cif_idx);
+        working = _console_list().get(cif_idx);
         if (nullptr == working) {
           _raw_from_console.clear();
           local_log.concatf("No such console: %d.\n", cif_idx);
@@ -464,7 +470,7 @@ int8_t ManuvrConsole::notify(ManuvrMsg* active_runnable) {
 
 
 void ManuvrConsole::change_active_console_interface(int cif_id) {
-  ConsoleInterface* working = _consoles.get(cif_id);
+  ConsoleInterface* working = _console_list().get(cif_id);
   if (working) {
     _current_console = working;
   }
@@ -472,9 +478,7 @@ void ManuvrConsole::change_active_console_interface(int cif_id) {
 
 void ManuvrConsole::change_active_console_interface(const char* cif_str) {
   if (nullptr != cif_str) {
-    ConsoleInterface* working;
-    for (int i = 0; i < _consoles.size(); i++) {
-      working = _consoles.get(i);
+    for (ConsoleInterface* working : _console_list()) {
       if (0 == StringBuilder::strcasestr((char*) cif_str, working->consoleName())) {
         _current_console = working;
         return;
@@ -114,6 +114,23 @@ int8_t MQTTSession::fromCounterparty(StringBuilder* buf, int8_t mm) {
   return MEM_MGMT_RESPONSIBLE_BEARER;
 }
 
+/**
+* Outward toward the application (or into the accumulator).
+* The parser accumulates across calls, so we feed it each segment in place.
+*
+* @param  buf    A pointer to the slice. Remains the caller's.
+* @param  mm     A declaration of memory-management responsibility.
+* @return A declaration of memory-management responsibility.
+*/
+int8_t MQTTSession::fromCounterparty(BufferSlice* buf, int8_t mm) {
+  unsigned int len = 0;
+  for (int i = 0; i < buf->segments(); i++) {
+    uint8_t* seg = buf->segment(i, &len);
+    bin_stream_rx(seg, (int) len);
+  }
+  return MEM_MGMT_RESPONSIBLE_BEARER;
+}
+
 
 
 /****************************************************************************************************
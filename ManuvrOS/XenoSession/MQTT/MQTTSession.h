@@ -99,6 +99,7 @@ class MQTTSession : public XenoSession {
 
     /* Override from BufferPipe. */
     virtual int8_t fromCounterparty(StringBuilder* buf, int8_t mm);
+    virtual int8_t fromCounterparty(BufferSlice* buf, int8_t mm);
 
     int8_t connection_callback(bool connected);
 
@@ -23,6 +23,7 @@ limitations under the License.
 #include "ManuvrSession.h"
 
 #if defined(MANUVR_OVER_THE_WIRE)
+#include <string.h>
 
 /*******************************************************************************
 *   ___ _              ___      _ _              _      _
@@ -39,8 +40,11 @@ limitations under the License.
 */
 ManuvrSession::ManuvrSession(BufferPipe* _near_side) : XenoSession("ManuvrSession", _near_side) {
   _bp_set_flag(BPIPE_FLAG_IS_BUFFERED, true);
+  working             = nullptr;
   _seq_parse_failures = MANUVR_MAX_PARSE_FAILURES;
   _seq_ack_failures   = MANUVR_MAX_ACK_FAILURES;
+  _stacked_sync_state = XENOSESSION_STATE_SYNC_SYNCD;
+  _sync_state         = XENOSESSION_STATE_SYNC_SYNCD;
 
   // These are messages that we want to relay from the rest of the system.
   tapMessageType(MANUVR_MSG_SESS_ESTABLISHED);
@@ -55,6 +59,10 @@ ManuvrSession::ManuvrSession(BufferPipe* _near_side) : XenoSession("ManuvrSessio
 ManuvrSession::~ManuvrSession() {
   sync_event.enableSchedule(false);
   platform.kernel()->removeSchedule(&sync_event);
+  if (nullptr != working) {
+    delete working;
+    working = nullptr;
+  }
 }
 
 
@@ -104,45 +112,112 @@ int8_t ManuvrSession::sendSyncPacket() {
 
 
 /**
-* This fxn is destructive to the session buffer. The point is to eliminate bytes from the
-*   buffer until we have the following 4-byte sequence at offset 0. In that case, we consume
-*   all the sync data from the buffer and return non-zero.
-* If no sync packets were found in the buffer, we should return zero after having fully-consumed
-*   the buffer.
+* Feed the scanner the next piece of the stream.
+*
+* @param  buf  The bytes that follow those from the last call.
+* @param  len  How many.
+* @return the offset in buf just past the last complete sync packet, or -1 if
+*           no sync packet ended in buf.
+*/
+int ManuvrSyncScanner::feed(const uint8_t* buf, int len) {
+  const uint8_t* sync = XenoManuvrMessage::SYNC_PACKET_BYTES;
+  int return_value = -1;
+  if (len <= 0) return return_value;
+  _bytes += len;
+
+  // A packet that began in the last call. The pattern can't overlap itself, so
+  //   there can be only one.
+  for (uint8_t t = 0; t < _tail_len; t++) {
+    const int have = _tail_len - t;
+    const int need = 4 - have;
+    if ((need <= len) && (0 == memcmp(&_tail[t], sync, have)) && (0 == memcmp(buf, sync + have, need))) {
+      return_value = need;
+      _packets++;
+      break;
+    }
+  }
+
+  int i = (return_value > 0) ? return_value : 0;
+  while (i <= (len - 4)) {
+    const uint8_t* p = (const uint8_t*) memchr(buf + i, sync[0], len - 3 - i);
+    if (nullptr == p) break;
+    i = p - buf;
+    if (0 == memcmp(p, sync, 4)) {
+      i += 4;
+      return_value = i;
+      _packets++;
+    }
+    else {
+      i++;
+    }
+  }
+
+  // Keep the last few bytes that weren't part of a packet, in case the next
+  //   packet begins among them.
+  if (return_value > 0) {
+    _tail_len = 0;
+  }
+  else if (len < 3) {
+    // The window slides. Old bytes are only kept if buf is short.
+    const int keep = (_tail_len > (3 - len)) ? (3 - len) : _tail_len;
+    memmove(_tail, &_tail[_tail_len - keep], keep);
+    _tail_len = keep;
+  }
+  else {
+    _tail_len = 0;
+  }
+  int j = (return_value > (len - 3)) ? return_value : (len - 3);
+  if (j < 0) j = 0;
+  while (j < len) {
+    _tail[_tail_len++] = buf[j++];
+  }
+  return return_value;
+}
+
+
+void ManuvrSyncScanner::reset() {
+  _tail_len = 0;
+}
+
+
+/**
+* While out of sync, nothing is buffered. The scanner watches the stream for
+*   sync packets, and once it sees one, whatever follows the last of them is
+*   handed to the session buffer for parsing.
+* Whatever was in the session buffer when sync was lost is scanned once, and
+*   then dropped.
 *
-* @return  int8_t 0 if we did not find a sync packet. 1 if we did. -1 on meltdown.
+* @param  buf  The bytes that just arrived.
+* @param  len  How many.
+* @return  int8_t 0 if we did not find a sync packet. 1 if we did.
 */
-int8_t ManuvrSession::scan_buffer_for_sync() {
+int8_t ManuvrSession::scan_buffer_for_sync(unsigned char* buf, int len) {
   int8_t return_value = 0;
-  int len = session_buffer.length();
-  int last_sync_offset = 0;
-  int offset = 0;
-  uint32_t sync_value = 0x04 + (CHECKSUM_PRELOAD_BYTE << 24);
-  unsigned char *buf = session_buffer.string();
-  while (len >= offset+4) {
-    if (parseUint32Fromchars(buf + offset) == sync_value) {
-      // If we have those 4 bytes in sequence, we have found a sync packet.
+  const int held = session_buffer.length();
+  if (held > 0) {
+    const int x = _sync_scanner.feed(session_buffer.string(), held);
+    if (x > 0) {
+      session_buffer.cull(x);
       return_value = 1;
-      last_sync_offset = offset;
-      offset += 4;
-      // Notice that we continue the loop. If we found one sync packet, we will likely find more.
     }
     else {
-      offset++;
+      session_buffer.clear();
     }
   }
 
-  if (return_value) {
-    /* We found a sync! Now to cull the sync data from the session buffer. We COULD
-    *  only cull the modulus of the offset and let the parser handle the sync packets,
-    *  but that would just waste resources. We might as well eliminate all the junk now. */
-    session_buffer.cull(last_sync_offset + 4);
+  const int x = _sync_scanner.feed(buf, len);
+  if (x > 0) {
+    // Anything held from before is older than this packet.
+    session_buffer.clear();
+    if (x < len) session_buffer.concat(buf + x, len - x);
+    return_value = 1;
   }
-  else if (len > 7) {
-    /* We did not find a sync packet, but we have more in the buffer than we need to find it.
-    *  Cull all but the last 3 bytes. The next time we get data from the transport, we will
-    *  concat to the buffer and run this check again. */
-    session_buffer.cull(len - 3);
+  else if (return_value) {
+    session_buffer.concat(buf, len);
+  }
+
+  if (return_value) {
+    _sync_scanner.reset();
   }
   return return_value;
 }
@@ -174,6 +249,7 @@ void ManuvrSession::mark_session_desync(uint8_t ds_src) {
       case XENOSESSION_STATE_SYNC_INITIATED:    // CP-initiated sync
       case XENOSESSION_STATE_SYNC_INITIATOR:    // We initiated sync
       case XENOSESSION_STATE_SYNC_CASTING:      //
+        _sync_scanner.reset();
         sync_event.enableSchedule(true);
         break;
       default:
@@ -238,8 +314,6 @@ void ManuvrSession::mark_session_sync(bool pending) {
 int8_t ManuvrSession::bin_stream_rx(unsigned char *buf, int len) {
   int8_t return_value = 0;
 
-  session_buffer.concat(buf, len);
-
   uint16_t statcked_sess_state = getPhase();
 
   #ifdef MANUVR_DEBUG
@@ -255,12 +329,13 @@ int8_t ManuvrSession::bin_stream_rx(unsigned char *buf, int len) {
   switch (_sync_state) {   // Consider the top four bits of the session state.
     case XENOSESSION_STATE_SYNC_SYNCD:       // The nominal case. Session is in-sync. Do nothing.
     case XENOSESSION_STATE_SYNC_PEND_EXIT:   // We have exchanged sync packets with the counterparty.
+      session_buffer.concat(buf, len);
       break;
     case XENOSESSION_STATE_SYNC_INITIATED:   // The counterparty noticed the problem.
     case XENOSESSION_STATE_SYNC_INITIATOR:   // We noticed a problem. We wait for a sync packet...
-      /* At this point, we shouldn't be adding to the inbound queue. We should simply add
-         to the session buffer and scan it for sync packets. */
-      if (scan_buffer_for_sync()) {   // We are getting sync back now.
+      /* At this point, we shouldn't be adding to the inbound queue. We should simply
+         scan for sync packets. The session buffer is only fed once we find one. */
+      if (scan_buffer_for_sync(buf, len)) {   // We are getting sync back now.
         /* Since we are going to fall-through into the general parser case, we should reset
            the values that it will use to index and make decisions... */
         mark_session_sync(true);   // Indicate that we are done with sync, but may still see such packets.
@@ -280,6 +355,7 @@ int8_t ManuvrSession::bin_stream_rx(unsigned char *buf, int len) {
       #ifdef MANUVR_DEBUG
       if (getVerbosity() > 1) local_log.concatf("ILLEGAL _sync_state: 0x%02x (top 4)\n", _sync_state);
       #endif
+      session_buffer.concat(buf, len);
       break;
   }
 
@@ -411,6 +487,7 @@ void ManuvrSession::printDebug(StringBuilder *output) {
   output->concatf("-- _heap_frees          %u\n", (unsigned long) XenoManuvrMessage::_heap_freeds);
   output->concatf("-- seq parse failures   %d\n", MANUVR_MAX_PARSE_FAILURES - _seq_parse_failures);
   output->concatf("-- seq_ack_failures     %d\n", MANUVR_MAX_ACK_FAILURES - _seq_ack_failures);
+  output->concatf("-- Sync scanner         %u packets in %u bytes\n", _sync_scanner.packetsFound(), _sync_scanner.bytesScanned());
 
   int ses_buf_len = session_buffer.length();
   if (ses_buf_len > 0) {
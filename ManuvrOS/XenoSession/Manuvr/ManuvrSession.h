@@ -161,6 +161,31 @@ class XenoManuvrMessage : public XenoMessage {
 
 
 
+/*
+* Finds the sync stream in bytes that arrive in pieces, without buffering them.
+*   Only the last three bytes are kept between calls, in case a sync packet
+*   straddles two of them. Candidates are found with memchr() on the first
+*   byte of the packet, and checked as a whole word.
+*/
+class ManuvrSyncScanner {
+  public:
+    ManuvrSyncScanner() {};
+
+    int  feed(const uint8_t* buf, int len);   // Offset past the last sync packet in buf, or -1.
+    void reset();
+
+    inline uint32_t bytesScanned() {   return _bytes;     };
+    inline uint32_t packetsFound() {   return _packets;   };
+
+
+  private:
+    uint8_t  _tail[3];
+    uint8_t  _tail_len = 0;
+    uint32_t _bytes    = 0;
+    uint32_t _packets  = 0;
+};
+
+
 class ManuvrSession : public XenoSession
   #if defined(MANUVR_CONSOLE_SUPPORT)
     , public ConsoleInterface
@@ -178,6 +203,9 @@ class ManuvrSession : public XenoSession
     int8_t notify(ManuvrMsg*);
     int8_t callback_proc(ManuvrMsg*);
 
+    inline uint8_t syncState() {       return _sync_state;               };
+    inline int     bufferedBytes() {   return session_buffer.length();   };
+
     #if defined(MANUVR_CONSOLE_SUPPORT)
       /* Overrides from ConsoleInterface */
       uint consoleGetCmds(ConsoleCommand**);
@@ -200,6 +228,7 @@ class ManuvrSession : public XenoSession
     *   the need for the transport to care about how much data we consumed versus left in its buffer.
     */
     StringBuilder session_buffer;
+    ManuvrSyncScanner _sync_scanner;   // Used in place of session_buffer while out of sync.
 
     /* These variables track failure cases to inform sync-initiation. */
     uint8_t _seq_parse_failures;  // How many parse attempts have failed in-a-row?
@@ -214,7 +243,7 @@ class ManuvrSession : public XenoSession
 
     int8_t sendKeepAlive();
     int8_t sendSyncPacket();
-    int8_t scan_buffer_for_sync();
+    int8_t scan_buffer_for_sync(unsigned char* buf, int len);
     void   mark_session_desync(uint8_t desync_source);
     void   mark_session_sync(bool pending);
 
@@ -207,6 +207,211 @@ int test_BufferPipe_1(void) {
 
 
 
+/*
+* Exercises the reference-counting and range arithmetic of BufferSlice.
+* Returns 0 on success.
+*/
+int test_BufferSlice(StringBuilder* log) {
+  uint8_t ref[128];
+  for (int i = 0; i < 128; i++) ref[i] = (uint8_t) i;
+
+  SharedBuffer* b = SharedBuffer::alloc(64);
+  memcpy(b->buffer(), ref, 64);
+  b->take();   // An extra reference, so we can watch it after the test is done with it.
+  BufferSlice a;
+  a.append(b, 0, 32);
+  a.append(b, 32, 32);   // Picks up where the last left off. Should extend.
+  if ((1 != a.segments()) || (64 != a.length()) || (3 != b->refs())) {
+    log->concat("Adjacent ranges of a backing should merge into one segment.\n");
+    return -1;
+  }
+  b->release();          // The creator's reference.
+
+  uint8_t* heap = (uint8_t*) malloc(64);
+  memcpy(heap, ref + 64, 64);
+  a.wrap(heap, 64, true);
+  if ((2 != a.segments()) || (128 != a.length())) {
+    log->concat("wrap() failed to append.\n");
+    return -1;
+  }
+
+  BufferSlice c;
+  c.append(&a);
+  if ((3 != b->refs()) || (128 != c.length())) {
+    log->concat("Appending a slice should share its backings.\n");
+    return -1;
+  }
+
+  uint8_t out[128];
+  c.cull(40);
+  c.truncate(30);
+  a.clear();   // c should not care.
+  if ((30 != c.length()) || (2 != c.segments()) || (2 != b->refs())) {
+    log->concatf("cull()/truncate() left %u bytes in %d segments.\n", c.length(), c.segments());
+    c.printDebug(log);
+    return -1;
+  }
+  if ((30 != c.copyOut(out, 0, 128)) || (0 != memcmp(out, ref + 40, 30))) {
+    log->concat("copyOut() across segments returned the wrong bytes.\n");
+    return -1;
+  }
+
+  // Run out of segments. The slice should collapse rather than refuse.
+  for (int i = 0; i < BUFFER_SLICE_MAX_SEGMENTS + 2; i++) {
+    SharedBuffer* x = SharedBuffer::alloc(1);
+    *(x->buffer()) = (uint8_t) (70 + i);
+    if (0 != c.append(x, 0, 1)) {
+      log->concat("append() failed when out of segments.\n");
+      return -1;
+    }
+    x->release();
+  }
+  unsigned int expected = 30 + BUFFER_SLICE_MAX_SEGMENTS + 2;
+  uint8_t* flat = c.contiguous();
+  if ((nullptr == flat) || (1 != c.segments()) || (expected != c.length()) || (0 != memcmp(flat, ref + 40, expected))) {
+    log->concat("contiguous() did not preserve the contents.\n");
+    c.printDebug(log);
+    return -1;
+  }
+  if (1 != b->refs()) {
+    log->concatf("Collapsing should have released the original backing, but it has %d refs.\n", b->refs());
+    return -1;
+  }
+  b->release();
+  log->concat("BufferSlice tests pass.\n");
+  return 0;
+}
+
+
+/*
+* A three-stage pipe for measuring throughput. The source originates packets
+*   with a 4-byte header, the framer strips it, and the sink checksums what is
+*   left. Each can move data either as a StringBuilder (the old way), or as a
+*   BufferSlice.
+*/
+#define BENCH_HEADER_LEN  4
+
+class BenchSource : public BufferPipe {
+  public:
+    BenchSource() : BufferPipe() {};
+    const char* pipeName() {  return "BenchSource";  };
+
+    /* Fills the buffer as a transport's read() would. */
+    void fill(uint8_t* buf, unsigned int len, uint32_t seq) {
+      memcpy(buf, &seq, BENCH_HEADER_LEN);
+      memset(buf + BENCH_HEADER_LEN, (uint8_t) seq, len - BENCH_HEADER_LEN);
+      buf[len - 1] = (uint8_t) (seq >> 8);
+    };
+
+    void pump(bool slices, unsigned int packets, unsigned int len) {
+      if (slices) {
+        SharedBuffer* backing = nullptr;
+        for (uint32_t seq = 0; seq < packets; seq++) {
+          if ((nullptr != backing) && (1 < backing->refs())) {
+            backing->release();
+            backing = nullptr;
+          }
+          if (nullptr == backing) backing = SharedBuffer::alloc(len);
+          fill(backing->buffer(), len, seq);
+          BufferSlice slice;
+          slice.append(backing, 0, len);
+          far()->fromCounterparty(&slice, MEM_MGMT_RESPONSIBLE_BEARER);
+        }
+        if (nullptr != backing) backing->release();
+      }
+      else {
+        uint8_t buf[len];
+        for (uint32_t seq = 0; seq < packets; seq++) {
+          fill(buf, len, seq);
+          BufferPipe::fromCounterparty(buf, len, MEM_MGMT_RESPONSIBLE_BEARER);
+        }
+      }
+    };
+};
+
+class BenchFramer : public BufferPipe {
+  public:
+    BenchFramer() : BufferPipe() {};
+    const char* pipeName() {  return "BenchFramer";  };
+
+    int8_t fromCounterparty(StringBuilder* buf, int8_t mm) {
+      buf->cull(BENCH_HEADER_LEN);
+      return BufferPipe::fromCounterparty(buf, mm);
+    };
+
+    int8_t fromCounterparty(BufferSlice* buf, int8_t mm) {
+      BufferSlice payload;
+      payload.append(buf);
+      payload.cull(BENCH_HEADER_LEN);
+      return far()->fromCounterparty(&payload, mm);
+    };
+};
+
+class BenchSink : public BufferPipe {
+  public:
+    uint32_t      checksum = 0;
+    unsigned long bytes    = 0;
+
+    BenchSink() : BufferPipe() {};
+    const char* pipeName() {  return "BenchSink";  };
+
+    /* Cheap, so that the pipe's overhead is what we measure. */
+    void eat(uint8_t* buf, unsigned int len) {
+      checksum = (checksum * 31) + buf[0];
+      checksum = (checksum * 31) + buf[len - 1];
+      bytes += len;
+    };
+
+    int8_t fromCounterparty(StringBuilder* buf, int8_t mm) {
+      eat(buf->string(), buf->length());
+      return MEM_MGMT_RESPONSIBLE_BEARER;
+    };
+
+    int8_t fromCounterparty(BufferSlice* buf, int8_t mm) {
+      unsigned int len = 0;
+      for (int i = 0; i < buf->segments(); i++) {
+        uint8_t* seg = buf->segment(i, &len);
+        eat(seg, len);
+      }
+      return MEM_MGMT_RESPONSIBLE_BEARER;
+    };
+};
+
+
+/*
+* Pushes the same packets through the same pipe both ways, and reports MB/s.
+* Returns 0 if both ways delivered the same bytes.
+*/
+int bench_BufferPipe(StringBuilder* log) {
+  const unsigned int PACKETS = 200000;
+  const unsigned int sizes[] = { 64, 256, 1400 };
+  int return_value = 0;
+  log->concat("3-stage pipe throughput:\n");
+  for (unsigned int s = 0; s < (sizeof(sizes) / sizeof(sizes[0])); s++) {
+    double mbps[2];
+    uint32_t sums[2];
+    for (int mode = 0; mode < 2; mode++) {
+      BenchSource src;
+      BenchFramer framer;
+      BenchSink   sink;
+      src.setFar(&framer);
+      framer.setFar(&sink);
+      unsigned long t0 = micros();
+      src.pump((1 == mode), PACKETS, sizes[s]);
+      unsigned long t1 = micros();
+      mbps[mode] = (t1 > t0) ? ((double) sink.bytes / (double) (t1 - t0)) : (double) 0;
+      sums[mode] = sink.checksum;
+      if (sink.bytes != (PACKETS * (sizes[s] - BENCH_HEADER_LEN))) return_value = -1;
+      framer.joinEnds();   // Detach in an orderly way.
+    }
+    if (sums[0] != sums[1]) return_value = -1;
+    log->concatf("\t%4u-byte packets:   StringBuilder %8.1f MB/s    BufferSlice %8.1f MB/s\n", sizes[s], mbps[0], mbps[1]);
+  }
+  if (0 != return_value) log->concat("The two paths did not deliver the same bytes.\n");
+  return return_value;
+}
+
+
 /****************************************************************************************************
 * The main function.                                                                                *
 ****************************************************************************************************/
@@ -223,5 +428,14 @@ int main(int argc, char *argv[]) {
   printf("\n\n");
   //test_BufferPipe_1();
   printf("\n\n");
-  exit(0);
+
+  int exit_value = 1;
+  StringBuilder log;
+  if (0 == test_BufferSlice(&log)) {
+    if (0 == bench_BufferPipe(&log)) {
+      exit_value = 0;
+    }
+  }
+  printf("%s\n", (const char*) log.string());
+  exit(exit_value);
 }
@@ -0,0 +1,411 @@
+/*
+File:   BusQueueTest.cpp
+Author: J. Ian Lindsay
+Date:   2026.10.18
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Tests for the scheduler in BusAdapter. A bare adapter is driven directly, with
+  ops that never touch hardware.
+
+After the tests, a bus is shared by a device that floods it and one that
+  wants low latency, to show how long the latter waits under each policy.
+*/
+
+#include <cstdio>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Platform/Platform.h>
+#include <Drivers/BusQueue/BusQueue.h>
+
+#define TEST_Q_DEPTH    32
+#define BENCH_ROUNDS    200
+#define BENCH_FLOOD     10
+
+
+/*
+* An op that only knows which register it is aimed at.
+*/
+class TestOp : public BusOp {
+  public:
+    uint8_t reg = 0;
+
+    virtual ~TestOp() {};
+
+    XferFault begin() {  return XferFault::NONE;  };
+    void wipe() {
+      set_state(XferState::IDLE);
+      set_opcode(BusOpcode::UNDEF);
+      xfer_fault = XferFault::NONE;
+      callback = nullptr;
+      buf      = nullptr;
+      buf_len  = 0;
+      reg      = 0;
+    };
+    void printDebug(StringBuilder* output) {  BusOp::printBusOp("TestOp", this, output);  };
+
+    inline void fail() {  xfer_fault = XferFault::DEV_FAULT;  };
+};
+
+
+/*
+* A requester. Never called back in these tests.
+*/
+class TestDevice : public BusOpCallback {
+  public:
+    int8_t io_op_callahead(BusOp*) {  return 0;  };
+    int8_t io_op_callback(BusOp*) {   return 0;  };
+    int8_t queue_io_job(BusOp*) {     return 0;  };
+};
+
+
+/*
+* An adapter with no bus behind it. The scheduler is exposed for the tests.
+*/
+class TestAdapter : public BusAdapter<TestOp> {
+  public:
+    TestAdapter() : BusAdapter(TEST_Q_DEPTH) {};
+    ~TestAdapter() {
+      TestOp* op = work_queue.dequeue();
+      while (nullptr != op) {
+        delete op;
+        op = work_queue.dequeue();
+      }
+    };
+
+    int8_t io_op_callahead(BusOp*) {  return 0;  };
+    int8_t io_op_callback(BusOp*) {   return 0;  };
+    int8_t queue_io_job(BusOp*) {     return 0;  };
+
+    /* Makes an op and queues it. Returns what enqueue_op() did with it. */
+    int8_t queue(TestDevice* dev, BusOpcode opc, uint8_t reg, uint8_t* buf) {
+      TestOp* op = new TestOp();
+      op->set_opcode(opc);
+      op->callback = dev;
+      op->reg      = reg;
+      op->buf      = buf;
+      op->buf_len  = 2;
+      int8_t ret = enqueue_op(op);
+      if (0 != ret) delete op;
+      return ret;
+    };
+
+    inline TestOp* next() {               return dequeue_op();   };
+    inline void    retire(TestOp* op) {   retire_op(op);         };
+    inline void    release(TestDevice* dev) {  release_lane(dev);  };
+    inline int     depth() {              return work_queue.size();  };
+    inline void    print(StringBuilder* out) {  printAdapter(out);  };
+
+
+  protected:
+    int8_t advance_work_queue() {  return 0;  };
+    int8_t bus_init() {            return 0;  };
+    int8_t bus_deinit() {          return 0;  };
+    bool   same_read(TestOp* waiting, TestOp* nu) {  return (waiting->reg == nu->reg);  };
+};
+
+
+/*
+* One chatty device must not keep the others waiting, and each device's ops
+*   must come out in the order they went in.
+*/
+int test_Fairness(StringBuilder* log) {
+  log->concat("===< FAIRNESS >=========================================\n");
+  TestAdapter adapter;
+  TestDevice  a, b, c;
+  uint8_t buf[2];
+  for (uint8_t i = 0; i < 6; i++) adapter.queue(&a, BusOpcode::TX, i, buf);
+  for (uint8_t i = 0; i < 2; i++) adapter.queue(&b, BusOpcode::TX, i, buf);
+  adapter.queue(&c, BusOpcode::TX, 0, buf);
+
+  // Round-robin, then whatever is left of the chatty one.
+  TestDevice* expect[9] = {&a, &b, &c, &a, &b, &a, &a, &a, &a};
+  uint8_t next_reg[3] = {0, 0, 0};
+  for (int i = 0; i < 9; i++) {
+    TestOp* op = adapter.next();
+    if (nullptr == op) {
+      log->concatf("Queue ran dry after %d ops.\n", i);
+      return -1;
+    }
+    if (op->callback != expect[i]) {
+      log->concatf("Op %d came from the wrong device.\n", i);
+      delete op;
+      return -1;
+    }
+    uint8_t* nr = &next_reg[(&a == op->callback) ? 0 : ((&b == op->callback) ? 1 : 2)];
+    if (op->reg != (*nr)++) {
+      log->concatf("Op %d is out of order for its device.\n", i);
+      delete op;
+      return -1;
+    }
+    delete op;
+  }
+  if (nullptr != adapter.next()) {
+    log->concat("Queue should be empty.\n");
+    return -1;
+  }
+  log->concat("\tPASS.\n");
+  return 0;
+}
+
+
+/*
+* Duplicate reads that are still waiting are folded together, unless a write
+*   from the same device stands between them.
+*/
+int test_Coalescing(StringBuilder* log) {
+  log->concat("===< COALESCING >=======================================\n");
+  TestAdapter adapter;
+  TestDevice  a, b;
+  uint8_t buf_0[2];
+  uint8_t buf_1[2];
+  int ret = -1;
+
+  if (0 != adapter.queue(&a, BusOpcode::RX, 5, buf_0)) {
+    log->concat("First read wasn't queued.\n");
+  }
+  else if (1 != adapter.queue(&a, BusOpcode::RX, 5, buf_0)) {
+    log->concat("Duplicate read wasn't coalesced.\n");
+  }
+  else if (0 != adapter.queue(&a, BusOpcode::RX, 6, buf_0)) {
+    log->concat("Read of another register was coalesced.\n");
+  }
+  else if (0 != adapter.queue(&a, BusOpcode::RX, 5, buf_1)) {
+    log->concat("Read into another buffer was coalesced.\n");
+  }
+  else if (0 != adapter.queue(&b, BusOpcode::RX, 5, buf_0)) {
+    log->concat("Read by another device was coalesced.\n");
+  }
+  else if (0 != adapter.queue(&a, BusOpcode::TX, 5, buf_0)) {
+    log->concat("Write wasn't queued.\n");
+  }
+  else if (0 != adapter.queue(&a, BusOpcode::RX, 5, buf_0)) {
+    log->concat("Read after a write was coalesced.\n");
+  }
+  else if (1 != adapter.queue(&a, BusOpcode::RX, 5, buf_0)) {
+    log->concat("Duplicate of the read after the write wasn't coalesced.\n");
+  }
+  else if (6 != adapter.depth()) {
+    log->concatf("Queue depth is %d. Should be 6.\n", adapter.depth());
+  }
+  else {
+    ret = 0;
+    StringBuilder out;
+    adapter.print(&out);
+    log->concat(&out);
+    log->concat("\tPASS.\n");
+  }
+  return ret;
+}
+
+
+/*
+* Ops from a device with a latency target go ahead of best-effort work, and
+*   earliest deadline first among themselves.
+*/
+int test_Deadlines(StringBuilder* log) {
+  log->concat("===< DEADLINES >========================================\n");
+  TestAdapter adapter;
+  TestDevice  a, slow, fast;
+  uint8_t buf[2];
+  if ((0 != adapter.setLatencyTarget(&slow, 100000)) || (0 != adapter.setLatencyTarget(&fast, 1000))) {
+    log->concat("Couldn't set latency targets.\n");
+    return -1;
+  }
+  for (uint8_t i = 0; i < 4; i++) adapter.queue(&a, BusOpcode::TX, i, buf);
+  adapter.queue(&slow, BusOpcode::TX, 0, buf);
+  adapter.queue(&fast, BusOpcode::TX, 0, buf);
+  adapter.queue(&fast, BusOpcode::TX, 1, buf);
+
+  TestDevice* expect[7] = {&fast, &fast, &slow, &a, &a, &a, &a};
+  for (int i = 0; i < 7; i++) {
+    TestOp* op = adapter.next();
+    if ((nullptr == op) || (op->callback != expect[i])) {
+      log->concatf("Op %d came from the wrong device.\n", i);
+      if (op) delete op;
+      return -1;
+    }
+    if ((&fast == op->callback) && (op->reg != i)) {
+      log->concat("Deadline ops are out of order.\n");
+      delete op;
+      return -1;
+    }
+    delete op;
+  }
+  log->concat("\tPASS.\n");
+  return 0;
+}
+
+
+/*
+* Retired ops are counted against their device's lane.
+*/
+int test_LaneStats(StringBuilder* log) {
+  log->concat("===< LANE STATS >=======================================\n");
+  TestAdapter adapter;
+  TestDevice  a, b;
+  uint8_t buf[2];
+  adapter.setLatencyTarget(&b, 1);   // Can't be met.
+  for (uint8_t i = 0; i < 3; i++) adapter.queue(&a, BusOpcode::TX, i, buf);
+  adapter.queue(&b, BusOpcode::RX, 0, buf);
+  sleep_millis(2);
+
+  TestOp* op = adapter.next();
+  int n = 0;
+  while (nullptr != op) {
+    if ((&a == op->callback) && (0 == op->reg)) op->fail();
+    op->set_state(op->hasFault() ? XferState::FAULT : XferState::COMPLETE);
+    adapter.retire(op);
+    delete op;
+    n++;
+    op = adapter.next();
+  }
+
+  StringBuilder out;
+  adapter.print(&out);
+  const char* text = (const char*) out.string();
+  // Device a: 3 ops, 1 fault, 4 bytes. Device b: 1 op, missed its deadline.
+  if ((4 != n) || (nullptr == strstr(text, "Xfers (fail/total)  1/4"))) {
+    log->concat("Adapter totals are wrong.\n");
+  }
+  else if (nullptr == strstr(text, "     3       1         4       0")) {
+    log->concat("Lane counts are wrong for the first device.\n");
+  }
+  else if (nullptr == strstr(text, "       1/1\n")) {
+    log->concat("The missed deadline wasn't counted.\n");
+  }
+  else {
+    log->concat(&out);
+    log->concat("\tPASS.\n");
+    return 0;
+  }
+  log->concat(&out);
+  return -1;
+}
+
+
+/*
+* A device that leaves the bus gives up its lane and its latency target. The
+*   lane goes to the next newcomer, and nobody else is moved.
+*/
+int test_LaneRelease(StringBuilder* log) {
+  log->concat("===< LANE RELEASE >=====================================\n");
+  TestAdapter adapter;
+  TestDevice  devs[BUSADAPTER_MAX_LANES];
+  TestDevice  late;
+  uint8_t buf[2];
+  for (int i = 0; i < BUSADAPTER_MAX_LANES; i++) adapter.setLatencyTarget(&devs[i], 100000);
+
+  if (0 == adapter.setLatencyTarget(&late, 100000)) {
+    log->concat("A latecomer got a lane of its own from a full table.\n");
+    return -1;
+  }
+  adapter.release(&devs[2]);
+  if (0 != adapter.setLatencyTarget(&late, 0)) {
+    log->concat("A released lane was not reclaimed.\n");
+    return -1;
+  }
+  // Every lane is spoken for again, so the departed device can't get one back.
+  if (0 == adapter.setLatencyTarget(&devs[2], 0)) {
+    log->concat("A lane was handed out twice.\n");
+    return -1;
+  }
+
+  // The newcomer is best-effort, and the others kept their deadlines.
+  adapter.queue(&late, BusOpcode::TX, 0, buf);
+  adapter.queue(&devs[BUSADAPTER_MAX_LANES - 1], BusOpcode::TX, 1, buf);
+  TestOp* op = adapter.next();
+  const bool ok = (nullptr != op) && (&devs[BUSADAPTER_MAX_LANES - 1] == op->callback);
+  while (nullptr != op) {
+    delete op;
+    op = adapter.next();
+  }
+  if (!ok) {
+    log->concat("Lanes were disturbed by the release.\n");
+    return -1;
+  }
+  log->concat("\tPASS.\n");
+  return 0;
+}
+
+
+/*
+* A device floods the bus, and another wants one op through. Counts how many
+*   ops are served before it, with the old FIFO order, with round-robin lanes,
+*   and with a latency target.
+*/
+int bench_Latency(StringBuilder* log) {
+  log->concat("===< BENCHMARK: LATENCY UNDER FLOOD >===================\n");
+  const char* names[3] = {"FIFO", "Lanes", "Lanes+deadline"};
+  uint32_t waited[3] = {0, 0, 0};
+  uint32_t worst[3]  = {0, 0, 0};
+  uint8_t  buf[2];
+
+  for (int mode = 1; mode < 3; mode++) {
+    TestAdapter adapter;
+    TestDevice  flood, sensor;
+    if (2 == mode) adapter.setLatencyTarget(&sensor, 500);
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+      // Keep the flooder's backlog topped up, then add the sensor's read.
+      while (adapter.depth() < BENCH_FLOOD) adapter.queue(&flood, BusOpcode::TX, 0, buf);
+      adapter.queue(&sensor, BusOpcode::RX, 0, buf);
+      uint32_t served = 0;
+      TestOp* op = adapter.next();
+      while ((nullptr != op) && (&sensor != op->callback)) {
+        served++;
+        delete op;
+        op = adapter.next();
+      }
+      if (nullptr == op) {
+        log->concat("The sensor's op was lost.\n");
+        return -1;
+      }
+      delete op;
+      waited[mode] += served;
+      if (served > worst[mode]) worst[mode] = served;
+    }
+  }
+  // FIFO would put the sensor's op behind the whole backlog, every time.
+  waited[0] = BENCH_FLOOD * BENCH_ROUNDS;
+  worst[0]  = BENCH_FLOOD;
+
+  log->concatf("\t%d rounds, %d ops of backlog from the flooder.\n", BENCH_ROUNDS, BENCH_FLOOD);
+  log->concatf("\t%-16s %14s %14s\n", "", "ops ahead avg", "ops ahead max");
+  for (int i = 0; i < 3; i++) {
+    log->concatf("\t%-16s %14.2f %14u\n", names[i], (double) waited[i] / (double) BENCH_ROUNDS, worst[i]);
+  }
+  if ((worst[1] > 1) || (worst[2] > 0)) {
+    log->concat("The sensor waited longer than it should have.\n");
+    return -1;
+  }
+  return 0;
+}
+
+
+int main(int argc, char *argv[]) {
+  int exit_value = 1;   // Failure is the default result.
+  platform.platformPreInit();
+
+  StringBuilder log("===< BusQueue >=========================================\n");
+  if ((0 == test_Fairness(&log)) && (0 == test_Coalescing(&log)) && (0 == test_Deadlines(&log))) {
+    if ((0 == test_LaneStats(&log)) && (0 == test_LaneRelease(&log)) && (0 == bench_Latency(&log))) {
+      exit_value = 0;
+    }
+  }
+  printf("%s\n", (const char*) log.string());
+  exit(exit_value);
+}
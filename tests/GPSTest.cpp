@@ -0,0 +1,263 @@
+/*
+File:   GPSTest.cpp
+Author: J. Ian Lindsay
+Date:   2026.10.18
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Tests for the GPS pipe. A recorded NMEA log is replayed through it in chunks
+  of various sizes, as a UART driver would deliver it.
+
+Usage:  ./GPSTest [nmea-log]
+*/
+
+#include <cstdio>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <Platform/Platform.h>
+#include <Transports/BufferPipes/ManuvrGPS/ManuvrGPS.h>
+
+#define GPS_TEST_DEFAULT_LOG   "data/nmea-replay.log"
+
+/* What we know about the default log. */
+#define GPS_TEST_LOG_PARSED     225     // Every sentence we know how to parse.
+#define GPS_TEST_LOG_REJECTED   2       // A $GPTXT, and a GGA with a bad checksum.
+#define GPS_TEST_LOG_LAT        48.1173503f
+#define GPS_TEST_LOG_LON        11.5167668f
+#define GPS_TEST_LOG_ALT        548.3f
+#define GPS_TEST_LOG_KPH        ((double) 1.485)
+
+
+/*
+* Pushes bytes into the GPS as its near-side transport would.
+*/
+static void _feed(ManuvrGPS* gps, const void* buf, unsigned int len) {
+  ((BufferPipe*) gps)->fromCounterparty((uint8_t*) buf, len, MEM_MGMT_RESPONSIBLE_CREATOR);
+}
+
+
+/*
+* Feeds the whole log through the pipe, chunk bytes at a time.
+*/
+static void _replay(ManuvrGPS* gps, StringBuilder* log_data, unsigned int chunk) {
+  uint8_t*     src = log_data->string();
+  unsigned int len = log_data->length();
+  unsigned int i   = 0;
+  while (i < len) {
+    unsigned int n = ((len - i) < chunk) ? (len - i) : chunk;
+    _feed(gps, src + i, n);
+    i += n;
+  }
+}
+
+
+/*
+* The log must parse identically no matter how it is chopped up.
+*/
+int test_GPS_Replay(StringBuilder* log, StringBuilder* log_data, bool default_log) {
+  const unsigned int chunks[] = { 1, 7, 64, 4096 };
+  for (unsigned int c = 0; c < (sizeof(chunks) / sizeof(chunks[0])); c++) {
+    ManuvrGPS gps;
+    _replay(&gps, log_data, chunks[c]);
+    log->concatf("\t%4u-byte chunks:  %u parsed, %u rejected\n", chunks[c], gps.sentencesParsed(), gps.sentencesRejected());
+    if (!default_log) continue;   // We know nothing about foreign logs.
+
+    if ((GPS_TEST_LOG_PARSED != gps.sentencesParsed()) || (GPS_TEST_LOG_REJECTED != gps.sentencesRejected())) {
+      log->concatf("Expected %u parsed and %u rejected.\n", GPS_TEST_LOG_PARSED, GPS_TEST_LOG_REJECTED);
+      return -1;
+    }
+    float  lat = 0.0f;
+    float  lon = 0.0f;
+    float  alt = 0.0f;
+    double kph = 0.0;
+    gps.readDatumRaw(1, &lat);
+    gps.readDatumRaw(2, &lon);
+    gps.readDatumRaw(3, &alt);
+    gps.readDatumRaw(0, &kph);
+    if ((fabsf(lat - GPS_TEST_LOG_LAT) > 0.0001f) || (fabsf(lon - GPS_TEST_LOG_LON) > 0.0001f)) {
+      log->concatf("Position came back as (%.6f, %.6f).\n", (double) lat, (double) lon);
+      return -1;
+    }
+    if ((fabsf(alt - GPS_TEST_LOG_ALT) > 0.01f) || (fabs(kph - GPS_TEST_LOG_KPH) > (double) 0.001)) {
+      log->concatf("Altitude and speed came back as %.2fm, %.3fkph.\n", (double) alt, kph);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+
+/*
+* Writes a UBX NAV-PVT frame into buf, and returns its length.
+*/
+static unsigned int _ubx_nav_pvt(uint8_t* buf, int32_t lat, int32_t lon, int32_t h_msl, int32_t g_speed) {
+  const uint16_t PAYLOAD = 92;
+  memset(buf, 0, PAYLOAD + 8);
+  buf[0] = 0xB5;
+  buf[1] = 0x62;
+  buf[2] = 0x01;   // NAV
+  buf[3] = 0x07;   // PVT
+  buf[4] = PAYLOAD & 0xFF;
+  buf[5] = PAYLOAD >> 8;
+  uint8_t* p = buf + 6;
+  p[20] = 3;       // 3D fix.
+  p[21] = 0x01;    // gnssFixOK
+  memcpy(p + 24, &lon, 4);
+  memcpy(p + 28, &lat, 4);
+  memcpy(p + 36, &h_msl, 4);
+  memcpy(p + 60, &g_speed, 4);
+  uint8_t ck_a = 0;
+  uint8_t ck_b = 0;
+  for (unsigned int i = 2; i < (unsigned int) (6 + PAYLOAD); i++) {
+    ck_a += buf[i];
+    ck_b += ck_a;
+  }
+  buf[6 + PAYLOAD] = ck_a;
+  buf[7 + PAYLOAD] = ck_b;
+  return PAYLOAD + 8;
+}
+
+
+/*
+* UBX frames may be interleaved with NMEA, and update the same data.
+*/
+int test_GPS_UBX(StringBuilder* log) {
+  ManuvrGPS gps;
+  uint8_t frame[128];
+  const char* nmea = "$GNVTG,77.52,T,,M,0.512,N,0.948,K,A*17\r\n";
+  unsigned int len = _ubx_nav_pvt(frame, -337654321, 1512345678, 12345, 2500);
+
+  _feed(&gps, nmea, strlen(nmea));
+  _feed(&gps, frame, 50);   // Split mid-frame.
+  _feed(&gps, frame + 50, len - 50);
+  _feed(&gps, nmea, strlen(nmea));
+
+  float  lat = 0.0f;
+  float  lon = 0.0f;
+  float  alt = 0.0f;
+  double kph = 0.0;
+  gps.readDatumRaw(1, &lat);
+  gps.readDatumRaw(2, &lon);
+  gps.readDatumRaw(3, &alt);
+  if ((3 != gps.sentencesParsed()) || (0 != gps.sentencesRejected())) {
+    log->concatf("UBX: %u parsed, %u rejected. Expected 3 and 0.\n", gps.sentencesParsed(), gps.sentencesRejected());
+    return -1;
+  }
+  if ((fabsf(lat - -33.7654321f) > 0.00001f) || (fabsf(lon - 151.2345678f) > 0.0001f) || (fabsf(alt - 12.345f) > 0.001f)) {
+    log->concatf("UBX position came back as (%.6f, %.6f, %.3f).\n", (double) lat, (double) lon, (double) alt);
+    return -1;
+  }
+
+  // A corrupted frame must not update anything.
+  _ubx_nav_pvt(frame, 0, 0, 0, 0);
+  frame[40] ^= 0x01;
+  _feed(&gps, frame, len);
+  gps.readDatumRaw(1, &lat);
+  gps.readDatumRaw(0, &kph);
+  if ((1 != gps.sentencesRejected()) || (lat > -33.0f) || (fabs(kph - (double) 0.948) > (double) 0.001)) {
+    log->concat("UBX frame with a bad checksum was not rejected.\n");
+    return -1;
+  }
+  log->concat("\tUBX NAV-PVT frames parse between NMEA sentences.\n");
+  return 0;
+}
+
+
+/*
+* A UBX sync that turns up by chance in NMEA, followed by a length that no
+*   frame could have, must not swallow the sentences after it.
+*/
+int test_GPS_UBXBogusLength(StringBuilder* log) {
+  ManuvrGPS gps;
+  const uint8_t bogus[6] = {0xB5, 0x62, 0x01, 0x07, 0xFF, 0xFF};
+  const char* nmea = "$GNVTG,77.52,T,,M,0.512,N,0.948,K,A*17\r\n";
+  double kph = 0.0;
+
+  _feed(&gps, bogus, sizeof(bogus));
+  _feed(&gps, nmea, strlen(nmea));
+  gps.readDatumRaw(0, &kph);
+  if ((1 != gps.sentencesParsed()) || (1 != gps.sentencesRejected())) {
+    log->concatf("Bogus UBX length: %u parsed, %u rejected. Expected 1 and 1.\n", gps.sentencesParsed(), gps.sentencesRejected());
+    return -1;
+  }
+  if (fabs(kph - (double) 0.948) > (double) 0.001) {
+    log->concat("The sentence after a bogus UBX length didn't update the speed.\n");
+    return -1;
+  }
+  log->concat("\tA UBX frame with an impossible length is dropped at its header.\n");
+  return 0;
+}
+
+
+/*
+* Replays the log many times, in the sort of chunks a UART DMA would give us.
+*   Informational only.
+*/
+void bench_GPS_Replay(StringBuilder* log, StringBuilder* log_data) {
+  const unsigned int ROUNDS = 400;
+  ManuvrGPS gps;
+  unsigned long t0 = micros();
+  for (unsigned int r = 0; r < ROUNDS; r++) {
+    _replay(&gps, log_data, 64);
+  }
+  unsigned long elapsed = micros() - t0;
+  unsigned long bytes   = (unsigned long) log_data->length() * ROUNDS;
+  unsigned int  count   = gps.sentencesParsed() + gps.sentencesRejected();
+  log->concatf("\tReplayed %lu bytes (%u sentences) in %lu us:  %.2f MB/s, %.0f ns/sentence\n",
+    bytes, count, elapsed,
+    (elapsed ? ((double) bytes / (double) elapsed) : (double) 0),
+    (count ? (((double) elapsed * 1000) / count) : (double) 0)
+  );
+}
+
+
+/****************************************************************************************************
+* The main function.                                                                                *
+****************************************************************************************************/
+int main(int argc, char *argv[]) {
+  int exit_value = 1;   // Failure is the default result.
+  platform.platformPreInit();
+
+  const char* path = (argc > 1) ? argv[1] : GPS_TEST_DEFAULT_LOG;
+  StringBuilder log_data;
+  FILE* fp = fopen(path, "rb");
+  if (nullptr != fp) {
+    uint8_t chunk[1024];
+    size_t r = 0;
+    while (0 < (r = fread(chunk, 1, sizeof(chunk), fp))) {
+      log_data.concat(chunk, (int) r);
+    }
+    fclose(fp);
+  }
+
+  StringBuilder log("===< ManuvrGPS >========================================\n");
+  if (0 < log_data.length()) {
+    log.concatf("Replaying %s (%d bytes)\n", path, log_data.length());
+    if (0 == test_GPS_Replay(&log, &log_data, (argc <= 1))) {
+      if ((0 == test_GPS_UBX(&log)) && (0 == test_GPS_UBXBogusLength(&log))) {
+        bench_GPS_Replay(&log, &log_data);
+        exit_value = 0;
+      }
+    }
+  }
+  else {
+    log.concatf("Couldn't read %s\n", path);
+  }
+  printf("%s\n", (const char*) log.string());
+  exit(exit_value);
+}
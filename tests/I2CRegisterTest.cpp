@@ -0,0 +1,346 @@
+/*
+File:   I2CRegisterTest.cpp
+Author: J. Ian Lindsay
+Date:   2026.10.18
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Tests for I2CDeviceWithRegisters. The device under test intercepts its own bus
+  ops and services them against an in-memory register file that
+  auto-increments, so we can count what would have gone over the wire.
+
+After the tests, a register map is synced with and without burst transfers,
+  for comparison.
+*/
+
+#include <cstdio>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Platform/Platform.h>
+#include <Platform/Peripherals/I2C/I2CAdapter.h>
+
+#define BENCH_SYNCS      20000
+#define BUS_HZ           100000   // Standard-mode, for estimating wire time.
+
+static I2CAdapter* adapter = nullptr;
+
+
+/*
+* A device with a simulated register file behind it. Ops complete before
+*   queue_io_job() returns.
+*/
+class SimRegDevice : public I2CDeviceWithRegisters {
+  public:
+    uint8_t  file[1024];
+    uint32_t ops       = 0;
+    uint32_t bytes     = 0;
+    uint32_t wire_bits = 0;
+    uint32_t read_cbs  = 0;
+    uint32_t write_cbs = 0;
+
+    SimRegDevice(uint8_t addr, uint8_t reg_count, uint16_t mem_size) :
+      I2CDeviceWithRegisters(addr, reg_count, mem_size) {
+      for (unsigned int i = 0; i < sizeof(file); i++) file[i] = (uint8_t) (i * 7 + 3);
+    };
+
+    using I2CDeviceWithRegisters::syncRegisters;
+    using I2CDeviceWithRegisters::writeDirtyRegisters;
+    using I2CDeviceWithRegisters::writeIndirect;
+
+    inline void burst(bool en) {   multi_access_support = en;   };
+    inline void resetCounts() {    ops = bytes = wire_bits = read_cbs = write_cbs = 0;  };
+    inline DeviceRegister* reg(int a) {   return getRegisterByBaseAddress(a);   };
+    inline DeviceRegister* regAt(unsigned int i) {   return reg_defs.get(i);   };
+    inline unsigned int regCount() {   return reg_defs.count();   };
+
+    bool def8(uint16_t a, bool w) {   return defineRegister(a, (uint8_t)  0, false, false, w);  };
+    bool def16(uint16_t a, bool w) {  return defineRegister(a, (uint16_t) 0, false, false, w);  };
+
+    int8_t queue_io_job(BusOp* _op) {
+      I2CBusOp* op = (I2CBusOp*) _op;
+      ops++;
+      bytes += op->buf_len;
+      // START, address, sub-address, [repeated START, address], data. Nine bits per byte.
+      wire_bits += 9 * (2 + op->buf_len + ((BusOpcode::RX == op->get_opcode()) ? 1 : 0)) + 2;
+      if ((op->sub_addr < 0) || ((op->sub_addr + op->buf_len) > (int) sizeof(file))) {
+        adapter->return_op_to_pool(op);
+        return -1;
+      }
+      if (BusOpcode::RX == op->get_opcode()) {
+        memcpy(op->buf, &file[op->sub_addr], op->buf_len);
+      }
+      else if (BusOpcode::TX == op->get_opcode()) {
+        memcpy(&file[op->sub_addr], op->buf, op->buf_len);
+      }
+      op->set_state(XferState::COMPLETE);
+      op->callback->io_op_callback(op);
+      adapter->return_op_to_pool(op);
+      return 0;
+    };
+
+
+  protected:
+    int8_t register_write_cb(DeviceRegister*) {  write_cbs++;   return 0;  };
+    int8_t register_read_cb(DeviceRegister*) {   read_cbs++;    return 0;  };
+};
+
+
+/*
+* Checks that every register mirrors the file.
+*/
+static int verify_mirror(SimRegDevice* dev, StringBuilder* log) {
+  for (unsigned int i = 0; i < dev->regCount(); i++) {
+    DeviceRegister* r = dev->regAt(i);
+    if (0 != memcmp(r->val, &dev->file[r->addr], r->len)) {
+      log->concatf("Register 0x%04x doesn't match the device.\n", r->addr);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+
+/*
+* Every register must be found by its address, and nothing else should be.
+*/
+int test_Index(StringBuilder* log) {
+  log->concat("===< INDEX >============================================\n");
+  SimRegDevice dev(0x20, 8, 16);
+  dev.def8(0x00, true);
+  dev.def16(0x01, true);
+  dev.def8(0x40, true);
+  dev.def8(0x03, true);
+  dev.def16(0xFF, true);
+  dev.def16(0x0300, true);   // Past the index. Found by search.
+  dev.def8(0x0305, true);
+
+  const int addrs[] = {0x00, 0x01, 0x40, 0x03, 0xFF, 0x0300, 0x0305};
+  for (unsigned int i = 0; i < sizeof(addrs) / sizeof(int); i++) {
+    DeviceRegister* r = dev.reg(addrs[i]);
+    if ((nullptr == r) || (r != dev.regAt(i)) || (r->addr != addrs[i])) {
+      log->concatf("Register 0x%04x was not found.\n", addrs[i]);
+      return -1;
+    }
+  }
+  const int misses[] = {0x02, 0x04, 0x3F, 0x41, 0xFE, 0x100, 0x0301, -1};
+  for (unsigned int i = 0; i < sizeof(misses) / sizeof(int); i++) {
+    if (nullptr != dev.reg(misses[i])) {
+      log->concatf("Found a register at 0x%04x, where none was defined.\n", misses[i]);
+      return -1;
+    }
+  }
+  log->concat("\tPASS.\n");
+  return 0;
+}
+
+
+/*
+* Without auto-increment, each register costs an op. With it, contiguous runs
+*   cost one op apiece, and breaks in the address space break the run.
+*/
+int test_SyncRuns(StringBuilder* log) {
+  log->concat("===< SYNC RUNS >========================================\n");
+  SimRegDevice dev(0x21, 12, 20);
+  adapter->addSlaveDevice(&dev);
+  dev.def8(0x00, false);    // Run 1...
+  dev.def8(0x01, true);
+  dev.def16(0x02, true);
+  dev.def16(0x04, true);
+  dev.def8(0x10, true);     // Run 2 (gap before)...
+  dev.def16(0x11, true);
+  dev.def16(0x13, false);
+  dev.def8(0x20, true);     // Run 3 (gap before)...
+  dev.def16(0x30, true);    // Run 4 (gap before)...
+  dev.def16(0x32, true);
+
+  int ret = -1;
+  if (0 != dev.syncRegisters()) {
+    log->concat("syncRegisters() failed without bursts.\n");
+  }
+  else if ((dev.ops != 10) || (dev.read_cbs != 10) || (0 != verify_mirror(&dev, log))) {
+    log->concatf("Single-register sync took %u ops and made %u callbacks.\n", dev.ops, dev.read_cbs);
+  }
+  else {
+    for (unsigned int i = 0; i < sizeof(dev.file); i++) dev.file[i] = (uint8_t) (i * 13 + 1);
+    dev.resetCounts();
+    dev.burst(true);
+    if (0 != dev.syncRegisters()) {
+      log->concat("syncRegisters() failed with bursts.\n");
+    }
+    else if ((dev.ops != 4) || (dev.read_cbs != 10) || (dev.bytes != 16)) {
+      log->concatf("Burst sync took %u ops, %u bytes, and made %u callbacks.\n", dev.ops, dev.bytes, dev.read_cbs);
+    }
+    else if (0 != verify_mirror(&dev, log)) {
+    }
+    else {
+      ret = 0;
+      for (unsigned int i = 0; i < dev.regCount(); i++) {
+        if (!dev.regAt(i)->unread) {
+          log->concatf("Register 0x%02x wasn't marked unread.\n", dev.regAt(i)->addr);
+          ret = -1;
+        }
+      }
+    }
+  }
+  adapter->removeSlaveDevice(&dev);
+  if (0 == ret) log->concat("\tPASS.\n");
+  return ret;
+}
+
+
+/*
+* A run must not grow past the burst limit.
+*/
+int test_BurstLimit(StringBuilder* log) {
+  log->concat("===< BURST LIMIT >======================================\n");
+  const unsigned int REGS = I2CDEVICE_MAX_BURST_LEN + 8;
+  SimRegDevice dev(0x22, REGS, REGS);
+  adapter->addSlaveDevice(&dev);
+  dev.burst(true);
+  for (unsigned int i = 0; i < REGS; i++) dev.def8(i, true);
+
+  int ret = -1;
+  if ((0 == dev.syncRegisters()) && (2 == dev.ops) && (REGS == dev.read_cbs) && (0 == verify_mirror(&dev, log))) {
+    ret = 0;
+  }
+  else {
+    log->concatf("Sync of %u bytes took %u ops.\n", REGS, dev.ops);
+  }
+  adapter->removeSlaveDevice(&dev);
+  if (0 == ret) log->concat("\tPASS.\n");
+  return ret;
+}
+
+
+/*
+* Dirty registers should be written in runs that stop at clean or read-only
+*   registers.
+*/
+int test_WriteRuns(StringBuilder* log) {
+  log->concat("===< WRITE RUNS >=======================================\n");
+  SimRegDevice dev(0x23, 10, 14);
+  adapter->addSlaveDevice(&dev);
+  dev.burst(true);
+  dev.def8(0x00, true);
+  dev.def8(0x01, true);
+  dev.def16(0x02, true);
+  dev.def8(0x04, true);
+  dev.def8(0x05, false);
+  dev.def8(0x06, true);
+  dev.def16(0x07, true);
+  dev.def8(0x09, true);
+  dev.def16(0x0A, true);
+  dev.syncRegisters();
+  dev.resetCounts();
+
+  int ret = -1;
+  // Dirty: 0x01, 0x02, 0x04 (one run), then 0x06, 0x07 (one run), and 0x0A.
+  dev.writeIndirect(0x01, 0x11, true);
+  dev.writeIndirect(0x02, 0x2222, true);
+  dev.writeIndirect(0x04, 0x44, true);
+  dev.writeIndirect(0x06, 0x66, true);
+  dev.writeIndirect(0x07, 0x7777, true);
+  dev.writeIndirect(0x0A, 0xAAAA, true);
+  if (I2C_ERR_SLAVE_REG_IS_RO != dev.writeIndirect(0x05, 0x55, true)) {
+    log->concat("A read-only register took a write.\n");
+  }
+  else if (0 != dev.writeDirtyRegisters()) {
+    log->concat("writeDirtyRegisters() failed.\n");
+  }
+  else if ((3 != dev.ops) || (6 != dev.write_cbs) || (9 != dev.bytes)) {
+    log->concatf("Dirty registers took %u ops, %u bytes, and made %u callbacks.\n", dev.ops, dev.bytes, dev.write_cbs);
+  }
+  else if (0 != verify_mirror(&dev, log)) {
+  }
+  else {
+    ret = 0;
+    for (unsigned int i = 0; i < dev.regCount(); i++) {
+      DeviceRegister* r = dev.regAt(i);
+      if (r->dirty || r->op_pending) {
+        log->concatf("Register 0x%02x is still dirty or pending.\n", r->addr);
+        ret = -1;
+      }
+    }
+    if ((0x11 != dev.file[1]) || (0x22 != dev.file[2]) || (0xAA != dev.file[0x0B])) {
+      log->concat("The device didn't receive the written values.\n");
+      ret = -1;
+    }
+  }
+  adapter->removeSlaveDevice(&dev);
+  if (0 == ret) log->concat("\tPASS.\n");
+  return ret;
+}
+
+
+/*
+* Syncs a map shaped like a typical sensor (a block of 8-bit config registers
+*   and a block of 16-bit data registers) both ways.
+*/
+int bench_Sync(StringBuilder* log) {
+  log->concat("===< BENCHMARK: REGISTER SYNC >=========================\n");
+  SimRegDevice dev(0x24, 24, 32);
+  adapter->addSlaveDevice(&dev);
+  for (unsigned int i = 0; i < 16; i++) dev.def8(i, true);
+  for (unsigned int i = 0; i < 8; i++) dev.def16(0x20 + (i << 1), false);
+
+  uint32_t ops[2];
+  uint32_t wire_us[2];
+  uint32_t cpu_us[2];
+  for (int mode = 0; mode < 2; mode++) {
+    dev.burst(1 == mode);
+    dev.resetCounts();
+    const uint32_t t0 = (uint32_t) micros();
+    for (int i = 0; i < BENCH_SYNCS; i++) dev.syncRegisters();
+    cpu_us[mode]  = (uint32_t) micros() - t0;
+    ops[mode]     = dev.ops / BENCH_SYNCS;
+    wire_us[mode] = (uint32_t) (((uint64_t) dev.wire_bits * 1000000) / ((uint64_t) BUS_HZ * BENCH_SYNCS));
+    if (dev.read_cbs != (uint32_t) (24 * BENCH_SYNCS)) {
+      log->concatf("Expected %u callbacks, got %u.\n", 24 * BENCH_SYNCS, dev.read_cbs);
+      adapter->removeSlaveDevice(&dev);
+      return -1;
+    }
+  }
+  adapter->removeSlaveDevice(&dev);
+
+  log->concatf("\t%u registers, %d syncs each way.\n", 24, BENCH_SYNCS);
+  log->concatf("\t%-16s %10s %12s %14s\n", "", "ops/sync", "wire us/sync", "cpu us total");
+  log->concatf("\t%-16s %10u %12u %14u\n", "Single register", ops[0], wire_us[0], cpu_us[0]);
+  log->concatf("\t%-16s %10u %12u %14u\n", "Burst", ops[1], wire_us[1], cpu_us[1]);
+  if (ops[1] >= ops[0]) {
+    log->concat("Bursts didn't reduce the op count.\n");
+    return -1;
+  }
+  return 0;
+}
+
+
+int main(int argc, char *argv[]) {
+  int exit_value = 1;   // Failure is the default result.
+  platform.platformPreInit();
+  I2CAdapterOptions opts(9, 0, 0);
+  adapter = new I2CAdapter(&opts);   // Never attached, so never opens a bus.
+
+  StringBuilder log("===< I2CDeviceWithRegisters >===========================\n");
+  if ((0 == test_Index(&log)) && (0 == test_SyncRuns(&log)) &&
+      (0 == test_BurstLimit(&log)) && (0 == test_WriteRuns(&log))) {
+    if (0 == bench_Sync(&log)) {
+      exit_value = 0;
+    }
+  }
+  printf("%s\n", (const char*) log.string());
+  exit(exit_value);
+}
@@ -0,0 +1,478 @@
+/*
+File:   KernelSchedTest.cpp
+Author: J. Ian Lindsay
+Date:   2026.10.18
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+This program tests the Kernel's scheduling policy.
+
+Msgs with deadlines must be run earliest-first within their priority, and a
+  nearly-due Msg must run even if its band has no budget left, or the loop has
+  run its fill. Only a few may run after the loop is spent. A band that has no
+  budget must still be served once it has waited past the aging limit.
+  A receiver that goes over its own budget must end the loop. A loop with no
+  event limit must report a sane count, however many events it ran.
+
+Then a slow, high-priority receiver is flooded with work, and we measure how
+  long a trickle of low-priority events waits behind it, with the policy
+  reduced to strict priority, and then with the default policy.
+*/
+
+#include <cstdio>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <Platform/Platform.h>
+#include <DataStructures/StringBuilder.h>
+
+#define SCHED_TEST_MSG_CODE   0x7E10   // Cheap, and recorded in order.
+#define SCHED_SLOW_MSG_CODE   0x7E11   // Burns SLOW_WORK_US in notify().
+#define SCHED_LOG_DEPTH       64
+#define SLOW_WORK_US          1000
+#define FLOOD_DEPTH           8
+#define TRICKLE_EVENTS        20
+#define LONG_LOOP_EVENTS      300  // More than procIdleFlags() can count.
+#define MARK_SEQ              0x80000000  // The recorder notes when it sees this one.
+
+const unsigned char SCHED_TEST_FORMS[] = {0};
+
+
+/*
+* Keeps the sequence numbers of the cheap events, in the order it saw them.
+*/
+class RecordingReceiver : public EventReceiver {
+  public:
+    uint32_t seq_log[SCHED_LOG_DEPTH];
+    uint32_t seen = 0;
+    uint32_t last_seen_at = 0;
+    uint32_t mark_seen_at = 0;
+
+    RecordingReceiver() : EventReceiver("RecordingReceiver") {};
+
+    int8_t notify(ManuvrMsg* active_event) {
+      if (SCHED_TEST_MSG_CODE == active_event->eventCode()) {
+        uint32_t seq = 0;
+        active_event->getArgAs(&seq);
+        if (seen < SCHED_LOG_DEPTH) seq_log[seen] = seq;
+        seen++;
+        last_seen_at = (uint32_t) micros();
+        if (MARK_SEQ == seq) mark_seen_at = last_seen_at;
+        return 1;
+      }
+      return EventReceiver::notify(active_event);
+    };
+};
+
+
+/*
+* Takes its time over the slow events.
+*/
+class SlowReceiver : public EventReceiver {
+  public:
+    uint32_t seen = 0;
+
+    SlowReceiver() : EventReceiver("SlowReceiver") {};
+
+    int8_t notify(ManuvrMsg* active_event) {
+      if (SCHED_SLOW_MSG_CODE == active_event->eventCode()) {
+        const unsigned long t0 = micros();
+        while ((micros() - t0) < SLOW_WORK_US) {}
+        seen++;
+        return 1;
+      }
+      return EventReceiver::notify(active_event);
+    };
+};
+
+
+RecordingReceiver recorder;
+SlowReceiver      slowpoke;
+
+
+static void raise_test(uint32_t seq, uint8_t priority, uint32_t due_in) {
+  ManuvrMsg* event = Kernel::returnEvent(SCHED_TEST_MSG_CODE);
+  event->addArg(seq);
+  event->priority(priority);
+  if (due_in) event->deadlineIn(due_in);
+  Kernel::staticRaiseEvent(event);
+}
+
+static void raise_slow(uint8_t priority) {
+  ManuvrMsg* event = Kernel::returnEvent(SCHED_SLOW_MSG_CODE);
+  event->priority(priority);
+  Kernel::staticRaiseEvent(event);
+}
+
+static void drain() {
+  while (0 < platform.kernel()->queueSize()) platform.kernel()->procIdleFlags();
+}
+
+/* Puts the policy back the way the Kernel starts. */
+static void restore_policy() {
+  Kernel* kernel = platform.kernel();
+  const uint32_t budgets[KERNEL_SCHED_BANDS] = { 300, 600, 800, KERNEL_SCHED_LOOP_BUDGET_US };
+  for (uint8_t b = 0; b < KERNEL_SCHED_BANDS; b++) kernel->bandBudget(b, budgets[b]);
+  kernel->maxEventsPerLoop(2);
+  kernel->loopBudget(KERNEL_SCHED_LOOP_BUDGET_US);
+  kernel->agingLimit(KERNEL_SCHED_AGING_US);
+  kernel->deadlineSlack(KERNEL_SCHED_DEADLINE_SLACK_US);
+  recorder.schedBudget(0);
+  slowpoke.schedBudget(0);
+  recorder.seen = 0;
+  slowpoke.seen = 0;
+}
+
+static bool order_is(const uint32_t* expected, uint32_t count, StringBuilder* log) {
+  bool ok = (recorder.seen == count);
+  for (uint32_t i = 0; ok && (i < count); i++) ok = (recorder.seq_log[i] == expected[i]);
+  if (!ok) {
+    log->concatf("Expected %u events in order:", count);
+    for (uint32_t i = 0; i < count; i++) log->concatf(" %u", expected[i]);
+    log->concatf("\nSaw %u:", recorder.seen);
+    for (uint32_t i = 0; (i < recorder.seen) && (i < SCHED_LOG_DEPTH); i++) log->concatf(" %u", recorder.seq_log[i]);
+    log->concat("\n");
+  }
+  return ok;
+}
+
+
+/*
+* Setup.
+*/
+int SCHED_SETUP(StringBuilder* log) {
+  printf("===< SCHED_SETUP >===============================================\n");
+  if (0 != ManuvrMsg::registerMessage(SCHED_TEST_MSG_CODE, 0, "SCHED_TEST", SCHED_TEST_FORMS, nullptr)) {
+    log->concat("Failed to register the test message.\n");
+    return -1;
+  }
+  if (0 != ManuvrMsg::registerMessage(SCHED_SLOW_MSG_CODE, 0, "SCHED_SLOW", SCHED_TEST_FORMS, nullptr)) {
+    log->concat("Failed to register the slow message.\n");
+    return -1;
+  }
+  Kernel* kernel = platform.kernel();
+  if ((0 != Kernel::schedBand(EVENT_PRIORITY_LOWEST)) || (1 != Kernel::schedBand(EVENT_PRIORITY_DEFAULT)) ||
+      (2 != Kernel::schedBand(5)) || (3 != Kernel::schedBand(EVENT_PRIORITY_HIGHEST)) || (3 != Kernel::schedBand(255))) {
+    log->concat("Priorities fall in the wrong bands.\n");
+    return -1;
+  }
+  if ((-1 != kernel->bandBudget(KERNEL_SCHED_BANDS, 5)) || (0 != kernel->bandBudget(KERNEL_SCHED_BANDS))) {
+    log->concat("Kernel accepted a budget for a band that doesn't exist.\n");
+    return -1;
+  }
+  kernel->subscribe(&recorder);
+  kernel->subscribe(&slowpoke);
+  drain();
+  restore_policy();
+  return 0;
+}
+
+
+/*
+* Within a priority, deadlines come first, earliest first. Everything else
+*   is FIFO behind them.
+*/
+int SCHED_DEADLINE_ORDER(StringBuilder* log) {
+  printf("===< SCHED_DEADLINE_ORDER >======================================\n");
+  raise_test(0, EVENT_PRIORITY_DEFAULT, 0);
+  raise_test(1, EVENT_PRIORITY_DEFAULT, 900000);
+  raise_test(2, EVENT_PRIORITY_DEFAULT, 0);
+  raise_test(3, EVENT_PRIORITY_DEFAULT, 300000);
+  raise_test(4, EVENT_PRIORITY_DEFAULT, 600000);
+  raise_test(5, EVENT_PRIORITY_DEFAULT, 300000);
+  raise_test(6, EVENT_PRIORITY_DEFAULT + 1, 0);   // Higher priority still wins.
+  drain();
+  const uint32_t expected[] = { 6, 3, 5, 4, 1, 0, 2 };
+  int ret = order_is(expected, 7, log) ? 0 : -1;
+  restore_policy();
+  return ret;
+}
+
+
+/*
+* A band with no budget defers to bands that have some, unless its Msg is
+*   nearly due.
+*/
+int SCHED_DEADLINE_FORCE(StringBuilder* log) {
+  printf("===< SCHED_DEADLINE_FORCE >======================================\n");
+  Kernel* kernel = platform.kernel();
+  kernel->bandBudget(Kernel::schedBand(EVENT_PRIORITY_DEFAULT), 0);
+  kernel->maxEventsPerLoop(1);
+  raise_test(0, EVENT_PRIORITY_LOWEST, 0);
+  raise_test(1, EVENT_PRIORITY_DEFAULT, 0);
+  raise_test(2, EVENT_PRIORITY_DEFAULT, 1);        // Nearly due. Jumps the background band.
+  raise_test(3, EVENT_PRIORITY_LOWEST, 0);
+  drain();
+  // 2 is forced. Then the background band has budget and the default band has none.
+  const uint32_t expected[] = { 2, 0, 3, 1 };
+  int ret = order_is(expected, 4, log) ? 0 : -1;
+  restore_policy();
+  return ret;
+}
+
+
+/*
+* Once a loop is spent, a nearly-due Msg still runs, whether or not its band
+*   has budget. But only so many of them, or the loop would never end.
+*/
+int SCHED_DEADLINE_SPENT(StringBuilder* log) {
+  printf("===< SCHED_DEADLINE_SPENT >======================================\n");
+  Kernel* kernel = platform.kernel();
+  kernel->maxEventsPerLoop(1);
+  raise_test(0, EVENT_PRIORITY_DEFAULT, 0);
+  raise_test(1, EVENT_PRIORITY_LOWEST, 1);         // Nearly due, and its band has budget.
+  const int with_one = kernel->procIdleFlags();
+  drain();
+  raise_test(2, EVENT_PRIORITY_DEFAULT, 0);
+  for (uint32_t i = 0; i < (KERNEL_SCHED_FORCED_PER_LOOP + 3); i++) {
+    raise_test(3 + i, EVENT_PRIORITY_LOWEST, 1);
+  }
+  const int with_many = kernel->procIdleFlags();
+  drain();
+  int ret = -1;
+  if (2 == with_one) {
+    if ((1 + KERNEL_SCHED_FORCED_PER_LOOP) == with_many) {
+      if ((6 + KERNEL_SCHED_FORCED_PER_LOOP) == recorder.seen) {
+        ret = 0;
+      }
+      else log->concatf("Recorder saw %u events.\n", recorder.seen);
+    }
+    else log->concatf("A spent loop should have run %d due events, but ran %d.\n", KERNEL_SCHED_FORCED_PER_LOOP, with_many - 1);
+  }
+  else log->concatf("The due event should have run in the spent loop, but the loop ran %d events.\n", with_one);
+  restore_policy();
+  return ret;
+}
+
+
+/*
+* A band without budget is served once it has waited long enough, even while
+*   a band with budget always has work.
+*/
+int SCHED_AGING(StringBuilder* log) {
+  printf("===< SCHED_AGING >===============================================\n");
+  Kernel* kernel = platform.kernel();
+  const uint32_t AGING_US = 5000;
+  kernel->bandBudget(Kernel::schedBand(EVENT_PRIORITY_LOWEST), 0);
+  kernel->agingLimit(AGING_US);
+  recorder.mark_seen_at = 0;
+  raise_test(MARK_SEQ, EVENT_PRIORITY_LOWEST, 0);
+  const uint32_t t0 = (uint32_t) micros();
+  uint32_t seq = 0;
+  while (0 == recorder.mark_seen_at) {
+    if (((uint32_t) micros() - t0) > 1000000) break;
+    while (kernel->queueSize() < 4) raise_test(seq++, EVENT_PRIORITY_DEFAULT, 0);
+    kernel->procIdleFlags();
+  }
+  const uint32_t waited = recorder.mark_seen_at - t0;
+  const bool ran = (0 != recorder.mark_seen_at);
+  drain();
+  int ret = -1;
+  if (ran) {
+    // The band's clock started when it was last seen empty, a little before t0.
+    if (waited >= (AGING_US / 2)) {
+      printf("\t Background event ran after %u us, with %u default events ahead of it.\n", waited, seq);
+      ret = 0;
+    }
+    else log->concatf("Background event ran after only %u us. It should have waited.\n", waited);
+  }
+  else log->concat("Background event never ran.\n");
+  restore_policy();
+  return ret;
+}
+
+
+/*
+* A receiver over its budget ends the loop.
+*/
+int SCHED_RECEIVER_BUDGET(StringBuilder* log) {
+  printf("===< SCHED_RECEIVER_BUDGET >=====================================\n");
+  Kernel* kernel = platform.kernel();
+  kernel->maxEventsPerLoop(0);
+  kernel->loopBudget(100000);
+  for (int i = 0; i < 4; i++) raise_slow(EVENT_PRIORITY_DEFAULT);
+  const int unlimited = kernel->procIdleFlags();
+  drain();
+  slowpoke.schedBudget(SLOW_WORK_US / 2);
+  for (int i = 0; i < 4; i++) raise_slow(EVENT_PRIORITY_DEFAULT);
+  const int limited = kernel->procIdleFlags();
+  drain();
+  int ret = -1;
+  if (4 == unlimited) {
+    if (1 == limited) {
+      if (8 == slowpoke.seen) {
+        ret = 0;
+      }
+      else log->concatf("Slow receiver saw %u of 8 events.\n", slowpoke.seen);
+    }
+    else log->concatf("Over-budget receiver should have ended the loop, but it ran %d events.\n", limited);
+  }
+  else log->concatf("Loop should have run 4 events, but ran %d.\n", unlimited);
+  restore_policy();
+  return ret;
+}
+
+
+/*
+* With no event limit, one loop runs everything. The count it returns is
+*   clamped, and must not wrap negative.
+*/
+int SCHED_LONG_LOOP(StringBuilder* log) {
+  printf("===< SCHED_LONG_LOOP >===========================================\n");
+  Kernel* kernel = platform.kernel();
+  kernel->maxEventsPerLoop(0);
+  kernel->loopBudget(1000000);
+  recorder.seen = 0;
+  for (uint32_t i = 0; i < LONG_LOOP_EVENTS; i++) raise_test(i, EVENT_PRIORITY_DEFAULT, 0);
+  const int ran = kernel->procIdleFlags();
+  const int left = kernel->queueSize();
+  drain();
+  int ret = -1;
+  if (LONG_LOOP_EVENTS == recorder.seen) {
+    if (0 == left) {
+      if (127 == ran) {
+        ret = 0;
+      }
+      else log->concatf("Loop ran %u events, but returned %d.\n", LONG_LOOP_EVENTS, ran);
+    }
+    else log->concatf("%d events were left for the next loop.\n", left);
+  }
+  else log->concatf("Recorder saw %u of %u events.\n", recorder.seen, LONG_LOOP_EVENTS);
+  restore_policy();
+  return ret;
+}
+
+
+/*
+* Keeps the slow receiver busy at a raised priority, and trickles cheap
+*   events at the default priority. Returns the worst wait of the trickle,
+*   in uS, or zero if it didn't finish in the given time.
+*/
+uint32_t trickle_behind_flood(uint32_t* slow_done, uint32_t limit_us) {
+  Kernel* kernel = platform.kernel();
+  recorder.seen = 0;
+  slowpoke.seen = 0;
+  uint32_t raised = 0;
+  uint32_t raised_at = 0;
+  uint32_t worst = 0;
+  uint32_t last_seen = 0;
+  const uint32_t t0 = (uint32_t) micros();
+  while (recorder.seen < TRICKLE_EVENTS) {
+    if (((uint32_t) micros() - t0) > limit_us) break;
+    while (kernel->queueSize() < FLOOD_DEPTH) raise_slow(5);
+    if (raised == recorder.seen) {
+      raise_test(raised++, EVENT_PRIORITY_DEFAULT, 0);
+      raised_at = (uint32_t) micros();
+    }
+    kernel->procIdleFlags();
+    if (recorder.seen != last_seen) {
+      last_seen = recorder.seen;
+      const uint32_t waited = recorder.last_seen_at - raised_at;
+      if (waited > worst) worst = waited;
+    }
+  }
+  *slow_done = slowpoke.seen;
+  drain();
+  return (recorder.seen < TRICKLE_EVENTS) ? 0 : worst;
+}
+
+
+/*
+* Strict priority, then the default policy.
+*/
+int SCHED_STARVATION(StringBuilder* log) {
+  printf("===< SCHED_STARVATION >==========================================\n");
+  Kernel* kernel = platform.kernel();
+  // Budgets big enough to never run out, and no aging, is strict priority.
+  for (uint8_t b = 0; b < KERNEL_SCHED_BANDS; b++) kernel->bandBudget(b, 0xFFFFFFFF);
+  kernel->agingLimit(0);
+  uint32_t strict_slow  = 0;
+  const uint32_t strict = trickle_behind_flood(&strict_slow, 500000);
+  restore_policy();
+  uint32_t policy_slow  = 0;
+  const uint32_t policy = trickle_behind_flood(&policy_slow, 5000000);
+
+  if (strict) {
+    printf("\t Strict priority: worst wait %8u us (%u slow events ran meanwhile).\n", strict, strict_slow);
+  }
+  else {
+    printf("\t Strict priority: starved. %u slow events ran in 500 ms.\n", strict_slow);
+  }
+  printf("\t Default policy:  worst wait %8u us (%u slow events ran meanwhile).\n", policy, policy_slow);
+  StringBuilder output;
+  kernel->printSchedPolicy(&output);
+  printf("%s\n", (char*) output.string());
+
+  if (0 == policy) {
+    log->concat("The trickle never finished under the default policy.\n");
+    return -1;
+  }
+  if (policy > (4 * SLOW_WORK_US * FLOOD_DEPTH)) {
+    log->concatf("The trickle waited %u us under the default policy.\n", policy);
+    return -1;
+  }
+  return 0;
+}
+
+
+void printTestFailure(const char* test) {
+  printf("\n");
+  printf("*********************************************\n");
+  printf("* %s FAILED tests.\n", test);
+  printf("*********************************************\n");
+}
+
+
+/****************************************************************************************************
+* The main function.                                                                                *
+****************************************************************************************************/
+int main(int argc, char *argv[]) {
+  int exit_value = 1;   // Failure is the default result.
+  StringBuilder log;
+
+  platform.platformPreInit();
+  platform.bootstrap();
+
+  if (0 == SCHED_SETUP(&log)) {
+    if (0 == SCHED_DEADLINE_ORDER(&log)) {
+      if ((0 == SCHED_DEADLINE_FORCE(&log)) && (0 == SCHED_DEADLINE_SPENT(&log))) {
+        if (0 == SCHED_AGING(&log)) {
+          if (0 == SCHED_RECEIVER_BUDGET(&log)) {
+            if (0 == SCHED_LONG_LOOP(&log)) {
+              if (0 == SCHED_STARVATION(&log)) {
+                printf("**********************************\n");
+                printf("*  Kernel scheduling tests pass  *\n");
+                printf("**********************************\n");
+                exit_value = 0;
+              }
+              else printTestFailure("SCHED_STARVATION");
+            }
+            else printTestFailure("SCHED_LONG_LOOP");
+          }
+          else printTestFailure("SCHED_RECEIVER_BUDGET");
+        }
+        else printTestFailure("SCHED_AGING");
+      }
+      else printTestFailure("SCHED_DEADLINE_FORCE or SCHED_DEADLINE_SPENT");
+    }
+    else printTestFailure("SCHED_DEADLINE_ORDER");
+  }
+  else printTestFailure("SCHED_SETUP");
+
+  if (log.length() > 0) printf("%s\n", (char*) log.string());
+  exit(exit_value);
+}
@@ -0,0 +1,343 @@
+/*
+File:   LinuxI2CTest.cpp
+Author: J. Ian Lindsay
+Date:   2026.10.18
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Tests for the linux i2c backend. An adapter is attached to the Kernel with an
+  I2CFakeBus in place of /dev/i2c-N, so ops go through the worker thread and
+  the same I2C_RDWR message arrays as they would on hardware.
+
+After the tests, reads are pushed through with batching disabled and enabled,
+  for comparison. The fake bus spins for a while on each transfer, to stand in
+  for the syscall and bus turnaround that batching saves.
+*/
+
+#include <cstdio>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Platform/Platform.h>
+#include <Platform/Targets/Linux/I2C/LinuxI2C.h>
+
+#define TEST_BUS_ID       2
+#define DEV_ADDR_A        0x40
+#define DEV_ADDR_B        0x41
+#define DEV_ADDR_ABSENT   0x55
+#define WAIT_LIMIT_US     5000000
+#define BENCH_OPS         4000
+#define BENCH_XFER_US     50
+
+static I2CFakeBus fake;
+static I2CAdapter* adapter = nullptr;
+
+
+/*
+* A device that issues raw reads and writes, and keeps score of how they went.
+*/
+class ProbeDevice : public I2CDevice {
+  public:
+    uint32_t ok      = 0;
+    uint32_t faults  = 0;
+    uint32_t order   = 0;   // Incremented per completion.
+    uint8_t  last_sub = 0;
+    bool     in_order = true;
+    uint8_t  bufs[64][4];
+
+    ProbeDevice(uint8_t addr) : I2CDevice(addr) {};
+
+    bool read(uint8_t sub, uint8_t* buf, uint8_t len) {   return readX(sub, len, buf);  };
+    bool write(uint8_t sub, uint8_t* buf, uint8_t len) {  return writeX(sub, len, buf); };
+
+    int8_t io_op_callback(BusOp* _op) {
+      I2CBusOp* op = (I2CBusOp*) _op;
+      if (op->hasFault()) {
+        faults++;
+      }
+      else {
+        ok++;
+      }
+      // Ops in these tests are issued with ascending sub-addresses.
+      if ((order > 0) && ((uint8_t) op->sub_addr < last_sub)) in_order = false;
+      last_sub = (uint8_t) op->sub_addr;
+      order++;
+      op->buf     = nullptr;   // Not the adapter's to free.
+      op->buf_len = 0;
+      return 0;
+    };
+
+    void reset() {  ok = faults = order = 0;  last_sub = 0;  in_order = true;  };
+};
+
+
+/*
+* Runs the Kernel once, and gives the worker the CPU if that was idle.
+*/
+static void pump() {
+  if (0 == platform.kernel()->procIdleFlags()) {
+    yieldThread();
+  }
+}
+
+
+/*
+* Runs the Kernel until the devices have seen the given number of completions.
+*/
+static bool pump_until(ProbeDevice* a, ProbeDevice* b, uint32_t count) {
+  const uint32_t t0 = (uint32_t) micros();
+  while (((a->order + ((nullptr != b) ? b->order : 0)) < count) && (((uint32_t) micros() - t0) < WAIT_LIMIT_US)) {
+    pump();
+  }
+  return ((a->order + ((nullptr != b) ? b->order : 0)) >= count);
+}
+
+
+/*
+* Bring up the adapter on the fake bus.
+*/
+int test_Setup(StringBuilder* log) {
+  log->concat("===< SETUP >============================================\n");
+  if ((0 != fake.addDevice(DEV_ADDR_A, 64)) || (0 != fake.addDevice(DEV_ADDR_B, 64))) {
+    log->concat("Couldn't add devices to the fake bus.\n");
+    return -1;
+  }
+  LinuxI2CBus* bus = LinuxI2CBus::bus(TEST_BUS_ID);
+  if ((nullptr == bus) || (nullptr != LinuxI2CBus::bus(I2C_LINUX_MAX_ADAPTERS))) {
+    log->concat("Bus lookup is wrong.\n");
+    return -1;
+  }
+  bus->fake = &fake;
+  I2CAdapterOptions opts(TEST_BUS_ID, 0, 0);
+  adapter = new I2CAdapter(&opts);
+  platform.kernel()->subscribe(adapter);
+  if (!adapter->busOnline()) {
+    log->concat("The adapter didn't come up on the fake bus.\n");
+    return -1;
+  }
+  log->concat("\tPASS.\n");
+  return 0;
+}
+
+
+/*
+* Writes land in the register file, and reads come back in order, including a
+*   read that follows a write to the same register.
+*/
+int test_RoundTrip(StringBuilder* log) {
+  log->concat("===< ROUND TRIP >=======================================\n");
+  ProbeDevice dev(DEV_ADDR_A);
+  adapter->addSlaveDevice(&dev);
+  int ret = -1;
+
+  uint8_t* regs = fake.registers(DEV_ADDR_A);
+  for (uint8_t i = 0; i < 64; i++) regs[i] = i ^ 0x5A;
+  uint8_t wbuf[4] = {0xDE, 0xAD, 0xBE, 0xEF};
+
+  const uint32_t xfers_before = fake.transfers();
+  for (uint8_t i = 0; i < 16; i++) {
+    if (8 == i) {
+      dev.write(0x20, wbuf, 4);
+      dev.read(0x20, dev.bufs[i], 4);    // Must see what was just written.
+    }
+    else {
+      dev.read(i << 2, dev.bufs[i], 4);
+    }
+  }
+  if (!pump_until(&dev, nullptr, 17)) {
+    log->concatf("Only %u of 17 ops completed.\n", dev.order);
+  }
+  else if ((17 != dev.ok) || !dev.in_order) {
+    log->concatf("%u ok, %u faults, %sin order.\n", dev.ok, dev.faults, dev.in_order ? "" : "not ");
+  }
+  else if (0 != memcmp(&regs[0x20], wbuf, 4)) {
+    log->concat("The write didn't reach the register file.\n");
+  }
+  else {
+    ret = 0;
+    for (uint8_t i = 0; i < 16; i++) {
+      const uint8_t* expect = (8 == i) ? wbuf : &regs[i << 2];
+      if (0 != memcmp(dev.bufs[i], expect, 4)) {
+        log->concatf("Read %u came back wrong.\n", i);
+        ret = -1;
+      }
+    }
+    log->concatf("\t17 ops in %u transfers.\n", fake.transfers() - xfers_before);
+  }
+  adapter->removeSlaveDevice(&dev);
+  if (0 == ret) log->concat("\tPASS.\n");
+  return ret;
+}
+
+
+/*
+* A batch holding an op for an absent device must fail only that op.
+*/
+int test_FaultIsolation(StringBuilder* log) {
+  log->concat("===< FAULT ISOLATION >==================================\n");
+  ProbeDevice good(DEV_ADDR_B);
+  ProbeDevice absent(DEV_ADDR_ABSENT);
+  adapter->addSlaveDevice(&good);
+  adapter->addSlaveDevice(&absent);
+  int ret = -1;
+
+  fake.transferCost = 200;   // Keep the worker busy, so that batches form.
+  for (uint8_t i = 0; i < 12; i++) {
+    if (5 == i) {
+      absent.read(i, absent.bufs[i], 2);
+    }
+    else {
+      good.read(i, good.bufs[i], 2);
+    }
+  }
+  if (!pump_until(&good, &absent, 12)) {
+    log->concatf("Only %u of 12 ops completed.\n", good.order + absent.order);
+  }
+  else if ((11 != good.ok) || (0 != good.faults) || (1 != absent.faults) || (0 != absent.ok)) {
+    log->concatf("Good device: %u ok, %u faults. Absent device: %u ok, %u faults.\n", good.ok, good.faults, absent.ok, absent.faults);
+  }
+  else {
+    ret = 0;
+  }
+  fake.transferCost = 0;
+  adapter->removeSlaveDevice(&good);
+  adapter->removeSlaveDevice(&absent);
+  if (0 == ret) log->concat("\tPASS.\n");
+  return ret;
+}
+
+
+/*
+* A device removed from the bus with ops in the worker's hands must not be
+*   called back, and the bus must carry on for everyone else.
+*/
+int test_DetachInFlight(StringBuilder* log) {
+  log->concat("===< DETACH IN FLIGHT >=================================\n");
+  ProbeDevice leaving(DEV_ADDR_B);
+  ProbeDevice staying(DEV_ADDR_A);
+  adapter->addSlaveDevice(&leaving);
+  adapter->addSlaveDevice(&staying);
+  int ret = -1;
+
+  fake.transferCost = 2000;   // Long enough that the ops are still in flight.
+  const uint32_t xfers_before = fake.transfers();
+  for (uint8_t i = 0; i < 6; i++) {
+    leaving.read(i, leaving.bufs[i], 2);
+  }
+  // Wait for the worker to finish something, without running the Kernel. What
+  //   it finished hasn't been called back, and it may be busy with the rest.
+  const uint32_t t0 = (uint32_t) micros();
+  while ((fake.transfers() == xfers_before) && (((uint32_t) micros() - t0) < WAIT_LIMIT_US)) {
+    yieldThread();
+  }
+  adapter->removeSlaveDevice(&leaving);
+  const uint32_t seen = leaving.order;
+  fake.transferCost = 0;
+
+  staying.read(0, staying.bufs[0], 2);
+  if (!pump_until(&staying, nullptr, 1)) {
+    log->concat("The bus stalled after the device was removed.\n");
+  }
+  else if (seen != leaving.order) {
+    log->concatf("The removed device was called back %u times.\n", leaving.order - seen);
+  }
+  else if (1 != staying.ok) {
+    log->concat("The remaining device's read failed.\n");
+  }
+  else {
+    log->concatf("\t%u transfers, and no call-backs after the device left.\n", fake.transfers() - xfers_before);
+    ret = 0;
+  }
+  adapter->removeSlaveDevice(&staying);
+  if (0 == ret) log->concat("\tPASS.\n");
+  return ret;
+}
+
+
+/*
+* Pushes reads through with the given batch limit.
+*/
+static int bench_run(ProbeDevice* dev, uint8_t max_batch, uint32_t* xfers, uint32_t* us) {
+  LinuxI2CBus::bus(TEST_BUS_ID)->maxBatch = max_batch;
+  dev->reset();
+  const uint32_t xfers_before = fake.transfers();
+  const uint32_t t0 = (uint32_t) micros();
+  uint32_t issued = 0;
+  while (issued < BENCH_OPS) {
+    // Keep the queue fed without flooding it.
+    while ((issued < BENCH_OPS) && ((issued - dev->order) < I2CADAPTER_MAX_QUEUE_DEPTH)) {
+      dev->read((uint8_t) (issued & 0x3F), dev->bufs[issued & 0x3F], 2);
+      issued++;
+    }
+    pump();
+  }
+  if (!pump_until(dev, nullptr, BENCH_OPS)) return -1;
+  *us    = (uint32_t) micros() - t0;
+  *xfers = fake.transfers() - xfers_before;
+  return (BENCH_OPS == dev->ok) ? 0 : -1;
+}
+
+
+int bench_Batching(StringBuilder* log) {
+  log->concat("===< BENCHMARK: BATCHING >==============================\n");
+  ProbeDevice dev(DEV_ADDR_A);
+  adapter->addSlaveDevice(&dev);
+  fake.transferCost = BENCH_XFER_US;
+
+  uint32_t xfers[2];
+  uint32_t us[2];
+  int ret = bench_run(&dev, 1, &xfers[0], &us[0]);
+  if (0 == ret) ret = bench_run(&dev, I2C_LINUX_MAX_BATCH, &xfers[1], &us[1]);
+  fake.transferCost = 0;
+  adapter->removeSlaveDevice(&dev);
+  if (0 != ret) {
+    log->concat("Not every op completed.\n");
+    return -1;
+  }
+
+  log->concatf("\t%d reads, %uus per transfer.\n", BENCH_OPS, BENCH_XFER_US);
+  log->concatf("\t%-12s %10s %12s %10s\n", "", "transfers", "ops/xfer", "ops/s");
+  for (int i = 0; i < 2; i++) {
+    log->concatf("\t%-12s %10u %12.2f %10u\n",
+      (0 == i) ? "Batch of 1" : "Batched",
+      xfers[i],
+      (double) BENCH_OPS / (double) xfers[i],
+      (uint32_t) (((uint64_t) BENCH_OPS * 1000000) / us[i])
+    );
+  }
+  if (xfers[1] >= xfers[0]) {
+    log->concat("Batching didn't reduce the transfer count.\n");
+    return -1;
+  }
+  adapter->printHardwareState(log);
+  return 0;
+}
+
+
+int main(int argc, char *argv[]) {
+  int exit_value = 1;   // Failure is the default result.
+  platform.platformPreInit();
+  platform.bootstrap();
+
+  StringBuilder log("===< Linux i2c >========================================\n");
+  if ((0 == test_Setup(&log)) && (0 == test_RoundTrip(&log)) && (0 == test_FaultIsolation(&log)) && (0 == test_DetachInFlight(&log))) {
+    if (0 == bench_Batching(&log)) {
+      exit_value = 0;
+    }
+  }
+  printf("%s\n", (const char*) log.string());
+  exit(exit_value);
+}
@@ -0,0 +1,391 @@
+/*
+File:   LinuxSPITest.cpp
+Author: J. Ian Lindsay
+Date:   2026.10.18
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Tests for the linux SPI backend. An adapter is attached to the Kernel with an
+  SPIFakeBus in place of /dev/spidevB.C, so ops go through the worker thread
+  and the same spi_ioc_transfer arrays as they would on hardware.
+
+After the tests, reads are pushed through with chaining disabled and enabled,
+  for comparison. The fake bus spins for a while on each transfer, to stand in
+  for the syscall that chaining saves.
+*/
+
+#include <cstdio>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Platform/Platform.h>
+#include <Platform/Targets/Linux/SPI/LinuxSPI.h>
+
+#define TEST_BUS_ID       1
+#define CS_REGS           0
+#define CS_LOOP           1
+#define CS_ABSENT         3
+#define WAIT_LIMIT_US     5000000
+#define BENCH_OPS         4000
+#define BENCH_XFER_US     50
+#define BENCH_WINDOW      12
+
+static SPIFakeBus fake;
+static SPIAdapter* adapter = nullptr;
+
+
+/*
+* A device that issues raw ops, and keeps score of how they went.
+*/
+class ProbeDevice : public BusOpCallback {
+  public:
+    uint32_t ok       = 0;
+    uint32_t faults   = 0;
+    uint32_t order    = 0;   // Incremented per completion.
+    int      last_idx = -1;
+    bool     in_order = true;
+    uint8_t  bufs[64][8];
+
+    int8_t io_op_callahead(BusOp* op) {  return 0;  };
+    int8_t queue_io_job(BusOp* op) {     return adapter->queue_io_job(op);  };
+
+    int8_t io_op_callback(BusOp* _op) {
+      SPIBusOp* op = (SPIBusOp*) _op;
+      if (op->hasFault()) {
+        faults++;
+      }
+      else {
+        ok++;
+      }
+      // Ops that use bufs are issued in ascending order of index.
+      if ((op->buf >= &bufs[0][0]) && (op->buf < &bufs[64][0])) {
+        const int idx = (op->buf - &bufs[0][0]) / 8;
+        if (idx <= last_idx) in_order = false;
+        last_idx = idx;
+      }
+      order++;
+      return SPI_CALLBACK_NOMINAL;
+    };
+
+    /* Queues an op on the given CS. */
+    int8_t issue(BusOpcode opcode, uint8_t cs, int16_t param, uint8_t* buf, uint16_t len) {
+      SPIBusOp* op = adapter->new_op(opcode, this);
+      op->setCSPin(cs);
+      if (param >= 0) op->setParams((uint8_t) param);
+      op->setBuffer(buf, len);
+      return queue_io_job(op);
+    };
+
+    void reset() {  ok = faults = order = 0;  last_idx = -1;  in_order = true;  };
+};
+
+
+/*
+* Runs the Kernel once, and gives the worker the CPU if that was idle.
+*/
+static void pump() {
+  if (0 == platform.kernel()->procIdleFlags()) {
+    yieldThread();
+  }
+}
+
+
+/*
+* Runs the Kernel until the device has seen the given number of completions.
+*/
+static bool pump_until(ProbeDevice* dev, uint32_t count) {
+  const uint32_t t0 = (uint32_t) micros();
+  while ((dev->order < count) && (((uint32_t) micros() - t0) < WAIT_LIMIT_US)) {
+    pump();
+  }
+  return (dev->order >= count);
+}
+
+
+/*
+* Bring up the adapter on the fake bus.
+*/
+int test_Setup(StringBuilder* log) {
+  log->concat("===< SETUP >============================================\n");
+  if ((0 != fake.addDevice(CS_REGS, 64)) || (0 != fake.addLoopback(CS_LOOP)) || (0 == fake.addLoopback(CS_LOOP))) {
+    log->concat("Couldn't add devices to the fake bus.\n");
+    return -1;
+  }
+  LinuxSPIBus* bus = LinuxSPIBus::bus(TEST_BUS_ID);
+  if ((nullptr == bus) || (nullptr != LinuxSPIBus::bus(SPI_LINUX_MAX_ADAPTERS))) {
+    log->concat("Bus lookup is wrong.\n");
+    return -1;
+  }
+  bus->fake = &fake;
+  SPIAdapterOpts opts(TEST_BUS_ID, 255, 255, 255);
+  adapter = new SPIAdapter(&opts);
+  platform.kernel()->subscribe(adapter);
+  if (!adapter->busOnline() || (bus != LinuxSPIBus::active())) {
+    log->concat("The adapter didn't come up on the fake bus.\n");
+    return -1;
+  }
+  log->concat("\tPASS.\n");
+  return 0;
+}
+
+
+/*
+* Pool buffers are aligned, distinct, and come back when given.
+*/
+int test_BufferPool(StringBuilder* log) {
+  log->concat("===< BUFFER POOL >======================================\n");
+  SPIBufferPool* pool = &LinuxSPIBus::bus(TEST_BUS_ID)->pool;
+  const uint8_t before = pool->available();
+  uint8_t* taken[SPI_LINUX_POOL_SLOTS];
+  uint8_t n = 0;
+  while (nullptr != (taken[n] = pool->take())) {
+    if (0 != ((uintptr_t) taken[n] % SPI_LINUX_BUF_ALIGN)) {
+      log->concatf("Slot %u is misaligned.\n", n);
+      return -1;
+    }
+    n++;
+  }
+  int ret = 0;
+  if (n != before) {
+    log->concatf("Took %u buffers, but %u were free.\n", n, before);
+    ret = -1;
+  }
+  else if ((n > 1) && (taken[0] == taken[1])) {
+    log->concat("The same slot was taken twice.\n");
+    ret = -1;
+  }
+  uint8_t not_ours[8];
+  pool->give(not_ours);
+  pool->give(taken[0] + 1);
+  while (n > 0) pool->give(taken[--n]);
+  if (before != pool->available()) {
+    log->concatf("%u buffers free after returning them all (expected %u).\n", pool->available(), before);
+    ret = -1;
+  }
+  if (0 == ret) log->concat("\tPASS.\n");
+  return ret;
+}
+
+
+/*
+* A write lands in the register file, and a read of the same registers brings
+*   it back. Then a burst of reads comes back in order.
+*/
+int test_RoundTrip(StringBuilder* log) {
+  log->concat("===< ROUND TRIP >=======================================\n");
+  ProbeDevice dev;
+  SPIBufferPool* pool = &LinuxSPIBus::bus(TEST_BUS_ID)->pool;
+  uint8_t* wbuf = pool->take();
+  uint8_t* rbuf = pool->take();
+  int ret = -1;
+  if ((nullptr == wbuf) || (nullptr == rbuf)) {
+    log->concat("Couldn't take buffers from the pool.\n");
+    return -1;
+  }
+
+  uint8_t* regs = fake.registers(CS_REGS);
+  for (uint8_t i = 0; i < 64; i++) regs[i] = i ^ 0x5A;
+  for (uint8_t i = 0; i < 8; i++) wbuf[i] = 0xA0 + i;
+  memset(rbuf, 0, 8);
+
+  const uint32_t xfers_before = fake.transfers();
+  dev.issue(BusOpcode::TX, CS_REGS, 0x10, wbuf, 8);
+  dev.issue(BusOpcode::RX, CS_REGS, 0x80 | 0x10, rbuf, 8);   // Must see what was just written.
+  for (uint8_t i = 0; i < 12; i++) {
+    dev.issue(BusOpcode::RX, CS_REGS, 0x80 | (0x20 + (i << 1)), dev.bufs[i], 4);
+  }
+  if (!pump_until(&dev, 14)) {
+    log->concatf("Only %u of 14 ops completed.\n", dev.order);
+  }
+  else if ((14 != dev.ok) || !dev.in_order) {
+    log->concatf("%u ok, %u faults, %sin order.\n", dev.ok, dev.faults, dev.in_order ? "" : "not ");
+  }
+  else if (0 != memcmp(&regs[0x10], wbuf, 8)) {
+    log->concat("The write didn't reach the register file.\n");
+  }
+  else if (0 != memcmp(rbuf, wbuf, 8)) {
+    log->concat("The read didn't bring the write back.\n");
+  }
+  else {
+    ret = 0;
+    for (uint8_t i = 0; i < 12; i++) {
+      if (0 != memcmp(dev.bufs[i], &regs[0x20 + (i << 1)], 4)) {
+        log->concatf("Read %u came back wrong.\n", i);
+        ret = -1;
+      }
+    }
+    log->concatf("\t14 ops in %u transfers.\n", fake.transfers() - xfers_before);
+  }
+  pool->give(wbuf);
+  pool->give(rbuf);
+  if (0 == ret) log->concat("\tPASS.\n");
+  return ret;
+}
+
+
+/*
+* Both directions at once. On the loopback, the buffer comes back as it was
+*   sent. On the register file, the address goes out in the first byte, and
+*   the registers come back in the rest.
+*/
+int test_FullDuplex(StringBuilder* log) {
+  log->concat("===< FULL DUPLEX >======================================\n");
+  ProbeDevice dev;
+  uint8_t* regs = fake.registers(CS_REGS);
+  for (uint8_t i = 0; i < 8; i++) {
+    dev.bufs[0][i] = 0x30 + i;
+    dev.bufs[1][i] = 0xFF;
+  }
+  dev.bufs[2][0] = 0x80 | 0x08;
+  memset(&dev.bufs[2][1], 0xFF, 7);
+
+  dev.issue(BusOpcode::TX_WAIT_RX, CS_LOOP, -1, dev.bufs[0], 8);
+  dev.issue(BusOpcode::RX, CS_LOOP, -1, dev.bufs[1], 8);     // Clocks out zeros.
+  dev.issue(BusOpcode::TX_WAIT_RX, CS_REGS, -1, dev.bufs[2], 8);
+  int ret = -1;
+  if (!pump_until(&dev, 3) || (3 != dev.ok)) {
+    log->concatf("%u of 3 ops completed, %u ok.\n", dev.order, dev.ok);
+  }
+  else {
+    ret = 0;
+    for (uint8_t i = 0; i < 8; i++) {
+      if (dev.bufs[0][i] != (0x30 + i)) ret = -1;
+      if (dev.bufs[1][i] != 0)          ret = -1;
+    }
+    if (0 != ret) log->concat("The loopback didn't echo what was sent.\n");
+    if ((0 != dev.bufs[2][0]) || (0 != memcmp(&dev.bufs[2][1], &regs[0x08], 7))) {
+      log->concat("The register file didn't answer in the same transfer.\n");
+      ret = -1;
+    }
+  }
+  if (0 == ret) log->concat("\tPASS.\n");
+  return ret;
+}
+
+
+/*
+* An op for an absent CS, and one too long for the driver, must fail alone.
+*/
+int test_FaultIsolation(StringBuilder* log) {
+  log->concat("===< FAULT ISOLATION >==================================\n");
+  ProbeDevice dev;
+  uint8_t* big = (uint8_t*) malloc(5000);
+  int ret = -1;
+  if (nullptr == big) return -1;
+  memset(big, 0, 5000);
+
+  fake.transferCost = 200;   // Keep the worker busy, so that chains form.
+  for (uint8_t i = 0; i < 12; i++) {
+    if (4 == i) {
+      dev.issue(BusOpcode::RX, CS_ABSENT, 0x80, dev.bufs[i], 2);
+    }
+    else if (8 == i) {
+      dev.issue(BusOpcode::TX, CS_REGS, 0x00, big, 5000);
+    }
+    else {
+      dev.issue(BusOpcode::RX, CS_REGS, 0x80 | i, dev.bufs[i], 2);
+    }
+  }
+  if (!pump_until(&dev, 12)) {
+    log->concatf("Only %u of 12 ops completed.\n", dev.order);
+  }
+  else if ((10 != dev.ok) || (2 != dev.faults) || !dev.in_order) {
+    log->concatf("%u ok, %u faults, %sin order.\n", dev.ok, dev.faults, dev.in_order ? "" : "not ");
+  }
+  else {
+    ret = 0;
+  }
+  fake.transferCost = 0;
+  free(big);
+  if (0 == ret) log->concat("\tPASS.\n");
+  return ret;
+}
+
+
+/*
+* Pushes reads through with the given chain limit.
+*/
+static int bench_run(ProbeDevice* dev, uint8_t max_chain, uint32_t* xfers, uint32_t* us) {
+  LinuxSPIBus::bus(TEST_BUS_ID)->maxChain = max_chain;
+  dev->reset();
+  const uint32_t xfers_before = fake.transfers();
+  const uint32_t t0 = (uint32_t) micros();
+  uint32_t issued = 0;
+  while (issued < BENCH_OPS) {
+    // Keep the queue fed without flooding it.
+    while ((issued < BENCH_OPS) && ((issued - dev->order) < BENCH_WINDOW)) {
+      dev->issue(BusOpcode::RX, CS_REGS, 0x80 | (issued & 0x3F), dev->bufs[issued & 0x3F], 4);
+      issued++;
+    }
+    pump();
+  }
+  if (!pump_until(dev, BENCH_OPS)) return -1;
+  *us    = (uint32_t) micros() - t0;
+  *xfers = fake.transfers() - xfers_before;
+  return (BENCH_OPS == dev->ok) ? 0 : -1;
+}
+
+
+int bench_Chaining(StringBuilder* log) {
+  log->concat("===< BENCHMARK: CHAINING >==============================\n");
+  ProbeDevice dev;
+  fake.transferCost = BENCH_XFER_US;
+
+  uint32_t xfers[2];
+  uint32_t us[2];
+  int ret = bench_run(&dev, 1, &xfers[0], &us[0]);
+  if (0 == ret) ret = bench_run(&dev, SPI_LINUX_MAX_CHAIN, &xfers[1], &us[1]);
+  fake.transferCost = 0;
+  if (0 != ret) {
+    log->concat("Not every op completed.\n");
+    return -1;
+  }
+
+  log->concatf("\t%d reads, %uus per transfer.\n", BENCH_OPS, BENCH_XFER_US);
+  log->concatf("\t%-12s %10s %12s %10s\n", "", "transfers", "ops/xfer", "ops/s");
+  for (int i = 0; i < 2; i++) {
+    log->concatf("\t%-12s %10u %12.2f %10u\n",
+      (0 == i) ? "Chain of 1" : "Chained",
+      xfers[i],
+      (double) BENCH_OPS / (double) xfers[i],
+      (uint32_t) (((uint64_t) BENCH_OPS * 1000000) / us[i])
+    );
+  }
+  if (xfers[1] >= xfers[0]) {
+    log->concat("Chaining didn't reduce the transfer count.\n");
+    return -1;
+  }
+  adapter->printHardwareState(log);
+  return 0;
+}
+
+
+int main(int argc, char *argv[]) {
+  int exit_value = 1;   // Failure is the default result.
+  platform.platformPreInit();
+  platform.bootstrap();
+
+  StringBuilder log("===< Linux SPI >========================================\n");
+  if ((0 == test_Setup(&log)) && (0 == test_BufferPool(&log)) && (0 == test_RoundTrip(&log))) {
+    if ((0 == test_FullDuplex(&log)) && (0 == test_FaultIsolation(&log))) {
+      if (0 == bench_Chaining(&log)) {
+        exit_value = 0;
+      }
+    }
+  }
+  printf("%s\n", (const char*) log.string());
+  exit(exit_value);
+}
@@ -0,0 +1,355 @@
+/*
+File:   LinuxStorageTest.cpp
+Author: J. Ian Lindsay
+Date:   2026.10.18
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Tests for the keyed log that backs LinuxStorage, followed by some timing of
+  a store of about 10MB. Stores are made in a scratch directory under /tmp,
+  which is removed afterward.
+*/
+
+#include <cstdio>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include <Platform/Platform.h>
+#include <Platform/Targets/Linux/LinuxStorage.h>
+
+static char scratch_dir[] = "/tmp/manuvr-storeXXXXXX";
+static char store_path[64];
+
+
+/*
+* Lets us mount the store without a Kernel.
+*/
+class TestStore : public LinuxStorage {
+  public:
+    TestStore(Argument* opts) : LinuxStorage(opts) {};
+    inline int8_t mount() {   return attached();   };
+};
+
+
+static TestStore* _open_store(bool sync_writes = false) {
+  Argument opts(store_path);
+  opts.setKey("store_path");
+  if (sync_writes) {
+    opts.append((uint8_t) 1)->setKey("store_sync");
+  }
+  TestStore* s = new TestStore(&opts);
+  s->mount();
+  return s;
+}
+
+
+/*
+* Is the value for key exactly the given string?
+*/
+static bool _value_is(TestStore* s, const char* key, const char* expected) {
+  uint8_t buf[64];
+  int len = s->persistentRead(key, buf, sizeof(buf), 0);
+  return ((int) strlen(expected) == len) && (0 == memcmp(buf, expected, len));
+}
+
+
+/*
+* Keys are independent, and the null key is a key like any other.
+*/
+int test_Keys(StringBuilder* log) {
+  TestStore* s = _open_store();
+  int ret = -1;
+  if (!s->isMounted()) {
+    log->concatf("Failed to mount %s.\n", store_path);
+  }
+  else if ((5 != s->persistentWrite("alpha", (uint8_t*) "first", 5, 0)) ||
+      (4 != s->persistentWrite("beta", (uint8_t*) "beta", 4, 0)) ||
+      (4 != s->persistentWrite(nullptr, (uint8_t*) "conf", 4, 0)) ||
+      (5 != s->persistentWrite("alpha", (uint8_t*) "again", 5, 0))) {
+    log->concat("A write failed.\n");
+  }
+  else if (!_value_is(s, "alpha", "again") || !_value_is(s, "beta", "beta") || !_value_is(s, nullptr, "conf") || !_value_is(s, "", "conf")) {
+    log->concat("A value read back wrong.\n");
+  }
+  else if (-1 != s->persistentRead("gamma", (uint8_t*) store_path, 1, 0)) {
+    log->concat("Reading an absent key should fail.\n");
+  }
+  else if ((0 != s->persistentWrite("beta", nullptr, 0, 0)) || (-1 != s->persistentRead("beta", (uint8_t*) store_path, 1, 0))) {
+    log->concat("Writing nothing should delete the key.\n");
+  }
+  else if (2 != s->keyCount()) {
+    log->concatf("Store holds %u keys. Expected 2.\n", s->keyCount());
+  }
+  else {
+    log->concat("\tKeys are independent, and can be deleted.\n");
+    ret = 0;
+  }
+  delete s;
+  return ret;
+}
+
+
+/*
+* What was written must be there when the store is reopened.
+*/
+int test_Reopen(StringBuilder* log) {
+  TestStore* s = _open_store();
+  int ret = -1;
+  if ((2 != s->keyCount()) || !_value_is(s, "alpha", "again") || !_value_is(s, nullptr, "conf")) {
+    log->concat("The store came back different after reopening.\n");
+  }
+  else if (-1 != s->persistentRead("beta", (uint8_t*) store_path, 1, 0)) {
+    log->concat("A deleted key came back after reopening.\n");
+  }
+  else {
+    log->concat("\tThe store survives reopening.\n");
+    ret = 0;
+  }
+  delete s;
+  return ret;
+}
+
+
+/*
+* A write that was cut short must cost us that write, and nothing else.
+*/
+int test_TornTail(StringBuilder* log) {
+  TestStore* s = _open_store();
+  s->persistentWrite("torn", (uint8_t*) "intact", 6, 0);
+  const uint32_t good_len = s->logLength();
+  s->persistentWrite("torn", (uint8_t*) "this write will be torn", 23, 0);
+  delete s;
+
+  // Lop the tail off the last record, as a crash mid-write would.
+  if (0 != truncate(store_path, good_len + 20)) {
+    log->concat("Couldn't truncate the store.\n");
+    return -1;
+  }
+  s = _open_store();
+  int ret = -1;
+  if (20 != s->discardedOnLoad() || (good_len != s->logLength())) {
+    log->concatf("Discarded %u bytes on load. Expected 20.\n", s->discardedOnLoad());
+  }
+  else if (!_value_is(s, "torn", "intact") || !_value_is(s, "alpha", "again")) {
+    log->concat("Records before the torn one were lost.\n");
+  }
+  else {
+    // A corrupted byte must be caught by the CRC.
+    s->persistentWrite("flipped", (uint8_t*) "soon to be wrong", 16, 0);
+    delete s;
+    int fd = open(store_path, O_RDWR);
+    uint8_t b = 0;
+    if ((1 == pread(fd, &b, 1, good_len + 20)) && (b ^= 0x40, 1 == pwrite(fd, &b, 1, good_len + 20))) {
+      s = _open_store();
+      if ((0 == s->discardedOnLoad()) || (-1 != s->persistentRead("flipped", &b, 1, 0))) {
+        log->concat("A corrupted record was accepted.\n");
+      }
+      else if ((3 != s->keyCount()) || !_value_is(s, "torn", "intact")) {
+        log->concat("Records before the corrupted one were lost.\n");
+      }
+      else {
+        log->concat("\tTorn and corrupted records are cut off on load.\n");
+        ret = 0;
+      }
+    }
+    else {
+      log->concat("Couldn't corrupt the store.\n");
+      s = nullptr;
+    }
+    close(fd);
+  }
+  if (s) delete s;
+  return ret;
+}
+
+
+/*
+* Overwriting the same keys must not grow the log without bound.
+*/
+int test_Compaction(StringBuilder* log) {
+  TestStore* s = _open_store();
+  uint8_t val[200];
+  for (unsigned int i = 0; i < 4000; i++) {
+    memset(val, (int) (i & 0xFF), sizeof(val));
+    s->persistentWrite(((i & 1) ? "odd" : "even"), val, sizeof(val), 0);
+  }
+  const uint32_t compactions = s->compactions();
+  const uint32_t log_len     = s->logLength();
+  delete s;
+
+  s = _open_store();
+  int ret = -1;
+  uint8_t odd[200];
+  uint8_t even[200];
+  s->persistentRead("odd", odd, sizeof(odd), 0);
+  s->persistentRead("even", even, sizeof(even), 0);
+  if ((0 == compactions) || (log_len > (2 * LINUX_STORAGE_COMPACT_MIN))) {
+    log->concatf("The log reached %u bytes after %u compactions.\n", log_len, compactions);
+  }
+  else if ((3999 & 0xFF) != odd[199] || (3998 & 0xFF) != even[0] || !_value_is(s, "torn", "intact")) {
+    log->concat("Compaction lost data.\n");
+  }
+  else if ((0 != s->compact()) || ((s->liveLength() + 8) != s->logLength())) {
+    log->concat("An explicit compaction should leave only live records.\n");
+  }
+  else {
+    log->concatf("\t4000 overwrites took %u compactions, leaving a %u-byte log.\n", compactions, log_len);
+    ret = 0;
+  }
+  delete s;
+  return ret;
+}
+
+
+/*
+* A store from before keys must be adopted as the value of the null key.
+*/
+int test_Legacy(StringBuilder* log) {
+  unlink(store_path);
+  const char* blob = "\xA1\x64name\x63old";   // What the old store held: CBOR, unframed.
+  int fd = open(store_path, O_CREAT | O_WRONLY | O_TRUNC, S_IRUSR | S_IWUSR);
+  int w = write(fd, blob, strlen(blob));
+  close(fd);
+  if ((int) strlen(blob) != w) {
+    log->concat("Couldn't write a legacy store.\n");
+    return -1;
+  }
+  int ret = -1;
+  TestStore* s = _open_store();
+  if (!s->isMounted() || !_value_is(s, nullptr, blob)) {
+    log->concat("The legacy store was not adopted.\n");
+  }
+  else {
+    delete s;
+    s = _open_store();   // Now as a log.
+    if (!_value_is(s, nullptr, blob) || (0 != s->discardedOnLoad())) {
+      log->concat("The adopted store didn't survive reopening.\n");
+    }
+    else {
+      log->concat("\tA legacy store becomes the value of the null key.\n");
+      ret = 0;
+    }
+  }
+  delete s;
+  return ret;
+}
+
+
+/*
+* Builds a store of about 10MB, and times writing it, reading it, and
+*   reopening it. Informational only.
+*/
+int bench_Store(StringBuilder* log) {
+  const unsigned int KEYS     = 2560;
+  const unsigned int VAL_LEN  = 4096;
+  const unsigned int READS    = 100000;
+  unlink(store_path);
+  uint8_t* val = (uint8_t*) malloc(VAL_LEN);
+  char key[16];
+  for (unsigned int i = 0; i < VAL_LEN; i++) val[i] = (uint8_t) randomInt();
+
+  TestStore* s = _open_store();
+  unsigned long t0 = micros();
+  for (unsigned int i = 0; i < KEYS; i++) {
+    snprintf(key, sizeof(key), "k%u", i);
+    memcpy(val, &i, sizeof(i));
+    s->persistentWrite(key, val, VAL_LEN, 0);
+  }
+  s->flush();
+  unsigned long t_write = micros() - t0;
+
+  bool ok = true;
+  t0 = micros();
+  for (unsigned int i = 0; i < READS; i++) {
+    unsigned int k = (i * 2654435761u) % KEYS;
+    unsigned int got = 0;
+    snprintf(key, sizeof(key), "k%u", k);
+    s->persistentRead(key, val, VAL_LEN, 0);
+    memcpy(&got, val, sizeof(got));
+    ok = ok && (got == k);
+  }
+  unsigned long t_read = micros() - t0;
+  const uint32_t store_len = s->logLength();
+  delete s;
+
+  t0 = micros();
+  s = _open_store();
+  unsigned long t_open = micros() - t0;
+  ok = ok && (KEYS == s->keyCount());
+  delete s;
+
+  // The same again, if every write must be durable before it returns.
+  s = _open_store(true);
+  const unsigned int SYNC_WRITES = 200;
+  t0 = micros();
+  for (unsigned int i = 0; i < SYNC_WRITES; i++) {
+    s->persistentWrite("synced", val, 64, 0);
+  }
+  unsigned long t_sync = micros() - t0;
+  delete s;
+  free(val);
+
+  if (!ok) {
+    log->concat("The benchmark store read back wrong.\n");
+    return -1;
+  }
+  log->concatf("\t%u-byte store of %u keys:\n", store_len, KEYS);
+  log->concatf("\t  Write:   %8.0f ops/s  (%.1f MB/s, flushed at the end)\n",
+    (t_write ? ((double) KEYS * 1000000 / t_write) : (double) 0),
+    (t_write ? ((double) KEYS * VAL_LEN / t_write) : (double) 0));
+  log->concatf("\t  Read:    %8.0f ops/s  (%u-byte values)\n",
+    (t_read ? ((double) READS * 1000000 / t_read) : (double) 0), VAL_LEN);
+  log->concatf("\t  Reopen:  %8lu us\n", t_open);
+  log->concatf("\t  Synced:  %8.0f ops/s  (64-byte values)\n",
+    (t_sync ? ((double) SYNC_WRITES * 1000000 / t_sync) : (double) 0));
+  return 0;
+}
+
+
+/****************************************************************************************************
+* The main function.                                                                                *
+****************************************************************************************************/
+int main(int argc, char *argv[]) {
+  int exit_value = 1;   // Failure is the default result.
+  platform.platformPreInit();
+
+  StringBuilder log("===< LinuxStorage >=====================================\n");
+  if (nullptr != mkdtemp(scratch_dir)) {
+    snprintf(store_path, sizeof(store_path), "%s/store", scratch_dir);
+    if (0 == test_Keys(&log)) {
+      if (0 == test_Reopen(&log)) {
+        if (0 == test_TornTail(&log)) {
+          if (0 == test_Compaction(&log)) {
+            if (0 == test_Legacy(&log)) {
+              if (0 == bench_Store(&log)) {
+                exit_value = 0;
+              }
+            }
+          }
+        }
+      }
+    }
+    unlink(store_path);
+    rmdir(scratch_dir);
+  }
+  else {
+    log.concat("Couldn't make a scratch directory.\n");
+  }
+  printf("%s\n", (const char*) log.string());
+  exit(exit_value);
+}
@@ -0,0 +1,318 @@
+/*
+File:   ManuvrSessionSyncTest.cpp
+Author: J. Ian Lindsay
+Date:   2026.10.18
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Tests for sync recovery in ManuvrSession.
+
+The scanner is fed random streams in random pieces, and checked against a
+  brute-force search of the whole stream. The streams are mostly bytes from
+  the sync packet, so that near-misses are common.
+Then corrupted streams are fed to sessions through fromCounterparty(), which
+  must stay out of sync (and buffer nothing) until a sync packet arrives.
+
+Finally, noise is pushed through an out-of-sync session, and through the
+  algorithm that the session used to use, for comparison.
+*/
+
+#include <cstdio>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Platform/Platform.h>
+#include <XenoSession/Manuvr/ManuvrSession.h>
+
+#define FUZZ_STREAMS      2000
+#define FUZZ_STREAM_MAX   512
+#define FUZZ_SESSIONS     300
+#define BENCH_BYTES       (4 * 1024 * 1024)
+#define BENCH_CHUNK       64
+#define BENCH_CHUNK_LARGE 1024
+
+static const uint8_t* SYNC = XenoManuvrMessage::SYNC_PACKET_BYTES;
+static uint32_t prng_state = 0;
+
+
+/*
+* The platform's randoms block until the pool refills, which is far too slow
+*   for fuzzing. So we seed a xorshift from it once.
+*/
+static uint32_t fuzz_rand() {
+  if (0 == prng_state) prng_state = randomInt() | 1;
+  prng_state ^= prng_state << 13;
+  prng_state ^= prng_state >> 17;
+  prng_state ^= prng_state << 5;
+  return prng_state;
+}
+
+
+/*
+* Mostly bytes that appear in the sync packet.
+*/
+static uint8_t noise_byte() {
+  switch (fuzz_rand() % 4) {
+    case 0:   return SYNC[0];
+    case 1:   return SYNC[1];
+    case 2:   return SYNC[3];
+    default:  return (uint8_t) fuzz_rand();
+  }
+}
+
+
+/*
+* Noise that can't contain a sync packet, even across chunks.
+*/
+static void fill_noise(uint8_t* buf, int len) {
+  for (int i = 0; i < len; i++) {
+    buf[i] = noise_byte();
+    if (SYNC[3] == buf[i]) buf[i] = 0xAA;
+  }
+}
+
+
+/*
+* The answer the scanner should give for the chunk [start, end) of a stream.
+*   Packets are found greedily from the start of the stream.
+*/
+static int reference_feed(const uint8_t* stream, int start, int end) {
+  int found = -1;
+  int i = 0;
+  while (i + 4 <= end) {
+    if (0 == memcmp(stream + i, SYNC, 4)) {
+      i += 4;
+      if (i > start) found = i - start;
+    }
+    else {
+      i++;
+    }
+  }
+  return found;
+}
+
+
+int test_ScannerFuzz(StringBuilder* log) {
+  log->concat("===< SCANNER FUZZ >=====================================\n");
+  uint8_t stream[FUZZ_STREAM_MAX];
+  uint32_t chunks  = 0;
+  uint32_t packets = 0;
+  for (int n = 0; n < FUZZ_STREAMS; n++) {
+    const int len = 1 + (fuzz_rand() % FUZZ_STREAM_MAX);
+    for (int i = 0; i < len; i++) stream[i] = noise_byte();
+    // Plant a few whole packets.
+    const int plants = fuzz_rand() % 4;
+    for (int p = 0; p < plants; p++) {
+      if (len >= 4) memcpy(stream + (fuzz_rand() % (len - 3)), SYNC, 4);
+    }
+
+    ManuvrSyncScanner scanner;
+    int pos = 0;
+    while (pos < len) {
+      int piece = 1 + (fuzz_rand() % 40);
+      if (piece > (len - pos)) piece = len - pos;
+      const int expect = reference_feed(stream, pos, pos + piece);
+      const int got    = scanner.feed(stream + pos, piece);
+      if (got != expect) {
+        log->concatf("Stream %d (%d bytes): chunk at %d of %d bytes gave %d, expected %d.\n", n, len, pos, piece, got, expect);
+        return -1;
+      }
+      pos += piece;
+      chunks++;
+    }
+    if (scanner.bytesScanned() != (uint32_t) len) {
+      log->concatf("Stream %d: scanner counted %u bytes of %d.\n", n, scanner.bytesScanned(), len);
+      return -1;
+    }
+    packets += scanner.packetsFound();
+  }
+  log->concatf("\t%d streams in %u chunks. %u packets found.\n\tPASS.\n", FUZZ_STREAMS, chunks, packets);
+  return 0;
+}
+
+
+/*
+* A session that has lost sync must ignore noise without buffering it, and
+*   come back when (and only when) a sync packet completes, however it is cut.
+*/
+int test_SessionFuzz(StringBuilder* log) {
+  log->concat("===< SESSION FUZZ >=====================================\n");
+  uint8_t buf[256];
+  for (int n = 0; n < FUZZ_SESSIONS; n++) {
+    ManuvrSession* sess = new ManuvrSession(nullptr);
+    platform.kernel()->subscribe(sess);
+    int ret = 0;
+    if (XENOSESSION_STATE_SYNC_INITIATOR != sess->syncState()) {
+      log->concatf("Session %d began in sync state 0x%02x.\n", n, sess->syncState());
+      ret = -1;
+    }
+
+    // Noise, in pieces.
+    const int pieces = 1 + (fuzz_rand() % 8);
+    for (int p = 0; (0 == ret) && (p < pieces); p++) {
+      const int len = 1 + (fuzz_rand() % sizeof(buf));
+      fill_noise(buf, len);
+      StringBuilder chunk(buf, len);
+      sess->fromCounterparty(&chunk, MEM_MGMT_RESPONSIBLE_BEARER);
+      if ((XENOSESSION_STATE_SYNC_INITIATOR != sess->syncState()) || (0 != sess->bufferedBytes())) {
+        log->concatf("Session %d: noise left it in state 0x%02x with %d bytes buffered.\n", n, sess->syncState(), sess->bufferedBytes());
+        ret = -1;
+      }
+    }
+
+    // Noise followed by the packet, cut into two pieces.
+    const int lead = fuzz_rand() % 32;
+    fill_noise(buf, lead);
+    memcpy(buf + lead, SYNC, 4);
+    const int cut  = fuzz_rand() % (lead + 4);
+    for (int p = 0; (0 == ret) && (p < 2); p++) {
+      const int from = (0 == p) ? 0 : cut;
+      const int to   = (0 == p) ? cut : (lead + 4);
+      if (from == to) continue;
+      StringBuilder chunk(buf + from, to - from);
+      sess->fromCounterparty(&chunk, MEM_MGMT_RESPONSIBLE_BEARER);
+      const uint8_t expect = (1 == p) ? XENOSESSION_STATE_SYNC_PEND_EXIT : XENOSESSION_STATE_SYNC_INITIATOR;
+      if (expect != sess->syncState()) {
+        log->concatf("Session %d: state 0x%02x after piece %d (cut at %d of %d). Expected 0x%02x.\n", n, sess->syncState(), p, cut, lead + 4, expect);
+        ret = -1;
+      }
+    }
+    if ((0 == ret) && (0 != sess->bufferedBytes())) {
+      log->concatf("Session %d: %d bytes buffered after sync.\n", n, sess->bufferedBytes());
+      ret = -1;
+    }
+
+    platform.kernel()->unsubscribe(sess);
+    delete sess;
+    if (0 != ret) return ret;
+  }
+  log->concatf("\t%d sessions.\n\tPASS.\n", FUZZ_SESSIONS);
+  return 0;
+}
+
+
+/*
+* What the session used to do with each chunk while out of sync.
+*/
+static int8_t old_scan(StringBuilder* session_buffer, uint8_t* buf, int len) {
+  session_buffer->concat(buf, len);
+  int8_t return_value = 0;
+  int total  = session_buffer->length();
+  int last   = 0;
+  int offset = 0;
+  uint32_t sync_value = parseUint32Fromchars((unsigned char*) SYNC);
+  unsigned char* str = session_buffer->string();
+  while (total >= offset + 4) {
+    if (parseUint32Fromchars(str + offset) == sync_value) {
+      return_value = 1;
+      last = offset;
+      offset += 4;
+    }
+    else {
+      offset++;
+    }
+  }
+  if (return_value) {
+    session_buffer->cull(last + 4);
+  }
+  else if (total > 7) {
+    session_buffer->cull(total - 3);
+  }
+  return return_value;
+}
+
+
+/*
+* Times the old scan, the scanner alone, and the session around it, over the
+*   same noise in chunks of the given size. Returns -1 if any of them finds
+*   sync.
+*/
+static int bench_run(const uint8_t* noise, int chunk_len, uint32_t* us) {
+  StringBuilder old_buffer;
+  uint32_t t0 = (uint32_t) micros();
+  for (int i = 0; i < BENCH_BYTES; i += chunk_len) {
+    if (old_scan(&old_buffer, (uint8_t*) noise, chunk_len)) return -1;
+  }
+  us[0] = (uint32_t) micros() - t0;
+
+  ManuvrSyncScanner scanner;
+  t0 = (uint32_t) micros();
+  for (int i = 0; i < BENCH_BYTES; i += chunk_len) {
+    if (0 <= scanner.feed(noise, chunk_len)) return -1;
+  }
+  us[1] = (uint32_t) micros() - t0;
+
+  ManuvrSession* sess = new ManuvrSession(nullptr);
+  platform.kernel()->subscribe(sess);
+  t0 = (uint32_t) micros();
+  for (int i = 0; i < BENCH_BYTES; i += chunk_len) {
+    StringBuilder chunk((uint8_t*) noise, chunk_len);
+    sess->fromCounterparty(&chunk, MEM_MGMT_RESPONSIBLE_BEARER);
+  }
+  us[2] = (uint32_t) micros() - t0;
+  const bool still_out = (XENOSESSION_STATE_SYNC_INITIATOR == sess->syncState()) && (0 == sess->bufferedBytes());
+  platform.kernel()->unsubscribe(sess);
+  delete sess;
+  return still_out ? 0 : -1;
+}
+
+
+int bench_OutOfSync(StringBuilder* log) {
+  log->concat("===< BENCHMARK: OUT OF SYNC >===========================\n");
+  const int chunk_lens[2] = {BENCH_CHUNK, BENCH_CHUNK_LARGE};
+  const char* names[3]    = {"Buffer and scan", "Scanner", "Session"};
+  uint8_t noise[BENCH_CHUNK_LARGE];
+  // Line noise, rather than fuzz. Anything but the last byte of the packet.
+  for (int i = 0; i < BENCH_CHUNK_LARGE; i++) {
+    noise[i] = (uint8_t) fuzz_rand();
+    if (SYNC[3] == noise[i]) noise[i] = 0xAA;
+  }
+
+  log->concatf("\t%d bytes of noise per run.\n", BENCH_BYTES);
+  log->concatf("\t%-20s %8s %10s %10s\n", "", "chunk", "us", "MB/s");
+  for (int c = 0; c < 2; c++) {
+    uint32_t us[3];
+    if (0 != bench_run(noise, chunk_lens[c], us)) {
+      log->concat("Sync was found in noise.\n");
+      return -1;
+    }
+    for (int i = 0; i < 3; i++) {
+      log->concatf("\t%-20s %8d %10u %10.1f\n",
+        names[i],
+        chunk_lens[c],
+        us[i],
+        (double) BENCH_BYTES / (double) (us[i] ? us[i] : 1)
+      );
+    }
+  }
+  return 0;
+}
+
+
+int main(int argc, char *argv[]) {
+  int exit_value = 1;   // Failure is the default result.
+  platform.platformPreInit();
+  platform.bootstrap();
+
+  StringBuilder log("===< ManuvrSession sync >===============================\n");
+  if ((0 == test_ScannerFuzz(&log)) && (0 == test_SessionFuzz(&log))) {
+    if (0 == bench_OutOfSync(&log)) {
+      exit_value = 0;
+    }
+  }
+  printf("%s\n", (const char*) log.string());
+  exit(exit_value);
+}
@@ -107,7 +107,50 @@ int SCHEDULER_CREATE_SCHEDULES() {
 */
 int SCHEDULER_EXEC_SCHEDULES() {
   printf("===< SCHEDULER_EXEC_SCHEDULES >==================================\n");
-  return 0;
+  Kernel* kernel = platform.kernel();
+  schedule_0.alterScheduleRecurrence(5);
+  schedule_0.delaySchedule();
+  count_0 = 0;
+  kernel->profiler(true);
+
+  // Six executions at 100ms intervals should be done in ~600ms. Allow some slop.
+  // The linux timer counts CPU time, so we must spin rather than sleep.
+  unsigned long t0 = millis();
+  while ((millis() - t0) < 1000) {
+    kernel->procIdleFlags();
+  }
+
+  StringBuilder out;
+  kernel->printScheduler(&out);
+  kernel->printProfiler(&out);
+  kernel->dumpProfiler(&out, false);
+  printf("%s\n", (const char*) out.string());
+
+  #if defined(MANUVR_EVENT_PROFILER)
+    // Every execution should have been timed, both running and waiting.
+    unsigned int runs  = 0;
+    unsigned int waits = 0;
+    char prefix[12];
+    snprintf(prefix, sizeof(prefix), "\n0x%04x\t", MANUVR_MSG_DEFERRED_FXN);
+    const char* line = strstr((const char*) out.string(), prefix);
+    if (nullptr != line) {
+      sscanf(line + 1, "%*x\t%*s\t%u\t%*u\t%*u\t%*u\t%*u\t%*u\t%*u\t%u", &runs, &waits);
+    }
+    kernel->profiler(false);
+    if ((runs < 6) || (waits < 6)) {
+      printf("Profiler saw %u runs and %u waits for DEFERRED_FXN. Expected at least 6.\n", runs, waits);
+      return -1;
+    }
+  #endif  // MANUVR_EVENT_PROFILER
+
+  if (6 == count_0) {
+    if (!schedule_0.willRunAgain()) {
+      return 0;
+    }
+    else printf("schedule_0 claims it will run again after exhausting its recurrence.\n");
+  }
+  else printf("schedule_0 ran %d times. Expected 6.\n", count_0);
+  return -1;
 }
 
 
@@ -0,0 +1,223 @@
+/*
+File:   SensorManagerTest.cpp
+Author: J. Ian Lindsay
+Date:   2026.10.18
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Tests for the SensorManager's polling schedule, and for deadband reporting
+  in SensorDatum. The SensorManager is driven by hand, without a Kernel.
+*/
+
+#include <cstdio>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Platform/Platform.h>
+#include <Drivers/Sensors/SensorWrapper.h>
+
+const DatumDef fake_datum_defs[] = {
+  {
+    .desc    = "Value",
+    .units   = COMMON_UNITS_DEGREES,
+    .type_id = TCode::FLOAT,
+    .flgs    = 0
+  }
+};
+
+static unsigned int report_count = 0;
+
+static void _report_cb(SensorWrapper*) {
+  report_count++;
+}
+
+
+/*
+* A sensor that produces whatever value we tell it to, whenever it is polled.
+*/
+class FakeSensor : public SensorWrapper {
+  public:
+    float        value = 0.0f;
+    unsigned int polls = 0;
+
+    FakeSensor(const char* n, float hz) : SensorWrapper(n) {
+      define_datum(&fake_datum_defs[0]);
+      setOutputDataRate(hz);
+      isActive(true);
+    };
+
+    SensorError init() {          return SensorError::NO_ERROR;  };
+    SensorError readSensor() {
+      polls++;
+      return updateDatum(0, value);
+    };
+    SensorError setParameter(uint16_t reg, int len, uint8_t*) {  return SensorError::INVALID_PARAM_ID;  };
+    SensorError getParameter(uint16_t reg, int len, uint8_t*) {  return SensorError::INVALID_PARAM_ID;  };
+};
+
+
+/*
+* Only changes that clear the deadband should earn reports.
+*/
+int test_Deadband(StringBuilder* log) {
+  FakeSensor s("fake", 0.0f);
+  s.setAutoReportCallback(_report_cb);
+  s.setAutoReporting(0, SensorReporting::NEW_VALUE);
+  s.setDeadband(0, 0.5f);
+  report_count = 0;
+
+  const float   values[]   = { 1.0f,  1.2f,  0.6f,  1.6f,  1.6f,  1.1f,  1.09f };
+  const bool    expected[] = { true,  false, false, true,  false, false, true  };
+  for (unsigned int i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+    s.value = values[i];
+    s.readSensor();
+    if (s.reportDue() != expected[i]) {
+      log->concatf("Update %u (%.2f) %s a report.\n", i, (double) values[i], (expected[i] ? "should have earned" : "should not have earned"));
+      return -1;
+    }
+    s.issueReport();
+  }
+  if (3 != report_count) {
+    log->concatf("Deadband: %u reports issued. Expected 3.\n", report_count);
+    return -1;
+  }
+
+  // Every read is reported when asked.
+  report_count = 0;
+  s.setAutoReporting(0, SensorReporting::EVERY_READ);
+  for (int i = 0; i < 4; i++) {
+    s.readSensor();
+    s.issueReport();
+  }
+  if (4 != report_count) {
+    log->concatf("EVERY_READ: %u reports issued. Expected 4.\n", report_count);
+    return -1;
+  }
+  log->concat("\tDeadband reporting suppresses small changes.\n");
+  return 0;
+}
+
+
+/*
+* Sensors should be polled at their own rates, no matter how often the
+*   SensorManager is serviced. Sensors with no declared rate are polled on
+*   every service.
+*/
+int test_PollRates(StringBuilder* log) {
+  SensorManager sm;
+  FakeSensor fast("fast", 100.0f);
+  FakeSensor slow("slow", 30.0f);   // Out of step with fast.
+  FakeSensor blind("blind", 0.0f);
+  int bus_a = 0;   // Only its address matters.
+
+  sm.addSensor(&fast, &bus_a);
+  sm.addSensor(&slow, &bus_a);
+  sm.addSensor(&blind);
+  if (10 != sm.servicePeriod()) {
+    log->concatf("Service period should follow the fastest sensor (10ms), but is %ums.\n", sm.servicePeriod());
+    return -1;
+  }
+
+  ManuvrMsg svc(MANUVR_MSG_SENSOR_MGR_SVC);
+  unsigned int services = 0;
+  const unsigned long t0 = micros();
+  while ((micros() - t0) < 500000) {
+    sm.notify(&svc);
+    services++;
+    sleep_millis(2);
+  }
+  const unsigned long elapsed = micros() - t0;
+  const unsigned int exp_fast = elapsed / 10000;
+  const unsigned int exp_slow = (elapsed * 3) / 100000;
+
+  log->concatf("\t%u services in %lu us: fast %u (~%u), slow %u (~%u), blind %u\n",
+    services, elapsed, fast.polls, exp_fast, slow.polls, exp_slow, blind.polls);
+  log->concatf("\tPolls executed %u, skipped %u, coalesced %u\n",
+    sm.pollsExecuted(), sm.pollsSkipped(), sm.pollsCoalesced());
+
+  if (services != blind.polls) {
+    log->concat("A sensor with no data rate should be polled on every service.\n");
+    return -1;
+  }
+  if ((fast.polls > exp_fast + 2) || (fast.polls < (exp_fast * 3) / 4)) {
+    log->concat("The 100Hz sensor was polled at the wrong rate.\n");
+    return -1;
+  }
+  if ((slow.polls > exp_slow + 2) || (slow.polls < (exp_slow * 3) / 4)) {
+    log->concat("The 30Hz sensor was polled at the wrong rate.\n");
+    return -1;
+  }
+  if ((sm.pollsExecuted() + sm.pollsSkipped()) != (services * 3)) {
+    log->concat("Every sensor should be counted as polled or skipped on every service.\n");
+    return -1;
+  }
+  if (0 == sm.pollsCoalesced()) {
+    log->concat("The 30Hz sensor should have been polled alongside the 100Hz sensor on its bus.\n");
+    return -1;
+  }
+  return 0;
+}
+
+
+/*
+* Unchanging values should not generate reports.
+*/
+int test_Reporting(StringBuilder* log) {
+  SensorManager sm;
+  FakeSensor a("a", 0.0f);
+  FakeSensor b("b", 0.0f);
+  a.setAutoReporting(SensorReporting::NEW_VALUE);
+  b.setAutoReporting(SensorReporting::NEW_VALUE);
+  b.setDeadband(0, 1.0f);
+  sm.addSensor(&a);
+  sm.addSensor(&b);
+
+  ManuvrMsg svc(MANUVR_MSG_SENSOR_MGR_SVC);
+  ManuvrMsg rpt(MANUVR_MSG_SENSOR_MGR_REPORT);
+  for (int i = 0; i < 11; i++) {
+    a.value = 5.0f;              // Never changes.
+    b.value = 0.25f * i;         // Crosses its deadband every fifth service.
+    sm.notify(&svc);
+    sm.notify(&rpt);
+  }
+  // One report each for the first values, plus b at 1.25 and 2.5.
+  if (4 != sm.reportsIssued()) {
+    log->concatf("%u reports issued. Expected 4.\n", sm.reportsIssued());
+    return -1;
+  }
+  log->concat("\tUnchanged data generate no reports.\n");
+  return 0;
+}
+
+
+/****************************************************************************************************
+* The main function.                                                                                *
+****************************************************************************************************/
+int main(int argc, char *argv[]) {
+  int exit_value = 1;   // Failure is the default result.
+  platform.platformPreInit();
+
+  StringBuilder log("===< SensorManager >====================================\n");
+  if (0 == test_Deadband(&log)) {
+    if (0 == test_PollRates(&log)) {
+      if (0 == test_Reporting(&log)) {
+        exit_value = 0;
+      }
+    }
+  }
+  printf("%s\n", (const char*) log.string());
+  exit(exit_value);
+}
@@ -0,0 +1,281 @@
+/*
+File:   SocketReactorTest.cpp
+Author: J. Ian Lindsay
+Date:   2026.10.18
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Tests for the SocketReactor, by way of a listening ManuvrTCP on loopback.
+  Every connection it accepts is given a pipe that echoes what it reads.
+  Clients are plain sockets, driven from this thread.
+
+After the tests, echo round-trips are timed for 1 to 1000 clients at once.
+*/
+
+#include <cstdio>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <netinet/tcp.h>
+
+#include <Platform/Platform.h>
+#include <Transports/ManuvrSocket/ManuvrTCP.h>
+
+#define ECHO_PIPE_CODE   0x7E
+#define MSG_LEN          64
+#define WAIT_LIMIT_US    5000000
+
+static const uint8_t echo_strategy[] = { ECHO_PIPE_CODE, 0 };
+static int listen_port = 0;
+
+
+/*
+* Sends everything it is given back the way it came.
+*/
+class EchoPipe : public BufferPipe {
+  public:
+    EchoPipe(BufferPipe* n) : BufferPipe() {   setNear(n);   };
+    const char* pipeName() {   return "EchoPipe";   };
+
+    int8_t fromCounterparty(StringBuilder* buf, int8_t mm) {
+      return near()->toCounterparty(buf, mm);
+    };
+    int8_t fromCounterparty(BufferSlice* buf, int8_t mm) {
+      return near()->toCounterparty(buf, mm);
+    };
+    int8_t fromCounterparty(ManuvrPipeSignal sig, void* arg) {   return 0;   };
+};
+
+static BufferPipe* _echo_factory(BufferPipe* n, BufferPipe*) {
+  return new EchoPipe(n);
+}
+
+
+/*
+* Blocks until the reactor holds the given number of sockets, or gives up.
+*/
+static bool _await_sockets(unsigned int count) {
+  const unsigned long t0 = micros();
+  while (SocketReactor::reactor()->sockets() != count) {
+    if ((micros() - t0) > WAIT_LIMIT_US) return false;
+    sleep_millis(1);
+  }
+  return true;
+}
+
+
+static int _connect_client() {
+  int s = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family      = AF_INET;
+  addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+  addr.sin_port        = htons(listen_port);
+  if (0 != connect(s, (struct sockaddr*) &addr, sizeof(addr))) {
+    close(s);
+    return -1;
+  }
+  int nodelay = 1;
+  setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+  return s;
+}
+
+
+/*
+* A connection must be accepted, echo, and be noticed when it goes away.
+*/
+int test_Echo(StringBuilder* log) {
+  const unsigned int base = SocketReactor::reactor()->sockets();
+  int s = _connect_client();
+  if (0 > s) {
+    log->concat("Couldn't connect to the listener.\n");
+    return -1;
+  }
+  if (!_await_sockets(base + 1)) {
+    log->concat("The connection was never registered with the reactor.\n");
+    close(s);
+    return -1;
+  }
+
+  const char* msg = "Is there anybody out there?";
+  char   buf[64];
+  size_t got = 0;
+  const unsigned long t0 = micros();
+  if ((ssize_t) strlen(msg) != write(s, msg, strlen(msg))) {
+    log->concat("Couldn't write to the listener.\n");
+    close(s);
+    return -1;
+  }
+  while ((got < strlen(msg)) && ((micros() - t0) < WAIT_LIMIT_US)) {
+    ssize_t n = recv(s, buf + got, sizeof(buf) - got, MSG_DONTWAIT);
+    if (n > 0) got += n;
+  }
+  const unsigned long rtt = micros() - t0;
+  close(s);
+
+  if ((got != strlen(msg)) || (0 != memcmp(buf, msg, got))) {
+    log->concat("The echo came back wrong.\n");
+    return -1;
+  }
+  if (!_await_sockets(base)) {
+    log->concat("The reactor never noticed that the client hung up.\n");
+    return -1;
+  }
+  log->concatf("\tEcho round-trip in %lu us. Hang-up noticed.\n", rtt);
+  return 0;
+}
+
+
+/*
+* Connects the given number of clients, and has each of them bounce messages
+*   off the server in lock-step. Informational, but fails if anything is lost.
+*/
+int bench_Clients(StringBuilder* log, unsigned int clients) {
+  const unsigned int base   = SocketReactor::reactor()->sockets();
+  const unsigned int rounds = std::max(20u, 20000u / clients);
+  int*      socks  = (int*) malloc(sizeof(int) * clients);
+  uint32_t* have   = (uint32_t*) malloc(sizeof(uint32_t) * clients);
+  uint32_t* sent   = (uint32_t*) malloc(sizeof(uint32_t) * clients);
+  uint32_t* lat    = (uint32_t*) malloc(sizeof(uint32_t) * clients * rounds);
+  unsigned int lat_count = 0;
+  int ret = -1;
+  int epfd = epoll_create1(0);
+
+  unsigned long t0 = micros();
+  unsigned int connected = 0;
+  for (; connected < clients; connected++) {
+    socks[connected] = _connect_client();
+    if (0 > socks[connected]) break;
+    struct epoll_event ev;
+    ev.events   = EPOLLIN;
+    ev.data.u32 = connected;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, socks[connected], &ev);
+  }
+  const bool all_in = (connected == clients) && _await_sockets(base + clients);
+  const unsigned long t_conn = micros() - t0;
+
+  if (!all_in) {
+    log->concatf("Only %u of %u clients connected.\n", connected, clients);
+  }
+  else {
+    uint8_t msg[MSG_LEN];
+    uint8_t rx[MSG_LEN * 4];
+    memset(msg, 0xA5, sizeof(msg));
+    struct epoll_event events[256];
+    bool ok = true;
+    t0 = micros();
+    for (unsigned int r = 0; ok && (r < rounds); r++) {
+      for (unsigned int c = 0; c < clients; c++) {
+        have[c] = 0;
+        sent[c] = (uint32_t) micros();
+        if (MSG_LEN != write(socks[c], msg, MSG_LEN)) ok = false;
+      }
+      unsigned int done = 0;
+      const unsigned long r0 = micros();
+      while (ok && (done < clients)) {
+        if ((micros() - r0) > WAIT_LIMIT_US) {
+          ok = false;
+          break;
+        }
+        int n = epoll_wait(epfd, events, 256, 100);
+        for (int i = 0; i < n; i++) {
+          const uint32_t c = events[i].data.u32;
+          ssize_t got = recv(socks[c], rx, sizeof(rx), MSG_DONTWAIT);
+          if (got <= 0) continue;
+          have[c] += got;
+          if (have[c] == MSG_LEN) {
+            lat[lat_count++] = (uint32_t) micros() - sent[c];
+            done++;
+          }
+        }
+      }
+    }
+    const unsigned long elapsed = micros() - t0;
+
+    if (!ok) {
+      log->concatf("%u clients: echoes went missing.\n", clients);
+    }
+    else {
+      std::sort(lat, lat + lat_count);
+      const unsigned int msgs = clients * rounds;
+      log->concatf("\t%4u clients:  connect %6.0f/s   %8.0f msgs/s   p50 %5u us   p99 %5u us\n",
+        clients,
+        (t_conn ? ((double) clients * 1000000 / t_conn) : (double) 0),
+        (elapsed ? ((double) msgs * 1000000 / elapsed) : (double) 0),
+        lat[lat_count / 2], lat[(lat_count * 99) / 100]
+      );
+      ret = 0;
+    }
+  }
+
+  for (unsigned int c = 0; c < connected; c++) close(socks[c]);
+  close(epfd);
+  if ((0 == ret) && !_await_sockets(base)) {
+    log->concatf("%u clients: the reactor didn't notice all of them leave.\n", clients);
+    ret = -1;
+  }
+  free(lat);
+  free(sent);
+  free(have);
+  free(socks);
+  return ret;
+}
+
+
+/****************************************************************************************************
+* The main function.                                                                                *
+****************************************************************************************************/
+int main(int argc, char *argv[]) {
+  int exit_value = 1;   // Failure is the default result.
+  platform.platformPreInit();
+
+  // A thousand clients is two thousand descriptors.
+  struct rlimit rl;
+  if (0 == getrlimit(RLIMIT_NOFILE, &rl)) {
+    rl.rlim_cur = rl.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &rl);
+  }
+
+  StringBuilder log("===< SocketReactor >====================================\n");
+  BufferPipe::registerPipe(ECHO_PIPE_CODE, _echo_factory);
+  listen_port = 20000 + (getpid() % 10000);
+  ManuvrTCP listener("127.0.0.1", listen_port);
+  listener.setPipeStrategy(echo_strategy);
+
+  if (0 != listener.listen()) {
+    log.concatf("Couldn't listen on port %d.\n", listen_port);
+  }
+  else if (0 == test_Echo(&log)) {
+    const unsigned int counts[] = { 1, 10, 100, 1000 };
+    const unsigned int fd_room  = (unsigned int) ((rl.rlim_cur - 64) / 2);
+    exit_value = 0;
+    for (unsigned int i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+      if (counts[i] > fd_room) {
+        log.concatf("\t%4u clients:  skipped for want of descriptors.\n", counts[i]);
+      }
+      else if (0 != bench_Clients(&log, counts[i])) {
+        exit_value = 1;
+        break;
+      }
+    }
+    SocketReactor::reactor()->printDebug(&log);
+  }
+  printf("%s\n", (const char*) log.string());
+  exit(exit_value);
+}
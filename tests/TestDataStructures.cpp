@@ -27,15 +27,22 @@ This program runs tests on raw data-handling classes.
 #include <string.h>
 #include <ctype.h>
 #include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
 
 #include <fstream>
 #include <iostream>
+#include <map>
 
 #include <DataStructures/StringBuilder.h>
 #include <DataStructures/PriorityQueue.h>
+#include <DataStructures/RunQueue.h>
+#include <DataStructures/TimerWheel.h>
+#include <DataStructures/MPSCQueue.h>
 #include <DataStructures/Vector3.h>
 #include <DataStructures/Quaternion.h>
 #include <DataStructures/RingBuffer.h>
+#include <DataStructures/SPSCRingBuffer.h>
 #include <DataStructures/BufferPipe.h>
 #include <DataStructures/uuid.h>
 
@@ -60,6 +67,28 @@ This program runs tests on raw data-handling classes.
 #endif
 
 
+/*
+* Heap accounting for the StringBuilder benchmark. The test build links with
+*   --wrap for these, so every call from the library lands here first.
+*/
+static unsigned long heap_allocs = 0;
+
+extern "C" {
+  void* __real_malloc(size_t);
+  void* __real_realloc(void*, size_t);
+
+  void* __wrap_malloc(size_t size) {
+    heap_allocs++;
+    return __real_malloc(size);
+  }
+
+  void* __wrap_realloc(void* ptr, size_t size) {
+    heap_allocs++;
+    return __real_realloc(ptr, size);
+  }
+}
+
+
 #define STRBUILDER_STATICTEST_STRING "I CAN cOUNT to PoTaTo   "
 
 int test_StringBuilderStatics(StringBuilder* log) {
@@ -99,6 +128,131 @@ int test_StringBuilderStatics(StringBuilder* log) {
 }
 
 
+/**
+* Runs the same sequence of operations on the given StringBuilder. Whatever the
+*   mode, the results ought to be the same.
+*/
+void exercise_StringBuilder(StringBuilder* sb, StringBuilder* result) {
+  sb->concat("alpha ");
+  sb->concatf("%d %s ", 42, "beta");
+  sb->prepend("zero ");
+  sb->concat((uint8_t*) "gamma ", 6);
+  // Longer than the old concatf() estimate, and the initial capacity.
+  sb->concatf("%s%s%s%s", STRBUILDER_STATICTEST_STRING, STRBUILDER_STATICTEST_STRING, STRBUILDER_STATICTEST_STRING, STRBUILDER_STATICTEST_STRING);
+  for (int i = 0; i < 40; i++) sb->concatf("%04d,", i);
+  result->concatf("%d|%s|", sb->length(), (const char*) sb->string());
+  sb->cull(5);
+  sb->cull(2, 20);
+  result->concatf("%d|%s|", sb->length(), (const char*) sb->string());
+
+  StringBuilder donor("delta epsilon");
+  sb->concatHandoff(&donor);
+  result->concatf("%d|%d|", sb->length(), donor.length());
+
+  int toks = sb->split(" ");
+  result->concatf("%d|%d|", toks, sb->count());
+  for (int i = 0; i < toks; i++) result->concatf("%s/", sb->position(i));
+  sb->drop_position(0);
+  sb->concat("tail");
+  result->concatf("|%d|%s|", sb->count(), sb->position(toks - 1));
+  result->concatf("%s", (const char*) sb->string());
+}
+
+
+/**
+* The coalescing and linked-list modes must be indistinguishable from the
+*   outside, apart from the number of tokens before a split().
+* @return 0 on pass. Non-zero otherwise.
+*/
+int test_StringBuilderCoalescing(StringBuilder* log) {
+  StringBuilder contiguous;
+  StringBuilder fragmented;
+  StringBuilder result_c;
+  StringBuilder result_f;
+  contiguous.coalesce(true);
+  exercise_StringBuilder(&contiguous, &result_c);
+  exercise_StringBuilder(&fragmented, &result_f);
+  if (result_c.length() != result_f.length() || (0 != strcmp((const char*) result_c.string(), (const char*) result_f.string()))) {
+    log->concatf("Coalescing mode diverged:\n\t%s\n\t%s\n", (const char*) result_c.string(), (const char*) result_f.string());
+    return -1;
+  }
+  StringBuilder empty;
+  if ((0 != empty.concatf("%s", "")) || (0 != strlen((const char*) empty.string())) || (0 != empty.length())) {
+    log->concat("An empty concatf() should leave an empty string.\n");
+    return -1;
+  }
+  return 0;
+}
+
+
+/**
+* Edge cases of split() and cull(offset, length), in the given mode.
+*   A string of nothing but delimiters is left whole, as the only token.
+*   cull(offset, length) keeps exactly the given range, and ignores a range
+*   that runs off the end.
+* @return 0 on pass. Non-zero otherwise.
+*/
+int test_StringBuilderEdges(StringBuilder* log, bool coalesce) {
+  StringBuilder delims;
+  delims.coalesce(coalesce);
+  delims.concat("   ");
+  if ((0 != delims.split(" ")) || (1 != delims.count()) || (0 != strcmp(delims.position(0), "   "))) {
+    log->concatf("split() of only delimiters gave %d tokens (coalesce %s).\n", delims.count(), coalesce ? "on" : "off");
+    return -1;
+  }
+  StringBuilder range;
+  range.coalesce(coalesce);
+  range.concat("0123");
+  range.concat("456789");
+  range.cull(2, 5);
+  if ((5 != range.length()) || (0 != strcmp((const char*) range.string(), "23456"))) {
+    log->concatf("cull(2, 5) left \"%s\" (coalesce %s).\n", (const char*) range.string(), coalesce ? "on" : "off");
+    return -1;
+  }
+  range.cull(3, 5);
+  if ((5 != range.length()) || (0 != strcmp((const char*) range.string(), "23456"))) {
+    log->concatf("cull(3, 5) of 5 bytes should do nothing (coalesce %s).\n", coalesce ? "on" : "off");
+    return -1;
+  }
+  return 0;
+}
+
+
+/**
+* Builds a log-like string out of many small pieces, in both modes, and reports
+*   the heap allocations and time taken. Informational only. No test.
+*/
+void bench_StringBuilder(StringBuilder* log) {
+  const int ROUNDS = 200;
+  const int LINES  = 50;
+  unsigned long allocs[2];
+  unsigned long elapsed[2];
+  unsigned long total_len = 0;
+
+  for (int mode = 0; mode < 2; mode++) {
+    unsigned long a0 = heap_allocs;
+    unsigned long t0 = micros();
+    for (int r = 0; r < ROUNDS; r++) {
+      StringBuilder out;
+      out.coalesce(1 == mode);
+      for (int i = 0; i < LINES; i++) {
+        out.concat("-- Element ");
+        out.concat(i);
+        out.concatf(":  0x%08x  %s\n", (unsigned int) (r * i), (i & 1) ? "odd" : "even");
+      }
+      total_len += strlen((const char*) out.string());
+    }
+    elapsed[mode] = micros() - t0;
+    allocs[mode]  = heap_allocs - a0;
+  }
+
+  unsigned long ops = ROUNDS * LINES * 3;
+  log->concatf("\t %lu appends in %d builds (%lu bytes):\n", ops, ROUNDS, total_len);
+  log->concatf("\t   Linked-list  %8lu allocs  %8lu us  (%.1f ns/append)\n", allocs[0], elapsed[0], (elapsed[0] * 1000.0) / ops);
+  log->concatf("\t   Coalescing   %8lu allocs  %8lu us  (%.1f ns/append)\n", allocs[1], elapsed[1], (elapsed[1] * 1000.0) / ops);
+}
+
+
 int test_StringBuilder(void) {
   int return_value = -1;
   StringBuilder log("===< StringBuilder >====================================\n");
@@ -109,7 +263,7 @@ int test_StringBuilder(void) {
   if (0 == test_StringBuilderStatics(&log)) {
     char* empty_str = (char*) stack_obj.string();
     if (0 == strlen(empty_str)) {
-      free(empty_str);
+      // The buffer still belongs to stack_obj. Don't free it.
       stack_obj.concat("a test of the StringBuilder ");
       stack_obj.concat("used in stack. ");
       stack_obj.prepend("This is ");
@@ -144,7 +298,10 @@ int test_StringBuilder(void) {
       stack_obj.split(" ");
 
       log.concatf("\t Final Stack obj:          %s\n", stack_obj.string());
-      return_value = 0;
+      if ((0 == test_StringBuilderCoalescing(&log)) && (0 == test_StringBuilderEdges(&log, false)) && (0 == test_StringBuilderEdges(&log, true))) {
+        bench_StringBuilder(&log);
+        return_value = 0;
+      }
     }
     else log.concat("StringBuilde.string() failed to produce an empty string.\n");
   }
@@ -317,12 +474,127 @@ int test_PriorityQueue1(StringBuilder* log) {
 }
 
 
+// Tests for:
+//   PriorityIterator<T>, begin(), end()
+//   bool remove(PriorityIterator<T>&);
+//   ListIterator<T>, and the same for LinkedList.
+int test_PriorityQueue2(StringBuilder* log) {
+  int return_value = -1;
+  PriorityQueue<uint32_t*> queue0;
+  LinkedList<uint32_t*>    list0;
+  uint32_t vals[16] = { 234, 734, 733, 7456, 819, 943, 223, 936,
+                        134, 634, 633, 6456, 719, 843, 123, 836 };
+  const int COUNT = sizeof(vals) / sizeof(uint32_t);
+
+  int visits = 0;
+  for (uint32_t* v : queue0) {  (void) v;  visits++;  }
+  for (uint32_t* v : list0) {   (void) v;  visits++;  }
+  if (0 != visits) {
+    log->concat("Iteration over an empty container visited something.\n");
+    return -1;
+  }
+
+  for (int i = 0; i < COUNT; i++) {
+    queue0.insert(&vals[i], i % 4);   // Four priority bands.
+    list0.insert(&vals[i]);
+  }
+
+  // The queue must iterate in the same order that get(i) reports.
+  bool in_order = true;
+  int  last_pri = 0x7FFFFFFF;
+  int  i        = 0;
+  for (PriorityIterator<uint32_t*> it = queue0.begin(); it != queue0.end(); ++it) {
+    in_order &= (*it == queue0.get(i)) && (it.priority() == queue0.getPriority(i)) && (it.priority() <= last_pri);
+    last_pri = it.priority();
+    i++;
+  }
+  in_order &= (COUNT == i);
+  i = 0;
+  for (uint32_t* v : list0) {
+    in_order &= (v == &vals[i++]);
+  }
+  in_order &= (COUNT == i);
+
+  if (in_order) {
+    // Remove the odd values while iterating, including the head and the tail.
+    vals[0]         |= 1;
+    vals[COUNT - 1] |= 1;
+    int odds = 0;
+    for (i = 0; i < COUNT; i++) odds += (vals[i] & 1);
+    int removed_q = 0;
+    int removed_l = 0;
+    for (PriorityIterator<uint32_t*> it = queue0.begin(); it != queue0.end(); ++it) {
+      if (**it & 1) removed_q += queue0.remove(it) ? 1 : 0;
+    }
+    for (ListIterator<uint32_t*> it = list0.begin(); it != list0.end(); ++it) {
+      if (**it & 1) removed_l += list0.remove(it) ? 1 : 0;
+    }
+    bool evens_only = (odds == removed_q) && (odds == removed_l);
+    evens_only &= ((COUNT - odds) == queue0.size()) && ((COUNT - odds) == list0.size());
+    int seen_q = 0;
+    int seen_l = 0;
+    for (uint32_t* v : queue0) {  evens_only &= (0 == (*v & 1));  seen_q++;  }
+    for (uint32_t* v : list0) {   evens_only &= (0 == (*v & 1));  seen_l++;  }
+    evens_only &= (seen_q == queue0.size()) && (seen_l == list0.size());
+
+    if (evens_only) {
+      // Removing everything must leave both containers consistent.
+      for (PriorityIterator<uint32_t*> it = queue0.begin(); it != queue0.end(); ++it) queue0.remove(it);
+      for (ListIterator<uint32_t*> it = list0.begin(); it != list0.end(); ++it) list0.remove(it);
+      if ((0 == queue0.size()) && !queue0.hasNext() && (0 == list0.size()) && !list0.hasNext()) {
+        return_value = 0;
+      }
+      else log->concat("Removing every element by iterator left something behind.\n");
+    }
+    else log->concatf("Removal during iteration went wrong (%d odds, removed %d/%d).\n", odds, removed_q, removed_l);
+  }
+  else log->concat("Iteration order disagrees with get(i).\n");
+  return return_value;
+}
+
+
+/**
+* Compares a broadcast to every member of a queue by get(i) against the same
+*   by iterator. Informational only. No test.
+*/
+void bench_PriorityQueueIteration(StringBuilder* log) {
+  const int sizes[] = {4, 16, 64, 256};
+  uint32_t vals[256];
+  for (int i = 0; i < 256; i++) vals[i] = randomInt();
+  log->concat("\t Members   get(i) ns/broadcast   iterator ns/broadcast\n");
+  for (unsigned int s = 0; s < sizeof(sizes) / sizeof(int); s++) {
+    const int n      = sizes[s];
+    const int ROUNDS = 200000 / n;
+    PriorityQueue<uint32_t*> queue0;
+    for (int i = 0; i < n; i++) queue0.insert(&vals[i]);
+    uint32_t sum0 = 0;
+    uint32_t sum1 = 0;
+    unsigned long t0 = micros();
+    for (int r = 0; r < ROUNDS; r++) {
+      for (int i = 0; i < queue0.size(); i++) sum0 += *queue0.get(i);
+    }
+    unsigned long t1 = micros();
+    for (int r = 0; r < ROUNDS; r++) {
+      for (uint32_t* v : queue0) sum1 += *v;
+    }
+    unsigned long t2 = micros();
+    log->concatf("\t %7d   %19.1f   %21.1f%s\n", n,
+      ((t1 - t0) * 1000.0) / ROUNDS, ((t2 - t1) * 1000.0) / ROUNDS,
+      ((sum0 == sum1) ? "" : "   (sums disagree!)")
+    );
+  }
+}
+
+
 int test_PriorityQueue(void) {
   StringBuilder log("===< PriorityQueue >====================================\n");
   int return_value = -1;
   if (0 == test_PriorityQueue0(&log)) {
     if (0 == test_PriorityQueue1(&log)) {
-      return_value = 0;
+      if (0 == test_PriorityQueue2(&log)) {
+        bench_PriorityQueueIteration(&log);
+        return_value = 0;
+      }
     }
   }
 
@@ -340,6 +612,298 @@ int test_PriorityQueue(void) {
 }
 
 
+#define RUNQUEUE_TEST_MSG_COUNT   300
+
+/**
+* Measures raise/dequeue throughput for the Kernel's RunQueue against the
+*   PriorityQueue template it replaced. Informational only. No test.
+*/
+void bench_RunQueue(StringBuilder* log, ManuvrMsg* msgs) {
+  const int ROUNDS = 100;
+  PriorityQueue<ManuvrMsg*> pq;
+  RunQueue<ManuvrMsg> rq;
+
+  unsigned long t0 = micros();
+  for (int r = 0; r < ROUNDS; r++) {
+    for (int i = 0; i < RUNQUEUE_TEST_MSG_COUNT; i++) {
+      if (!pq.contains(&msgs[i])) pq.insert(&msgs[i], msgs[i].priority());
+    }
+    while (pq.hasNext()) pq.dequeue();
+  }
+  unsigned long t1 = micros();
+  for (int r = 0; r < ROUNDS; r++) {
+    for (int i = 0; i < RUNQUEUE_TEST_MSG_COUNT; i++) {
+      rq.insert(&msgs[i]);
+    }
+    while (rq.hasNext()) rq.dequeue();
+  }
+  unsigned long t2 = micros();
+
+  unsigned long ops = ROUNDS * RUNQUEUE_TEST_MSG_COUNT;
+  log->concatf("\t Raise/dequeue %lu msgs at depth %d:\n", ops, RUNQUEUE_TEST_MSG_COUNT);
+  log->concatf("\t   PriorityQueue  %8lu us  (%.1f Msg/sec)\n", (t1 - t0), (ops * 1000000.0) / ((t1 - t0) ? (t1 - t0) : 1));
+  log->concatf("\t   RunQueue       %8lu us  (%.1f Msg/sec)\n", (t2 - t1), (ops * 1000000.0) / ((t2 - t1) ? (t2 - t1) : 1));
+}
+
+
+/**
+* The RunQueue must order its elements exactly as PriorityQueue would, and must
+*   refuse double-insertion of the same element.
+* @return 0 on pass. Non-zero otherwise.
+*/
+int test_RunQueue() {
+  int return_value = -1;
+  StringBuilder log("===< RunQueue >=========================================\n");
+  ManuvrMsg* msgs = new ManuvrMsg[RUNQUEUE_TEST_MSG_COUNT];
+  PriorityQueue<ManuvrMsg*> reference;
+  RunQueue<ManuvrMsg> rq;
+
+  for (int i = 0; i < RUNQUEUE_TEST_MSG_COUNT; i++) {
+    msgs[i].repurpose(MANUVR_MSG_SYS_FAULT_REPORT);
+    msgs[i].priority((uint8_t) (randomInt() % 8));
+    reference.insert(&msgs[i], msgs[i].priority());
+    rq.insert(&msgs[i]);
+  }
+
+  if (rq.size() == RUNQUEUE_TEST_MSG_COUNT) {
+    if (-3 == rq.insert(&msgs[7])) {
+      if (rq.contains(&msgs[7]) && rq.remove(&msgs[7]) && !rq.contains(&msgs[7])) {
+        reference.remove(&msgs[7]);
+        if (!rq.remove(&msgs[7]) && (-1 == rq.insert(nullptr))) {
+          bool order_matches = true;
+          while (order_matches && reference.hasNext()) {
+            order_matches = (reference.dequeue() == rq.dequeue());
+          }
+          if (order_matches) {
+            if (!rq.hasNext() && (0 == rq.size()) && (nullptr == rq.dequeue())) {
+              log.concat("\t Ordering matches PriorityQueue.\n");
+              bench_RunQueue(&log, msgs);
+              return_value = 0;
+            }
+            else log.concatf("RunQueue should be empty but reports %d elements.\n", rq.size());
+          }
+          else log.concat("RunQueue dequeue order differs from PriorityQueue.\n");
+        }
+        else log.concat("RunQueue accepted a removal or insertion it ought not to have.\n");
+      }
+      else log.concat("RunQueue failed to remove a queued element.\n");
+    }
+    else log.concat("RunQueue accepted a duplicate insertion.\n");
+  }
+  else log.concatf("RunQueue should hold %d elements but reports %d.\n", RUNQUEUE_TEST_MSG_COUNT, rq.size());
+
+  delete[] msgs;
+  printf("%s\n\n", (const char*) log.string());
+  return return_value;
+}
+
+
+#define TIMERWHEEL_TEST_MSG_COUNT   300
+
+/**
+* Measures the cost of clock ticks as the number of filed schedules grows.
+*   Every schedule that fires is filed again at its own period, as the Kernel
+*   would do. Informational only. No test.
+*/
+void bench_TimerWheel(StringBuilder* log, ManuvrMsg* msgs) {
+  const uint32_t TICKS = 100000;
+  const int counts[] = {10, 100, TIMERWHEEL_TEST_MSG_COUNT};
+  log->concatf("\t Advancing %lu ticks one at a time:\n", (unsigned long) TICKS);
+  for (int c = 0; c < 3; c++) {
+    TimerWheel<ManuvrMsg> tw;
+    uint32_t fired = 0;
+    for (int i = 0; i < counts[c]; i++) {
+      tw.insert(&msgs[i], 50 + (i * 7));
+    }
+    unsigned long t0 = micros();
+    for (uint32_t t = 0; t < TICKS; t++) {
+      tw.advance(1);
+      ManuvrMsg* current = tw.dequeueExpired();
+      while (current) {
+        fired++;
+        tw.insert(current, 50 + ((current - msgs) * 7));
+        current = tw.dequeueExpired();
+      }
+    }
+    unsigned long t1 = micros();
+    log->concatf("\t   %3d schedules  %8lu us  (%.1f ns/tick, %lu fired)\n", counts[c], (t1 - t0), ((t1 - t0) * 1000.0) / TICKS, (unsigned long) fired);
+  }
+}
+
+
+/**
+* Every element filed in the TimerWheel must come due on the advance() call
+*   that carries the clock past its deadline, and not before. Deadlines are
+*   spread across all of the wheels, and some are moved after filing.
+* @return 0 on pass. Non-zero otherwise.
+*/
+int test_TimerWheel() {
+  int return_value = -1;
+  StringBuilder log("===< TimerWheel >=======================================\n");
+  ManuvrMsg* msgs = new ManuvrMsg[TIMERWHEEL_TEST_MSG_COUNT];
+  uint32_t deadlines[TIMERWHEEL_TEST_MSG_COUNT];
+  TimerWheel<ManuvrMsg> tw;
+  int expiries = 0;
+  int mistimed = 0;
+
+  tw.advance(4000000000UL);   // Start close to clock wrap.
+  for (int i = 0; i < TIMERWHEEL_TEST_MSG_COUNT; i++) {
+    uint32_t delay = 1 + (randomInt() % (1UL << (4 + (i % 20))));
+    deadlines[i] = tw.now() + delay;
+    tw.insert(&msgs[i], delay);
+  }
+  // Move some deadlines in both directions, and drop one entirely.
+  for (int i = 0; i < TIMERWHEEL_TEST_MSG_COUNT; i += 10) {
+    uint32_t delay = 1 + (randomInt() % 5000);
+    deadlines[i] = tw.now() + delay;
+    tw.insert(&msgs[i], delay);
+  }
+  tw.remove(&msgs[5]);
+
+  if ((TIMERWHEEL_TEST_MSG_COUNT - 1) == tw.size()) {
+    if (!tw.remove(&msgs[5]) && (-1 == tw.insert(nullptr, 1))) {
+      while ((tw.size() > 0) && (0 == mistimed)) {
+        uint32_t before = tw.now();
+        tw.advance(1 + (randomInt() % 3000));
+        ManuvrMsg* current = tw.dequeueExpired();
+        while (current) {
+          int idx = current - msgs;
+          uint32_t since_before = deadlines[idx] - before;
+          uint32_t span         = tw.now() - before;
+          if ((0 == since_before) || (since_before > span) || (tw.overdue(current) != (tw.now() - deadlines[idx]))) {
+            log.concatf("Element %d (deadline %u) came due between %u and %u.\n", idx, deadlines[idx], before, tw.now());
+            mistimed++;
+          }
+          expiries++;
+          current = tw.dequeueExpired();
+        }
+      }
+      if (0 == mistimed) {
+        if ((TIMERWHEEL_TEST_MSG_COUNT - 1) == expiries) {
+          log.concatf("\t All %d deadlines met across clock wrap.\n", expiries);
+          bench_TimerWheel(&log, msgs);
+          return_value = 0;
+        }
+        else log.concatf("TimerWheel expired %d elements. Expected %d.\n", expiries, TIMERWHEEL_TEST_MSG_COUNT - 1);
+      }
+    }
+    else log.concat("TimerWheel accepted a removal or insertion it ought not to have.\n");
+  }
+  else log.concatf("TimerWheel should hold %d elements but reports %d.\n", TIMERWHEEL_TEST_MSG_COUNT - 1, tw.size());
+
+  delete[] msgs;
+  printf("%s\n\n", (const char*) log.string());
+  return return_value;
+}
+
+
+#define MPSC_TEST_THREADS     8
+#define MPSC_TEST_MSG_COUNT   64
+#define MPSC_TEST_PUSHES      20000    // Successful pushes, per thread.
+
+/* Shared state for the MPSCQueue stress test. */
+MPSCQueue<ManuvrMsg>* mpsc_queue = nullptr;
+ManuvrMsg*            mpsc_msgs  = nullptr;
+uint32_t mpsc_pushed[MPSC_TEST_MSG_COUNT];      // Successful pushes, per Msg.
+uint32_t mpsc_popped[MPSC_TEST_MSG_COUNT];      // Dequeues, per Msg. Consumer-only.
+uint32_t mpsc_refused   = 0;                    // Pushes refused as already pending.
+int      mpsc_producing = 0;                    // Producers still running.
+
+/* Producers all fight over the same small set of Msgs. */
+void* mpsc_producer(void* arg) {
+  uint32_t seed = (uint32_t) (uintptr_t) arg;
+  int i = 0;
+  while (i < MPSC_TEST_PUSHES) {
+    seed = (seed * 1103515245) + 12345;
+    int idx = (seed >> 16) % MPSC_TEST_MSG_COUNT;
+    if (0 == mpsc_queue->push(&mpsc_msgs[idx])) {
+      __atomic_add_fetch(&mpsc_pushed[idx], 1, __ATOMIC_RELAXED);
+      i++;
+    }
+    else {
+      // Still pending. Give the consumer a chance if we are sharing a core.
+      __atomic_add_fetch(&mpsc_refused, 1, __ATOMIC_RELAXED);
+      sched_yield();
+    }
+  }
+  __atomic_sub_fetch(&mpsc_producing, 1, __ATOMIC_RELEASE);
+  return nullptr;
+}
+
+
+/**
+* Hammers the MPSCQueue that carries events in from ISRs and foreign threads.
+*   Every successful push must come out of the queue exactly once. Nothing
+*   may be lost, and nothing may be duplicated.
+* @return 0 on pass. Non-zero otherwise.
+*/
+int test_MPSCQueue() {
+  int return_value = -1;
+  StringBuilder log("===< MPSCQueue >========================================\n");
+  MPSCQueue<ManuvrMsg> q;
+  pthread_t threads[MPSC_TEST_THREADS];
+  mpsc_queue = &q;
+  mpsc_msgs  = new ManuvrMsg[MPSC_TEST_MSG_COUNT];
+  for (int i = 0; i < MPSC_TEST_MSG_COUNT; i++) {
+    mpsc_pushed[i] = 0;
+    mpsc_popped[i] = 0;
+  }
+
+  if ((0 == q.push(&mpsc_msgs[0])) && (-3 == q.push(&mpsc_msgs[0])) && (-1 == q.push(nullptr))) {
+    if (q.remove(&mpsc_msgs[0]) && !q.contains(&mpsc_msgs[0]) && (nullptr == q.dequeue())) {
+      unsigned long t0 = micros();
+      mpsc_producing = MPSC_TEST_THREADS;
+      for (int i = 0; i < MPSC_TEST_THREADS; i++) {
+        pthread_create(&threads[i], nullptr, mpsc_producer, (void*) (uintptr_t) (i + 1));
+      }
+      // We are the consumer.
+      uint32_t popped = 0;
+      bool     still_producing = true;
+      while (still_producing || q.hasNext()) {
+        still_producing = (0 < __atomic_load_n(&mpsc_producing, __ATOMIC_ACQUIRE));
+        ManuvrMsg* current = q.dequeue();
+        if (nullptr == current) sched_yield();
+        while (current) {
+          mpsc_popped[current - mpsc_msgs]++;
+          popped++;
+          current = q.dequeue();
+        }
+      }
+      unsigned long t1 = micros();
+      for (int i = 0; i < MPSC_TEST_THREADS; i++) {
+        pthread_join(threads[i], nullptr);
+      }
+
+      int mismatches = 0;
+      for (int i = 0; i < MPSC_TEST_MSG_COUNT; i++) {
+        if (mpsc_pushed[i] != mpsc_popped[i]) {
+          log.concatf("Msg %d was pushed %u times, but dequeued %u times.\n", i, mpsc_pushed[i], mpsc_popped[i]);
+          mismatches++;
+        }
+      }
+      if (0 == mismatches) {
+        if ((MPSC_TEST_THREADS * MPSC_TEST_PUSHES) != popped) {
+          log.concatf("Expected %d dequeues, but saw %u.\n", MPSC_TEST_THREADS * MPSC_TEST_PUSHES, popped);
+        }
+        else if ((0 == q.size()) && (nullptr == q.dequeue())) {
+          log.concatf("\t %d threads made %u pushes (%u refused as pending) in %lu us.\n", MPSC_TEST_THREADS, popped, mpsc_refused, (t1 - t0));
+          log.concatf("\t %.1f pushes/sec. Nothing lost or duplicated.\n", (popped * 1000000.0) / ((t1 - t0) ? (t1 - t0) : 1));
+          return_value = 0;
+        }
+        else log.concatf("MPSCQueue should be empty but reports %d elements.\n", q.size());
+      }
+    }
+    else log.concat("MPSCQueue failed to remove a pending element.\n");
+  }
+  else log.concat("MPSCQueue accepted a push it ought not to have.\n");
+
+  delete[] mpsc_msgs;
+  mpsc_queue = nullptr;
+  printf("%s\n\n", (const char*) log.string());
+  return return_value;
+}
+
+
 /*
 * These tests are meant to test the memory-management implications of
 *   the Argument class.
@@ -814,6 +1378,168 @@ int test_Arguments_PODs() {
 }
 
 
+/**
+* Vectors and doubles passed by value should live inside the Argument, and
+*   Arguments themselves should come back to the slab they came from.
+* @return 0 on pass. Non-zero otherwise.
+*/
+int test_Arguments_Inline() {
+  int return_value = -1;
+  StringBuilder log("===< Arguments Inline and Slab >========================\n");
+  Vector3<float> val0(0.5f, -0.25f, 0.2319f);
+  Vector4f       val1(1.0f, 2.0f, -3.0f, 4.5f);
+  double         val2 = ((uint32_t) randomInt()) / ((double) randomInt());
+
+  unsigned long a0 = heap_allocs;
+  Argument* a = new Argument(val0);
+  a->append(val1);
+  a->append(val2);
+  unsigned long allocs = heap_allocs - a0;
+
+  // Scribbling on the originals must not affect the copies.
+  val0(9.0f, 9.0f, 9.0f);
+  Vector3<float> ret0(0.0f, 0.0f, 0.0f);
+  Vector4f       ret1(0.0f, 0.0f, 0.0f, 0.0f);
+  double         ret2 = 0.0;
+
+  if ((0 == a->getValueAs(&ret0)) && (0.5f == ret0.x) && (-0.25f == ret0.y) && (0.2319f == ret0.z)) {
+    if ((0 == a->getValueAs(1, &ret1)) && (1.0f == ret1.x) && (2.0f == ret1.y) && (-3.0f == ret1.z) && (4.5f == ret1.w)) {
+      if ((0 == a->getValueAs(2, &ret2)) && (ret2 == val2)) {
+        #if (ARGUMENT_PREALLOC_COUNT > 0)
+          if (0 == allocs) {
+            a->printDebug(&log);
+            delete a;
+            // Churn well beyond the slab's capacity. Nothing should leak, and
+            //   the overflow should go to the heap and come back.
+            const int CHURN = ARGUMENT_PREALLOC_COUNT * 3;
+            Argument* held[CHURN];
+            for (int i = 0; i < CHURN; i++) held[i] = new Argument((uint32_t) i);
+            for (int i = 0; i < CHURN; i++) delete held[i];
+            Argument* b = new Argument((uint32_t) 7);
+            a0 = heap_allocs;
+            delete b;
+            b = new Argument((uint32_t) 8);
+            allocs = heap_allocs - a0;
+            delete b;
+            if (0 == allocs) {
+              Argument::printPool(&log);
+              return_value = 0;
+            }
+            else log.concat("A freshly-returned slab cell was not reused.\n");
+          }
+          else {
+            log.concatf("Building three inline Arguments cost %lu heap allocations.\n", allocs);
+            delete a;
+          }
+        #else
+          delete a;
+          return_value = 0;
+        #endif
+        a = nullptr;
+      }
+      else log.concatf("double failed (%.20f vs %.20f)...\n", ret2, val2);
+    }
+    else log.concat("Vector4f failed.\n");
+  }
+  else log.concatf("Vector3f failed (%.4f, %.4f, %.4f).\n", (double) ret0.x, (double) ret0.y, (double) ret0.z);
+
+  if (nullptr != a) delete a;
+  printf("%s\n\n", (const char*) log.string());
+  return return_value;
+}
+
+
+/**
+* Times a Msg's trip through raise, dispatch, and reclaim, with a few
+*   arguments. The Kernel's queue is left out, since it is measured
+*   elsewhere. Informational only. No test.
+*/
+void bench_MsgArguments(StringBuilder* log) {
+  const int ROUNDS = 50000;
+  ManuvrMsg msg;
+  log->concat("\t Args   ns/msg (slab)  allocs/msg   ns/msg (heap)  allocs/msg\n");
+  for (int n = 0; n <= 4; n++) {
+    unsigned long elapsed[2];
+    unsigned long allocs[2];
+    for (int mode = 0; mode < 2; mode++) {
+      #if (ARGUMENT_PREALLOC_COUNT > 0)
+        // Exhaust the slab to see what the heap would have cost.
+        Argument* hog[ARGUMENT_PREALLOC_COUNT];
+        for (int i = 0; i < ARGUMENT_PREALLOC_COUNT; i++) hog[i] = (1 == mode) ? new Argument((uint8_t) 0) : nullptr;
+      #endif
+      unsigned long a0 = heap_allocs;
+      unsigned long t0 = micros();
+      for (int r = 0; r < ROUNDS; r++) {
+        msg.repurpose(MANUVR_MSG_UNDEFINED);
+        for (int i = 0; i < n; i++) msg.addArg((uint32_t) r);
+        uint32_t sum = 0;
+        for (int i = 0; i < n; i++) {
+          uint32_t v = 0;
+          msg.getArgAs(i, &v);
+          sum += v;
+        }
+        if (sum != ((uint32_t) r * n)) log->concat("\t Argument corruption!\n");
+        msg.clearArgs();
+      }
+      elapsed[mode] = micros() - t0;
+      allocs[mode]  = heap_allocs - a0;
+      #if (ARGUMENT_PREALLOC_COUNT > 0)
+        for (int i = 0; i < ARGUMENT_PREALLOC_COUNT; i++) if (nullptr != hog[i]) delete hog[i];
+      #endif
+    }
+    log->concatf("\t %4d   %13.1f  %10.2f   %13.1f  %10.2f\n", n,
+      (elapsed[0] * 1000.0) / ROUNDS, ((double) allocs[0]) / ROUNDS,
+      (elapsed[1] * 1000.0) / ROUNDS, ((double) allocs[1]) / ROUNDS
+    );
+  }
+}
+
+
+/**
+* Positional access to a Msg's Arguments, both within and beyond the index.
+* @return 0 on pass. Non-zero otherwise.
+*/
+int test_MsgArguments() {
+  int return_value = -1;
+  StringBuilder log("===< ManuvrMsg Arguments >==============================\n");
+  ManuvrMsg msg;
+  const int ARG_COUNT = MANUVR_MSG_ARG_INDEX_DEPTH + 3;
+  bool good = (TCode::NONE == msg.getArgumentType(0));
+  for (int n = 0; good && (n < ARG_COUNT); n++) {
+    msg.addArg((uint32_t) (n * 1000));
+    good = (n + 1 == msg.argCount());
+    for (int i = 0; good && (i <= n); i++) {
+      uint32_t v = 0xFFFFFFFF;
+      good = (0 == msg.getArgAs(i, &v)) && ((uint32_t) (i * 1000) == v);
+      if (!good) log.concatf("With %d args, arg %d was wrong (%u).\n", n + 1, i, v);
+    }
+    good = good && (TCode::NONE == msg.getArgumentType(n + 1));
+  }
+  if (good) {
+    // Reclaim and reuse.
+    msg.clearArgs();
+    uint8_t ret = 0;
+    good = (0 == msg.argCount()) && (0 != msg.getArgAs(0, &ret));
+    msg.addArg((uint8_t) 42);
+    good = good && (0 == msg.getArgAs(0, &ret)) && (42 == ret);
+    Argument* taken = msg.takeArgs();
+    good = good && (nullptr != taken) && (0 == msg.argCount()) && (TCode::NONE == msg.getArgumentType(0));
+    msg.addArg((uint8_t) 43);
+    good = good && (0 == msg.getArgAs(0, &ret)) && (43 == ret);
+    if (taken) delete taken;
+    msg.clearArgs();
+    if (good) {
+      bench_MsgArguments(&log);
+      return_value = 0;
+    }
+    else log.concat("Argument index is stale after clearArgs() or takeArgs().\n");
+  }
+
+  printf("%s\n\n", (const char*) log.string());
+  return return_value;
+}
+
+
 int test_Arguments() {
   int return_value = test_Arguments_KVP();
   if (0 == return_value) {
@@ -822,6 +1548,12 @@ int test_Arguments() {
       return_value = test_Arguments_PODs();
       if (0 == return_value) {
         return_value = test_Argument_Value_Placement();
+        if (0 == return_value) {
+          return_value = test_Arguments_Inline();
+        }
+        if (0 == return_value) {
+          return_value = test_MsgArguments();
+        }
         if (0 == return_value) {
         #if defined(MANUVR_CBOR)
           return_value = test_CBOR_Argument();
@@ -839,6 +1571,104 @@ int test_Arguments() {
 }
 
 
+#define MSGDEF_TEST_EXT_COUNT   64
+#define MSGDEF_TEST_EXT_BASE    0x6000
+
+/**
+* Compares message definition lookup against the linear scan and std::map
+*   that it replaced. Informational only. No test.
+*/
+void bench_MsgDefLookup(StringBuilder* log, std::map<uint16_t, const MessageTypeDef*>* ref_map) {
+  const int ROUNDS = 2000;
+  const int n_builtin = ManuvrMsg::TOTAL_MSG_DEFS;
+  uintptr_t junk = 0;
+
+  unsigned long t0 = micros();
+  for (int r = 0; r < ROUNDS; r++) {
+    for (int i = 0; i < n_builtin; i++) {
+      uint16_t code = ManuvrMsg::message_defs[i].msg_type_code;
+      for (int n = 0; n < n_builtin; n++) {
+        if (ManuvrMsg::message_defs[n].msg_type_code == code) {
+          junk += (uintptr_t) &ManuvrMsg::message_defs[n];
+          break;
+        }
+      }
+    }
+    for (int i = 0; i < MSGDEF_TEST_EXT_COUNT; i++) {
+      junk += (uintptr_t) (*ref_map)[MSGDEF_TEST_EXT_BASE + i];
+    }
+  }
+  unsigned long t1 = micros();
+  for (int r = 0; r < ROUNDS; r++) {
+    for (int i = 0; i < n_builtin; i++) {
+      junk += (uintptr_t) ManuvrMsg::lookupMsgDefByCode(ManuvrMsg::message_defs[i].msg_type_code);
+    }
+    for (int i = 0; i < MSGDEF_TEST_EXT_COUNT; i++) {
+      junk += (uintptr_t) ManuvrMsg::lookupMsgDefByCode(MSGDEF_TEST_EXT_BASE + i);
+    }
+  }
+  unsigned long t2 = micros();
+
+  unsigned long ops = ROUNDS * (n_builtin + MSGDEF_TEST_EXT_COUNT);
+  log->concatf("\t %lu lookups (%d built-in codes, %d registered):\n", ops, n_builtin, MSGDEF_TEST_EXT_COUNT);
+  log->concatf("\t   Linear + std::map  %8lu us  (%.1f ns/lookup)\n", (t1 - t0), ((t1 - t0) * 1000.0) / ops);
+  log->concatf("\t   Hash index         %8lu us  (%.1f ns/lookup)\n", (t2 - t1), ((t2 - t1) * 1000.0) / ops);
+  if (0 == junk) log->concat("\t (junk)\n");
+}
+
+
+/**
+* Every built-in and registered code must be found, unknown codes must map to
+*   the UNDEFINED def, and misses must not grow the table.
+* @return 0 on pass. Non-zero otherwise.
+*/
+int test_MsgDefLookup() {
+  int return_value = -1;
+  StringBuilder log("===< MessageTypeDef lookup >============================\n");
+  std::map<uint16_t, const MessageTypeDef*> ref_map;
+  static MessageTypeDef ext_defs[MSGDEF_TEST_EXT_COUNT];
+  for (int i = 0; i < MSGDEF_TEST_EXT_COUNT; i++) {
+    ext_defs[i].msg_type_code  = MSGDEF_TEST_EXT_BASE + i;
+    ext_defs[i].msg_type_flags = (i & 1) ? MSG_FLAG_EXPORTABLE : 0;
+    ext_defs[i].debug_label    = "MSGDEF_TEST";
+    ext_defs[i].arg_modes      = ManuvrMsg::MSG_ARGS_NONE;
+    ref_map[ext_defs[i].msg_type_code] = &ext_defs[i];
+  }
+  int prior_count = ManuvrMsg::registeredMessageCount();
+
+  if (0 == ManuvrMsg::registerMessages(ext_defs, MSGDEF_TEST_EXT_COUNT)) {
+    bool all_found = true;
+    for (int i = 0; all_found && (i < ManuvrMsg::TOTAL_MSG_DEFS); i++) {
+      all_found = (&ManuvrMsg::message_defs[i] == ManuvrMsg::lookupMsgDefByCode(ManuvrMsg::message_defs[i].msg_type_code));
+      if (!all_found) log.concatf("Failed to find built-in code 0x%04x.\n", ManuvrMsg::message_defs[i].msg_type_code);
+    }
+    for (int i = 0; all_found && (i < MSGDEF_TEST_EXT_COUNT); i++) {
+      all_found = (&ext_defs[i] == ManuvrMsg::lookupMsgDefByCode(ext_defs[i].msg_type_code));
+      if (!all_found) log.concatf("Failed to find registered code 0x%04x.\n", ext_defs[i].msg_type_code);
+    }
+    if (all_found) {
+      const MessageTypeDef* undef = ManuvrMsg::lookupMsgDefByCode(MSGDEF_TEST_EXT_BASE + MSGDEF_TEST_EXT_COUNT);
+      if ((&ManuvrMsg::message_defs[0] == undef) && (0 == strcmp("<UNDEF>", ManuvrMsg::getMsgTypeString(0xFFFE)))) {
+        if ((prior_count + MSGDEF_TEST_EXT_COUNT) == ManuvrMsg::registeredMessageCount()) {
+          // Redefinition replaces, and doesn't add.
+          if ((0 == ManuvrMsg::registerMessages(ext_defs, 1)) && ((prior_count + MSGDEF_TEST_EXT_COUNT) == ManuvrMsg::registeredMessageCount())) {
+            bench_MsgDefLookup(&log, &ref_map);
+            return_value = 0;
+          }
+          else log.concat("Re-registering a code changed the registered count.\n");
+        }
+        else log.concatf("Expected %d registered defs, but have %d.\n", prior_count + MSGDEF_TEST_EXT_COUNT, ManuvrMsg::registeredMessageCount());
+      }
+      else log.concat("Unknown codes should map to the UNDEFINED def.\n");
+    }
+  }
+  else log.concat("Failed to register message defs.\n");
+
+  printf("%s\n\n", (const char*) log.string());
+  return return_value;
+}
+
+
 int test_RingBuffer() {
   int return_value = -1;
   StringBuilder log("===< RingBuffer >=======================================\n");
@@ -912,6 +1742,310 @@ int test_RingBuffer() {
 }
 
 
+#define SPSC_TEST_ELEMENTS   1000000
+#define SPSC_TEST_CAPACITY   1000      // Will round up to 1024.
+#define SPSC_TEST_CHUNK      37        // Bulk transfers, deliberately not a divisor.
+
+/* Shared state for the SPSCRingBuffer stress test and benchmark. */
+SPSCRingBuffer<uint32_t>* spsc_ring  = nullptr;
+RingBuffer<uint32_t>*     spsc_ref   = nullptr;
+pthread_mutex_t           spsc_mutex = PTHREAD_MUTEX_INITIALIZER;
+int                       spsc_bulk  = 0;
+
+/* Produces a counting sequence, mixing single and bulk writes. */
+void* spsc_producer(void* arg) {
+  uint32_t next = 0;
+  uint32_t chunk[SPSC_TEST_CHUNK];
+  while (next < SPSC_TEST_ELEMENTS) {
+    if (spsc_bulk && (next & 1)) {
+      unsigned int n = SPSC_TEST_CHUNK;
+      if (n > (SPSC_TEST_ELEMENTS - next)) n = SPSC_TEST_ELEMENTS - next;
+      for (unsigned int i = 0; i < n; i++) chunk[i] = next + i;
+      unsigned int taken = spsc_ring->write(chunk, n);
+      next += taken;
+      if (0 == taken) sched_yield();
+    }
+    else if (0 == spsc_ring->insert(next)) {
+      next++;
+    }
+    else {
+      sched_yield();   // Full. Give the consumer a chance if we are sharing a core.
+    }
+  }
+  return nullptr;
+}
+
+/* The same sequence through the old RingBuffer, which needs a lock. */
+void* spsc_ref_producer(void* arg) {
+  uint32_t next = 0;
+  while (next < SPSC_TEST_ELEMENTS) {
+    pthread_mutex_lock(&spsc_mutex);
+    int ret = spsc_ref->insert(next);
+    pthread_mutex_unlock(&spsc_mutex);
+    if (0 == ret) {
+      next++;
+    }
+    else {
+      sched_yield();
+    }
+  }
+  return nullptr;
+}
+
+
+/**
+* Consumes the counting sequence from the SPSCRingBuffer, mixing single and
+*   bulk reads.
+* @return the number of elements that arrived out of order.
+*/
+unsigned int spsc_consume() {
+  uint32_t expected = 0;
+  unsigned int errors = 0;
+  uint32_t chunk[SPSC_TEST_CHUNK];
+  uint32_t val;
+  while (expected < SPSC_TEST_ELEMENTS) {
+    if (spsc_bulk && (expected & 2)) {
+      unsigned int n = spsc_ring->read(chunk, SPSC_TEST_CHUNK);
+      if (0 == n) sched_yield();
+      for (unsigned int i = 0; i < n; i++) {
+        if (chunk[i] != expected++) errors++;
+      }
+    }
+    else if (0 == spsc_ring->get(&val)) {
+      if (val != expected++) errors++;
+    }
+    else {
+      sched_yield();
+    }
+  }
+  return errors;
+}
+
+
+/**
+* Moves the same sequence through the locked RingBuffer, the SPSCRingBuffer
+*   one element at a time, and the SPSCRingBuffer in bulk. Informational only.
+*/
+void bench_SPSCRingBuffer(StringBuilder* log) {
+  pthread_t thread;
+  unsigned long elapsed[3];
+  RingBuffer<uint32_t> ref(SPSC_TEST_CAPACITY);
+  spsc_ref = &ref;
+
+  unsigned long t0 = micros();
+  pthread_create(&thread, nullptr, spsc_ref_producer, nullptr);
+  uint32_t expected = 0;
+  while (expected < SPSC_TEST_ELEMENTS) {
+    pthread_mutex_lock(&spsc_mutex);
+    unsigned int avail = ref.count();
+    for (unsigned int i = 0; i < avail; i++) {
+      if (ref.get() == expected) expected++;
+    }
+    pthread_mutex_unlock(&spsc_mutex);
+    if (0 == avail) sched_yield();
+  }
+  pthread_join(thread, nullptr);
+  elapsed[0] = micros() - t0;
+
+  for (int mode = 0; mode < 2; mode++) {
+    spsc_bulk = mode;
+    t0 = micros();
+    pthread_create(&thread, nullptr, spsc_producer, nullptr);
+    spsc_consume();
+    pthread_join(thread, nullptr);
+    elapsed[1 + mode] = micros() - t0;
+  }
+  spsc_bulk = 0;
+
+  const char* labels[3] = { "RingBuffer + mutex ", "SPSC insert()/get()", "SPSC mixed bulk    " };
+  log->concatf("\t %u elements from a producer thread:\n", SPSC_TEST_ELEMENTS);
+  for (int i = 0; i < 3; i++) {
+    log->concatf("\t   %s  %8lu us  (%.1f M/s)\n", labels[i], elapsed[i], SPSC_TEST_ELEMENTS / (double) (elapsed[i] ? elapsed[i] : 1));
+  }
+}
+
+
+/**
+* Checks the single-threaded semantics of the SPSCRingBuffer, and then hammers
+*   it from a producer thread. Every element must arrive, in order.
+* @return 0 on pass. Non-zero otherwise.
+*/
+int test_SPSCRingBuffer() {
+  int return_value = -1;
+  StringBuilder log("===< SPSCRingBuffer >===================================\n");
+  SPSCRingBuffer<uint32_t> a(18);
+  uint32_t val  = 0;
+  uint32_t buf[32];
+  if (a.allocated() && (32 == a.capacity()) && (0 == a.count())) {
+    bool ok = true;
+    for (uint32_t i = 0; ok && (i < 32); i++) ok = (0 == a.insert(i));
+    ok = ok && (-1 == a.insert(99)) && (32 == a.count()) && (0 == a.vacancy());
+    for (uint32_t i = 0; ok && (i < 20); i++) ok = ((0 == a.get(&val)) && (i == val));
+    // This write wraps around the end of the pool.
+    for (uint32_t i = 0; i < 32; i++) buf[i] = 100 + i;
+    ok = ok && (20 == a.write(buf, 32)) && (0 == a.write(buf, 1));
+    ok = ok && (4 == a.peek(buf, 4)) && (20 == buf[0]) && (23 == buf[3]) && (32 == a.count());
+    ok = ok && (12 == a.skip(12)) && (5 == a.read(buf, 5)) && (100 == buf[0]) && (104 == buf[4]);
+    ok = ok && (15 == a.read(buf, 32)) && (105 == buf[0]) && (119 == buf[14]);
+    ok = ok && (-1 == a.get(&val)) && (0 == a.read(buf, 1)) && (0 == a.count());
+    if (ok) {
+      SPSCRingBuffer<uint32_t> b(SPSC_TEST_CAPACITY);
+      spsc_ring = &b;
+      unsigned int errors = 0;
+      for (int mode = 0; mode < 2; mode++) {
+        pthread_t thread;
+        spsc_bulk = mode;
+        pthread_create(&thread, nullptr, spsc_producer, nullptr);
+        errors += spsc_consume();
+        pthread_join(thread, nullptr);
+      }
+      spsc_bulk = 0;
+      if ((0 == errors) && (0 == b.count())) {
+        log.concatf("\t %u elements, twice, in order.\n", SPSC_TEST_ELEMENTS);
+        bench_SPSCRingBuffer(&log);
+        return_value = 0;
+      }
+      else log.concatf("%u elements arrived out of order. %u left over.\n", errors, b.count());
+      spsc_ring = nullptr;
+    }
+    else log.concat("Single-threaded semantics are broken.\n");
+  }
+  else log.concatf("Expected an empty buffer of 32. Got %u of %u.\n", a.count(), a.capacity());
+
+  printf("%s\n\n", (const char*) log.string());
+  return return_value;
+}
+
+
+#if defined(MANUVR_EVENT_PROFILER)
+static int _cmp_uint32(const void* a, const void* b) {
+  const uint32_t x = *((const uint32_t*) a);
+  const uint32_t y = *((const uint32_t*) b);
+  return (x < y) ? -1 : ((x > y) ? 1 : 0);
+}
+
+
+/**
+* Compares the Kernel's per-code profiler against the linear scan and
+*   PriorityQueue it replaced. Informational only. No test.
+*/
+void bench_MsgProfiler(StringBuilder* log) {
+  const int CODES  = 48;
+  const int EVENTS = 200000;
+  uint16_t codes[EVENTS];
+  for (int i = 0; i < EVENTS; i++) codes[i] = 0x4000 + (randomInt() % CODES);
+
+  PriorityQueue<TaskProfilerData*> old_costs;
+  unsigned long t0 = micros();
+  for (int e = 0; e < EVENTS; e++) {
+    TaskProfilerData* item = nullptr;
+    int cost_size = old_costs.size();
+    for (int i = 0; (nullptr == item) && (i < cost_size); i++) {
+      if (old_costs.get(i)->msg_code == codes[e]) item = old_costs.get(i);
+    }
+    if (nullptr == item) {
+      item = new TaskProfilerData();
+      item->msg_code = codes[e];
+      old_costs.insert(item, 1);
+    }
+    else {
+      old_costs.incrementPriority(item);
+    }
+    item->executions++;
+  }
+  unsigned long t1 = micros();
+  MsgProfiler profiler;
+  for (int e = 0; e < EVENTS; e++) {
+    TaskProfilerData* item = profiler.profile(codes[e]);
+    item->noteRunTime(e & 0x3FF);
+    item->noteWaitTime(e & 0xFF);
+  }
+  unsigned long t2 = micros();
+  while (old_costs.hasNext()) delete old_costs.dequeue();
+
+  log->concatf("\t %d events over %d codes:\n", EVENTS, CODES);
+  log->concatf("\t   Scan + PriorityQueue (count only)  %8lu us  (%.1f ns/event)\n", (t1 - t0), ((t1 - t0) * 1000.0) / EVENTS);
+  log->concatf("\t   MsgProfiler (two histograms)       %8lu us  (%.1f ns/event)\n", (t2 - t1), ((t2 - t1) * 1000.0) / EVENTS);
+}
+#endif  // MANUVR_EVENT_PROFILER
+
+
+/**
+* Histogram geometry and accuracy, and the code-indexed table that holds them.
+* @return 0 on pass. Non-zero otherwise.
+*/
+int test_MsgProfiler() {
+  int return_value = -1;
+  StringBuilder log("===< MsgProfiler >======================================\n");
+  #if defined(MANUVR_EVENT_PROFILER)
+    // The buckets must tile the entire range of uint32, in order.
+    bool tiled = (0 == LatencyHistogram::bucketFloor(0)) && (0xFFFFFFFF == LatencyHistogram::bucketCeiling(MSG_PROFILER_BUCKETS - 1));
+    for (int i = 0; tiled && (i < MSG_PROFILER_BUCKETS); i++) {
+      tiled = (i == LatencyHistogram::bucketOf(LatencyHistogram::bucketFloor(i)));
+      tiled = tiled && (i == LatencyHistogram::bucketOf(LatencyHistogram::bucketCeiling(i)));
+      if (i > 0) tiled = tiled && (LatencyHistogram::bucketFloor(i) == (LatencyHistogram::bucketCeiling(i - 1) + 1));
+      if (!tiled) log.concatf("Bucket %d is misplaced (%u - %u).\n", i, LatencyHistogram::bucketFloor(i), LatencyHistogram::bucketCeiling(i));
+    }
+
+    if (tiled) {
+      // Mostly fast, with a long tail. Every percentile must be no less than
+      //   the exact answer, and no more than one sub-bucket above it.
+      const int SAMPLES = 20000;
+      uint32_t* samples = (uint32_t*) malloc(SAMPLES * sizeof(uint32_t));
+      LatencyHistogram hist;
+      for (int i = 0; i < SAMPLES; i++) {
+        uint32_t r = randomInt();
+        samples[i] = (0 == (r & 0x3F)) ? (r >> 12) : ((r >> 8) % 200);
+        hist.record(samples[i]);
+      }
+      qsort(samples, SAMPLES, sizeof(uint32_t), _cmp_uint32);
+      const uint16_t per_milles[] = {1, 500, 900, 990, 999, 1000};
+      bool accurate = (SAMPLES == (int) hist.count()) && (samples[0] == hist.minimum()) && (samples[SAMPLES - 1] == hist.maximum());
+      for (unsigned int i = 0; accurate && (i < sizeof(per_milles) / sizeof(uint16_t)); i++) {
+        int rank = (SAMPLES * per_milles[i] + 999) / 1000;
+        uint32_t exact = samples[(rank > 0) ? (rank - 1) : 0];
+        uint32_t est   = hist.percentile(per_milles[i]);
+        accurate = (est >= exact) && (est <= (exact + (exact / MSG_PROFILER_SUB_COUNT)));
+        log.concatf("\t p%-5.1f  exact %9u   histogram %9u\n", per_milles[i] / 10.0, exact, est);
+      }
+      free(samples);
+
+      if (accurate) {
+        // Enough codes to force the index to grow a few times.
+        MsgProfiler profiler;
+        bool indexed = (nullptr == profiler.lookup(0x4000));
+        for (int i = 0; indexed && (i < 300); i++) {
+          TaskProfilerData* item = profiler.profile(0x4000 + (i * 7));
+          indexed = (nullptr != item) && ((uint32_t) (0x4000 + (i * 7)) == item->msg_code);
+          if (indexed) item->noteRunTime(i);
+        }
+        for (int i = 0; indexed && (i < 300); i++) {
+          TaskProfilerData* item = profiler.lookup(0x4000 + (i * 7));
+          indexed = (item == profiler.get(i)) && (1 == item->executions) && ((uint32_t) i == item->run_time_last);
+          indexed = indexed && (item == profiler.profile(0x4000 + (i * 7)));
+        }
+        if (indexed && (300 == profiler.size()) && (nullptr == profiler.lookup(0x4001))) {
+          profiler.clear();
+          if ((0 == profiler.size()) && (nullptr == profiler.lookup(0x4000))) {
+            bench_MsgProfiler(&log);
+            return_value = 0;
+          }
+          else log.concat("clear() left something behind.\n");
+        }
+        else log.concatf("Profiler index is broken (%d entries).\n", profiler.size());
+      }
+      else log.concat("Histogram percentiles are out of tolerance.\n");
+    }
+  #else
+    log.concat("\t Not built with MANUVR_EVENT_PROFILER.\n");
+    return_value = 0;
+  #endif  // MANUVR_EVENT_PROFILER
+
+  printf("%s\n\n", (const char*) log.string());
+  return return_value;
+}
+
+
 /**
 * UUID battery.
 * @return 0 on pass. Non-zero otherwise.
@@ -1016,9 +2150,14 @@ void printTypeSizes() {
   output.concatf("\tLinkedList<void*>     %u\n", sizeof(LinkedList<void*>));
   output.concatf("\tPriorityQueue<void*>  %u\n", sizeof(PriorityQueue<void*>));
   output.concatf("\tRingBuffer<void*>     %u\n", sizeof(RingBuffer<void*>));
+  output.concatf("\tSPSCRingBuffer<void*> %u\n", sizeof(SPSCRingBuffer<void*>));
+  output.concatf("\tRunQueue<ManuvrMsg>   %u\n", sizeof(RunQueue<ManuvrMsg>));
+  output.concatf("\tTimerWheel<ManuvrMsg> %u\n", sizeof(TimerWheel<ManuvrMsg>));
+  output.concatf("\tMPSCQueue<ManuvrMsg>  %u\n", sizeof(MPSCQueue<ManuvrMsg>));
   output.concatf("\tArgument              %u\n", sizeof(Argument));
   output.concatf("\tUUID                  %u\n", sizeof(UUID));
   output.concatf("\tTaskProfilerData      %u\n", sizeof(TaskProfilerData));
+  output.concatf("\tLatencyHistogram      %u\n", sizeof(LatencyHistogram));
   output.concatf("\tSensorWrapper         %u\n", sizeof(SensorWrapper));
 
   output.concat("\n-- Core singletons:\n");
@@ -1079,19 +2218,19 @@ int main(int argc, char *argv[]) {
   platform.kernel()->printScheduler(&out);
 
   if (0 == test_StringBuilder()) {
-    if (0 == test_PriorityQueue()) {
+    if ((0 == test_PriorityQueue()) && (0 == test_RunQueue()) && (0 == test_TimerWheel()) && (0 == test_MPSCQueue())) {
       if (0 == vector3_float_test(0.7f, 0.8f, 0.01f)) {
         if (0 == test_Arguments()) {
-          if (0 == test_UUID()) {
-            if (0 == test_RingBuffer()) {
+          if ((0 == test_UUID()) && (0 == test_MsgDefLookup()) && (0 == test_MsgProfiler())) {
+            if ((0 == test_RingBuffer()) && (0 == test_SPSCRingBuffer())) {
               printf("**********************************\n");
               printf("*  DataStructure tests all pass  *\n");
               printf("**********************************\n");
               exit_value = 0;
             }
-            else printTestFailure("RingBuffer");
+            else printTestFailure("RingBuffer or SPSCRingBuffer");
           }
-          else printTestFailure("UUID");
+          else printTestFailure("UUID, MsgDef lookup, or MsgProfiler");
         }
         else printTestFailure("Argument");
       }
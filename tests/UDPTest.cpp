@@ -0,0 +1,415 @@
+/*
+File:   UDPTest.cpp
+Author: J. Ian Lindsay
+Date:   2026.10.18
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Tests for ManuvrUDP, by way of listeners on loopback. Counterparties are plain
+  sockets, driven from this thread.
+
+After the tests, datagrams are thrown at a listener as fast as it will take
+  them, for a few batch sizes and receiver counts.
+*/
+
+#include <cstdio>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include <Platform/Platform.h>
+#include <Transports/ManuvrSocket/ManuvrUDP.h>
+
+#define ECHO_PIPE_CODE   0x7E
+#define SINK_PIPE_CODE   0x7D
+#define MSG_LEN          64
+#define WAIT_LIMIT_US    5000000
+#define BENCH_DATAGRAMS  200000
+#define BENCH_SENDERS    8
+#define BENCH_WINDOW     128    // Datagrams in flight. Keeps us under SO_RCVBUF.
+
+static const uint8_t echo_strategy[] = { ECHO_PIPE_CODE, 0 };
+static const uint8_t sink_strategy[] = { SINK_PIPE_CODE, 0 };
+static int listen_port = 0;
+static volatile uint32_t sunk = 0;
+
+
+/*
+* Sends everything it is given back the way it came.
+*/
+class EchoPipe : public BufferPipe {
+  public:
+    EchoPipe(BufferPipe* n) : BufferPipe() {   setNear(n);   };
+    const char* pipeName() {   return "EchoPipe";   };
+
+    int8_t fromCounterparty(StringBuilder* buf, int8_t mm) {
+      return near()->toCounterparty(buf, mm);
+    };
+    int8_t fromCounterparty(ManuvrPipeSignal sig, void* arg) {   return 0;   };
+};
+
+/*
+* Counts what it is given, and keeps its counterparty around for more.
+*/
+class SinkPipe : public BufferPipe {
+  public:
+    SinkPipe(BufferPipe* n) : BufferPipe() {
+      setNear(n);
+      ((UDPPipe*) n)->persistAfterReply(true);
+    };
+    const char* pipeName() {   return "SinkPipe";   };
+
+    int8_t fromCounterparty(StringBuilder* buf, int8_t mm) {
+      sunk++;
+      return MEM_MGMT_RESPONSIBLE_BEARER;
+    };
+    int8_t fromCounterparty(ManuvrPipeSignal sig, void* arg) {   return 0;   };
+};
+
+static BufferPipe* _echo_factory(BufferPipe* n, BufferPipe*) {
+  return new EchoPipe(n);
+}
+
+static BufferPipe* _sink_factory(BufferPipe* n, BufferPipe*) {
+  return new SinkPipe(n);
+}
+
+
+/*
+* Opens a socket bound to the given loopback address, on any port unless one
+*   is given.
+*/
+static int _bound_client(const char* addr, int port) {
+  int s = socket(AF_INET, SOCK_DGRAM, 0);
+  struct sockaddr_in sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sin_family      = AF_INET;
+  sa.sin_addr.s_addr = inet_addr(addr);
+  sa.sin_port        = htons(port);
+  if (0 != bind(s, (struct sockaddr*) &sa, sizeof(sa))) {
+    close(s);
+    return -1;
+  }
+  return s;
+}
+
+static void _listener_addr(struct sockaddr_in* sa) {
+  memset(sa, 0, sizeof(struct sockaddr_in));
+  sa->sin_family      = AF_INET;
+  sa->sin_addr.s_addr = inet_addr("127.0.0.1");
+  sa->sin_port        = htons(listen_port);
+}
+
+static bool _await_sunk(uint32_t count) {
+  const unsigned long t0 = micros();
+  while (sunk < count) {
+    if ((micros() - t0) > WAIT_LIMIT_US) return false;
+    sleep_millis(1);
+  }
+  return true;
+}
+
+
+/*
+* Two counterparties on the same port, but different addresses, must each get
+*   their own pipe, and their own echo.
+*/
+int test_Echo(StringBuilder* log) {
+  ManuvrUDP listener("127.0.0.1", listen_port);
+  listener.setPipeStrategy(echo_strategy);
+  if (0 != listener.listen()) {
+    log->concatf("Couldn't listen on port %d.\n", listen_port);
+    return -1;
+  }
+  const int cport = listen_port + 1;
+  int a = _bound_client("127.0.0.2", cport);
+  int b = _bound_client("127.0.0.3", cport);
+  if ((0 > a) || (0 > b)) {
+    log->concat("Couldn't bind counterparties on 127.0.0.2 and 127.0.0.3.\n");
+    if (0 <= a) close(a);
+    if (0 <= b) close(b);
+    return -1;
+  }
+  struct sockaddr_in dest;
+  _listener_addr(&dest);
+  const char* msg_a = "Is there anybody out there?";
+  const char* msg_b = "Nobody here but us chickens.";
+  int ret = -1;
+
+  const unsigned long t0 = micros();
+  sendto(a, msg_a, strlen(msg_a), 0, (struct sockaddr*) &dest, sizeof(dest));
+  sendto(b, msg_b, strlen(msg_b), 0, (struct sockaddr*) &dest, sizeof(dest));
+  char buf_a[64];
+  char buf_b[64];
+  ssize_t got_a = 0;
+  ssize_t got_b = 0;
+  while (((0 >= got_a) || (0 >= got_b)) && ((micros() - t0) < WAIT_LIMIT_US)) {
+    if (0 >= got_a) got_a = recv(a, buf_a, sizeof(buf_a), MSG_DONTWAIT);
+    if (0 >= got_b) got_b = recv(b, buf_b, sizeof(buf_b), MSG_DONTWAIT);
+  }
+  const unsigned long rtt = micros() - t0;
+
+  if ((got_a != (ssize_t) strlen(msg_a)) || (0 != memcmp(buf_a, msg_a, got_a))) {
+    log->concat("The first counterparty's echo came back wrong.\n");
+  }
+  else if ((got_b != (ssize_t) strlen(msg_b)) || (0 != memcmp(buf_b, msg_b, got_b))) {
+    log->concat("The second counterparty's echo came back wrong.\n");
+  }
+  else if (2 != listener.peers()) {
+    log->concatf("Expected two counterparties. Found %u.\n", listener.peers());
+  }
+  else if ((nullptr == listener.findPipe(inet_addr("127.0.0.2"), cport)) ||
+           (nullptr == listener.findPipe(inet_addr("127.0.0.3"), cport)) ||
+           (nullptr != listener.findPipe(inet_addr("127.0.0.4"), cport))) {
+    log->concat("The counterparty table doesn't tell addresses apart.\n");
+  }
+  else {
+    log->concatf("\tTwo echoes on one port in %lu us.\n", rtt);
+    ret = 0;
+  }
+  close(a);
+  close(b);
+  return ret;
+}
+
+
+/*
+* Fills the counterparty table well past its first size, and then empties
+*   every other entry. Whatever remains must still be found.
+*/
+int test_PeerTable(StringBuilder* log) {
+  const unsigned int count = 300;
+  ManuvrUDP listener("127.0.0.1", listen_port);
+  listener.setPipeStrategy(sink_strategy);
+  if (0 != listener.listen()) {
+    log->concatf("Couldn't listen on port %d.\n", listen_port);
+    return -1;
+  }
+  int* socks = (int*) malloc(sizeof(int) * count);
+  uint16_t* ports = (uint16_t*) malloc(sizeof(uint16_t) * count);
+  struct sockaddr_in dest;
+  _listener_addr(&dest);
+  int ret = -1;
+  sunk = 0;
+  unsigned int opened = 0;
+  for (; opened < count; opened++) {
+    socks[opened] = _bound_client("127.0.0.1", 0);
+    if (0 > socks[opened]) break;
+    struct sockaddr_in sa;
+    socklen_t len = sizeof(sa);
+    getsockname(socks[opened], (struct sockaddr*) &sa, &len);
+    ports[opened] = ntohs(sa.sin_port);
+    sendto(socks[opened], "hello", 5, 0, (struct sockaddr*) &dest, sizeof(dest));
+  }
+
+  if (opened != count) {
+    log->concatf("Only opened %u of %u counterparties.\n", opened, count);
+  }
+  else if (!_await_sunk(count) || (count != listener.peers())) {
+    log->concatf("Expected %u counterparties. Found %u.\n", count, listener.peers());
+  }
+  else {
+    const uint32_t lo = inet_addr("127.0.0.1");
+    bool ok = true;
+    for (unsigned int i = 0; i < count; i += 2) {
+      delete listener.findPipe(lo, ports[i]);
+    }
+    for (unsigned int i = 0; ok && (i < count); i++) {
+      const bool present = (nullptr != listener.findPipe(lo, ports[i]));
+      if (present != (1 == (i & 1))) {
+        log->concatf("Counterparty %u is %s after removal of its neighbors.\n", i, (present ? "present" : "missing"));
+        ok = false;
+      }
+    }
+    if (ok && ((count / 2) != listener.peers())) {
+      log->concatf("Expected %u counterparties after removal. Found %u.\n", count / 2, listener.peers());
+      ok = false;
+    }
+    if (ok) {
+      log->concatf("\t%u counterparties found, half removed, the rest found again.\n", count);
+      ret = 0;
+    }
+  }
+  for (unsigned int i = 0; i < opened; i++) close(socks[i]);
+  free(ports);
+  free(socks);
+  return ret;
+}
+
+
+/*
+* Throws datagrams at a listener from a handful of counterparties, never more
+*   than a window's worth ahead of what it has taken. Informational, but fails
+*   if the listener stops making progress.
+*/
+int bench_Datagrams(StringBuilder* log, uint8_t batch, uint8_t receivers) {
+  ManuvrUDP* listener = new ManuvrUDP("127.0.0.1", listen_port);
+  listener->setPipeStrategy(sink_strategy);
+  listener->setBatchSize(batch);
+  listener->setReceivers(receivers);
+  if (0 != listener->listen()) {
+    log->concatf("Couldn't listen on port %d.\n", listen_port);
+    delete listener;
+    return -1;
+  }
+  int socks[BENCH_SENDERS];
+  for (unsigned int i = 0; i < BENCH_SENDERS; i++) {
+    socks[i] = _bound_client("127.0.0.1", 0);
+  }
+  struct sockaddr_in dest;
+  _listener_addr(&dest);
+  uint8_t msg[MSG_LEN];
+  memset(msg, 0xA5, sizeof(msg));
+  struct iovec   iov[16];
+  struct mmsghdr out[16];
+  memset(out, 0, sizeof(out));
+  for (unsigned int i = 0; i < 16; i++) {
+    iov[i].iov_base = msg;
+    iov[i].iov_len  = MSG_LEN;
+    out[i].msg_hdr.msg_name    = &dest;
+    out[i].msg_hdr.msg_namelen = sizeof(dest);
+    out[i].msg_hdr.msg_iov     = &iov[i];
+    out[i].msg_hdr.msg_iovlen  = 1;
+  }
+
+  sunk = 0;
+  uint32_t sent = 0;
+  uint32_t seen = 0;
+  unsigned long last_progress = micros();
+  const unsigned long t0 = micros();
+  while (sunk < BENCH_DATAGRAMS) {
+    const uint32_t now_sunk = sunk;
+    if (now_sunk != seen) {
+      seen = now_sunk;
+      last_progress = micros();
+    }
+    else if ((micros() - last_progress) > 1000000) {
+      break;   // Whatever is still outstanding was lost.
+    }
+    if ((sent < BENCH_DATAGRAMS) && ((sent - now_sunk) < BENCH_WINDOW)) {
+      const int n = sendmmsg(socks[(sent / 16) % BENCH_SENDERS], out, 16, 0);
+      if (n > 0) sent += n;
+    }
+  }
+  const unsigned long elapsed = micros() - t0;
+  const uint32_t got = sunk;
+
+  log->concatf("\tbatch %2u  receivers %u:  %8.0f datagrams/s   %5.1f per read   lost %u\n",
+    batch, receivers,
+    (elapsed ? ((double) got * 1000000 / elapsed) : (double) 0),
+    (listener->receiveCalls() ? ((double) listener->datagramsReceived() / listener->receiveCalls()) : (double) 0),
+    sent - got
+  );
+  for (unsigned int i = 0; i < BENCH_SENDERS; i++) close(socks[i]);
+  delete listener;
+  return (got > (BENCH_DATAGRAMS / 2)) ? 0 : -1;
+}
+
+
+/*
+* Bounces datagrams off an echoing listener, to see the replies coalesce.
+*/
+int bench_Echo(StringBuilder* log) {
+  ManuvrUDP listener("127.0.0.1", listen_port);
+  listener.setPipeStrategy(echo_strategy);
+  if (0 != listener.listen()) {
+    log->concatf("Couldn't listen on port %d.\n", listen_port);
+    return -1;
+  }
+  int s = _bound_client("127.0.0.1", 0);
+  struct sockaddr_in dest;
+  _listener_addr(&dest);
+  uint8_t msg[MSG_LEN];
+  memset(msg, 0x5A, sizeof(msg));
+  struct iovec   iov[32];
+  struct mmsghdr out[32];
+  uint8_t        rx[32][MSG_LEN];
+  struct iovec   rx_iov[32];
+  struct mmsghdr in[32];
+  memset(out, 0, sizeof(out));
+  memset(in, 0, sizeof(in));
+  for (unsigned int i = 0; i < 32; i++) {
+    iov[i].iov_base = msg;
+    iov[i].iov_len  = MSG_LEN;
+    out[i].msg_hdr.msg_name    = &dest;
+    out[i].msg_hdr.msg_namelen = sizeof(dest);
+    out[i].msg_hdr.msg_iov     = &iov[i];
+    out[i].msg_hdr.msg_iovlen  = 1;
+    rx_iov[i].iov_base = rx[i];
+    rx_iov[i].iov_len  = MSG_LEN;
+    in[i].msg_hdr.msg_iov      = &rx_iov[i];
+    in[i].msg_hdr.msg_iovlen   = 1;
+  }
+
+  const unsigned int rounds = 2000;
+  unsigned int echoed = 0;
+  bool ok = true;
+  const unsigned long t0 = micros();
+  for (unsigned int r = 0; ok && (r < rounds); r++) {
+    sendmmsg(s, out, 32, 0);
+    unsigned int have = 0;
+    const unsigned long r0 = micros();
+    while (have < 32) {
+      const int n = recvmmsg(s, in, 32 - have, MSG_DONTWAIT, nullptr);
+      if (n > 0) have += n;
+      if ((micros() - r0) > WAIT_LIMIT_US) {
+        ok = false;
+        break;
+      }
+    }
+    echoed += have;
+  }
+  const unsigned long elapsed = micros() - t0;
+  close(s);
+
+  if (!ok) {
+    log->concatf("Echoes went missing after %u of %u.\n", echoed, rounds * 32);
+    return -1;
+  }
+  log->concatf("\techo, 32 at a time:  %8.0f datagrams/s   %5.1f replies per send\n",
+    (elapsed ? ((double) echoed * 1000000 / elapsed) : (double) 0),
+    (listener.sendCalls() ? ((double) listener.datagramsSent() / listener.sendCalls()) : (double) 0)
+  );
+  return 0;
+}
+
+
+/****************************************************************************************************
+* The main function.                                                                                *
+****************************************************************************************************/
+int main(int argc, char *argv[]) {
+  int exit_value = 1;   // Failure is the default result.
+  platform.platformPreInit();
+
+  StringBuilder log("===< ManuvrUDP >========================================\n");
+  BufferPipe::registerPipe(ECHO_PIPE_CODE, _echo_factory);
+  BufferPipe::registerPipe(SINK_PIPE_CODE, _sink_factory);
+  listen_port = 30000 + (getpid() % 10000);
+
+  if ((0 == test_Echo(&log)) && (0 == test_PeerTable(&log))) {
+    const uint8_t batches[]   = { 1, 16, 64 };
+    const uint8_t receivers[] = { 1, 4 };
+    exit_value = 0;
+    for (unsigned int r = 0; r < sizeof(receivers); r++) {
+      for (unsigned int b = 0; b < sizeof(batches); b++) {
+        if (0 != bench_Datagrams(&log, batches[b], receivers[r])) exit_value = 1;
+      }
+    }
+    if (0 != bench_Echo(&log)) exit_value = 1;
+  }
+  printf("%s\n", (const char*) log.string());
+  exit(exit_value);
+}
@@ -0,0 +1,531 @@
+/*
+File:   WorkerPoolTest.cpp
+Author: J. Ian Lindsay
+Date:   2026.10.17
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+This program tests how the Kernel hands events to receivers.
+
+Receivers that declare their interests should only be notified of those
+  codes, and receivers that don't should see everything.
+
+Then the worker pool. A parallel-safe message is
+  raised many times, and fanned out to several parallel-safe receivers that
+  each burn some CPU. We check that every receiver saw every event, in order,
+  and that no event was called back before all of its receivers were done.
+  Parallel-safe and serial events are then interleaved to a single
+  parallel-safe receiver, which must see them in the order they were raised,
+  and never be re-entered.
+  Then we measure how throughput scales with the number of worker threads.
+*/
+
+#include <cstdio>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Platform.h must come first. It decides the threading model that the other
+//   headers depend on.
+#include <Platform/Platform.h>
+#include <EventWorkerPool.h>
+#include <DataStructures/StringBuilder.h>
+
+#define PARALLEL_TEST_MSG_CODE   0x7E00
+#define PARALLEL_TEST_RECEIVERS  6
+#define PARALLEL_TEST_EVENTS     600
+#define PARALLEL_TEST_WORK       20000
+#define INTEREST_TEST_MSG_CODE   0x7E01
+#define INTEREST_TEST_EVENTS     50
+#define ORDER_TEST_MSG_CODE_P    0x7E02
+#define ORDER_TEST_MSG_CODE_S    0x7E03
+#define ORDER_TEST_EVENTS        400
+
+const unsigned char PARALLEL_TEST_FORMS[] = {0};
+
+
+/*
+* A receiver that does some arithmetic for every test event, and keeps track
+*   of the order in which it saw them.
+*/
+class ParallelReceiver : public EventReceiver {
+  public:
+    uint32_t seen     = 0;
+    uint32_t expected = 0;
+    uint32_t disorder = 0;
+    uint32_t junk     = 0;
+
+    ParallelReceiver(bool p_safe) : EventReceiver("ParallelReceiver") {
+      parallelSafe(p_safe);
+    };
+
+    void reset() {
+      seen     = 0;
+      expected = 0;
+      disorder = 0;
+    };
+
+    int8_t notify(ManuvrMsg* active_event) {
+      if (PARALLEL_TEST_MSG_CODE == active_event->eventCode()) {
+        uint32_t seq = 0;
+        active_event->getArgAs(&seq);
+        if (seq != expected) disorder++;
+        expected = seq + 1;
+        uint32_t x = seq + 1;
+        for (int i = 0; i < PARALLEL_TEST_WORK; i++) {
+          x ^= x << 13;
+          x ^= x >> 17;
+          x ^= x << 5;
+        }
+        junk += x;
+        __atomic_add_fetch(&seen, 1, __ATOMIC_RELEASE);
+        return 1;
+      }
+      return EventReceiver::notify(active_event);
+    };
+};
+
+
+/*
+* Originates the test events, and checks each one at call-back time.
+*/
+class ParallelOriginator : public EventReceiver {
+  public:
+    ParallelReceiver** rxs = nullptr;
+    int      rx_count  = 0;
+    uint32_t callbacks = 0;
+    uint32_t early     = 0;
+
+    ParallelOriginator() : EventReceiver("ParallelOriginator") {};
+
+    int8_t callback_proc(ManuvrMsg* event) {
+      if (PARALLEL_TEST_MSG_CODE == event->eventCode()) {
+        uint32_t seq = 0;
+        event->getArgAs(&seq);
+        for (int i = 0; i < rx_count; i++) {
+          if (__atomic_load_n(&rxs[i]->seen, __ATOMIC_ACQUIRE) < (seq + 1)) early++;
+        }
+        callbacks++;
+      }
+      return EVENT_CALLBACK_RETURN_REAP;
+    };
+};
+
+
+/*
+* Counts its notify() calls.
+*/
+class CountingReceiver : public EventReceiver {
+  public:
+    uint32_t calls = 0;
+    uint32_t hits  = 0;
+
+    CountingReceiver() : EventReceiver("CountingReceiver") {};
+
+    int8_t notify(ManuvrMsg* active_event) {
+      calls++;
+      if (INTEREST_TEST_MSG_CODE == active_event->eventCode()) {
+        hits++;
+        return 1;
+      }
+      return EventReceiver::notify(active_event);
+    };
+};
+
+const uint16_t interest_codes[] = {
+  INTEREST_TEST_MSG_CODE,
+  MANUVR_MSG_UNDEFINED
+};
+
+
+/*
+* Parallel-safe, and interested in both the parallel and serial ordering
+*   events. Parallel events are slow, so that serial ones catch up with them.
+*/
+class OrderReceiver : public EventReceiver {
+  public:
+    uint32_t seen      = 0;
+    uint32_t expected  = 0;
+    uint32_t disorder  = 0;
+    uint32_t reentered = 0;
+    uint32_t inside    = 0;
+    uint32_t junk      = 0;
+
+    OrderReceiver() : EventReceiver("OrderReceiver") {
+      parallelSafe(true);
+    };
+
+    int8_t notify(ManuvrMsg* active_event) {
+      switch (active_event->eventCode()) {
+        case ORDER_TEST_MSG_CODE_P:
+        case ORDER_TEST_MSG_CODE_S:
+          break;
+        default:
+          return EventReceiver::notify(active_event);
+      }
+      if (0 != __atomic_fetch_add(&inside, 1, __ATOMIC_ACQ_REL)) reentered++;
+      uint32_t seq = 0;
+      active_event->getArgAs(&seq);
+      if (seq != expected) disorder++;
+      expected = seq + 1;
+      if (ORDER_TEST_MSG_CODE_P == active_event->eventCode()) {
+        uint32_t x = seq + 1;
+        for (int i = 0; i < PARALLEL_TEST_WORK; i++) {
+          x ^= x << 13;
+          x ^= x >> 17;
+          x ^= x << 5;
+        }
+        junk += x;
+      }
+      __atomic_sub_fetch(&inside, 1, __ATOMIC_ACQ_REL);
+      __atomic_add_fetch(&seen, 1, __ATOMIC_RELEASE);
+      return 1;
+    };
+};
+
+const uint16_t order_codes[] = {
+  ORDER_TEST_MSG_CODE_P,
+  ORDER_TEST_MSG_CODE_S,
+  MANUVR_MSG_UNDEFINED
+};
+
+
+ParallelReceiver*  receivers[PARALLEL_TEST_RECEIVERS];
+ParallelReceiver*  serial_rx = nullptr;
+ParallelOriginator originator;
+
+
+/*
+* Raises the test event count times and runs the Kernel until every one of them
+*   has been called back.
+*
+* @return 0 on success.
+*/
+int run_parallel_events(uint8_t threads, int count, StringBuilder* log) {
+  Kernel* kernel = platform.kernel();
+  if (0 != kernel->workerThreads(threads)) {
+    log->concatf("Failed to start %u worker threads.\n", threads);
+    return -1;
+  }
+  if (kernel->workerThreads() != threads) {
+    log->concatf("Asked for %u worker threads, but have %u.\n", threads, kernel->workerThreads());
+    return -1;
+  }
+  for (int i = 0; i < PARALLEL_TEST_RECEIVERS; i++) receivers[i]->reset();
+  serial_rx->reset();
+  originator.callbacks = 0;
+  originator.early     = 0;
+
+  unsigned long t0 = micros();
+  int raised = 0;
+  uint32_t spins = 0;
+  while (originator.callbacks < (uint32_t) count) {
+    // Keep a reasonable number of events pending.
+    while ((raised < count) && (kernel->queueSize() < 32)) {
+      ManuvrMsg* event = Kernel::returnEvent(PARALLEL_TEST_MSG_CODE, &originator);
+      event->addArg((uint32_t) raised++);
+      Kernel::staticRaiseEvent(event);
+    }
+    kernel->procIdleFlags();
+    if (++spins > 50000000) {
+      log->concatf("Gave up after %u callbacks.\n", originator.callbacks);
+      return -1;
+    }
+  }
+  unsigned long t1 = micros();
+
+  int return_value = 0;
+  for (int i = 0; i < PARALLEL_TEST_RECEIVERS; i++) {
+    if (receivers[i]->seen != (uint32_t) count) {
+      log->concatf("Receiver %d saw %u of %d events.\n", i, receivers[i]->seen, count);
+      return_value = -1;
+    }
+    if (receivers[i]->disorder) {
+      log->concatf("Receiver %d saw %u events out of order.\n", i, receivers[i]->disorder);
+      return_value = -1;
+    }
+  }
+  if (serial_rx->seen != (uint32_t) count) {
+    log->concatf("Serial receiver saw %u of %d events.\n", serial_rx->seen, count);
+    return_value = -1;
+  }
+  if (originator.early) {
+    log->concatf("%u callbacks came before delivery was complete.\n", originator.early);
+    return_value = -1;
+  }
+
+  unsigned long elapsed = (t1 > t0) ? (t1 - t0) : 1;
+  printf("\t %u worker threads: %d events in %lu us (%.2f Msg/sec).\n",
+    threads, count, elapsed, (((double) count * 1000000) / (double) elapsed)
+  );
+  return return_value;
+}
+
+
+/*
+* Setup.
+*/
+int WORKER_POOL_SETUP(StringBuilder* log) {
+  printf("===< WORKER_POOL_SETUP >=========================================\n");
+  if (0 != ManuvrMsg::registerMessage(PARALLEL_TEST_MSG_CODE, MSG_FLAG_PARALLEL_SAFE, "PARALLEL_TEST", PARALLEL_TEST_FORMS, nullptr)) {
+    log->concat("Failed to register the test message.\n");
+    return -1;
+  }
+  ManuvrMsg probe(PARALLEL_TEST_MSG_CODE, nullptr);
+  if (!probe.isParallelSafe()) {
+    log->concat("Test message isn't parallel-safe.\n");
+    return -1;
+  }
+  for (int i = 0; i < PARALLEL_TEST_RECEIVERS; i++) {
+    receivers[i] = new ParallelReceiver(true);
+    platform.kernel()->subscribe(receivers[i]);
+  }
+  serial_rx = new ParallelReceiver(false);
+  platform.kernel()->subscribe(serial_rx);
+  originator.rxs      = receivers;
+  originator.rx_count = PARALLEL_TEST_RECEIVERS;
+  return 0;
+}
+
+
+/*
+* Correctness, first inline, then with a pool much smaller than the receivers.
+*/
+int WORKER_POOL_DELIVERY(StringBuilder* log) {
+  printf("===< WORKER_POOL_DELIVERY >======================================\n");
+  if (0 == run_parallel_events(0, PARALLEL_TEST_EVENTS, log)) {
+    if (0 == run_parallel_events(2, PARALLEL_TEST_EVENTS, log)) {
+      if (0 == platform.kernel()->workerThreads(0)) {
+        if (0 == platform.kernel()->workerThreads()) {
+          return 0;
+        }
+        else log->concat("Pool should be stopped.\n");
+      }
+      else log->concat("Failed to stop the pool.\n");
+    }
+    else log->concat("Delivery failed with 2 workers.\n");
+  }
+  else log->concat("Delivery failed without workers.\n");
+  return -1;
+}
+
+
+/*
+* A raised event that is still in flight must be refused.
+*/
+int WORKER_POOL_IDEMPOTENCY(StringBuilder* log) {
+  printf("===< WORKER_POOL_IDEMPOTENCY >===================================\n");
+  Kernel* kernel = platform.kernel();
+  int return_value = -1;
+  if (0 == kernel->workerThreads(1)) {
+    for (int i = 0; i < PARALLEL_TEST_RECEIVERS; i++) receivers[i]->reset();
+    serial_rx->reset();
+    originator.callbacks = 0;
+    ManuvrMsg* event = Kernel::returnEvent(PARALLEL_TEST_MSG_CODE, &originator);
+    event->addArg((uint32_t) 0);
+    event->incRefs();   // Keep the event around to try to raise again.
+    if (0 == Kernel::staticRaiseEvent(event)) {
+      // Retirement happens on a later call than dispatch, so we can't miss it.
+      while (!event->isDispatched() && (0 == originator.callbacks)) {
+        kernel->procIdleFlags();
+      }
+      if (event->isDispatched()) {
+        if (0 != Kernel::staticRaiseEvent(event)) {
+          while (0 == originator.callbacks) {
+            kernel->procIdleFlags();
+          }
+          if (!event->isDispatched()) {
+            return_value = 0;
+          }
+          else log->concat("Event is still marked as dispatched after retirement.\n");
+        }
+        else log->concat("Kernel accepted an event that was in flight.\n");
+      }
+      else log->concat("Event was never dispatched.\n");
+    }
+    else log->concat("Failed to raise the event.\n");
+    event->decRefs();
+    kernel->workerThreads(0);
+  }
+  else log->concat("Failed to start the pool.\n");
+  return return_value;
+}
+
+
+/*
+* Receivers that declare their interests only hear about those codes.
+*/
+int DISPATCH_INTEREST(StringBuilder* log) {
+  printf("===< DISPATCH_INTEREST >=========================================\n");
+  Kernel* kernel = platform.kernel();
+  if (0 != ManuvrMsg::registerMessage(INTEREST_TEST_MSG_CODE, 0, "INTEREST_TEST", PARALLEL_TEST_FORMS, nullptr)) {
+    log->concat("Failed to register the test message.\n");
+    return -1;
+  }
+  CountingReceiver filtered;
+  CountingReceiver unfiltered;
+  kernel->subscribe(&filtered, 10, interest_codes);
+  kernel->subscribe(&unfiltered);
+  originator.callbacks = 0;
+  for (int i = 0; i < PARALLEL_TEST_RECEIVERS; i++) receivers[i]->reset();
+  serial_rx->reset();
+
+  for (int i = 0; i < INTEREST_TEST_EVENTS; i++) {
+    ManuvrMsg* event = Kernel::returnEvent(PARALLEL_TEST_MSG_CODE, &originator);
+    event->addArg((uint32_t) i);
+    Kernel::staticRaiseEvent(event);
+    Kernel::raiseEvent(INTEREST_TEST_MSG_CODE, nullptr);
+  }
+  while ((0 < kernel->queueSize()) || (originator.callbacks < INTEREST_TEST_EVENTS)) {
+    kernel->procIdleFlags();
+  }
+  kernel->unsubscribe(&filtered);
+  kernel->unsubscribe(&unfiltered);
+
+  if (filtered.msgInterest() == interest_codes) {
+    if ((INTEREST_TEST_EVENTS == filtered.hits) && (INTEREST_TEST_EVENTS == filtered.calls)) {
+      if ((INTEREST_TEST_EVENTS == unfiltered.hits) && ((2 * INTEREST_TEST_EVENTS) <= unfiltered.calls)) {
+        printf("\t Filtered receiver: %u calls. Unfiltered receiver: %u calls.\n", filtered.calls, unfiltered.calls);
+        return 0;
+      }
+      else log->concatf("Unfiltered receiver: %u hits in %u calls.\n", unfiltered.hits, unfiltered.calls);
+    }
+    else log->concatf("Filtered receiver: %u hits in %u calls.\n", filtered.hits, filtered.calls);
+  }
+  else log->concat("subscribe() didn't record the receiver's interests.\n");
+  return -1;
+}
+
+
+/*
+* Parallel-safe and serial events, alternating, to one parallel-safe receiver.
+*   The serial ones are notified on the Kernel's thread, and must wait for the
+*   receiver's strand to drain.
+*/
+int WORKER_POOL_ORDERING(StringBuilder* log) {
+  printf("===< WORKER_POOL_ORDERING >======================================\n");
+  Kernel* kernel = platform.kernel();
+  if ((0 != ManuvrMsg::registerMessage(ORDER_TEST_MSG_CODE_P, MSG_FLAG_PARALLEL_SAFE, "ORDER_TEST_P", PARALLEL_TEST_FORMS, nullptr)) ||
+      (0 != ManuvrMsg::registerMessage(ORDER_TEST_MSG_CODE_S, 0, "ORDER_TEST_S", PARALLEL_TEST_FORMS, nullptr))) {
+    log->concat("Failed to register the test messages.\n");
+    return -1;
+  }
+  if (0 != kernel->workerThreads(2)) {
+    log->concat("Failed to start the pool.\n");
+    return -1;
+  }
+  OrderReceiver rx;
+  kernel->subscribe(&rx, 10, order_codes);
+
+  int raised = 0;
+  uint32_t spins = 0;
+  while ((rx.seen < ORDER_TEST_EVENTS) && (++spins < 50000000)) {
+    // Two or three at a time, so that each loop mixes the kinds.
+    while ((raised < ORDER_TEST_EVENTS) && (kernel->queueSize() < 3)) {
+      ManuvrMsg* event = Kernel::returnEvent((raised & 1) ? ORDER_TEST_MSG_CODE_S : ORDER_TEST_MSG_CODE_P);
+      event->addArg((uint32_t) raised++);
+      Kernel::staticRaiseEvent(event);
+    }
+    if (0 == kernel->procIdleFlags()) yieldThread();
+  }
+  // Let the pool retire what it delivered.
+  while (0 < kernel->procIdleFlags()) {}
+  kernel->unsubscribe(&rx);
+  kernel->workerThreads(0);
+
+  if (ORDER_TEST_EVENTS != rx.seen) {
+    log->concatf("Receiver saw %u of %d events.\n", rx.seen, ORDER_TEST_EVENTS);
+  }
+  else if (0 != rx.disorder) {
+    log->concatf("Receiver saw %u events out of order.\n", rx.disorder);
+  }
+  else if (0 != rx.reentered) {
+    log->concatf("Receiver was re-entered %u times.\n", rx.reentered);
+  }
+  else {
+    printf("\t %d events, alternating, in order.\n", ORDER_TEST_EVENTS);
+    return 0;
+  }
+  return -1;
+}
+
+
+/*
+* Throughput as a function of thread count.
+*/
+int WORKER_POOL_SCALING(StringBuilder* log) {
+  printf("===< WORKER_POOL_SCALING >=======================================\n");
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  int max_threads = (cpus > 1) ? ((cpus < EVENT_WORKERS_MAX) ? cpus : EVENT_WORKERS_MAX) : 2;
+  printf("\t %ld CPUs online.\n", cpus);
+  for (int t = 0; t <= max_threads; t = ((0 == t) ? 1 : (t << 1))) {
+    if (0 != run_parallel_events((uint8_t) t, PARALLEL_TEST_EVENTS, log)) {
+      return -1;
+    }
+  }
+  StringBuilder output;
+  platform.kernel()->workerThreads(1);
+  platform.kernel()->printProfiler(&output);
+  platform.kernel()->workerThreads(0);
+  printf("%s\n", (char*) output.string());
+  return 0;
+}
+
+
+void printTestFailure(const char* test) {
+  printf("\n");
+  printf("*********************************************\n");
+  printf("* %s FAILED tests.\n", test);
+  printf("*********************************************\n");
+}
+
+
+/****************************************************************************************************
+* The main function.                                                                                *
+****************************************************************************************************/
+int main(int argc, char *argv[]) {
+  int exit_value = 1;   // Failure is the default result.
+  StringBuilder log;
+
+  platform.platformPreInit();
+  platform.bootstrap();
+
+  if (0 == WORKER_POOL_SETUP(&log)) {
+    if (0 == WORKER_POOL_DELIVERY(&log)) {
+      if (0 == WORKER_POOL_IDEMPOTENCY(&log)) {
+        if (0 == DISPATCH_INTEREST(&log)) {
+          if (0 == WORKER_POOL_ORDERING(&log)) {
+            if (0 == WORKER_POOL_SCALING(&log)) {
+              printf("**********************************\n");
+              printf("*  Worker pool tests all pass    *\n");
+              printf("**********************************\n");
+              exit_value = 0;
+            }
+            else printTestFailure("WORKER_POOL_SCALING");
+          }
+          else printTestFailure("WORKER_POOL_ORDERING");
+        }
+        else printTestFailure("DISPATCH_INTEREST");
+      }
+      else printTestFailure("WORKER_POOL_IDEMPOTENCY");
+    }
+    else printTestFailure("WORKER_POOL_DELIVERY");
+  }
+  else printTestFailure("WORKER_POOL_SETUP");
+
+  if (log.length() > 0) printf("%s\n", (char*) log.string());
+  exit(exit_value);
+}
@@ -0,0 +1,397 @@
+/*
+File:   XportQueueTest.cpp
+Author: J. Ian Lindsay
+Date:   2026.10.18
+
+Copyright 2026 Manuvr, Inc
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Tests for ManuvrXport's outbound queue. A fake transport takes a limited number
+  of bytes per write, so we can watch the queue coalesce, recover from partial
+  writes, and push back.
+
+After the tests, small messages are written over loopback TCP, both through
+  ManuvrTCP and with a plain write() apiece, for comparison.
+*/
+
+#include <cstdio>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include <Platform/Platform.h>
+#include <Transports/ManuvrSocket/ManuvrTCP.h>
+
+#define BENCH_MESSAGES   200000
+#define BENCH_MSG_LEN    32
+#define WAIT_LIMIT_US    10000000
+
+
+/*
+* A transport that writes into a StringBuilder, but only so much per call.
+*/
+class FakeXport : public ManuvrXport {
+  public:
+    StringBuilder wire;
+    int  room     = -1;      // Bytes taken per write. -1 is unlimited.
+    bool notifies = true;    // Pretend we will be told when writable.
+
+    FakeXport() : ManuvrXport("FakeXport") {
+      set_xport_state(MANUVR_XPORT_FLAG_CONNECTED);
+    };
+
+    int8_t send(const char* str) {   return _out_queue((uint8_t*) str, strlen(str));  };
+    int8_t send(uint8_t* buf, unsigned int len) {   return _out_queue(buf, len);     };
+    int8_t send(BufferSlice* slice) {               return _out_queue(slice);        };
+    int    drain() {                                return _out_flush();             };
+
+    int8_t read_port() {   return 0;   };
+    int8_t connect() {     return 0;   };
+    int8_t listen() {      return 0;   };
+    int8_t reset() {       return 0;   };
+
+
+  protected:
+    int8_t attached() {    return 0;   };
+
+    int _out_write(XportIOV* iov, int count) {
+      int total = 0;
+      for (int i = 0; i < count; i++) {
+        int n = (int) iov[i].iov_len;
+        if ((0 <= room) && (n > (room - total))) n = room - total;
+        wire.concat((uint8_t*) iov[i].iov_base, n);
+        total += n;
+        if (n < (int) iov[i].iov_len) break;
+      }
+      return total;
+    };
+    bool _out_wanted() {   return notifies;   };
+};
+
+
+/*
+* Counts the congestion signals it is sent.
+*/
+class SignalCatcher : public BufferPipe {
+  public:
+    int congested = 0;
+    int drained   = 0;
+
+    SignalCatcher(BufferPipe* n) : BufferPipe() {   setNear(n);   };
+    const char* pipeName() {   return "SignalCatcher";   };
+
+    int8_t fromCounterparty(StringBuilder* buf, int8_t mm) {   return MEM_MGMT_RESPONSIBLE_BEARER;   };
+    int8_t fromCounterparty(ManuvrPipeSignal sig, void* arg) {
+      if (ManuvrPipeSignal::XPORT_CONGESTED == sig) congested++;
+      if (ManuvrPipeSignal::XPORT_DRAINED == sig)   drained++;
+      return 0;
+    };
+};
+
+
+/*
+* Small writes must be held until the flush, and then go out together.
+*/
+int test_Coalesce(StringBuilder* log) {
+  FakeXport x;
+  StringBuilder expected;
+  char msg[16];
+  for (int i = 0; i < 1000; i++) {
+    snprintf(msg, sizeof(msg), "msg%04d\n", i);
+    expected.concat(msg);
+    if (0 != x.send(msg)) {
+      log->concat("A small write was refused.\n");
+      return -1;
+    }
+  }
+  if ((0 != x.outboundWrites()) || (8000 != x.outboundBytes())) {
+    log->concatf("Small writes weren't held (%u writes, %u bytes queued).\n", x.outboundWrites(), x.outboundBytes());
+    return -1;
+  }
+  const unsigned int depth = x.outboundDepth();
+  if (0 != x.drain()) {
+    log->concat("The flush left something behind.\n");
+    return -1;
+  }
+  if ((x.wire.length() != expected.length()) || (0 != memcmp(x.wire.string(), expected.string(), expected.length()))) {
+    log->concat("The coalesced stream is wrong.\n");
+    return -1;
+  }
+  log->concatf("\t1000 writes held in %u segments, and written in %u calls.\n", depth, x.outboundWrites());
+  return 0;
+}
+
+
+/*
+* A driver that takes a few bytes at a time mustn't reorder or lose anything,
+*   whether it was copied or written straight through.
+*/
+int test_PartialWrites(StringBuilder* log) {
+  FakeXport x;
+  x.room     = 7;
+  x.notifies = false;
+  StringBuilder expected;
+  uint8_t big[3000];
+  for (unsigned int i = 0; i < sizeof(big); i++) big[i] = (uint8_t) (i * 7);
+  for (int i = 0; i < 20; i++) {
+    char msg[16];
+    snprintf(msg, sizeof(msg), "<%d>", i);
+    expected.concat(msg);
+    expected.concat(big, (i * 150) + 1);
+    if ((0 != x.send(msg)) || (0 != x.send(big, (i * 150) + 1))) {
+      log->concat("A write was refused.\n");
+      return -1;
+    }
+  }
+  int guard = 100000;
+  while ((0 < x.outboundBytes()) && (0 < guard--)) x.drain();
+  if ((x.wire.length() != expected.length()) || (0 != memcmp(x.wire.string(), expected.string(), expected.length()))) {
+    log->concatf("The stream is wrong after partial writes (%d of %d bytes).\n", x.wire.length(), expected.length());
+    return -1;
+  }
+  log->concatf("\t%d bytes survived %u partial writes.\n", expected.length(), x.outboundStalls());
+  return 0;
+}
+
+
+/*
+* A full queue must say so to the far side, refuse writes past the hard limit,
+*   and say so again once it has drained.
+*/
+int test_Backpressure(StringBuilder* log) {
+  FakeXport x;
+  SignalCatcher catcher(&x);
+  x.room = 0;   // The driver takes nothing.
+  x.outboundLimit(1000);
+  uint8_t chunk[100];
+  memset(chunk, 0x55, sizeof(chunk));
+  int accepted = 0;
+  while ((0 == x.send(chunk, sizeof(chunk))) && (accepted < 1000)) accepted++;
+
+  if (40 != accepted) {
+    log->concatf("Expected the 41st write to be refused. It was write %d.\n", accepted + 1);
+    return -1;
+  }
+  if (!x.congested() || (1 != catcher.congested) || (0 != catcher.drained)) {
+    log->concatf("Congestion went unsignalled (%d, %d).\n", catcher.congested, catcher.drained);
+    return -1;
+  }
+  x.room = 2500;   // Not quite enough to drain below half the limit...
+  x.drain();
+  if (!x.congested() || (0 != catcher.drained)) {
+    log->concat("Drained too early.\n");
+    return -1;
+  }
+  x.room = 1100;   // ...but now it is.
+  x.drain();
+  if (x.congested() || (1 != catcher.drained)) {
+    log->concatf("Draining went unsignalled (%u bytes left).\n", x.outboundBytes());
+    return -1;
+  }
+  x.room = -1;
+  x.drain();
+  if ((0 != x.outboundBytes()) || (4000 != x.wire.length())) {
+    log->concat("Lost bytes while congested.\n");
+    return -1;
+  }
+  log->concat("\tCongestion signalled, excess refused, and drainage signalled.\n");
+  return 0;
+}
+
+
+/*
+* Large segments of a slice should be queued by reference, and let go once
+*   they are written.
+*/
+int test_Slices(StringBuilder* log) {
+  FakeXport x;
+  x.room = 0;
+  SharedBuffer* backing = SharedBuffer::alloc(4096);
+  memset(backing->buffer(), 0xA5, 4096);
+  BufferSlice slice;
+  slice.append(backing, 0, 4096);
+  slice.wrap((uint8_t*) "tail", 4, false);
+  backing->release();   // The slice holds it now.
+
+  int ret = -1;
+  if (0 != x.send(&slice)) {
+    log->concat("The slice was refused.\n");
+  }
+  else if (2 != backing->refs()) {
+    log->concatf("The large segment wasn't held by reference (refs: %d).\n", backing->refs());
+  }
+  else {
+    x.room = -1;
+    x.drain();
+    if (1 != backing->refs()) {
+      log->concat("The queue didn't let go of the segment.\n");
+    }
+    else if ((4100 != x.wire.length()) || (0 != memcmp(x.wire.string() + 4096, "tail", 4))) {
+      log->concat("The slice came out wrong.\n");
+    }
+    else {
+      log->concat("\tLarge slice segments queued without a copy.\n");
+      ret = 0;
+    }
+  }
+  return ret;
+}
+
+
+/*******************************************************************************
+* Loopback benchmark                                                           *
+*******************************************************************************/
+
+typedef struct {
+  int           sock;
+  unsigned long expected;
+  unsigned long got;
+} SinkArgs;
+
+static void* _sink_thread(void* arg) {
+  SinkArgs* s = (SinkArgs*) arg;
+  uint8_t buf[65536];
+  while (s->got < s->expected) {
+    ssize_t n = read(s->sock, buf, sizeof(buf));
+    if (n <= 0) break;
+    s->got += n;
+  }
+  return nullptr;
+}
+
+
+static int _listen_loopback(int* port) {
+  int l = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sin_family      = AF_INET;
+  sa.sin_addr.s_addr = inet_addr("127.0.0.1");
+  sa.sin_port        = 0;
+  socklen_t len = sizeof(sa);
+  if ((0 != bind(l, (struct sockaddr*) &sa, sizeof(sa))) || (0 != ::listen(l, 4))) {
+    close(l);
+    return -1;
+  }
+  getsockname(l, (struct sockaddr*) &sa, &len);
+  *port = ntohs(sa.sin_port);
+  return l;
+}
+
+
+/*
+* Writes the messages one way or the other, and returns the rate.
+*/
+static double _bench(bool queued, uint32_t* writes, uint32_t* stalls) {
+  int port = 0;
+  int l = _listen_loopback(&port);
+  if (0 > l) return 0;
+
+  ManuvrTCP* xport = nullptr;
+  int raw = -1;
+  if (queued) {
+    xport = new ManuvrTCP("127.0.0.1", port);
+    if (0 != xport->connect()) {
+      delete xport;
+      close(l);
+      return 0;
+    }
+  }
+  else {
+    raw = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family      = AF_INET;
+    sa.sin_addr.s_addr = inet_addr("127.0.0.1");
+    sa.sin_port        = htons(port);
+    if (0 != ::connect(raw, (struct sockaddr*) &sa, sizeof(sa))) {
+      close(raw);
+      close(l);
+      return 0;
+    }
+  }
+  SinkArgs sink;
+  sink.sock     = accept(l, nullptr, nullptr);
+  sink.expected = (unsigned long) BENCH_MESSAGES * BENCH_MSG_LEN;
+  sink.got      = 0;
+  pthread_t sink_thread;
+  pthread_create(&sink_thread, nullptr, _sink_thread, &sink);
+
+  uint8_t msg[BENCH_MSG_LEN];
+  memset(msg, 'm', sizeof(msg));
+  msg[BENCH_MSG_LEN - 1] = '\n';
+  const unsigned long t0 = micros();
+  for (unsigned int i = 0; i < BENCH_MESSAGES; i++) {
+    if (queued) {
+      while (xport->congested()) sched_yield();   // Backpressure.
+      while (!xport->write_port(msg, BENCH_MSG_LEN)) sched_yield();
+    }
+    else {
+      if (BENCH_MSG_LEN != write(raw, msg, BENCH_MSG_LEN)) break;
+    }
+  }
+  while ((sink.got < sink.expected) && ((micros() - t0) < WAIT_LIMIT_US)) sleep_millis(1);
+  const unsigned long elapsed = micros() - t0;
+  const bool complete = (sink.got == sink.expected);
+
+  if (queued) {
+    *writes = xport->outboundWrites();
+    *stalls = xport->outboundStalls();
+    delete xport;
+  }
+  else {
+    close(raw);
+  }
+  pthread_join(sink_thread, nullptr);
+  close(sink.sock);
+  close(l);
+  return (complete && elapsed) ? ((double) BENCH_MESSAGES * 1000000 / elapsed) : (double) 0;
+}
+
+
+int bench_SmallMessages(StringBuilder* log) {
+  uint32_t writes = 0;
+  uint32_t stalls = 0;
+  const double direct = _bench(false, &writes, &stalls);
+  const double queued = _bench(true, &writes, &stalls);
+  if ((0 == direct) || (0 == queued)) {
+    log->concat("Messages went missing.\n");
+    return -1;
+  }
+  log->concatf("\t%d %d-byte messages over loopback TCP:\n", BENCH_MESSAGES, BENCH_MSG_LEN);
+  log->concatf("\t  write() apiece:    %9.0f msgs/s   %d writes\n", direct, BENCH_MESSAGES);
+  log->concatf("\t  ManuvrTCP queue:   %9.0f msgs/s   %u writes (%.1f msgs each), %u stalls\n",
+    queued, writes, (writes ? ((double) BENCH_MESSAGES / writes) : (double) 0), stalls);
+  return 0;
+}
+
+
+/****************************************************************************************************
+* The main function.                                                                                *
+****************************************************************************************************/
+int main(int argc, char *argv[]) {
+  int exit_value = 1;   // Failure is the default result.
+  platform.platformPreInit();
+
+  StringBuilder log("===< ManuvrXport outbound queue >=======================\n");
+  if ((0 == test_Coalesce(&log)) && (0 == test_PartialWrites(&log)) &&
+      (0 == test_Backpressure(&log)) && (0 == test_Slices(&log))) {
+    if (0 == bench_SmallMessages(&log)) {
+      exit_value = 0;
+    }
+  }
+  printf("%s\n", (const char*) log.string());
+  exit(exit_value);
+}
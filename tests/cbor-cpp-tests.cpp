@@ -14,31 +14,554 @@
 	   limitations under the License.
 */
 
-#include <stdio.h>
-
-#include "cbor.h"
-
-int main() {
-    cbor::output_dynamic output;
-
-    { //encoding
-        cbor::encoder encoder(output);
-        encoder.write_array(5);
-        {
-            encoder.write_int(123);
-            encoder.write_string("bar");
-            encoder.write_int(321);
-            encoder.write_int(321);
-            encoder.write_string("foo");
+/*
+Tests for the CBOR encoder, reader, and the Argument codec built on them.
+*/
+
+#include <cstdio>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <Platform/Platform.h>
+#include <DataStructures/Argument.h>
+#include <Types/TypeTranscriber.h>
+#include <Types/cbor-cpp/cbor.h>
+
+
+/*
+* Heap accounting for the benchmarks. The test build links with --wrap for
+*   these, so every call from the library lands here first.
+*/
+static unsigned long heap_allocs = 0;
+
+extern "C" {
+  void* __real_malloc(size_t);
+  void* __real_realloc(void*, size_t);
+
+  void* __wrap_malloc(size_t size) {
+    heap_allocs++;
+    return __real_malloc(size);
+  }
+
+  void* __wrap_realloc(void* ptr, size_t size) {
+    heap_allocs++;
+    return __real_realloc(ptr, size);
+  }
+}
+
+
+/*******************************************************************************
+* cbor::reader against cbor::encoder
+*******************************************************************************/
+
+/*
+* Encodes one of everything the encoder knows how to write, and checks that the
+*   reader sees the same thing come back.
+*/
+int test_CBOR_Reader(StringBuilder* log) {
+  const uint8_t blob[5] = { 0x00, 0xFF, 0x55, 0xAA, 0x01 };
+  cbor::output_dynamic output;
+  cbor::encoder encoder(output);
+  encoder.write_array(12);
+  encoder.write_int(23);
+  encoder.write_int(200);
+  encoder.write_int((unsigned long long) 40000);
+  encoder.write_int(100000);
+  encoder.write_int(-1);
+  encoder.write_int(-500);
+  encoder.write_int(-100000);
+  encoder.write_string("bar");
+  encoder.write_bytes((uint8_t*) blob, sizeof(blob));
+  encoder.write_float(3.5f);
+  encoder.write_double(-0.125);
+  encoder.write_map(1);
+  encoder.write_tag(0x1234);
+  encoder.write_special(20);
+
+  const struct {
+    uint8_t  major;
+    uint8_t  width;
+    uint64_t value;
+  } expect[] = {
+    { cbor::CBOR_ARRAY,   0, 12 },
+    { cbor::CBOR_UINT,    0, 23 },
+    { cbor::CBOR_UINT,    1, 200 },
+    { cbor::CBOR_UINT,    2, 40000 },
+    { cbor::CBOR_UINT,    4, 100000 },
+    { cbor::CBOR_NINT,    0, 0 },
+    { cbor::CBOR_NINT,    2, 499 },
+    { cbor::CBOR_NINT,    4, 99999 },
+    { cbor::CBOR_STRING,  0, 3 },
+    { cbor::CBOR_BYTES,   0, 5 },
+    { cbor::CBOR_SPECIAL, 4, 0 },   // Values checked separately.
+    { cbor::CBOR_SPECIAL, 8, 0 },
+    { cbor::CBOR_MAP,     0, 1 },
+    { cbor::CBOR_TAG,     2, 0x1234 },
+    { cbor::CBOR_SPECIAL, 0, 20 }
+  };
+  const unsigned int EXPECTED = sizeof(expect) / sizeof(expect[0]);
+
+  cbor::reader reader(output.data(), output.size());
+  cbor::item it;
+  unsigned int i = 0;
+  while (reader.next(&it)) {
+    if (i >= EXPECTED) {
+      log->concat("Reader returned more items than were written.\n");
+      return -1;
+    }
+    bool ok = (it.major == expect[i].major) && (it.width == expect[i].width);
+    switch (it.major) {
+      case cbor::CBOR_SPECIAL:
+        if (4 == it.width)      ok &= (3.5f == cbor::reader::asFloat(&it));
+        else if (8 == it.width) ok &= (((double) -0.125) == cbor::reader::asDouble(&it));
+        else                    ok &= (it.value == expect[i].value);
+        break;
+      case cbor::CBOR_STRING:
+        ok &= (it.value == expect[i].value) && (0 == memcmp(it.data, "bar", 3));
+        break;
+      case cbor::CBOR_BYTES:
+        ok &= (it.value == expect[i].value) && (0 == memcmp(it.data, blob, sizeof(blob)));
+        break;
+      default:
+        ok &= (it.value == expect[i].value);
+        break;
+    }
+    if (!ok) {
+      log->concatf("Item %u mismatch: major %u, width %u, value %llu\n", i, it.major, it.width, (unsigned long long) it.value);
+      return -1;
+    }
+    i++;
+  }
+  if (reader.failed() || (i != EXPECTED) || (reader.consumed() != output.size())) {
+    log->concatf("Reader stopped at item %u (offset %u of %u). failed: %c\n", i, reader.consumed(), output.size(), reader.failed() ? 'y' : 'n');
+    return -1;
+  }
+
+  // Items cut short must fail, and not run off the end.
+  const uint8_t truncated[][4] = {
+    { 0x63, 'b', 'a', 0x00 },    // A 3-byte string with 2 bytes.
+    { 0x1A, 0x00, 0x01, 0x00 },  // A 4-byte integer with 2 bytes.
+    { 0xFB, 0x3F, 0xF0, 0x00 }   // A double with 2 bytes.
+  };
+  for (unsigned int t = 0; t < (sizeof(truncated) / sizeof(truncated[0])); t++) {
+    cbor::reader short_reader(truncated[t], 3);
+    if (short_reader.next(&it) || !short_reader.failed()) {
+      log->concatf("Reader didn't notice truncated item %u.\n", t);
+      return -1;
+    }
+  }
+
+  // Indefinite-length items are refused.
+  const uint8_t indefinite[] = { 0x9F, 0x01, 0xFF };
+  cbor::reader indef_reader(indefinite, sizeof(indefinite));
+  if (indef_reader.next(&it) || !indef_reader.failed()) {
+    log->concat("Reader accepted an indefinite-length array.\n");
+    return -1;
+  }
+  log->concatf("cbor::reader agrees with cbor::encoder on %u items.\n", EXPECTED);
+  return 0;
+}
+
+
+/*
+* The fixed buffer must never write past its end, and must report the size it
+*   would have needed.
+*/
+int test_CBOR_OutputBuffer(StringBuilder* log) {
+  uint8_t buf[32];
+  memset(buf, 0xEE, sizeof(buf));
+  cbor::output_buffer output(buf, 8);
+  cbor::encoder encoder(output);
+  encoder.write_string("This is longer than eight bytes.");
+  if (!output.overflowed() || (34 != output.size())) {
+    log->concatf("output_buffer should have overflowed and wanted 34 bytes. Wanted %u.\n", output.size());
+    return -1;
+  }
+  for (unsigned int i = 8; i < sizeof(buf); i++) {
+    if (0xEE != buf[i]) {
+      log->concatf("output_buffer wrote past its end at offset %u.\n", i);
+      return -1;
+    }
+  }
+
+  // A sizing pass, with no buffer at all.
+  output.reset(nullptr, 0);
+  encoder.write_int(1000);
+  if (3 != output.size()) {
+    log->concatf("Sizing pass gave %u bytes. Expected 3.\n", output.size());
+    return -1;
+  }
+
+  // And the snprintf()-style Argument overload.
+  Argument a((uint32_t) 70000);
+  a.append("Some string");
+  int needed = Argument::encodeToCBOR(&a, buf, 4);
+  if ((needed <= 4) || (needed > (int) sizeof(buf))) {
+    log->concatf("Argument::encodeToCBOR() reported %d bytes needed.\n", needed);
+    return -1;
+  }
+  if (needed != Argument::encodeToCBOR(&a, buf, sizeof(buf))) {
+    log->concat("Argument::encodeToCBOR() changed its mind about length.\n");
+    return -1;
+  }
+  log->concat("cbor::output_buffer respects its bounds.\n");
+  return 0;
+}
+
+
+/*******************************************************************************
+* Argument round-trips
+*******************************************************************************/
+
+int test_CBOR_Arguments(StringBuilder* log) {
+  int return_value = -1;
+  const uint8_t  blob[24] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24 };
+  const uint8_t  small[3] = { 0xDE, 0xAD, 0x00 };
+  const double   big      = ldexp(1.0, 200);   // Too big for a float.
+  StringBuilder shuttle;
+
+  Argument a((int8_t) -100);
+  a.setKey("i8");
+  a.append((int16_t) -30000)->setKey("i16");
+  a.append((int32_t) -2000000)->setKey("i32");
+  a.append((uint32_t) 4000000000)->setKey("u32");
+  a.append(2.25f)->setKey("f");
+  a.append(big)->setKey("d");
+  a.append("A string value")->setKey("str");
+  a.append((void*) blob, sizeof(blob))->setKey("blob");
+  a.append((void*) small, sizeof(small));      // No key.
+  a.append(Vector3f(1.0f, -2.0f, 0.5f))->setKey("v3f");
+
+  int enc_len = Argument::encodeToCBOR(&a, &shuttle);
+  if ((0 >= enc_len) || (enc_len != shuttle.length())) {
+    log->concatf("Encoding returned %d, but the buffer holds %d.\n", enc_len, shuttle.length());
+    return -1;
+  }
+
+  // Appending to a non-empty buffer must not disturb what was there.
+  StringBuilder prefixed("PREFIX");
+  Argument::encodeToCBOR(&a, &prefixed);
+  if ((prefixed.length() != (6 + enc_len)) || (0 != memcmp(prefixed.string() + 6, shuttle.string(), enc_len))) {
+    log->concat("Encoding onto a non-empty StringBuilder gave different bytes.\n");
+    return -1;
+  }
+
+  Argument* r = Argument::decodeFromCBOR(&shuttle);
+  if (nullptr == r) {
+    log->concat("Failed to decode.\n");
+    return -1;
+  }
+  shuttle.clear();   // Nothing decoded may still point at the source.
+  r->printDebug(log);
+
+  int8_t   ri8  = 0;
+  int16_t  ri16 = 0;
+  int32_t  ri32 = 0;
+  uint32_t ru32 = 0;
+  float    rf   = 0.0f;
+  double   rd   = 0.0;
+  char*    rstr = nullptr;
+  Vector3f rv3f(0.0f, 0.0f, 0.0f);
+  Argument* rblob  = r->retrieveArgByKey("blob");
+  Argument* rsmall = r->retrieveArgByIdx(8);
+  Argument* rvec   = r->retrieveArgByKey("v3f");
+
+  if (r->argCount() != a.argCount()) {
+    log->concatf("Arg counts don't match: %d vs %d\n", r->argCount(), a.argCount());
+  }
+  else if ((0 != r->getValueAs("i8", &ri8)) || (-100 != ri8))  log->concatf("i8 came back as %d\n", ri8);
+  else if ((0 != r->getValueAs("i16", &ri16)) || (-30000 != ri16))  log->concatf("i16 came back as %d\n", ri16);
+  else if ((0 != r->getValueAs("i32", &ri32)) || (-2000000 != ri32))  log->concatf("i32 came back as %d\n", ri32);
+  else if ((0 != r->getValueAs("u32", &ru32)) || (4000000000 != ru32))  log->concatf("u32 came back as %u\n", ru32);
+  else if ((0 != r->getValueAs("f", &rf)) || (2.25f != rf))  log->concatf("f came back as %f\n", (double) rf);
+  else if ((0 != r->getValueAs("d", &rd)) || (big != rd))  log->concat("d came back wrong\n");
+  else if ((0 != r->getValueAs("str", &rstr)) || (0 != strcmp(rstr, "A string value")))  log->concat("str came back wrong\n");
+  else if ((nullptr == rblob) || (TCode::BINARY != rblob->typeCode()) || (sizeof(blob) != rblob->length()) || (0 != memcmp(rblob->pointer(), blob, sizeof(blob)))) {
+    log->concat("blob came back wrong\n");
+  }
+  else if ((nullptr == rsmall) || (nullptr != rsmall->getKey()) || (sizeof(small) != rsmall->length()) || (0 != memcmp(rsmall->pointer(), small, sizeof(small)))) {
+    log->concat("Unkeyed binary came back wrong\n");
+  }
+  else if ((nullptr == rvec) || (TCode::VECT_3_FLOAT != rvec->typeCode()) || (0 != rvec->getValueAs(&rv3f)) || (rv3f.x != 1.0f) || (rv3f.y != -2.0f) || (rv3f.z != 0.5f)) {
+    log->concat("v3f came back wrong\n");
+  }
+  else {
+    log->concatf("Argument list of %d survived a %d-byte CBOR round-trip.\n", a.argCount(), enc_len);
+    return_value = 0;
+  }
+  delete r;
+  return return_value;
+}
+
+
+/*
+* 64-bit integers, and the simple values that aren't numbers.
+*/
+int test_CBOR_Specials(StringBuilder* log) {
+  int return_value = -1;
+  const uint8_t src[] = {
+    0xA7,                                                 // Map of 7.
+    0x63, 'u', '6', '4',   0x1B, 0, 0, 0, 1, 0, 0, 0, 0,  // 2^32
+    0x63, 'n', '6', '4',   0x3B, 0, 0, 0, 1, 0, 0, 0, 0,  // -1 - 2^32
+    0x61, 't',             0xF5,                          // true
+    0x61, 'f',             0xF4,                          // false
+    0x63, 'n', 'u', 'l',   0xF6,                          // null
+    0x61, 'h',             0xF9, 0x3E, 0x00,              // 1.5 as a half
+    0x62, 'h', 'n',        0xF9, 0x80, 0x01               // The least negative subnormal half
+  };
+  const uint8_t too_small[] = { 0x3B, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+  const uint8_t unassigned[] = { 0x82, 0x01, 0xF0 };   // [1, simple(16)]
+
+  Argument* r = Argument::decodeFromCBOR((uint8_t*) src, sizeof(src));
+  if (nullptr == r) {
+    log->concat("Failed to decode the specials.\n");
+    return -1;
+  }
+  uint64_t ru64 = 0;
+  int64_t  rn64 = 0;
+  uint8_t  rt   = 0;
+  uint8_t  rf   = 1;
+  float    rh   = 0.0f;
+  float    rhn  = 0.0f;
+  Argument* a_u64 = r->retrieveArgByKey("u64");
+  Argument* a_n64 = r->retrieveArgByKey("n64");
+  Argument* a_t   = r->retrieveArgByKey("t");
+
+  if (6 != r->argCount()) {
+    log->concatf("Expected 6 Arguments (null has none), but got %d.\n", r->argCount());
+  }
+  else if ((nullptr == a_u64) || (TCode::UINT64 != a_u64->typeCode()) || (0 != a_u64->getValueAs(&ru64)) || (4294967296ULL != ru64)) {
+    log->concat("u64 came back wrong.\n");
+  }
+  else if ((nullptr == a_n64) || (TCode::INT64 != a_n64->typeCode()) || (0 != a_n64->getValueAs(&rn64)) || (-4294967297LL != rn64)) {
+    log->concat("n64 came back wrong.\n");
+  }
+  else if ((nullptr == a_t) || (TCode::BOOLEAN != a_t->typeCode()) || (0 != a_t->getValueAs(&rt)) || (1 != rt)) {
+    log->concat("true came back wrong.\n");
+  }
+  else if ((0 != r->getValueAs("f", &rf)) || (0 != rf)) {
+    log->concat("false came back wrong.\n");
+  }
+  else if (nullptr != r->retrieveArgByKey("nul")) {
+    log->concat("null produced an Argument.\n");
+  }
+  else if ((0 != r->getValueAs("h", &rh)) || (1.5f != rh)) {
+    log->concatf("Half-float came back as %f.\n", (double) rh);
+  }
+  else if ((0 != r->getValueAs("hn", &rhn)) || (-ldexpf(1.0f, -24) != rhn)) {
+    log->concatf("Subnormal half-float came back as %g.\n", (double) rhn);
+  }
+  else {
+    return_value = 0;
+  }
+  delete r;
+  if (0 != return_value) return return_value;
+
+  // Things we can't represent fail the decode, rather than vanish from it.
+  r = Argument::decodeFromCBOR((uint8_t*) too_small, sizeof(too_small));
+  if (nullptr != r) {
+    log->concat("A negative integer below int64 was decoded.\n");
+    delete r;
+    return -1;
+  }
+  r = Argument::decodeFromCBOR((uint8_t*) unassigned, sizeof(unassigned));
+  if (nullptr != r) {
+    log->concat("An unassigned simple value was decoded.\n");
+    delete r;
+    return -1;
+  }
+
+  // And what we decode, we can encode.
+  StringBuilder shuttle;
+  Argument a((uint64_t) 0x123456789ULL);
+  a.link(new Argument((int64_t) -0x123456789LL));
+  a.link(new Argument((void*)(uintptr_t) 1, 1, TCode::BOOLEAN));
+  Argument::encodeToCBOR(&a, &shuttle);
+  r = Argument::decodeFromCBOR(&shuttle);
+  ru64 = 0;
+  rn64 = 0;
+  rt   = 0;
+  if ((nullptr == r) || (3 != r->argCount())) {
+    log->concat("64-bit and boolean Arguments didn't survive a round-trip.\n");
+    return_value = -1;
+  }
+  else if ((0 != r->getValueAs((uint8_t) 0, &ru64)) || (0x123456789ULL != ru64) ||
+           (0 != r->getValueAs((uint8_t) 1, &rn64)) || (-0x123456789LL != rn64) ||
+           (0 != r->getValueAs((uint8_t) 2, &rt))   || (1 != rt)) {
+    log->concat("64-bit and boolean Arguments came back wrong.\n");
+    return_value = -1;
+  }
+  else {
+    log->concat("64-bit integers, booleans, null and half-floats decode.\n");
+  }
+  if (nullptr != r) delete r;
+  return return_value;
+}
+
+
+/*
+* A nested Argument comes back as a single Argument that owns the nested list.
+*/
+int test_CBOR_NestedArguments(StringBuilder* log) {
+  int return_value = -1;
+  StringBuilder shuttle;
+  Argument* inner = new Argument((uint16_t) 512);
+  inner->append("inner string");
+  Argument a((uint8_t) 7);
+  a.append(inner);
+
+  if (0 < Argument::encodeToCBOR(&a, &shuttle)) {
+    Argument* r = Argument::decodeFromCBOR(&shuttle);
+    shuttle.clear();
+    Argument* r_inner = nullptr;
+    uint16_t  r_u16   = 0;
+    char*     r_str   = nullptr;
+    if ((nullptr != r) && (2 == r->argCount()) && (0 == r->getValueAs((uint8_t) 1, &r_inner))) {
+      if ((0 == r_inner->getValueAs((uint8_t) 0, &r_u16)) && (512 == r_u16)) {
+        if ((0 == r_inner->getValueAs((uint8_t) 1, &r_str)) && (0 == strcmp(r_str, "inner string"))) {
+          log->concat("Nested Argument survived a CBOR round-trip.\n");
+          return_value = 0;
         }
+      }
     }
+    if (0 != return_value) log->concat("Nested Argument came back wrong.\n");
+    if (nullptr != r) delete r;
+  }
+  else {
+    log->concat("Failed to encode a nested Argument.\n");
+  }
+  delete inner;
+  return return_value;
+}
+
 
-    { // decoding
-        cbor::input input(output.data(), output.size());
-        cbor::listener_debug listener;
+/*******************************************************************************
+* Benchmarks. Informational only.
+*******************************************************************************/
+
+/* A representative sensor report. */
+static Argument* _bench_args() {
+  Argument* a = new Argument((uint32_t) 1234567);
+  a->setKey("timestamp");
+  a->append(22.75f)->setKey("temperature");
+  a->append(45.5f)->setKey("humidity");
+  a->append((int16_t) -412)->setKey("offset");
+  a->append("sensor-node-07")->setKey("origin");
+  a->append(Vector3f(0.01f, -0.98f, 0.12f))->setKey("accel");
+  a->append(101325.0)->setKey("pressure");
+  return a;
+}
+
+
+/*
+* Encodes a keyed Argument list the way encodeToCBOR() used to: into a
+*   growing cbor::output_dynamic, which is then copied onto the StringBuilder.
+*/
+static void _legacy_encode(Argument* src, StringBuilder* out) {
+  cbor::output_dynamic output;
+  cbor::encoder encoder(output);
+  while (nullptr != src) {
+    if (nullptr != src->getKey()) {
+      encoder.write_map(1);
+      encoder.write_string(src->getKey());
+    }
+    switch (src->typeCode()) {
+      case TCode::UINT32:   { uint32_t x = 0;  src->getValueAs(&x);  encoder.write_int(x);  }  break;
+      case TCode::INT16:    { int16_t x = 0;   src->getValueAs(&x);  encoder.write_int(x);  }  break;
+      case TCode::FLOAT:    { float x = 0;     src->getValueAs(&x);  encoder.write_float(x);  }  break;
+      case TCode::DOUBLE:   { double x = 0;    src->getValueAs(&x);  encoder.write_double(x);  }  break;
+      case TCode::STR:      { char* x = 0;     src->getValueAs(&x);  encoder.write_string(x);  }  break;
+      default:
+        encoder.write_tag(MANUVR_CBOR_VENDOR_TYPE | TcodeToInt(src->typeCode()));
+        encoder.write_bytes((uint8_t*) src->pointer(), src->length());
+        break;
+    }
+    src = src->next();
+  }
+  out->concat(output.data(), output.size());
+}
+
+
+void bench_CBOR(StringBuilder* log, Argument* args, const int ROUNDS) {
+  unsigned long allocs[2];
+  unsigned long elapsed[2];
+  int lengths[2] = { 0, 0 };
+
+  // Encoding.
+  for (int mode = 0; mode < 2; mode++) {
+    unsigned long a0 = heap_allocs;
+    unsigned long t0 = micros();
+    for (int r = 0; r < ROUNDS; r++) {
+      StringBuilder out;
+      if (0 == mode) _legacy_encode(args, &out);
+      else           Argument::encodeToCBOR(args, &out);
+      lengths[mode] = out.length();
+    }
+    elapsed[mode] = micros() - t0;
+    allocs[mode]  = heap_allocs - a0;
+  }
+  log->concatf("\t Encoding %d args (%d bytes), %d times:\n", args->argCount(), lengths[1], ROUNDS);
+  log->concatf("\t   output_dynamic + copy  %8lu allocs  %8lu us  (%.1f ns/encode)\n", allocs[0], elapsed[0], ((double) elapsed[0] * 1000) / ROUNDS);
+  log->concatf("\t   Direct into the tail   %8lu allocs  %8lu us  (%.1f ns/encode)\n", allocs[1], elapsed[1], ((double) elapsed[1] * 1000) / ROUNDS);
+
+  // Decoding.
+  StringBuilder encoded;
+  Argument::encodeToCBOR(args, &encoded);
+  for (int mode = 0; mode < 2; mode++) {
+    unsigned long a0 = heap_allocs;
+    unsigned long t0 = micros();
+    for (int r = 0; r < ROUNDS; r++) {
+      Argument* result = nullptr;
+      if (0 == mode) {
+        CBORArgListener listener(&result);
+        cbor::input input(encoded.string(), encoded.length());
         cbor::decoder decoder(input, listener);
         decoder.run();
+      }
+      else {
+        result = Argument::decodeFromCBOR(&encoded);
+      }
+      if (nullptr != result) {
+        lengths[mode] = result->argCount();
+        delete result;
+      }
     }
+    elapsed[mode] = micros() - t0;
+    allocs[mode]  = heap_allocs - a0;
+  }
+  log->concatf("\t Decoding the same, %d times:\n", ROUNDS);
+  log->concatf("\t   decoder + listener     %8lu allocs  %8lu us  (%.1f ns/decode)  %d args\n", allocs[0], elapsed[0], ((double) elapsed[0] * 1000) / ROUNDS, lengths[0]);
+  log->concatf("\t   reader                 %8lu allocs  %8lu us  (%.1f ns/decode)  %d args\n", allocs[1], elapsed[1], ((double) elapsed[1] * 1000) / ROUNDS, lengths[1]);
+}
 
-    return 0;
+
+/****************************************************************************************************
+* The main function.                                                                                *
+****************************************************************************************************/
+int main(int argc, char *argv[]) {
+  int exit_value = 1;   // Failure is the default result.
+  platform.platformPreInit();
+
+  StringBuilder log("===< CBOR >=============================================\n");
+  if (0 == test_CBOR_Reader(&log)) {
+    if (0 == test_CBOR_OutputBuffer(&log)) {
+      if (0 == test_CBOR_Arguments(&log)) {
+        if (0 == test_CBOR_NestedArguments(&log)) {
+          if (0 == test_CBOR_Specials(&log)) {
+            // A small report, and the same with a bulky capture attached.
+            static uint8_t capture[2048];
+            Argument* args = _bench_args();
+            bench_CBOR(&log, args, 100000);
+            args->append((void*) capture, sizeof(capture))->setKey("capture");
+            bench_CBOR(&log, args, 20000);
+            delete args;
+            exit_value = 0;
+          }
+        }
+      }
+    }
+  }
+  printf("%s\n", (const char*) log.string());
+  exit(exit_value);
 }